@@ -0,0 +1,105 @@
+#!/usr/bin/env bash
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Library Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Library Public License for more details.
+#
+
+source $CEPH_ROOT/qa/standalone/ceph-helpers.sh
+
+function run() {
+    local dir=$1
+    shift
+
+    export CEPH_MON="127.0.0.1:7149" # git grep '\<7149\>' : there must be only one
+    export CEPH_ARGS
+    CEPH_ARGS+="--fsid=$(uuidgen) --auth-supported=none "
+    CEPH_ARGS+="--mon-host=$CEPH_MON "
+    CEPH_ARGS+="--osd_op_queue=wpq "
+    CEPH_ARGS+="--osd_recovery_max_active=40 "
+    CEPH_ARGS+="--osd_recovery_max_single_start=1 "
+    CEPH_ARGS+="--osd_recovery_sleep=0 "
+    export objects=200
+    export poolname=test
+
+    local funcs=${@:-$(set | sed -n -e 's/^\(TEST_[0-9a-z_]*\) .*/\1/p')}
+    for func in $funcs ; do
+        setup $dir || return 1
+        $func $dir || return 1
+        teardown $dir || return 1
+    done
+}
+
+# Write small objects while the replica is down, bring it back and let
+# the primary recover them. Returns the largest number of objects a
+# single recovery work item started.
+function do_recovery_small_objects() {
+    local dir=$1
+    shift
+    local batch_bytes=$1
+
+    run_mon $dir a || return 1
+    run_mgr $dir x || return 1
+    run_osd $dir 0 --osd_recovery_small_object_batch_bytes=$batch_bytes || return 1
+    run_osd $dir 1 --osd_recovery_small_object_batch_bytes=$batch_bytes || return 1
+
+    create_pool $poolname 1 1
+    ceph osd pool set $poolname size 2
+    wait_for_clean || return 1
+
+    local primary=$(get_primary $poolname obj1)
+    local otherosd=$(get_not_primary $poolname obj1)
+
+    ceph osd set noout
+    kill_daemons $dir TERM osd.$otherosd || return 1
+    ceph osd down osd.$otherosd
+    dd if=/dev/urandom of=$dir/datafile bs=4096 count=1
+    for i in $(seq 1 $objects)
+    do
+        rados -p $poolname put obj$i $dir/datafile || return 1
+    done
+
+    activate_osd $dir $otherosd --osd_recovery_small_object_batch_bytes=$batch_bytes || return 1
+    ceph osd unset noout
+    wait_for_clean || return 1
+
+    for i in $(seq 1 $objects)
+    do
+        rados -p $poolname get obj$i $dir/obj$i || return 1
+        cmp $dir/datafile $dir/obj$i || return 1
+        rm -f $dir/obj$i
+    done
+
+    grep "_maybe_queue_recovery starting " $dir/osd.$primary.log | \
+        sed -e 's/.* starting \([0-9]*\),.*/\1/' | sort -n | tail -1 > $dir/max_start
+    delete_pool $poolname
+    kill_daemons $dir || return 1
+}
+
+function TEST_recovery_small_objects_unbatched() {
+    local dir=$1
+
+    do_recovery_small_objects $dir 0 || return 1
+    test "$(cat $dir/max_start)" = "1" || return 1
+}
+
+# With 4K objects, 1M of them are 256 objects, so each work item can
+# start as many as osd_recovery_max_active allows
+function TEST_recovery_small_objects_batched() {
+    local dir=$1
+
+    do_recovery_small_objects $dir 1048576 || return 1
+    test "$(cat $dir/max_start)" -gt 1 || return 1
+}
+
+main osd-recovery-small-batch "$@"
+
+# Local Variables:
+# compile-command: "make -j4 && ../qa/run-standalone.sh osd-recovery-small-batch.sh"
+# End:
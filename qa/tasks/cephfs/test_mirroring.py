@@ -1144,6 +1144,139 @@ class TestMirroring(CephFSTestCase):
 
         self.disable_mirroring(self.primary_fs_name, self.primary_fs_id)
 
+    def _mount_secondary_for_data(self):
+        log.debug('reconfigure client auth caps')
+        self.get_ceph_cmd_result(
+            'auth', 'caps', "client.{0}".format(self.mount_b.client_id),
+                'mds', 'allow rw',
+                'mon', 'allow r',
+                'osd', 'allow rw pool={0}, allow rw pool={1}'.format(
+                    self.backup_fs.get_data_pool_name(),
+                    self.backup_fs.get_data_pool_name()))
+
+        log.debug(f'mounting filesystem {self.secondary_fs_name}')
+        self.mount_b.umount_wait()
+        self.mount_b.mount_wait(cephfs_name=self.secondary_fs_name)
+
+    def _overwrite_mb(self, mount, filename, n_mb, seek):
+        mount.run_shell(["dd", "if=/dev/urandom", f"of={filename}", "bs=1M",
+                         f"count={n_mb}", f"seek={seek}", "conv=notrunc,fdatasync"])
+
+    def test_cephfs_mirror_delta_sync(self):
+        """
+        That large files changed in place, grown and shrunk between snapshots
+        are synchronized correctly by only rewriting their changed blocks.
+        """
+        self._mount_secondary_for_data()
+
+        # above cephfs_mirror_delta_sync_min_size
+        self.mount_a.run_shell(["mkdir", "d0"])
+        self.mount_a.write_n_mb('d0/file0', 128)
+
+        self.enable_mirroring(self.primary_fs_name, self.primary_fs_id)
+        self.add_directory(self.primary_fs_name, self.primary_fs_id, '/d0')
+        self.peer_add(self.primary_fs_name, self.primary_fs_id, "client.mirror_remote@ceph", self.secondary_fs_name)
+
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap0"])
+        time.sleep(120)
+        self.check_peer_status(self.primary_fs_name, self.primary_fs_id,
+                               "client.mirror_remote@ceph", '/d0', 'snap0', 1)
+        self.verify_snapshot('d0', 'snap0')
+
+        # change a block in the middle
+        self._overwrite_mb(self.mount_a, 'd0/file0', 1, 40)
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap1"])
+        time.sleep(60)
+        self.check_peer_status(self.primary_fs_name, self.primary_fs_id,
+                               "client.mirror_remote@ceph", '/d0', 'snap1', 2)
+        self.verify_snapshot('d0', 'snap1')
+
+        # grow it
+        self.mount_a.write_n_mb('d0/file0', 16, seek=128)
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap2"])
+        time.sleep(60)
+        self.check_peer_status(self.primary_fs_name, self.primary_fs_id,
+                               "client.mirror_remote@ceph", '/d0', 'snap2', 3)
+        self.verify_snapshot('d0', 'snap2')
+
+        # shrink it
+        self.mount_a.run_shell(["truncate", "-s", "96M", "d0/file0"])
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap3"])
+        time.sleep(60)
+        self.check_peer_status(self.primary_fs_name, self.primary_fs_id,
+                               "client.mirror_remote@ceph", '/d0', 'snap3', 4)
+        self.verify_snapshot('d0', 'snap3')
+
+        self.disable_mirroring(self.primary_fs_name, self.primary_fs_id)
+
+    def test_cephfs_mirror_delta_sync_remote_changed(self):
+        """
+        That a large file is copied as a whole when its remote copy no longer
+        matches the previous snapshot.
+        """
+        self._mount_secondary_for_data()
+
+        self.mount_a.run_shell(["mkdir", "d0"])
+        self.mount_a.write_n_mb('d0/file0', 128)
+
+        self.enable_mirroring(self.primary_fs_name, self.primary_fs_id)
+        self.add_directory(self.primary_fs_name, self.primary_fs_id, '/d0')
+        self.peer_add(self.primary_fs_name, self.primary_fs_id, "client.mirror_remote@ceph", self.secondary_fs_name)
+
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap0"])
+        time.sleep(120)
+        self.check_peer_status(self.primary_fs_name, self.primary_fs_id,
+                               "client.mirror_remote@ceph", '/d0', 'snap0', 1)
+        self.verify_snapshot('d0', 'snap0')
+
+        # scribble over another part of the remote copy
+        self._overwrite_mb(self.mount_b, 'd0/file0', 1, 8)
+        self._overwrite_mb(self.mount_a, 'd0/file0', 1, 40)
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap1"])
+        time.sleep(120)
+        self.check_peer_status(self.primary_fs_name, self.primary_fs_id,
+                               "client.mirror_remote@ceph", '/d0', 'snap1', 2)
+        self.verify_snapshot('d0', 'snap1')
+
+        self.disable_mirroring(self.primary_fs_name, self.primary_fs_id)
+
+    def test_cephfs_mirror_delta_sync_retry(self):
+        """
+        That retrying an interrupted snapshot sync copies large files as a
+        whole, as the interrupted sync may have left them half written.
+        """
+        self._mount_secondary_for_data()
+
+        self.mount_a.run_shell(["mkdir", "d0"])
+        self.mount_a.write_n_mb('d0/file0', 128)
+
+        self.enable_mirroring(self.primary_fs_name, self.primary_fs_id)
+        self.add_directory(self.primary_fs_name, self.primary_fs_id, '/d0')
+        self.peer_add(self.primary_fs_name, self.primary_fs_id, "client.mirror_remote@ceph", self.secondary_fs_name)
+
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap0"])
+        time.sleep(120)
+        self.check_peer_status(self.primary_fs_name, self.primary_fs_id,
+                               "client.mirror_remote@ceph", '/d0', 'snap0', 1)
+        self.verify_snapshot('d0', 'snap0')
+
+        # change the file and add enough data to interrupt the sync midway
+        self._overwrite_mb(self.mount_a, 'd0/file0', 1, 40)
+        for i in range(4):
+            self.mount_a.write_n_mb(f'd0/big.{i}', 1024)
+        self.mount_a.run_shell(["mkdir", "d0/.snap/snap1"])
+        time.sleep(10)
+        self.check_peer_snap_in_progress(self.primary_fs_name, self.primary_fs_id,
+                                         "client.mirror_remote@ceph", '/d0', 'snap1')
+        self.remove_directory(self.primary_fs_name, self.primary_fs_id, '/d0')
+
+        # the retry resumes snap1 on top of what the first attempt left
+        self.add_directory(self.primary_fs_name, self.primary_fs_id, '/d0')
+        time.sleep(500)
+        self.verify_snapshot('d0', 'snap1')
+
+        self.disable_mirroring(self.primary_fs_name, self.primary_fs_id)
+
     def test_cephfs_mirror_sync_with_purged_snapshot(self):
         """Test snapshot synchronization in midst of snapshot deletes.
 
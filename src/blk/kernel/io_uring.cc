@@ -7,18 +7,57 @@
 
 #include "liburing.h"
 #include <sys/epoll.h>
+#include <sys/mman.h>
+
+#include <boost/lockfree/queue.hpp>
 
 using std::list;
 using std::make_unique;
 
 struct ioring_data {
   struct io_uring io_uring;
-  pthread_mutex_t cq_mutex;
   pthread_mutex_t sq_mutex;
   int epoll_fd = -1;
   std::map<int, int> fixed_fds_map;
+
+  // registered (fixed) buffers.  small ios are bounced through these so
+  // the kernel does not have to pin and unpin the user pages for every
+  // single request.  buffers are taken by the submitter (under sq_mutex)
+  // and handed back by the reaper, hence the lock-free queue.
+  void *fixed_bufs_region = nullptr;
+  size_t fixed_bufs_region_len = 0;
+  std::vector<struct iovec> fixed_bufs;
+  std::unique_ptr<boost::lockfree::queue<int>> free_fixed_bufs;
 };
 
+static void put_fixed_buf(struct ioring_data *d, struct aio_t *io)
+{
+  if (io->fixed_buf_index < 0)
+    return;
+
+  if (io->iocb.aio_lio_opcode == IO_CMD_PREADV && io->rval > 0) {
+    // copy the bounced data back into the caller's buffers
+    const char *src =
+      static_cast<const char*>(d->fixed_bufs[io->fixed_buf_index].iov_base);
+    size_t left = std::min<size_t>(io->rval, io->length);
+    for (auto& iov : io->iov) {
+      if (left == 0)
+	break;
+      size_t len = std::min(left, iov.iov_len);
+      memcpy(iov.iov_base, src, len);
+      src += len;
+      left -= len;
+    }
+  }
+
+  d->free_fixed_bufs->push(io->fixed_buf_index);
+  io->fixed_buf_index = -1;
+}
+
+/*
+ * There is a single reaper per queue (the KernelDevice aio thread), so
+ * the completion ring is consumed without any locking.
+ */
 static int ioring_get_cqe(struct ioring_data *d, unsigned int max,
 			  struct aio_t **paio)
 {
@@ -30,6 +69,7 @@ static int ioring_get_cqe(struct ioring_data *d, unsigned int max,
   io_uring_for_each_cqe(ring, head, cqe) {
     struct aio_t *io = (struct aio_t *)(uintptr_t) io_uring_cqe_get_data(cqe);
     io->rval = cqe->res;
+    put_fixed_buf(d, io);
 
     paio[nr++] = io;
 
@@ -50,6 +90,37 @@ static int find_fixed_fd(struct ioring_data *d, int real_fd)
   return it->second;
 }
 
+static bool init_fixed_sqe(struct ioring_data *d, struct io_uring_sqe *sqe,
+			   struct aio_t *io, int fixed_fd)
+{
+  if (!d->free_fixed_bufs || d->fixed_bufs.empty() ||
+      io->length > d->fixed_bufs[0].iov_len)
+    return false;
+
+  int index;
+  if (!d->free_fixed_bufs->pop(index))
+    /* all registered buffers are in flight, use the regular path */
+    return false;
+
+  char *buf = static_cast<char*>(d->fixed_bufs[index].iov_base);
+  if (io->iocb.aio_lio_opcode == IO_CMD_PWRITEV) {
+    char *dst = buf;
+    for (auto& iov : io->iov) {
+      memcpy(dst, iov.iov_base, iov.iov_len);
+      dst += iov.iov_len;
+    }
+    io_uring_prep_write_fixed(sqe, fixed_fd, buf, io->length,
+			      io->offset, index);
+  } else if (io->iocb.aio_lio_opcode == IO_CMD_PREADV) {
+    io_uring_prep_read_fixed(sqe, fixed_fd, buf, io->length,
+			     io->offset, index);
+  } else {
+    ceph_assert(0);
+  }
+  io->fixed_buf_index = index;
+  return true;
+}
+
 static void init_sqe(struct ioring_data *d, struct io_uring_sqe *sqe,
 		     struct aio_t *io)
 {
@@ -57,7 +128,9 @@ static void init_sqe(struct ioring_data *d, struct io_uring_sqe *sqe,
 
   ceph_assert(fixed_fd != -1);
 
-  if (io->iocb.aio_lio_opcode == IO_CMD_PWRITEV)
+  if (init_fixed_sqe(d, sqe, io, fixed_fd))
+    /* bounced through a registered buffer */;
+  else if (io->iocb.aio_lio_opcode == IO_CMD_PWRITEV)
     io_uring_prep_writev(sqe, fixed_fd, &io->iov[0],
 			 io->iov.size(), io->offset);
   else if (io->iocb.aio_lio_opcode == IO_CMD_PREADV)
@@ -106,11 +179,65 @@ static void build_fixed_fds_map(struct ioring_data *d,
   }
 }
 
-ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_) :
+static void free_fixed_bufs(struct ioring_data *d)
+{
+  d->free_fixed_bufs.reset();
+  d->fixed_bufs.clear();
+  if (d->fixed_bufs_region) {
+    munmap(d->fixed_bufs_region, d->fixed_bufs_region_len);
+    d->fixed_bufs_region = nullptr;
+    d->fixed_bufs_region_len = 0;
+  }
+}
+
+/*
+ * Registering buffers needs RLIMIT_MEMLOCK headroom.  Failing to do so is
+ * not fatal: we simply keep submitting through the vectored, non-fixed
+ * path.
+ */
+static int register_fixed_bufs(struct ioring_data *d, unsigned count,
+			       size_t size)
+{
+  if (count == 0 || size == 0)
+    return 0;
+
+  size = p2roundup<size_t>(size, CEPH_PAGE_SIZE);
+  size_t len = size * count;
+  void *region = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  if (region == MAP_FAILED)
+    return -errno;
+
+  d->fixed_bufs_region = region;
+  d->fixed_bufs_region_len = len;
+  d->fixed_bufs.resize(count);
+  d->free_fixed_bufs = make_unique<boost::lockfree::queue<int>>(count);
+  for (unsigned i = 0; i < count; i++) {
+    d->fixed_bufs[i].iov_base = static_cast<char*>(region) + i * size;
+    d->fixed_bufs[i].iov_len = size;
+  }
+
+  int ret = io_uring_register_buffers(&d->io_uring, &d->fixed_bufs[0],
+				      d->fixed_bufs.size());
+  if (ret < 0) {
+    free_fixed_bufs(d);
+    return ret;
+  }
+
+  for (unsigned i = 0; i < count; i++)
+    d->free_fixed_bufs->push(i);
+
+  return 0;
+}
+
+ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_,
+			       unsigned fixed_bufs_, size_t fixed_buf_size_) :
   d(make_unique<ioring_data>()),
   iodepth(iodepth_),
   hipri(hipri_),
-  sq_thread(sq_thread_)
+  sq_thread(sq_thread_),
+  fixed_bufs(fixed_bufs_),
+  fixed_buf_size(fixed_buf_size_)
 {
 }
 
@@ -122,7 +249,6 @@ int ioring_queue_t::init(std::vector<int> &fds)
 {
   unsigned flags = 0;
 
-  pthread_mutex_init(&d->cq_mutex, NULL);
   pthread_mutex_init(&d->sq_mutex, NULL);
 
   if (hipri)
@@ -143,6 +269,10 @@ int ioring_queue_t::init(std::vector<int> &fds)
 
   build_fixed_fds_map(d.get(), fds);
 
+  if (register_fixed_bufs(d.get(), fixed_bufs, fixed_buf_size) < 0)
+    /* fall back to regular buffers */
+    fixed_bufs = 0;
+
   d->epoll_fd = epoll_create1(0);
   if (d->epoll_fd < 0) {
     ret = -errno;
@@ -163,6 +293,7 @@ close_epoll_fd:
   close(d->epoll_fd);
 close_ring_fd:
   io_uring_queue_exit(&d->io_uring);
+  free_fixed_bufs(d.get());
 
   return ret;
 }
@@ -173,6 +304,7 @@ void ioring_queue_t::shutdown()
   close(d->epoll_fd);
   d->epoll_fd = -1;
   io_uring_queue_exit(&d->io_uring);
+  free_fixed_bufs(d.get());
 }
 
 int ioring_queue_t::submit_batch(aio_iter beg, aio_iter end,
@@ -192,9 +324,7 @@ int ioring_queue_t::submit_batch(aio_iter beg, aio_iter end,
 int ioring_queue_t::get_next_completed(int timeout_ms, aio_t **paio, int max)
 {
 get_cqe:
-  pthread_mutex_lock(&d->cq_mutex);
   int events = ioring_get_cqe(d.get(), max, paio);
-  pthread_mutex_unlock(&d->cq_mutex);
 
   if (events == 0) {
     struct epoll_event ev;
@@ -224,7 +354,8 @@ bool ioring_queue_t::supported()
 
 struct ioring_data {};
 
-ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_)
+ioring_queue_t::ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_,
+			       unsigned fixed_bufs_, size_t fixed_buf_size_)
 {
   ceph_assert(0);
 }
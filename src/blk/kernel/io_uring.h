@@ -15,13 +15,16 @@ struct ioring_queue_t final : public io_queue_t {
   unsigned iodepth = 0;
   bool hipri = false;
   bool sq_thread = false;
+  unsigned fixed_bufs = 0;      ///< number of registered bounce buffers
+  size_t fixed_buf_size = 0;    ///< size of each registered bounce buffer
 
   typedef std::list<aio_t>::iterator aio_iter;
 
   // Returns true if arch is x86-64 and kernel supports io_uring
   static bool supported();
 
-  ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_);
+  ioring_queue_t(unsigned iodepth_, bool hipri_, bool sq_thread_,
+		 unsigned fixed_bufs_ = 0, size_t fixed_buf_size_ = 0);
   ~ioring_queue_t() final;
 
   int init(std::vector<int> &fds) final;
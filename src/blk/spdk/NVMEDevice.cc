@@ -27,6 +27,7 @@
 #include <fstream>
 #include <functional>
 #include <map>
+#include <memory>
 #include <thread>
 #include <boost/intrusive/slist.hpp>
 
@@ -149,6 +150,8 @@ class SharedDriverQueueData {
   std::string sn;
   uint32_t block_size;
   uint32_t max_queue_depth;
+  uint32_t max_io_completion;
+  uint64_t io_sleep_in_us;
   struct spdk_nvme_qpair *qpair;
   int alloc_buf_from_pool(Task *t, bool write);
 
@@ -164,6 +167,9 @@ class SharedDriverQueueData {
     ctrlr = driver->ctrlr;
     ns = driver->ns;
     block_size = driver->block_size;
+    // read once per queue pair rather than on every submission
+    max_io_completion = (uint32_t)g_conf().get_val<uint64_t>("bluestore_spdk_max_io_completion");
+    io_sleep_in_us = g_conf().get_val<uint64_t>("bluestore_spdk_io_sleep");
 
     struct spdk_nvme_io_qpair_opts opts = {};
     spdk_nvme_ctrlr_get_default_io_qpair_opts(ctrlr, &opts, sizeof(opts));
@@ -352,8 +358,6 @@ void SharedDriverQueueData::_aio_handle(Task *t, IOContext *ioc)
 
   int r = 0;
   uint64_t lba_off, lba_count;
-  uint32_t max_io_completion = (uint32_t)g_conf().get_val<uint64_t>("bluestore_spdk_max_io_completion");
-  uint64_t io_sleep_in_us = g_conf().get_val<uint64_t>("bluestore_spdk_io_sleep");
 
   while (ioc->num_running) {
  again:
@@ -810,8 +814,16 @@ void NVMEDevice::aio_submit(IOContext *ioc)
     // Only need to push the first entry
     ioc->nvme_task_first = ioc->nvme_task_last = nullptr;
 
-    thread_local SharedDriverQueueData queue_t = SharedDriverQueueData(this, driver);
-    queue_t._aio_handle(t, ioc);
+    // Each submitting thread owns one queue pair per controller and polls
+    // its completions inline, so queue pairs and their DMA buffers are
+    // never shared between threads.
+    thread_local std::map<SharedDriverData*,
+			  std::unique_ptr<SharedDriverQueueData>> queues;
+    auto& queue = queues[driver];
+    if (!queue) {
+      queue = std::make_unique<SharedDriverQueueData>(this, driver);
+    }
+    queue->_aio_handle(t, ioc);
   }
 }
 
@@ -1612,7 +1612,12 @@ Inode* Client::insert_trace(MetaRequest *request, MetaSession *session)
 	  unlink(dn, true, true);  // keep dir, dentry
 	}
       }
-      if (dlease.duration_ms > 0) {
+      // without a lease, a null dentry is still good for as long as we
+      // hold the FILE_SHARED cap the dir had when the reply arrived
+      bool cache_null = cct->_conf->client_cache_null_dentries &&
+	diri->auth_cap && diri->auth_cap->session == session &&
+	diri->caps_issued_mask(CEPH_CAP_FILE_SHARED, true);
+      if (dlease.duration_ms > 0 || cache_null) {
 	if (!dn) {
 	  Dir *dir = diri->open_dir();
 	  dn = link(dir, dname, NULL, NULL);
@@ -1949,15 +1954,9 @@ int Client::verify_reply_trace(int r, MetaSession *session,
  * @param use_mds [optional] prefer a specific mds (-1 for default)
  * @param pdirbl [optional; disallowed if ptarget] where to pass extra reply payload to the caller
  */
-int Client::make_request(MetaRequest *request,
-			 const UserPerm& perms,
-			 InodeRef *ptarget, bool *pcreated,
-			 mds_rank_t use_mds,
-			 bufferlist *pdirbl,
-			 size_t feature_needed)
+void Client::_register_request(MetaRequest *request, const UserPerm& perms,
+				mds_rank_t use_mds)
 {
-  int r = 0;
-
   // assign a unique tid
   ceph_tid_t tid = ++last_tid;
   request->set_tid(tid);
@@ -1983,86 +1982,88 @@ int Client::make_request(MetaRequest *request,
   // hack target mds?
   if (use_mds >= 0)
     request->resend_mds = use_mds;
+}
 
-  MetaSessionRef session = NULL;
-  while (1) {
-    if (request->aborted())
-      break;
+/*
+ * Make one attempt at sending the request to its mds, possibly waiting
+ * for an mdsmap or session first.  Returns 0 once sent, 1 if the caller
+ * should try again, or -1 if the request got aborted.
+ */
+int Client::_send_request_attempt(MetaRequest *request,
+				  ceph::condition_variable *caller_cond,
+				  MetaSessionRef *psession,
+				  size_t feature_needed)
+{
+  if (request->aborted())
+    return -1;
 
-    if (blocklisted) {
-      request->abort(-CEPHFS_EBLOCKLISTED);
-      break;
-    }
+  if (blocklisted) {
+    request->abort(-CEPHFS_EBLOCKLISTED);
+    return -1;
+  }
 
-    // set up wait cond
-    ceph::condition_variable caller_cond;
-    request->caller_cond = &caller_cond;
-
-    // choose mds
-    Inode *hash_diri = NULL;
-    mds_rank_t mds = choose_target_mds(request, &hash_diri);
-    int mds_state = (mds == MDS_RANK_NONE) ? MDSMap::STATE_NULL : mdsmap->get_state(mds);
-    if (mds_state != MDSMap::STATE_ACTIVE && mds_state != MDSMap::STATE_STOPPING) {
-      if (mds_state == MDSMap::STATE_NULL && mds >= mdsmap->get_max_mds()) {
-	if (hash_diri) {
-	  ldout(cct, 10) << " target mds." << mds << " has stopped, remove it from fragmap" << dendl;
-	  _fragmap_remove_stopped_mds(hash_diri, mds);
-	} else {
-	  ldout(cct, 10) << " target mds." << mds << " has stopped, trying a random mds" << dendl;
-	  request->resend_mds = _get_random_up_mds();
-	}
-      } else {
-	ldout(cct, 10) << " target mds." << mds << " not active, waiting for new mdsmap" << dendl;
-	wait_on_list(waiting_for_mdsmap);
-      }
-      continue;
-    }
+  // set up wait cond
+  request->caller_cond = caller_cond;
 
-    // open a session?
-    if (!have_open_session(mds)) {
-      session = _get_or_open_mds_session(mds);
-      if (session->state == MetaSession::STATE_REJECTED) {
-	request->abort(-CEPHFS_EPERM);
-	break;
-      }
-      // wait
-      if (session->state == MetaSession::STATE_OPENING) {
-	ldout(cct, 10) << "waiting for session to mds." << mds << " to open" << dendl;
-	wait_on_context_list(session->waiting_for_open);
-	continue;
+  // choose mds
+  Inode *hash_diri = NULL;
+  mds_rank_t mds = choose_target_mds(request, &hash_diri);
+  int mds_state = (mds == MDS_RANK_NONE) ? MDSMap::STATE_NULL : mdsmap->get_state(mds);
+  if (mds_state != MDSMap::STATE_ACTIVE && mds_state != MDSMap::STATE_STOPPING) {
+    if (mds_state == MDSMap::STATE_NULL && mds >= mdsmap->get_max_mds()) {
+      if (hash_diri) {
+	ldout(cct, 10) << " target mds." << mds << " has stopped, remove it from fragmap" << dendl;
+	_fragmap_remove_stopped_mds(hash_diri, mds);
+      } else {
+	ldout(cct, 10) << " target mds." << mds << " has stopped, trying a random mds" << dendl;
+	request->resend_mds = _get_random_up_mds();
       }
-
-      if (!have_open_session(mds))
-	continue;
     } else {
-      session = mds_sessions.at(mds);
+      ldout(cct, 10) << " target mds." << mds << " not active, waiting for new mdsmap" << dendl;
+      wait_on_list(waiting_for_mdsmap);
     }
+    return 1;
+  }
 
-    if (feature_needed != ULONG_MAX && !session->mds_features.test(feature_needed)) {
-      request->abort(-CEPHFS_EOPNOTSUPP);
-      break;
+  // open a session?
+  MetaSessionRef& session = *psession;
+  if (!have_open_session(mds)) {
+    session = _get_or_open_mds_session(mds);
+    if (session->state == MetaSession::STATE_REJECTED) {
+      request->abort(-CEPHFS_EPERM);
+      return -1;
+    }
+    // wait
+    if (session->state == MetaSession::STATE_OPENING) {
+      ldout(cct, 10) << "waiting for session to mds." << mds << " to open" << dendl;
+      wait_on_context_list(session->waiting_for_open);
+      return 1;
     }
 
-    // send request.
-    send_request(request, session.get());
-
-    // wait for signal
-    ldout(cct, 20) << "awaiting reply|forward|kick on " << &caller_cond << dendl;
-    request->kick = false;
-    std::unique_lock l{client_lock, std::adopt_lock};
-    caller_cond.wait(l, [request] {
-      return (request->reply ||	          // reply
-	      request->resend_mds >= 0 || // forward
-	      request->kick);
-    });
-    l.release();
-    request->caller_cond = nullptr;
+    if (!have_open_session(mds))
+      return 1;
+  } else {
+    session = mds_sessions.at(mds);
+  }
 
-    // did we get a reply?
-    if (request->reply)
-      break;
+  if (feature_needed != ULONG_MAX && !session->mds_features.test(feature_needed)) {
+    request->abort(-CEPHFS_EOPNOTSUPP);
+    return -1;
   }
 
+  // send request.
+  send_request(request, session.get());
+  request->kick = false;
+  return 0;
+}
+
+int Client::_finish_request(MetaRequest *request, MetaSession *session,
+			    const UserPerm& perms,
+			    InodeRef *ptarget, bool *pcreated,
+			    bufferlist *pdirbl)
+{
+  int r = 0;
+
   if (!request->reply) {
     ceph_assert(request->aborted());
     ceph_assert(!request->got_unsafe);
@@ -2082,11 +2083,11 @@ int Client::make_request(MetaRequest *request,
   // kick dispatcher (we've got it!)
   ceph_assert(request->dispatch_cond);
   request->dispatch_cond->notify_all();
-  ldout(cct, 20) << "sendrecv kickback on tid " << tid << " " << request->dispatch_cond << dendl;
+  ldout(cct, 20) << "sendrecv kickback on tid " << request->get_tid() << " " << request->dispatch_cond << dendl;
   request->dispatch_cond = 0;
   
   if (r >= 0 && ptarget)
-    r = verify_reply_trace(r, session.get(), request, reply, ptarget, pcreated, perms);
+    r = verify_reply_trace(r, session, request, reply, ptarget, pcreated, perms);
 
   if (pdirbl)
     *pdirbl = reply->get_extra_bl();
@@ -2103,6 +2104,116 @@ int Client::make_request(MetaRequest *request,
   return r;
 }
 
+int Client::make_request(MetaRequest *request,
+			 const UserPerm& perms,
+			 InodeRef *ptarget, bool *pcreated,
+			 mds_rank_t use_mds,
+			 bufferlist *pdirbl,
+			 size_t feature_needed)
+{
+  _register_request(request, perms, use_mds);
+
+  MetaSessionRef session = NULL;
+  while (1) {
+    ceph::condition_variable caller_cond;
+    int r = _send_request_attempt(request, &caller_cond, &session,
+				  feature_needed);
+    if (r > 0)
+      continue;
+    if (r < 0)
+      break;
+
+    // wait for signal
+    ldout(cct, 20) << "awaiting reply|forward|kick on " << &caller_cond << dendl;
+    std::unique_lock l{client_lock, std::adopt_lock};
+    caller_cond.wait(l, [request] {
+      return (request->reply ||	          // reply
+	      request->resend_mds >= 0 || // forward
+	      request->kick);
+    });
+    l.release();
+    request->caller_cond = nullptr;
+
+    // did we get a reply?
+    if (request->reply)
+      break;
+  }
+
+  return _finish_request(request, session.get(), perms, ptarget, pcreated,
+			 pdirbl);
+}
+
+/*
+ * Like make_request(), but keeps all of the requests in flight at once
+ * rather than waiting for each reply before sending the next request.
+ * results[i] is set to what make_request() would have returned for
+ * requests[i].
+ */
+void Client::make_requests(const std::vector<MetaRequest*>& requests,
+			   const UserPerm& perms, std::vector<int> *results)
+{
+  const size_t n = requests.size();
+  results->assign(n, 0);
+  for (auto request : requests) {
+    _register_request(request, perms, -1);
+  }
+
+  // one condition for the whole batch: any reply, forward or kick wakes us
+  ceph::condition_variable caller_cond;
+  std::vector<MetaSessionRef> sessions(n);
+  std::vector<bool> in_flight(n, false), done(n, false);
+  size_t num_done = 0;
+  while (num_done < n) {
+    for (size_t i = 0; i < n; ++i) {
+      if (done[i] || in_flight[i])
+	continue;
+      int r = _send_request_attempt(requests[i], &caller_cond, &sessions[i],
+				    ULONG_MAX);
+      if (r == 0) {
+	in_flight[i] = true;
+      } else if (r < 0) {
+	(*results)[i] = _finish_request(requests[i], sessions[i].get(), perms,
+					nullptr, nullptr, nullptr);
+	done[i] = true;
+	++num_done;
+      }
+    }
+
+    auto has_news = [&requests, &in_flight](size_t i) {
+      auto request = requests[i];
+      return in_flight[i] &&
+	(request->reply || request->resend_mds >= 0 || request->kick);
+    };
+    if (std::find(in_flight.begin(), in_flight.end(), true) == in_flight.end())
+      continue;
+    ldout(cct, 20) << __func__ << " " << n - num_done
+		   << " requests pending on " << &caller_cond << dendl;
+    std::unique_lock l{client_lock, std::adopt_lock};
+    caller_cond.wait(l, [n, &has_news] {
+      for (size_t i = 0; i < n; ++i) {
+	if (has_news(i))
+	  return true;
+      }
+      return false;
+    });
+    l.release();
+
+    for (size_t i = 0; i < n; ++i) {
+      if (!has_news(i))
+	continue;
+      auto request = requests[i];
+      in_flight[i] = false;
+      request->caller_cond = nullptr;
+      if (request->reply) {
+	(*results)[i] = _finish_request(request, sessions[i].get(), perms,
+					nullptr, nullptr, nullptr);
+	done[i] = true;
+	++num_done;
+      }
+    }
+  }
+}
+
 void Client::unregister_request(MetaRequest *req)
 {
   mds_requests.erase(req->tid);
@@ -5421,7 +5532,11 @@ void Client::handle_caps(const MConstRef<MClientCaps>& m)
       m->get_mseq(),
       cap_epoch_barrier);
 
-    flush_cap_releases();
+    // only this session has anything new to release; don't walk them all
+    // for every cap message of a recall storm
+    if (uint64_t nr_caps = flush_cap_release(session.get()); nr_caps > 0) {
+      dec_pinned_icaps(nr_caps);
+    }
     return;
   }
 
@@ -6989,23 +7104,29 @@ void Client::abort_conn()
   _unmount(true);
 }
 
+uint64_t Client::flush_cap_release(MetaSession *session)
+{
+  if (!session->release ||
+      !mdsmap->is_clientreplay_or_active_or_stopping(session->mds_num)) {
+    return 0;
+  }
+  uint64_t nr_caps = session->release->caps.size();
+  if (cct->_conf->client_inject_release_failure) {
+    ldout(cct, 20) << __func__ << " injecting failure to send cap release message" << dendl;
+  } else {
+    session->con->send_message2(std::move(session->release));
+  }
+  session->release.reset();
+  return nr_caps;
+}
+
 void Client::flush_cap_releases()
 {
   uint64_t nr_caps = 0;
 
   // send any cap releases
   for (auto &p : mds_sessions) {
-    auto session = p.second;
-    if (session->release && mdsmap->is_clientreplay_or_active_or_stopping(
-          p.first)) {
-      nr_caps += session->release->caps.size();
-      if (cct->_conf->client_inject_release_failure) {
-        ldout(cct, 20) << __func__ << " injecting failure to send cap release message" << dendl;
-      } else {
-        session->con->send_message2(std::move(session->release));
-      }
-      session->release.reset();
-    }
+    nr_caps += flush_cap_release(p.second.get());
   }
 
   if (nr_caps > 0) {
@@ -10228,6 +10349,7 @@ Fh *Client::_create_fh(Inode *in, int flags, int cmode, const UserPerm& perms)
   alignments.push_back(in->layout.get_period());
   alignments.push_back(in->layout.stripe_unit);
   f->readahead.set_alignments(alignments);
+  f->readahead.set_max_streams(conf->client_readahead_max_streams);
 
   return f;
 }
@@ -11003,6 +11125,33 @@ void Client::C_Readahead::finish(int r) {
   }
 }
 
+void Client::C_Direct_Write::finish(int r) {
+  std::scoped_lock l(client->client_lock);
+  if (r < 0) {
+    lgeneric_subdout(client->cct, client, 1) << "client." << client->get_nodeid()
+      << " I/O error from direct write on inode " << *in << ": " << r << dendl;
+    in->set_async_err(r);
+  }
+  ceph_assert(client->direct_write_bytes >= len);
+  client->direct_write_bytes -= len;
+  client->direct_write_cond.notify_all();
+  ceph_assert(in->direct_writes > 0);
+  if (--in->direct_writes == 0) {
+    client->signal_context_list(in->waitfor_commit);
+  }
+  client->put_cap_ref(in, CEPH_CAP_FILE_BUFFER);
+}
+
+void Client::wait_direct_writes(Inode *in)
+{
+  // the object cacher knows nothing of these, so flushing it is not enough
+  while (in->direct_writes > 0) {
+    ldout(cct, 10) << "ino " << in->ino << " has " << in->direct_writes
+		   << " direct writes in flight, waiting" << dendl;
+    wait_on_context_list(in->waitfor_commit);
+  }
+}
+
 void Client::do_readahead(Fh *f, Inode *in, uint64_t off, uint64_t len)
 {
   if(f->readahead.get_min_readahead_size() > 0) {
@@ -11496,8 +11645,11 @@ int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
     ceph_assert(in->inline_version > 0);
   }
 
-  // copy into fresh buffer (since our write may be resub, async)
+  // copy into fresh buffer (since our write may be resub, async).  Only
+  // the caller's buffer is touched, so do it without client_lock, as the
+  // read path does when copying out.
   bufferlist bl;
+  client_lock.unlock();
   if (buf) {
     if (size > 0)
       bl.append(buf, size);
@@ -11508,6 +11660,7 @@ int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
       }
     }
   }
+  client_lock.lock();
 
   int want, have;
   if (f->mode & CEPH_FILE_MODE_LAZY)
@@ -11532,6 +11685,16 @@ int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
 
   ldout(cct, 10) << " snaprealm " << *in->snaprealm << dendl;
 
+  // large buffered writes are sent straight to the OSDs rather than copied
+  // into the cache; like cached writes they return before they commit
+  const uint64_t direct_write_threshold = cct->_conf->client_oc_direct_write_threshold;
+  bool direct_write = cct->_conf->client_oc &&
+    direct_write_threshold > 0 && size >= direct_write_threshold &&
+    onfinish == nullptr &&
+    !(f->flags & (O_SYNC | O_DSYNC)) &&
+    in->inline_version >= CEPH_INLINE_NONE &&
+    (have & (CEPH_CAP_FILE_BUFFER | CEPH_CAP_FILE_LAZYIO));
+
   std::unique_ptr<Context> iofinish = nullptr;
   std::unique_ptr<C_Write_Finisher> cwf = nullptr;
   
@@ -11563,6 +11726,38 @@ int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
     }
   }
 
+  if (direct_write) {
+    // write back and drop whatever the cache holds for the range, so that
+    // neither a later flush nor a cached read can undo this write
+    _flush_range(in, offset, size);
+    vector<ObjectExtent> ls;
+    Striper::file_to_extents(cct, in->ino, &in->layout, offset, size,
+			     in->truncate_size, ls);
+    objectcacher->discard_set(&in->oset, ls);
+
+    const uint64_t max_bytes = cct->_conf->client_oc_direct_write_max_in_flight;
+    if (direct_write_bytes > 0 && direct_write_bytes + size > max_bytes) {
+      ldout(cct, 10) << " " << direct_write_bytes << " direct write bytes in flight, waiting" << dendl;
+      std::unique_lock l{client_lock, std::adopt_lock};
+      direct_write_cond.wait(l, [this, size, max_bytes] {
+	return direct_write_bytes == 0 || direct_write_bytes + size <= max_bytes;
+      });
+      l.release();
+    }
+
+    // the FILE_BUFFER ref makes fsync and cap revocation wait for the
+    // write to commit; errors are reported through async_err
+    get_cap_ref(in, CEPH_CAP_FILE_BUFFER);
+    direct_write_bytes += size;
+    ++in->direct_writes;
+    ldout(cct, 10) << " direct write " << offset << "~" << size << dendl;
+    filer->write_trunc(in->ino, &in->layout, in->snaprealm->get_snap_context(),
+		       offset, size, bl, ceph::real_clock::now(), 0,
+		       in->truncate_size, in->truncate_seq,
+		       new C_Direct_Write(this, in, size));
+    goto success;
+  }
+
   if (onfinish) {
      cwf_iofinish = new CWF_iofinish();
      iofinish.reset(cwf_iofinish);
@@ -11714,6 +11909,8 @@ done:
 int Client::_flush(Fh *f)
 {
   Inode *in = f->inode.get();
+  // direct writes report their errors through async_err
+  wait_direct_writes(in);
   int err = f->take_async_err();
   if (err != 0) {
     ldout(cct, 1) << __func__ << ": " << f << " on inode " << *in << " caught async_err = "
@@ -11880,6 +12077,15 @@ void Client::C_nonblocking_fsync_state::advance()
     ldout(clnt->cct, 15) << "Client::C_nonblocking_fsync_state::advance - case 2" << dendl;
 
     if (flush_completed) {
+      // the object cacher does not cover writes sent around it
+      if (in->direct_writes > 0) {
+        ldout(clnt->cct, 10) << "ino " << in->ino << " has " << in->direct_writes
+                             << " direct writes in flight, waiting" << dendl;
+        advancer = new C_nonblocking_fsync_state_advancer(clnt, this);
+        clnt->add_nonblocking_onfinish_to_context_list(in->waitfor_commit, advancer);
+        // ------------  here is a state machine break point
+        return;
+      }
       // we waited for real reply above, now we have it... retrieve result
       ldout(clnt->cct, 15) << "got " << result << " from flush writeback" << dendl;
     }
@@ -12035,6 +12241,7 @@ int Client::_fsync(Inode *in, bool syncdataonly)
     r = object_cacher_completion->wait();
     client_lock.lock();
     ldout(cct, 15) << "got " << r << " from flush writeback" << dendl;
+    wait_direct_writes(in);
   } else {
     // FIXME: this can starve
     while (in->cap_refs[CEPH_CAP_FILE_BUFFER] > 0) {
@@ -15047,12 +15254,9 @@ int Client::ll_symlinkx(Inode *parent, const char *name, const char *value,
   return r;
 }
 
-int Client::_unlink(Inode *dir, const char *name, const UserPerm& perm)
+int Client::_prepare_unlink(Inode *dir, const char *name,
+			    const UserPerm& perm, MetaRequest **preq)
 {
-  ldout(cct, 8) << "_unlink(" << dir->ino << " " << name
-		<< " uid " << perm.uid() << " gid " << perm.gid()
-		<< ")" << dendl;
-
   if (dir->snapid != CEPH_NOSNAP) {
     return -CEPHFS_EROFS;
   }
@@ -15084,10 +15288,25 @@ int Client::_unlink(Inode *dir, const char *name, const UserPerm& perm)
 
   req->set_inode(dir);
 
+  *preq = req;
+  return 0;
+}
+
+int Client::_unlink(Inode *dir, const char *name, const UserPerm& perm)
+{
+  ldout(cct, 8) << "_unlink(" << dir->ino << " " << name
+		<< " uid " << perm.uid() << " gid " << perm.gid()
+		<< ")" << dendl;
+
+  MetaRequest *req;
+  int res = _prepare_unlink(dir, name, perm, &req);
+  if (res < 0)
+    return res;
+
   res = make_request(req, perm);
 
   trim_cache();
-  ldout(cct, 8) << "unlink(" << path << ") = " << res << dendl;
+  ldout(cct, 8) << "unlink(" << dir->ino << " " << name << ") = " << res << dendl;
   return res;
 }
 
@@ -15114,6 +15333,52 @@ int Client::ll_unlink(Inode *in, const char *name, const UserPerm& perm)
   return _unlink(in, name, perm);
 }
 
+int Client::ll_unlink_batch(Inode *in, const std::vector<std::string>& names,
+			    const UserPerm& perm, std::vector<int> *results)
+{
+  RWRef_t mref_reader(mount_state, CLIENT_MOUNTING);
+  if (!mref_reader.is_state_satisfied())
+    return -CEPHFS_ENOTCONN;
+
+  vinodeno_t vino = _get_vino(in);
+
+  ldout(cct, 3) << "ll_unlink_batch " << vino << " " << names.size()
+		<< " names" << dendl;
+  tout(cct) << "ll_unlink_batch" << std::endl;
+  tout(cct) << vino.ino.val << std::endl;
+  tout(cct) << names.size() << std::endl;
+
+  std::scoped_lock lock(client_lock);
+
+  results->assign(names.size(), 0);
+  std::vector<MetaRequest*> reqs;
+  std::vector<size_t> req_idx;
+  for (size_t i = 0; i < names.size(); ++i) {
+    const char *name = names[i].c_str();
+    int r = 0;
+    if (!fuse_default_permissions)
+      r = may_delete(in, name, perm);
+    MetaRequest *req = nullptr;
+    if (r >= 0)
+      r = _prepare_unlink(in, name, perm, &req);
+    if (r < 0) {
+      (*results)[i] = r;
+      continue;
+    }
+    reqs.push_back(req);
+    req_idx.push_back(i);
+  }
+
+  std::vector<int> req_results;
+  make_requests(reqs, perm, &req_results);
+  for (size_t j = 0; j < reqs.size(); ++j) {
+    (*results)[req_idx[j]] = req_results[j];
+  }
+
+  trim_cache();
+  return 0;
+}
+
 int Client::_rmdir(Inode *dir, const char *name, const UserPerm& perms)
 {
   ldout(cct, 8) << "_rmdir(" << dir->ino << " " << name << " uid "
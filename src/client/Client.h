@@ -614,6 +614,8 @@ public:
 		  Inode **out, struct ceph_statx *stx, unsigned want,
 		  unsigned flags, const UserPerm& perms);
   int ll_unlink(Inode *in, const char *name, const UserPerm& perm);
+  int ll_unlink_batch(Inode *in, const std::vector<std::string>& names,
+		      const UserPerm& perm, std::vector<int> *results);
   int ll_rmdir(Inode *in, const char *name, const UserPerm& perms);
   int ll_rename(Inode *parent, const char *name, Inode *newparent,
 		const char *newname, const UserPerm& perm);
@@ -835,6 +837,7 @@ public:
   void renew_caps();
   void renew_caps(MetaSession *session);
   void flush_cap_releases();
+  uint64_t flush_cap_release(MetaSession *session);
   void renew_and_flush_cap_releases();
   void tick();
   void start_tick_thread();
@@ -958,8 +961,18 @@ protected:
                    InodeRef *ptarget = 0, bool *pcreated = 0,
                    mds_rank_t use_mds=-1, bufferlist *pdirbl=0,
                    size_t feature_needed=ULONG_MAX);
+  void make_requests(const std::vector<MetaRequest*>& requests,
+		     const UserPerm& perms, std::vector<int> *results);
   void put_request(MetaRequest *request);
   void unregister_request(MetaRequest *request);
+  void _register_request(MetaRequest *request, const UserPerm& perms,
+			 mds_rank_t use_mds);
+  int _send_request_attempt(MetaRequest *request,
+			    ceph::condition_variable *caller_cond,
+			    MetaSessionRef *psession, size_t feature_needed);
+  int _finish_request(MetaRequest *request, MetaSession *session,
+		      const UserPerm& perms, InodeRef *ptarget, bool *pcreated,
+		      bufferlist *pdirbl);
 
   int verify_reply_trace(int r, MetaSession *session, MetaRequest *request,
 			 const MConstRef<MClientReply>& reply,
@@ -1035,6 +1048,7 @@ protected:
   }
   void wait_on_context_list(std::list<Context*>& ls);
   void signal_context_list(std::list<Context*>& ls);
+  void wait_direct_writes(Inode *in);
   void signal_caps_inode(Inode *in);
 
   // -- metadata cache stuff
@@ -1521,6 +1535,16 @@ private:
     Fh *f;
   };
 
+  struct C_Direct_Write : public Context {
+    C_Direct_Write(Client *c, Inode *in, uint64_t len)
+      : client(c), in(in), len(len) {}
+    void finish(int r) override;
+
+    Client *client;
+    Inode *in;
+    uint64_t len;
+  };
+
   /*
    * These define virtual xattrs exposing the recursive directory
    * statistics and layout metadata.
@@ -1614,6 +1638,8 @@ private:
 
   int _link(Inode *in, Inode *dir, const char *name, const UserPerm& perm, std::string alternate_name,
 	    InodeRef *inp = 0);
+  int _prepare_unlink(Inode *dir, const char *name, const UserPerm& perm,
+		      MetaRequest **preq);
   int _unlink(Inode *dir, const char *name, const UserPerm& perm);
   int _rename(Inode *olddir, const char *oname, Inode *ndir, const char *nname, const UserPerm& perm, std::string alternate_name);
   int _mkdir(Inode *dir, const char *name, mode_t mode, const UserPerm& perm,
@@ -1876,6 +1902,10 @@ private:
 
   std::list<ceph::condition_variable*> waiting_for_rename;
 
+  // uncommitted writes sent around the object cacher, see _write()
+  uint64_t direct_write_bytes = 0;
+  ceph::condition_variable direct_write_cond;
+
   uint64_t retries_on_invalidate = 0;
 
   // state reclaim
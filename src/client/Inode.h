@@ -224,6 +224,7 @@ struct Inode : RefCountedObject {
   //int open_by_mode[CEPH_FILE_MODE_NUM];
   std::map<int,int> open_by_mode;
   std::map<int,int> cap_refs;
+  int direct_writes = 0;  // in flight around the object cacher
 
   ObjectCacher::ObjectSet oset; // ORDER DEPENDENCY: ino
 
@@ -1429,7 +1429,7 @@ int CephFuse::Handle::init(int argc, const char *argv[])
 
   // set up fuse argc/argv
   int newargc = 0;
-  const char **newargv = (const char **) malloc((argc + 17) * sizeof(char *));
+  const char **newargv = (const char **) malloc((argc + 21) * sizeof(char *));
   if(!newargv)
     return ENOMEM;
 
@@ -1456,6 +1456,15 @@ int CephFuse::Handle::init(int argc, const char *argv[])
     "fuse_splice_move");
   auto fuse_debug = client->cct->_conf.get_val<bool>(
     "fuse_debug");
+#if FUSE_VERSION >= FUSE_MAKE_VERSION(3, 0)
+  auto fuse_clone_fd = client->cct->_conf.get_val<bool>(
+    "fuse_clone_fd");
+#endif
+#if FUSE_VERSION >= FUSE_MAKE_VERSION(3, 12)
+  auto fuse_max_threads = client->cct->_conf.get_val<uint64_t>(
+    "fuse_max_threads");
+  char strmaxthreads[65];
+#endif
 
   if (fuse_allow_other) {
     newargv[newargc++] = "-o";
@@ -1494,6 +1503,19 @@ int CephFuse::Handle::init(int argc, const char *argv[])
     newargv[newargc++] = "-o";
     newargv[newargc++] = "splice_move";
   }
+#endif
+#if FUSE_VERSION >= FUSE_MAKE_VERSION(3, 0)
+  if (fuse_clone_fd) {
+    newargv[newargc++] = "-o";
+    newargv[newargc++] = "clone_fd";
+  }
+#endif
+#if FUSE_VERSION >= FUSE_MAKE_VERSION(3, 12)
+  if (fuse_max_threads > 0) {
+    newargv[newargc++] = "-o";
+    sprintf(strmaxthreads, "max_threads=%zu", (size_t)fuse_max_threads);
+    newargv[newargc++] = strmaxthreads;
+  }
 #endif
   if (fuse_debug)
     newargv[newargc++] = "-d";
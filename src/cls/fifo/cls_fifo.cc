@@ -97,16 +97,24 @@ int write_header(cls_method_context_t hctx,
   return cls_cxx_write_full(hctx, &bl);
 }
 
+/// with a readahead, also read that many bytes of the entries that follow
+/// the header, and leave them in *entries (from CLS_FIFO_MAX_PART_HEADER_SIZE)
 int read_part_header(cls_method_context_t hctx,
-		     part_header* part_header)
+		     part_header* part_header,
+		     std::uint64_t readahead = 0,
+		     ceph::buffer::list* entries = nullptr)
 {
   ceph::buffer::list bl;
-  int r = cls_cxx_read2(hctx, 0, CLS_FIFO_MAX_PART_HEADER_SIZE, &bl,
+  int r = cls_cxx_read2(hctx, 0, CLS_FIFO_MAX_PART_HEADER_SIZE + readahead, &bl,
 			CEPH_OSD_OP_FLAG_FADVISE_WILLNEED);
   if (r < 0) {
     CLS_ERR("ERROR: %s: cls_cxx_read2() on obj returned %d", __PRETTY_FUNCTION__, r);
     return r;
   }
+  if (entries && bl.length() > CLS_FIFO_MAX_PART_HEADER_SIZE) {
+    entries->substr_of(bl, CLS_FIFO_MAX_PART_HEADER_SIZE,
+		       bl.length() - CLS_FIFO_MAX_PART_HEADER_SIZE);
+  }
 
   auto iter = bl.cbegin();
   try {
@@ -563,8 +571,10 @@ int push_part(cls_method_context_t hctx, ceph::buffer::list* in,
 }
 
 class EntryReader {
+public:
   static constexpr std::uint64_t prefetch_len = (128 * 1024);
 
+private:
   cls_method_context_t hctx;
 
   const fifo::part_header& part_header;
@@ -585,6 +595,19 @@ public:
 			      ofs(ofs < part_header.min_ofs ?
 				  part_header.min_ofs :
 				  ofs) {}
+  /// start with the bytes in prefetched, read from prefetched_ofs on
+  EntryReader(cls_method_context_t hctx,
+              const fifo::part_header& part_header,
+              uint64_t ofs,
+              const ceph::buffer::list& prefetched,
+              uint64_t prefetched_ofs)
+    : EntryReader(hctx, part_header, ofs) {
+    if (this->ofs >= prefetched_ofs &&
+	this->ofs < prefetched_ofs + prefetched.length()) {
+      auto skip = this->ofs - prefetched_ofs;
+      data.substr_of(prefetched, skip, prefetched.length() - skip);
+    }
+  }
 
   std::uint64_t get_ofs() const {
     return ofs;
@@ -834,14 +857,21 @@ int list_part(cls_method_context_t hctx, ceph::buffer::list* in,
     return -EINVAL;
   }
 
+  // listing from the start of the part is the common case (draining
+  // the tail), so read the first entries along with the header then
   part_header part_header;
-  int r = read_part_header(hctx, &part_header);
+  ceph::buffer::list prefetched;
+  bool from_start = op.ofs < CLS_FIFO_MAX_PART_HEADER_SIZE;
+  int r = read_part_header(hctx, &part_header,
+			   from_start ? EntryReader::prefetch_len : 0,
+			   &prefetched);
   if (r < 0) {
     CLS_ERR("%s: failed to read part header", __PRETTY_FUNCTION__);
     return r;
   }
 
-  EntryReader reader(hctx, part_header, op.ofs);
+  EntryReader reader(hctx, part_header, op.ofs,
+		     prefetched, CLS_FIFO_MAX_PART_HEADER_SIZE);
 
   if (op.ofs >= part_header.min_ofs &&
       !reader.end()) {
@@ -3771,11 +3771,7 @@ static int usage_log_trim_cb(cls_method_context_t hctx, const string& key, rgw_u
   usage_record_name_by_time(entry.epoch, o, entry.bucket, key_by_time);
   usage_record_name_by_user(o, entry.epoch, entry.bucket, key_by_user);
 
-  int ret = cls_cxx_map_remove_key(hctx, key_by_time);
-  if (ret < 0)
-    return ret;
-
-  return cls_cxx_map_remove_key(hctx, key_by_user);
+  return cls_cxx_map_remove_keys(hctx, {key_by_time, key_by_user});
 }
 
 int rgw_user_usage_log_trim(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
@@ -4,9 +4,12 @@
 #ifndef CEPH_OS_BLUESTORE_CHECKSUMMER
 #define CEPH_OS_BLUESTORE_CHECKSUMMER
 
+#include <cstring>
+
 #include "include/buffer.h"
 #include "include/byteorder.h"
 #include "include/ceph_assert.h"
+#include "include/crc32c.h"
 
 #include "xxHash/xxhash.h"
 
@@ -90,6 +93,16 @@ public:
       ) {
       return p.crc32c(len, init_value);
     }
+    static init_value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *data
+      ) {
+      return ceph_crc32c(init_value,
+			 reinterpret_cast<const unsigned char*>(data),
+			 len);
+    }
   };
 
   struct crc32c_16 {
@@ -111,6 +124,16 @@ public:
       ) {
       return p.crc32c(len, init_value) & 0xffff;
     }
+    static init_value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *data
+      ) {
+      return ceph_crc32c(init_value,
+			 reinterpret_cast<const unsigned char*>(data),
+			 len) & 0xffff;
+    }
   };
 
   struct crc32c_8 {
@@ -132,6 +155,16 @@ public:
       ) {
       return p.crc32c(len, init_value) & 0xff;
     }
+    static init_value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *data
+      ) {
+      return ceph_crc32c(init_value,
+			 reinterpret_cast<const unsigned char*>(data),
+			 len) & 0xff;
+    }
   };
 
   struct xxhash32 {
@@ -161,6 +194,15 @@ public:
       }
       return XXH32_digest(state);
     }
+    static init_value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *data
+      ) {
+      // one-shot; cheaper than reset/update/digest on the shared state
+      return XXH32(data, len, init_value);
+    }
   };
 
   struct xxhash64 {
@@ -190,6 +232,15 @@ public:
       }
       return XXH64_digest(state);
     }
+    static init_value_t calc(
+      state_t state,
+      init_value_t init_value,
+      size_t len,
+      const char *data
+      ) {
+      // one-shot; cheaper than reset/update/digest on the shared state
+      return XXH64(data, len, init_value);
+    }
   };
 
   template<class Alg>
@@ -253,18 +304,40 @@ public:
       reinterpret_cast<const typename Alg::value_t*>(csum_data.c_str());
     pv += offset / csum_block_size;
     size_t pos = offset;
+
+    // Checksum a batch of chunks back to back and compare the whole batch
+    // against the stored values at once; only a mismatching batch is
+    // looked at chunk by chunk.  Chunks that sit in a single contiguous
+    // buffer (the common case for aio reads) are hashed straight from
+    // memory instead of going through the bufferlist iterator.
+    static constexpr size_t batch_size = 32;
+    typename Alg::value_t v[batch_size];
     while (length > 0) {
-      typename Alg::init_value_t v = Alg::calc(state, -1, csum_block_size, p);
-      if (*pv != v) {
-	if (bad_csum) {
-	  *bad_csum = v;
+      size_t n = std::min(batch_size, length / csum_block_size);
+      for (size_t i = 0; i < n; ++i) {
+	auto q = p;
+	const char *data;
+	if (q.get_ptr_and_advance(csum_block_size, &data) == csum_block_size) {
+	  v[i] = Alg::calc(state, -1, csum_block_size, data);
+	  p = q;
+	} else {
+	  v[i] = Alg::calc(state, -1, csum_block_size, p);
 	}
-	Alg::fini(&state);
-	return pos;
       }
-      ++pv;
-      pos += csum_block_size;
-      length -= csum_block_size;
+      if (memcmp(v, pv, n * sizeof(typename Alg::value_t)) != 0) {
+	for (size_t i = 0; i < n; ++i) {
+	  if (pv[i] != v[i]) {
+	    if (bad_csum) {
+	      *bad_csum = v[i];
+	    }
+	    Alg::fini(&state);
+	    return pos + i * csum_block_size;
+	  }
+	}
+      }
+      pv += n;
+      pos += n * csum_block_size;
+      length -= n * csum_block_size;
     }
     Alg::fini(&state);
     return -1;  // no errors
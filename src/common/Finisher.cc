@@ -3,10 +3,128 @@
 
 #include "Finisher.h"
 
+#include <algorithm>
+
 #define dout_subsys ceph_subsys_finisher
 #undef dout_prefix
 #define dout_prefix *_dout << "finisher(" << this << ") "
 
+/// How many nodes of a batch the worker hands back for reuse; anything
+/// beyond that is freed.
+static constexpr size_t MAX_RECYCLED_ITEMS = 256;
+
+struct Finisher::ItemCache {
+  QueueItem *head = nullptr;
+  ~ItemCache() {
+    while (head) {
+      QueueItem *next = head->next;
+      delete head;
+      head = next;
+    }
+  }
+};
+
+// shared by all finishers; the nodes carry no per-finisher state
+thread_local Finisher::ItemCache Finisher::item_cache;
+
+Finisher::Finisher(CephContext *cct_) :
+  cct(cct_), finisher_lock(ceph::make_mutex("Finisher::finisher_lock")),
+  finisher_stop(false), finisher_running(false), finisher_empty_wait(false),
+  lockless(cct && cct->_conf.get_val<bool>("finisher_lockless_queue")),
+  thread_name("fn_anonymous"), logger(0),
+  finisher_thread(this) {}
+
+Finisher::Finisher(CephContext *cct_, std::string name, std::string tn) :
+  cct(cct_), finisher_lock(ceph::make_mutex("Finisher::" + name)),
+  finisher_stop(false), finisher_running(false), finisher_empty_wait(false),
+  lockless(cct && cct->_conf.get_val<bool>("finisher_lockless_queue")),
+  thread_name(tn), logger(0),
+  finisher_thread(this)
+{
+  PerfCountersBuilder b(cct, std::string("finisher-") + name,
+			l_finisher_first, l_finisher_last);
+  b.add_u64(l_finisher_queue_len, "queue_len");
+  b.add_time_avg(l_finisher_complete_lat, "complete_latency");
+  b.add_time_avg(l_finisher_queue_lat, "queue_latency",
+		 "Time contexts waited in the queue before being completed");
+  b.add_u64_avg(l_finisher_batch_size, "batch_size",
+		"Contexts completed per wakeup of the worker");
+  logger = b.create_perf_counters();
+  cct->get_perfcounters_collection()->add(logger);
+  logger->set(l_finisher_queue_len, 0);
+  logger->set(l_finisher_complete_lat, 0);
+}
+
+Finisher::~Finisher()
+{
+  _delete_items(free_items.exchange(nullptr));
+  if (logger && cct) {
+    cct->get_perfcounters_collection()->remove(logger);
+    delete logger;
+  }
+}
+
+ceph::mono_time Finisher::_stamp() const
+{
+  if (logger && cct->_conf->perf)
+    return ceph::mono_clock::now();
+  return {};
+}
+
+Finisher::QueueItem *Finisher::_new_item(Context *c, int r,
+					   ceph::mono_time stamp)
+{
+  auto& cache = item_cache;
+  if (!cache.head) {
+    // take all of them: with only whole-list pops the stack is ABA-free
+    cache.head = free_items.exchange(nullptr, std::memory_order_acquire);
+  }
+  QueueItem *item = cache.head;
+  if (item) {
+    cache.head = item->next;
+  } else {
+    item = new QueueItem;
+  }
+  *item = _make_item(c, r, stamp);
+  return item;
+}
+
+void Finisher::_delete_items(QueueItem *items)
+{
+  while (items) {
+    QueueItem *next = items->next;
+    delete items;
+    items = next;
+  }
+}
+
+void Finisher::_take_stack()
+{
+  QueueItem *item = finisher_stack.exchange(nullptr, std::memory_order_acquire);
+  QueueItem *keep = item, *keep_last = nullptr;
+  size_t n = 0;
+  for (; item; item = item->next) {
+    in_progress_queue.push_back(*item);
+    if (++n == MAX_RECYCLED_ITEMS)
+      keep_last = item;
+  }
+  // the stack is newest first
+  std::reverse(in_progress_queue.begin(), in_progress_queue.end());
+
+  // hand the nodes back if the producers have used up the last lot
+  QueueItem *rest = nullptr;
+  if (keep_last) {
+    rest = keep_last->next;
+    keep_last->next = nullptr;
+  }
+  QueueItem *expected = nullptr;
+  if (!free_items.compare_exchange_strong(expected, keep,
+					  std::memory_order_release)) {
+    _delete_items(keep);
+  }
+  _delete_items(rest);
+}
+
 void Finisher::start()
 {
   ldout(cct, 10) << __func__ << dendl;
@@ -29,9 +147,12 @@ void Finisher::stop()
 void Finisher::wait_for_empty()
 {
   std::unique_lock ul(finisher_lock);
-  while (!finisher_queue.empty() || finisher_running) {
+  while (_have_work() || finisher_running) {
     ldout(cct, 10) << "wait_for_empty waiting" << dendl;
     finisher_empty_wait = true;
+    // the worker may be asleep with the queue just filled; make sure it
+    // notices, it will signal us once it has drained the queue.
+    finisher_cond.notify_one();
     finisher_empty_cond.wait(ul);
   }
   ldout(cct, 10) << "wait_for_empty empty" << dendl;
@@ -40,6 +161,8 @@ void Finisher::wait_for_empty()
 
 bool Finisher::is_empty()
 {
+  if (lockless)
+    return finisher_stack.load() == nullptr;
   std::unique_lock ul(finisher_lock);
   return finisher_queue.empty();
 }
@@ -53,23 +176,38 @@ void *Finisher::finisher_thread_entry()
   uint64_t count = 0;
   while (!finisher_stop) {
     /// Every time we are woken up, we process the queue until it is empty.
-    while (!finisher_queue.empty()) {
-      // To reduce lock contention, we swap out the queue to process.
-      // This way other threads can submit new contexts to complete
-      // while we are working.
-      in_progress_queue.swap(finisher_queue);
+    while (_have_work()) {
       finisher_running = true;
-      ul.unlock();
+      if (lockless) {
+	// Take the whole stack in one go.  Producers never block on us;
+	// they keep pushing onto a fresh stack while we are working.
+	ul.unlock();
+	_take_stack();
+      } else {
+	// To reduce lock contention, we swap out the queue to process.
+	// This way other threads can submit new contexts to complete
+	// while we are working.
+	in_progress_queue.swap(finisher_queue);
+	ul.unlock();
+      }
       ldout(cct, 10) << "finisher_thread doing " << in_progress_queue << dendl;
 
       if (logger) {
 	start = ceph_clock_now();
 	count = in_progress_queue.size();
+	auto now = ceph::mono_clock::now();
+	for (const auto& i : in_progress_queue) {
+	  // not stamped if perf was off when it was queued
+	  if (i.stamp != ceph::mono_time{}) {
+	    logger->tinc(l_finisher_queue_lat, now - i.stamp);
+	  }
+	}
+	logger->inc(l_finisher_batch_size, count);
       }
 
       // Now actually process the contexts.
-      for (auto p : in_progress_queue) {
-	p.first->complete(p.second);
+      for (const auto& i : in_progress_queue) {
+	i.c->complete(i.r);
       }
       ldout(cct, 10) << "finisher_thread done with " << in_progress_queue
                      << dendl;
@@ -87,9 +225,17 @@ void *Finisher::finisher_thread_entry()
       finisher_empty_cond.notify_all();
     if (finisher_stop)
       break;
-    
-    ldout(cct, 10) << "finisher_thread sleeping" << dendl;
-    finisher_cond.wait(ul);
+
+    // Announce that we are going to sleep *before* the final check of the
+    // queue; a producer that pushed after that check will see the flag
+    // and wake us up (it needs finisher_lock to do so, which we only drop
+    // inside wait()).
+    finisher_sleeping = true;
+    if (!_have_work()) {
+      ldout(cct, 10) << "finisher_thread sleeping" << dendl;
+      finisher_cond.wait(ul);
+    }
+    finisher_sleeping = false;
   }
   // If we are exiting, we signal the thread waiting in stop(),
   // otherwise it would never unblock
@@ -99,4 +245,3 @@ void *Finisher::finisher_thread_entry()
   finisher_stop = false;
   return 0;
 }
-
@@ -19,6 +19,7 @@
 #include "include/common_fwd.h"
 #include "common/Thread.h"
 #include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 #include "common/perf_counters.h"
 #include "common/Cond.h"
 
@@ -28,6 +29,8 @@ enum {
   l_finisher_first = 997082,
   l_finisher_queue_len,
   l_finisher_complete_lat,
+  l_finisher_queue_lat,
+  l_finisher_batch_size,
   l_finisher_last
 };
 
@@ -35,19 +38,44 @@ enum {
  * Finisher asynchronously completes Contexts, which are simple classes
  * representing callbacks, in a dedicated worker thread. Enqueuing
  * contexts to complete is thread-safe.
+ *
+ * With finisher_lockless_queue, producers push onto a lock-free stack and
+ * only take finisher_lock to wake the worker when it is (about to be)
+ * asleep; the worker grabs the whole stack at once and completes it in
+ * FIFO order. Otherwise every queue() takes finisher_lock.
  */
 class Finisher {
+  struct QueueItem {
+    Context *c = nullptr;
+    int r = 0;
+    ceph::mono_time stamp; ///< When it was queued, only set if _stamp() is.
+    QueueItem *next = nullptr; ///< Only used by the lock-free stack.
+
+    friend std::ostream& operator<<(std::ostream& out, const QueueItem& i) {
+      return out << i.c << "," << i.r;
+    }
+  };
+  /// Per-thread cache of stack nodes, refilled from free_items.
+  struct ItemCache;
+  static thread_local ItemCache item_cache;
+
   CephContext *cct;
-  ceph::mutex finisher_lock; ///< Protects access to queues and finisher_running.
+  ceph::mutex finisher_lock; ///< Protects the queue (unless lockless), the sleep/wakeup handshake and finisher_running.
   ceph::condition_variable finisher_cond; ///< Signaled when there is something to process.
   ceph::condition_variable finisher_empty_cond; ///< Signaled when the finisher has nothing more to process.
   bool         finisher_stop; ///< Set when the finisher should stop.
   bool         finisher_running; ///< True when the finisher is currently executing contexts.
   bool	       finisher_empty_wait; ///< True mean someone wait finisher empty.
+  const bool   lockless; ///< finisher_lockless_queue when we were constructed.
+  std::atomic<bool> finisher_sleeping = {false}; ///< True when the worker may be waiting on finisher_cond.
 
-  /// Queue for contexts for which complete(0) will be called.
-  std::vector<std::pair<Context*,int>> finisher_queue;
-  std::vector<std::pair<Context*,int>> in_progress_queue;
+  /// Queue for contexts for which complete() will be called.
+  std::vector<QueueItem> finisher_queue;
+  /// The same for the lockless queue, most recent first.
+  std::atomic<QueueItem*> finisher_stack = {nullptr};
+  /// Nodes of the last batch, handed back to the producers for reuse.
+  std::atomic<QueueItem*> free_items = {nullptr};
+  std::vector<QueueItem> in_progress_queue;
 
   std::string thread_name;
 
@@ -56,6 +84,11 @@ class Finisher {
   PerfCounters *logger;
 
   void *finisher_thread_entry();
+  bool _have_work() const {
+    return lockless ? finisher_stack.load() != nullptr : !finisher_queue.empty();
+  }
+  void _take_stack();
+  void _delete_items(QueueItem *items);
 
   struct FinisherThread : public Thread {
     Finisher *fin;
@@ -63,60 +96,91 @@ class Finisher {
     void* entry() override { return fin->finisher_thread_entry(); }
   } finisher_thread;
 
- public:
-  /// Add a context to complete, optionally specifying a parameter for the complete function.
-  void queue(Context *c, int r = 0) {
-    std::unique_lock ul(finisher_lock);
-    bool was_empty = finisher_queue.empty();
-    finisher_queue.push_back(std::make_pair(c, r));
-    if (was_empty) {
+  /// Enqueue time for the queue_latency counter, or zero if nobody looks.
+  ceph::mono_time _stamp() const;
+  static QueueItem _make_item(Context *c, int r, ceph::mono_time stamp) {
+    QueueItem item;
+    item.c = c;
+    item.r = r;
+    item.stamp = stamp;
+    return item;
+  }
+  /// Get a stack node, reusing one from this thread's cache if we can.
+  QueueItem *_new_item(Context *c, int r, ceph::mono_time stamp);
+
+  /// Push the chain first..last (last being the oldest item) and wake the worker.
+  void _push(QueueItem *first, QueueItem *last, size_t count) {
+    QueueItem *head = finisher_stack.load(std::memory_order_relaxed);
+    do {
+      last->next = head;
+    } while (!finisher_stack.compare_exchange_weak(head, first));
+    if (logger)
+      logger->inc(l_finisher_queue_len, count);
+    // pairs with the store to finisher_sleeping in finisher_thread_entry():
+    // either the worker sees our items, or we see that it is going to sleep.
+    if (finisher_sleeping.load()) {
+      std::lock_guard l(finisher_lock);
       finisher_cond.notify_one();
     }
-    if (logger)
-      logger->inc(l_finisher_queue_len);
   }
 
-  void queue(std::list<Context*>& ls) {
-    {
-      std::unique_lock ul(finisher_lock);
-      if (finisher_queue.empty()) {
-	finisher_cond.notify_all();
-      }
+  template <typename Container>
+  void _queue(Container& ls) {
+    if (ls.empty())
+      return;
+    // one stamp for the whole list, they are all queued at once
+    const auto stamp = _stamp();
+    if (lockless) {
+      QueueItem *first = nullptr, *last = nullptr;
       for (auto i : ls) {
-	finisher_queue.push_back(std::make_pair(i, 0));
+	auto item = _new_item(i, 0, stamp);
+	item->next = first;
+	first = item;
+	if (!last)
+	  last = item;
       }
-      if (logger)
-	logger->inc(l_finisher_queue_len, ls.size());
-    }
-    ls.clear();
-  }
-  void queue(std::deque<Context*>& ls) {
-    {
+      _push(first, last, ls.size());
+    } else {
       std::unique_lock ul(finisher_lock);
       if (finisher_queue.empty()) {
 	finisher_cond.notify_all();
       }
       for (auto i : ls) {
-	finisher_queue.push_back(std::make_pair(i, 0));
+	finisher_queue.push_back(_make_item(i, 0, stamp));
       }
       if (logger)
 	logger->inc(l_finisher_queue_len, ls.size());
     }
     ls.clear();
   }
-  void queue(std::vector<Context*>& ls) {
-    {
-      std::unique_lock ul(finisher_lock);
-      if (finisher_queue.empty()) {
-	finisher_cond.notify_all();
-      }
-      for (auto i : ls) {
-	finisher_queue.push_back(std::make_pair(i, 0));
-      }
-      if (logger)
-	logger->inc(l_finisher_queue_len, ls.size());
+
+ public:
+  /// Add a context to complete, optionally specifying a parameter for the complete function.
+  void queue(Context *c, int r = 0) {
+    const auto stamp = _stamp();
+    if (lockless) {
+      auto item = _new_item(c, r, stamp);
+      _push(item, item, 1);
+      return;
     }
-    ls.clear();
+    std::unique_lock ul(finisher_lock);
+    bool was_empty = finisher_queue.empty();
+    finisher_queue.push_back(_make_item(c, r, stamp));
+    if (was_empty) {
+      finisher_cond.notify_one();
+    }
+    if (logger)
+      logger->inc(l_finisher_queue_len);
+  }
+
+  void queue(std::list<Context*>& ls) {
+    _queue(ls);
+  }
+  void queue(std::deque<Context*>& ls) {
+    _queue(ls);
+  }
+  void queue(std::vector<Context*>& ls) {
+    _queue(ls);
   }
 
   /// Start the worker thread.
@@ -139,34 +203,12 @@ class Finisher {
 
   /// Construct an anonymous Finisher.
   /// Anonymous finishers do not log their queue length.
-  explicit Finisher(CephContext *cct_) :
-    cct(cct_), finisher_lock(ceph::make_mutex("Finisher::finisher_lock")),
-    finisher_stop(false), finisher_running(false), finisher_empty_wait(false),
-    thread_name("fn_anonymous"), logger(0),
-    finisher_thread(this) {}
+  explicit Finisher(CephContext *cct_);
 
   /// Construct a named Finisher that logs its queue length.
-  Finisher(CephContext *cct_, std::string name, std::string tn) :
-    cct(cct_), finisher_lock(ceph::make_mutex("Finisher::" + name)),
-    finisher_stop(false), finisher_running(false), finisher_empty_wait(false),
-    thread_name(tn), logger(0),
-    finisher_thread(this) {
-    PerfCountersBuilder b(cct, std::string("finisher-") + name,
-			  l_finisher_first, l_finisher_last);
-    b.add_u64(l_finisher_queue_len, "queue_len");
-    b.add_time_avg(l_finisher_complete_lat, "complete_latency");
-    logger = b.create_perf_counters();
-    cct->get_perfcounters_collection()->add(logger);
-    logger->set(l_finisher_queue_len, 0);
-    logger->set(l_finisher_complete_lat, 0);
-  }
+  Finisher(CephContext *cct_, std::string name, std::string tn);
 
-  ~Finisher() {
-    if (logger && cct) {
-      cct->get_perfcounters_collection()->remove(logger);
-      delete logger;
-    }
-  }
+  ~Finisher();
 };
 
 /// Context that is completed asynchronously on the supplied finisher.
@@ -20,6 +20,7 @@
 
 #include <fmt/format.h>
 #include <algorithm>
+#include <charconv>
 #include <set>
 #include <limits>
 
@@ -292,10 +293,18 @@ void JSONFormatter::finish_pending_string()
 template <class T>
 void JSONFormatter::add_value(std::string_view name, T val)
 {
-  std::stringstream ss;
-  ss.precision(std::numeric_limits<T>::max_digits10);
-  ss << val;
-  add_value(name, ss.str(), false);
+  // same output as an ostream with precision max_digits10, without
+  // constructing one per value
+  char buf[64];
+  std::to_chars_result r;
+  if constexpr (std::is_floating_point_v<T>) {
+    r = std::to_chars(buf, buf + sizeof(buf), val, std::chars_format::general,
+		      std::numeric_limits<T>::max_digits10);
+  } else {
+    r = std::to_chars(buf, buf + sizeof(buf), val);
+  }
+  ceph_assert(r.ec == std::errc());
+  add_value(name, std::string_view(buf, r.ptr - buf), false);
 }
 
 void JSONFormatter::add_value(std::string_view name, std::string_view val, bool quoted)
@@ -313,7 +322,7 @@ void JSONFormatter::add_value(std::string_view name, std::string_view val, bool
 
 void JSONFormatter::dump_null(std::string_view name)
 {
-  add_value(name, "null");
+  add_value(name, "null", false);
 }
 
 void JSONFormatter::dump_unsigned(std::string_view name, uint64_t u)
@@ -354,7 +363,7 @@ void JSONFormatter::dump_format_va(std::string_view name, const char *ns, bool q
 
 int JSONFormatter::get_len() const
 {
-  return m_ss.str().size();
+  return m_ss.view().size();
 }
 
 void JSONFormatter::write_raw_data(const char *data)
@@ -548,7 +557,7 @@ void XMLFormatter::dump_format_va(std::string_view name, const char *ns, bool qu
 
 int XMLFormatter::get_len() const
 {
-  return m_ss.str().size();
+  return m_ss.view().size();
 }
 
 void XMLFormatter::write_raw_data(const char *data)
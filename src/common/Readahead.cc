@@ -17,7 +17,8 @@ Readahead::Readahead()
     m_readahead_pos(0),
     m_readahead_trigger_pos(0),
     m_readahead_size(0),
-    m_pending(0) {
+    m_pending(0),
+    m_max_streams(1) {
 }
 
 Readahead::~Readahead() {
@@ -50,6 +51,15 @@ Readahead::extent_t Readahead::update(uint64_t offset, uint64_t length, uint64_t
 }
 
 void Readahead::_observe_read(uint64_t offset, uint64_t length) {
+  if (offset != m_last_pos && m_max_streams > 1) {
+    // continue another stream if this read picks up where it left off,
+    // otherwise remember the current one and start a new stream
+    auto p = m_streams.begin();
+    while (p != m_streams.end() && p->last_pos != offset) {
+      ++p;
+    }
+    _switch_stream(p);
+  }
   if (offset == m_last_pos) {
     m_nr_consec_read++;
     m_consec_read_bytes += length;
@@ -63,6 +73,24 @@ void Readahead::_observe_read(uint64_t offset, uint64_t length) {
   m_last_pos = offset + length;
 }
 
+void Readahead::_switch_stream(std::vector<stream_t>::iterator p) {
+  stream_t cur{m_nr_consec_read, m_consec_read_bytes, m_last_pos,
+	       m_readahead_pos, m_readahead_trigger_pos, m_readahead_size};
+  if (p != m_streams.end()) {
+    m_nr_consec_read = p->nr_consec_read;
+    m_consec_read_bytes = p->consec_read_bytes;
+    m_last_pos = p->last_pos;
+    m_readahead_pos = p->readahead_pos;
+    m_readahead_trigger_pos = p->readahead_trigger_pos;
+    m_readahead_size = p->readahead_size;
+    m_streams.erase(p);
+  } else if (m_streams.size() + 1 >= m_max_streams) {
+    // forget the least recently used stream
+    m_streams.pop_back();
+  }
+  m_streams.insert(m_streams.begin(), cur);
+}
+
 Readahead::extent_t Readahead::_compute_readahead(uint64_t limit) {
   uint64_t readahead_offset = 0;
   uint64_t readahead_length = 0;
@@ -194,3 +222,11 @@ void Readahead::set_alignments(const vector<uint64_t> &alignments) {
   m_alignments = alignments;
   m_lock.unlock();
 }
+
+void Readahead::set_max_streams(unsigned max_streams) {
+  std::lock_guard lock(m_lock);
+  m_max_streams = std::max(max_streams, 1u);
+  if (m_streams.size() >= m_max_streams) {
+    m_streams.resize(m_max_streams - 1);
+  }
+}
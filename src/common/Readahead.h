@@ -108,7 +108,33 @@ public:
    */
   void set_alignments(const std::vector<uint64_t> &alignments);
 
+  /**
+     Sets the number of sequential streams tracked at once.
+     With more than one stream, a read that does not continue the current
+     stream is matched against the other recently seen streams before
+     readahead is reset, so that interleaved sequential readers (e.g. several
+     threads sharing a file handle) each keep their readahead window.
+   */
+  void set_max_streams(unsigned max_streams);
+
 private:
+  /// Sequential stream state saved while another stream is being read
+  struct stream_t {
+    int nr_consec_read;
+    uint64_t consec_read_bytes;
+    uint64_t last_pos;
+    uint64_t readahead_pos;
+    uint64_t readahead_trigger_pos;
+    uint64_t readahead_size;
+  };
+
+  /**
+     Saves the current stream and makes the one at \c p current.  If \c p
+     is the end of m_streams, the current state is left to be reset.
+     m_lock must be held while calling.
+   */
+  void _switch_stream(std::vector<stream_t>::iterator p);
+
   /**
      Records that a read request has been received.
      m_lock must be held while calling.
@@ -162,6 +188,12 @@ private:
 
   /// Waiters for pending readahead
   std::list<Context *> m_pending_waiting;
+
+  /// Maximum number of tracked streams, including the current one
+  unsigned m_max_streams;
+
+  /// Other recently seen streams, most recent first
+  std::vector<stream_t> m_streams;
 };
 
 #endif
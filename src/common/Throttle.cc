@@ -92,31 +92,37 @@ void Throttle::_reset_max(int64_t m)
 
 bool Throttle::_wait(int64_t c, std::unique_lock<std::mutex>& l)
 {
+  // always wait behind other waiters.  The slots are claimed with a CAS
+  // even under the lock, since _try_get_fast() takes them without it.
+  if (conds.empty() && _try_claim(c)) {
+    return false;
+  }
   mono_time start;
-  bool waited = false;
-  if (_should_wait(c) || !conds.empty()) { // always wait behind other waiters.
-    {
-      auto cv = conds.emplace(conds.end());
-      auto w = make_scope_guard([this, cv]() {
-	  conds.erase(cv);
-	});
-      waited = true;
-      ldout(cct, 2) << "_wait waiting..." << dendl;
-      if (logger)
-	start = mono_clock::now();
-
-      cv->wait(l, [this, c, cv]() { return (!_should_wait(c) &&
-					    cv == conds.begin()); });
-      ldout(cct, 2) << "_wait finished waiting" << dendl;
-      if (logger) {
-	logger->tinc(l_throttle_wait, mono_clock::now() - start);
-      }
+  {
+    auto cv = conds.emplace(conds.end());
+    // published before the predicate is first checked, so that a put()
+    // seeing no waiters has its decrement seen by the check.  It stays
+    // raised until the slots are claimed, keeping the fast path out.
+    ++num_waiters;
+    auto w = make_scope_guard([this, cv]() {
+	conds.erase(cv);
+	--num_waiters;
+      });
+    ldout(cct, 2) << "_wait waiting..." << dendl;
+    if (logger)
+      start = mono_clock::now();
+
+    cv->wait(l, [this, c, cv]() { return (cv == conds.begin() &&
+					  _try_claim(c)); });
+    ldout(cct, 2) << "_wait finished waiting" << dendl;
+    if (logger) {
+      logger->tinc(l_throttle_wait, mono_clock::now() - start);
     }
-    // wake up the next guy
-    if (!conds.empty())
-      conds.front().notify_one();
   }
-  return waited;
+  // wake up the next guy
+  if (!conds.empty())
+    conds.front().notify_one();
+  return true;
 }
 
 bool Throttle::wait(int64_t m)
@@ -163,14 +169,13 @@ bool Throttle::get(int64_t c, int64_t m)
     logger->inc(l_throttle_get_started);
   }
   bool waited = false;
-  {
+  if (m || !_try_get_fast(c)) {
     std::unique_lock l(lock);
     if (m) {
       ceph_assert(m > 0);
       _reset_max(m);
     }
     waited = _wait(c, l);
-    count += c;
   }
   if (logger) {
     logger->inc(l_throttle_get);
@@ -192,15 +197,17 @@ bool Throttle::get_or_fail(int64_t c)
 
   assert (c >= 0);
   bool result = false;
-  {
+  if (_try_get_fast(c)) {
+    ldout(cct, 10) << "get_or_fail " << c << " success" << dendl;
+    result = true;
+  } else {
     std::lock_guard l(lock);
-    if (_should_wait(c) || !conds.empty()) {
+    if (!conds.empty() || !_try_claim(c)) {
       ldout(cct, 10) << "get_or_fail " << c << " failed" << dendl;
       result = false;
     } else {
       ldout(cct, 10) << "get_or_fail " << c << " success (" << count.load()
-	<< " -> " << (count.load() + c) << ")" << dendl;
-      count += c;
+	<< ")" << dendl;
       result = true;
     }
   }
@@ -228,16 +235,17 @@ int64_t Throttle::put(int64_t c)
   ceph_assert(c >= 0);
   ldout(cct, 10) << "put " << c << " (" << count.load() << " -> "
 		 << (count.load()-c) << ")" << dendl;
-  int64_t new_count;
-  {
-    std::lock_guard l(lock);
-    new_count = count;
-    if (c) {
+  int64_t new_count = count;
+  if (c) {
+    new_count = count -= c;
+    // if count goes negative, we failed somewhere!
+    ceph_assert(new_count >= 0);
+    // only wake the first waiter up under the lock if there is one; see
+    // _wait() for why checking num_waiters here cannot miss it
+    if (num_waiters) {
+      std::lock_guard l(lock);
       if (!conds.empty())
 	conds.front().notify_one();
-      // if count goes negative, we failed somewhere!
-      ceph_assert(count >= c);
-      new_count = count -= c;
     }
   }
   if (logger) {
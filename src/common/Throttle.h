@@ -36,6 +36,8 @@ class Throttle final : public ThrottleInterface {
   std::atomic<int64_t> count = { 0 }, max = { 0 };
   std::mutex lock;
   std::list<std::condition_variable> conds;
+  /// conds.size(), readable without the lock
+  std::atomic<unsigned> num_waiters = { 0 };
   const bool use_perf;
 
 public:
@@ -45,8 +47,10 @@ public:
 private:
   void _reset_max(int64_t m);
   bool _should_wait(int64_t c) const {
+    return _should_wait(c, count);
+  }
+  bool _should_wait(int64_t c, int64_t cur) const {
     int64_t m = max;
-    int64_t cur = count;
     return
       m &&
       ((c <= m && cur + c > m) || // normally stay under max
@@ -54,6 +58,20 @@ private:
   }
 
   bool _wait(int64_t c, std::unique_lock<std::mutex>& l);
+  /// take c slots without the lock if nobody waits and there is room
+  bool _try_get_fast(int64_t c) {
+    return !num_waiters && _try_claim(c);
+  }
+  /// take c slots if there is room, racing with other claimers
+  bool _try_claim(int64_t c) {
+    int64_t cur = count;
+    do {
+      if (_should_wait(c, cur)) {
+	return false;
+      }
+    } while (!count.compare_exchange_weak(cur, cur + c));
+    return true;
+  }
 
 public:
   /**
@@ -24,6 +24,7 @@ using std::pair;
 using std::set;
 using std::string;
 using std::stringstream;
+using std::vector;
 
 using ceph::Formatter;
 
@@ -41,7 +42,7 @@ void OpHistoryServiceThread::break_thread() {
 
 void* OpHistoryServiceThread::entry() {
   int sleep_time = 1000;
-  list<pair<utime_t, TrackedOpRef>> internal_queue;
+  std::vector<pair<utime_t, TrackedOpRef>> internal_queue;
   while (1) {
     queue_spinlock.lock();
     if (_break_thread) {
@@ -59,10 +60,9 @@ void* OpHistoryServiceThread::entry() {
       sleep_time = 1000;
     }
 
-    while (!internal_queue.empty()) {
-      pair<utime_t, TrackedOpRef> op = internal_queue.front();
-      _ophistory->_insert_delayed(op.first, op.second);
-      internal_queue.pop_front();
+    if (!internal_queue.empty()) {
+      _ophistory->_insert_delayed(internal_queue);
+      internal_queue.clear();
     }
   }
   return nullptr;
@@ -80,19 +80,23 @@ void OpHistory::on_shutdown()
   shutdown = true;
 }
 
-void OpHistory::_insert_delayed(const utime_t& now, TrackedOpRef op)
+void OpHistory::_insert_delayed(vector<pair<utime_t, TrackedOpRef>>& ops)
 {
+  // take the lock and trim the history once for the whole batch
   std::lock_guard history_lock(ops_history_lock);
   if (shutdown)
     return;
-  double opduration = op->get_duration();
-  duration.insert(make_pair(opduration, op));
-  arrived.insert(make_pair(op->get_initiated(), op));
-  if (opduration >= history_slow_op_threshold.load()) {
-    slow_op.insert(make_pair(op->get_initiated(), op));
-    logger->inc(l_osd_slow_op_count);
+  const double slow_op_threshold = history_slow_op_threshold.load();
+  for (auto& [now, op] : ops) {
+    double opduration = op->get_duration();
+    duration.insert(make_pair(opduration, op));
+    arrived.insert(make_pair(op->get_initiated(), op));
+    if (opduration >= slow_op_threshold) {
+      slow_op.insert(make_pair(op->get_initiated(), op));
+      logger->inc(l_osd_slow_op_count);
+    }
   }
-  cleanup(now);
+  cleanup(ops.back().first);
 }
 
 void OpHistory::cleanup(utime_t now)
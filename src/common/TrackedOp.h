@@ -15,6 +15,7 @@
 #define TRACKEDREQUEST_H_
 
 #include <atomic>
+#include <vector>
 #include "common/StackStringStream.h"
 #include "common/ceph_mutex.h"
 #include "common/histogram.h"
@@ -33,7 +34,9 @@ typedef boost::intrusive_ptr<TrackedOp> TrackedOpRef;
 class OpHistoryServiceThread : public Thread
 {
 private:
-  std::list<std::pair<utime_t, TrackedOpRef>> _external_queue;
+  // a vector handed back and forth with the service thread, so pushing an
+  // op does not allocate once both have grown to the usual batch size
+  std::vector<std::pair<utime_t, TrackedOpRef>> _external_queue;
   OpHistory* _ophistory;
   mutable ceph::spinlock queue_spinlock;
   bool _break_thread;
@@ -103,7 +106,7 @@ public:
     opsvc.insert_op(now, op);
   }
 
-  void _insert_delayed(const utime_t& now, TrackedOpRef op);
+  void _insert_delayed(std::vector<std::pair<utime_t, TrackedOpRef>>& ops);
   void dump_ops(utime_t now, ceph::Formatter *f, std::set<std::string> filters = {""}, bool by_duration=false);
   void dump_slow_ops(utime_t now, ceph::Formatter *f, std::set<std::string> filters = {""});
   void on_shutdown();
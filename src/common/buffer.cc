@@ -15,6 +15,7 @@
 #include <atomic>
 #include <cstring>
 #include <errno.h>
+#include <iterator>
 #include <limits.h>
 
 #include <sys/uio.h>
@@ -81,15 +82,134 @@ static ceph::spinlock debug_lock;
     return buffer_missed_crc;
   }
 
+  /*
+   * per thread cache of the small allocations raw_combined is made of.
+   *
+   * message headers, encode buffers and append buffers are allocated and
+   * freed at a high rate in a handful of sizes; keeping a few freed blocks
+   * of each size class around lets the next allocation skip malloc.  a
+   * block goes back to the cache of the thread freeing it, so a producer
+   * and a consumer thread still end up in malloc once the consumer's cache
+   * is full; the caches are kept small for that reason.
+   */
+  namespace {
+  class raw_cache_t {
+  public:
+    // raw_combined placed in cached blocks must not ask for more than this
+    static constexpr unsigned max_align = 64;
+    static constexpr size_t class_size[] = {256, 1024, CEPH_BUFFER_ALLOC_UNIT};
+    static constexpr unsigned num_classes = std::size(class_size);
+    // a cache holds up to this many bytes of each class
+    static constexpr size_t class_budget = 64 * 1024;
+
+    static int size_class(size_t len) {
+      for (unsigned i = 0; i < num_classes; ++i) {
+	if (len <= class_size[i]) {
+	  return i;
+	}
+      }
+      return -1;
+    }
+
+    static raw_cache_t* get() {
+      if (!enabled || destroyed) {
+	return nullptr;
+      }
+      thread_local raw_cache_t cache;
+      return &cache;
+    }
+
+    char* alloc(int c) {
+      block_t* b = free_list[c];
+      if (!b) {
+	account(misses);
+	return nullptr;
+      }
+      free_list[c] = b->next;
+      --num_free[c];
+      account(hits);
+      return reinterpret_cast<char*>(b);
+    }
+
+    bool release(int c, char* p) {
+      if (num_free[c] >= class_budget / class_size[c]) {
+	return false;
+      }
+      auto b = reinterpret_cast<block_t*>(p);
+      b->next = free_list[c];
+      free_list[c] = b;
+      ++num_free[c];
+      return true;
+    }
+
+    ~raw_cache_t() {
+      destroyed = true;
+      for (unsigned c = 0; c < num_classes; ++c) {
+	while (free_list[c]) {
+	  block_t* b = free_list[c];
+	  free_list[c] = b->next;
+	  aligned_free(b);
+	}
+      }
+      hits.flush();
+      misses.flush();
+    }
+
+    // without the cache, allocations are not rounded up to a class either
+    static inline bool enabled = !get_env_bool("CEPH_BUFFER_NO_RAW_CACHE");
+    static inline ceph::atomic<uint64_t> total_hits = 0;
+    static inline ceph::atomic<uint64_t> total_misses = 0;
+
+  private:
+    struct block_t {
+      block_t* next;
+    };
+    // counted locally, folded into the totals now and then
+    struct counter_t {
+      ceph::atomic<uint64_t>& total;
+      uint64_t local = 0;
+      void flush() {
+	total += local;
+	local = 0;
+      }
+    };
+    static void account(counter_t& c) {
+      if (++c.local == 1024) {
+	c.flush();
+      }
+    }
+
+    static inline thread_local bool destroyed = false;
+
+    block_t* free_list[num_classes] = {};
+    unsigned num_free[num_classes] = {};
+    counter_t hits{total_hits};
+    counter_t misses{total_misses};
+  };
+  } // anonymous namespace
+
+  uint64_t buffer::get_raw_cache_hits() {
+    return raw_cache_t::total_hits;
+  }
+  uint64_t buffer::get_raw_cache_misses() {
+    return raw_cache_t::total_misses;
+  }
+
   /*
    * raw_combined is always placed within a single allocation along
    * with the data buffer.  the data goes at the beginning, and
    * raw_combined at the end.
    */
   class buffer::raw_combined : public buffer::raw {
+    // raw_cache_t size class of the allocation, -1 if not cacheable
+    int cache_class;
   public:
-    raw_combined(char *dataptr, unsigned l, int mempool)
-      : raw(dataptr, l, mempool) {
+    raw_combined(char *dataptr, unsigned l, int mempool, int cache_class,
+		 unsigned s)
+      : raw(dataptr, l, mempool), cache_class(cache_class) {
+      // the rounding up to a cache class is memory the buffer holds on to
+      slack = s;
+      mempool::get_pool(mempool::pool_index_t(mempool)).adjust_count(0, slack);
     }
 
     static ceph::unique_leakable_ptr<buffer::raw>
@@ -102,26 +222,49 @@ static ceph::spinlock debug_lock;
       size_t rawlen = round_up_to(sizeof(buffer::raw_combined),
 				  alignof(buffer::raw_combined));
       size_t datalen = round_up_to(len, alignof(buffer::raw_combined));
+      size_t alloclen = rawlen + datalen;
 
+      char *ptr = 0;
+      int cache_class = -1;
+      if (raw_cache_t::enabled && align <= raw_cache_t::max_align) {
+	cache_class = raw_cache_t::size_class(alloclen);
+      }
+      if (cache_class >= 0) {
+	// allocate the whole class, for the block to be reusable by any
+	// allocation of its class
+	alloclen = raw_cache_t::class_size[cache_class];
+	align = raw_cache_t::max_align;
+	if (auto cache = raw_cache_t::get(); cache) {
+	  ptr = cache->alloc(cache_class);
+	}
+      }
+      if (!ptr) {
 #ifdef DARWIN
-      char *ptr = (char *) valloc(rawlen + datalen);
+	ptr = (char *) valloc(alloclen);
 #else
-      char *ptr = 0;
-      int r = ::posix_memalign((void**)(void*)&ptr, align, rawlen + datalen);
-      if (r)
-	throw bad_alloc();
+	int r = ::posix_memalign((void**)(void*)&ptr, align, alloclen);
+	if (r)
+	  throw bad_alloc();
 #endif /* DARWIN */
-      if (!ptr)
-	throw bad_alloc();
+	if (!ptr)
+	  throw bad_alloc();
+      }
 
       // actual data first, since it has presumably larger alignment restriction
       // then put the raw_combined at the end
       return ceph::unique_leakable_ptr<buffer::raw>(
-	new (ptr + datalen) raw_combined(ptr, len, mempool));
+	new (ptr + datalen) raw_combined(ptr, len, mempool, cache_class,
+					 alloclen - rawlen - len));
     }
 
     static void operator delete(void *ptr) {
       raw_combined *raw = (raw_combined *)ptr;
+      if (raw->cache_class >= 0) {
+	if (auto cache = raw_cache_t::get();
+	    cache && cache->release(raw->cache_class, raw->data)) {
+	  return;
+	}
+      }
       aligned_free((void *)raw->data);
     }
   };
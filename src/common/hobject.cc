@@ -346,22 +346,15 @@ int cmp(const hobject_t& l, const hobject_t& r)
     return -1;
   if (l.get_bitwise_key() > r.get_bitwise_key())
     return 1;
-  if (l.nspace < r.nspace)
-    return -1;
-  if (l.nspace > r.nspace)
-    return 1;
+  // compare each string once rather than testing < and then >
+  if (int c = l.nspace.compare(r.nspace); c != 0)
+    return c < 0 ? -1 : 1;
   if (!(l.get_key().empty() && r.get_key().empty())) {
-    if (l.get_effective_key() < r.get_effective_key()) {
-      return -1;
-    }
-    if (l.get_effective_key() > r.get_effective_key()) {
-      return 1;
-    }
+    if (int c = l.get_effective_key().compare(r.get_effective_key()); c != 0)
+      return c < 0 ? -1 : 1;
   }
-  if (l.oid < r.oid)
-    return -1;
-  if (l.oid > r.oid)
-    return 1;
+  if (int c = l.oid.name.compare(r.oid.name); c != 0)
+    return c < 0 ? -1 : 1;
   if (l.snap < r.snap)
     return -1;
   if (l.snap > r.snap)
@@ -6,6 +6,10 @@
 #include <cstring>
 #include <errno.h>
 #include <iostream>
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
 
 #include "include/stringify.h"
 #include "common/safe_io.h"
@@ -224,6 +228,60 @@ int set_cpu_affinity_all_threads(size_t cpu_set_size, cpu_set_t *cpu_set)
   return 0;
 }
 
+int set_cpu_affinity_this_thread_nth(const char *cpu_list,
+				     unsigned n,
+				     int *cpu)
+{
+  size_t cpu_set_size;
+  cpu_set_t cpu_set;
+  int r = parse_cpu_set_list(cpu_list, &cpu_set_size, &cpu_set);
+  if (r < 0) {
+    return r;
+  }
+  int count = CPU_COUNT(&cpu_set);
+  if (count == 0) {
+    return -EINVAL;
+  }
+  int nth = n % count;
+  int pick = 0;
+  for (; pick < CPU_SETSIZE; ++pick) {
+    if (CPU_ISSET(pick, &cpu_set) && nth-- == 0) {
+      break;
+    }
+  }
+  CPU_ZERO(&cpu_set);
+  CPU_SET(pick, &cpu_set);
+  // 0 is the calling thread
+  r = sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+  if (r < 0) {
+    return -errno;
+  }
+  *cpu = pick;
+  return 0;
+}
+
+int set_preferred_memory_node(int node)
+{
+  // go through the raw syscall so that we don't need libnuma
+  unsigned long nodemask = 0;
+  int r;
+  if (node < 0) {
+    r = syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+  } else if (node >= (int)(sizeof(nodemask) * 8)) {
+    return -EINVAL;
+  } else {
+    nodemask = 1ul << node;
+    // the kernel takes maxnode as one past the last bit it reads, so pass
+    // one more than the bits in the mask or it ignores the top one
+    r = syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodemask,
+		sizeof(nodemask) * 8 + 1);
+  }
+  if (r < 0) {
+    return -errno;
+  }
+  return 0;
+}
+
 #else
 int parse_cpu_set_list(const char *s,
 		       size_t *cpu_set_size,
@@ -257,4 +315,16 @@ int set_cpu_affinity_all_threads(size_t cpu_set_size,
   return -ENOTSUP;
 }
 
+int set_cpu_affinity_this_thread_nth(const char *cpu_list,
+				     unsigned n,
+				     int *cpu)
+{
+  return -ENOTSUP;
+}
+
+int set_preferred_memory_node(int node)
+{
+  return -ENOTSUP;
+}
+
 #endif
@@ -22,3 +22,13 @@ int get_numa_node_cpu_set(int node,
 
 int set_cpu_affinity_all_threads(size_t cpu_set_size,
 				 cpu_set_t *cpu_set);
+
+// pin the calling thread to the n-th cpu (modulo the count) of a cpu list;
+// the cpu picked is returned in *cpu
+int set_cpu_affinity_this_thread_nth(const char *cpu_list,
+				     unsigned n,
+				     int *cpu);
+
+// prefer allocating memory for the calling thread on the given numa node
+// (-1 to restore the default, first touch, policy)
+int set_preferred_memory_node(int node);
@@ -17,6 +17,9 @@
  */
 #include "include/compat.h"
 #include <pthread.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
 #include "common/ceph_mutex.h"
 #include "common/Clock.h"
 #include "obj_bencher.h"
@@ -84,6 +87,77 @@ static void sanitize_object_contents (bench_data *data, size_t length) {
   memset(data->object_contents, 'z', length);
 }
 
+void bench_latency_histogram::add(std::chrono::duration<double> lat)
+{
+  auto us = (uint64_t)std::max(0.0, lat.count() * 1000000);
+  size_t idx;
+  if (us < SUB_BUCKETS) {
+    idx = us;
+  } else {
+    int shift = 63 - __builtin_clzll(us) - SUB_BITS;
+    idx = (shift + 1) * SUB_BUCKETS + ((us >> shift) - SUB_BUCKETS);
+  }
+  ++counts[idx];
+  ++total;
+}
+
+double bench_latency_histogram::percentile(double p) const
+{
+  if (total == 0) {
+    return 0;
+  }
+  auto target = std::max<uint64_t>(1, std::ceil(total * p / 100));
+  uint64_t seen = 0;
+  for (size_t idx = 0; idx < counts.size(); ++idx) {
+    seen += counts[idx];
+    if (seen >= target) {
+      // report the upper bound of the bucket
+      uint64_t us;
+      if (idx < SUB_BUCKETS) {
+	us = idx;
+      } else {
+	int shift = idx / SUB_BUCKETS - 1;
+	us = ((idx % SUB_BUCKETS + SUB_BUCKETS + 1) << shift) - 1;
+      }
+      return us / 1000000.0;
+    }
+  }
+  return 0;
+}
+
+mono_time ObjBencher::op_start_time(int op_index)
+{
+  auto now = mono_clock::now();
+  if (target_rate <= 0) {
+    return now;
+  }
+  auto due = data.start_time +
+    std::chrono::duration_cast<mono_clock::duration>(
+      std::chrono::duration<double>(op_index / target_rate));
+  if (due > now) {
+    std::this_thread::sleep_for(due - now);
+  }
+  return due;
+}
+
+void ObjBencher::print_latency_percentiles(size_t label_width)
+{
+  static const std::pair<double, const char*> percentiles[] = {
+    {50, "50"}, {90, "90"}, {99, "99"}, {99.9, "99.9"}};
+  for (auto& [p, name] : percentiles) {
+    auto lat = data.latency_hist.percentile(p);
+    if (formatter) {
+      std::string key = std::string("latency_p") + name;
+      std::replace(key.begin(), key.end(), '.', '_');
+      formatter->dump_format(key, "%f", lat);
+    } else {
+      std::string label = std::string("Latency p") + name + "(s):";
+      label.resize(std::max(label.size(), label_width), ' ');
+      out(cout) << label << lat << std::endl;
+    }
+  }
+}
+
 ostream& ObjBencher::out(ostream& os, utime_t& t)
 {
   if (show_time)
@@ -295,6 +369,7 @@ int ObjBencher::aio_bench(
   data.max_latency = 0;
   data.avg_latency = 0;
   data.latency_diff_sum = 0;
+  data.latency_hist.reset();
   data.object_contents = contentsChars;
   lock.unlock();
 
@@ -363,6 +438,24 @@ void _aio_cb(void *cb, void *arg) {
   lc->lock->unlock();
 }
 
+// an op of the benches that measure latency, which takes its completion
+// time in the callback: the loop that reaps the slots may only notice it
+// later
+struct timed_completion {
+  lock_cond *lc;
+  bool done = false;
+  mono_time end_time;
+};
+
+void _aio_timed_cb(void *cb, void *arg) {
+  auto tc = (struct timed_completion *)arg;
+  auto now = mono_clock::now();
+  std::lock_guard l{*tc->lc->lock};
+  tc->end_time = now;
+  tc->done = true;
+  tc->lc->cond.notify_all();
+}
+
 int ObjBencher::fetch_bench_metadata(const std::string& metadata_file,
 				     uint64_t *op_size, uint64_t* object_size,
 				     int* num_ops, int* num_objects, int* prevPid) {
@@ -433,6 +526,7 @@ int ObjBencher::write_bench(int secondsToRun,
   lock_cond lc(&lock);
   double total_latency = 0;
   std::vector<mono_time> start_times(concurrentios);
+  std::vector<timed_completion> completions(concurrentios, {&lc});
   mono_time stopTime;
   std::chrono::duration<double> timePassed;
 
@@ -459,8 +553,8 @@ int ObjBencher::write_bench(int secondsToRun,
   data.start_time = mono_clock::now();
   locker.unlock();
   for (int i = 0; i<concurrentios; ++i) {
-    start_times[i] = mono_clock::now();
-    r = create_completion(i, _aio_cb, (void *)&lc);
+    start_times[i] = op_start_time(i);
+    r = create_completion(i, _aio_timed_cb, &completions[i]);
     if (r < 0)
       goto ERR;
     r = aio_write(name[i], i, *contents[i], data.op_size,
@@ -487,7 +581,7 @@ int ObjBencher::write_bench(int secondsToRun,
     while (1) {
       int old_slot = slot;
       do {
-        if (completion_is_done(slot)) {
+        if (completion_is_done(slot) && completions[slot].done) {
             found = true;
             break;
         }
@@ -509,7 +603,8 @@ int ObjBencher::write_bench(int secondsToRun,
       locker.unlock();
       goto ERR;
     }
-    data.cur_latency = mono_clock::now() - start_times[slot];
+    data.cur_latency = completions[slot].end_time - start_times[slot];
+    data.latency_hist.add(data.cur_latency);
     total_latency += data.cur_latency.count();
     if( data.cur_latency.count() > data.max_latency)
       data.max_latency = data.cur_latency.count();
@@ -545,8 +640,9 @@ int ObjBencher::write_bench(int secondsToRun,
     // we wrote to buffer, going around internal crc cache, so invalidate it now.
     newContents->invalidate_crc();
 
-    start_times[slot] = mono_clock::now();
-    r = create_completion(slot, _aio_cb, &lc);
+    completions[slot].done = false;
+    start_times[slot] = op_start_time(data.started);
+    r = create_completion(slot, _aio_timed_cb, &completions[slot]);
     if (r < 0)
       goto ERR;
     r = aio_write(newName, slot, *newContents, data.op_size,
@@ -609,6 +705,7 @@ int ObjBencher::write_bench(int secondsToRun,
        << "Stddev Latency(s):      " << latency_stddev << std::endl
        << "Max latency(s):         " << data.max_latency << std::endl
        << "Min latency(s):         " << data.min_latency << std::endl;
+    print_latency_percentiles(24);
   } else {
     formatter->dump_format("total_time_run", "%f", timePassed.count());
     formatter->dump_format("total_writes_made", "%d", data.finished);
@@ -626,6 +723,7 @@ int ObjBencher::write_bench(int secondsToRun,
     formatter->dump_format("stddev_latency", "%f", latency_stddev);
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
+    print_latency_percentiles(0);
   }
   //write object size/number data for read benchmarks
   encode(data.object_size, b_write);
@@ -665,6 +763,7 @@ int ObjBencher::seq_read_bench(
   double total_latency = 0;
   int r = 0;
   std::vector<mono_time> start_times(concurrentios);
+  std::vector<timed_completion> completions(concurrentios, {&lc});
   mono_clock::duration time_to_run = std::chrono::seconds(seconds_to_run);
   std::chrono::duration<double> timePassed;
   sanitize_object_contents(&data, data.op_size); //clean it up once; subsequent
@@ -697,8 +796,8 @@ int ObjBencher::seq_read_bench(
   //start initial reads
   for (int i = 0; i < concurrentios; ++i) {
     index[i] = i;
-    start_times[i] = mono_clock::now();
-    create_completion(i, _aio_cb, (void *)&lc);
+    start_times[i] = op_start_time(i);
+    create_completion(i, _aio_timed_cb, &completions[i]);
     r = aio_read(name[i], i, contents[i].get(), data.op_size,
 		 data.op_size * (i % reads_per_object));
     if (r < 0) {
@@ -722,7 +821,7 @@ int ObjBencher::seq_read_bench(
     bool found = false;
     while (1) {
       do {
-        if (completion_is_done(slot)) {
+        if (completion_is_done(slot) && completions[slot].done) {
           found = true;
           break;
         }
@@ -738,7 +837,8 @@ int ObjBencher::seq_read_bench(
     }
 
     // calculate latency here, so memcmp doesn't inflate it
-    data.cur_latency = mono_clock::now() - start_times[slot];
+    data.cur_latency = completions[slot].end_time - start_times[slot];
+    data.latency_hist.add(data.cur_latency);
 
     cur_contents = contents[slot].get();
     int current_index = index[slot];
@@ -786,8 +886,9 @@ int ObjBencher::seq_read_bench(
       continue;
 
     //start new read and check data if requested
-    start_times[slot] = mono_clock::now();
-    create_completion(slot, _aio_cb, (void *)&lc);
+    completions[slot].done = false;
+    start_times[slot] = op_start_time(data.started);
+    create_completion(slot, _aio_timed_cb, &completions[slot]);
     r = aio_read(newName, slot, contents[slot].get(), data.op_size,
 		 data.op_size * (data.started % reads_per_object));
     if (r < 0) {
@@ -831,6 +932,7 @@ int ObjBencher::seq_read_bench(
        << "Average Latency(s):   " << data.avg_latency << std::endl
        << "Max latency(s):       " << data.max_latency << std::endl
        << "Min latency(s):       " << data.min_latency << std::endl;
+    print_latency_percentiles(22);
   } else {
     formatter->dump_format("total_time_run", "%f", timePassed.count());
     formatter->dump_format("total_reads_made", "%d", data.finished);
@@ -844,6 +946,7 @@ int ObjBencher::seq_read_bench(
     formatter->dump_format("average_latency", "%f", data.avg_latency);
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
+    print_latency_percentiles(0);
   }
 
   completions_done();
@@ -875,6 +978,7 @@ int ObjBencher::rand_read_bench(
   int r = 0;
   double total_latency = 0;
   std::vector<mono_time> start_times(concurrentios);
+  std::vector<timed_completion> completions(concurrentios, {&lc});
   mono_clock::duration time_to_run = std::chrono::seconds(seconds_to_run);
   std::chrono::duration<double> timePassed;
   sanitize_object_contents(&data, data.op_size); //clean it up once; subsequent
@@ -909,8 +1013,8 @@ int ObjBencher::rand_read_bench(
   //start initial reads
   for (int i = 0; i < concurrentios; ++i) {
     index[i] = i;
-    start_times[i] = mono_clock::now();
-    create_completion(i, _aio_cb, (void *)&lc);
+    start_times[i] = op_start_time(i);
+    create_completion(i, _aio_timed_cb, &completions[i]);
     r = aio_read(name[i], i, contents[i].get(), data.op_size,
 		 data.op_size * (i % reads_per_object));
     if (r < 0) {
@@ -935,7 +1039,7 @@ int ObjBencher::rand_read_bench(
     bool found = false;
     while (1) {
       do {
-        if (completion_is_done(slot)) {
+        if (completion_is_done(slot) && completions[slot].done) {
           found = true;
           break;
         }
@@ -951,7 +1055,8 @@ int ObjBencher::rand_read_bench(
     }
 
     // calculate latency here, so memcmp doesn't inflate it
-    data.cur_latency = mono_clock::now() - start_times[slot];
+    data.cur_latency = completions[slot].end_time - start_times[slot];
+    data.latency_hist.add(data.cur_latency);
 
     locker.unlock();
 
@@ -999,8 +1104,9 @@ int ObjBencher::rand_read_bench(
     // invalidate internal crc cache
     cur_contents->invalidate_crc();
 
-    start_times[slot] = mono_clock::now();
-    create_completion(slot, _aio_cb, (void *)&lc);
+    completions[slot].done = false;
+    start_times[slot] = op_start_time(data.started);
+    create_completion(slot, _aio_timed_cb, &completions[slot]);
     r = aio_read(newName, slot, contents[slot].get(), data.op_size,
 		 data.op_size * (rand_id % reads_per_object));
     if (r < 0) {
@@ -1044,6 +1150,7 @@ int ObjBencher::rand_read_bench(
        << "Average Latency(s):   " << data.avg_latency << std::endl
        << "Max latency(s):       " << data.max_latency << std::endl
        << "Min latency(s):       " << data.min_latency << std::endl;
+    print_latency_percentiles(22);
   } else {
     formatter->dump_format("total_time_run", "%f", timePassed.count());
     formatter->dump_format("total_reads_made", "%d", data.finished);
@@ -1057,6 +1164,7 @@ int ObjBencher::rand_read_bench(
     formatter->dump_format("average_latency", "%f", data.avg_latency);
     formatter->dump_format("max_latency", "%f", data.max_latency);
     formatter->dump_format("min_latency", "%f", data.min_latency);
+    print_latency_percentiles(0);
   }
   completions_done();
 
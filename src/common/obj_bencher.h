@@ -18,6 +18,7 @@
 #include "common/ceph_context.h"
 #include "common/Formatter.h"
 #include "ceph_time.h"
+#include <array>
 #include <cfloat>
 
 using ceph::mono_clock;
@@ -35,6 +36,23 @@ struct bench_interval_data {
   double iops_diff_sum = 0;
 };
 
+// log-linear histogram of latencies in microseconds: there are 32
+// buckets per power of two, which keeps percentiles within ~3%
+struct bench_latency_histogram {
+  static constexpr int SUB_BITS = 5;
+  static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+  std::array<uint64_t, (64 - SUB_BITS + 1) * SUB_BUCKETS> counts{};
+  uint64_t total = 0;
+
+  void reset() {
+    counts.fill(0);
+    total = 0;
+  }
+  void add(std::chrono::duration<double> lat);
+  /// latency (in seconds) that p percent of the ops did not exceed
+  double percentile(double p) const;
+};
+
 struct bench_data {
   bool done; //is the benchmark is done
   uint64_t object_size; //the size of the objects
@@ -50,6 +68,7 @@ struct bench_data {
   struct bench_interval_data idata; // data that is updated by time intervals and not by events
   double latency_diff_sum;
   std::chrono::duration<double> cur_latency; //latency of last completed transaction - in seconds by default
+  bench_latency_histogram latency_hist; //latencies of all completed transactions
   mono_time start_time; //start time for benchmark - use the monotonic clock as we'll measure the passage of time
   char *object_contents; //pointer to the contents written to each object
 };
@@ -63,6 +82,7 @@ typedef std::pair<std::string, std::string> Object;
 
 class ObjBencher {
   bool show_time;
+  double target_rate = 0; // ops/sec to issue ops at, 0 to issue them as soon as possible
   Formatter *formatter = NULL;
   std::ostream *outstream = NULL;
 public:
@@ -104,6 +124,9 @@ protected:
   virtual bool get_objects(std::list< std::pair<std::string, std::string> >* objects, int num) = 0;
   virtual void set_namespace(const std::string&) {}
 
+  mono_time op_start_time(int op_index);
+  void print_latency_percentiles(size_t label_width);
+
   std::ostream& out(std::ostream& os);
   std::ostream& out(std::ostream& os, utime_t& t);
 public:
@@ -118,6 +141,15 @@ public:
   void set_show_time(bool dt) {
     show_time = dt;
   }
+  /**
+   * issue ops at a fixed rate rather than as soon as a slot frees up, and
+   * measure their latency from when they were due (not from when they
+   * actually went out), so that a saturated cluster shows up in the tail
+   * latency instead of just slowing down the benchmark
+   */
+  void set_target_rate(double ops_per_sec) {
+    target_rate = ops_per_sec;
+  }
   void set_formatter(Formatter *f) {
     formatter = f;
   }
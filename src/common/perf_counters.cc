@@ -18,6 +18,7 @@
 #include "common/dout.h"
 #include "common/valgrind.h"
 #include "include/common_fwd.h"
+#include "include/intarith.h"
 
 using std::ostringstream;
 using std::make_pair;
@@ -179,6 +180,36 @@ PerfCounters::~PerfCounters()
 {
 }
 
+PerfCounters::counter_shard_t&
+PerfCounters::_my_shard(perf_counter_data_any_d& data)
+{
+  static std::atomic<unsigned> next_shard = 0;
+  thread_local const unsigned shard = next_shard++ % NUM_COUNTER_SHARDS;
+  return data.shards[shard * data.shard_stride];
+}
+
+void PerfCounters::_add(perf_counter_data_any_d& data, uint64_t v)
+{
+  if (!data.shards) {
+    if (data.type & PERFCOUNTER_LONGRUNAVG) {
+      data.avgcount++;
+      data.u64 += v;
+      data.avgcount2++;
+    } else {
+      data.u64 += v;
+    }
+    return;
+  }
+  auto& s = _my_shard(data);
+  if (data.type & PERFCOUNTER_LONGRUNAVG) {
+    s.avgcount++;
+    s.u64 += v;
+    s.avgcount2++;
+  } else {
+    s.u64 += v;
+  }
+}
+
 void PerfCounters::inc(int idx, uint64_t amt)
 {
 #ifndef WITH_SEASTAR
@@ -191,13 +222,7 @@ void PerfCounters::inc(int idx, uint64_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt;
-    data.avgcount2++;
-  } else {
-    data.u64 += amt;
-  }
+  _add(data, amt);
 }
 
 void PerfCounters::dec(int idx, uint64_t amt)
@@ -213,7 +238,11 @@ void PerfCounters::dec(int idx, uint64_t amt)
   ceph_assert(!(data.type & PERFCOUNTER_LONGRUNAVG));
   if (!(data.type & PERFCOUNTER_U64))
     return;
-  data.u64 -= amt;
+  if (data.shards) {
+    _my_shard(data).u64 -= amt;
+  } else {
+    data.u64 -= amt;
+  }
 }
 
 void PerfCounters::set(int idx, uint64_t amt)
@@ -238,6 +267,9 @@ void PerfCounters::set(int idx, uint64_t amt)
   } else {
     data.u64 = amt;
   }
+  for (unsigned i = 0; data.shards && i < NUM_COUNTER_SHARDS; ++i) {
+    data.shards[i * data.shard_stride].u64 = 0;
+  }
 }
 
 uint64_t PerfCounters::get(int idx) const
@@ -252,7 +284,7 @@ uint64_t PerfCounters::get(int idx) const
   const perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return 0;
-  return data.u64;
+  return data.read();
 }
 
 void PerfCounters::tinc(int idx, utime_t amt)
@@ -267,13 +299,7 @@ void PerfCounters::tinc(int idx, utime_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt.to_nsec();
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.to_nsec();
-  }
+  _add(data, amt.to_nsec());
 }
 
 void PerfCounters::tinc(int idx, ceph::timespan amt)
@@ -288,13 +314,7 @@ void PerfCounters::tinc(int idx, ceph::timespan amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt.count();
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.count();
-  }
+  _add(data, amt.count());
 }
 
 void PerfCounters::tset(int idx, utime_t amt)
@@ -326,7 +346,7 @@ utime_t PerfCounters::tget(int idx) const
   const perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return utime_t();
-  uint64_t v = data.u64;
+  uint64_t v = data.read();
   return utime_t(v / 1000000000ull, v % 1000000000ull);
 }
 
@@ -493,7 +513,7 @@ void PerfCounters::dump_formatted_generic(Formatter *f, bool schema,
         d->histogram->dump_formatted(f);
         f->close_section();
       } else {
-	uint64_t v = d->u64;
+	uint64_t v = d->read();
 	if (d->type & PERFCOUNTER_U64) {
 	  f->dump_unsigned(d->name, v);
 	} else if (d->type & PERFCOUNTER_TIME) {
@@ -618,14 +638,47 @@ void PerfCountersBuilder::add_impl(
   data.histogram = std::move(histogram);
 }
 
+// counters only ever added to, rather than set
+static bool is_sharded(int type)
+{
+  return !(type & PERFCOUNTER_HISTOGRAM) &&
+    (type & (PERFCOUNTER_COUNTER | PERFCOUNTER_LONGRUNAVG));
+}
+
 PerfCounters *PerfCountersBuilder::create_perf_counters()
 {
   PerfCounters::perf_counter_data_vec_t::const_iterator d = m_perf_counters->m_data.begin();
   PerfCounters::perf_counter_data_vec_t::const_iterator d_end = m_perf_counters->m_data.end();
+  uint32_t num_sharded = 0;
   for (; d != d_end; ++d) {
     ceph_assert(d->type != PERFCOUNTER_NONE);
     ceph_assert(d->type & (PERFCOUNTER_U64 | PERFCOUNTER_TIME));
+    if (is_sharded(d->type)) {
+      ++num_sharded;
+    }
+  }
+
+#if !defined(WITH_SEASTAR) || defined(WITH_ALIEN)
+  // a crimson reactor owns its counters, there is nothing to contend on
+  if (num_sharded) {
+    // keep each row of shards in cache lines of its own
+    constexpr uint32_t per_line = 64 / sizeof(PerfCounters::counter_shard_t);
+    uint32_t stride = round_up_to(num_sharded, per_line);
+    auto& shards = m_perf_counters->m_shards;
+    shards.reset(new PerfCounters::counter_shard_t[
+      PerfCounters::NUM_COUNTER_SHARDS * stride + per_line - 1]);
+    auto base = shards.get();
+    while (reinterpret_cast<uintptr_t>(base) % 64) {
+      ++base;
+    }
+    for (auto& data : m_perf_counters->m_data) {
+      if (is_sharded(data.type)) {
+	data.shards = base++;
+	data.shard_stride = stride;
+      }
+    }
   }
+#endif
 
   PerfCounters *ret = m_perf_counters;
   m_perf_counters = NULL;
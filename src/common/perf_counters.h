@@ -154,6 +154,17 @@ private:
 class PerfCounters
 {
 public:
+  /// a thread's share of a counter that is only ever added to.  inc() and
+  /// tinc() bump the calling thread's shard of such counters, so threads
+  /// bumping the same counter do not all write the same cache line;
+  /// readers add the shards up.
+  struct alignas(32) counter_shard_t {
+    std::atomic<uint64_t> u64 = { 0 };
+    std::atomic<uint64_t> avgcount = { 0 };
+    std::atomic<uint64_t> avgcount2 = { 0 };
+  };
+  static constexpr unsigned NUM_COUNTER_SHARDS = 8;
+
   /** Represents a PerfCounters data element. */
   struct perf_counter_data_any_d {
     perf_counter_data_any_d()
@@ -169,7 +180,7 @@ public:
         nick(other.nick),
 	 type(other.type),
 	 unit(other.unit),
-	 u64(other.u64.load()) {
+	 u64(other.read()) {
       auto a = other.read_avg();
       u64 = a.first;
       avgcount = a.second;
@@ -189,6 +200,10 @@ public:
     std::atomic<uint64_t> avgcount = { 0 };
     std::atomic<uint64_t> avgcount2 = { 0 };
     std::unique_ptr<PerfHistogram<>> histogram;
+    /// NUM_COUNTER_SHARDS shards, shard_stride apart, if this counter has
+    /// them; what set() stores goes to u64 above
+    counter_shard_t *shards = nullptr;
+    uint32_t shard_stride = 0;
 
     void reset()
     {
@@ -196,16 +211,45 @@ public:
 	    u64 = 0;
 	    avgcount = 0;
 	    avgcount2 = 0;
+	    for (unsigned i = 0; shards && i < NUM_COUNTER_SHARDS; ++i) {
+	      auto& s = shards[i * shard_stride];
+	      s.u64 = 0;
+	      s.avgcount = 0;
+	      s.avgcount2 = 0;
+	    }
       }
       if (histogram) {
         histogram->reset();
       }
     }
 
+    uint64_t read() const {
+      uint64_t v = u64;
+      for (unsigned i = 0; shards && i < NUM_COUNTER_SHARDS; ++i) {
+	v += shards[i * shard_stride].u64;
+      }
+      return v;
+    }
+
     // read <sum, count> safely by making sure the post- and pre-count
     // are identical; in other words the whole loop needs to be run
     // without any intervening calls to inc, set, or tinc.
     std::pair<uint64_t,uint64_t> read_avg() const {
+      auto [sum, count] = read_avg(u64, avgcount, avgcount2);
+      for (unsigned i = 0; shards && i < NUM_COUNTER_SHARDS; ++i) {
+	auto& s = shards[i * shard_stride];
+	auto [ssum, scount] = read_avg(s.u64, s.avgcount, s.avgcount2);
+	sum += ssum;
+	count += scount;
+      }
+      return { sum, count };
+    }
+
+  private:
+    static std::pair<uint64_t,uint64_t> read_avg(
+      const std::atomic<uint64_t>& u64,
+      const std::atomic<uint64_t>& avgcount,
+      const std::atomic<uint64_t>& avgcount2) {
       uint64_t sum, count;
       do {
 	count = avgcount2;
@@ -297,6 +341,12 @@ private:
 #endif
 
   perf_counter_data_vec_t m_data;
+  /// backs the shards of m_data, one row of counters per shard
+  std::unique_ptr<counter_shard_t[]> m_shards;
+
+  /// the shard the calling thread adds to, or u64 if there are none
+  static counter_shard_t& _my_shard(perf_counter_data_any_d& data);
+  static void _add(perf_counter_data_any_d& data, uint64_t v);
 
   friend class PerfCountersBuilder;
   friend class PerfCountersCollectionImpl;
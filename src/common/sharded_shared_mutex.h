@@ -0,0 +1,109 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+
+#pragma once
+
+#include "common/ceph_mutex.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <utility>
+
+namespace ceph {
+/// a reader/writer mutex whose shared side scales with the number of cores
+///
+/// Each reader thread sticks to one of a set of independent shared_mutexes,
+/// a writer takes all of them.  With a plain shared_mutex every reader
+/// bumps the same reader count, which turns into a contended cache line
+/// once many threads take the lock shared at a high rate; here they only
+/// meet when they happen to share a shard.  Meant for read-mostly state
+/// that is locked exclusively rarely (e.g. when a new OSDMap comes in).
+///
+/// A thread must release a shared lock itself: the shard is picked per
+/// thread, not recorded anywhere.
+class sharded_shared_mutex {
+  // lockdep only knows locks by name, and would take the shards for
+  // recursive locking of the same lock
+  static constexpr unsigned num_shards = mutex_debugging ? 1 : 16;
+
+public:
+  sharded_shared_mutex(const std::string& name)
+    : shards{make_shards(name, std::make_index_sequence<num_shards>{})}
+  {}
+  ~sharded_shared_mutex() = default;
+  sharded_shared_mutex(const sharded_shared_mutex&) = delete;
+  sharded_shared_mutex& operator=(const sharded_shared_mutex&) = delete;
+
+  void lock() {
+    for (auto& s : shards) {
+      s.lock.lock();
+    }
+  }
+
+  bool try_lock() {
+    for (unsigned i = 0; i < num_shards; ++i) {
+      if (!shards[i].lock.try_lock()) {
+        while (i-- > 0) {
+          shards[i].lock.unlock();
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void unlock() {
+    for (auto s = shards.rbegin(); s != shards.rend(); ++s) {
+      s->lock.unlock();
+    }
+  }
+
+  void lock_shared() {
+    my_shard().lock_shared();
+  }
+
+  bool try_lock_shared() {
+    return my_shard().try_lock_shared();
+  }
+
+  void unlock_shared() {
+    my_shard().unlock_shared();
+  }
+
+#ifdef CEPH_DEBUG_MUTEX
+  bool is_locked() const {
+    return shards[0].lock.is_locked();
+  }
+  bool is_rlocked() const {
+    return shards[0].lock.is_rlocked();
+  }
+  bool is_wlocked() const {
+    return shards[0].lock.is_wlocked();
+  }
+  bool is_locked_by_me() const {
+    return shards[0].lock.is_locked_by_me();
+  }
+#endif
+
+private:
+  ceph::shared_mutex& my_shard() {
+    static std::atomic<unsigned> next_shard = 0;
+    thread_local const unsigned shard = next_shard++ % num_shards;
+    return shards[shard].lock;
+  }
+
+  struct alignas(64) shard_t {
+    ceph::shared_mutex lock;
+    shard_t(const std::string& name)
+      : lock{ceph::make_shared_mutex(name)}
+    {}
+  };
+  using shards_t = std::array<shard_t, num_shards>;
+  template <std::size_t... I>
+  static shards_t make_shards(const std::string& name,
+                              std::index_sequence<I...>) {
+    return {{((void)I, shard_t{name})...}};
+  }
+  shards_t shards;
+};
+} // namespace ceph
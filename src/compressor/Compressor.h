@@ -88,6 +88,30 @@ public:
   // alignment with decode methods
   virtual int decompress(ceph::bufferlist::const_iterator &p, size_t compressed_len, ceph::bufferlist &out, std::optional<int32_t> compressor_message) = 0;
 
+  /// compression context kept across calls
+  ///
+  /// What a stream compresses may refer back to anything it compressed
+  /// before, so small and repetitive inputs compress well when they are fed
+  /// through the same stream.  The output of a CompressStream can only be
+  /// decompressed by a single DecompressStream, fed in the same order.
+  class CompressStream {
+  public:
+    virtual ~CompressStream() = default;
+    virtual int compress(const ceph::bufferlist &in, ceph::bufferlist &out) = 0;
+  };
+  class DecompressStream {
+  public:
+    virtual ~DecompressStream() = default;
+    virtual int decompress(const ceph::bufferlist &in, ceph::bufferlist &out) = 0;
+  };
+  /// nullptr if the algorithm has no streaming mode
+  virtual std::unique_ptr<CompressStream> create_compress_stream() {
+    return nullptr;
+  }
+  virtual std::unique_ptr<DecompressStream> create_decompress_stream() {
+    return nullptr;
+  }
+
   static CompressorRef create(CephContext *cct, const std::string &type);
   static CompressorRef create(CephContext *cct, int alg);
 
@@ -18,8 +18,16 @@
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd/lib/zstd.h"
 
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <vector>
+
 #include "include/buffer.h"
 #include "include/encoding.h"
+#include "include/mempool.h"
+#include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 #include "compressor/Compressor.h"
 
 class ZstdCompressor : public Compressor {
@@ -27,7 +35,7 @@ class ZstdCompressor : public Compressor {
   ZstdCompressor(CephContext *cct) : Compressor(COMP_ALG_ZSTD, "zstd"), cct(cct) {}
 
   int compress(const ceph::buffer::list &src, ceph::buffer::list &dst, std::optional<int32_t> &compressor_message) override {
-    ZSTD_CStream *s = ZSTD_createCStream();
+    ZSTD_CStream *s = get_cstream();
     ZSTD_initCStream_srcSize(s, cct->_conf->compressor_zstd_level, src.length());
     auto p = src.begin();
     size_t left = src.length();
@@ -48,12 +56,13 @@ class ZstdCompressor : public Compressor {
       ZSTD_EndDirective const zed = (left==0) ? ZSTD_e_end : ZSTD_e_continue;
       size_t r = ZSTD_compressStream2(s, &outbuf, &inbuf, zed);
       if (ZSTD_isError(r)) {
+	ZSTD_freeCStream(s);
 	return -EINVAL;
       }
     }
     ceph_assert(p.end());
 
-    ZSTD_freeCStream(s);
+    put_cstream(s);
 
     // prefix with decompressed length
     ceph::encode((uint32_t)src.length(), dst);
@@ -82,10 +91,11 @@ class ZstdCompressor : public Compressor {
     outbuf.dst = dstptr.c_str();
     outbuf.size = dstptr.length();
     outbuf.pos = 0;
-    ZSTD_DStream *s = ZSTD_createDStream();
+    ZSTD_DStream *s = get_dstream();
     ZSTD_initDStream(s);
     while (compressed_len > 0) {
       if (p.end()) {
+	ZSTD_freeDStream(s);
 	return -1;
       }
       ZSTD_inBuffer_s inbuf;
@@ -95,13 +105,215 @@ class ZstdCompressor : public Compressor {
       ZSTD_decompressStream(s, &outbuf, &inbuf);
       compressed_len -= inbuf.size;
     }
-    ZSTD_freeDStream(s);
+    put_dstream(s);
 
     dst.append(dstptr, 0, outbuf.pos);
     return 0;
   }
+
+  // a stream is held for the life of a connection: bound what its
+  // contexts cost by capping the window (128KiB) and the level, which
+  // matter most for the history small messages refer back to anyway
+  static constexpr int STREAM_WINDOW_LOG = 17;
+  static constexpr int STREAM_MAX_LEVEL = 3;
+
+  class ZstdCompressStream : public CompressStream {
+    ZSTD_CCtx *ctx;
+  public:
+    ZstdCompressStream(int level) : ctx(ZSTD_createCCtx()) {
+      ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel,
+			     std::min(level, STREAM_MAX_LEVEL));
+      ZSTD_CCtx_setParameter(ctx, ZSTD_c_windowLog, STREAM_WINDOW_LOG);
+    }
+    ~ZstdCompressStream() override {
+      ZSTD_freeCCtx(ctx);
+    }
+    int compress(const ceph::buffer::list &src, ceph::buffer::list &dst) override {
+      // flushing at the end makes all of src decodable from this output
+      // while keeping the window (and its history) for the next call
+      size_t const out_max = ZSTD_compressBound(src.length()) + ZSTD_CStreamOutSize();
+      ceph::buffer::ptr outptr = ceph::buffer::create_small_page_aligned(out_max);
+      ZSTD_outBuffer_s outbuf = {outptr.c_str(), outptr.length(), 0};
+      for (const auto& ptr : src.buffers()) {
+	ZSTD_inBuffer_s inbuf = {ptr.c_str(), ptr.length(), 0};
+	while (inbuf.pos < inbuf.size) {
+	  size_t in_pos = inbuf.pos, out_pos = outbuf.pos;
+	  size_t r = ZSTD_compressStream2(ctx, &outbuf, &inbuf, ZSTD_e_continue);
+	  if (ZSTD_isError(r) ||
+	      (inbuf.pos == in_pos && outbuf.pos == out_pos)) {
+	    return -EINVAL;
+	  }
+	}
+      }
+      ZSTD_inBuffer_s empty = {nullptr, 0, 0};
+      size_t r;
+      do {
+	r = ZSTD_compressStream2(ctx, &outbuf, &empty, ZSTD_e_flush);
+	if (ZSTD_isError(r) || (r && outbuf.pos == outbuf.size)) {
+	  return -EINVAL;
+	}
+      } while (r);
+
+      ceph::encode((uint32_t)src.length(), dst);
+      dst.append(outptr, 0, outbuf.pos);
+      return 0;
+    }
+  };
+
+  class ZstdDecompressStream : public DecompressStream {
+    ZSTD_DCtx *ctx;
+  public:
+    ZstdDecompressStream() : ctx(ZSTD_createDCtx()) {
+      // refuse a peer asking for a larger window than we would use
+      ZSTD_DCtx_setParameter(ctx, ZSTD_d_windowLogMax, STREAM_WINDOW_LOG);
+    }
+    ~ZstdDecompressStream() override {
+      ZSTD_freeDCtx(ctx);
+    }
+    int decompress(const ceph::buffer::list &src, ceph::buffer::list &dst) override {
+      if (src.length() < 4) {
+	return -1;
+      }
+      auto p = src.cbegin();
+      uint32_t dst_len;
+      ceph::decode(dst_len, p);
+      size_t left = src.length() - 4;
+
+      ceph::buffer::ptr dstptr(dst_len);
+      ZSTD_outBuffer_s outbuf = {dstptr.c_str(), dstptr.length(), 0};
+      while (left > 0) {
+	ZSTD_inBuffer_s inbuf = {nullptr, 0, 0};
+	inbuf.size = p.get_ptr_and_advance(left, (const char**)&inbuf.src);
+	left -= inbuf.size;
+	while (inbuf.pos < inbuf.size) {
+	  size_t in_pos = inbuf.pos, out_pos = outbuf.pos;
+	  size_t r = ZSTD_decompressStream(ctx, &outbuf, &inbuf);
+	  if (ZSTD_isError(r) ||
+	      (inbuf.pos == in_pos && outbuf.pos == out_pos)) {
+	    return -1;
+	  }
+	}
+      }
+      if (outbuf.pos != dst_len) {
+	return -1;
+      }
+      dst.append(dstptr, 0, outbuf.pos);
+      return 0;
+    }
+  };
+
+  std::unique_ptr<CompressStream> create_compress_stream() override {
+    return std::make_unique<ZstdCompressStream>(cct->_conf->compressor_zstd_level);
+  }
+  std::unique_ptr<DecompressStream> create_decompress_stream() override {
+    return std::make_unique<ZstdDecompressStream>();
+  }
  private:
   CephContext *const cct;
+
+  // a stream holds the compression state and window, which for small
+  // blobs costs more to allocate and set up than the compression itself,
+  // so keep the ones not in use around for the next call. the ones kept
+  // are bounded by compressor_zstd_stream_cache_bytes in each cache, freed
+  // once idle for compressor_zstd_stream_cache_age, and accounted in
+  // mempool::compressor
+  template <typename Stream,
+	    Stream* (*create)(),
+	    size_t (*destroy)(Stream*),
+	    size_t (*size_of)(const Stream*)>
+  class StreamCache {
+    struct Idle {
+      Stream *s;
+      size_t bytes;
+      ceph::coarse_mono_time since;
+    };
+    CephContext *const cct;
+    ceph::mutex lock = ceph::make_mutex("ZstdCompressor::StreamCache::lock");
+    std::deque<Idle> idle; // the most recently used at the back
+    size_t idle_bytes = 0;
+
+    static void account(ssize_t items, ssize_t bytes) {
+      mempool::get_pool(mempool::mempool_compressor).adjust_count(items, bytes);
+    }
+    // free the streams idle for too long, or beyond the bytes allowed
+    void trim(ceph::coarse_mono_time now, size_t max_bytes,
+	      std::vector<Stream*>& to_free) {
+      auto max_age = ceph::make_timespan(
+	cct->_conf->compressor_zstd_stream_cache_age);
+      while (!idle.empty() &&
+	     (idle_bytes > max_bytes || now - idle.front().since > max_age)) {
+	auto& i = idle.front();
+	idle_bytes -= i.bytes;
+	account(-1, -(ssize_t)i.bytes);
+	to_free.push_back(i.s);
+	idle.pop_front();
+      }
+    }
+  public:
+    explicit StreamCache(CephContext *cct) : cct(cct) {}
+    ~StreamCache() {
+      for (auto& i : idle) {
+	account(-1, -(ssize_t)i.bytes);
+	destroy(i.s);
+      }
+    }
+    Stream *get() {
+      Stream *s = nullptr;
+      std::vector<Stream*> to_free;
+      {
+	std::lock_guard l(lock);
+	trim(ceph::coarse_mono_clock::now(),
+	     cct->_conf->compressor_zstd_stream_cache_bytes, to_free);
+	if (!idle.empty()) {
+	  auto& i = idle.back();
+	  s = i.s;
+	  idle_bytes -= i.bytes;
+	  account(-1, -(ssize_t)i.bytes);
+	  idle.pop_back();
+	}
+      }
+      for (auto f : to_free) {
+	destroy(f);
+      }
+      return s ? s : create();
+    }
+    void put(Stream *s) {
+      size_t bytes = size_of(s);
+      size_t max_bytes = cct->_conf->compressor_zstd_stream_cache_bytes;
+      std::vector<Stream*> to_free;
+      if (bytes > max_bytes) {
+	to_free.push_back(s);
+      } else {
+	std::lock_guard l(lock);
+	auto now = ceph::coarse_mono_clock::now();
+	idle.push_back({s, bytes, now});
+	idle_bytes += bytes;
+	account(1, bytes);
+	trim(now, max_bytes, to_free);
+      }
+      for (auto f : to_free) {
+	destroy(f);
+      }
+    }
+  };
+
+  StreamCache<ZSTD_CStream, ZSTD_createCStream, ZSTD_freeCStream,
+	      ZSTD_sizeof_CStream> cstreams{cct};
+  StreamCache<ZSTD_DStream, ZSTD_createDStream, ZSTD_freeDStream,
+	      ZSTD_sizeof_DStream> dstreams{cct};
+
+  ZSTD_CStream *get_cstream() {
+    return cstreams.get();
+  }
+  void put_cstream(ZSTD_CStream *s) {
+    cstreams.put(s);
+  }
+  ZSTD_DStream *get_dstream() {
+    return dstreams.get();
+  }
+  void put_dstream(ZSTD_DStream *s) {
+    dstreams.put(s);
+  }
 };
 
 #endif
@@ -188,6 +188,10 @@ Socket::write(bufferlist buf)
     inject_failure();
     return inject_delay(
     ).then([buf = std::move(buf), this]() mutable {
+      // each buffer::ptr becomes a fragment of the packet that holds a
+      // reference to it, and output_stream queues packets as they are, so
+      // data segments reach sendmsg() without being copied; only the kernel
+      // copies them, as seastar's sockets don't offer MSG_ZEROCOPY
       packet p(std::move(buf));
       return out.write(std::move(p));
     });
@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <boost/lockfree/queue.hpp>
 #include <boost/optional.hpp>
+#include <seastar/core/alien.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/reactor.hh>
@@ -41,7 +42,9 @@ struct Task final : WorkItem {
   using futurator_t = seastar::futurize<T>;
 public:
   explicit Task(Func&& f)
-    : func(std::move(f))
+    : func(std::move(f)),
+      alien(seastar::engine().alien()),
+      shard(seastar::this_shard_id())
   {}
   void process() override {
     try {
@@ -54,10 +57,14 @@ public:
     } catch (...) {
       state.set_exception(std::current_exception());
     }
-    on_done.write_side().signal(1);
+    // the reactor drains the messages from alien threads in batches, which
+    // is cheaper than waking it up through an eventfd per task
+    seastar::alien::run_on(alien, shard, [this]() noexcept {
+      on_done.set_value();
+    });
   }
   typename futurator_t::type get_future() {
-    return on_done.wait().then([this](size_t) {
+    return on_done.get_future().then([this] {
       if (state.failed()) {
         return futurator_t::make_exception_future(state.get_exception());
       } else {
@@ -68,7 +75,9 @@ public:
 private:
   Func func;
   seastar::future_state<future_stored_type_t> state;
-  seastar::readable_eventfd on_done;
+  seastar::alien::instance& alien;
+  const unsigned shard;
+  seastar::promise<> on_done;
 };
 
 struct SubmitQueue {
@@ -154,9 +163,11 @@ public:
         });
   }
 
+  /// tasks without ordering constraints stay on the thread of their reactor
   template<typename Func>
   auto submit(Func&& func) {
-    return submit(::rand() % n_threads, std::forward<Func>(func));
+    return submit(seastar::this_shard_id() % n_threads,
+                  std::forward<Func>(func));
   }
 
 private:
@@ -949,6 +949,10 @@ void SegmentCleaner::register_metrics()
     sm::make_gauge("reclaim_ratio",
                    [this] { return get_reclaim_ratio(); },
                    sm::description("ratio of reclaimable space to unavailable space")),
+    sm::make_gauge("reclaim_write_amplification",
+                   [this] { return get_reclaim_write_amplification(); },
+                   sm::description("ratio of bytes written to closed segments "
+                                   "to those not rewritten by reclaim")),
 
     sm::make_histogram("segment_utilization_distribution",
 		       [this]() -> seastar::metrics::histogram& {
@@ -7,6 +7,7 @@
 #include <seastar/core/metrics_types.hh>
 
 #include "common/ceph_time.h"
+#include "crimson/common/config_proxy.h"
 
 #include "osd/osd_types.h"
 
@@ -1202,7 +1203,8 @@ public:
         .15,  // available_ratio_gc_max
         .1,   // available_ratio_hard_limit
         .1,   // reclaim_ratio_gc_threshold
-        1<<20 // reclaim_bytes_per_cycle
+        crimson::common::get_conf<Option::size_t>(
+          "seastore_segment_cleaner_reclaim_bytes_per_cycle")
       };
     }
 
@@ -1503,6 +1505,14 @@ private:
   double get_alive_ratio() const {
     return stats.used_bytes / (double)segments.get_total_bytes();
   }
+  /// total bytes written to segments per byte written by everything but
+  /// reclaim, 1 if nothing has been rewritten
+  double get_reclaim_write_amplification() const {
+    uint64_t written = stats.closed_journal_total_bytes +
+                       stats.closed_ool_total_bytes;
+    if (written <= stats.reclaimed_bytes) return 1;
+    return (double)written / (double)(written - stats.reclaimed_bytes);
+  }
 
   /*
    * Space calculations (projected)
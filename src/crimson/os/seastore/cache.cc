@@ -41,10 +41,13 @@ Cache::Cache(
   ExtentPlacementManager &epm)
   : epm(epm),
     lru(crimson::common::get_conf<Option::size_t>(
-	  "seastore_cache_lru_size"))
+	  "seastore_cache_lru_size")),
+    data_lru(crimson::common::get_conf<Option::size_t>(
+	  "seastore_cache_data_lru_size"))
 {
   LOG_PREFIX(Cache::Cache);
-  INFO("created, lru_size={}", lru.get_capacity());
+  INFO("created, lru_size={}, data_lru_size={}",
+       lru.get_capacity(), data_lru.get_capacity());
   register_metrics();
   segment_providers_by_device_id.resize(DEVICE_ID_MAX, nullptr);
 }
@@ -494,6 +497,20 @@ void Cache::register_metrics()
 	},
 	sm::description("total extents pinned by the lru")
       ),
+      sm::make_counter(
+	"cache_data_lru_size_bytes",
+	[this] {
+	  return data_lru.get_current_contents_bytes();
+	},
+	sm::description("total bytes pinned by the data lru")
+      ),
+      sm::make_counter(
+	"cache_data_lru_size_extents",
+	[this] {
+	  return data_lru.get_current_contents_extents();
+	},
+	sm::description("total extents pinned by the data lru")
+      ),
     }
   );
 
@@ -721,7 +738,7 @@ void Cache::mark_dirty(CachedExtentRef ref)
     return;
   }
 
-  lru.remove_from_lru(*ref);
+  get_lru(*ref).remove_from_lru(*ref);
   ref->state = CachedExtent::extent_state_t::DIRTY;
   add_to_dirty(ref);
 }
@@ -754,7 +771,7 @@ void Cache::remove_extent(CachedExtentRef ref)
   if (ref->is_dirty()) {
     remove_from_dirty(ref);
   } else if (!ref->is_placeholder()) {
-    lru.remove_from_lru(*ref);
+    get_lru(*ref).remove_from_lru(*ref);
   }
   extents.erase(*ref);
 }
@@ -797,7 +814,7 @@ void Cache::commit_replace_extent(
     intrusive_ptr_release(&*prev);
     intrusive_ptr_add_ref(&*next);
   } else {
-    lru.remove_from_lru(*prev);
+    get_lru(*prev).remove_from_lru(*prev);
     add_to_dirty(next);
   }
 
@@ -1706,13 +1723,15 @@ Cache::close_ertr::future<> Cache::close()
 {
   LOG_PREFIX(Cache::close);
   INFO("close with {}({}B) dirty, dirty_from={}, alloc_from={}, "
-       "{}({}B) lru, totally {}({}B) indexed extents",
+       "{}({}B) lru, {}({}B) data lru, totally {}({}B) indexed extents",
        dirty.size(),
        stats.dirty_bytes,
        get_oldest_dirty_from().value_or(JOURNAL_SEQ_NULL),
        get_oldest_backref_dirty_from().value_or(JOURNAL_SEQ_NULL),
        lru.get_current_contents_extents(),
        lru.get_current_contents_bytes(),
+       data_lru.get_current_contents_extents(),
+       data_lru.get_current_contents_bytes(),
        extents.size(),
        extents.get_bytes());
   root.reset();
@@ -1726,6 +1745,7 @@ Cache::close_ertr::future<> Cache::close()
   backref_entryrefs_by_seq.clear();
   assert(stats.dirty_bytes == 0);
   lru.clear();
+  data_lru.clear();
   return close_ertr::now();
 }
 
@@ -1345,7 +1345,7 @@ public:
     if (p_src && is_background_transaction(*p_src))
       return;
     if (ext.is_stable_clean() && !ext.is_placeholder()) {
-      lru.move_to_top(ext);
+      get_lru(ext).move_to_top(ext);
     }
   }
 
@@ -1483,7 +1483,17 @@ private:
     ~LRU() {
       clear();
     }
-  } lru;
+  } lru, data_lru;
+
+  /// object data extents get a budget of their own if data_lru is sized,
+  /// so that reading through objects does not evict the metadata
+  LRU &get_lru(const CachedExtent &extent) {
+    if (data_lru.get_capacity() > 0 &&
+        extent.get_type() == extent_types_t::OBJECT_DATA_BLOCK) {
+      return data_lru;
+    }
+    return lru;
+  }
 
   struct query_counters_t {
     uint64_t access = 0;
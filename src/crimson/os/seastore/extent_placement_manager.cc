@@ -10,14 +10,24 @@ SET_SUBSYS(seastore_epm);
 
 namespace crimson::os::seastore {
 
+static std::size_t get_ool_iodepth_limit()
+{
+  auto iodepth = crimson::common::get_conf<uint64_t>(
+    "seastore_ool_iodepth_limit");
+  if (iodepth == 0) {
+    iodepth = crimson::common::get_conf<uint64_t>(
+      "seastore_journal_iodepth_limit");
+  }
+  return iodepth;
+}
+
 SegmentedOolWriter::SegmentedOolWriter(
   data_category_t category,
   rewrite_gen_t gen,
   SegmentProvider& sp,
   SegmentSeqAllocator &ssa)
   : segment_allocator(nullptr, category, gen, sp, ssa),
-    record_submitter(crimson::common::get_conf<uint64_t>(
-                       "seastore_journal_iodepth_limit"),
+    record_submitter(get_ool_iodepth_limit(),
                      crimson::common::get_conf<uint64_t>(
                        "seastore_journal_batch_capacity"),
                      crimson::common::get_conf<Option::size_t>(
@@ -802,9 +812,15 @@ RandomBlockOolWriter::do_write(
     } else {
       bp = ex->get_bptr();
     }
+    // let a multi-stream device keep the frequently rewritten metadata
+    // apart from the data
+    uint16_t stream =
+      get_extent_category(ex->get_type()) == data_category_t::METADATA ?
+      WRITE_LIFE_SHORT : WRITE_LIFE_LONG;
     return trans_intr::make_interruptible(
       rbm->write(paddr + offset,
-	bp
+	bp,
+	stream
       ).handle_error(
 	alloc_write_iertr::pass_further{},
 	crimson::ct_error::assert_all{
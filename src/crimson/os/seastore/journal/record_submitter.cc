@@ -6,6 +6,7 @@
 #include <fmt/format.h>
 #include <fmt/os.h>
 
+#include "crimson/common/config_proxy.h"
 #include "crimson/os/seastore/logging.h"
 #include "crimson/os/seastore/async_cleaner.h"
 
@@ -131,14 +132,16 @@ RecordSubmitter::RecordSubmitter(
   JournalAllocator& ja)
   : io_depth_limit{io_depth},
     preferred_fullness{preferred_fullness},
+    target_latency_us{crimson::common::get_conf<uint64_t>(
+      "seastore_journal_batch_target_latency_us")},
     journal_allocator{ja},
     batches(new RecordBatch[io_depth + 1])
 {
   LOG_PREFIX(RecordSubmitter);
   INFO("{} io_depth_limit={}, batch_capacity={}, batch_flush_size={}, "
-       "preferred_fullness={}",
+       "preferred_fullness={}, target_latency_us={}",
        get_name(), io_depth, batch_capacity,
-       batch_flush_size, preferred_fullness);
+       batch_flush_size, preferred_fullness, target_latency_us);
   ceph_assert(io_depth > 0);
   ceph_assert(batch_capacity > 0);
   ceph_assert(preferred_fullness >= 0 &&
@@ -285,7 +288,8 @@ RecordSubmitter::submit(
       // RecordBatch::needs_flush()
       eval.is_full ||
       p_current_batch->get_num_records() + 1 >=
-        p_current_batch->get_batch_capacity());
+        p_current_batch->get_batch_capacity() ||
+      is_batching_over_latency());
   if (p_current_batch->is_empty() &&
       needs_flush &&
       state != state_t::FULL) {
@@ -299,13 +303,15 @@ RecordSubmitter::submit(
     DEBUG("{} fast submit {}, committed_to={}, outstanding_io={} ...",
           get_name(), sizes, get_committed_to(), num_outstanding_io);
     account_submission(1, sizes);
+    auto start = std::chrono::steady_clock::now();
     return journal_allocator.write(std::move(to_write)
     ).safe_then([mdlength = sizes.get_mdlength()](auto write_result) {
       return record_locator_t{
         write_result.start_seq.offset.add_offset(mdlength),
         write_result
       };
-    }).finally([this] {
+    }).finally([this, start] {
+      account_write_latency(start);
       decrement_io_with_flush();
     });
   }
@@ -468,7 +474,8 @@ void RecordSubmitter::decrement_io_with_flush()
       !p_current_batch->is_empty() && (
         state == state_t::IDLE ||
         p_current_batch->get_submit_size().get_fullness() > preferred_fullness ||
-        p_current_batch->needs_flush()
+        p_current_batch->needs_flush() ||
+        is_batching_over_latency()
       ));
   if (needs_flush) {
     DEBUG("{} flush", get_name());
@@ -487,6 +494,31 @@ void RecordSubmitter::account_submission(
   stats.record_batch_stats.increment(num);
 }
 
+void RecordSubmitter::account_write_latency(
+  std::chrono::steady_clock::time_point start)
+{
+  if (target_latency_us == 0) {
+    return;
+  }
+  double sample = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - start).count();
+  if (avg_write_latency_us == 0) {
+    avg_write_latency_us = sample;
+  } else {
+    // smooth like the TCP round-trip estimator
+    avg_write_latency_us += (sample - avg_write_latency_us) / 8;
+  }
+}
+
+bool RecordSubmitter::is_batching_over_latency() const
+{
+  // a record left pending waits for an outstanding write to finish before
+  // its own write even starts, so it sees about twice the write latency
+  return target_latency_us > 0 &&
+         state == state_t::PENDING &&
+         2 * avg_write_latency_us > target_latency_us;
+}
+
 void RecordSubmitter::finish_submit_batch(
   RecordBatch* p_batch,
   maybe_result_t maybe_result)
@@ -512,8 +544,11 @@ void RecordSubmitter::flush_current_batch()
   DEBUG("{} {} records, {}, committed_to={}, outstanding_io={} ...",
         get_name(), num, sizes, get_committed_to(), num_outstanding_io);
   account_submission(num, sizes);
+  auto start = std::chrono::steady_clock::now();
   std::ignore = journal_allocator.write(std::move(to_write)
-  ).safe_then([this, p_batch, FNAME, num, sizes=sizes](auto write_result) {
+  ).finally([this, start] {
+    account_write_latency(start);
+  }).safe_then([this, p_batch, FNAME, num, sizes=sizes](auto write_result) {
     TRACE("{} {} records, {}, write done with {}",
           get_name(), num, sizes, write_result);
     finish_submit_batch(p_batch, write_result);
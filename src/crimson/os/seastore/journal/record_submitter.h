@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <optional>
 #include <seastar/core/circular_buffer.hh>
 #include <seastar/core/metrics.hh>
@@ -208,6 +209,8 @@ private:
  * - batch_flush_size: the bytes threshold to force flush a RecordBatch to
  *   control the maximum latency;
  * - preferred_fullness: the fullness threshold to flush a RecordBatch;
+ * - target_latency_us: if non-zero, stop holding records back for a batch
+ *   while the measured write latency would push them beyond this target;
  */
 class RecordSubmitter {
   enum class state_t {
@@ -308,6 +311,10 @@ private:
 
   void account_submission(std::size_t, const record_group_size_t&);
 
+  void account_write_latency(std::chrono::steady_clock::time_point start);
+
+  bool is_batching_over_latency() const;
+
   using maybe_result_t = RecordBatch::maybe_result_t;
   void finish_submit_batch(RecordBatch*, maybe_result_t);
 
@@ -317,6 +324,9 @@ private:
   std::size_t num_outstanding_io = 0;
   std::size_t io_depth_limit;
   double preferred_fullness;
+  uint64_t target_latency_us;
+  // smoothed latency of the writes to journal_allocator
+  double avg_write_latency_us = 0;
 
   JournalAllocator& journal_allocator;
   // committed_to may be in a previous journal segment
@@ -127,35 +127,47 @@ BtreeLBAManager::get_mappings(
   return with_btree_state<LBABtree, lba_pin_list_t>(
     cache,
     c,
-    [c, offset, length, FNAME, this](auto &btree, auto &ret) {
+    [c, offset, length, this](auto &btree, auto &ret) {
       return seastar::do_with(
 	std::list<BtreeLBAMappingRef>(),
-	[offset, length, c, FNAME, this, &ret, &btree](auto &pin_list) {
-	return LBABtree::iterate_repeat(
-	  c,
-	  btree.upper_bound_right(c, offset),
-	  [&pin_list, offset, length, c, FNAME](auto &pos) {
-	    if (pos.is_end() || pos.get_key() >= (offset + length)) {
-	      TRACET("{}~{} done with {} results",
-		     c.trans, offset, length, pin_list.size());
-	      return LBABtree::iterate_repeat_ret_inner(
-		interruptible::ready_future_marker{},
-		seastar::stop_iteration::yes);
-	    }
-	    TRACET("{}~{} got {}, {}, repeat ...",
-		   c.trans, offset, length, pos.get_key(), pos.get_val());
-	    ceph_assert((pos.get_key() + pos.get_val().len) > offset);
-	    pin_list.push_back(pos.get_pin(c));
-	    return LBABtree::iterate_repeat_ret_inner(
-	      interruptible::ready_future_marker{},
-	      seastar::stop_iteration::no);
-	  }).si_then([this, &ret, c, &pin_list] {
-	    return _get_original_mappings(c, pin_list
-	    ).si_then([&ret](auto _ret) {
-	      ret = std::move(_ret);
-	    });
+	[offset, length, c, this, &ret, &btree](auto &pin_list) {
+	return _get_mappings(c, btree, offset, length, pin_list
+	).si_then([this, &ret, c, &pin_list] {
+	  return _get_original_mappings(c, pin_list
+	  ).si_then([&ret](auto _ret) {
+	    ret = std::move(_ret);
 	  });
 	});
+      });
+    });
+}
+
+BtreeLBAManager::_get_mappings_ret
+BtreeLBAManager::_get_mappings(
+  op_context_t<laddr_t> c,
+  LBABtree &btree,
+  laddr_t offset, extent_len_t length,
+  std::list<BtreeLBAMappingRef> &pin_list)
+{
+  LOG_PREFIX(BtreeLBAManager::get_mappings);
+  return LBABtree::iterate_repeat(
+    c,
+    btree.upper_bound_right(c, offset),
+    [&pin_list, offset, length, c, FNAME](auto &pos) {
+      if (pos.is_end() || pos.get_key() >= (offset + length)) {
+	TRACET("{}~{} done with {} results",
+	       c.trans, offset, length, pin_list.size());
+	return LBABtree::iterate_repeat_ret_inner(
+	  interruptible::ready_future_marker{},
+	  seastar::stop_iteration::yes);
+      }
+      TRACET("{}~{} got {}, {}, repeat ...",
+	     c.trans, offset, length, pos.get_key(), pos.get_val());
+      ceph_assert((pos.get_key() + pos.get_val().len) > offset);
+      pin_list.push_back(pos.get_pin(c));
+      return LBABtree::iterate_repeat_ret_inner(
+	interruptible::ready_future_marker{},
+	seastar::stop_iteration::no);
     });
 }
 
@@ -222,20 +234,30 @@ BtreeLBAManager::get_mappings(
 {
   LOG_PREFIX(BtreeLBAManager::get_mappings);
   TRACET("{}", t, list);
-  auto l = std::make_unique<laddr_list_t>(std::move(list));
-  auto retptr = std::make_unique<lba_pin_list_t>();
-  auto &ret = *retptr;
-  return trans_intr::do_for_each(
-    l->begin(),
-    l->end(),
-    [this, &t, &ret](const auto &p) {
-      return this->get_mappings(t, p.first, p.second).si_then(
-	[&ret](auto res) {
-	  ret.splice(ret.end(), res, res.begin(), res.end());
-	  return get_mappings_iertr::now();
+  auto c = get_context(t);
+  // load the root once and resolve the indirect mappings of all the
+  // ranges in one pass
+  return with_btree_state<LBABtree, lba_pin_list_t>(
+    cache,
+    c,
+    [c, list=std::move(list), this](auto &btree, auto &ret) mutable {
+      return seastar::do_with(
+	std::move(list),
+	std::list<BtreeLBAMappingRef>(),
+	[c, this, &ret, &btree](auto &list, auto &pin_list) {
+	return trans_intr::do_for_each(
+	  list.begin(),
+	  list.end(),
+	  [c, &btree, &pin_list](const auto &p) {
+	    return _get_mappings(c, btree, p.first, p.second, pin_list);
+	  }
+	).si_then([this, &ret, c, &pin_list] {
+	  return _get_original_mappings(c, pin_list
+	  ).si_then([&ret](auto _ret) {
+	    ret = std::move(_ret);
+	  });
 	});
-    }).si_then([l=std::move(l), retptr=std::move(retptr)]() mutable {
-      return std::move(*retptr);
+      });
     });
 }
 
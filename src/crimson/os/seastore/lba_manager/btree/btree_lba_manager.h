@@ -406,6 +406,14 @@ private:
     Transaction &t,
     laddr_t offset);
 
+  /// appends the mappings overlapping [offset, offset + length) to pin_list
+  using _get_mappings_ret = get_mappings_iertr::future<>;
+  static _get_mappings_ret _get_mappings(
+    op_context_t<laddr_t> c,
+    LBABtree &btree,
+    laddr_t offset, extent_len_t length,
+    std::list<BtreeLBAMappingRef> &pin_list);
+
   using _get_original_mappings_ret = get_mappings_ret;
   _get_original_mappings_ret _get_original_mappings(
     op_context_t<laddr_t> c,
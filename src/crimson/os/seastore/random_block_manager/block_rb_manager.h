@@ -43,7 +43,10 @@ public:
    */
 
   read_ertr::future<> read(paddr_t addr, bufferptr &buffer) final;
-  write_ertr::future<> write(paddr_t addr, bufferptr &buf) final;
+  write_ertr::future<> write(
+    paddr_t addr,
+    bufferptr &buf,
+    uint16_t stream = 0) final;
   open_ertr::future<> open() final;
   close_ertr::future<> close() final;
 
@@ -1,7 +1,12 @@
 #include "ec_backend.h"
 
+#include <system_error>
+
+#include "crimson/common/log.h"
 #include "crimson/osd/shard_services.h"
 
+SET_SUBSYS(osd);
+
 ECBackend::ECBackend(shard_id_t shard,
                      ECBackend::CollectionRef coll,
                      crimson::osd::ShardServices& shard_services,
@@ -19,8 +24,12 @@ ECBackend::_read(const hobject_t& hoid,
                  const uint64_t len,
                  const uint32_t flags)
 {
-  // todo
-  return seastar::make_ready_future<bufferlist>();
+  LOG_PREFIX(ECBackend::_read);
+  // todo: an empty buffer would be taken for the object's data, so fail
+  // the read until EC reads are implemented
+  ERRORDPP("object {} {}~{}, EC reads are not supported yet",
+	   dpp, hoid, off, len);
+  return crimson::ct_error::input_output_error::make();
 }
 
 ECBackend::rep_op_fut_t
@@ -31,7 +40,15 @@ ECBackend::_submit_transaction(std::set<pg_shard_t>&& pg_shards,
                                epoch_t min_epoch, epoch_t max_epoch,
 			       std::vector<pg_log_entry_t>&& log_entries)
 {
-  // todo
-  return {seastar::now(),
-	  seastar::make_ready_future<crimson::osd::acked_peers_t>()};
+  LOG_PREFIX(ECBackend::_submit_transaction);
+  // acking would tell the client a write that was never applied is durable
+  ERRORDPP("object {}, EC writes are not supported yet, failing {}",
+	   dpp, hoid, osd_op_p.at_version);
+  auto not_supported = [] {
+    return std::system_error(
+      std::make_error_code(std::errc::operation_not_supported));
+  };
+  return {seastar::make_exception_future<>(not_supported()),
+	  seastar::make_exception_future<crimson::osd::acked_peers_t>(
+	    not_supported())};
 }
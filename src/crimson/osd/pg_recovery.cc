@@ -119,7 +119,7 @@ size_t PGRecovery::start_primary_recovery_ops(
   unsigned started = 0;
   int skipped = 0;
 
-  map<version_t, hobject_t>::const_iterator p =
+  pg_missing_t::rmissing_t::const_iterator p =
     missing.get_rmissing().lower_bound(pg->get_peering_state().get_pg_log().get_log().last_requested);
   while (started < max_to_start && p != missing.get_rmissing().end()) {
     // TODO: chain futures here to enable yielding to scheduler?
@@ -206,7 +206,7 @@ size_t PGRecovery::start_replica_recovery_ops(
     for (auto p = pm.get_rmissing().begin();
 	 p != pm.get_rmissing().end() && started < max_to_start;
 	 ++p) {
-      const auto &soid = p->second;
+      const hobject_t &soid = p->second;
 
       if (pg->get_peering_state().get_missing_loc().is_unfound(soid)) {
 	logger().debug("{}: object {} still unfound", __func__, soid);
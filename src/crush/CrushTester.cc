@@ -10,6 +10,7 @@
 #include <boost/algorithm/string/join.hpp>
 
 #include "common/SubProcess.h"
+#include "common/ceph_time.h"
 #include "common/fork_function.h"
 
 #include "include/stringify.h"
@@ -549,6 +550,9 @@ int CrushTester::test(CephContext* cct)
       for (unsigned i = 0; i < num_devices; i++)
         num_objects_expected[i] = (proportional_weights[i]*expected_objects);
 
+      // time spent in do_rule() only, for --show-mapping-rate
+      ceph::timespan mapping_time = ceph::timespan::zero();
+
       for (int current_batch = 0; current_batch < num_batches; current_batch++) {
         if (current_batch == (num_batches - 1)) {
           batch_max = max_x;
@@ -575,7 +579,13 @@ int CrushTester::test(CephContext* cct)
             if (pool_id != -1) {
               real_x = crush_hash32_2(CRUSH_HASH_RJENKINS1, x, (uint32_t)pool_id);
             }
-            crush.do_rule(r, real_x, out, nr, weight, 0);
+            if (output_mapping_rate) {
+              auto start = ceph::mono_clock::now();
+              crush.do_rule(r, real_x, out, nr, weight, 0);
+              mapping_time += ceph::mono_clock::now() - start;
+            } else {
+              crush.do_rule(r, real_x, out, nr, weight, 0);
+            }
           } else {
             if (output_mappings)
 	      err << "RNG"; // prepend RNG to placement output to denote simulation
@@ -612,6 +622,13 @@ int CrushTester::test(CephContext* cct)
         batch_max = batch_min + objects_per_batch - 1;
       }
 
+      if (output_mapping_rate && use_crush) {
+        double secs = std::chrono::duration<double>(mapping_time).count();
+        err << "rule " << r << " (" << crush.get_rule_name(r) << ") num_rep " << nr
+            << " mapped " << num_objects << " inputs in " << secs << "s: "
+            << (secs > 0 ? num_objects / secs : 0) << " mappings/s" << std::endl;
+      }
+
       for (unsigned i = 0; i < per.size(); i++)
         if (output_utilization && !output_statistics)
           err << "  device " << i
@@ -1,6 +1,7 @@
 #ifdef __KERNEL__
 # include <linux/crush/hash.h>
 #else
+# include <string.h>
 # include "hash.h"
 #endif
 
@@ -120,6 +121,55 @@ __u32 crush_hash32_3(int type, __u32 a, __u32 b, __u32 c)
 	}
 }
 
+#if !defined(__KERNEL__) && defined(__GNUC__)
+/*
+ * Eight lanes of crush_hash32_rjenkins1_3() with the same a and c.  The
+ * generic vector type lowers to whatever the target has (SSE2, AVX2,
+ * NEON, or plain scalar code) and gives bit-identical results.
+ */
+typedef __u32 crush_u32x8 __attribute__((vector_size(32)));
+
+static inline void crush_hash32_rjenkins1_3_x8(__u32 a, const __s32 *pb,
+					       __u32 c, __u32 *out)
+{
+	const crush_u32x8 zero = {0};
+	crush_u32x8 b, hash;
+	memcpy(&b, pb, sizeof(b));
+	hash = (zero + (crush_hash_seed ^ a ^ c)) ^ b;
+	crush_u32x8 va = zero + a;
+	crush_u32x8 vc = zero + c;
+	crush_u32x8 x = zero + 231232;
+	crush_u32x8 y = zero + 1232;
+	crush_hashmix(va, b, hash);
+	crush_hashmix(vc, x, hash);
+	crush_hashmix(y, va, hash);
+	crush_hashmix(b, x, hash);
+	crush_hashmix(y, vc, hash);
+	memcpy(out, &hash, sizeof(hash));
+}
+#endif
+
+void crush_hash32_3_vec(int type, __u32 a, const __s32 *b, __u32 c,
+			__u32 *out, unsigned int n)
+{
+	unsigned int i = 0;
+
+	switch (type) {
+	case CRUSH_HASH_RJENKINS1:
+#if !defined(__KERNEL__) && defined(__GNUC__)
+		for (; i + 8 <= n; i += 8)
+			crush_hash32_rjenkins1_3_x8(a, b + i, c, out + i);
+#endif
+		for (; i < n; i++)
+			out[i] = crush_hash32_rjenkins1_3(a, b[i], c);
+		break;
+	default:
+		for (; i < n; i++)
+			out[i] = 0;
+		break;
+	}
+}
+
 __u32 crush_hash32_4(int type, __u32 a, __u32 b, __u32 c, __u32 d)
 {
 	switch (type) {
@@ -267,6 +267,60 @@ int ErasureCode::decode(const set<int> &want_to_read,
   return _decode(want_to_read, chunks, decoded);
 }
 
+int ErasureCode::encode_stripes(const set<int> &want_to_encode,
+                                unsigned stripe_count,
+                                map<int, bufferlist> *encoded)
+{
+  ceph_assert(stripe_count > 0);
+  ceph_assert(!encoded->empty());
+  unsigned length = encoded->begin()->second.length();
+  ceph_assert(length % stripe_count == 0);
+  unsigned blocksize = length / stripe_count;
+  for (auto &[i, chunk] : *encoded) {
+    ceph_assert(chunk.length() == length);
+    // every stripe must be contiguous for encode_chunks to write
+    // through to the batch buffers
+    chunk.rebuild_aligned_size_and_memory(blocksize, SIMD_ALIGN);
+  }
+  if (stripe_count == 1)
+    return encode_chunks(want_to_encode, encoded);
+  for (unsigned s = 0; s < stripe_count; s++) {
+    map<int, bufferlist> stripe;
+    for (auto &[i, chunk] : *encoded)
+      stripe[i].substr_of(chunk, s * blocksize, blocksize);
+    int r = encode_chunks(want_to_encode, &stripe);
+    if (r)
+      return r;
+  }
+  return 0;
+}
+
+int ErasureCode::decode_stripes(const set<int> &want_to_read,
+                                const map<int, bufferlist> &chunks,
+                                map<int, bufferlist> *decoded,
+                                unsigned stripe_count)
+{
+  ceph_assert(stripe_count > 0);
+  ceph_assert(!chunks.empty());
+  unsigned length = chunks.begin()->second.length();
+  ceph_assert(length % stripe_count == 0);
+  unsigned blocksize = length / stripe_count;
+  if (stripe_count == 1)
+    return decode(want_to_read, chunks, decoded, blocksize);
+  for (unsigned s = 0; s < stripe_count; s++) {
+    map<int, bufferlist> stripe;
+    for (auto &[i, chunk] : chunks)
+      stripe[i].substr_of(chunk, s * blocksize, blocksize);
+    map<int, bufferlist> out;
+    int r = decode(want_to_read, stripe, &out, blocksize);
+    if (r)
+      return r;
+    for (auto i : want_to_read)
+      (*decoded)[i].claim_append(out[i]);
+  }
+  return 0;
+}
+
 int ErasureCode::parse(const ErasureCodeProfile &profile,
 		       ostream *ss)
 {
@@ -89,6 +89,15 @@ namespace ceph {
 			const std::map<int, bufferlist> &chunks,
 			std::map<int, bufferlist> *decoded);
 
+    int encode_stripes(const std::set<int> &want_to_encode,
+                       unsigned stripe_count,
+                       std::map<int, bufferlist> *encoded) override;
+
+    int decode_stripes(const std::set<int> &want_to_read,
+                       const std::map<int, bufferlist> &chunks,
+                       std::map<int, bufferlist> *decoded,
+                       unsigned stripe_count) override;
+
     const std::vector<int> &get_chunk_mapping() const override;
 
     int to_mapping(const ErasureCodeProfile &profile,
@@ -412,6 +412,45 @@ namespace ceph {
                               const std::map<int, bufferlist> &chunks,
                               std::map<int, bufferlist> *decoded) = 0;
 
+    /**
+     * Same as **encode_chunks** for **stripe_count** stripes at
+     * once. Each buffer in **encoded** holds one chunk of every
+     * stripe, back to back: the data chunks are filled in and the
+     * coding chunks are computed in place. Plugins whose coding
+     * does not depend on where a stripe starts in the buffer do
+     * it in a single pass instead of one call per stripe.
+     *
+     * Returns 0 on success.
+     *
+     * @param [in] want_to_encode chunk indexes to be encoded
+     * @param [in] stripe_count number of stripes in each buffer
+     * @param [in,out] encoded map chunk indexes to chunk data
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int encode_stripes(const std::set<int> &want_to_encode,
+                               unsigned stripe_count,
+                               std::map<int, bufferlist> *encoded) = 0;
+
+    /**
+     * Same as **decode** for **stripe_count** stripes at once. The
+     * buffers in **chunks** hold one chunk of every stripe, back to
+     * back, and so will the buffers in **decoded**. The decoding
+     * tables are looked up once for the whole batch rather than
+     * once per stripe.
+     *
+     * Returns 0 on success.
+     *
+     * @param [in] want_to_read chunk indexes to be decoded
+     * @param [in] chunks map chunk indexes to chunk data
+     * @param [out] decoded map chunk indexes to chunk data
+     * @param [in] stripe_count number of stripes in each buffer
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int decode_stripes(const std::set<int> &want_to_read,
+                               const std::map<int, bufferlist> &chunks,
+                               std::map<int, bufferlist> *decoded,
+                               unsigned stripe_count) = 0;
+
     /**
      * Return the ordered list of chunks or an empty vector
      * if no remapping is necessary.
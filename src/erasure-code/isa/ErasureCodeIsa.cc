@@ -116,6 +116,35 @@ int ErasureCodeIsa::decode_chunks(const set<int> &want_to_read,
 
 // -----------------------------------------------------------------------------
 
+// Reed-Solomon over GF(2^8) codes every byte offset on its own, so a
+// batch of stripes laid out chunk after chunk is encoded and decoded
+// as one big stripe: one pass through ec_encode_data and a single
+// decoding table lookup in tcache for all of them.
+
+int ErasureCodeIsa::encode_stripes(const set<int> &want_to_encode,
+                                   unsigned stripe_count,
+                                   map<int, bufferlist> *encoded)
+{
+  ceph_assert(stripe_count > 0);
+  ceph_assert(encoded->begin()->second.length() % stripe_count == 0);
+  for (auto &[i, chunk] : *encoded)
+    chunk.rebuild_aligned(SIMD_ALIGN);
+  return encode_chunks(want_to_encode, encoded);
+}
+
+int ErasureCodeIsa::decode_stripes(const set<int> &want_to_read,
+                                   const map<int, bufferlist> &chunks,
+                                   map<int, bufferlist> *decoded,
+                                   unsigned stripe_count)
+{
+  ceph_assert(stripe_count > 0);
+  unsigned length = chunks.begin()->second.length();
+  ceph_assert(length % stripe_count == 0);
+  return decode(want_to_read, chunks, decoded, length);
+}
+
+// -----------------------------------------------------------------------------
+
 void
 ErasureCodeIsaDefault::isa_encode(char **data,
                                   char **coding,
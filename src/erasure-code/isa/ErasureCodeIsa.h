@@ -80,6 +80,15 @@ public:
                             const std::map<int, ceph::buffer::list> &chunks,
                             std::map<int, ceph::buffer::list> *decoded) override;
 
+  int encode_stripes(const std::set<int> &want_to_encode,
+                     unsigned stripe_count,
+                     std::map<int, ceph::buffer::list> *encoded) override;
+
+  int decode_stripes(const std::set<int> &want_to_read,
+                     const std::map<int, ceph::buffer::list> &chunks,
+                     std::map<int, ceph::buffer::list> *decoded,
+                     unsigned stripe_count) override;
+
   int init(ceph::ErasureCodeProfile &profile, std::ostream *ss) override;
 
   virtual void isa_encode(char **data,
@@ -137,6 +137,32 @@ int ErasureCodeJerasure::decode_chunks(const set<int> &want_to_read,
   return jerasure_decode(erasures, data, coding, blocksize);
 }
 
+// All the techniques code the chunk in independent blocks (a word
+// for the matrix ones, w packets for the bitmatrix ones) and the
+// chunk size is a multiple of those blocks: a batch of stripes laid
+// out chunk after chunk is coded exactly as if it was one stripe.
+int ErasureCodeJerasure::encode_stripes(const set<int> &want_to_encode,
+					unsigned stripe_count,
+					map<int, bufferlist> *encoded)
+{
+  ceph_assert(stripe_count > 0);
+  ceph_assert(encoded->begin()->second.length() % stripe_count == 0);
+  for (auto &[i, chunk] : *encoded)
+    chunk.rebuild_aligned(SIMD_ALIGN);
+  return encode_chunks(want_to_encode, encoded);
+}
+
+int ErasureCodeJerasure::decode_stripes(const set<int> &want_to_read,
+					const map<int, bufferlist> &chunks,
+					map<int, bufferlist> *decoded,
+					unsigned stripe_count)
+{
+  ceph_assert(stripe_count > 0);
+  unsigned length = chunks.begin()->second.length();
+  ceph_assert(length % stripe_count == 0);
+  return decode(want_to_read, chunks, decoded, length);
+}
+
 bool ErasureCodeJerasure::is_prime(int value)
 {
   int prime55[] = {
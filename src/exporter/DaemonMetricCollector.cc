@@ -202,6 +202,26 @@ void DaemonMetricCollector::dump_asok_metrics() {
     get_process_metrics(daemon_pids);
   }
   metrics = builder->dump();
+  if (g_conf().get_val<bool>("exporter_mgr_metrics")) {
+    metrics += dump_mgr_metrics();
+  }
+}
+
+std::string DaemonMetricCollector::dump_mgr_metrics() {
+  for (auto &[daemon_name, sock_client] : mgr_clients) {
+    bool ok;
+    sock_client.ping(&ok);
+    if (!ok) {
+      continue;
+    }
+    // standbys do not have the command
+    std::string response =
+      asok_request(sock_client, "dump_cluster_metrics", daemon_name);
+    if (response.size() != 0) {
+      return response;
+    }
+  }
+  return "";
 }
 
 std::vector<std::string> read_proc_stat_file(std::string path) {
@@ -375,6 +395,7 @@ void DaemonMetricCollector::dump_asok_metric(json_object perf_info,
 void DaemonMetricCollector::update_sockets() {
   std::string sock_dir = g_conf().get_val<std::string>("exporter_sock_dir");
   clients.clear();
+  mgr_clients.clear();
   std::filesystem::path sock_path = sock_dir;
   if (!std::filesystem::is_directory(sock_path.parent_path())) {
     dout(1) << "ERROR: No such directory exist" << sock_dir << dendl;
@@ -385,8 +406,12 @@ void DaemonMetricCollector::update_sockets() {
       std::string daemon_socket_name = entry.path().filename().string();
       std::string daemon_name =
           daemon_socket_name.substr(0, daemon_socket_name.size() - 5);
+      if (daemon_name.find("mgr") != std::string::npos) {
+        mgr_clients.emplace(daemon_name,
+                            AdminSocketClient(entry.path().string()));
+        continue;
+      }
       if (clients.find(daemon_name) == clients.end() &&
-          !(daemon_name.find("mgr") != std::string::npos) &&
           !(daemon_name.find("ceph-exporter") != std::string::npos)) {
         AdminSocketClient sock(entry.path().string());
         clients.insert({daemon_name, std::move(sock)});
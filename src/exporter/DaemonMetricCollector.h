@@ -38,6 +38,9 @@ public:
 
 private:
   std::map<std::string, AdminSocketClient> clients;
+  // their perf counters are exported by the prometheus module, but the
+  // active one serves the cluster wide metrics with exporter_mgr_metrics
+  std::map<std::string, AdminSocketClient> mgr_clients;
   std::string metrics;
   std::mutex metrics_mutex;
   std::unique_ptr<MetricsBuilder> builder;
@@ -50,6 +53,7 @@ private:
                         labels_t labels);
   std::pair<labels_t, std::string> add_fixed_name_metrics(std::string metric_name);
   void get_process_metrics(std::vector<std::pair<std::string, int>> daemon_pids);
+  std::string dump_mgr_metrics();
   std::string asok_request(AdminSocketClient &asok, std::string command, std::string daemon_name);
 };
 
@@ -118,6 +118,9 @@ struct error_code;
   int get_missed_crc();
   /// enable/disable tracking of cached crcs
   void track_cached_crc(bool b);
+  /// count of small raw buffers allocated from / missing in the thread cache
+  uint64_t get_raw_cache_hits();
+  uint64_t get_raw_cache_misses();
 
   /*
    * an abstract raw buffer.  with a reference count.
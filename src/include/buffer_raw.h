@@ -35,6 +35,8 @@ inline namespace v15_2_0 {
   protected:
     char *data;
     unsigned len;
+    /// bytes allocated beyond len, charged to the mempool along with it
+    unsigned slack = 0;
   public:
     ceph::atomic<unsigned> nref { 0 };
     int mempool;
@@ -54,14 +56,15 @@ inline namespace v15_2_0 {
     }
     virtual ~raw() {
       mempool::get_pool(mempool::pool_index_t(mempool)).adjust_count(
-	-1, -(int)len);
+	-1, -(int)(len + slack));
     }
 
     void _set_len(unsigned l) {
       mempool::get_pool(mempool::pool_index_t(mempool)).adjust_count(
-	-1, -(int)len);
+	-1, -(int)(len + slack));
       len = l;
-      mempool::get_pool(mempool::pool_index_t(mempool)).adjust_count(1, len);
+      mempool::get_pool(mempool::pool_index_t(mempool)).adjust_count(
+	1, len + slack);
     }
 
     void reassign_to_mempool(int pool) {
@@ -69,9 +72,10 @@ inline namespace v15_2_0 {
 	return;
       }
       mempool::get_pool(mempool::pool_index_t(mempool)).adjust_count(
-	-1, -(int)len);
+	-1, -(int)(len + slack));
       mempool = pool;
-      mempool::get_pool(mempool::pool_index_t(pool)).adjust_count(1, len);
+      mempool::get_pool(mempool::pool_index_t(pool)).adjust_count(
+	1, len + slack);
     }
 
     void try_assign_to_mempool(int pool) {
@@ -266,6 +266,7 @@ struct ceph_client_mount {
 } __attribute__ ((packed));
 
 #define CEPH_SUBSCRIBE_ONETIME    1  /* i want only 1 update after have */
+#define CEPH_SUBSCRIBE_SQUASH     2  /* osdmap: i can apply squashed incs */
 
 struct ceph_mon_subscribe_item {
 	__le64 start;
@@ -99,6 +99,7 @@ typedef struct Inode Inode;
 
 struct ceph_mount_info;
 struct ceph_dir_result;
+struct ceph_read_buffers;
 
 // user supplied key,value pair to be associated with a snapshot.
 // callers can supply an array of this struct via ceph_mksnap().
@@ -1935,6 +1936,36 @@ off_t ceph_ll_lseek(struct ceph_mount_info *cmount, struct Fh* filehandle,
 		     off_t offset, int whence);
 int ceph_ll_read(struct ceph_mount_info *cmount, struct Fh* filehandle,
 		 int64_t off, uint64_t len, char* buf);
+/**
+ * Read data from a file without copying it into caller memory.
+ *
+ * On success, *iov points to *iovcnt segments that hold the data read, in
+ * order.  The segments are owned by *bufs, stay valid and must not be
+ * modified until it is released with ceph_ll_release_read_buffers().
+ *
+ * @param cmount the ceph mount handle to use.
+ * @param filehandle the open file to read from.
+ * @param off the offset to read from.
+ * @param len the number of bytes to read.
+ * @param bufs filled in with a handle on the data read.
+ * @param iov filled in with the segments of the data read.
+ * @param iovcnt filled in with the number of segments.
+ * @returns the number of bytes read on success, negative error code
+ *          otherwise (in which case nothing needs to be released).
+ */
+int64_t ceph_ll_read_buffers(struct ceph_mount_info *cmount,
+			     struct Fh *filehandle, int64_t off, uint64_t len,
+			     struct ceph_read_buffers **bufs,
+			     const struct iovec **iov, int *iovcnt);
+
+/**
+ * Release the data returned by ceph_ll_read_buffers().
+ *
+ * @param cmount the ceph mount handle to use.
+ * @param bufs the handle to release.
+ */
+void ceph_ll_release_read_buffers(struct ceph_mount_info *cmount,
+				  struct ceph_read_buffers *bufs);
 int ceph_ll_fsync(struct ceph_mount_info *cmount, struct Fh *fh,
 		  int syncdataonly);
 int ceph_ll_sync_inode(struct ceph_mount_info *cmount, struct Inode *in,
@@ -1997,6 +2028,22 @@ int ceph_ll_rename(struct ceph_mount_info *cmount, struct Inode *parent,
 		   const char *newname, const UserPerm *perms);
 int ceph_ll_unlink(struct ceph_mount_info *cmount, struct Inode *in,
 		   const char *name, const UserPerm *perms);
+/**
+ * Unlink several names from a directory, keeping all of the requests to
+ * the MDS in flight at once.
+ *
+ * @param cmount the ceph mount handle to use.
+ * @param in the directory to unlink from.
+ * @param names the names to unlink.
+ * @param count the number of names.
+ * @param perms the credentials to unlink with.
+ * @param results filled in with the result of unlinking each name.
+ * @returns 0 if the requests were made (see results), negative error code
+ *          otherwise.
+ */
+int ceph_ll_unlink_batch(struct ceph_mount_info *cmount, struct Inode *in,
+			 const char * const *names, int count,
+			 const UserPerm *perms, int *results);
 int ceph_ll_statfs(struct ceph_mount_info *cmount, struct Inode *in,
 		   struct statvfs *stbuf);
 int ceph_ll_readlink(struct ceph_mount_info *cmount, struct Inode *in,
@@ -1629,6 +1629,53 @@ struct denc_traits<std::nullopt_t> {
     }									\
   };
 
+// Write denc_traits<> for a class whose in-memory representation on a
+// little endian host is its encoding: nothing but integer fields (and
+// arrays and structs of those) in the order its DENC() encodes them, and
+// no padding.  Such a class is encoded and decoded with a single copy
+// rather than field by field; big endian hosts keep using its DENC().
+
+namespace _denc {
+template<typename T>
+inline constexpr bool trivially_encodable =
+  std::endian::native == std::endian::little &&
+  std::is_trivially_copyable_v<T> &&
+  std::has_unique_object_representations_v<T>;
+}
+
+#define WRITE_CLASS_DENC_TRIVIAL(T)					\
+  template<> struct denc_traits<T> {					\
+    static_assert(_denc::trivially_encodable<T> ||			\
+		  std::endian::native != std::endian::little,		\
+		  #T " has padding or is not trivially copyable");	\
+    static constexpr bool supported = true;				\
+    static constexpr bool featured = false;				\
+    static constexpr bool bounded = true;				\
+    static constexpr bool need_contiguous = !_denc::has_legacy_denc<T>::value;\
+    static void bound_encode(const T& v, size_t& p, uint64_t f=0) {	\
+      if constexpr (_denc::trivially_encodable<T>) {			\
+	p += sizeof(T);							\
+      } else {								\
+	v.bound_encode(p);						\
+      }									\
+    }									\
+    static void encode(const T& v, ::ceph::buffer::list::contiguous_appender& p, \
+		       uint64_t f=0) {					\
+      if constexpr (_denc::trivially_encodable<T>) {			\
+	::memcpy(p.get_pos_add(sizeof(T)), &v, sizeof(T));		\
+      } else {								\
+	v.encode(p);							\
+      }									\
+    }									\
+    static void decode(T& v, ::ceph::buffer::ptr::const_iterator& p, uint64_t f=0) { \
+      if constexpr (_denc::trivially_encodable<T>) {			\
+	::memcpy(&v, p.get_pos_add(sizeof(T)), sizeof(T));		\
+      } else {								\
+	v.decode(p);							\
+      }									\
+    }									\
+  };
+
 // ----------------------------------------------------------------------
 // encoded_sizeof_wrapper
 
@@ -1406,6 +1406,38 @@ public:
       }, consigned);
   }
 
+  /// Submit many independent operations at once, sparing the per-op
+  /// submission overhead. The completion is called once all of them are
+  /// done, with the first error any of them got. If `ecs` is given, it
+  /// is resized to `ops.size()` and receives the result of each op.
+  template<boost::asio::completion_token_for<Op::Signature> CompletionToken>
+  auto execute(IOContext ioc, std::vector<std::pair<Object, ReadOp>> ops,
+	       CompletionToken&& token,
+	       std::vector<boost::system::error_code>* ecs = nullptr) {
+    auto consigned = boost::asio::consign(
+      std::forward<CompletionToken>(token), boost::asio::make_work_guard(
+	boost::asio::get_associated_executor(token, get_executor())));
+    return boost::asio::async_initiate<decltype(consigned), Op::Signature>(
+      [ioc = std::move(ioc), ops = std::move(ops), ecs,
+       this](auto&& handler) mutable {
+	execute_(std::move(ioc), std::move(ops), std::move(handler), ecs);
+      }, consigned);
+  }
+
+  template<boost::asio::completion_token_for<Op::Signature> CompletionToken>
+  auto execute(IOContext ioc, std::vector<std::pair<Object, WriteOp>> ops,
+	       CompletionToken&& token,
+	       std::vector<boost::system::error_code>* ecs = nullptr) {
+    auto consigned = boost::asio::consign(
+      std::forward<CompletionToken>(token), boost::asio::make_work_guard(
+	boost::asio::get_associated_executor(token, get_executor())));
+    return boost::asio::async_initiate<decltype(consigned), Op::Signature>(
+      [ioc = std::move(ioc), ops = std::move(ops), ecs,
+       this](auto&& handler) mutable {
+	execute_(std::move(ioc), std::move(ops), std::move(handler), ecs);
+      }, consigned);
+  }
+
   boost::uuids::uuid get_fsid() const noexcept;
 
   using LookupPoolSig = void(boost::system::error_code,
@@ -1813,6 +1845,12 @@ private:
 		Op::Completion c, uint64_t* objver,
 		const blkin_trace_info* trace_info);
 
+  void execute_(IOContext ioc, std::vector<std::pair<Object, ReadOp>> ops,
+		Op::Completion c, std::vector<boost::system::error_code>* ecs);
+
+  void execute_(IOContext ioc, std::vector<std::pair<Object, WriteOp>> ops,
+		Op::Completion c, std::vector<boost::system::error_code>* ecs);
+
   void lookup_pool_(std::string name, LookupPoolComp c);
   void list_pools_(LSPoolsComp c);
   void create_pool_snap_(int64_t pool, std::string snap_name,
@@ -364,6 +364,16 @@ public:
     return -EOPNOTSUPP;
   }
 
+  /// cumulative block cache lookups that hit / missed
+  virtual int get_cache_lookups(uint64_t* hits, uint64_t* misses) const {
+    return -EOPNOTSUPP;
+  }
+
+  virtual int get_cache_lookups(std::string prefix,
+				uint64_t* hits, uint64_t* misses) const {
+    return -EOPNOTSUPP;
+  }
+
   virtual std::shared_ptr<PriorityCache::PriCache> get_priority_cache() const {
     return nullptr;
   }
@@ -422,6 +432,14 @@ public:
     return -EOPNOTSUPP;
   }
 
+  /// Declare that keys of prefix sharing their first len bytes are
+  /// iterated over together (e.g. the omap of one object), so range scans
+  /// bounded within them can be served from prefix filters.  This needs to
+  /// be done BEFORE the DB is opened.
+  virtual int set_key_prefix_length(const std::string& prefix, size_t len) {
+    return -EOPNOTSUPP;
+  }
+
   virtual void get_statistics(ceph::Formatter *f) {
     return;
   }
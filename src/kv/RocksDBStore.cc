@@ -20,6 +20,7 @@
 #include "rocksdb/utilities/convenience.h"
 #include "rocksdb/utilities/table_properties_collectors.h"
 #include "rocksdb/merge_operator.h"
+#include "rocksdb/slice_transform.h"
 
 #include "common/perf_counters.h"
 #include "common/PriorityCache.h"
@@ -178,6 +179,13 @@ int RocksDBStore::set_merge_operator(
   return 0;
 }
 
+int RocksDBStore::set_key_prefix_length(const string& prefix, size_t len)
+{
+  ceph_assert(db == nullptr);
+  key_prefix_lengths[prefix] = len;
+  return 0;
+}
+
 class CephRocksdbLogger : public rocksdb::Logger {
   CephContext *cct;
 public:
@@ -926,6 +934,12 @@ int RocksDBStore::update_column_family_options(const std::string& base_name,
   if (base_name != rocksdb::kDefaultColumnFamilyName) {
     // default cf has its merge operator defined in load_rocksdb_options, should not override it
     install_cf_mergeop(base_name, cf_opt);
+    // keys of the default cf carry the kv prefix, only dedicated column
+    // families can filter on a fixed length key prefix
+    auto p = key_prefix_lengths.find(base_name);
+    if (p != key_prefix_lengths.end() && !cf_opt->prefix_extractor) {
+      cf_opt->prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(p->second));
+    }
   }
   if (!block_cache_opt.empty()) {
     r = apply_block_cache_options(base_name, block_cache_opt, cf_opt);
@@ -1246,6 +1260,7 @@ int RocksDBStore::do_open(ostream &out,
   plb.add_u64_counter(l_rocksdb_compact_range, "compact_range", "Compactions by range");
   plb.add_u64_counter(l_rocksdb_compact_queue_merge, "compact_queue_merge", "Mergings of ranges in compaction queue");
   plb.add_u64(l_rocksdb_compact_queue_len, "compact_queue_len", "Length of compaction queue");
+  plb.add_u64_counter(l_rocksdb_compact_tombstones, "compact_tombstones", "Range compactions queued on iterated tombstones");
   plb.add_time_avg(l_rocksdb_write_wal_time, "rocksdb_write_wal_time", "Rocksdb write wal time");
   plb.add_time_avg(l_rocksdb_write_memtable_time, "rocksdb_write_memtable_time", "Rocksdb write memtable time");
   plb.add_time_avg(l_rocksdb_write_delay_time, "rocksdb_write_delay_time", "Rocksdb write delay time");
@@ -2079,6 +2094,31 @@ bool RocksDBStore::check_omap_dir(string &omap_dir)
   return status.ok();
 }
 
+void RocksDBStore::note_tombstones(const string& start, const string& end,
+				   uint64_t skipped)
+{
+  if (skipped < cct->_conf->rocksdb_compact_on_tombstones_threshold) {
+    return;
+  }
+  auto now = ceph::mono_clock::now();
+  {
+    std::lock_guard l(compact_queue_lock);
+    if (now < next_tombstone_compact) {
+      dout(20) << __func__ << " " << skipped << " tombstones in "
+	       << pretty_binary_string(start) << ".."
+	       << pretty_binary_string(end) << ", throttled" << dendl;
+      return;
+    }
+    next_tombstone_compact = now + ceph::make_timespan(
+      cct->_conf->rocksdb_compact_on_tombstones_min_interval);
+  }
+  dout(10) << __func__ << " " << skipped << " tombstones in "
+	   << pretty_binary_string(start) << ".."
+	   << pretty_binary_string(end) << ", compacting" << dendl;
+  logger->inc(l_rocksdb_compact_tombstones);
+  compact_range_async(start, end);
+}
+
 void RocksDBStore::compact_range(const string& start, const string& end)
 {
   rocksdb::CompactRangeOptions options;
@@ -2252,6 +2292,72 @@ string RocksDBStore::past_prefix(const string &prefix)
   return limit;
 }
 
+/**
+ * Counts the deleted keys an iterator over a bounded range steps over,
+ * and has the range compacted once they reach
+ * rocksdb_compact_on_tombstones_threshold.  Only the iterator operations
+ * themselves are accounted for: each of them opens a Scope.
+ */
+class TombstoneTracker {
+  RocksDBStore* db = nullptr; ///< null when not tracking
+  string start, end;
+  uint64_t skipped = 0;
+public:
+  /// counts for the duration of one operation, with the thread's perf
+  /// level raised as much as that needs and restored afterwards
+  class Scope {
+    TombstoneTracker* t;
+    uint64_t base = 0;
+    rocksdb::PerfLevel prev_level = rocksdb::PerfLevel::kDisable;
+    bool raised = false;
+  public:
+    explicit Scope(TombstoneTracker* tracker)
+      : t(tracker->db ? tracker : nullptr) {
+      if (t) {
+	prev_level = rocksdb::GetPerfLevel();
+	if (prev_level < rocksdb::PerfLevel::kEnableCount) {
+	  rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+	  raised = true;
+	}
+	base = rocksdb::get_perf_context()->internal_delete_skipped_count;
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+      if (t) {
+	uint64_t now = rocksdb::get_perf_context()->internal_delete_skipped_count;
+	// the perf context may have been reset in between
+	if (now > base) {
+	  t->skipped += now - base;
+	}
+	if (raised) {
+	  rocksdb::SetPerfLevel(std::max(prev_level, rocksdb::PerfLevel::kDisable));
+	}
+      }
+    }
+  };
+
+  TombstoneTracker(RocksDBStore* db, const string& prefix,
+		   const KeyValueDB::IteratorBounds& bounds) {
+    if (db->cct->_conf->rocksdb_compact_on_tombstones_threshold == 0 ||
+	!bounds.lower_bound || !bounds.upper_bound) {
+      return;
+    }
+    this->db = db;
+    start = RocksDBStore::combine_strings(prefix, *bounds.lower_bound);
+    end = RocksDBStore::combine_strings(prefix, *bounds.upper_bound);
+  }
+  ~TombstoneTracker() {
+    if (db) {
+      db->note_tombstones(start, end, skipped);
+    }
+  }
+  Scope scope() {
+    return Scope(this);
+  }
+};
+
 class CFIteratorImpl : public KeyValueDB::IteratorImpl {
 protected:
   string prefix;
@@ -2259,16 +2365,19 @@ protected:
   const KeyValueDB::IteratorBounds bounds;
   const rocksdb::Slice iterate_lower_bound;
   const rocksdb::Slice iterate_upper_bound;
+  TombstoneTracker tombstones;
 public:
-  explicit CFIteratorImpl(const RocksDBStore* db,
+  explicit CFIteratorImpl(RocksDBStore* db,
                           const std::string& p,
                           rocksdb::ColumnFamilyHandle* cf,
                           KeyValueDB::IteratorBounds bounds_)
     : prefix(p), bounds(std::move(bounds_)),
       iterate_lower_bound(make_slice(bounds.lower_bound)),
-      iterate_upper_bound(make_slice(bounds.upper_bound))
+      iterate_upper_bound(make_slice(bounds.upper_bound)),
+      tombstones(db, prefix, bounds)
       {
       auto options = rocksdb::ReadOptions();
+      options.total_order_seek = true;
       if (db->cct->_conf->osd_rocksdb_iterator_bounds_enabled) {
         if (bounds.lower_bound) {
           options.iterate_lower_bound = &iterate_lower_bound;
@@ -2276,6 +2385,12 @@ public:
         if (bounds.upper_bound) {
           options.iterate_upper_bound = &iterate_upper_bound;
         }
+#if (ROCKSDB_MAJOR >= 7 || (ROCKSDB_MAJOR == 6 && ROCKSDB_MINOR >= 22))
+        if (bounds.lower_bound && bounds.upper_bound) {
+          // use the prefix filters when both bounds share a prefix
+          options.auto_prefix_mode = true;
+        }
+#endif
       }
       dbiter = db->db->NewIterator(options, cf);
   }
@@ -2284,10 +2399,12 @@ public:
   }
 
   int seek_to_first() override {
+    auto s = tombstones.scope();
     dbiter->SeekToFirst();
     return dbiter->status().ok() ? 0 : -1;
   }
   int seek_to_last() override {
+    auto s = tombstones.scope();
     dbiter->SeekToLast();
     return dbiter->status().ok() ? 0 : -1;
   }
@@ -2299,17 +2416,20 @@ public:
     return dbiter->status().ok() ? 0 : -1;
   }
   int lower_bound(const string &to) override {
+    auto s = tombstones.scope();
     rocksdb::Slice slice_bound(to);
     dbiter->Seek(slice_bound);
     return dbiter->status().ok() ? 0 : -1;
   }
   int next() override {
+    auto s = tombstones.scope();
     if (valid()) {
       dbiter->Next();
     }
     return dbiter->status().ok() ? 0 : -1;
   }
   int prev() override {
+    auto s = tombstones.scope();
     if (valid()) {
       dbiter->Prev();
     }
@@ -2814,17 +2934,20 @@ private:
   const rocksdb::Slice iterate_lower_bound;
   const rocksdb::Slice iterate_upper_bound;
   std::vector<rocksdb::Iterator*> iters;
+  TombstoneTracker tombstones;
 public:
-  explicit ShardMergeIteratorImpl(const RocksDBStore* db,
+  explicit ShardMergeIteratorImpl(RocksDBStore* db,
 				  const std::string& prefix,
 				  const std::vector<rocksdb::ColumnFamilyHandle*>& shards,
                   KeyValueDB::IteratorBounds bounds_)
     : db(db), keyless(db->comparator), prefix(prefix), bounds(std::move(bounds_)),
       iterate_lower_bound(make_slice(bounds.lower_bound)),
-      iterate_upper_bound(make_slice(bounds.upper_bound))
+      iterate_upper_bound(make_slice(bounds.upper_bound)),
+      tombstones(db, prefix, bounds)
   {
     iters.reserve(shards.size());
     auto options = rocksdb::ReadOptions();
+    options.total_order_seek = true;
     if (db->cct->_conf->osd_rocksdb_iterator_bounds_enabled) {
       if (bounds.lower_bound) {
         options.iterate_lower_bound = &iterate_lower_bound;
@@ -2832,6 +2955,11 @@ public:
       if (bounds.upper_bound) {
         options.iterate_upper_bound = &iterate_upper_bound;
       }
+#if (ROCKSDB_MAJOR >= 7 || (ROCKSDB_MAJOR == 6 && ROCKSDB_MINOR >= 22))
+      if (bounds.lower_bound && bounds.upper_bound) {
+        options.auto_prefix_mode = true;
+      }
+#endif
     }
     for (auto& s : shards) {
       iters.push_back(db->db->NewIterator(options, s));
@@ -2843,6 +2971,7 @@ public:
     }
   }
   int seek_to_first() override {
+    auto s = tombstones.scope();
     for (auto& it : iters) {
       it->SeekToFirst();
       if (!it->status().ok()) {
@@ -2854,6 +2983,7 @@ public:
     return 0;
   }
   int seek_to_last() override {
+    auto s = tombstones.scope();
     for (auto& it : iters) {
       it->SeekToLast();
       if (!it->status().ok()) {
@@ -2883,6 +3013,7 @@ public:
     return 0;
   }
   int upper_bound(const string &after) override {
+    auto s = tombstones.scope();
     rocksdb::Slice slice_bound(after);
     for (auto& it : iters) {
       it->Seek(slice_bound);
@@ -2897,6 +3028,7 @@ public:
     return 0;
   }
   int lower_bound(const string &to) override {
+    auto s = tombstones.scope();
     rocksdb::Slice slice_bound(to);
     for (auto& it : iters) {
       it->Seek(slice_bound);
@@ -2908,6 +3040,7 @@ public:
     return 0;
   }
   int next() override {
+    auto s = tombstones.scope();
     int r = -1;
     if (iters[0]->Valid()) {
       iters[0]->Next();
@@ -2938,6 +3071,7 @@ public:
   // 3. go next() on all iterators except (2)
   // 4. sort
   int prev() override {
+    auto s = tombstones.scope();
     std::vector<rocksdb::Iterator*> prev_done;
     //1
     for (auto it: iters) {
@@ -3320,6 +3454,8 @@ int RocksDBStore::reshard_cleanup(const RocksDBStore::columns_t& current_columns
 
 int RocksDBStore::reshard(const std::string& new_sharding, const RocksDBStore::resharding_ctrl* ctrl_in)
 {
+  rocksdb::ReadOptions roptions;
+  roptions.total_order_seek = true;
 
   resharding_ctrl ctrl = ctrl_in ? *ctrl_in : resharding_ctrl();
   size_t bytes_in_batch = 0;
@@ -3346,7 +3482,7 @@ int RocksDBStore::reshard(const std::string& new_sharding, const RocksDBStore::r
   {
     dout(5) << " column=" << (void*)handle << " prefix=" << fixed_prefix << dendl;
     std::unique_ptr<rocksdb::Iterator> it{
-      db->NewIterator(rocksdb::ReadOptions(), handle)};
+      db->NewIterator(roptions, handle)};
     ceph_assert(it);
 
     rocksdb::WriteBatch bat;
@@ -3360,7 +3496,7 @@ int RocksDBStore::reshard(const std::string& new_sharding, const RocksDBStore::r
 	bytes_per_iterator = 0;
 	keys_per_iterator = 0;
 	std::string raw_key_str = raw_key.ToString();
-	it.reset(db->NewIterator(rocksdb::ReadOptions(), handle));
+	it.reset(db->NewIterator(roptions, handle));
 	ceph_assert(it);
 	it->Seek(raw_key_str);
 	ceph_assert(it->Valid());
@@ -25,6 +25,7 @@
 #include "include/common_fwd.h"
 #include "common/Formatter.h"
 #include "common/Cond.h"
+#include "common/ceph_time.h"
 #include "common/ceph_context.h"
 #include "common/PriorityCache.h"
 #include "common/pretty_binary.h"
@@ -38,6 +39,7 @@ enum {
   l_rocksdb_compact_range,
   l_rocksdb_compact_queue_merge,
   l_rocksdb_compact_queue_len,
+  l_rocksdb_compact_tombstones,
   l_rocksdb_write_wal_time,
   l_rocksdb_write_memtable_time,
   l_rocksdb_write_delay_time,
@@ -89,10 +91,13 @@ class RocksDBStore : public KeyValueDB {
   std::string options_str;
 
   uint64_t cache_size = 0;
+  /// prefix -> length of the key prefixes its column families filter on
+  std::map<std::string, size_t> key_prefix_lengths;
   bool set_cache_flag = false;
   friend class ShardMergeIteratorImpl;
   friend class CFIteratorImpl;
   friend class WholeMergeIteratorImpl;
+  friend class TombstoneTracker;
   /*
    *  See RocksDB's definition of a column family(CF) and how to use it.
    *  The interfaces of KeyValueDB is extended, when a column family is created.
@@ -178,6 +183,7 @@ private:
   ceph::condition_variable compact_queue_cond;
   std::list<std::pair<std::string,std::string>> compact_queue;
   bool compact_queue_stop;
+  ceph::mono_time next_tombstone_compact;
   class CompactThread : public Thread {
     RocksDBStore *db;
   public:
@@ -193,6 +199,9 @@ private:
 
   void compact_range(const std::string& start, const std::string& end);
   void compact_range_async(const std::string& start, const std::string& end);
+  /// an iterator over [start, end) stepped over skipped deleted keys
+  void note_tombstones(const std::string& start, const std::string& end,
+		       uint64_t skipped);
   int tryInterpret(const std::string& key, const std::string& val,
 		   rocksdb::Options& opt);
 
@@ -362,6 +371,7 @@ public:
                                            const KeyValueDB::IteratorOpts opts)
       {
         rocksdb::ReadOptions options = rocksdb::ReadOptions();
+        options.total_order_seek = true;
         if (opts & ITERATOR_NOCACHE)
           options.fill_cache=false;
         dbiter = db->db->NewIterator(options, cf);
@@ -420,6 +430,7 @@ public:
   int set_merge_operator(
     const std::string& prefix,
     std::shared_ptr<KeyValueDB::MergeOperator> mop) override;
+  int set_key_prefix_length(const std::string& prefix, size_t len) override;
   std::string assoc_name; ///< Name of associative operator
 
   uint64_t get_estimated_size(std::map<std::string,uint64_t> &extra) override {
@@ -500,6 +511,32 @@ err:
     return -EINVAL;
   }
 
+  virtual int get_cache_lookups(uint64_t* hits,
+				uint64_t* misses) const override {
+    auto c = std::dynamic_pointer_cast<rocksdb_cache::ShardedCache>(
+      bbt_opts.block_cache);
+    if (!c) {
+      return -EOPNOTSUPP;
+    }
+    c->get_lookup_stats(hits, misses);
+    return 0;
+  }
+
+  virtual int get_cache_lookups(std::string prefix, uint64_t* hits,
+				uint64_t* misses) const override {
+    auto it = cf_bbt_opts.find(prefix);
+    if (it == cf_bbt_opts.end() || !it->second.block_cache) {
+      return -EINVAL;
+    }
+    auto c = std::dynamic_pointer_cast<rocksdb_cache::ShardedCache>(
+      it->second.block_cache);
+    if (!c) {
+      return -EOPNOTSUPP;
+    }
+    c->get_lookup_stats(hits, misses);
+    return 0;
+  }
+
   int set_cache_size(uint64_t s) override {
     cache_size = s;
     set_cache_flag = true;
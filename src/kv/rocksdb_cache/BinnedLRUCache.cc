@@ -244,6 +244,12 @@ void BinnedLRUCacheShard::LRU_Insert(BinnedLRUHandle* e) {
   lru_usage_ += e->charge;
 }
 
+void BinnedLRUCacheShard::get_lookup_stats(uint64_t* hits, uint64_t* misses) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  *hits += lookup_hits_;
+  *misses += lookup_misses_;
+}
+
 uint64_t BinnedLRUCacheShard::sum_bins(uint32_t start, uint32_t end) const {
   std::lock_guard<std::mutex> l(mutex_);
   auto size = age_bins.size();
@@ -314,6 +320,9 @@ rocksdb::Cache::Handle* BinnedLRUCacheShard::Lookup(const rocksdb::Slice& key, u
     }
     e->refs++;
     e->SetHit();
+    ++lookup_hits_;
+  } else {
+    ++lookup_misses_;
   }
   return reinterpret_cast<rocksdb::Cache::Handle*>(e);
 }
@@ -682,6 +691,14 @@ uint64_t BinnedLRUCache::sum_bins(uint32_t start, uint32_t end) const {
   return bytes;
 }
 
+void BinnedLRUCache::get_lookup_stats(uint64_t* hits, uint64_t* misses) const {
+  *hits = 0;
+  *misses = 0;
+  for (int s = 0; s < num_shards_; s++) {
+    shards_[s].get_lookup_stats(hits, misses);
+  }
+}
+
 uint32_t BinnedLRUCache::get_bin_count() const {
   uint32_t result = 0;
   if (num_shards_ > 0) {
@@ -244,6 +244,9 @@ class alignas(CACHE_LINE_SIZE) BinnedLRUCacheShard : public CacheShard {
   // Get the byte counts for a range of age bins
   uint64_t sum_bins(uint32_t start, uint32_t end) const;
 
+  // Get the number of lookups that found / did not find their key
+  void get_lookup_stats(uint64_t* hits, uint64_t* misses) const;
+
  private:
   CephContext *cct;
   void LRU_Remove(BinnedLRUHandle* e);
@@ -313,6 +316,10 @@ class alignas(CACHE_LINE_SIZE) BinnedLRUCacheShard : public CacheShard {
 
   // Circular buffer of byte counters for age binning
   boost::circular_buffer<std::shared_ptr<uint64_t>> age_bins;
+
+  // Lookup outcomes since the shard was created
+  uint64_t lookup_hits_ = 0;
+  uint64_t lookup_misses_ = 0;
 };
 
 class BinnedLRUCache : public ShardedCache {
@@ -350,6 +357,7 @@ class BinnedLRUCache : public ShardedCache {
   uint64_t sum_bins(uint32_t start, uint32_t end) const;
   uint32_t get_bin_count() const;
   void set_bin_count(uint32_t count);
+  void get_lookup_stats(uint64_t* hits, uint64_t* misses) const;
 
   virtual std::string get_cache_name() const {
     return "RocksDB Binned LRU Cache";
@@ -109,6 +109,7 @@ class ShardedCache : public rocksdb::Cache, public PriorityCache::PriCache {
 
   virtual uint32_t get_bin_count() const = 0;
   virtual void set_bin_count(uint32_t count) = 0;
+  virtual void get_lookup_stats(uint64_t* hits, uint64_t* misses) const = 0;
 
   // PriCache
   virtual int64_t get_cache_bytes(PriorityCache::Priority pri) const {
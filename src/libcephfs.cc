@@ -1940,6 +1940,35 @@ extern "C" int ceph_ll_read(class ceph_mount_info *cmount, Fh* filehandle,
   return r;
 }
 
+struct ceph_read_buffers {
+  bufferlist bl;
+  std::vector<iovec> iov;
+};
+
+extern "C" int64_t ceph_ll_read_buffers(class ceph_mount_info *cmount,
+					Fh *filehandle, int64_t off,
+					uint64_t len,
+					struct ceph_read_buffers **bufs,
+					const struct iovec **iov, int *iovcnt)
+{
+  auto rb = std::make_unique<ceph_read_buffers>();
+  int r = cmount->get_client()->ll_read(filehandle, off, len, &rb->bl);
+  if (r < 0)
+    return r;
+  // hand out the buffers the data was read into as they are
+  rb->bl.prepare_iov(&rb->iov);
+  *iov = rb->iov.data();
+  *iovcnt = rb->iov.size();
+  *bufs = rb.release();
+  return r;
+}
+
+extern "C" void ceph_ll_release_read_buffers(class ceph_mount_info *cmount,
+					     struct ceph_read_buffers *bufs)
+{
+  delete bufs;
+}
+
 extern "C" int ceph_ll_read_block(class ceph_mount_info *cmount,
 				  Inode *in, uint64_t blockid,
 				  char* buf, uint64_t offset,
@@ -2123,6 +2152,21 @@ extern "C" int ceph_ll_unlink(class ceph_mount_info *cmount, Inode *in,
   return cmount->get_client()->ll_unlink(in, name, *perms);
 }
 
+extern "C" int ceph_ll_unlink_batch(class ceph_mount_info *cmount, Inode *in,
+				    const char * const *names, int count,
+				    const UserPerm *perms, int *results)
+{
+  if (count < 0)
+    return -CEPHFS_EINVAL;
+  std::vector<std::string> v(names, names + count);
+  std::vector<int> r;
+  int ret = cmount->get_client()->ll_unlink_batch(in, v, *perms, &r);
+  if (ret < 0)
+    return ret;
+  std::copy(r.begin(), r.end(), results);
+  return 0;
+}
+
 extern "C" int ceph_ll_statfs(class ceph_mount_info *cmount,
 			      Inode *in, struct statvfs *stbuf)
 {
@@ -1074,12 +1074,13 @@ int libradosstriper::RadosStriperImpl::trunc(const std::string& soid, uint64_t s
   std::string lockCookie = RadosStriperImpl::getUUID();
   utime_t dur = utime_t();
   rados::cls::lock::lock(&op, RADOS_LOCK_NAME, ClsLockType::EXCLUSIVE, lockCookie, "", "", dur, 0);
-  int rc = m_ioCtx.operate(firstObjOid, &op);
-  if (rc) return rc;
-  // load layout and size
+  // and load layout and size
   ceph_file_layout layout;
   uint64_t original_size;
-  rc = internal_get_layout_and_size(firstObjOid, &layout, &original_size);
+  int rc;
+  int lrc = internal_lock_and_get_layout_and_size(firstObjOid, &op, &layout,
+						  &original_size, &rc);
+  if (lrc) return lrc;
   if (!rc) {
     if (size < original_size) {
       rc = truncate(soid, original_size, size, layout);
@@ -1304,17 +1305,50 @@ int libradosstriper::RadosStriperImpl::extract_sizet_attr
   return 0;
 }
 
-int libradosstriper::RadosStriperImpl::internal_get_layout_and_size(
+int libradosstriper::RadosStriperImpl::internal_lock_and_get_layout_and_size(
   const std::string& oid,
+  librados::ObjectWriteOperation *lockOp,
   ceph_file_layout *layout,
-  uint64_t *size)
+  uint64_t *size,
+  int *layoutRc)
 {
-  // get external attributes of the first rados object
+  librados::AioCompletion *lock_completion =
+    librados::Rados::aio_create_completion();
+  int rc = m_ioCtx.aio_operate(oid, lock_completion, lockOp);
+  if (rc) {
+    lock_completion->release();
+    return rc;
+  }
+  // ops on a given object are executed in order, so the attributes
+  // are read with the lock held, as if we had waited for it
   std::map<std::string, bufferlist> attrs;
-  int rc = m_ioCtx.getxattrs(oid, attrs);
-  if (rc) return rc;
+  int attrs_rval = 0;
+  librados::ObjectReadOperation attrs_op;
+  attrs_op.getxattrs(&attrs, &attrs_rval);
+  librados::AioCompletion *attrs_completion =
+    librados::Rados::aio_create_completion();
+  *layoutRc = m_ioCtx.aio_operate(oid, attrs_completion, &attrs_op, nullptr);
+  lock_completion->wait_for_complete();
+  rc = lock_completion->get_return_value();
+  lock_completion->release();
+  if (*layoutRc == 0) {
+    attrs_completion->wait_for_complete();
+    *layoutRc = attrs_completion->get_return_value();
+  }
+  attrs_completion->release();
+  if (rc == 0 && *layoutRc == 0) {
+    *layoutRc = extract_layout_and_size(attrs, layout, size);
+  }
+  return rc;
+}
+
+int libradosstriper::RadosStriperImpl::extract_layout_and_size(
+  std::map<std::string, bufferlist> &attrs,
+  ceph_file_layout *layout,
+  uint64_t *size)
+{
   // deal with stripe_unit
-  rc = extract_uint32_attr(attrs, XATTR_LAYOUT_STRIPE_UNIT, &layout->fl_stripe_unit);
+  int rc = extract_uint32_attr(attrs, XATTR_LAYOUT_STRIPE_UNIT, &layout->fl_stripe_unit);
   if (rc) return rc;
   // deal with stripe_count
   rc = extract_uint32_attr(attrs, XATTR_LAYOUT_STRIPE_COUNT, &layout->fl_stripe_count);
@@ -1348,12 +1382,13 @@ int libradosstriper::RadosStriperImpl::openStripedObjectForRead(
   utime_t dur = utime_t();
   rados::cls::lock::lock(&op, RADOS_LOCK_NAME, ClsLockType::SHARED, *lockCookie, "Tag", "", dur, 0);
   std::string firstObjOid = getObjectId(soid, 0);
-  int rc = m_ioCtx.operate(firstObjOid, &op);
-  if (rc) {
+  int rc;
+  int lrc = internal_lock_and_get_layout_and_size(firstObjOid, &op, layout,
+						  size, &rc);
+  if (lrc) {
     // error case (including -ENOENT)
-    return rc;
+    return lrc;
   }
-  rc = internal_get_layout_and_size(firstObjOid, layout, size);
   if (rc) {
     unlockObject(soid, *lockCookie);
     lderr(cct()) << "RadosStriperImpl::openStripedObjectForRead : "
@@ -1377,7 +1412,10 @@ int libradosstriper::RadosStriperImpl::openStripedObjectForWrite(const std::stri
   utime_t dur = utime_t();
   rados::cls::lock::lock(&op, RADOS_LOCK_NAME, ClsLockType::SHARED, *lockCookie, "Tag", "", dur, 0);
   std::string firstObjOid = getObjectId(soid, 0);
-  int rc = m_ioCtx.operate(firstObjOid, &op);
+  uint64_t curSize;
+  int layoutRc;
+  int rc = internal_lock_and_get_layout_and_size(firstObjOid, &op, layout,
+						 &curSize, &layoutRc);
   if (rc) {
     if (rc == -ENOENT) {
       // object does not exist, delegate to createEmptyStripedObject
@@ -1390,8 +1428,7 @@ int libradosstriper::RadosStriperImpl::openStripedObjectForWrite(const std::stri
     }
   }
   // all fine
-  uint64_t curSize;
-  rc = internal_get_layout_and_size(firstObjOid, layout, &curSize);
+  rc = layoutRc;
   if (rc) {
     unlockObject(soid, *lockCookie);
     lderr(cct()) << "RadosStriperImpl::openStripedObjectForWrite : "
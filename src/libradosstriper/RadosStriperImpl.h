@@ -168,9 +168,21 @@ struct RadosStriperImpl {
 			 const std::string& key,
 			 size_t *value);
 
-  int internal_get_layout_and_size(const std::string& oid,
-				   ceph_file_layout *layout,
-				   uint64_t *size);
+  /**
+   * executes lockOp on the given object and reads its layout and size
+   * right behind it, saving a round trip compared to doing both in turn.
+   * Returns the return code of lockOp; the one of the layout and size
+   * loading goes in layoutRc and is only meaningful if lockOp succeeded
+   */
+  int internal_lock_and_get_layout_and_size(const std::string& oid,
+					    librados::ObjectWriteOperation *lockOp,
+					    ceph_file_layout *layout,
+					    uint64_t *size,
+					    int *layoutRc);
+
+  int extract_layout_and_size(std::map<std::string, bufferlist> &attrs,
+			      ceph_file_layout *layout,
+			      uint64_t *size);
 
   int internal_aio_remove(const std::string& soid,
 			  MultiAioCompletionImplPtr multi_completion,
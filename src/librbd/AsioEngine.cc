@@ -20,11 +20,17 @@ AsioEngine::AsioEngine(std::shared_ptr<librados::Rados> rados)
       neorados::RADOS::make_with_librados(*rados))),
     m_cct(m_rados_api->cct()),
     m_io_context(m_rados_api->get_io_context()),
-    m_api_strand(std::make_unique<boost::asio::strand<executor_type>>(
-      boost::asio::make_strand(m_io_context))),
     m_context_wq(std::make_unique<asio::ContextWQ>(m_cct, m_io_context)) {
   ldout(m_cct, 20) << dendl;
 
+  auto api_strands = std::max<uint64_t>(
+    m_cct->_conf.get_val<uint64_t>("rbd_api_strands"), 1);
+  for (uint64_t i = 0; i < api_strands; ++i) {
+    m_api_strands.push_back(
+      std::make_unique<boost::asio::strand<executor_type>>(
+        boost::asio::make_strand(m_io_context)));
+  }
+
   auto rados_threads = m_cct->_conf.get_val<uint64_t>("librados_thread_count");
   auto rbd_threads = m_cct->_conf.get_val<uint64_t>("rbd_op_threads");
   if (rbd_threads > rados_threads) {
@@ -42,7 +48,7 @@ AsioEngine::AsioEngine(librados::IoCtx& io_ctx)
 
 AsioEngine::~AsioEngine() {
   ldout(m_cct, 20) << dendl;
-  m_api_strand.reset();
+  m_api_strands.clear();
 }
 
 void AsioEngine::dispatch(Context* ctx, int r) {
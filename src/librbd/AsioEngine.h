@@ -7,6 +7,7 @@
 #include "include/common_fwd.h"
 #include "include/rados/librados_fwd.hpp"
 #include <memory>
+#include <vector>
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
@@ -47,7 +48,13 @@ public:
 
   inline boost::asio::strand<executor_type>& get_api_strand() {
     // API client callbacks should never fire concurrently
-    return *m_api_strand;
+    return *m_api_strands.front();
+  }
+  inline boost::asio::strand<executor_type>& get_api_strand(const void* key) {
+    // unless more than one strand was configured, in which case only
+    // the callbacks of the same key are serialized
+    auto i = (reinterpret_cast<uintptr_t>(key) >> 4) % m_api_strands.size();
+    return *m_api_strands[i];
   }
 
   inline asio::ContextWQ* get_work_queue() {
@@ -71,7 +78,7 @@ private:
   CephContext* m_cct;
 
   boost::asio::io_context& m_io_context;
-  std::unique_ptr<boost::asio::strand<executor_type>> m_api_strand;
+  std::vector<std::unique_ptr<boost::asio::strand<executor_type>>> m_api_strands;
   std::unique_ptr<asio::ContextWQ> m_context_wq;
 };
 
@@ -49,7 +49,18 @@ struct DiffContext {
     : callback(callback), callback_arg(callback_arg),
       whole_object(_whole_object), include_parent(_include_parent),
       from_snap_id(_from_snap_id), end_snap_id(_end_snap_id),
-      throttle(image_ctx.config.template get_val<uint64_t>("rbd_concurrent_management_ops"), true) {
+      throttle(get_max_concurrent_ops(image_ctx), true) {
+  }
+
+  template <typename I>
+  static uint64_t get_max_concurrent_ops(I &image_ctx) {
+    auto ops = image_ctx.config.template get_val<uint64_t>(
+      "rbd_diff_iterate_max_concurrent_ops");
+    if (ops == 0) {
+      ops = image_ctx.config.template get_val<uint64_t>(
+        "rbd_concurrent_management_ops");
+    }
+    return ops;
   }
 };
 
@@ -374,10 +385,39 @@ int DiffIterate<I>::execute() {
   uint64_t off = m_offset;
   uint64_t left = m_length;
 
+  // without fancy striping each period is backed by exactly one object, so
+  // runs of objects that the object map reports as unchanged can be skipped
+  // without mapping them to extents one at a time
+  const bool skip_unchanged = fast_diff_enabled &&
+    m_image_ctx.get_stripe_count() == 1 &&
+    (from_snap_id != 0 || parent_diff.empty());
+
   while (left > 0) {
     uint64_t period_off = round_down_to(off, period);
     uint64_t read_len = std::min(period_off + period - off, left);
 
+    if (skip_unchanged) {
+      uint64_t object_no = period_off / period;
+      uint64_t skip_len = 0;
+      while (object_no < end_object_no && skip_len < left) {
+        uint8_t diff_state = object_diff_state[object_no - start_object_no];
+        if (diff_state != object_map::DIFF_STATE_HOLE &&
+            diff_state != object_map::DIFF_STATE_DATA) {
+          break;
+        }
+        skip_len = std::min(period_off + period - off, left);
+        period_off += period;
+        ++object_no;
+      }
+      if (skip_len > 0) {
+        ldout(cct, 20) << "skipping unchanged extent " << off << "~"
+                       << skip_len << dendl;
+        left -= skip_len;
+        off += skip_len;
+        continue;
+      }
+    }
+
     if (fast_diff_enabled) {
       // map to extents
       std::map<object_t,std::vector<ObjectExtent> > object_extents;
@@ -508,6 +508,11 @@ void AbstractWriteLog<I>::pwl_init(Context *on_finish, DeferredContexts &later)
   ldout(cct,5) << "pwl_size: " << m_cache_state->size << dendl;
   ldout(cct,5) << "pwl_path: " << m_cache_state->path << dendl;
 
+  m_max_flush_ops_in_flight = m_image_ctx.config.template get_val<uint64_t>(
+      "rbd_persistent_cache_writeback_max_ops");
+  m_max_flush_bytes_in_flight = m_image_ctx.config.template get_val<Option::size_t>(
+      "rbd_persistent_cache_writeback_max_bytes");
+
   m_log_pool_name = m_cache_state->path;
   m_log_pool_size = max(m_cache_state->size, MIN_POOL_SIZE);
   m_log_pool_size = p2align(m_log_pool_size, POOL_SIZE_ALIGN);
@@ -1643,8 +1648,8 @@ bool AbstractWriteLog<I>::can_flush_entry(std::shared_ptr<GenericLogEntry> log_e
   }
 
   return (log_entry->can_writeback() &&
-         (m_flush_ops_in_flight <= IN_FLIGHT_FLUSH_WRITE_LIMIT) &&
-         (m_flush_bytes_in_flight <= IN_FLIGHT_FLUSH_BYTES_LIMIT));
+         (m_flush_ops_in_flight <= m_max_flush_ops_in_flight) &&
+         (m_flush_bytes_in_flight <= m_max_flush_bytes_in_flight));
 }
 
 template <typename I>
@@ -1750,7 +1755,7 @@ void AbstractWriteLog<I>::process_writeback_dirty_entries() {
 
     std::shared_lock entry_reader_locker(m_entry_reader_lock);
     std::lock_guard locker(m_lock);
-    while (flushed < IN_FLIGHT_FLUSH_WRITE_LIMIT) {
+    while (flushed < m_max_flush_ops_in_flight) {
       if (m_shutting_down) {
         ldout(cct, 5) << "Flush during shutdown suppressed" << dendl;
         /* Do flush complete only when all flush ops are finished */
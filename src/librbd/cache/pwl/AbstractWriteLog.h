@@ -206,6 +206,9 @@ private:
   int m_flush_ops_in_flight = 0;
   int m_flush_bytes_in_flight = 0;
   uint64_t m_lowest_flushing_sync_gen = 0;
+  /* Limits on concurrent writeback to the image */
+  int m_max_flush_ops_in_flight = IN_FLIGHT_FLUSH_WRITE_LIMIT;
+  int m_max_flush_bytes_in_flight = IN_FLIGHT_FLUSH_BYTES_LIMIT;
 
   /* Writes that have left the block guard, but are waiting for resources */
   C_BlockIORequests m_deferred_ios;
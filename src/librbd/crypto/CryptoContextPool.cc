@@ -22,6 +22,7 @@ CryptoContextPool<T>::~CryptoContextPool() {
   while (m_decrypt_contexts.pop(ctx)) {
     m_data_cryptor->return_context(ctx, CipherMode::CIPHER_MODE_DEC);
   }
+  delete m_data_cryptor;
 }
 
 template <typename T>
@@ -42,3 +43,5 @@ void CryptoContextPool<T>::return_context(T* ctx, CipherMode mode) {
 
 } // namespace crypto
 } // namespace librbd
+
+template class librbd::crypto::CryptoContextPool<EVP_CIPHER_CTX>;
@@ -5,12 +5,18 @@
 #define CEPH_LIBRBD_CRYPTO_CRYPTO_CONTEXT_POOL_H
 
 #include "librbd/crypto/DataCryptor.h"
+#include "librbd/crypto/openssl/DataCryptor.h"
 #include "include/ceph_assert.h"
 #include <boost/lockfree/queue.hpp>
 
 namespace librbd {
 namespace crypto {
 
+/*
+ * Keeps the contexts returned by the wrapped cryptor for reuse, so that a
+ * context (and its key schedule) is not set up from scratch on every
+ * encrypt/decrypt. Takes ownership of the wrapped cryptor.
+ */
 template <typename T>
 class CryptoContextPool : public DataCryptor<T>  {
 
@@ -65,4 +71,6 @@ private:
 } // namespace crypto
 } // namespace librbd
 
+extern template class librbd::crypto::CryptoContextPool<EVP_CIPHER_CTX>;
+
 #endif // CEPH_LIBRBD_CRYPTO_CRYPTO_CONTEXT_POOL_H
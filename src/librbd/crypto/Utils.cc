@@ -7,6 +7,7 @@
 #include "common/errno.h"
 #include "librbd/ImageCtx.h"
 #include "librbd/crypto/BlockCrypto.h"
+#include "librbd/crypto/CryptoContextPool.h"
 #include "librbd/crypto/CryptoInterface.h"
 #include "librbd/crypto/CryptoObjectDispatch.h"
 #include "librbd/crypto/EncryptionFormat.h"
@@ -22,6 +23,12 @@ namespace librbd {
 namespace crypto {
 namespace util {
 
+namespace {
+
+const uint32_t CONTEXT_POOL_SIZE = 32;
+
+} // anonymous namespace
+
 template <typename I>
 void set_crypto(I *image_ctx,
                 decltype(I::encryption_format) encryption_format) {
@@ -62,8 +69,12 @@ int build_crypto(
     return r;
   }
 
+  // reuse keyed contexts across requests rather than expanding the key
+  // for every IO
+  auto context_pool = new CryptoContextPool<EVP_CIPHER_CTX>(
+          data_cryptor, CONTEXT_POOL_SIZE);
   result_crypto->reset(BlockCrypto<EVP_CIPHER_CTX>::create(
-          cct, data_cryptor, block_size, data_offset));
+          cct, context_pool, block_size, data_offset));
   return 0;
 }
 
@@ -8,6 +8,7 @@
 #include "include/Context.h"
 #include "common/ceph_mutex.h"
 #include "common/dout.h"
+#include "common/sharded_shared_mutex.h"
 #include "common/AsyncOpTracker.h"
 #include "librbd/Utils.h"
 #include "librbd/io/DispatcherInterface.h"
@@ -31,9 +32,8 @@ public:
 
   Dispatcher(ImageCtxT* image_ctx)
     : m_image_ctx(image_ctx),
-      m_lock(ceph::make_shared_mutex(
-        librbd::util::unique_lock_name("librbd::io::Dispatcher::lock",
-                                       this))) {
+      m_lock(librbd::util::unique_lock_name("librbd::io::Dispatcher::lock",
+                                            this)) {
   }
 
   virtual ~Dispatcher() {
@@ -153,7 +153,9 @@ protected:
 
   ImageCtxT* m_image_ctx;
 
-  ceph::shared_mutex m_lock;
+  // taken shared by every IO for each layer it passes through, and only
+  // exclusively when layers are registered or shut down
+  ceph::sharded_shared_mutex m_lock;
   std::map<DispatchLayer, DispatchMeta> m_dispatches;
 
   virtual bool send_dispatch(Dispatch* dispatch,
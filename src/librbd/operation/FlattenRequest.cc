@@ -56,6 +56,24 @@ public:
         // can skip because the object already exists
         return 1;
       }
+
+      // with identical layouts the child object maps to the parent object
+      // with the same number, which need not be copied up when the parent
+      // object map says it does not exist (and there is no grandparent it
+      // could be inherited from)
+      auto parent = image_ctx.parent;
+      if (parent != nullptr && image_ctx.encryption_format == nullptr &&
+          parent->layout == image_ctx.layout) {
+        std::shared_lock parent_image_lock{parent->image_lock};
+        if (parent->parent == nullptr &&
+            parent->encryption_format == nullptr &&
+            parent->object_map != nullptr &&
+            !parent->object_map->object_may_exist(m_object_no)) {
+          ldout(cct, 20) << "skipping object " << m_object_no
+                         << " not present in parent" << dendl;
+          return 1;
+        }
+      }
     }
 
     if (!io::util::trigger_copyup(
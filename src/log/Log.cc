@@ -247,40 +247,90 @@ void Log::stop_journald_logger()
   m_journald.reset();
 }
 
-void Log::submit_entry(Entry&& e)
+Log::QueueShard& Log::_my_queue_shard()
 {
-  std::unique_lock lock(m_queue_mutex);
-  m_queue_mutex_holder = pthread_self();
-
-  if (unlikely(m_inject_segv))
-    *(volatile int *)(0) = 0xdead;
+  static std::atomic<unsigned> next_shard = 0;
+  thread_local const unsigned shard = next_shard++ % NUM_QUEUE_SHARDS;
+  return m_new[shard];
+}
 
+void Log::submit_entry(Entry&& e)
+{
   // wait for flush to catch up
-  while (is_started() &&
-	 m_new.size() > m_max_new) {
-    if (m_stop) break; // force addition
-    m_cond_loggers.wait(lock);
+  if (is_started() && m_num_new.load(std::memory_order_relaxed) > m_max_new) {
+    std::unique_lock lock(m_queue_mutex);
+    m_queue_mutex_holder = pthread_self();
+    while (is_started() &&
+	   m_num_new > m_max_new) {
+      if (m_stop) break; // force addition
+      m_cond_loggers.wait(lock);
+    }
+    m_queue_mutex_holder = 0;
   }
 
-  m_new.emplace_back(std::move(e));
-  m_cond_flusher.notify_all();
-  m_queue_mutex_holder = 0;
+  const bool was_empty = m_num_new++ == 0;
+  {
+    auto& shard = _my_queue_shard();
+    std::scoped_lock lock(shard.lock);
+    shard.holder = pthread_self();
+
+    if (unlikely(m_inject_segv))
+      *(volatile int *)(0) = 0xdead;
+
+    shard.entries.emplace_back(std::move(e));
+    shard.holder = 0;
+  }
+  // the flusher only goes to sleep once it has drained everything
+  if (was_empty) {
+    std::scoped_lock lock(m_queue_mutex);
+    m_cond_flusher.notify_all();
+  }
 }
 
-void Log::flush()
+void Log::_take_new()
 {
-  std::scoped_lock lock1(m_flush_mutex);
-  m_flush_mutex_holder = pthread_self();
-
+  assert(m_flush.empty());
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < NUM_QUEUE_SHARDS; ++i) {
+    auto& shard = m_new[i];
+    std::scoped_lock lock(shard.lock);
+    assert(m_taken[i].empty());
+    m_taken[i].swap(shard.entries);
+    n += m_taken[i].size();
+  }
+  if (n == 0) {
+    return;
+  }
+  m_num_new -= n;
   {
-    std::scoped_lock lock2(m_queue_mutex);
-    m_queue_mutex_holder = pthread_self();
-    assert(m_flush.empty());
-    m_flush.swap(m_new);
+    std::scoped_lock lock(m_queue_mutex);
     m_cond_loggers.notify_all();
-    m_queue_mutex_holder = 0;
   }
 
+  // each queue is in submission order; merge them by time stamp
+  m_flush.reserve(n);
+  std::array<std::size_t, NUM_QUEUE_SHARDS> pos = {};
+  while (m_flush.size() < n) {
+    std::size_t next = NUM_QUEUE_SHARDS;
+    for (std::size_t i = 0; i < NUM_QUEUE_SHARDS; ++i) {
+      if (pos[i] < m_taken[i].size() &&
+	  (next == NUM_QUEUE_SHARDS ||
+	   m_taken[i][pos[i]].m_stamp < m_taken[next][pos[next]].m_stamp)) {
+	next = i;
+      }
+    }
+    m_flush.emplace_back(std::move(m_taken[next][pos[next]++]));
+  }
+  for (auto& t : m_taken) {
+    t.clear();
+  }
+}
+
+void Log::flush()
+{
+  std::scoped_lock lock1(m_flush_mutex);
+  m_flush_mutex_holder = pthread_self();
+  _take_new();
   _flush(m_flush, false);
   m_flush_mutex_holder = 0;
 }
@@ -482,14 +532,7 @@ void Log::dump_recent()
   std::scoped_lock lock1(m_flush_mutex);
   m_flush_mutex_holder = pthread_self();
 
-  {
-    std::scoped_lock lock2(m_queue_mutex);
-    m_queue_mutex_holder = pthread_self();
-    assert(m_flush.empty());
-    m_flush.swap(m_new);
-    m_queue_mutex_holder = 0;
-  }
-
+  _take_new();
   _flush(m_flush, false);
 
   _log_message("--- begin dump of recent events ---", true);
@@ -526,7 +569,7 @@ void Log::dump_recent()
   }
 
   _log_message(fmt::format("  max_recent {:9}", m_recent.capacity()), true);
-  _log_message(fmt::format("  max_new    {:9}", m_max_new), true);
+  _log_message(fmt::format("  max_new    {:9}", m_max_new.load()), true);
   _log_message(fmt::format("  log_file {}", m_log_file), true);
 
   _log_message("--- end dump of recent events ---", true);
@@ -566,7 +609,7 @@ void *Log::entry()
     std::unique_lock lock(m_queue_mutex);
     m_queue_mutex_holder = pthread_self();
     while (!m_stop) {
-      if (!m_new.empty()) {
+      if (m_num_new > 0) {
         m_queue_mutex_holder = 0;
         lock.unlock();
         flush();
@@ -585,9 +628,16 @@ void *Log::entry()
 
 bool Log::is_inside_log_lock()
 {
-  return
-    pthread_self() == m_queue_mutex_holder ||
-    pthread_self() == m_flush_mutex_holder;
+  if (pthread_self() == m_queue_mutex_holder ||
+      pthread_self() == m_flush_mutex_holder) {
+    return true;
+  }
+  for (const auto& shard : m_new) {
+    if (pthread_self() == shard.holder) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void Log::inject_segv()
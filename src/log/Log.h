@@ -6,6 +6,8 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -89,12 +91,21 @@ private:
 
   static const std::size_t DEFAULT_MAX_NEW = 100;
   static const std::size_t DEFAULT_MAX_RECENT = 10000;
+  static const std::size_t NUM_QUEUE_SHARDS = 8;
+
+  /// new entries are spread over a few independently locked queues, so
+  /// threads logging at the same time rarely contend on the same lock
+  struct alignas(64) QueueShard {
+    std::mutex lock;
+    pthread_t holder = 0;
+    EntryVector entries;
+  };
 
   Log **m_indirect_this;
 
   const SubsystemMap *m_subs;
 
-  std::mutex m_queue_mutex;
+  std::mutex m_queue_mutex; ///< protects m_stop, used to wait on m_num_new
   std::mutex m_flush_mutex;
   std::condition_variable m_cond_loggers;
   std::condition_variable m_cond_flusher;
@@ -102,9 +113,14 @@ private:
   pthread_t m_queue_mutex_holder;
   pthread_t m_flush_mutex_holder;
 
-  EntryVector m_new;    ///< new entries
+  std::array<QueueShard, NUM_QUEUE_SHARDS> m_new; ///< new entries
+  /// entries queued in m_new; counted before they are added, so it may
+  /// briefly run ahead of the queues but never behind them
+  std::atomic<std::size_t> m_num_new = 0;
   EntryRing m_recent; ///< recent (less new) entries we've already written at low detail
   EntryVector m_flush; ///< entries to be flushed (here to optimize heap allocations)
+  /// m_new queues taken by the flusher, merged into m_flush
+  std::array<EntryVector, NUM_QUEUE_SHARDS> m_taken;
 
   std::string m_log_file;
   int m_fd = -1;
@@ -130,12 +146,16 @@ private:
 
   bool m_stop = false;
 
-  std::size_t m_max_new = DEFAULT_MAX_NEW;
+  std::atomic<std::size_t> m_max_new = DEFAULT_MAX_NEW;
 
   bool m_inject_segv = false;
 
   void *entry() override;
 
+  QueueShard& _my_queue_shard();
+  /// move all queued entries into m_flush, oldest first
+  void _take_new();
+
   void _log_safe_write(std::string_view sv);
   void _flush_logbuf();
   void _log_message(std::string_view s, bool crash);
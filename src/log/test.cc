@@ -14,6 +14,9 @@
 
 #include <limits.h>
 
+#include <map>
+#include <thread>
+
 using namespace std;
 using namespace ceph::logging;
 
@@ -170,6 +173,56 @@ TEST(Log, ManyGather)
   log.stop();
 }
 
+namespace {
+class CountingLog : public Log {
+public:
+  using Log::Log;
+  std::map<pthread_t, int> last;
+  int total = 0;
+  bool ordered = true;
+protected:
+  void _flush(EntryVector& q, bool crash) override {
+    for (auto& e : q) {
+      int n = atoi(std::string(e.strv()).c_str());
+      auto [p, inserted] = last.try_emplace(e.m_thread, n);
+      if (!inserted) {
+        ordered = ordered && p->second + 1 == n;
+        p->second = n;
+      }
+      ++total;
+    }
+    Log::_flush(q, crash);
+  }
+};
+}
+
+TEST(Log, ManyThreads)
+{
+  SubsystemMap subs;
+  subs.set_log_level(1, 1);
+  subs.set_gather_level(1, 20);
+  CountingLog log(&subs);
+  log.start();
+  constexpr int num_threads = 16;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&log] {
+      for (int i = 0; i < many; i++) {
+        MutableEntry e(10, 1);
+        e.get_ostream() << i;
+        log.submit_entry(std::move(e));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  log.flush();
+  log.stop();
+  ASSERT_EQ(num_threads * many, log.total);
+  ASSERT_TRUE(log.ordered);
+}
+
 static void readpipe(int fd, int verify)
 {
   while (1) {
@@ -16,7 +16,10 @@
 #ifndef MDS_BATCHOP_H
 #define MDS_BATCHOP_H
 
+#include <memory>
+
 #include "common/ref.h"
+#include "include/mempool.h"
 
 #include "mdstypes.h"
 
@@ -37,4 +40,8 @@ protected:
   virtual void _respond(mds_rank_t) = 0;
 };
 
+// per dentry/inode batches of getattr/lookup, keyed by mask; empty on
+// nearly every cached object, so only allocated when in use
+using BatchOpMap = mempool::mds_co::compact_map<int, std::unique_ptr<BatchOp>>;
+
 #endif
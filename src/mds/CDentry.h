@@ -373,8 +373,8 @@ public:
   SimpleLock lock; // FIXME referenced containers not in mempool
   LocalLockC versionlock; // FIXME referenced containers not in mempool
 
-  mempool::mds_co::map<client_t,ClientLease*> client_lease_map;
-  std::map<int, std::unique_ptr<BatchOp>> batch_ops;
+  mempool::mds_co::compact_map<client_t,ClientLease*> client_lease_map;
+  BatchOpMap batch_ops;
 
   ceph_tid_t reintegration_reqid = 0;
 
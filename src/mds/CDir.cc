@@ -317,7 +317,18 @@ void CDir::adjust_num_inodes_with_caps(int d)
 CDentry *CDir::lookup(std::string_view name, snapid_t snap)
 { 
   dout(20) << "lookup (" << name << ", '" << snap << "')" << dendl;
-  auto iter = items.lower_bound(dentry_key_t(snap, name, inode->hash_dentry_name(name)));
+  __u32 hash = inode->hash_dentry_name(name);
+  if (snap == CEPH_NOSNAP) {
+    // only a head dentry can cover CEPH_NOSNAP
+    auto p = head_items.find(head_dentry_key_t{name, hash});
+    if (p == head_items.end()) {
+      dout(20) << "  miss" << dendl;
+      return 0;
+    }
+    dout(20) << "  hit -> " << p->second->key() << dendl;
+    return p->second;
+  }
+  auto iter = items.lower_bound(dentry_key_t(snap, name, hash));
   if (iter == items.end())
     return 0;
   if (iter->second->get_name() == name &&
@@ -332,12 +343,31 @@ CDentry *CDir::lookup(std::string_view name, snapid_t snap)
 
 CDentry *CDir::lookup_exact_snap(std::string_view name, snapid_t last) {
   dout(20) << __func__ << " (" << last << ", '" << name << "')" << dendl;
-  auto p = items.find(dentry_key_t(last, name, inode->hash_dentry_name(name)));
+  __u32 hash = inode->hash_dentry_name(name);
+  if (last == CEPH_NOSNAP) {
+    auto p = head_items.find(head_dentry_key_t{name, hash});
+    return p == head_items.end() ? NULL : p->second;
+  }
+  auto p = items.find(dentry_key_t(last, name, hash));
   if (p == items.end())
     return NULL;
   return p->second;
 }
 
+void CDir::_insert_item(CDentry *dn)
+{
+  items[dn->key()] = dn;
+  if (dn->last == CEPH_NOSNAP)
+    head_items[head_dentry_key_t{dn->get_name(), dn->get_hash()}] = dn;
+}
+
+void CDir::_erase_item(CDentry *dn)
+{
+  items.erase(dn->key());
+  if (dn->last == CEPH_NOSNAP)
+    head_items.erase(head_dentry_key_t{dn->get_name(), dn->get_hash()});
+}
+
 void CDir::adjust_dentry_lru(CDentry *dn)
 {
   bool bottom_lru;
@@ -390,7 +420,7 @@ CDentry* CDir::add_null_dentry(std::string_view dname,
   ceph_assert(items.count(dn->key()) == 0);
   //assert(null_items.count(dn->get_name()) == 0);
 
-  items[dn->key()] = dn;
+  _insert_item(dn);
   if (last == CEPH_NOSNAP)
     num_head_null++;
   else
@@ -437,7 +467,7 @@ CDentry* CDir::add_primary_dentry(std::string_view dname, CInode *in,
   ceph_assert(items.count(dn->key()) == 0);
   //assert(null_items.count(dn->get_name()) == 0);
 
-  items[dn->key()] = dn;
+  _insert_item(dn);
 
   dn->get_linkage()->inode = in;
 
@@ -482,7 +512,7 @@ CDentry* CDir::add_remote_dentry(std::string_view dname, inodeno_t ino, unsigned
   ceph_assert(items.count(dn->key()) == 0);
   //assert(null_items.count(dn->get_name()) == 0);
 
-  items[dn->key()] = dn;
+  _insert_item(dn);
   if (last == CEPH_NOSNAP)
     num_head_items++;
   else
@@ -535,7 +565,7 @@ void CDir::remove_dentry(CDentry *dn)
   
   // remove from list
   ceph_assert(items.count(dn->key()) == 1);
-  items.erase(dn->key());
+  _erase_item(dn);
 
   // clean?
   if (dn->is_dirty())
@@ -864,9 +894,9 @@ void CDir::steal_dentry(CDentry *dn)
 {
   dout(15) << __func__ << " " << *dn << dendl;
 
-  items[dn->key()] = dn;
+  _insert_item(dn);
 
-  dn->dir->items.erase(dn->key());
+  dn->dir->_erase_item(dn);
   if (dn->dir->items.empty())
     dn->dir->put(PIN_CHILD);
 
@@ -48,6 +48,23 @@ public:
   typedef mempool::mds_co::map<dentry_key_t, CDentry*> dentry_key_map;
   typedef mempool::mds_co::set<dentry_key_t> dentry_key_set;
 
+  // point lookups of head dentries go through a hash index instead of
+  // walking the ordered map; the key refers to the name of the dentry
+  struct head_dentry_key_t {
+    std::string_view name;
+    __u32 hash;
+    bool operator==(const head_dentry_key_t& o) const {
+      return hash == o.hash && name == o.name;
+    }
+  };
+  struct head_dentry_key_hash {
+    size_t operator()(const head_dentry_key_t& k) const {
+      return k.hash;  // already the dir layout hash of the name
+    }
+  };
+  typedef mempool::mds_co::unordered_map<head_dentry_key_t, CDentry*,
+					 head_dentry_key_hash> head_dentry_map;
+
   using fnode_ptr = std::shared_ptr<fnode_t>;
   using fnode_const_ptr = std::shared_ptr<const fnode_t>;
 
@@ -700,6 +717,7 @@ protected:
 
   // contents of this directory
   dentry_key_map items;       // non-null AND null
+  head_dentry_map head_items; // items with last == CEPH_NOSNAP
   unsigned num_head_items = 0;
   unsigned num_head_null = 0;
   unsigned num_snap_items = 0;
@@ -763,6 +781,8 @@ private:
    */
   void scrub_maybe_delete_info();
 
+  void _insert_item(CDentry *dn);
+  void _erase_item(CDentry *dn);
   void link_inode_work( CDentry *dn, CInode *in );
   void unlink_inode_work( CDentry *dn );
   void remove_null_dentries();
@@ -242,7 +242,8 @@ class CInode : public MDSCacheObject, public InodeStoreBase, public Counter<CIno
  public:
   MEMPOOL_CLASS_HELPERS();
 
-  using mempool_cap_map = mempool::mds_co::map<client_t, Capability>;
+  // a compact_map: most cached inodes have no client caps at all
+  using mempool_cap_map = mempool::mds_co::compact_map<client_t, Capability>;
   /**
    * @defgroup Scrubbing and fsck
    */
@@ -418,7 +419,7 @@ class CInode : public MDSCacheObject, public InodeStoreBase, public Counter<CIno
     ceph_assert(batch_ops.empty());
   }
 
-  std::map<int, std::unique_ptr<BatchOp>> batch_ops;
+  BatchOpMap batch_ops;
 
   std::string_view pin_name(int p) const override;
 
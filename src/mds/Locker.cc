@@ -2330,12 +2330,18 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
 
   ceph_assert(in->is_head());
 
+  // every message for this inode names the same realm; look it up (a walk
+  // up the ancestry) at most once rather than once per client
+  inodeno_t realm_ino = 0;
+  auto get_realm_ino = [&] {
+    if (!realm_ino)
+      realm_ino = in->find_snaprealm()->inode->ino();
+    return realm_ino;
+  };
+
   // client caps
-  map<client_t, Capability>::iterator it;
-  if (only_cap)
-    it = in->client_caps.find(only_cap->get_client());
-  else
-    it = in->client_caps.begin();
+  auto it = only_cap ? in->client_caps.find(only_cap->get_client()) :
+                       in->client_caps.begin();
   for (; it != in->client_caps.end(); ++it) {
     Capability *cap = &it->second;
     int allowed = get_allowed_caps(in, cap, all_allowed, loner_allowed,
@@ -2376,7 +2382,7 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
         if (mds->logger) mds->logger->inc(l_mdss_ceph_cap_op_grant);
 
 	auto m = make_message<MClientCaps>(CEPH_CAP_OP_GRANT, in->ino(),
-					   in->find_snaprealm()->inode->ino(),
+					   get_realm_ino(),
 					   cap->get_cap_id(), cap->get_last_seq(),
 					   pending, wanted, 0, cap->get_mseq(),
 					   mds->get_osd_epoch_barrier());
@@ -2424,7 +2430,7 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
       }
 
       auto m = make_message<MClientCaps>(op, in->ino(),
-					 in->find_snaprealm()->inode->ino(),
+					 get_realm_ino(),
 					 cap->get_cap_id(), cap->get_last_seq(),
 					 after, wanted, 0, cap->get_mseq(),
 					 mds->get_osd_epoch_barrier());
@@ -2443,13 +2449,15 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
 void Locker::issue_truncate(CInode *in)
 {
   dout(7) << "issue_truncate on " << *in << dendl;
-  
+
+  inodeno_t realm_ino = in->client_caps.empty() ? inodeno_t() :
+    in->find_snaprealm()->inode->ino();
   for (auto &p : in->client_caps) {
     if (mds->logger) mds->logger->inc(l_mdss_ceph_cap_op_trunc);
     Capability *cap = &p.second;
     auto m = make_message<MClientCaps>(CEPH_CAP_OP_TRUNC,
                                        in->ino(),
-                                       in->find_snaprealm()->inode->ino(),
+                                       realm_ino,
                                        cap->get_cap_id(), cap->get_last_seq(),
                                        cap->pending(), cap->wanted(), 0,
                                        cap->get_mseq(),
@@ -2918,11 +2926,8 @@ void Locker::share_inode_max_size(CInode *in, Capability *only_cap)
    * the cap later.
    */
   dout(10) << "share_inode_max_size on " << *in << dendl;
-  map<client_t, Capability>::iterator it;
-  if (only_cap)
-    it = in->client_caps.find(only_cap->get_client());
-  else
-    it = in->client_caps.begin();
+  auto it = only_cap ? in->client_caps.find(only_cap->get_client()) :
+                       in->client_caps.begin();
   for (; it != in->client_caps.end(); ++it) {
     const client_t client = it->first;
     Capability *cap = &it->second;
@@ -4320,7 +4325,7 @@ void Locker::revoke_client_leases(SimpleLock *lock)
 {
   int n = 0;
   CDentry *dn = static_cast<CDentry*>(lock->get_parent());
-  for (map<client_t, ClientLease*>::iterator p = dn->client_lease_map.begin();
+  for (auto p = dn->client_lease_map.begin();
        p != dn->client_lease_map.end();
        ++p) {
     ClientLease *l = p->second;
@@ -951,6 +951,16 @@ void MDBalancer::try_rebalance(balance_state_t& state)
   multimap<double, CDir*> import_pop_map;
   multimap<mds_rank_t, pair<CDir*, double> > import_from_map;
 
+  // forget imports past their cooldown, including subtrees that went away
+  auto now = clock::now();
+  auto cooldown = g_conf().get_val<std::chrono::seconds>("mds_bal_import_cooldown");
+  for (auto p = import_stamps.begin(); p != import_stamps.end(); ) {
+    if (now - p->second >= cooldown)
+      import_stamps.erase(p++);
+    else
+      ++p;
+  }
+
   for (auto& dir : mds->mdcache->get_fullauth_subtrees()) {
     CInode *diri = dir->get_inode();
     if (diri->is_mdsdir())
@@ -959,6 +969,10 @@ void MDBalancer::try_rebalance(balance_state_t& state)
       continue;
     if (dir->is_freezing() || dir->is_frozen())
       continue;  // export pbly already in progress
+    if (in_import_cooldown(dir, now)) {
+      dout(15) << "  skipping recent import " << *dir << dendl;
+      continue;
+    }
 
     mds_rank_t from = diri->authority().first;
     double pop = dir->pop_auth_subtree.meta_load();
@@ -1375,6 +1389,7 @@ void MDBalancer::hit_dir(CDir *dir, int type, double amount)
 void MDBalancer::subtract_export(CDir *dir)
 {
   dirfrag_load_vec_t subload = dir->pop_auth_subtree;
+  import_stamps.erase(dir->dirfrag());
 
   while (true) {
     dir = dir->inode->get_parent_dir();
@@ -1389,6 +1404,8 @@ void MDBalancer::subtract_export(CDir *dir)
 void MDBalancer::add_import(CDir *dir)
 {
   dirfrag_load_vec_t subload = dir->pop_auth_subtree;
+  if (g_conf().get_val<std::chrono::seconds>("mds_bal_import_cooldown").count() > 0)
+    import_stamps[dir->dirfrag()] = clock::now();
 
   while (true) {
     dir = dir->inode->get_parent_dir();
@@ -1431,6 +1448,15 @@ void MDBalancer::adjust_pop_for_rename(CDir *pdir, CDir *dir, bool inc)
   }
 }
 
+bool MDBalancer::in_import_cooldown(CDir *dir, time now)
+{
+  auto p = import_stamps.find(dir->dirfrag());
+  if (p == import_stamps.end())
+    return false;
+  auto cooldown = g_conf().get_val<std::chrono::seconds>("mds_bal_import_cooldown");
+  return now - p->second < cooldown;
+}
+
 void MDBalancer::handle_mds_failure(mds_rank_t who)
 {
   if (0 == who) {
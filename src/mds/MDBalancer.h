@@ -118,6 +118,8 @@ private:
    */
   void try_rebalance(balance_state_t& state);
   bool test_rank_mask(mds_rank_t rank);
+  /// true if dir was imported less than mds_bal_import_cooldown ago
+  bool in_import_cooldown(CDir *dir, time now);
 
   bool bal_fragment_dirs;
   int64_t bal_fragment_interval;
@@ -147,6 +149,9 @@ private:
   // dirfrags that already have one in flight.
   std::set<dirfrag_t> split_pending, merge_pending;
 
+  // when the subtrees we hold were imported
+  std::map<dirfrag_t, time> import_stamps;
+
   // per-epoch scatter/gathered info
   std::map<mds_rank_t, mds_load_t> mds_load;
   std::map<mds_rank_t, double> mds_meta_load;
@@ -51,6 +51,9 @@ MDLog::MDLog(MDSRank* m)
 {
   debug_subtrees = g_conf().get_val<bool>("mds_debug_subtrees");
   event_large_threshold = g_conf().get_val<uint64_t>("mds_log_event_large_threshold");
+  submit_batch_max = g_conf().get_val<uint64_t>("mds_log_submit_batch_max");
+  replay_batch_max = g_conf().get_val<uint64_t>("mds_log_replay_batch_max");
+  group_commit_max_delay = g_conf().get_val<std::chrono::milliseconds>("mds_log_group_commit_max_delay");
   events_per_segment = g_conf().get_val<uint64_t>("mds_log_events_per_segment");
   pause = g_conf().get_val<bool>("mds_log_pause");
   major_segment_event_ratio = g_conf().get_val<uint64_t>("mds_log_major_segment_event_ratio");
@@ -92,6 +95,9 @@ void MDLog::create_logger()
   plb.add_u64_counter(l_mdl_replayed, "replayed", "Events replayed",
 		      "repl", PerfCountersBuilder::PRIO_INTERESTING);
   plb.add_time_avg(l_mdl_jlat, "jlat", "Journaler flush latency");
+  plb.add_u64_avg(l_mdl_evbatch, "evbatch", "Events per journal append");
+  plb.add_u64_counter(l_mdl_flushdefer, "flushdefer",
+                      "Flushes held back for group commit");
   plb.add_u64_counter(l_mdl_evex, "evex", "Total expired events");
   plb.add_u64_counter(l_mdl_evtrm, "evtrm", "Trimmed events");
   plb.add_u64_counter(l_mdl_segadd, "segadd", "Segments added");
@@ -390,99 +396,203 @@ public:
   }
 };
 
+/// the Journaler's waiter for a journal entry to become safe. Rather than
+/// each such completion taking mds_lock in turn, the ones of one flush are
+/// gathered and finished together
+class C_MDL_SafeQueued : public Context {
+  MDLog *mdlog;
+  MDSIOContextBase *fin;
+public:
+  C_MDL_SafeQueued(MDLog *m, MDSIOContextBase *f) : mdlog(m), fin(f) {}
+  void finish(int r) override {
+    mdlog->queue_safe_finish(fin, r);
+  }
+};
+
+class C_MDL_FinishSafe : public Context {
+  MDLog *mdlog;
+public:
+  explicit C_MDL_FinishSafe(MDLog *m) : mdlog(m) {}
+  void finish(int r) override {
+    mdlog->finish_safe_batch();
+  }
+};
+
+void MDLog::queue_safe_finish(MDSIOContextBase* fin, int r)
+{
+  bool first;
+  {
+    std::lock_guard l(safe_finish_lock);
+    first = safe_finished.empty();
+    safe_finished.emplace_back(fin, r);
+  }
+  if (first) {
+    // the Journaler queued the waiters of a flush together, so the others
+    // are already ahead of this in the finisher
+    mds->finisher->queue(new C_MDL_FinishSafe(this));
+  }
+}
+
+void MDLog::finish_safe_batch()
+{
+  std::lock_guard locker(mds->mds_lock);
+  std::vector<std::pair<MDSIOContextBase*, int>> batch;
+  {
+    std::lock_guard l(safe_finish_lock);
+    batch.swap(safe_finished);
+  }
+  dout(20) << __func__ << " " << batch.size() << " safe events" << dendl;
+  for (auto& [fin, r] : batch) {
+    fin->complete_locked(r);
+  }
+}
+
 void MDLog::_submit_thread()
 {
   dout(10) << "_submit_thread start" << dendl;
 
   std::unique_lock locker{submit_mutex};
 
+  // a flush held back while the previous one is still in flight, so that
+  // it goes out together with the events submitted meanwhile
+  bool flush_deferred = false;
+  ceph::mono_time flush_due;
+
   while (!mds->is_daemon_stopping()) {
     if (pause) {
       submit_cond.wait(locker);
       continue;
     }
 
-    map<uint64_t,list<PendingEvent> >::iterator it = pending_events.begin();
-    if (it == pending_events.end()) {
-      submit_cond.wait(locker);
-      continue;
+    // take everything pending, in order, up to the batch limit
+    std::vector<PendingEvent> batch;
+    const uint64_t batch_max = submit_batch_max.load();
+    while (!pending_events.empty() && batch.size() < batch_max) {
+      auto it = pending_events.begin();
+      if (it->second.empty()) {
+        pending_events.erase(it);
+        continue;
+      }
+      batch.push_back(it->second.front());
+      it->second.pop_front();
     }
 
-    if (it->second.empty()) {
-      pending_events.erase(it);
-      continue;
+    bool do_flush = false;
+    if (batch.empty()) {
+      if (!flush_deferred) {
+        submit_cond.wait(locker);
+        continue;
+      }
+      auto now = ceph::mono_clock::now();
+      if (now < flush_due && _flush_in_flight()) {
+        submit_cond.wait_for(locker, flush_due - now);
+        continue;
+      }
+      do_flush = true;
     }
 
     int64_t features = mdsmap_up_features;
-    PendingEvent data = it->second.front();
-    it->second.pop_front();
-
     locker.unlock();
 
-    if (data.le) {
-      LogEvent *le = data.le;
-      LogSegment *ls = le->_segment;
-      // encode it, with event type
-      bufferlist bl;
-      le->encode_with_header(bl, features);
+    // encode them, with event type
+    std::vector<bufferlist> bls(batch.size());
+    bool want_flush = false;
+    unsigned num_le = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+      if (batch[i].le) {
+        batch[i].le->encode_with_header(bls[i], features);
+        num_le++;
+      }
+      want_flush |= batch[i].flush;
+    }
 
-      uint64_t write_pos = journaler->get_write_pos();
+    // journal them with a single append
+    uint64_t write_pos = journaler->get_write_pos();
+    journaler->append_entries(bls, [&](size_t i, uint64_t new_write_pos) -> Context* {
+      auto& data = batch[i];
+      if (!data.le) {
+        if (!data.fin) {
+          return nullptr;
+        }
+        Context* fin = dynamic_cast<Context*>(data.fin);
+        ceph_assert(fin);
+        C_MDL_Flushed *fin2 = new C_MDL_Flushed(this, fin);
+        fin2->set_write_pos(new_write_pos);
+        return new C_MDL_SafeQueued(this, fin2);
+      }
 
+      LogEvent *le = data.le;
+      LogSegment *ls = le->_segment;
+      uint64_t len = new_write_pos - write_pos;
       le->set_start_off(write_pos);
       if (dynamic_cast<SegmentBoundary*>(le)) {
-	ls->offset = write_pos;
+        ls->offset = write_pos;
       }
-
-      if (bl.length() >= event_large_threshold.load()) {
+      if (len >= event_large_threshold.load()) {
         dout(5) << "large event detected!" << dendl;
         logger->inc(l_mdl_evlrg);
       }
-
-      dout(5) << "_submit_thread " << write_pos << "~" << bl.length()
-	      << " : " << *le << dendl;
-
-      // journal it.
-      const uint64_t new_write_pos = journaler->append_entry(bl);  // bl is destroyed.
-      ls->end = new_write_pos;
+      dout(5) << "_submit_thread " << write_pos << "~" << len
+              << " : " << *le << dendl;
+      ls->end = write_pos = new_write_pos;
 
       MDSLogContextBase *fin;
       if (data.fin) {
-	fin = dynamic_cast<MDSLogContextBase*>(data.fin);
-	ceph_assert(fin);
-	fin->set_write_pos(new_write_pos);
+        fin = dynamic_cast<MDSLogContextBase*>(data.fin);
+        ceph_assert(fin);
+        fin->set_write_pos(new_write_pos);
       } else {
-	fin = new C_MDL_Flushed(this, new_write_pos);
+        fin = new C_MDL_Flushed(this, new_write_pos);
       }
-
-      journaler->wait_for_flush(fin);
-
-      if (data.flush)
-	journaler->flush();
-
-      if (logger)
-	logger->set(l_mdl_wrpos, ls->end);
-
-      delete le;
-    } else {
-      if (data.fin) {
-	Context* fin = dynamic_cast<Context*>(data.fin);
-	ceph_assert(fin);
-	C_MDL_Flushed *fin2 = new C_MDL_Flushed(this, fin);
-	fin2->set_write_pos(journaler->get_write_pos());
-	journaler->wait_for_flush(fin2);
-      }
-      if (data.flush)
-	journaler->flush();
+      return new C_MDL_SafeQueued(this, fin);
+    });
+    if (logger && num_le) {
+      logger->set(l_mdl_wrpos, write_pos);
+      logger->inc(l_mdl_evbatch, num_le);
+    }
+    for (auto& data : batch) {
+      delete data.le;
     }
 
     locker.lock();
-    if (data.flush)
+    if (!do_flush && flush_deferred) {
+      do_flush = !_flush_in_flight() || ceph::mono_clock::now() >= flush_due;
+    } else if (!do_flush && want_flush) {
+      auto delay = group_commit_max_delay.load();
+      if (delay > ceph::timespan::zero() && _flush_in_flight()) {
+        flush_deferred = true;
+        flush_due = ceph::mono_clock::now() + delay;
+        if (logger)
+          logger->inc(l_mdl_flushdefer);
+        // wake up as soon as the write in flight is safe rather than
+        // sleeping out the whole delay
+        locker.unlock();
+        journaler->wait_for_flushed(new LambdaContext([this](int) {
+          std::lock_guard l(submit_mutex);
+          submit_cond.notify_all();
+        }));
+        locker.lock();
+      } else {
+        do_flush = true;
+      }
+    }
+    if (do_flush) {
+      flush_deferred = false;
       unflushed = 0;
-    else if (data.le)
-      unflushed++;
+      locker.unlock();
+      journaler->flush();
+      locker.lock();
+    } else {
+      unflushed += num_le;
+    }
   }
 }
 
+bool MDLog::_flush_in_flight() const
+{
+  return journaler->get_write_flush_pos() != journaler->get_write_safe_pos();
+}
+
 void MDLog::wait_for_safe(Context* c)
 {
   submit_mutex.lock();
@@ -496,8 +606,10 @@ void MDLog::wait_for_safe(Context* c)
 
   submit_mutex.unlock();
 
+  // (finished behind the completions of the events before it)
   if (no_pending && c)
-    journaler->wait_for_flush(new C_IO_Wrapper(mds, c));
+    journaler->wait_for_flush(
+      new C_MDL_SafeQueued(this, new MDSIOContextWrapper(mds, c)));
 }
 
 void MDLog::flush()
@@ -1340,12 +1452,47 @@ void MDLog::_replay_thread()
 {
   dout(10) << "_replay_thread start" << dendl;
 
+  // decoded events not applied yet; they are applied in batches, so that
+  // mds_lock is taken once per batch rather than once per event
+  std::vector<std::unique_ptr<LogEvent>> pending;
+  auto apply_pending = [this, &pending]() {
+    if (pending.empty())
+      return true;
+    {
+      std::lock_guard l(mds->mds_lock);
+      if (mds->is_daemon_stopping()) {
+        return false;
+      }
+      for (auto& le : pending) {
+        logger->inc(l_mdl_replayed);
+        le->replay(mds);
+      }
+    }
+    logger->set(l_mdl_rdpos, pending.back()->get_start_off());
+    logger->set(l_mdl_expos, journaler->get_expire_pos());
+    logger->set(l_mdl_wrpos, journaler->get_write_pos());
+    pending.clear();
+    return true;
+  };
+
   // loop
   int r = 0;
   while (1) {
+    // apply what we have before we might block on a read
+    if (!pending.empty() &&
+        (pending.size() >= replay_batch_max || !journaler->is_readable())) {
+      if (!apply_pending()) {
+        return;
+      }
+    }
+
     // wait for read?
     journaler->check_isreadable(); 
     if (journaler->get_error()) {
+      // events replayed so far must not outlive the segments trimmed below
+      if (!apply_pending()) {
+        return;
+      }
       r = journaler->get_error();
       dout(0) << "_replay journaler got error " << r << ", aborting" << dendl;
       if (r == -CEPHFS_ENOENT) {
@@ -1449,6 +1596,10 @@ void MDLog::_replay_thread()
 
     events_since_last_major_segment++;
     if (auto sb = dynamic_cast<SegmentBoundary*>(le.get()); sb) {
+      // events are replayed with the segment they belong to current
+      if (!apply_pending()) {
+        return;
+      }
       auto seq = sb->get_seq();
       if (seq > 0) {
         event_seq = seq;
@@ -1490,18 +1641,10 @@ void MDLog::_replay_thread()
     num_events++;
     logger->set(l_mdl_ev, num_events);
 
-    {
-      std::lock_guard l(mds->mds_lock);
-      if (mds->is_daemon_stopping()) {
-        return;
-      }
-      logger->inc(l_mdl_replayed);
-      le->replay(mds);
-    }
-
-    logger->set(l_mdl_rdpos, pos);
-    logger->set(l_mdl_expos, journaler->get_expire_pos());
-    logger->set(l_mdl_wrpos, journaler->get_write_pos());
+    pending.push_back(std::move(le));
+  }
+  if (!apply_pending()) {
+    return;
   }
 
   // done!
@@ -1588,6 +1731,15 @@ void MDLog::handle_conf_change(const std::set<std::string>& changed, const MDSMa
   if (changed.count("mds_log_event_large_threshold")) {
     event_large_threshold = g_conf().get_val<uint64_t>("mds_log_event_large_threshold");
   }
+  if (changed.count("mds_log_submit_batch_max")) {
+    submit_batch_max = g_conf().get_val<uint64_t>("mds_log_submit_batch_max");
+  }
+  if (changed.count("mds_log_replay_batch_max")) {
+    replay_batch_max = g_conf().get_val<uint64_t>("mds_log_replay_batch_max");
+  }
+  if (changed.count("mds_log_group_commit_max_delay")) {
+    group_commit_max_delay = g_conf().get_val<std::chrono::milliseconds>("mds_log_group_commit_max_delay");
+  }
   if (changed.count("mds_log_events_per_segment")) {
     events_per_segment = g_conf().get_val<uint64_t>("mds_log_events_per_segment");
   }
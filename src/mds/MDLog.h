@@ -37,6 +37,8 @@ enum {
   l_mdl_wrpos,
   l_mdl_rdpos,
   l_mdl_jlat,
+  l_mdl_evbatch,
+  l_mdl_flushdefer,
   l_mdl_replayed,
   l_mdl_last,
 };
@@ -232,6 +234,8 @@ protected:
   }
 
   void _submit_thread();
+  /// is a journal write still waiting to become safe?
+  bool _flush_in_flight() const;
 
   LogSegment *get_oldest_segment() {
     return segments.begin()->second;
@@ -272,11 +276,21 @@ protected:
   ceph::fair_mutex submit_mutex{"MDLog::submit_mutex"};
   std::condition_variable_any submit_cond;
 
+  ceph::mutex safe_finish_lock = ceph::make_mutex("MDLog::safe_finish_lock");
+  std::vector<std::pair<MDSIOContextBase*, int>> safe_finished;
+
 private:
   friend class C_MaybeExpiredSegment;
   friend class C_MDL_Flushed;
+  friend class C_MDL_SafeQueued;
+  friend class C_MDL_FinishSafe;
   friend class C_OFT_Committed;
 
+  /// queue a completion of a journal write that became safe, to be
+  /// finished with the others of its flush under one take of mds_lock
+  void queue_safe_finish(MDSIOContextBase* fin, int r);
+  void finish_safe_batch();
+
   void try_to_commit_open_file_table(uint64_t last_seq);
   LogSegment* _start_new_segment(SegmentBoundary* sb);
   void _segment_upkeep();
@@ -293,6 +307,9 @@ private:
 
   bool debug_subtrees;
   std::atomic_uint64_t event_large_threshold; // accessed by submit thread
+  std::atomic_uint64_t submit_batch_max; // accessed by submit thread
+  std::atomic_uint64_t replay_batch_max; // accessed by replay thread
+  std::atomic<ceph::timespan> group_commit_max_delay; // accessed by submit thread
   uint64_t events_per_segment;
   uint64_t major_segment_event_ratio;
   int64_t max_events;
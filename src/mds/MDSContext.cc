@@ -101,6 +101,12 @@ void MDSIOContextBase::complete(int r) {
   // lock here when MDSContext::complete would otherwise assume the lock is
   // already acquired.
   std::lock_guard l(mds->mds_lock);
+  MDSIOContextBase::complete_locked(r);
+}
+
+void MDSIOContextBase::complete_locked(int r) {
+  MDSRank *mds = get_mds();
+  ceph_assert(ceph_mutex_is_locked_by_me(mds->mds_lock));
 
   if (mds->is_daemon_stopping()) {
     dout(4) << "MDSIOContextBase::complete: dropping for stopping "
@@ -129,6 +135,15 @@ void MDSLogContextBase::complete(int r) {
   mdlog->set_safe_pos(safe_pos);
 }
 
+void MDSLogContextBase::complete_locked(int r) {
+  MDLog *mdlog = get_mds()->mdlog;
+  uint64_t safe_pos = write_pos;
+  pre_finish(r);
+  // MDSIOContext::complete_locked() free this
+  MDSIOContextBase::complete_locked(r);
+  mdlog->set_safe_pos(safe_pos);
+}
+
 void MDSIOContextWrapper::finish(int r)
 {
   fin->complete(r);
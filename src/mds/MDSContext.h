@@ -108,6 +108,9 @@ public:
   static bool check_ios_in_flight(ceph::coarse_mono_time cutoff,
 				  std::string& slow_count,
 				  ceph::coarse_mono_time& oldest);
+  /// complete(), for a caller that already holds mds_lock
+  virtual void complete_locked(int r);
+
 private:
   ceph::coarse_mono_time created_at;
   elist<MDSIOContextBase*>::item list_item;
@@ -127,6 +130,7 @@ protected:
 public:
   MDSLogContextBase() = default;
   void complete(int r) final;
+  void complete_locked(int r) final;
   void set_write_pos(uint64_t wp) { write_pos = wp; }
   virtual void pre_finish(int r) {}
   void print(std::ostream& out) const override {
@@ -1041,9 +1041,13 @@ bool MDSRankDispatcher::ms_dispatch(const cref_t<Message> &m)
       session->last_seen = Session::clock::now();
   }
 
+  auto start = ceph::mono_clock::now();
   inc_dispatch_depth();
   bool ret = _dispatch(m, true);
   dec_dispatch_depth();
+  if (logger) {
+    logger->tinc(l_mds_dispatch_latency, ceph::mono_clock::now() - start);
+  }
   return ret;
 }
 
@@ -3513,6 +3517,10 @@ void MDSRank::create_logger()
     mds_plb.add_u64_counter(l_mds_traverse_lock, "traverse_lock",
                             "Traverse locks");
     mds_plb.add_u64(l_mds_dispatch_queue_len, "q", "Dispatch queue length");
+    mds_plb.add_time_avg(l_mds_dispatch_lock_wait, "dispatch_lock_wait",
+                         "Time messages waited for mds_lock");
+    mds_plb.add_time_avg(l_mds_dispatch_latency, "dispatch_latency",
+                         "Time messages were handled under mds_lock");
     mds_plb.add_u64_counter(l_mds_exported, "exported", "Exports");
     mds_plb.add_u64_counter(l_mds_imported, "imported", "Imports");
     mds_plb.add_u64_counter(l_mds_openino_backtrace_fetch, "openino_backtrace_fetch",
@@ -3833,6 +3841,7 @@ const char** MDSRankDispatcher::get_tracked_conf_keys() const
     "mds_cap_revoke_eviction_timeout",
     "mds_debug_subtrees",
     "mds_dir_max_entries",
+    "mds_readdir_prefetch_frags",
     "mds_dump_cache_threshold_file",
     "mds_dump_cache_threshold_formatter",
     "mds_enable_op_tracker",
@@ -3850,14 +3859,18 @@ const char** MDSRankDispatcher::get_tracked_conf_keys() const
     "mds_kill_shutdown_at",
     "mds_log_event_large_threshold",
     "mds_log_events_per_segment",
+    "mds_log_group_commit_max_delay",
     "mds_log_major_segment_event_ratio",
     "mds_log_max_events",
     "mds_log_max_segments",
     "mds_log_pause",
+    "mds_log_replay_batch_max",
     "mds_log_skip_corrupt_events",
     "mds_log_skip_unbounded_events",
+    "mds_log_submit_batch_max",
     "mds_max_caps_per_client",
     "mds_max_export_size",
+    "mds_max_exports_in_flight",
     "mds_max_purge_files",
     "mds_max_purge_ops",
     "mds_max_purge_ops_per_pg",
@@ -685,7 +685,7 @@ void Migrator::maybe_do_queued_export()
     return;
   running = true;
 
-  uint64_t max_total_size = max_export_size * 2;
+  uint64_t max_total_size = max_export_size * max_exports_in_flight;
 
   while (!export_queue.empty() &&
 	 max_total_size > total_exporting_size &&
@@ -3677,6 +3677,7 @@ void Migrator::logged_import_caps(CInode *in,
 
 Migrator::Migrator(MDSRank *m, MDCache *c) : mds(m), mdcache(c) {
   max_export_size = g_conf().get_val<Option::size_t>("mds_max_export_size");
+  max_exports_in_flight = g_conf().get_val<uint64_t>("mds_max_exports_in_flight");
   inject_session_race = g_conf().get_val<bool>("mds_inject_migrator_session_race");
 }
 
@@ -3684,6 +3685,10 @@ void Migrator::handle_conf_change(const std::set<std::string>& changed, const MD
 {
   if (changed.count("mds_max_export_size"))
     max_export_size = g_conf().get_val<Option::size_t>("mds_max_export_size");
+  if (changed.count("mds_max_exports_in_flight")) {
+    max_exports_in_flight = g_conf().get_val<uint64_t>("mds_max_exports_in_flight");
+    maybe_do_queued_export();
+  }
   if (changed.count("mds_inject_migrator_session_race")) {
     inject_session_race = g_conf().get_val<bool>("mds_inject_migrator_session_race");
     dout(0) << "mds_inject_migrator_session_race is " << inject_session_race << dendl;
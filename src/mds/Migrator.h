@@ -372,6 +372,7 @@ private:
   MDSRank *mds;
   MDCache *mdcache;
   uint64_t max_export_size = 0;
+  uint64_t max_exports_in_flight = 2;
   bool inject_session_race = false;
 };
 
@@ -773,6 +773,13 @@ void OpenFileTable::_load_finish(int op_r, int header_r, int values_r,
       ++omap_num_items[idx];
   };
 
+  ceph_assert(num_loading_objs > 0);
+  if (load_err < 0) {
+    // another object failed to load, don't go on with this one
+    err = load_err;
+    goto out;
+  }
+
   if (op_r < 0) {
     derr << __func__ << " got " << cpp_strerror(op_r) << dendl;
     err = op_r;
@@ -831,6 +838,14 @@ void OpenFileTable::_load_finish(int op_r, int header_r, int values_r,
       }
     }
 
+    if (idx >= omap_num_objs) {
+      // a newer header shrank the table, this object is stale
+      dout(10) << __func__ << ": skipping object " << idx << " beyond "
+	       << omap_num_objs << " objects" << dendl;
+      values.clear();
+      more = false;
+    }
+
     for (auto& it : values) {
       if (it.first.compare(0, 9, "_journal.") == 0) {
 	if (idx >= loaded_journals.size())
@@ -853,18 +868,32 @@ void OpenFileTable::_load_finish(int op_r, int header_r, int values_r,
     goto out;
   }
 
-  if (more || idx + 1 < omap_num_objs) {
-    // Issue another read if we're not at the end of the omap
-    std::string last_key;
-    if (more)
-      last_key = values.rbegin()->first;
-    else
-      idx++;
+  // the objects are independent, so once a header told us how many
+  // there are, read all of them in parallel
+  while (num_load_objs_issued < omap_num_objs) {
+    ++num_loading_objs;
+    _read_omap_values("", num_load_objs_issued++, true);
+  }
 
-    _read_omap_values(last_key, idx, !more);
+  if (more) {
+    // Issue another read if we're not at the end of this object's omap
+    _read_omap_values(values.rbegin()->first, idx, false);
     return;
   }
 
+  if (--num_loading_objs > 0)
+    return;
+
+  // drop what was read from objects a newer header left out of the table
+  for (auto p = loaded_anchor_map.begin(); p != loaded_anchor_map.end(); ) {
+    if (p->second.omap_idx >= (int)omap_num_objs)
+      loaded_anchor_map.erase(p++);
+    else
+      ++p;
+  }
+  if (loaded_journals.size() > omap_num_objs)
+    loaded_journals.resize(omap_num_objs);
+
   // replay journal
   if (loaded_journals.size() > 0) {
     dout(10) << __func__ << ": recover journal" << dendl;
@@ -956,6 +985,12 @@ void OpenFileTable::_load_finish(int op_r, int header_r, int values_r,
   err = 0;
   dout(10) << __func__ << ": load complete" << dendl;
 out:
+  if (err < 0 && num_loading_objs > 0) {
+    // wait for the reads still in flight before giving up
+    load_err = err;
+    if (--num_loading_objs > 0)
+      return;
+  }
 
   if (err < 0)
     _reset_states();
@@ -972,6 +1007,9 @@ void OpenFileTable::load(MDSContext *onload)
   if (onload)
     waiting_for_load.push_back(onload);
 
+  // the header of the first object says how many more there are
+  num_loading_objs = 1;
+  num_load_objs_issued = 1;
   _read_omap_values("", 0, true);
 }
 
@@ -134,6 +134,9 @@ protected:
   std::map<inodeno_t, RecoveredAnchor> loaded_anchor_map;
   MDSContext::vec waiting_for_load;
   bool load_done = false;
+  unsigned num_loading_objs = 0;     // objects whose omap read is in flight
+  unsigned num_load_objs_issued = 0; // objects we started reading
+  int load_err = 0;
 
   enum {
     DIR_INODES = 1,
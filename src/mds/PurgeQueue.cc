@@ -149,6 +149,10 @@ void PurgeQueue::create_logger()
   pcb.add_u64(l_pq_executing, "pq_executing", "Purge queue tasks in flight");
   pcb.add_u64(l_pq_executing_high_water, "pq_executing_high_water", "Maximum number of executing file purges");
   pcb.add_u64(l_pq_item_in_journal, "pq_item_in_journal", "Purge item left in journal");
+  pcb.add_u64_counter(l_pq_executed_bytes, "pq_executed_bytes",
+                      "Purge queue file data purged", NULL, 0, unit_t(UNIT_BYTES));
+  pcb.add_time_avg(l_pq_item_latency, "pq_item_latency",
+                   "Time from queueing a purge item to completing it");
 
   logger.reset(pcb.create_perf_counters());
   g_ceph_context->get_perfcounters_collection()->add(logger.get());
@@ -361,7 +365,29 @@ void PurgeQueue::push(const PurgeItem &pi, Context *completion)
   }
 }
 
-uint32_t PurgeQueue::_calculate_ops(const PurgeItem &item) const
+/*
+ * Filer purges a range filer_max_purge_ops objects at a time. A file of
+ * more objects is purged in several ranges in parallel instead, as many as
+ * it takes to use the ops the queue has left, so that one large file does
+ * not hold up the queue for the time it takes to delete its objects ten at
+ * a time.
+ */
+uint32_t PurgeQueue::_calculate_ranges(const PurgeItem &item) const
+{
+  if (item.action == PurgeItem::PURGE_DIR || item.size == 0) {
+    return 1;
+  }
+  const uint64_t num = Striper::get_num_objects(item.layout, item.size);
+  const uint64_t per_range =
+    std::max<uint64_t>(1, cct->_conf->filer_max_purge_ops);
+  const uint64_t ops_free =
+    max_purge_ops > ops_in_flight ? max_purge_ops - ops_in_flight : 0;
+  const uint64_t want = std::min(num, std::max(ops_free, per_range));
+  return std::max<uint64_t>(1, want / per_range);
+}
+
+uint32_t PurgeQueue::_calculate_ops(const PurgeItem &item,
+                                    uint32_t ranges) const
 {
   uint32_t ops_required = 0;
   if (item.action == PurgeItem::PURGE_DIR) {
@@ -377,8 +403,10 @@ uint32_t PurgeQueue::_calculate_ops(const PurgeItem &item) const
     // Account for removing (or zeroing) backtrace
     const uint64_t num = (item.size > 0) ?
       Striper::get_num_objects(item.layout, item.size) : 1;
+    const uint64_t per_range =
+      std::max<uint64_t>(1, cct->_conf->filer_max_purge_ops);
 
-    ops_required = num;
+    ops_required = std::min<uint64_t>(num, ranges * per_range);
 
     // Account for deletions for old pools
     if (item.action != PurgeItem::TRUNCATE_FILE) {
@@ -539,9 +567,14 @@ void PurgeQueue::_commit_ops(int r, const std::vector<PurgeItemCommitOp>& ops_ve
           continue;
       }
 
-      filer.purge_range(op.item.ino, &op.item.layout, op.item.snapc,
-                        first_obj, num_obj, ceph::real_clock::now(), op.flags,
-                        gather.new_sub());
+      const uint64_t ranges = std::min<uint64_t>(op.ranges, num_obj);
+      for (uint64_t i = 0; i < ranges; i++) {
+        const uint64_t begin = first_obj + num_obj * i / ranges;
+        const uint64_t end = first_obj + num_obj * (i + 1) / ranges;
+        filer.purge_range(op.item.ino, &op.item.layout, op.item.snapc,
+                          begin, end - begin, ceph::real_clock::now(),
+                          op.flags, gather.new_sub());
+      }
     } else if (op.type == PurgeItemCommitOp::PURGE_OP_REMOVE) {
       if (op.item.action == PurgeItem::PURGE_DIR) {
         objecter->remove(op.oid, op.oloc, nullsnapc,
@@ -602,7 +635,9 @@ void PurgeQueue::_execute_item(
   files_high_water = std::max<uint64_t>(files_high_water,
                               in_flight.size());
   logger->set(l_pq_executing_high_water, files_high_water);
-  auto ops = _calculate_ops(item);
+  const auto ranges = _calculate_ranges(item);
+  auto ops = _calculate_ops(item, ranges);
+  in_flight_ops[expire_to] = ops;
   ops_in_flight += ops;
   logger->set(l_pq_executing_ops, ops_in_flight);
   ops_high_water = std::max(ops_high_water, ops_in_flight);
@@ -617,8 +652,10 @@ void PurgeQueue::_execute_item(
     if (item.size > 0) {
       uint64_t num = Striper::get_num_objects(item.layout, item.size);
       dout(10) << " 0~" << item.size << " objects 0~" << num
+               << " in " << ranges << " ranges"
                << " snapc " << item.snapc << " on " << item.ino << dendl;
       ops_vec.emplace_back(item, PurgeItemCommitOp::PURGE_OP_RANGE, 0);
+      ops_vec.back().ranges = ranges;
     }
 
     // remove the backtrace object if it was not purged
@@ -656,6 +693,7 @@ void PurgeQueue::_execute_item(
     // keep backtrace object
     if (num > 1) {
       ops_vec.emplace_back(item, PurgeItemCommitOp::PURGE_OP_RANGE, 0);
+      ops_vec.back().ranges = ranges;
     }
     ops_vec.emplace_back(item, PurgeItemCommitOp::PURGE_OP_ZERO, 0);
   } else {
@@ -666,6 +704,7 @@ void PurgeQueue::_execute_item(
     ops_high_water = std::max(ops_high_water, ops_in_flight);
     logger->set(l_pq_executing_ops_high_water, ops_high_water);
     in_flight.erase(expire_to);
+    in_flight_ops.erase(expire_to);
     logger->set(l_pq_executing, in_flight.size());
     files_high_water = std::max<uint64_t>(files_high_water,
                                 in_flight.size());
@@ -712,7 +751,14 @@ void PurgeQueue::_execute_item_complete(
     pending_expire.insert(expire_to);
   }
 
-  auto executed_ops = _calculate_ops(iter->second);
+  auto ops_iter = in_flight_ops.find(expire_to);
+  ceph_assert(ops_iter != in_flight_ops.end());
+  auto executed_ops = ops_iter->second;
+  in_flight_ops.erase(ops_iter);
+  if (iter->second.action != PurgeItem::PURGE_DIR)
+    logger->inc(l_pq_executed_bytes, iter->second.size);
+  if (iter->second.stamp != utime_t())
+    logger->tinc(l_pq_item_latency, ceph_clock_now() - iter->second.stamp);
   ops_in_flight -= executed_ops;
   logger->set(l_pq_executing_ops, ops_in_flight);
   ops_high_water = std::max(ops_high_water, ops_in_flight);
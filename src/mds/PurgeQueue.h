@@ -92,6 +92,8 @@ enum {
   l_pq_executed_ops,
   l_pq_executed,
   l_pq_item_in_journal,
+  l_pq_executed_bytes,
+  l_pq_item_latency,
   l_pq_last
 };
 
@@ -115,6 +117,8 @@ public:
   int flags;
   object_t oid;
   object_locator_t oloc;
+  // PURGE_OP_RANGE: the number of parts to purge the range in, in parallel
+  uint32_t ranges = 1;
 };
 
 /**
@@ -181,7 +185,8 @@ public:
   void handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map);
 
 private:
-  uint32_t _calculate_ops(const PurgeItem &item) const;
+  uint32_t _calculate_ranges(const PurgeItem &item) const;
+  uint32_t _calculate_ops(const PurgeItem &item, uint32_t ranges) const;
 
   bool _can_consume();
 
@@ -220,6 +225,8 @@ private:
 
   // Map of Journaler offset to PurgeItem
   std::map<uint64_t, PurgeItem> in_flight;
+  // ... and to the ops it was charged for when it started
+  std::map<uint64_t, uint32_t> in_flight_ops;
 
   std::set<uint64_t> pending_expire;
 
@@ -181,6 +181,8 @@ void Server::create_logger()
   plb.add_u64_counter(l_mdss_cap_acquisition_throttle,
                       "cap_acquisition_throttle", "Cap acquisition throttle counter", "cat",
                       PerfCountersBuilder::PRIO_INTERESTING);
+  plb.add_u64_counter(l_mdss_readdir_prefetch, "readdir_prefetch",
+                      "Dirfrags fetched ahead of a readdir");
 
   // fop latencies are useful
   plb.set_prio_default(PerfCountersBuilder::PRIO_USEFUL);
@@ -273,6 +275,7 @@ Server::Server(MDSRank *m, MetricsHandler *metrics_handler) :
   caps_throttle_retry_request_timeout = g_conf().get_val<double>("mds_cap_acquisition_throttle_retry_request_timeout");
   dir_max_entries = g_conf().get_val<uint64_t>("mds_dir_max_entries");
   bal_fragment_size_max = g_conf().get_val<int64_t>("mds_bal_fragment_size_max");
+  readdir_prefetch_frags = g_conf().get_val<uint64_t>("mds_readdir_prefetch_frags");
   supported_features = feature_bitset_t(CEPHFS_FEATURES_MDS_SUPPORTED);
   supported_metric_spec = feature_bitset_t(CEPHFS_METRIC_FEATURES_ALL);
 }
@@ -1372,6 +1375,9 @@ void Server::handle_conf_change(const std::set<std::string>& changed) {
     dout(20) << __func__ << " max fragment size changed to "
             << bal_fragment_size_max << dendl;
   }
+  if (changed.count("mds_readdir_prefetch_frags")) {
+    readdir_prefetch_frags = g_conf().get_val<uint64_t>("mds_readdir_prefetch_frags");
+  }
   if (changed.count("mds_inject_rename_corrupt_dentry_first")) {
     inject_rename_corrupt_dentry_first = g_conf().get_val<double>("mds_inject_rename_corrupt_dentry_first");
   }
@@ -4803,6 +4809,43 @@ void Server::handle_client_openc(const MDRequestRef& mdr)
 }
 
 
+/*
+ * start fetching the dirfrags following fg, so that a client walking a
+ * large fragmented directory does not stall on a fetch at every frag
+ * boundary.  nobody waits for these; a readdir that gets to one of the
+ * frags before it is complete waits on the fetch already in flight.
+ */
+void Server::_prefetch_readdir_frags(CInode *diri, frag_t fg)
+{
+  if (!readdir_prefetch_frags || diri->dirfragtree.is_leaf(frag_t()))
+    return;
+  if (mdcache->cache_toofull())
+    return;
+
+  frag_vec_t leaves;
+  diri->dirfragtree.get_leaves(leaves);
+  auto p = std::find(leaves.begin(), leaves.end(), fg);
+  if (p == leaves.end())
+    return;
+
+  uint64_t n = 0;
+  for (++p; p != leaves.end() && n < readdir_prefetch_frags; ++p, ++n) {
+    CDir *dir = diri->get_dirfrag(*p);
+    if (!dir) {
+      if (!diri->is_auth() || diri->is_frozen())
+	continue;
+      dir = diri->get_or_open_dirfrag(mdcache, *p);
+    }
+    if (!dir->is_auth() || dir->is_complete() ||
+	dir->state_test(CDir::STATE_FETCHING) || !dir->can_auth_pin())
+      continue;
+    dout(10) << __func__ << " " << *dir << dendl;
+    dir->fetch(nullptr);
+    if (logger)
+      logger->inc(l_mdss_readdir_prefetch);
+  }
+}
+
 void Server::_finalize_readdir(const MDRequestRef& mdr,
                                CInode *diri,
                                CDir* dir,
@@ -4935,6 +4978,7 @@ void Server::handle_client_readdir(const MDRequestRef& mdr)
     // fetch
     dout(10) << " incomplete dir contents for readdir on " << *dir << ", fetching" << dendl;
     dir->fetch(new C_MDS_RetryRequest(mdcache, mdr), true);
+    _prefetch_readdir_frags(diri, fg);
     return;
   }
 
@@ -4942,6 +4986,8 @@ void Server::handle_client_readdir(const MDRequestRef& mdr)
   dir->verify_fragstat();
 #endif
 
+  _prefetch_readdir_frags(diri, fg);
+
   utime_t now = ceph_clock_now();
   mdr->set_mds_stamp(now);
 
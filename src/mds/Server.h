@@ -82,6 +82,7 @@ enum {
   l_mdss_cap_revoke_eviction,
   l_mdss_cap_acquisition_throttle,
   l_mdss_req_getvxattr_latency,
+  l_mdss_readdir_prefetch,
   l_mdss_last,
 };
 
@@ -493,6 +494,7 @@ private:
                          __u32 numfiles,
                          bufferlist& dirbl,
                          bufferlist& dnbl);
+  void _prefetch_readdir_frags(CInode *diri, frag_t fg);
   void _readdir_diff(
     utime_t now,
     const MDRequestRef& mdr,
@@ -546,6 +548,7 @@ private:
   unsigned delegate_inos_pct = 0;
   uint64_t dir_max_entries = 0;
   int64_t bal_fragment_size_max = 0;
+  uint64_t readdir_prefetch_frags = 0;
 
   double inject_rename_corrupt_dentry_first = 0.0;
 
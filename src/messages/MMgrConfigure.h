@@ -25,7 +25,7 @@
  */
 class MMgrConfigure : public Message {
 private:
-  static constexpr int HEAD_VERSION = 4;
+  static constexpr int HEAD_VERSION = 5;
   static constexpr int COMPAT_VERSION = 1;
 
 public:
@@ -38,6 +38,9 @@ public:
 
   boost::optional<MetricConfigMessage> metric_config_message;
 
+  // leave the values of unchanged counters out of the MMgrReports
+  bool perf_counter_deltas = false;
+
   void decode_payload() override
   {
     using ceph::decode;
@@ -52,6 +55,9 @@ public:
     if (header.version >= 4) {
       decode(metric_config_message, p);
     }
+    if (header.version >= 5) {
+      decode(perf_counter_deltas, p);
+    }
   }
 
   void encode_payload(uint64_t features) override {
@@ -65,12 +71,17 @@ public:
       boost::optional<MetricConfigMessage> empty;
       encode(empty, payload);
     }
+    encode(perf_counter_deltas, payload);
   }
 
   std::string_view get_type_name() const override { return "mgrconfigure"; }
   void print(std::ostream& out) const override {
     out << get_type_name() << "(period=" << stats_period
-			   << ", threshold=" << stats_threshold << ")";
+			   << ", threshold=" << stats_threshold;
+    if (perf_counter_deltas) {
+      out << ", deltas";
+    }
+    out << ")";
   }
 
 private:
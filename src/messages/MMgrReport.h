@@ -98,6 +98,42 @@ public:
 };
 WRITE_CLASS_ENCODER(PerfCounterType)
 
+/// Which counters, in declaration order, a v2 packed report carries values
+/// for; the others did not change since the previous report.  Encoded as
+/// a vector of bytes, one bit per counter.
+class PerfCounterChanges
+{
+  std::vector<uint8_t> bits;
+  unsigned count = 0;
+
+public:
+  /// flag the next counter
+  void push_back(bool changed) {
+    if (count % 8 == 0) {
+      bits.push_back(0);
+    }
+    if (changed) {
+      bits.back() |= 1 << (count % 8);
+    }
+    ++count;
+  }
+  /// are the values of counter n included?  not for those past the end
+  bool test(unsigned n) const {
+    return n / 8 < bits.size() && (bits[n / 8] & (1 << (n % 8)));
+  }
+
+  void encode(ceph::buffer::list &bl) const {
+    using ceph::encode;
+    encode(bits, bl);
+  }
+  void decode(ceph::buffer::list::const_iterator &p) {
+    using ceph::decode;
+    decode(bits, p);
+    count = bits.size() * 8;
+  }
+};
+WRITE_CLASS_ENCODER(PerfCounterChanges)
+
 class MMgrReport : public Message {
 private:
   static constexpr int HEAD_VERSION = 9;
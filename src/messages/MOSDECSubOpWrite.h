@@ -20,13 +20,17 @@
 
 class MOSDECSubOpWrite : public MOSDFastDispatchOp {
 private:
-  static constexpr int HEAD_VERSION = 2;
+  static constexpr int HEAD_VERSION = 3;
   static constexpr int COMPAT_VERSION = 1;
+  // what decoding batched_ops takes; older decoders would drop them
+  static constexpr int BATCHED_COMPAT_VERSION = 3;
 
 public:
   spg_t pgid;
   epoch_t map_epoch = 0, min_epoch = 0;
   ECSubWrite op;
+  /// further writes to the same shard, applied in order after op
+  std::list<ECSubWrite> batched_ops;
 
   int get_cost() const override {
     return 0;
@@ -61,15 +65,21 @@ public:
     } else {
       min_epoch = map_epoch;
     }
+    if (header.version >= 3) {
+      decode(batched_ops, p);
+    }
   }
 
   void encode_payload(uint64_t features) override {
     using ceph::encode;
+    header.compat_version =
+      batched_ops.empty() ? COMPAT_VERSION : BATCHED_COMPAT_VERSION;
     encode(pgid, payload);
     encode(map_epoch, payload);
     encode(op, payload);
     encode(min_epoch, payload);
     encode_trace(payload, features);
+    encode(batched_ops, payload);
   }
 
   std::string_view get_type_name() const override { return "MOSDECSubOpWrite"; }
@@ -78,12 +88,16 @@ public:
     out << "MOSDECSubOpWrite(" << pgid
 	<< " " << map_epoch << "/" << min_epoch
 	<< " " << op;
+    if (!batched_ops.empty()) {
+      out << " +" << batched_ops.size() << " batched";
+    }
     out << ")";
   }
 
   void clear_buffers() override {
     op.t = ObjectStore::Transaction();
     op.log_entries.clear();
+    batched_ops.clear();
   }
 private:
   template<class T, typename... Args>
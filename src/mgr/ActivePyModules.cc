@@ -185,11 +185,41 @@ void ActivePyModules::update_cache_metrics() {
     perfcounter->set(l_mgr_cache_miss, hit_miss_ratio.second);
 }
 
+std::pair<epoch_t, version_t> ActivePyModules::get_cache_version(
+  const std::string &what)
+{
+  // only the maps a dump is built from matter
+  epoch_t epoch = 0;
+  version_t version = 0;
+  if (what.substr(0, 7) == "osd_map" || what == "df" ||
+      what == "osd_pool_stats") {
+    epoch = cluster_state.with_osdmap([](const OSDMap &osd_map) {
+      return osd_map.get_epoch();
+    });
+  }
+  if (what.substr(0, 3) == "pg_" || what == "osd_stats" ||
+      what == "pool_stats" || what == "df" || what == "osd_pool_stats") {
+    version = cluster_state.with_pgmap([](const PGMap &pg_map) {
+      return pg_map.version;
+    });
+  }
+  return {epoch, version};
+}
+
 PyObject *ActivePyModules::cacheable_get_python(const std::string &what)
 {
   uint64_t ttl_seconds = g_conf().get_val<uint64_t>("mgr_ttl_cache_expire_seconds");
+  std::pair<epoch_t, version_t> version;
   if(ttl_seconds > 0) {
     ttl_cache.set_ttl(ttl_seconds);
+    version = without_gil([&] {
+      return get_cache_version(what);
+    });
+    // a dump of an older map is stale however young it is, while one of
+    // the current map is shared by every module until it expires
+    if (ttl_cache.exists(what) && ttl_cache_versions[what] != version) {
+      ttl_cache.erase(what);
+    }
     try{
       PyObject* cached = ttl_cache.get(what);
       update_cache_metrics();
@@ -200,6 +230,7 @@ PyObject *ActivePyModules::cacheable_get_python(const std::string &what)
   PyObject *obj = get_python(what);
   if(ttl_seconds && ttl_cache.is_cacheable(what)) {
     ttl_cache.insert(what, obj);
+    ttl_cache_versions[what] = version;
     Py_INCREF(obj);
   }
   update_cache_metrics();
@@ -57,6 +57,8 @@ class ActivePyModules
   Client   &client;
   Finisher &finisher;
   TTLCache<std::string, PyObject*> ttl_cache;
+  /// (osdmap epoch, pgmap version) each ttl_cache entry was built from
+  std::map<std::string, std::pair<epoch_t, version_t>> ttl_cache_versions;
 public:
   Finisher cmd_finisher;
 private:
@@ -229,5 +231,6 @@ public:
 
   bool inject_python_on() const;
   void update_cache_metrics();
+  std::pair<epoch_t, version_t> get_cache_version(const std::string &what);
 };
 
@@ -89,7 +89,7 @@ void ClusterState::ingest_pgstats(ref_t<MPGStats> stats)
     pending_inc.update_stat(from, std::move(empty_stat));  
   }
 
-  for (auto p : stats->pg_stat) {
+  for (const auto& p : stats->pg_stat) {
     pg_t pgid = p.first;
     const auto &pg_stats = p.second;
 
@@ -124,10 +124,18 @@ void ClusterState::ingest_pgstats(ref_t<MPGStats> stats)
 	       << q->second.reported_seq << dendl;
       continue;
     }
+    // the osd resends what it published last until the pg changes, and
+    // bumps reported_seq when it does; applying the same stats again
+    // would just subtract and add them back to every sum
+    if (q != pg_map.pg_stat.end() &&
+	q->second.get_version_pair() == pg_stats.get_version_pair() &&
+	q->second.state == pg_stats.state) {
+      continue;
+    }
 
     pending_inc.pg_stat_updates[pgid] = pg_stats;
   }
-  for (auto p : stats->pool_stat) {
+  for (const auto& p : stats->pool_stat) {
     pending_inc.pool_statfs_updates[std::make_pair(p.first, from)] = p.second;
   }
 }
@@ -223,6 +231,157 @@ void ClusterState::final_init()
     "dump_osd_network name=value,type=CephInt,req=false", asok_hook,
     "Dump osd heartbeat network ping times");
   ceph_assert(r == 0);
+  r = admin_socket->register_command(
+    "dump_cluster_metrics", asok_hook,
+    "Dump cluster, pool and pg metrics in the prometheus text format");
+  ceph_assert(r == 0);
+}
+
+namespace {
+void dump_metric_header(ostream& out, std::string_view name,
+			std::string_view type, std::string_view help)
+{
+  out << "# HELP " << name << " " << help << "\n"
+      << "# TYPE " << name << " " << type << "\n";
+}
+}
+
+void ClusterState::dump_cluster_metrics(ostream& ss)
+{
+  // names and labels follow the mgr prometheus module
+  objecter->with_osdmap([this](const OSDMap& osdmap) {
+    if (!osdmap_metrics.empty() &&
+	osdmap_metrics_epoch == osdmap.get_epoch()) {
+      return;
+    }
+    stringstream out;
+    dump_metric_header(out, "ceph_osd_up", "untyped", "OSD status up");
+    for (int i = 0; i < osdmap.get_max_osd(); i++) {
+      if (osdmap.exists(i)) {
+	out << "ceph_osd_up{ceph_daemon=\"osd." << i << "\"} "
+	    << (osdmap.is_up(i) ? 1 : 0) << "\n";
+      }
+    }
+    dump_metric_header(out, "ceph_osd_in", "untyped", "OSD status in");
+    for (int i = 0; i < osdmap.get_max_osd(); i++) {
+      if (osdmap.exists(i)) {
+	out << "ceph_osd_in{ceph_daemon=\"osd." << i << "\"} "
+	    << (osdmap.is_in(i) ? 1 : 0) << "\n";
+      }
+    }
+    dump_metric_header(out, "ceph_osd_weight", "untyped", "OSD status weight");
+    for (int i = 0; i < osdmap.get_max_osd(); i++) {
+      if (osdmap.exists(i)) {
+	out << "ceph_osd_weight{ceph_daemon=\"osd." << i << "\"} "
+	    << osdmap.get_weightf(i) << "\n";
+      }
+    }
+    dump_metric_header(out, "ceph_pool_metadata", "untyped", "POOL Metadata");
+    for (auto& [poolid, pool] : osdmap.get_pools()) {
+      out << "ceph_pool_metadata{pool_id=\"" << poolid
+	  << "\",name=\"" << osdmap.get_pool_name(poolid)
+	  << "\",type=\"" << (pool.is_erasure() ? "erasure" : "replicated")
+	  << "\"} 1\n";
+    }
+    osdmap_metrics = out.str();
+    osdmap_metrics_epoch = osdmap.get_epoch();
+  });
+
+  if (pgmap_metrics.empty() || pgmap_metrics_version != pg_map.version) {
+    stringstream out;
+    const auto& statfs = pg_map.osd_sum.statfs;
+    dump_metric_header(out, "ceph_cluster_total_bytes", "gauge",
+		       "DF total_bytes");
+    out << "ceph_cluster_total_bytes " << statfs.total << "\n";
+    dump_metric_header(out, "ceph_cluster_total_used_bytes", "gauge",
+		       "DF total_used_bytes");
+    out << "ceph_cluster_total_used_bytes " << statfs.get_used() << "\n";
+    dump_metric_header(out, "ceph_cluster_total_used_raw_bytes", "gauge",
+		       "DF total_used_raw_bytes");
+    out << "ceph_cluster_total_used_raw_bytes " << statfs.get_used_raw()
+	<< "\n";
+
+    const auto& sum = pg_map.pg_sum.stats.sum;
+    dump_metric_header(out, "ceph_num_objects_degraded", "gauge",
+		       "Number of degraded objects");
+    out << "ceph_num_objects_degraded " << sum.num_objects_degraded << "\n";
+    dump_metric_header(out, "ceph_num_objects_misplaced", "gauge",
+		       "Number of misplaced objects");
+    out << "ceph_num_objects_misplaced " << sum.num_objects_misplaced << "\n";
+    dump_metric_header(out, "ceph_num_objects_unfound", "gauge",
+		       "Number of unfound objects");
+    out << "ceph_num_objects_unfound " << sum.num_objects_unfound << "\n";
+
+    const bool per_pool = pg_map.use_per_pool_stats();
+    const bool per_pool_omap = pg_map.use_per_pool_omap_stats();
+    struct pool_metric_t {
+      const char *name;
+      const char *type;
+      const char *help;
+      std::function<int64_t(const pool_stat_t&)> get;
+    };
+    const pool_metric_t pool_metrics[] = {
+      {"ceph_pool_bytes_used", "gauge", "DF pool bytes_used",
+       [per_pool, per_pool_omap](const pool_stat_t& s) -> int64_t {
+	 return s.get_allocated_data_bytes(per_pool) +
+		s.get_allocated_omap_bytes(per_pool_omap);
+       }},
+      {"ceph_pool_objects", "gauge", "DF pool objects",
+       [](const pool_stat_t& s) { return s.stats.sum.num_objects; }},
+      {"ceph_pool_rd", "counter", "DF pool rd",
+       [](const pool_stat_t& s) { return s.stats.sum.num_rd; }},
+      {"ceph_pool_rd_bytes", "counter", "DF pool rd_bytes",
+       [](const pool_stat_t& s) { return s.stats.sum.num_rd_kb << 10; }},
+      {"ceph_pool_wr", "counter", "DF pool wr",
+       [](const pool_stat_t& s) { return s.stats.sum.num_wr; }},
+      {"ceph_pool_wr_bytes", "counter", "DF pool wr_bytes",
+       [](const pool_stat_t& s) { return s.stats.sum.num_wr_kb << 10; }},
+    };
+    // sorted, so that series keep their order across scrapes
+    std::map<int64_t, const pool_stat_t*> pools;
+    for (auto& [poolid, stat] : pg_map.pg_pool_sum) {
+      pools[poolid] = &stat;
+    }
+    for (auto& m : pool_metrics) {
+      dump_metric_header(out, m.name, m.type, m.help);
+      for (auto& [poolid, stat] : pools) {
+	out << m.name << "{pool_id=\"" << poolid << "\"} " << m.get(*stat)
+	    << "\n";
+      }
+    }
+
+    dump_metric_header(out, "ceph_pg_total", "gauge", "PG Total Count per Pool");
+    for (auto& [poolid, num] : pg_map.num_pg_by_pool) {
+      out << "ceph_pg_total{pool_id=\"" << poolid << "\"} " << num << "\n";
+    }
+    const uint64_t pg_states[] = {
+      PG_STATE_ACTIVE, PG_STATE_CLEAN, PG_STATE_DOWN, PG_STATE_DEGRADED,
+      PG_STATE_UNDERSIZED, PG_STATE_PEERING, PG_STATE_RECOVERING,
+      PG_STATE_BACKFILLING, PG_STATE_REMAPPED, PG_STATE_STALE,
+      PG_STATE_INCONSISTENT, PG_STATE_INCOMPLETE,
+    };
+    for (auto state : pg_states) {
+      std::string name = "ceph_pg_" + pg_state_string(state);
+      dump_metric_header(out, name, "gauge", "PG " + pg_state_string(state) +
+			 " per pool");
+      for (auto& [poolid, num] : pg_map.num_pg_by_pool) {
+	int64_t n = 0;
+	if (auto p = pg_map.num_pg_by_pool_state.find(poolid);
+	    p != pg_map.num_pg_by_pool_state.end()) {
+	  for (auto& [s, count] : p->second) {
+	    if (s & state) {
+	      n += count;
+	    }
+	  }
+	}
+	out << name << "{pool_id=\"" << poolid << "\"} " << n << "\n";
+      }
+    }
+    pgmap_metrics = out.str();
+    pgmap_metrics_version = pg_map.version;
+  }
+
+  ss << osdmap_metrics << pgmap_metrics;
 }
 
 bool ClusterState::asok_command(
@@ -376,6 +535,8 @@ bool ClusterState::asok_command(
     }
     f->close_section(); // entries
     f->close_section(); // network_ping_times
+  } else if (admin_command == "dump_cluster_metrics") {
+    dump_cluster_metrics(ss);
   } else {
     ceph_abort_msg("broken asok registration");
   }
@@ -52,6 +52,14 @@ protected:
 
   class ClusterSocketHook *asok_hook;
 
+  // prometheus text served by dump_cluster_metrics; each half is only
+  // encoded again once the map it comes from changed
+  epoch_t osdmap_metrics_epoch = 0;
+  std::string osdmap_metrics;
+  version_t pgmap_metrics_version = 0;
+  std::string pgmap_metrics;
+  void dump_cluster_metrics(std::ostream& ss);
+
 public:
 
   void load_digest(MMgrDigest *m);
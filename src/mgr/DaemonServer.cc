@@ -676,8 +676,10 @@ bool DaemonServer::handle_report(const ref_t<MMgrReport>& m)
       return false;
     }
 
-    // Update the DaemonState
+    // Update the DaemonState.  Decoding the counters only needs the
+    // daemon's own lock, don't keep everything else waiting on ours.
     ceph_assert(daemon != nullptr);
+    locker.unlock();
     {
       std::lock_guard l(daemon->lock);
       auto &daemon_counters = daemon->perf_counters;
@@ -701,9 +703,7 @@ bool DaemonServer::handle_report(const ref_t<MMgrReport>& m)
       } else if (m->daemon_status) {
         derr << "got status from non-daemon " << key << dendl;
       }
-      // update task status
       if (m->task_status) {
-        update_task_status(key, *m->task_status);
         daemon->last_service_beacon = now;
       }
       if (m->get_connection()->peer_is_osd() || m->get_connection()->peer_is_mon()) {
@@ -713,6 +713,11 @@ bool DaemonServer::handle_report(const ref_t<MMgrReport>& m)
                  << dendl;
       }
     }
+    // update task status
+    if (m->task_status) {
+      locker.lock();
+      update_task_status(key, *m->task_status);
+    }
   }
 
   // if there are any schema updates, notify the python modules
@@ -3081,6 +3086,7 @@ const char** DaemonServer::get_tracked_conf_keys() const
   static const char *KEYS[] = {
     "mgr_stats_threshold",
     "mgr_stats_period",
+    "mgr_stats_deltas",
     nullptr
   };
 
@@ -3091,7 +3097,8 @@ void DaemonServer::handle_conf_change(const ConfigProxy& conf,
 				      const std::set <std::string> &changed)
 {
 
-  if (changed.count("mgr_stats_threshold") || changed.count("mgr_stats_period")) {
+  if (changed.count("mgr_stats_threshold") || changed.count("mgr_stats_period") ||
+      changed.count("mgr_stats_deltas")) {
     dout(4) << "Updating stats threshold/period on "
             << daemon_connections.size() << " clients" << dendl;
     // Send a fresh MMgrConfigure to all clients, so that they can follow
@@ -3112,6 +3119,7 @@ void DaemonServer::_send_configure(ConnectionRef c)
   auto configure = make_message<MMgrConfigure>();
   configure->stats_period = g_conf().get_val<int64_t>("mgr_stats_period");
   configure->stats_threshold = g_conf().get_val<int64_t>("mgr_stats_threshold");
+  configure->perf_counter_deltas = g_conf().get_val<bool>("mgr_stats_deltas");
 
   if (c->peer_is_osd()) {
     configure->osd_perf_metric_queries =
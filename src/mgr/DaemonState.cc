@@ -396,7 +396,14 @@ void DaemonPerfCounters::update(const MMgrReport& report)
 
   // Parse packed data according to declared set of types
   auto p = report.packed.cbegin();
-  DECODE_START(1, p);
+  DECODE_START(2, p);
+  // from v2 on, only the counters flagged in here are included, the others
+  // did not change since the last report
+  PerfCounterChanges changed;
+  if (struct_v >= 2) {
+    decode(changed, p);
+  }
+  unsigned n = 0;
   for (const auto &t_path : session->declared_types) {
     const auto &t = types.at(t_path);
     auto instances_it = instances.find(t_path);
@@ -406,6 +413,13 @@ void DaemonPerfCounters::update(const MMgrReport& report)
     if (instances_it == instances.end()) {
       instances_it = instances.insert({t_path, t.type}).first;
     }
+    if (struct_v >= 2) {
+      unsigned i = n++;
+      if (!changed.test(i)) {
+	instances_it->second.repeat(now);
+	continue;
+      }
+    }
     uint64_t val = 0;
     uint64_t avgcount = 0;
     uint64_t avgcount2 = 0;
@@ -427,6 +441,18 @@ void PerfCounterInstance::push(utime_t t, uint64_t const &v)
   buffer.push_back({t, v});
 }
 
+void PerfCounterInstance::repeat(utime_t t)
+{
+  // keep the time series going, so that rates computed from the last two
+  // points drop to zero
+  if (!buffer.empty()) {
+    buffer.push_back({t, buffer.back().v});
+  }
+  if (!avg_buffer.empty()) {
+    avg_buffer.push_back({t, avg_buffer.back().s, avg_buffer.back().c});
+  }
+}
+
 void PerfCounterInstance::push_avg(utime_t t, uint64_t const &s,
                                    uint64_t const &c)
 {
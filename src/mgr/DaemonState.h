@@ -81,6 +81,8 @@ class PerfCounterInstance
   }
   void push(utime_t t, uint64_t const &v);
   void push_avg(utime_t t, uint64_t const &s, uint64_t const &c);
+  /// the value has not changed since the last point
+  void repeat(utime_t t);
 
   PerfCounterInstance(enum perfcounter_type_d type)
   {
@@ -349,11 +349,17 @@ void MgrClient::_send_report()
       session->declared.erase(path);
     };
 
-    ENCODE_START(1, 1, report->packed);
+    // With deltas, a bitmap of the counters whose values follow comes
+    // first, so the values are collected aside.
+    const bool deltas = session->perf_counter_deltas;
+    PerfCounterChanges changed;
+    bufferlist values;
+    unsigned num_changed = 0;
+    ENCODE_START(deltas ? 2 : 1, deltas ? 2 : 1, report->packed);
 
     // Find counters that no longer exist, and undeclare them
     for (auto p = session->declared.begin(); p != session->declared.end(); ) {
-      const auto &path = *(p++);
+      const auto &path = (p++)->first;
       if (by_path.count(path) == 0) {
         undeclare(path);
       }
@@ -373,7 +379,9 @@ void MgrClient::_send_report()
         continue;
       }
 
-      if (session->declared.count(path) == 0) {
+      auto last = session->declared.find(path);
+      bool fresh = last == session->declared.end();
+      if (fresh) {
         ldout(cct, 20) << " declare " << path << dendl;
         PerfCounterType type;
         type.path = path;
@@ -387,18 +395,39 @@ void MgrClient::_send_report()
         type.priority = perf_counters.get_adjusted_priority(data.prio);
         type.unit = data.unit;
         report->declare_types.push_back(std::move(type));
-        session->declared.insert(path);
+        last = session->declared.emplace(path, std::make_pair(0, 0)).first;
       }
 
-      encode(static_cast<uint64_t>(data.u64), report->packed);
+      std::pair<uint64_t, uint64_t> value;
       if (data.type & PERFCOUNTER_LONGRUNAVG) {
-        encode(static_cast<uint64_t>(data.avgcount), report->packed);
-        encode(static_cast<uint64_t>(data.avgcount2), report->packed);
+        value = data.read_avg();
+      } else {
+        value = {data.read(), 0};
       }
+      if (deltas) {
+        bool c = fresh || last->second != value;
+        changed.push_back(c);
+        if (!c) {
+          continue;
+        }
+      }
+      last->second = value;
+      num_changed++;
+      auto& bl = deltas ? values : report->packed;
+      encode(value.first, bl);
+      if (data.type & PERFCOUNTER_LONGRUNAVG) {
+        encode(value.second, bl);
+        encode(value.second, bl);
+      }
+    }
+    if (deltas) {
+      encode(changed, report->packed);
+      report->packed.claim_append(values);
     }
     ENCODE_FINISH(report->packed);
 
-    ldout(cct, 20) << "sending " << session->declared.size() << " counters ("
+    ldout(cct, 20) << "sending " << num_changed << "/"
+                   << session->declared.size() << " counters ("
                       "of possible " << by_path.size() << "), "
 		   << report->declare_types.size() << " new, "
                    << report->undeclare_types.size() << " removed"
@@ -474,6 +503,8 @@ bool MgrClient::handle_mgr_configure(ref_t<MMgrConfigure> m)
     boost::apply_visitor(HandlePayloadVisitor(this), message.payload);
   }
 
+  session->perf_counter_deltas = m->perf_counter_deltas;
+
   bool starting = (stats_period == 0) && (m->stats_period != 0);
   stats_period = m->stats_period;
   if (starting) {
@@ -40,8 +40,12 @@ class MonMap;
 class MgrSessionState
 {
   public:
-  // Which performance counters have we already transmitted schema for?
-  std::set<std::string> declared;
+  // Which performance counters have we already transmitted schema for,
+  // and the last value (sum and count for averages) we sent for them
+  std::map<std::string, std::pair<uint64_t, uint64_t>> declared;
+
+  // Does the mgr accept reports leaving out unchanged counters?
+  bool perf_counter_deltas = false;
 
   // Our connection to the mgr
   ConnectionRef con;
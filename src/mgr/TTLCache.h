@@ -18,7 +18,10 @@ template <class Key, class Value> class Cache {
   unsigned int capacity;
   Cache(unsigned int size = UINT16_MAX) : hits{0}, misses{0}, capacity{size} {};
   std::map<Key, Value> content;
-  std::vector<std::string> allowed_keys = {"osd_map", "pg_dump", "pg_stats"};
+  std::vector<std::string> allowed_keys = {
+    "osd_map", "osd_map_tree", "osd_map_crush",
+    "pg_dump", "pg_stats", "pg_summary", "pg_status",
+    "osd_stats", "pool_stats", "df", "osd_pool_stats"};
 
   void mark_miss() {
     misses++;
@@ -78,7 +81,6 @@ class TTLCacheBase : public Cache<Key, std::pair<Value, ttl_time_point>> {
  protected:
   Value get_value(Key key, bool count_hit = true);
   ttl_time_point get_value_time_point(Key key);
-  bool exists(Key key);
   bool expired(Key key);
   void finish_get(Key key);
   void finish_erase(Key key);
@@ -93,6 +95,7 @@ class TTLCacheBase : public Cache<Key, std::pair<Value, ttl_time_point>> {
   Value get(Key key);
   void erase(Key key);
   void clear();
+  bool exists(Key key);
   uint16_t get_ttl() { return ttl; };
   void set_ttl(uint16_t ttl);
 };
@@ -83,6 +83,8 @@ private:
   ConnectionRef con;
   bool forwarded_to_leader;
   op_type_t op_type;
+  /// how stale a read-only reply from a peon may be, past its paxos lease
+  ceph::timespan max_staleness = ceph::timespan::zero();
 
   MonOpRequest(Message *req, OpTracker *tracker) :
     TrackedOp(tracker,
@@ -205,6 +207,13 @@ public:
   bool is_type_command() {
     return (get_op_type() == OP_TYPE_COMMAND);
   }
+
+  void set_max_staleness(ceph::timespan s) {
+    max_staleness = s;
+  }
+  ceph::timespan get_max_staleness() const {
+    return max_staleness;
+  }
 };
 
 typedef MonOpRequest::Ref MonOpRequestRef;
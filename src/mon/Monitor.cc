@@ -3445,6 +3445,25 @@ void Monitor::handle_command(MonOpRequestRef op)
     }
   }
 
+  if (!is_leader() && cct->_conf->mon_command_max_staleness > 0) {
+    // the caller may let us answer a read from our own committed state
+    // for a while after our lease lapsed instead of waiting on paxos
+    double max_staleness = 0;
+    if (auto p = cmdmap.find("max_staleness"); p != cmdmap.end()) {
+      if (auto d = boost::get<double>(&p->second); d) {
+	max_staleness = *d;
+      } else if (auto i = boost::get<int64_t>(&p->second); i) {
+	max_staleness = *i;
+      }
+    }
+    max_staleness = std::min(max_staleness,
+			     cct->_conf->mon_command_max_staleness);
+    if (max_staleness > 0) {
+      op->set_max_staleness(ceph::to_timespan(
+	ceph::make_timespan(max_staleness)));
+    }
+  }
+
   if (mon_cmd->is_obsolete() ||
       (cct->_conf->mon_debug_deprecated_as_obsolete
        && mon_cmd->is_deprecated())) {
@@ -5302,7 +5321,8 @@ void Monitor::handle_subscribe(MonOpRequestRef op)
       std::lock_guard l(session_map_lock);
       session_map.add_update_sub(s, p->first, p->second.start,
 				 p->second.flags & CEPH_SUBSCRIBE_ONETIME,
-				 m->get_connection()->has_feature(CEPH_FEATURE_INCSUBOSDMAP));
+				 m->get_connection()->has_feature(CEPH_FEATURE_INCSUBOSDMAP),
+				 p->second.flags & CEPH_SUBSCRIBE_SQUASH);
     }
 
     if (p->first.compare(0, 6, "mdsmap") == 0 || p->first.compare(0, 5, "fsmap") == 0) {
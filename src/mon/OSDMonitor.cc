@@ -462,8 +462,12 @@ OSDMonitor::OSDMonitor(
    cct(cct),
    inc_osd_cache(g_conf()->mon_osd_cache_size),
    full_osd_cache(g_conf()->mon_osd_cache_size),
+   squashed_osd_cache(g_conf().get_val<uint64_t>("mon_osdmap_squash_cache_size")),
    has_osdmap_manifest(false),
-   mapper(mn.cct, &mn.cpu_tp)
+   mapper(mn.cct, &mn.cpu_tp),
+   encode_wq("OSDMonitor::encode_wq",
+	     ceph::make_timespan(mn.cct->_conf->threadpool_default_timeout),
+	     &mn.cpu_tp)
 {
   inc_cache = std::make_shared<IncCache>(this);
   full_cache = std::make_shared<FullCache>(this);
@@ -2000,6 +2004,7 @@ void OSDMonitor::encode_pending(MonitorDBStore::TransactionRef t)
 
   // encode full map and determine its crc
   OSDMap tmp;
+  health_check_map_t next;
   {
     tmp.deepish_copy_from(osdmap);
     tmp.apply_incremental(pending_inc);
@@ -2013,8 +2018,23 @@ void OSDMonitor::encode_pending(MonitorDBStore::TransactionRef t)
     // the features should be a subset of the mon quorum's features!
     ceph_assert((features & ~mon.get_quorum_con_features()) == 0);
 
+    // on a big cluster the full map runs into megabytes; encode it on
+    // the cpu_tp while we check the health of the new map.  both only read
+    // tmp, and check_health() does not look at the crc.
     bufferlist fullbl;
-    encode(tmp, fullbl, features | CEPH_FEATURE_RESERVED);
+    if (mon.cpu_tp.get_num_threads() > 0) {
+      C_SaferCond encoded;
+      encode_wq.queue(make_gen_lambda_context<ThreadPool::TPHandle&>(
+	[&](ThreadPool::TPHandle&) {
+	  encode(tmp, fullbl, features | CEPH_FEATURE_RESERVED);
+	  encoded.complete(0);
+	}).release());
+      tmp.check_health(cct, &next);
+      encoded.wait();
+    } else {
+      encode(tmp, fullbl, features | CEPH_FEATURE_RESERVED);
+      tmp.check_health(cct, &next);
+    }
     pending_inc.full_crc = tmp.get_crc();
 
     // include full map in the txn.  note that old monitors will
@@ -2074,8 +2094,6 @@ void OSDMonitor::encode_pending(MonitorDBStore::TransactionRef t)
   }
 
   // health
-  health_check_map_t next;
-  tmp.check_health(cct, &next);
   encode_health(next, t);
 }
 
@@ -4479,6 +4497,56 @@ MOSDMap *OSDMonitor::build_incremental(epoch_t from, epoch_t to, uint64_t featur
   return m;
 }
 
+MOSDMap *OSDMonitor::build_squashed_incremental(epoch_t from, epoch_t to,
+						 uint64_t features)
+{
+  const auto max_epochs =
+    g_conf().get_val<uint64_t>("mon_osdmap_squash_max_epochs");
+  if (to <= from || to - from >= max_epochs ||
+      !HAVE_FEATURE(features, SERVER_NAUTILUS)) {
+    return nullptr;
+  }
+  uint64_t significant_features = OSDMap::get_significant_features(features);
+  bufferlist bl;
+  if (!squashed_osd_cache.lookup({{from, to}, significant_features}, &bl)) {
+    OSDMap::Incremental squashed;
+    for (epoch_t e = from; e <= to; e++) {
+      bufferlist inc_bl;
+      if (get_version(e, features, inc_bl) < 0) {
+	// only a full map was stored for this one
+	break;
+      }
+      OSDMap::Incremental inc;
+      auto p = inc_bl.cbegin();
+      inc.decode(p);
+      if (e == from) {
+	squashed = std::move(inc);
+      } else if (!squashed.squash(inc)) {
+	dout(10) << __func__ << " [" << from << ".." << to << "] can not squash "
+		 << e << dendl;
+	break;
+      }
+    }
+    if (squashed.epoch == to) {
+      squashed.encode(bl, (features & squashed.encode_features) |
+		      CEPH_FEATURE_RESERVED);
+    }
+    // remember the ranges we failed at, too
+    squashed_osd_cache.add({{from, to}, significant_features}, bl);
+  }
+  if (!bl.length()) {
+    return nullptr;
+  }
+  dout(10) << __func__ << " [" << from << ".." << to << "] " << bl.length()
+	   << " bytes" << dendl;
+  MOSDMap *m = new MOSDMap(mon.monmap->fsid, features);
+  m->cluster_osdmap_trim_lower_bound = get_first_committed();
+  m->newest_map = osdmap.get_epoch();
+  // keyed by the first epoch it covers, as it applies on top of from - 1
+  m->incremental_maps[from] = std::move(bl);
+  return m;
+}
+
 void OSDMonitor::send_full(MonOpRequestRef op)
 {
   op->mark_osdmon_event(__func__);
@@ -4510,7 +4578,8 @@ void OSDMonitor::send_incremental(MonOpRequestRef op, epoch_t first)
 void OSDMonitor::send_incremental(epoch_t first,
 				  MonSession *session,
 				  bool onetime,
-				  MonOpRequestRef req)
+				  MonOpRequestRef req,
+				  bool squash)
 {
   dout(5) << "send_incremental [" << first << ".." << osdmap.get_epoch() << "]"
 	  << " to " << session->name << dendl;
@@ -4554,7 +4623,15 @@ void OSDMonitor::send_incremental(epoch_t first,
   while (first <= osdmap.get_epoch()) {
     epoch_t last = std::min<epoch_t>(first + g_conf()->osd_map_message_max - 1,
 				     osdmap.get_epoch());
-    MOSDMap *m = build_incremental(first, last, features);
+    MOSDMap *m = nullptr;
+    if (squash) {
+      m = build_squashed_incremental(first, osdmap.get_epoch(), features);
+    }
+    if (m) {
+      last = osdmap.get_epoch();
+    } else {
+      m = build_incremental(first, last, features);
+    }
 
     if (req) {
       // send some maps.  it may not be all of them, but it will get them
@@ -4838,7 +4915,8 @@ void OSDMonitor::check_osdmap_sub(Subscription *sub)
 	   << (sub->onetime ? " (onetime)":" (ongoing)") << dendl;
   if (sub->next <= osdmap.get_epoch()) {
     if (sub->next >= 1)
-      send_incremental(sub->next, sub->session, sub->incremental_onetime);
+      send_incremental(sub->next, sub->session, sub->incremental_onetime,
+		       MonOpRequestRef(), sub->squash);
     else
       sub->session->con->send_message(build_latest_full(sub->session->con_features));
     if (sub->onetime)
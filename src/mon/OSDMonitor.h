@@ -29,6 +29,7 @@
 #include "include/types.h"
 #include "include/encoding.h"
 #include "common/simple_cache.hpp"
+#include "common/WorkQueue.h"
 #include "common/PriorityCache.h"
 #include "msg/Messenger.h"
 
@@ -230,6 +231,12 @@ public:
                                    boost::hash<osdmap_key_t>>;
   osdmap_cache_t inc_osd_cache;
   osdmap_cache_t full_osd_cache;
+  /// squashed incrementals by ((first, last), features)
+  using squashed_key_t = std::pair<std::pair<epoch_t, epoch_t>, uint64_t>;
+  SimpleLRU<squashed_key_t,
+	    ceph::buffer::list,
+	    std::less<squashed_key_t>,
+	    boost::hash<squashed_key_t>> squashed_osd_cache;
 
   bool has_osdmap_manifest;
   osdmap_manifest_t osdmap_manifest;
@@ -381,6 +388,7 @@ private:
   void prime_pg_temp(const OSDMap& next, pg_t pgid);
 
   ParallelPGMapper mapper;                        ///< for background pg work
+  GenContextWQ encode_wq;                         ///< for encoding pending maps
   OSDMapMapping mapping;                          ///< pg <-> osd mappings
   std::unique_ptr<ParallelPGMapper::Job> mapping_job;  ///< background mapping job
   void start_mapping();
@@ -402,6 +410,9 @@ private:
   // ...
   MOSDMap *build_latest_full(uint64_t features);
   MOSDMap *build_incremental(epoch_t first, epoch_t last, uint64_t features);
+  /// one incremental taking a client from first - 1 to last, or nullptr
+  MOSDMap *build_squashed_incremental(epoch_t first, epoch_t last,
+				      uint64_t features);
   void send_full(MonOpRequestRef op);
   void send_incremental(MonOpRequestRef op, epoch_t first);
 public:
@@ -413,8 +424,11 @@ public:
   int check_cluster_features(uint64_t features, std::stringstream &ss);
   // @param req an optional op request, if the osdmaps are replies to it. so
   //            @c Monitor::send_reply() can mark_event with it.
+  // @param squash the session can take the whole range as one squashed
+  //               incremental
   void send_incremental(epoch_t first, MonSession *session, bool onetime,
-			MonOpRequestRef req = MonOpRequestRef());
+			MonOpRequestRef req = MonOpRequestRef(),
+			bool squash = false);
 
 private:
   void print_utilization(std::ostream &out, ceph::Formatter *f, bool tree) const;
@@ -1134,14 +1134,22 @@ void PGMap::apply_incremental(CephContext *cct, const Incremental& inc)
 
     auto pg_stat_iter = pg_stat.find(update_pg);
     pool_stat_t &pool_sum_ref = pg_pool_sum[update_pool];
+    // most updates leave the mapping alone, no need to redo pg_by_osd
+    bool sameosds = false;
     if (pg_stat_iter == pg_stat.end()) {
       pg_stat.insert(make_pair(update_pg, update_stat));
     } else {
-      stat_pg_sub(update_pg, pg_stat_iter->second);
-      pool_sum_ref.sub(pg_stat_iter->second);
+      const pg_stat_t &old_stat = pg_stat_iter->second;
+      sameosds =
+	old_stat.up == update_stat.up &&
+	old_stat.acting == update_stat.acting &&
+	old_stat.up_primary == update_stat.up_primary &&
+	old_stat.blocked_by == update_stat.blocked_by;
+      stat_pg_sub(update_pg, old_stat, sameosds);
+      pool_sum_ref.sub(old_stat);
       pg_stat_iter->second = update_stat;
     }
-    stat_pg_add(update_pg, update_stat);
+    stat_pg_add(update_pg, update_stat, sameosds);
     pool_sum_ref.add(update_stat);
   }
 
@@ -1317,6 +1317,10 @@ void Paxos::cancel_events()
     mon.timer.cancel_event(lease_timeout_event);
     lease_timeout_event = 0;
   }
+  if (group_commit_event) {
+    mon.timer.cancel_event(group_commit_event);
+    group_commit_event = 0;
+  }
 }
 
 void Paxos::shutdown()
@@ -1478,7 +1482,7 @@ void Paxos::dispatch(MonOpRequestRef op)
 
 // -- READ --
 
-bool Paxos::is_readable(version_t v)
+bool Paxos::is_readable(version_t v, ceph::timespan max_staleness)
 {
   bool ret;
   if (v > last_committed)
@@ -1487,10 +1491,11 @@ bool Paxos::is_readable(version_t v)
     ret =
       (mon.is_peon() || mon.is_leader()) &&
       (is_active() || is_updating() || is_writing()) &&
-      last_committed > 0 && is_lease_valid(); // must have a value alone, or have lease
+      last_committed > 0 && is_lease_valid(max_staleness); // must have a value alone, or have lease
   dout(5) << __func__ << " = " << (int)ret
 	  << " - now=" << ceph_clock_now()
 	  << " lease_expire=" << lease_expire
+	  << " max_staleness=" << max_staleness
 	  << " has v" << v << " lc " << last_committed
 	  << dendl;
   return ret;
@@ -1511,10 +1516,10 @@ version_t Paxos::read_current(bufferlist &bl)
 }
 
 
-bool Paxos::is_lease_valid()
+bool Paxos::is_lease_valid(ceph::timespan grace)
 {
   return ((mon.get_quorum().size() == 1)
-	  || (ceph::real_clock::now() < lease_expire));
+	  || (ceph::real_clock::now() < lease_expire + grace));
 }
 
 // -- WRITE --
@@ -1575,6 +1580,24 @@ bool Paxos::trigger_propose()
     dout(10) << __func__ << " plugged, not proposing now" << dendl;
     return false;
   } else if (is_active()) {
+    double window = g_conf()->paxos_group_commit_window;
+    if (window > 0) {
+      if (!group_commit_event) {
+	dout(10) << __func__ << " active, proposing in " << window << "s"
+		 << dendl;
+	group_commit_event = mon.timer.add_event_after(
+	  window,
+	  new C_MonContext{&mon, [this](int r) {
+	      group_commit_event = 0;
+	      if (r == -ECANCELED)
+		return;
+	      if (!plugged && is_active() && pending_proposal) {
+		propose_pending();
+	      }
+	    }});
+      }
+      return false;
+    }
     dout(10) << __func__ << " active, proposing now" << dendl;
     propose_pending();
     return true;
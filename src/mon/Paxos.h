@@ -564,6 +564,11 @@ private:
    * may not have the latest committed value.
    */
   Context    *accept_timeout_event;
+  /**
+   * Proposal delayed by paxos_group_commit_window, so that changes other
+   * services make shortly after go out in the same round.
+   */
+  Context    *group_commit_event = nullptr;
 
   /**
    * List of callbacks waiting for it to be possible to write again.
@@ -1254,9 +1259,12 @@ public:
    *  @li we do not have a valid lease
    *
    * @param seen The version we want to check if it is readable.
+   * @param max_staleness How long past the lease expiration the caller
+   *			  is still willing to read our committed state.
    * @return 'true' if the version is readable; 'false' otherwise.
    */
-  bool is_readable(version_t seen=0);
+  bool is_readable(version_t seen=0,
+		   ceph::timespan max_staleness = ceph::timespan::zero());
   /**
    * Read version @e v and store its value in @e bl
    *
@@ -1295,9 +1303,10 @@ public:
   /**
    * Check if we have a valid lease.
    *
+   * @param grace Treat a lease expired less than this long ago as valid.
    * @returns true if the lease is still valid; false otherwise.
    */
-  bool is_lease_valid();
+  bool is_lease_valid(ceph::timespan grace = ceph::timespan::zero());
   // write
   /**
    * @defgroup Paxos_h_write_funcs Write-related functions
@@ -1353,6 +1362,8 @@ public:
    * Tell paxos that it should submit the pending proposal.  Note that if it
    * is not active (e.g., because it is already in the midst of committing
    * something) that will be deferred (e.g., until the current round finishes).
+   * With paxos_group_commit_window set, an idle paxos waits that long
+   * before proposing, to take in changes from other services as well.
    */
   bool trigger_propose();
   /**
@@ -68,8 +68,9 @@ bool PaxosService::dispatch(MonOpRequestRef op)
     return true;
   }
 
-  // make sure our map is readable and up to date
-  if (!is_readable(m->version)) {
+  // make sure our map is readable and up to date.  a peon may answer a
+  // query from a lapsed lease if the client said it can live with that.
+  if (!is_readable(m->version, op->get_max_staleness())) {
     dout(10) << " waiting for paxos -> readable (v" << m->version << ")" << dendl;
     wait_for_readable(op, new C_RetryMessage(this, op), m->version);
     return true;
@@ -524,11 +524,13 @@ public:
    *  - we have committed our initial state (last_committed > 0)
    *
    * @param ver The version we want to check if is readable
+   * @param max_staleness How long past the paxos lease we may still serve
    * @returns true if it is readable; false otherwise
    */
-  bool is_readable(version_t ver = 0) const {
+  bool is_readable(version_t ver = 0,
+		   ceph::timespan max_staleness = ceph::timespan::zero()) const {
     if (ver > get_last_committed() ||
-	!paxos.is_readable(0) ||
+	!paxos.is_readable(0, max_staleness) ||
 	get_last_committed() == 0)
       return false;
     return true;
@@ -39,6 +39,7 @@ struct Subscription {
   version_t next;
   bool onetime;
   bool incremental_onetime;  // has CEPH_FEATURE_INCSUBOSDMAP
+  bool squash = false;       // CEPH_SUBSCRIBE_SQUASH
   
   Subscription(MonSession *s, const std::string& t) : session(s), type(t), type_item(this),
 						 next(0), onetime(false), incremental_onetime(false) {}
@@ -257,7 +258,8 @@ struct MonSessionMap {
     return s;
   }
 
-  void add_update_sub(MonSession *s, const std::string& what, version_t start, bool onetime, bool incremental_onetime) {
+  void add_update_sub(MonSession *s, const std::string& what, version_t start, bool onetime, bool incremental_onetime,
+		      bool squash = false) {
     Subscription *sub = 0;
     if (s->sub_map.count(what)) {
       sub = s->sub_map[what];
@@ -272,6 +274,7 @@ struct MonSessionMap {
     sub->next = start;
     sub->onetime = onetime;
     sub->incremental_onetime = onetime && incremental_onetime;
+    sub->squash = squash;
   }
 
   void remove_sub(Subscription *sub) {
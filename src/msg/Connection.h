@@ -57,6 +57,9 @@ public:
 
   int rx_buffers_version = 0;
   std::map<ceph_tid_t,std::pair<ceph::buffer::list, int>> rx_buffers;
+  /// tid whose rx buffer the messenger is writing into right now (0 if none)
+  ceph_tid_t rx_buffer_in_use = 0;
+  ceph::condition_variable rx_buffer_cond;
 
   // authentication state
   // FIXME make these private after ms_handle_authorizer is removed
@@ -207,19 +210,60 @@ public:
     return CEPH_CON_MODE_CRC;
   }
 
+  /**
+   * Offer a buffer the data payload of the reply to tid may be received
+   * into directly.  Only protocols that can do so (msgr2 in crc mode)
+   * look at it; everybody else keeps allocating their own buffers.
+   */
   void post_rx_buffer(ceph_tid_t tid, ceph::buffer::list& bl) {
-#if 0
     std::lock_guard l{lock};
     ++rx_buffers_version;
-    rx_buffers[tid] = pair<bufferlist,int>(bl, rx_buffers_version);
-#endif
+    rx_buffers[tid] = std::pair<ceph::buffer::list,int>(bl, rx_buffers_version);
   }
 
+  /**
+   * Take back a buffer handed out with post_rx_buffer().  If the messenger
+   * is writing into it at the moment, wait for that step of the read to
+   * end; the messenger never writes into a buffer again once it has been
+   * revoked, so the owner can safely reuse (or free) the memory once we
+   * return.
+   */
   void revoke_rx_buffer(ceph_tid_t tid) {
-#if 0
-    std::lock_guard l{lock};
+    std::unique_lock l{lock};
     rx_buffers.erase(tid);
-#endif
+    rx_buffer_cond.wait(l, [this, tid] { return rx_buffer_in_use != tid; });
+  }
+
+  /// messenger side: start reading into the rx buffer posted for tid, if any
+  bool claim_rx_buffer(ceph_tid_t tid, ceph::buffer::list *bl) {
+    std::lock_guard l{lock};
+    auto p = rx_buffers.find(tid);
+    if (p == rx_buffers.end()) {
+      return false;
+    }
+    *bl = p->second.first;
+    rx_buffer_in_use = tid;
+    return true;
+  }
+
+  /// messenger side: continue a read into the rx buffer claimed for tid
+  /// unless it has been revoked in the meantime
+  bool resume_rx_buffer(ceph_tid_t tid) {
+    std::lock_guard l{lock};
+    if (!rx_buffers.count(tid)) {
+      return false;
+    }
+    rx_buffer_in_use = tid;
+    return true;
+  }
+
+  /// messenger side: stop writing into the claimed rx buffer (for now)
+  void release_rx_buffer() {
+    std::lock_guard l{lock};
+    if (rx_buffer_in_use) {
+      rx_buffer_in_use = 0;
+      rx_buffer_cond.notify_all();
+    }
   }
 
   utime_t get_last_keepalive() const {
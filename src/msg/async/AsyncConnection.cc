@@ -470,7 +470,10 @@ void AsyncConnection::process() {
 
     case STATE_CONNECTION_ESTABLISHED: {
       if (pendingReadLen) {
-        ssize_t r = read(*pendingReadLen, read_buffer, readCallback);
+        char *buf = protocol->resume_read(read_buffer, state_offset);
+        ssize_t r = read(*pendingReadLen, buf, readCallback);
+        protocol->suspend_read();
+        read_buffer = buf;
         if (r <= 0) { // read all bytes, or an error occured
           pendingReadLen.reset();
           char *buf_tmp = read_buffer;
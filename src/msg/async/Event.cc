@@ -385,7 +385,10 @@ int EventCenter::process_time_events()
   return processed;
 }
 
-int EventCenter::process_events(unsigned timeout_microseconds,  ceph::timespan *working_dur)
+int EventCenter::process_events(unsigned timeout_microseconds,
+                                ceph::timespan *working_dur,
+                                ceph::timespan *spin_dur,
+                                ceph::timespan *sleep_dur)
 {
   struct timeval tv;
   int numevents;
@@ -408,12 +411,45 @@ int EventCenter::process_events(unsigned timeout_microseconds,  ceph::timespan *
   bool blocking = pollers.empty() && !external_num_events.load();
   if (!blocking)
     timeout_microseconds = 0;
-  tv.tv_sec = timeout_microseconds / 1000000;
-  tv.tv_usec = timeout_microseconds % 1000000;
 
-  ldout(cct, 30) << __func__ << " wait second " << tv.tv_sec << " usec " << tv.tv_usec << dendl;
   std::vector<FiredFileEvent> fired_events;
-  numevents = driver->event_wait(fired_events, &tv);
+  numevents = 0;
+  bool spun = false;
+  if (busy_poll.count() && timeout_microseconds) {
+    spun = true;
+    // spin on the driver for a while, new events are then picked up
+    // without a wakeup and context switch
+    struct timeval zero = {0, 0};
+    auto spin_start = ceph::mono_clock::now();
+    auto spin_end = spin_start + std::min<std::chrono::microseconds>(
+      busy_poll, std::chrono::microseconds(timeout_microseconds));
+    auto spin_now = spin_start;
+    do {
+      numevents = driver->event_wait(fired_events, &zero);
+      spin_now = ceph::mono_clock::now();
+    } while (numevents == 0 && !external_num_events.load() &&
+             spin_now < spin_end);
+    if (spin_dur)
+      *spin_dur = spin_now - spin_start;
+    if (numevents || external_num_events.load()) {
+      timeout_microseconds = 0;
+    } else {
+      timeout_microseconds -= std::min<uint64_t>(
+        timeout_microseconds,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+          spin_now - spin_start).count());
+    }
+  }
+  if (!spun || (numevents == 0 && timeout_microseconds)) {
+    tv.tv_sec = timeout_microseconds / 1000000;
+    tv.tv_usec = timeout_microseconds % 1000000;
+
+    ldout(cct, 30) << __func__ << " wait second " << tv.tv_sec << " usec " << tv.tv_usec << dendl;
+    auto sleep_start = ceph::mono_clock::now();
+    numevents = driver->event_wait(fired_events, &tv);
+    if (sleep_dur)
+      *sleep_dur = ceph::mono_clock::now() - sleep_start;
+  }
   auto working_start = ceph::mono_clock::now();
   for (int event_id = 0; event_id < numevents; event_id++) {
     int rfired = 0;
@@ -179,6 +179,8 @@ class EventCenter {
   EventCallbackRef notify_handler;
   unsigned center_id;
   AssociatedCenters *global_centers = nullptr;
+  /// how long to poll the driver before blocking in it
+  std::chrono::microseconds busy_poll{0};
 
   int process_time_events();
   FileEvent *_get_file_event(int fd) {
@@ -200,6 +202,7 @@ class EventCenter {
   void set_owner();
   pthread_t get_owner() const { return owner; }
   unsigned get_id() const { return center_id; }
+  void set_busy_poll(std::chrono::microseconds window) { busy_poll = window; }
 
   EventDriver *get_driver() { return driver; }
 
@@ -208,7 +211,10 @@ class EventCenter {
   uint64_t create_time_event(uint64_t microseconds, EventCallbackRef ctxt);
   void delete_file_event(int fd, int mask);
   void delete_time_event(uint64_t id);
-  int process_events(unsigned timeout_microseconds, ceph::timespan *working_dur = nullptr);
+  int process_events(unsigned timeout_microseconds,
+                     ceph::timespan *working_dur = nullptr,
+                     ceph::timespan *spin_dur = nullptr,
+                     ceph::timespan *sleep_dur = nullptr);
   void wakeup();
 
   // Used by external thread
@@ -15,7 +15,9 @@
  */
 
 #include "common/errno.h"
+#include <algorithm>
 #include <fcntl.h>
+#include <sys/ioctl.h>
 #include "EventEpoll.h"
 
 #define dout_subsys ceph_subsys_ms
@@ -46,6 +48,22 @@ int EpollDriver::init(EventCenter *c, int nevent)
     return -e;
   }
 
+#ifdef EPIOCSPARAMS
+  // the sockets are non-blocking and only waited on here, so this is where
+  // busy polling has to be asked for (linux 6.9+); otherwise it takes the
+  // net.core.busy_poll sysctl
+  if (auto busy_poll = cct->_conf.get_val<uint64_t>("ms_tcp_busy_poll_us");
+      busy_poll > 0) {
+    struct epoll_params params = {};
+    params.busy_poll_usecs = std::min<uint64_t>(busy_poll, UINT32_MAX);
+    params.busy_poll_budget = 8; // the kernel's default budget
+    if (::ioctl(epfd, EPIOCSPARAMS, &params) == -1) {
+      lderr(cct) << __func__ << " unable to set epoll busy poll to "
+                 << busy_poll << "us: " << cpp_strerror(errno) << dendl;
+    }
+  }
+#endif
+
   this->nevent = nevent;
 
   return 0;
@@ -132,6 +132,12 @@ public:
   virtual void write_event() = 0;
   virtual bool is_queued() = 0;
 
+  // bracket each step of a read that did not complete synchronously; lets
+  // the protocol swap in another buffer for the rest of the read (done is
+  // the number of bytes already received into buf)
+  virtual char *resume_read(char *buf, unsigned done) { return buf; }
+  virtual void suspend_read() {}
+
   int get_con_mode() const {
     return auth_meta->con_mode;
   }
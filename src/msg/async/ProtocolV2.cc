@@ -154,6 +154,7 @@ void ProtocolV2::reset_session() {
   connection->dispatch_queue->discard_queue(connection->conn_id);
   discard_out_queue();
   connection->outgoing_bl.clear();
+  tx_batch_messages = 0;
 
   connection->dispatch_queue->queue_remote_reset(connection);
 
@@ -266,6 +267,7 @@ void ProtocolV2::reset_recv_state() {
   // clean read and write callbacks
   connection->pendingReadLen.reset();
   connection->writeCallback.reset();
+  release_rx_buffer();
 
   next_tag = static_cast<Tag>(0);
 
@@ -556,19 +558,24 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
                  << " src=" << entity_name_t(messenger->get_myname())
                  << " off=" << header2.data_off
                  << dendl;
-  ssize_t total_send_size = connection->outgoing_bl.length();
-  ssize_t rc = connection->_try_send(more);
-  if (rc < 0) {
-    ldout(cct, 1) << __func__ << " error sending " << m << ", "
-                  << cpp_strerror(rc) << dendl;
+  ++tx_batch_messages;
+  ssize_t rc = 0;
+  if (more && !tx_batch_full()) {
+    // more messages are ready to go; let them join this one in a single
+    // sendmsg instead of pushing out each frame on its own
+    ldout(cct, 20) << __func__ << " batching " << m << ", "
+                   << tx_batch_messages << " messages "
+                   << connection->outgoing_bl.length() << " bytes pending"
+                   << dendl;
   } else {
-    const auto sent_bytes = total_send_size - connection->outgoing_bl.length();
-    connection->logger->inc(l_msgr_send_bytes, sent_bytes);
-    if (session_stream_handlers.tx) {
-      connection->logger->inc(l_msgr_send_encrypted_bytes, sent_bytes);
+    rc = flush_outgoing(more);
+    if (rc < 0) {
+      ldout(cct, 1) << __func__ << " error sending " << m << ", "
+                    << cpp_strerror(rc) << dendl;
+    } else {
+      ldout(cct, 10) << __func__ << " sending " << m
+                     << (rc ? " continuely." : " done.") << dendl;
     }
-    ldout(cct, 10) << __func__ << " sending " << m
-                   << (rc ? " continuely." : " done.") << dendl;
   }
 
 #if defined(WITH_EVENTTRACE)
@@ -582,6 +589,29 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
   return rc;
 }
 
+bool ProtocolV2::tx_batch_full() const {
+  const auto& outgoing_bl = connection->outgoing_bl;
+  return outgoing_bl.length() >= cct->_conf->ms_async_send_batch_bytes ||
+         outgoing_bl.get_num_buffers() >= cct->_conf->ms_async_send_batch_iovs;
+}
+
+ssize_t ProtocolV2::flush_outgoing(bool more) {
+  ssize_t total_send_size = connection->outgoing_bl.length();
+  ssize_t rc = connection->_try_send(more);
+  if (rc >= 0) {
+    const auto sent_bytes = total_send_size - connection->outgoing_bl.length();
+    connection->logger->inc(l_msgr_send_bytes, sent_bytes);
+    if (session_stream_handlers.tx) {
+      connection->logger->inc(l_msgr_send_encrypted_bytes, sent_bytes);
+    }
+  }
+  if (tx_batch_messages) {
+    connection->logger->inc(l_msgr_send_batch_messages, tx_batch_messages);
+    tx_batch_messages = 0;
+  }
+  return rc;
+}
+
 template <class F>
 bool ProtocolV2::append_frame(F& frame) {
   ceph::bufferlist bl;
@@ -656,7 +686,7 @@ void ProtocolV2::write_event() {
     auto start = ceph::mono_clock::now();
     bool more;
     do {
-      if (connection->is_queued()) {
+      if (connection->is_queued() && !tx_batch_messages) {
 	if (r = connection->_try_send(); r!= 0) {
 	  // either fails to send or not all queued buffer is sent
 	  break;
@@ -713,12 +743,12 @@ void ProtocolV2::write_event() {
         if (append_frame(ack_frame)) {
           ack_left -= left;
           left = ack_left;
-          r = connection->_try_send(left);
+          r = flush_outgoing(left);
         } else {
           r = -EILSEQ;
         }
       } else if (is_queued()) {
-        r = connection->_try_send();
+        r = flush_outgoing(false);
       }
     }
     connection->write_lock.unlock();
@@ -778,6 +808,7 @@ CtPtr ProtocolV2::read(CONTINUATION_RXBPTR_TYPE<ProtocolV2> &next,
       next.r = r;
       run_continuation(next);
     });
+  suspend_read();
   if (r <= 0) {
     // error or done synchronously
     if (unlikely(pre_auth.enabled) && r == 0) {
@@ -841,13 +872,27 @@ CtPtr ProtocolV2::write(const std::string &desc,
   return nullptr;
 }
 
+uint64_t ProtocolV2::get_supported_features() const {
+  uint64_t features = CEPH_MSGR2_SUPPORTED_FEATURES;
+  // only advertised when enabled, so that both ends agree on using it
+  if (!cct->_conf.get_val<bool>("ms_compression_stream")) {
+    features &= ~CEPH_MSGR2_FEATURE_COMPRESSION_STREAM;
+  }
+  return features;
+}
+
+bool ProtocolV2::is_compression_stream() const {
+  return HAVE_MSGR2_FEATURE(peer_supported_features, COMPRESSION_STREAM) &&
+    HAVE_MSGR2_FEATURE(get_supported_features(), COMPRESSION_STREAM);
+}
+
 CtPtr ProtocolV2::_banner_exchange(CtRef callback) {
   ldout(cct, 20) << __func__ << dendl;
   bannerExchangeCallback = &callback;
 
   ceph::bufferlist banner_payload;
   using ceph::encode;
-  encode((uint64_t)CEPH_MSGR2_SUPPORTED_FEATURES, banner_payload, 0);
+  encode(get_supported_features(), banner_payload, 0);
   encode((uint64_t)CEPH_MSGR2_REQUIRED_FEATURES, banner_payload, 0);
 
   ceph::bufferlist bl;
@@ -935,7 +980,7 @@ CtPtr ProtocolV2::_handle_peer_banner_payload(rx_buffer_t &&buffer, int r) {
 
   // Check feature bit compatibility
 
-  uint64_t supported_features = CEPH_MSGR2_SUPPORTED_FEATURES;
+  uint64_t supported_features = get_supported_features();
   uint64_t required_features = CEPH_MSGR2_REQUIRED_FEATURES;
 
   if ((required_features & peer_supported_features) != required_features) {
@@ -1187,25 +1232,123 @@ CtPtr ProtocolV2::read_frame_segment() {
   }
 
   rx_buffer_t rx_buffer;
-  uint16_t align = rx_frame_asm.get_segment_align(seg_idx);
-  try {
-    rx_buffer = ceph::buffer::ptr_node::create(ceph::buffer::create_aligned(
-        onwire_len, align));
-  } catch (const ceph::buffer::bad_alloc&) {
-    // Catching because of potential issues with satisfying alignment.
-    ldout(cct, 1) << __func__ << " can't allocate aligned rx_buffer"
-                  << " len=" << onwire_len
-                  << " align=" << align
-                  << dendl;
-    return _fault();
+  if (seg_idx == SegmentIndex::Msg::DATA && next_tag == Tag::MESSAGE) {
+    rx_buffer = claim_rx_buffer(onwire_len);
+    if (!rx_buffer) {
+      rx_buffer = alloc_data_rx_buffer(onwire_len);
+    }
+  }
+  if (!rx_buffer) {
+    uint16_t align = rx_frame_asm.get_segment_align(seg_idx);
+    try {
+      rx_buffer = ceph::buffer::ptr_node::create(ceph::buffer::create_aligned(
+          onwire_len, align));
+    } catch (const ceph::buffer::bad_alloc&) {
+      // Catching because of potential issues with satisfying alignment.
+      ldout(cct, 1) << __func__ << " can't allocate aligned rx_buffer"
+                    << " len=" << onwire_len
+                    << " align=" << align
+                    << dendl;
+      return _fault();
+    }
   }
 
   return READ_RXBUF(std::move(rx_buffer), handle_read_frame_segment);
 }
 
+rx_buffer_t ProtocolV2::claim_rx_buffer(uint32_t onwire_len) {
+  // The data segment can only land in the caller's buffer when it goes
+  // over the wire as is: no encryption, no compression.
+  if (session_stream_handlers.rx || session_compression_handlers.rx) {
+    return nullptr;
+  }
+  const auto& header_bl = rx_segments_data[SegmentIndex::Msg::HEADER];
+  if (header_bl.length() < sizeof(ceph_msg_header2)) {
+    return nullptr;
+  }
+  ceph_msg_header2 header;
+  header_bl.begin().copy(sizeof(header), reinterpret_cast<char*>(&header));
+
+  ceph::bufferlist bl;
+  if (!connection->claim_rx_buffer(header.tid, &bl)) {
+    return nullptr;
+  }
+  if (bl.get_num_buffers() != 1 || bl.length() < onwire_len) {
+    ldout(cct, 20) << __func__ << " rx buffer for tid " << header.tid
+                   << " not usable (" << bl.get_num_buffers() << " buffers, "
+                   << bl.length() << " bytes), need " << onwire_len << dendl;
+    connection->release_rx_buffer();
+    return nullptr;
+  }
+  ldout(cct, 20) << __func__ << " reading " << onwire_len
+                 << " bytes of data into rx buffer for tid " << header.tid
+                 << dendl;
+  rx_buffer_tid = header.tid;
+  bl.invalidate_crc();  // we write through c_str()
+  return ceph::buffer::ptr_node::create(bl.front(), 0, onwire_len);
+}
+
+rx_buffer_t ProtocolV2::alloc_data_rx_buffer(uint32_t onwire_len) {
+  // Like msgr1, lay the data out so that its in-page offset matches the
+  // data_off the sender gave (e.g. the object offset of an MOSDOp write),
+  // letting the store submit the page aligned part of a write without
+  // copying it first.  Only possible when what we read is the plain data.
+  if (session_stream_handlers.rx || session_compression_handlers.rx) {
+    return nullptr;
+  }
+  const auto& header_bl = rx_segments_data[SegmentIndex::Msg::HEADER];
+  if (header_bl.length() < sizeof(ceph_msg_header2)) {
+    return nullptr;
+  }
+  ceph_msg_header2 header;
+  header_bl.begin().copy(sizeof(header), reinterpret_cast<char*>(&header));
+  const unsigned head = header.data_off & ~CEPH_PAGE_MASK;
+  if (head == 0) {
+    return nullptr;
+  }
+  ceph::bufferptr ptr(ceph::buffer::create_small_page_aligned(
+      head + onwire_len));
+  ptr.set_offset(head);
+  ptr.set_length(onwire_len);
+  return ceph::buffer::ptr_node::create(std::move(ptr));
+}
+
+void ProtocolV2::release_rx_buffer() {
+  if (rx_buffer_tid) {
+    rx_buffer_tid = 0;
+    connection->release_rx_buffer();
+  }
+}
+
+char *ProtocolV2::resume_read(char *buf, unsigned done) {
+  if (!rx_buffer_tid || connection->resume_rx_buffer(rx_buffer_tid)) {
+    return buf;
+  }
+  // The owner took its buffer back while we were waiting for the rest of
+  // the segment; finish the read into a buffer of our own.
+  auto& node = CONTINUATION(handle_read_frame_segment).node;
+  ldout(cct, 10) << __func__ << " rx buffer for tid " << rx_buffer_tid
+                 << " revoked after " << done << "/" << node->length()
+                 << " bytes, switching to a private buffer" << dendl;
+  rx_buffer_tid = 0;
+  auto copy = ceph::buffer::ptr_node::create(ceph::buffer::create_aligned(
+      node->length(), CEPH_PAGE_SIZE));
+  memcpy(copy->c_str(), buf, done);
+  node = std::move(copy);
+  return node->c_str();
+}
+
+void ProtocolV2::suspend_read() {
+  if (rx_buffer_tid) {
+    connection->release_rx_buffer();
+  }
+}
+
 CtPtr ProtocolV2::handle_read_frame_segment(rx_buffer_t &&rx_buffer, int r) {
   ldout(cct, 20) << __func__ << " r=" << r << dendl;
 
+  release_rx_buffer();
+
   if (r < 0) {
     ldout(cct, 1) << __func__ << " read frame segment failed r=" << r << " ("
                   << cpp_strerror(r) << ")" << dendl;
@@ -2167,7 +2310,8 @@ CtPtr ProtocolV2::handle_compression_done(ceph::bufferlist &payload) {
     comp_meta.con_mode = Compressor::COMP_NONE;
   }
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()),
+    is_compression_stream());
 
   return start_session_connect();
 }
@@ -3027,7 +3171,8 @@ CtPtr ProtocolV2::finish_compression() {
   // allow reusing finish_compression().
   
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()),
+    is_compression_stream());
 
   state = SESSION_ACCEPTING;
   return CONTINUE(read_frame);
@@ -121,6 +121,8 @@ private:
 
   bool keepalive;
   bool write_in_progress = false;
+  unsigned tx_batch_messages = 0; ///< messages appended to outgoing_bl since the last flush
+  ceph_tid_t rx_buffer_tid = 0; ///< reading a data segment into the rx buffer posted for this tid
 
   CompConnectionMeta comp_meta;
   std::ostream& _conn_prefix(std::ostream *_dout);
@@ -151,6 +153,8 @@ private:
   void prepare_send_message(uint64_t features, Message *m);
   out_queue_entry_t _get_next_outgoing();
   ssize_t write_message(Message *m, bool more);
+  bool tx_batch_full() const;
+  ssize_t flush_outgoing(bool more);
   void handle_message_ack(uint64_t seq);
   void reset_compression();
 
@@ -158,6 +162,9 @@ private:
   READ_BPTR_HANDLER_CONTINUATION_DECL(ProtocolV2, _handle_peer_banner);
   READ_BPTR_HANDLER_CONTINUATION_DECL(ProtocolV2, _handle_peer_banner_payload);
 
+  uint64_t get_supported_features() const;
+  /// compress frames with a context carried over from the previous ones?
+  bool is_compression_stream() const;
   Ct<ProtocolV2> *_banner_exchange(Ct<ProtocolV2> &callback);
   Ct<ProtocolV2> *_wait_for_peer_banner();
   Ct<ProtocolV2> *_handle_peer_banner(rx_buffer_t &&buffer, int r);
@@ -180,6 +187,9 @@ private:
   Ct<ProtocolV2> *finish_server_auth();
   Ct<ProtocolV2> *handle_read_frame_preamble_main(rx_buffer_t &&buffer, int r);
   Ct<ProtocolV2> *read_frame_segment();
+  rx_buffer_t claim_rx_buffer(uint32_t onwire_len);
+  rx_buffer_t alloc_data_rx_buffer(uint32_t onwire_len);
+  void release_rx_buffer();
   Ct<ProtocolV2> *handle_read_frame_segment(rx_buffer_t &&rx_buffer, int r);
   Ct<ProtocolV2> *_handle_read_frame_segment();
   Ct<ProtocolV2> *handle_read_frame_epilogue_main(rx_buffer_t &&buffer, int r);
@@ -218,6 +228,9 @@ public:
   virtual void write_event() override;
   virtual bool is_queued() override;
 
+  virtual char *resume_read(char *buf, unsigned done) override;
+  virtual void suspend_read() override;
+
 private:
   // Client Protocol
   CONTINUATION_DECL(ProtocolV2, start_client_banner_exchange);
@@ -28,6 +28,7 @@
 #endif
 
 #include "common/dout.h"
+#include "common/numa.h"
 #include "include/ceph_assert.h"
 
 #define dout_subsys ceph_subsys_ms
@@ -40,6 +41,24 @@ std::function<void ()> NetworkStack::add_thread(Worker* w)
       rename_thread(w->id);
       const unsigned EventMaxWaitUs = 30000000;
       w->center.set_owner();
+      if (const auto& cpus = cct->_conf->ms_async_worker_cpus; !cpus.empty()) {
+        int cpu = -1;
+        int r = set_cpu_affinity_this_thread_nth(cpus.c_str(), w->id, &cpu);
+        if (r < 0) {
+          lderr(cct) << __func__ << " unable to pin worker " << w->id
+                     << " to a cpu of '" << cpus << "': " << cpp_strerror(r)
+                     << dendl;
+        } else {
+          ldout(cct, 1) << __func__ << " worker " << w->id << " pinned to cpu "
+                        << cpu << dendl;
+        }
+      }
+      if (cct->_conf->ms_async_busy_poll_us &&
+          (cct->_conf->ms_async_busy_poll_workers == 0 ||
+           w->id < cct->_conf->ms_async_busy_poll_workers)) {
+        w->center.set_busy_poll(
+          std::chrono::microseconds(cct->_conf->ms_async_busy_poll_us));
+      }
       ldout(cct, 10) << __func__ << " starting" << dendl;
       w->initialize();
       w->init_done();
@@ -47,13 +66,17 @@ std::function<void ()> NetworkStack::add_thread(Worker* w)
         ldout(cct, 30) << __func__ << " calling event process" << dendl;
 
         ceph::timespan dur;
-        int r = w->center.process_events(EventMaxWaitUs, &dur);
+        ceph::timespan spin = ceph::timespan::zero();
+        ceph::timespan sleep = ceph::timespan::zero();
+        int r = w->center.process_events(EventMaxWaitUs, &dur, &spin, &sleep);
         if (r < 0) {
           ldout(cct, 20) << __func__ << " process events failed: "
                          << cpp_strerror(errno) << dendl;
           // TODO do something?
         }
         w->perf_logger->tinc(l_msgr_running_total_time, dur);
+        w->perf_logger->tinc(l_msgr_poll_spin_time, spin);
+        w->perf_logger->tinc(l_msgr_poll_sleep_time, sleep);
       }
       w->reset();
       w->destroy();
@@ -213,6 +213,11 @@ enum {
   l_msgr_recv_encrypted_bytes,
   l_msgr_send_encrypted_bytes,
 
+  l_msgr_send_batch_messages,
+
+  l_msgr_poll_spin_time,
+  l_msgr_poll_sleep_time,
+
   l_msgr_last,
 };
 
@@ -271,6 +276,11 @@ class Worker {
     plb.add_u64_counter(l_msgr_recv_encrypted_bytes, "msgr_recv_encrypted_bytes", "Network received encrypted bytes", NULL, 0, unit_t(UNIT_BYTES));
     plb.add_u64_counter(l_msgr_send_encrypted_bytes, "msgr_send_encrypted_bytes", "Network sent encrypted bytes", NULL, 0, unit_t(UNIT_BYTES));
 
+    plb.add_u64_avg(l_msgr_send_batch_messages, "msgr_send_batch_messages", "Messages written to the socket per flush");
+
+    plb.add_time(l_msgr_poll_spin_time, "msgr_poll_spin_time", "The total time spent busy polling for events");
+    plb.add_time(l_msgr_poll_sleep_time, "msgr_poll_sleep_time", "The total time spent blocked waiting for events");
+
     perf_logger = plb.create_perf_counters();
     cct->get_perfcounters_collection()->add(perf_logger);
 
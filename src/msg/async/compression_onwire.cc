@@ -3,6 +3,7 @@
 
 #include "compression_onwire.h"
 #include "compression_meta.h"
+#include "crypto_onwire.h"
 #include "common/dout.h"
 
 #define dout_subsys ceph_subsys_ms
@@ -12,15 +13,31 @@ namespace ceph::compression::onwire {
 rxtx_t rxtx_t::create_handler_pair(
     CephContext* ctx,
     const CompConnectionMeta& comp_meta,
-    std::uint64_t compress_min_size)
+    std::uint64_t compress_min_size,
+    bool stream)
 {
   if (comp_meta.is_compress()) {
      CompressorRef compressor = Compressor::create(ctx, comp_meta.get_method());
     if (compressor) {
-      return {std::make_unique<RxHandler>(ctx, compressor),
+      std::unique_ptr<Compressor::CompressStream> tx_stream;
+      std::unique_ptr<Compressor::DecompressStream> rx_stream;
+      if (stream) {
+	tx_stream = compressor->create_compress_stream();
+	rx_stream = compressor->create_decompress_stream();
+	// both peers pick the same algorithm, so either both or neither
+	// of them have a streaming mode
+	if (!tx_stream || !rx_stream) {
+	  tx_stream.reset();
+	  rx_stream.reset();
+	}
+      }
+      ldout(ctx, 10) << __func__ << " " << compressor->get_type_name()
+		     << (tx_stream ? " stream" : "") << dendl;
+      return {std::make_unique<RxHandler>(ctx, compressor, std::move(rx_stream)),
 	      std::make_unique<TxHandler>(ctx, compressor,
 					  comp_meta.get_mode(),
-					  compress_min_size)};
+					  compress_min_size,
+					  std::move(tx_stream))};
     }
   }
   return {};
@@ -46,6 +63,18 @@ std::optional<ceph::bufferlist> TxHandler::compress(const ceph::bufferlist &inpu
     return out;
   }
 
+  if (m_stream) {
+    // the stream has taken in the input whatever happens, so the frame can
+    // not go out uncompressed without losing the peer's context
+    if (m_stream->compress(input, out)) {
+      throw ceph::crypto::onwire::TxHandlerError("stream compression failed");
+    }
+    ldout(m_cct, 20) << __func__ << " uncompressed.length()=" << input.length()
+                     << " compressed.length()=" << out.length() << dendl;
+    m_onwire_size += out.length();
+    return out;
+  }
+
   std::optional<int32_t> compressor_message;
   if (m_compressor->compress(input, out, compressor_message)) {
     return {};
@@ -68,6 +97,15 @@ std::optional<ceph::bufferlist> RxHandler::decompress(const ceph::bufferlist &in
     return out;
   }
 
+  if (m_stream) {
+    if (m_stream->decompress(input, out)) {
+      return {};
+    }
+    ldout(m_cct, 20) << __func__ << " compressed.length()=" << input.length()
+                     << " uncompressed.length()=" << out.length() << dendl;
+    return out;
+  }
+
   std::optional<int32_t> compressor_message;
   if (m_compressor->decompress(input, out, compressor_message)) {
     return {};
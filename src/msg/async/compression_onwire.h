@@ -28,8 +28,9 @@ namespace ceph::compression::onwire {
 
   class RxHandler final : private Handler {
   public:
-    RxHandler(CephContext* const cct, CompressorRef compressor)
-      : Handler(cct, compressor) {}
+    RxHandler(CephContext* const cct, CompressorRef compressor,
+	      std::unique_ptr<Compressor::DecompressStream> stream = nullptr)
+      : Handler(cct, compressor), m_stream(std::move(stream)) {}
     ~RxHandler() {};
 
     /**
@@ -41,14 +42,21 @@ namespace ceph::compression::onwire {
      * @returns true on success, false on failure
      */
     std::optional<ceph::bufferlist> decompress(const ceph::bufferlist &input);
+
+  private:
+    // set if the segments are compressed with a context carried over from
+    // the previous ones
+    std::unique_ptr<Compressor::DecompressStream> m_stream;
   };
 
   class TxHandler final : private Handler {
   public:
-    TxHandler(CephContext* const cct, CompressorRef compressor, int mode, std::uint64_t min_size)
+    TxHandler(CephContext* const cct, CompressorRef compressor, int mode, std::uint64_t min_size,
+	      std::unique_ptr<Compressor::CompressStream> stream = nullptr)
       : Handler(cct, compressor),
 	m_min_size(min_size),
-	m_mode(static_cast<Compressor::CompressionMode>(mode))
+	m_mode(static_cast<Compressor::CompressionMode>(mode)),
+	m_stream(std::move(stream))
     {}
     ~TxHandler() {}
 
@@ -85,6 +93,7 @@ namespace ceph::compression::onwire {
   private:
     uint64_t m_min_size; 
     Compressor::CompressionMode m_mode;
+    std::unique_ptr<Compressor::CompressStream> m_stream;
 
     uint64_t m_init_onwire_size;
     uint64_t m_onwire_size;
@@ -98,7 +107,8 @@ namespace ceph::compression::onwire {
     static rxtx_t create_handler_pair(
       CephContext* ctx,
       const CompConnectionMeta& comp_meta,
-      std::uint64_t compress_min_size);
+      std::uint64_t compress_min_size,
+      bool stream = false);
   };
 }
 
@@ -18,6 +18,11 @@ static constexpr const std::size_t AESGCM_KEY_LEN{16};
 static constexpr const std::size_t AESGCM_IV_LEN{12};
 static constexpr const std::size_t AESGCM_TAG_LEN{16};
 static constexpr const std::size_t AESGCM_BLOCK_LEN{16};
+// plaintext segments shorter than this are gathered into one contiguous
+// EVP_EncryptUpdate; the per call overhead and the partial block handling
+// dominate for the tiny segments encoded messages are made of, and the
+// aes-ni/pclmul code only gets going on longer runs.
+static constexpr const std::size_t AESGCM_GATHER_LEN{4096};
 
 struct nonce_t {
   ceph_le32 fixed;
@@ -44,6 +49,9 @@ class AES128GCM_OnWireTxHandler : public ceph::crypto::onwire::TxHandler {
   bool new_nonce_format;  // 64-bit counter?
   static_assert(sizeof(nonce) == AESGCM_IV_LEN);
 
+  void encrypt(ceph::bufferlist::contiguous_filler& filler,
+	       const char* plain, unsigned len);
+
 public:
   AES128GCM_OnWireTxHandler(CephContext* const cct,
 			    const key_t& key,
@@ -105,6 +113,23 @@ void AES128GCM_OnWireTxHandler::reset_tx_handler(const uint32_t* first,
   }
 }
 
+void AES128GCM_OnWireTxHandler::encrypt(
+  ceph::bufferlist::contiguous_filler& filler,
+  const char* plain, unsigned len)
+{
+  int update_len = 0;
+  if(1 != EVP_EncryptUpdate(ectx.get(),
+      reinterpret_cast<unsigned char*>(filler.c_str()),
+      &update_len,
+      reinterpret_cast<const unsigned char*>(plain),
+      len)) {
+    throw std::runtime_error("EVP_EncryptUpdate failed");
+  }
+  ceph_assert_always(update_len >= 0);
+  ceph_assert(static_cast<unsigned>(update_len) == len);
+  filler.advance(update_len);
+}
+
 void AES128GCM_OnWireTxHandler::authenticated_encrypt_update(
   const ceph::bufferlist& plaintext)
 {
@@ -112,19 +137,26 @@ void AES128GCM_OnWireTxHandler::authenticated_encrypt_update(
               plaintext.length());
   auto filler = buffer.append_hole(plaintext.length());
 
+  std::array<char, AESGCM_GATHER_LEN> gather;
+  unsigned gathered = 0;
   for (const auto& plainbuf : plaintext.buffers()) {
-    int update_len = 0;
-
-    if(1 != EVP_EncryptUpdate(ectx.get(),
-	reinterpret_cast<unsigned char*>(filler.c_str()),
-	&update_len,
-	reinterpret_cast<const unsigned char*>(plainbuf.c_str()),
-	plainbuf.length())) {
-      throw std::runtime_error("EVP_EncryptUpdate failed");
+    if (plainbuf.length() < AESGCM_GATHER_LEN) {
+      if (gathered + plainbuf.length() > gather.size()) {
+	encrypt(filler, gather.data(), gathered);
+	gathered = 0;
+      }
+      ::memcpy(gather.data() + gathered, plainbuf.c_str(), plainbuf.length());
+      gathered += plainbuf.length();
+      continue;
     }
-    ceph_assert_always(update_len >= 0);
-    ceph_assert(static_cast<unsigned>(update_len) == plainbuf.length());
-    filler.advance(update_len);
+    if (gathered) {
+      encrypt(filler, gather.data(), gathered);
+      gathered = 0;
+    }
+    encrypt(filler, plainbuf.c_str(), plainbuf.length());
+  }
+  if (gathered) {
+    encrypt(filler, gather.data(), gathered);
   }
 
   ldout(cct, 15) << __func__
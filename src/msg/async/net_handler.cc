@@ -20,6 +20,7 @@
 #include <netinet/ip.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <atomic>
 
 #include "net_handler.h"
 #include "common/debug.h"
@@ -114,6 +115,28 @@ int NetHandler::set_socket_options(int sd, bool nodelay, int size)
     }
   }
 
+#ifdef SO_BUSY_POLL
+  // lets a read that finds the socket empty poll the device queue once
+  // more; the waiting itself is busy polled by the epoll driver. a failure
+  // (e.g. EPERM above net.core.busy_read) is not fatal, and would be the
+  // same for every socket, so it is only logged once
+  if (int busy_poll = cct->_conf.get_val<uint64_t>("ms_tcp_busy_poll_us");
+      busy_poll > 0) {
+    if (::setsockopt(sd, SOL_SOCKET, SO_BUSY_POLL,
+		     (SOCKOPT_VAL_TYPE)&busy_poll, sizeof(busy_poll)) < 0) {
+      int err = ceph_sock_errno();
+      static std::atomic<bool> warned{false};
+      if (!warned.exchange(true)) {
+	ldout(cct, 0) << "couldn't set SO_BUSY_POLL to " << busy_poll << ": "
+		      << cpp_strerror(err) << dendl;
+      } else {
+	ldout(cct, 10) << "couldn't set SO_BUSY_POLL to " << busy_poll << ": "
+		       << cpp_strerror(err) << dendl;
+      }
+    }
+  }
+#endif
+
   // block ESIGPIPE
 #ifdef CEPH_USE_SO_NOSIGPIPE
   int val = 1;
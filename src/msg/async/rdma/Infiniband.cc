@@ -1109,7 +1109,12 @@ void Infiniband::init()
   memory_manager->create_tx_pool(cct->_conf->ms_async_rdma_buffer_size, tx_queue_len);
 
   if (support_srq) {
-    srq = create_shared_receive_queue(rx_queue_len, MAX_SHARED_RX_SGE_COUNT);
+    // with per connection buffers the srq can grow up to what the device
+    // allows, otherwise it stays at the receive queue length
+    srq_max_wr = cct->_conf->ms_async_rdma_srq_buffers_per_conn ?
+      device->device_attr.max_srq_wr : rx_queue_len;
+    srq_wr_target = rx_queue_len;
+    srq = create_shared_receive_queue(srq_max_wr, MAX_SHARED_RX_SGE_COUNT);
     post_chunks_to_rq(rx_queue_len, NULL); //add to srq
   }
 }
@@ -1173,11 +1178,48 @@ Infiniband::QueuePair* Infiniband::create_queue_pair(CephContext *cct, Completio
   return qp;
 }
 
+void Infiniband::set_srq_connections(uint64_t num_conns)
+{
+  if (!support_srq) {
+    return;
+  }
+  uint64_t target = std::max<uint64_t>(
+    rx_queue_len, num_conns * cct->_conf->ms_async_rdma_srq_buffers_per_conn);
+  uint32_t new_target = std::min<uint64_t>(target, srq_max_wr);
+  srq_wr_target = new_target;
+  // post_chunks_to_rq() clamps this to the room left under the target
+  if (uint32_t posted = srq_wr_posted; posted < new_target) {
+    ldout(cct, 10) << __func__ << " " << num_conns << " connections, growing srq "
+                   << posted << " -> " << new_target << dendl;
+    post_chunks_to_rq(new_target - posted, nullptr);
+  }
+}
+
 int Infiniband::post_chunks_to_rq(int rq_wr_num, QueuePair *qp)
 {
   int ret = 0;
   Chunk *chunk = nullptr;
 
+  // buffers over the srq target are not posted, and do not count as missing
+  int skipped = 0;
+  if (support_srq) {
+    // the dispatcher and the connections' event centers post concurrently;
+    // reserve the room up front, and give back what we fail to post
+    uint32_t posted = srq_wr_posted.load();
+    int room;
+    do {
+      uint32_t target = srq_wr_target.load();
+      room = std::min<int64_t>(rq_wr_num,
+                               target > posted ? target - posted : 0);
+    } while (room > 0 &&
+             !srq_wr_posted.compare_exchange_weak(posted, posted + room));
+    skipped = rq_wr_num - room;
+    rq_wr_num = room;
+    if (rq_wr_num == 0) {
+      return skipped;
+    }
+  }
+
   ibv_recv_wr *rx_work_request = static_cast<ibv_recv_wr*>(::calloc(rq_wr_num, sizeof(ibv_recv_wr)));
   ibv_sge *isge = static_cast<ibv_sge*>(::calloc(rq_wr_num, sizeof(ibv_sge)));
   ceph_assert(rx_work_request);
@@ -1192,7 +1234,10 @@ int Infiniband::post_chunks_to_rq(int rq_wr_num, QueuePair *qp)
       if (i == 0) {
         ::free(rx_work_request);
         ::free(isge);
-        return 0;
+        if (support_srq) {
+          srq_wr_consumed(rq_wr_num);
+        }
+        return skipped;
       }
       break; //get some buffers, so we need post them to recevie queue
     }
@@ -1227,7 +1272,10 @@ int Infiniband::post_chunks_to_rq(int rq_wr_num, QueuePair *qp)
   ::free(rx_work_request);
   ::free(isge);
   ceph_assert(badworkrequest == nullptr && ret == 0);
-  return i;
+  if (support_srq) {
+    srq_wr_consumed(rq_wr_num - i);
+  }
+  return i + skipped;
 }
 
 Infiniband::CompletionChannel* Infiniband::create_comp_channel(CephContext *c)
@@ -395,6 +395,9 @@ class Infiniband {
   uint8_t  ib_physical_port = 0;
   MemoryManager* memory_manager = nullptr;
   ibv_srq* srq = nullptr;             // shared receive work queue
+  uint32_t srq_max_wr = 0;            // srq capacity
+  std::atomic<uint32_t> srq_wr_posted = {0}; // rx buffers currently posted to srq
+  std::atomic<uint32_t> srq_wr_target = {0}; // rx buffers we want posted to srq
   Device *device = NULL;
   ProtectionDomain *pd = NULL;
   DeviceList *device_list = nullptr;
@@ -586,6 +589,14 @@ class Infiniband {
   static const char* wc_status_to_string(int status);
   static const char* qp_state_string(int status);
   uint32_t get_rx_queue_len() const { return rx_queue_len; }
+  // size the srq for this many connections, posting buffers if it grows; it
+  // shrinks by not reposting the buffers consumed above the new target
+  void set_srq_connections(uint64_t num_conns);
+  void srq_wr_consumed(uint32_t num) {
+    uint32_t posted = srq_wr_posted.load();
+    while (!srq_wr_posted.compare_exchange_weak(
+             posted, posted - std::min(num, posted)));
+  }
 };
 
 #endif
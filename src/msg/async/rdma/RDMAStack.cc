@@ -380,6 +380,7 @@ void RDMADispatcher::register_qp(QueuePair *qp, RDMAConnectedSocketImpl* csi)
   ceph_assert(!qp_conns.count(qp->get_local_qp_number()));
   qp_conns[qp->get_local_qp_number()] = std::make_pair(qp, csi);
   ++num_qp_conn;
+  ib->set_srq_connections(num_qp_conn);
 }
 
 RDMAConnectedSocketImpl* RDMADispatcher::get_conn_lockless(uint32_t qp)
@@ -424,6 +425,7 @@ void RDMADispatcher::enqueue_dead_qp_lockless(uint32_t qpn)
   dead_queue_pairs.push_back(qp);
   qp_conns.erase(it);
   --num_qp_conn;
+  ib->set_srq_connections(num_qp_conn);
 }
 
 void RDMADispatcher::enqueue_dead_qp(uint32_t qpn)
@@ -449,6 +451,7 @@ void RDMADispatcher::schedule_qp_destroy(uint32_t qpn)
     dead_queue_pairs.push_back(qp);
     qp_conns.erase(it);
     --num_qp_conn;
+    ib->set_srq_connections(num_qp_conn);
   } else {
     //
     // Successfully switched to dead, thus keep entry in the map.
@@ -585,6 +588,8 @@ void RDMADispatcher::handle_rx_event(ibv_wc *cqe, int rx_number)
 
   std::map<RDMAConnectedSocketImpl*, std::vector<ibv_wc> > polled;
   std::lock_guard l{lock};//make sure connected socket alive when pass wc
+  // every completion, good or not, took a buffer off the srq
+  ib->srq_wr_consumed(rx_number);
 
   for (int i = 0; i < rx_number; ++i) {
     ibv_wc* response = &cqe[i];
@@ -14,6 +14,7 @@
 
 #define BOOST_BIND_NO_PLACEHOLDERS
 
+#include <algorithm>
 #include <optional>
 #include <string_view>
 
@@ -959,6 +960,104 @@ void RADOS::execute_(Object o, IOContext _ioc, WriteOp _op,
   trace.event("submitted");
 }
 
+namespace {
+// shared by the ops of one batch, the last one to finish completes it
+struct BatchState {
+  std::atomic<std::size_t> pending;
+  std::vector<bs::error_code> own_ecs;
+  std::vector<bs::error_code>* ecs;
+  Op::Completion c;
+
+  BatchState(std::size_t nops, std::size_t pending,
+	     std::vector<bs::error_code>* ecs, Op::Completion c)
+    : pending(pending), ecs(ecs ? ecs : &own_ecs), c(std::move(c)) {
+    this->ecs->assign(nops, bs::error_code{});
+  }
+
+  void finish(std::size_t i, bs::error_code ec) {
+    (*ecs)[i] = ec;
+    if (--pending == 0) {
+      bs::error_code first;
+      for (const auto& e : *ecs) {
+	if (e) {
+	  first = e;
+	  break;
+	}
+      }
+      asio::dispatch(asio::append(std::move(c), first));
+    }
+  }
+};
+
+template<typename T>
+std::size_t count_nonempty(const std::vector<std::pair<Object, T>>& ops) {
+  return std::count_if(ops.begin(), ops.end(),
+		       [](const auto& p) { return p.second.size() > 0; });
+}
+}
+
+void RADOS::execute_(IOContext _ioc, std::vector<std::pair<Object, ReadOp>> ops,
+		     Op::Completion c, std::vector<bs::error_code>* ecs) {
+  auto n = count_nonempty(ops);
+  if (n == 0) {
+    if (ecs) {
+      ecs->assign(ops.size(), bs::error_code{});
+    }
+    asio::dispatch(asio::append(std::move(c), bs::error_code{}));
+    return;
+  }
+  auto ioc = reinterpret_cast<const IOContextImpl*>(&_ioc.impl);
+  auto state = std::make_shared<BatchState>(ops.size(), n, ecs, std::move(c));
+
+  std::vector<Objecter::Op*> batch;
+  batch.reserve(n);
+  for (std::size_t i = 0; i < ops.size(); ++i) {
+    auto& [o, _op] = ops[i];
+    if (_op.size() == 0) {
+      continue;
+    }
+    auto oid = reinterpret_cast<const object_t*>(&o.impl);
+    auto op = reinterpret_cast<OpImpl*>(&_op.impl);
+    auto flags = op->op.flags | ioc->extra_op_flags;
+    batch.push_back(impl->objecter->prepare_read_op(
+      *oid, ioc->oloc, std::move(op->op), ioc->snap_seq, nullptr, flags,
+      [state, i](bs::error_code ec) { state->finish(i, ec); }));
+  }
+  impl->objecter->op_submit_batch(batch);
+}
+
+void RADOS::execute_(IOContext _ioc, std::vector<std::pair<Object, WriteOp>> ops,
+		     Op::Completion c, std::vector<bs::error_code>* ecs) {
+  auto n = count_nonempty(ops);
+  if (n == 0) {
+    if (ecs) {
+      ecs->assign(ops.size(), bs::error_code{});
+    }
+    asio::dispatch(asio::append(std::move(c), bs::error_code{}));
+    return;
+  }
+  auto ioc = reinterpret_cast<const IOContextImpl*>(&_ioc.impl);
+  auto state = std::make_shared<BatchState>(ops.size(), n, ecs, std::move(c));
+  auto now = ceph::real_clock::now();
+
+  std::vector<Objecter::Op*> batch;
+  batch.reserve(n);
+  for (std::size_t i = 0; i < ops.size(); ++i) {
+    auto& [o, _op] = ops[i];
+    if (_op.size() == 0) {
+      continue;
+    }
+    auto oid = reinterpret_cast<const object_t*>(&o.impl);
+    auto op = reinterpret_cast<OpImpl*>(&_op.impl);
+    auto flags = op->op.flags | ioc->extra_op_flags;
+    batch.push_back(impl->objecter->prepare_mutate_op(
+      *oid, ioc->oloc, std::move(op->op), ioc->snapc,
+      op->mtime ? *op->mtime : now, flags,
+      [state, i](bs::error_code ec) { state->finish(i, ec); }));
+  }
+  impl->objecter->op_submit_batch(batch);
+}
+
 boost::uuids::uuid RADOS::get_fsid() const noexcept {
   return impl->monclient.get_fsid().uuid;
 }
@@ -8,6 +8,7 @@
 #include "AvlAllocator.h"
 #include "BtreeAllocator.h"
 #include "HybridAllocator.h"
+#include "ShardedAllocator.h"
 #include "common/debug.h"
 #include "common/admin_socket.h"
 #define dout_subsys ceph_subsys_bluestore
@@ -57,6 +58,17 @@ public:
 	  this,
 	  "build allocator free regions state histogram");
         ceph_assert(r == 0);
+        r = admin_socket->register_command(
+	  ("bluestore allocator trace start " + name +
+           " name=max_bytes,type=CephInt,req=false").c_str(),
+	  this,
+	  "start recording allocate/release calls");
+        ceph_assert(r == 0);
+        r = admin_socket->register_command(
+	  ("bluestore allocator trace stop " + name).c_str(),
+	  this,
+	  "stop recording allocate/release calls and return the binary trace");
+        ceph_assert(r == 0);
       }
     }
   }
@@ -138,6 +150,20 @@ public:
         f->close_section();
       }
       f->close_section();
+    } else if (command == "bluestore allocator trace start " + name) {
+      int64_t max_bytes = 256 << 20;
+      cmd_getval(cmdmap, "max_bytes", max_bytes);
+      if (max_bytes <= 0) {
+        ss << "Invalid max_bytes: '" << max_bytes << "'" << std::endl;
+        return -EINVAL;
+      }
+      alloc->start_trace(max_bytes);
+      f->open_object_section("trace");
+      f->dump_bool("tracing", true);
+      f->dump_int("max_bytes", max_bytes);
+      f->close_section();
+    } else if (command == "bluestore allocator trace stop " + name) {
+      out = alloc->stop_trace();
     } else {
       ss << "Invalid command" << std::endl;
       r = -ENOSYS;
@@ -185,6 +211,10 @@ Allocator *Allocator::create(
     return new HybridAllocator(cct, size, block_size,
       cct->_conf.get_val<uint64_t>("bluestore_hybrid_alloc_mem_cap"),
       name);
+  } else if (type == "sharded") {
+    return new ShardedAllocator(cct, size, block_size,
+      cct->_conf.get_val<uint64_t>("bluestore_sharded_alloc_shards"),
+      name);
   }
   if (alloc == nullptr) {
     lderr(cct) << "Allocator::" << __func__ << " unknown alloc type "
@@ -193,6 +223,107 @@ Allocator *Allocator::create(
   return alloc;
 }
 
+void Allocator::start_trace(uint64_t max_bytes)
+{
+  std::lock_guard l(trace_lock);
+  // start recording before taking the snapshot, so that no call slips in
+  // between the two: calls made meanwhile wait for the lock in record()
+  // and land after the header.  one racing with foreach() may be reflected
+  // in the free extents as well; replay tolerates that.
+  trace_bl.clear();
+  trace_max_bytes = max_bytes;
+  trace_ops = 0;
+  trace_start = ceph::mono_clock::now();
+  tracing = true;
+
+  allocator_trace_header_t header;
+  header.type = get_type();
+  header.capacity = get_capacity();
+  header.block_size = get_block_size();
+  foreach([&](uint64_t offset, uint64_t length) {
+    header.free_extents.emplace_back(offset, length);
+  });
+  encode(header, trace_bl);
+}
+
+bufferlist Allocator::stop_trace()
+{
+  std::lock_guard l(trace_lock);
+  tracing = false;
+  bufferlist bl;
+  bl.swap(trace_bl);
+  return bl;
+}
+
+void Allocator::record(allocator_trace_op_t&& op)
+{
+  std::lock_guard l(trace_lock);
+  if (!tracing) {
+    return;
+  }
+  op.stamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    ceph::mono_clock::now() - trace_start).count();
+  encode(op, trace_bl);
+  ++trace_ops;
+  if (trace_bl.length() >= trace_max_bytes) {
+    // keep what we have until stop_trace()
+    tracing = false;
+  }
+}
+
+int64_t Allocator::traced_allocate(uint64_t want_size, uint64_t block_size,
+				   uint64_t max_alloc_size, int64_t hint,
+				   PExtentVector *extents)
+{
+  if (!tracing.load(std::memory_order_relaxed)) {
+    return allocate(want_size, block_size, max_alloc_size, hint, extents);
+  }
+  size_t first = extents->size();
+  auto start = ceph::mono_clock::now();
+  int64_t r = allocate(want_size, block_size, max_alloc_size, hint, extents);
+  allocator_trace_op_t op;
+  op.latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    ceph::mono_clock::now() - start).count();
+  op.op = allocator_trace_op_t::OP_ALLOCATE;
+  op.want = want_size;
+  op.unit = block_size;
+  op.max_alloc_size = max_alloc_size;
+  op.hint = hint;
+  op.result = r;
+  for (size_t i = first; i < extents->size(); ++i) {
+    op.extents.emplace_back((*extents)[i].offset, (*extents)[i].length);
+  }
+  record(std::move(op));
+  return r;
+}
+
+void Allocator::traced_release(const interval_set<uint64_t>& release_set)
+{
+  if (!tracing.load(std::memory_order_relaxed)) {
+    release(release_set);
+    return;
+  }
+  allocator_trace_op_t op;
+  op.op = allocator_trace_op_t::OP_RELEASE;
+  for (auto p = release_set.begin(); p != release_set.end(); ++p) {
+    op.extents.emplace_back(p.get_start(), p.get_len());
+  }
+  auto start = ceph::mono_clock::now();
+  release(release_set);
+  op.latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    ceph::mono_clock::now() - start).count();
+  record(std::move(op));
+}
+
+void Allocator::traced_release(const PExtentVector& release_vec)
+{
+  interval_set<uint64_t> release_set;
+  for (auto e : release_vec) {
+    release_set.insert(e.offset, e.length);
+  }
+  traced_release(release_set);
+}
+
 void Allocator::release(const PExtentVector& release_vec)
 {
   interval_set<uint64_t> release_set;
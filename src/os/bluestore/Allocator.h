@@ -12,11 +12,65 @@
 #ifndef CEPH_OS_BLUESTORE_ALLOCATOR_H
 #define CEPH_OS_BLUESTORE_ALLOCATOR_H
 
+#include <atomic>
 #include <functional>
 #include <ostream>
 #include "include/ceph_assert.h"
+#include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 #include "bluestore_types.h"
 
+/// start of an allocator trace: the allocator's geometry and free space
+struct allocator_trace_header_t {
+  std::string type;
+  uint64_t capacity = 0;
+  uint64_t block_size = 0;
+  std::vector<std::pair<uint64_t, uint64_t>> free_extents;
+
+  DENC(allocator_trace_header_t, v, p) {
+    DENC_START(1, 1, p);
+    denc(v.type, p);
+    denc(v.capacity, p);
+    denc(v.block_size, p);
+    denc(v.free_extents, p);
+    DENC_FINISH(p);
+  }
+};
+WRITE_CLASS_DENC(allocator_trace_header_t)
+
+/// one traced allocate() or release() call; a trace is a header followed
+/// by these, in the order the calls completed
+struct allocator_trace_op_t {
+  enum {
+    OP_ALLOCATE = 1,
+    OP_RELEASE = 2,
+  };
+  uint8_t op = 0;
+  uint64_t stamp_ns = 0;         ///< since the trace was started
+  uint64_t want = 0;
+  uint64_t unit = 0;
+  uint64_t max_alloc_size = 0;
+  int64_t hint = 0;
+  int64_t result = 0;            ///< what allocate() returned
+  uint64_t latency_ns = 0;
+  std::vector<std::pair<uint64_t, uint64_t>> extents; ///< allocated or released
+
+  DENC(allocator_trace_op_t, v, p) {
+    DENC_START(1, 1, p);
+    denc(v.op, p);
+    denc(v.stamp_ns, p);
+    denc(v.want, p);
+    denc(v.unit, p);
+    denc(v.max_alloc_size, p);
+    denc(v.hint, p);
+    denc(v.result, p);
+    denc(v.latency_ns, p);
+    denc(v.extents, p);
+    DENC_FINISH(p);
+  }
+};
+WRITE_CLASS_DENC(allocator_trace_op_t)
+
 class Allocator {
 public:
   Allocator(std::string_view name,
@@ -52,6 +106,22 @@ public:
   virtual void release(const interval_set<uint64_t>& release_set) = 0;
   void release(const PExtentVector& release_set);
 
+  /*
+   * allocate() and release() recorded while a trace is running (see the
+   * "bluestore allocator trace" admin socket commands).  Meant for the
+   * store's own allocation paths, so that their calls can be replayed
+   * later against any allocator.
+   */
+  int64_t traced_allocate(uint64_t want_size, uint64_t block_size,
+			  uint64_t max_alloc_size, int64_t hint,
+			  PExtentVector *extents);
+  int64_t traced_allocate(uint64_t want_size, uint64_t block_size,
+			  int64_t hint, PExtentVector *extents) {
+    return traced_allocate(want_size, block_size, want_size, hint, extents);
+  }
+  void traced_release(const interval_set<uint64_t>& release_set);
+  void traced_release(const PExtentVector& release_set);
+
   virtual void dump() = 0;
   virtual void foreach(
     std::function<void(uint64_t offset, uint64_t length)> notify) = 0;
@@ -120,6 +190,17 @@ public:
 private:
   class SocketHook;
   SocketHook* asok_hook = nullptr;
+
+  std::atomic<bool> tracing = false;
+  ceph::mutex trace_lock = ceph::make_mutex("Allocator::trace_lock");
+  ceph::mono_time trace_start;
+  ceph::buffer::list trace_bl;
+  uint64_t trace_max_bytes = 0;
+  uint64_t trace_ops = 0;
+
+  void start_trace(uint64_t max_bytes);
+  ceph::buffer::list stop_trace();
+  void record(allocator_trace_op_t&& op);
 protected:
   const int64_t device_size = 0;
   const int64_t block_size = 0;
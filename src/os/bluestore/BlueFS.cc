@@ -2133,6 +2133,53 @@ void BlueFS::_drop_link_D(FileRef file)
   }
 }
 
+bool BlueFS::_fill_read_buffer(
+  FileReader *h,
+  uint64_t off,
+  uint64_t len,
+  uint64_t prefetch,
+  uint64_t *fetched)
+{
+  FileReaderBuffer *buf = &(h->buf);
+  buf->bl.clear();
+  buf->bl_off = off & super.block_mask();
+  uint64_t x_off = 0;
+  auto p = h->file->fnode.seek(buf->bl_off, &x_off);
+  if (p == h->file->fnode.extents.end()) {
+    return false;
+  }
+
+  uint64_t want = round_up_to(len + (off & ~super.block_mask()),
+			      super.block_size);
+  want = std::max(want, prefetch);
+  uint64_t l = std::min(p->length - x_off, want);
+  //hard cap to 1GB
+  l = std::min(l, uint64_t(1) << 30);
+  uint64_t eof_offset = round_up_to(h->file->fnode.size, super.block_size);
+  if (!h->ignore_eof &&
+      buf->bl_off + l > eof_offset) {
+    l = eof_offset - buf->bl_off;
+  }
+  dout(20) << __func__ << " fetching 0x"
+	   << std::hex << x_off << "~" << l << std::dec
+	   << " of " << *p << dendl;
+  int r;
+  // when reading BlueFS log (only happens on startup) use non-buffered io
+  // it makes it in sync with logic in _flush_range()
+  bool use_buffered_io = h->file->fnode.ino == 1 ? false : cct->_conf->bluefs_buffered_io;
+  if (!cct->_conf->bluefs_check_for_zeros) {
+    r = _bdev_read(p->bdev, p->offset + x_off, l, &buf->bl, ioc[p->bdev],
+		   use_buffered_io);
+  } else {
+    r = _read_and_check(
+      p->bdev, p->offset + x_off, l, &buf->bl, ioc[p->bdev],
+      use_buffered_io);
+  }
+  ceph_assert(r == 0);
+  *fetched = l;
+  return true;
+}
+
 int64_t BlueFS::_read_random(
   FileReader *h,         ///< [in] read from here
   uint64_t off,          ///< [in] offset
@@ -2161,11 +2208,39 @@ int64_t BlueFS::_read_random(
   logger->inc(l_bluefs_read_random_count, 1);
   logger->inc(l_bluefs_read_random_bytes, len);
 
+  uint64_t max_readahead = cct->_conf->bluefs_random_readahead_max;
   std::shared_lock s_lock(h->lock);
   buf->bl.reassign_to_mempool(mempool::mempool_bluefs_file_reader);
   while (len > 0) {
     if (off < buf->bl_off || off >= buf->get_buf_end()) {
       s_lock.unlock();
+      // A miss that starts where the previous read ended is part of a scan
+      // (compaction input, iterator); grow the readahead window for it and
+      // serve the scan from the reader buffer.  Anything else, and reads at
+      // least as large as the window, go straight to the device.
+      uint64_t readahead = 0;
+      if (max_readahead) {
+	if (off == buf->random_seq_end.load(std::memory_order_relaxed)) {
+	  readahead = std::min(
+	    std::max(buf->random_readahead.load(std::memory_order_relaxed) * 2,
+		     len * 2),
+	    max_readahead);
+	}
+	buf->random_readahead.store(readahead, std::memory_order_relaxed);
+      }
+      if (readahead > len) {
+	std::unique_lock u_lock(h->lock);
+	if (off < buf->bl_off || off >= buf->get_buf_end()) {
+	  uint64_t l = 0;
+	  bool filled = _fill_read_buffer(h, off, len, readahead, &l);
+	  ceph_assert(filled);
+	  logger->inc(l_bluefs_read_random_disk_count, 1);
+	  logger->inc(l_bluefs_read_random_disk_bytes, l);
+	}
+	u_lock.unlock();
+	s_lock.lock();
+	continue;
+      }
       uint64_t x_off = 0;
       auto p = h->file->fnode.seek(off, &x_off);
       ceph_assert(p != h->file->fnode.extents.end());
@@ -2221,6 +2296,7 @@ int64_t BlueFS::_read_random(
       buf->pos += r;
     }
   }
+  buf->random_seq_end.store(off, std::memory_order_relaxed);
   dout(20) << __func__ << std::hex
            << " got 0x" << ret
            << std::dec  << dendl;
@@ -2277,46 +2353,14 @@ int64_t BlueFS::_read(
       buf->bl.reassign_to_mempool(mempool::mempool_bluefs_file_reader);
       if (off < buf->bl_off || off >= buf->get_buf_end()) {
         // if precondition hasn't changed during locking upgrade.
-        buf->bl.clear();
-        buf->bl_off = off & super.block_mask();
-        uint64_t x_off = 0;
-        auto p = h->file->fnode.seek(buf->bl_off, &x_off);
-	if (p == h->file->fnode.extents.end()) {
+        uint64_t l = 0;
+	if (!_fill_read_buffer(h, off, len, buf->max_prefetch, &l)) {
 	  dout(5) << __func__ << " reading less then required "
 		  << ret << "<" << ret + len << dendl;
 	  break;
 	}
-
-        uint64_t want = round_up_to(len + (off & ~super.block_mask()),
-				    super.block_size);
-        want = std::max(want, buf->max_prefetch);
-        uint64_t l = std::min(p->length - x_off, want);
-        //hard cap to 1GB
-	l = std::min(l, uint64_t(1) << 30);
-        uint64_t eof_offset = round_up_to(h->file->fnode.size, super.block_size);
-        if (!h->ignore_eof &&
-	    buf->bl_off + l > eof_offset) {
-	  l = eof_offset - buf->bl_off;
-        }
-        dout(20) << __func__ << " fetching 0x"
-                 << std::hex << x_off << "~" << l << std::dec
-                 << " of " << *p << dendl;
-	int r;
-	// when reading BlueFS log (only happens on startup) use non-buffered io
-	// it makes it in sync with logic in _flush_range()
-	bool use_buffered_io = h->file->fnode.ino == 1 ? false : cct->_conf->bluefs_buffered_io;
-	if (!cct->_conf->bluefs_check_for_zeros) {
-	  r = _bdev_read(p->bdev, p->offset + x_off, l, &buf->bl, ioc[p->bdev],
-			 use_buffered_io);
-	} else {
-	  r = _read_and_check(
-	    p->bdev, p->offset + x_off, l, &buf->bl, ioc[p->bdev],
-	    use_buffered_io);
-	}
 	logger->inc(l_bluefs_read_disk_count, 1);
 	logger->inc(l_bluefs_read_disk_bytes, l);
-
-        ceph_assert(r == 0);
       }
       u_lock.unlock();
       s_lock.lock();
@@ -2528,6 +2572,64 @@ void BlueFS::_compact_log_dump_metadata_NF(uint64_t start_seq,
   }
 }
 
+void BlueFS::_compact_log_capture_metadata_NF(metadata_capture_t *c,
+                                              uint64_t capture_before_seq)
+{
+  dout(20) << __func__ << dendl;
+  std::lock_guard nl(nodes.lock);
+
+  c->files.reserve(nodes.file_map.size());
+  for (auto& [ino, file_ref] : nodes.file_map) {
+    if (ino == 1)
+      continue;
+    ceph_assert(ino > 1);
+    std::lock_guard fl(file_ref->lock);
+    auto& fnode = file_ref->fnode;
+    if (file_ref->dirty_seq >= capture_before_seq) {
+      dout(20) << __func__ << " op_file_update just modified, dirty_seq="
+               << file_ref->dirty_seq << " " << fnode << dendl;
+    }
+    // only what gets encoded; the extents index isn't needed for that
+    auto& copy = c->files.emplace_back(fnode.ino, fnode.size, fnode.mtime);
+    copy.extents = fnode.extents;
+    // as op_file_update() does: the captured fnode is the new base for
+    // the deltas logged from now on
+    fnode.reset_delta();
+  }
+  c->dirs.reserve(nodes.dir_map.size());
+  for (auto& [path, dir_ref] : nodes.dir_map) {
+    auto& [dirname, links] = c->dirs.emplace_back();
+    dirname = path;
+    links.reserve(dir_ref->file_map.size());
+    for (auto& [fname, file_ref] : dir_ref->file_map) {
+      links.emplace_back(fname, file_ref->fnode.ino);
+    }
+  }
+}
+
+void BlueFS::_compact_log_encode_metadata(uint64_t start_seq,
+                                          metadata_capture_t&& c,
+                                          bluefs_transaction_t *t)
+{
+  dout(20) << __func__ << " " << c.files.size() << " files, "
+           << c.dirs.size() << " dirs" << dendl;
+  t->seq = start_seq;
+  t->uuid = super.uuid;
+  for (auto& fnode : c.files) {
+    dout(20) << __func__ << " op_file_update " << fnode << dendl;
+    t->op_file_update(fnode);
+  }
+  for (auto& [path, links] : c.dirs) {
+    dout(20) << __func__ << " op_dir_create " << path << dendl;
+    t->op_dir_create(path);
+    for (auto& [fname, ino] : links) {
+      dout(20) << __func__ << " op_dir_link " << path << "/" << fname
+	       << " to " << ino << dendl;
+      t->op_dir_link(path, fname, ino);
+    }
+  }
+}
+
 void BlueFS::_compact_log_sync_LNF_LD()
 {
   dout(10) << __func__ << dendl;
@@ -2814,30 +2916,40 @@ void BlueFS::_compact_log_async_LD_LNF_D() //also locks FW for new_writer
   uint64_t old_log_jump_to = 0;
 
   // Part 0.
-  // Lock the log and forbid its expansion and other compactions
-
-  // lock log's run-time structures for a while
-  log.lock.lock();
-
-  // Extend log in case of having a big transaction waiting before starting compaction.
-  _maybe_extend_log();
+  // Forbid other compactions, then lock the log and forbid its expansion.
+  // Everything that does not depend on the log's state is done before
+  // taking log.lock, as fsyncs are held off while we have it.
 
   // only one compaction allowed at one time
   bool old_is_comp = std::atomic_exchange(&log_is_compacting, true);
   if (old_is_comp) {
     dout(10) << __func__ << " ongoing" <<dendl;
-    log.lock.unlock();
     return;
   }
-  auto t0 = mono_clock::now();
 
-  // Part 1.
-  // Prepare current log for jumping into it.
-  // 1. Allocate extent
-  // 2. Update op to log
-  // 3. Jump op to log
-  // During that, no one else can write to log, otherwise we risk jumping backwards.
-  // We need to sync log, because we are injecting discontinuity, and writer is not prepared for that.
+  File *log_file = log.writer->file.get();
+
+  // 1.1 allocate new log extents and store them at fnode_tail
+  bluefs_fnode_t fnode_tail;
+  dout(10) << __func__ << " need 0x" << std::hex
+	   << cct->_conf->bluefs_max_log_runway << std::dec << dendl;
+  int r = _allocate(vselector->select_prefer_bdev(log_file->vselector_hint),
+		    cct->_conf->bluefs_max_log_runway,
+                    0,
+                    &fnode_tail);
+  ceph_assert(r == 0);
+
+  // the flush below, under log.lock, only has to cover what gets written
+  // from now on
+  _flush_bdev();
+
+  // lock log's run-time structures for a while
+  log.lock.lock();
+
+  // Extend log in case of having a big transaction waiting before starting compaction.
+  _maybe_extend_log();
+
+  auto t0 = mono_clock::now();
 
   //signal _extend_log that expansion of log is temporary inacceptable
   bool old_forbidden = atomic_exchange(&log_forbidden_to_expand, true);
@@ -2846,25 +2958,16 @@ void BlueFS::_compact_log_async_LD_LNF_D() //also locks FW for new_writer
   //
   // Part 1.
   // Prepare current log for jumping into it.
-  // 1.1. Allocate extent
+  // 1.1. Allocate extent (done above)
   // 1.2. Save log's fnode extents and add new extents
   // 1.3. Update op to log
   // 1.4. Jump op to log
   // During that, no one else can write to log, otherwise we risk jumping backwards.
   // We need to sync log, because we are injecting discontinuity, and writer is not prepared for that.
 
-  // 1.1 allocate new log extents and store them at fnode_tail
-  File *log_file = log.writer->file.get();
-
   old_log_jump_to = log_file->fnode.get_allocated();
-  bluefs_fnode_t fnode_tail;
   dout(10) << __func__ << " old_log_jump_to 0x" << std::hex << old_log_jump_to
-           << " need 0x" << cct->_conf->bluefs_max_log_runway << std::dec << dendl;
-  int r = _allocate(vselector->select_prefer_bdev(log_file->vselector_hint),
-		    cct->_conf->bluefs_max_log_runway,
-                    0,
-                    &fnode_tail);
-  ceph_assert(r == 0);
+           << std::dec << dendl;
 
   // 1.2 save log's fnode extents and add new extents
   bluefs_fnode_t old_log_fnode(log_file->fnode);
@@ -2891,8 +2994,9 @@ void BlueFS::_compact_log_async_LD_LNF_D() //also locks FW for new_writer
   // Part 2.
   // Build new log starter and compacted metadata body
   // 2.1.  Build full compacted meta transaction.
-  //       While still holding the lock, encode a bluefs transaction
-  //       that dumps all of the in-memory fnodes and names.
+  //       While still holding the lock, copy all of the in-memory fnodes
+  //       and names, then encode a bluefs transaction that dumps them
+  //       once the lock is released.
   //       This might be pretty large and its allocation map can exceed
   //       superblock size. Hence instead we'll need log starter part which
   //       goes to superblock and refers that new meta through op_update_inc.
@@ -2916,15 +3020,21 @@ void BlueFS::_compact_log_async_LD_LNF_D() //also locks FW for new_writer
   //
 
   // 2.1 Build full compacted meta transaction
-  bluefs_transaction_t compacted_meta_t;
-  _compact_log_dump_metadata_NF(starter_seq + 1, &compacted_meta_t, 0, seq_now);
+  //     Only copying the metadata has to be done under the lock, it is
+  //     encoded after dropping it.
+  metadata_capture_t captured_meta;
+  _compact_log_capture_metadata_NF(&captured_meta, seq_now);
 
-  // now state is captured to compacted_meta_t,
+  // now state is captured to captured_meta,
   // current log can be used to write to,
   //ops in log will be continuation of captured state
   logger->tinc(l_bluefs_compaction_lock_lat, mono_clock::now() - t0);
   log.lock.unlock();
 
+  bluefs_transaction_t compacted_meta_t;
+  _compact_log_encode_metadata(starter_seq + 1, std::move(captured_meta),
+                               &compacted_meta_t);
+
   // 2.2 Allocate the space required for the compacted meta transaction
   uint64_t compacted_meta_need = _estimate_transaction_size(&compacted_meta_t);
   dout(20) << __func__ << " compacted_meta_need " << compacted_meta_need
@@ -3268,7 +3378,7 @@ void BlueFS::_release_pending_allocations(vector<interval_set<uint64_t>>& to_rel
 
     bool discard_queued = bdev[i]->try_discard(to_release[i]);
     if (!discard_queued) {
-      alloc[i]->release(to_release[i]);
+      alloc[i]->traced_release(to_release[i]);
       if (is_shared_alloc(i)) {
         shared_alloc->bluefs_used -= to_release[i].size();
       }
@@ -3910,13 +4020,13 @@ int BlueFS::_allocate(uint8_t id, uint64_t len,
     ++alloc_attempts;
     extents.reserve(4);  // 4 should be (more than) enough for most allocations
     auto t0 = mono_clock::now();
-    alloc_len = alloc[id]->allocate(need, alloc_unit, hint, &extents);
+    alloc_len = alloc[id]->traced_allocate(need, alloc_unit, hint, &extents);
     _update_allocate_stats(id, mono_clock::now() - t0);
   }
   if (alloc_len < 0 || alloc_len < need) {
     if (alloc[id]) {
       if (alloc_len > 0) {
-        alloc[id]->release(extents);
+        alloc[id]->traced_release(extents);
       }
       if (!was_cooldown && shared) {
         auto delay_s = cct->_conf->bluefs_failed_shared_alloc_cooldown;
@@ -375,6 +375,10 @@ public:
     ceph::buffer::list bl;          ///< prefetch buffer
     uint64_t pos = 0;       ///< current logical offset
     uint64_t max_prefetch;  ///< max allowed prefetch
+    /// end of the previous read_random(), to detect sequential scans
+    std::atomic<uint64_t> random_seq_end = 0;
+    /// current read_random() readahead window, 0 while reads look random
+    std::atomic<uint64_t> random_readahead = 0;
 
     explicit FileReaderBuffer(uint64_t mpf)
       : max_prefetch(mpf) {}
@@ -585,6 +589,18 @@ private:
                                      bluefs_transaction_t *t,
 				     int flags,
 				     uint64_t capture_before_seq);
+  // the metadata _compact_log_dump_metadata_NF() would dump, copied out
+  // so that it can be encoded without holding the log locked
+  struct metadata_capture_t {
+    std::vector<bluefs_fnode_t> files;
+    std::vector<std::pair<std::string,
+			  std::vector<std::pair<std::string, uint64_t>>>> dirs;
+  };
+  void _compact_log_capture_metadata_NF(metadata_capture_t *c,
+					uint64_t capture_before_seq);
+  void _compact_log_encode_metadata(uint64_t start_seq,
+				    metadata_capture_t&& c,
+				    bluefs_transaction_t *t);
 
   void _compact_log_sync_LNF_LD();
   void _compact_log_async_LD_LNF_D();
@@ -611,6 +627,12 @@ private:
     size_t len,      ///< [in] this many bytes
     ceph::buffer::list *outbl,   ///< [out] optional: reference the result here
     char *out);      ///< [out] optional: or copy it here
+  bool _fill_read_buffer(
+    FileReader *h,   ///< [in] buffer of this reader, with h->lock held
+    uint64_t offset, ///< [in] offset the buffer must cover
+    uint64_t len,    ///< [in] bytes the caller wants
+    uint64_t prefetch, ///< [in] read at least this many bytes
+    uint64_t *fetched); ///< [out] bytes read from disk
   int64_t _read_random(
     FileReader *h,   ///< [in] read from here
     uint64_t offset, ///< [in] offset
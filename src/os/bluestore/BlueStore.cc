@@ -1971,6 +1971,7 @@ BlueStore::OnodeRef BlueStore::OnodeSpace::lookup(const ghobject_t& oid)
     if (p == onode_map.end()) {
       ldout(cache->cct, 30) << __func__ << " " << oid << " miss" << dendl;
       cache->logger->inc(l_bluestore_onode_misses);
+      ++misses;
     } else {
       ldout(cache->cct, 30) << __func__ << " " << oid << " hit " << p->second
                             << " " << p->second->nref
@@ -1981,6 +1982,7 @@ BlueStore::OnodeRef BlueStore::OnodeSpace::lookup(const ghobject_t& oid)
       o = p->second;
 
       cache->logger->inc(l_bluestore_onode_hits);
+      ++hits;
     }
   }
 
@@ -2003,6 +2005,15 @@ bool BlueStore::OnodeSpace::empty()
   return onode_map.empty();
 }
 
+void BlueStore::OnodeSpace::add_stats(
+  uint64_t *onodes, uint64_t *_hits, uint64_t *_misses)
+{
+  std::lock_guard l(cache->lock);
+  *onodes += onode_map.size();
+  *_hits += hits;
+  *_misses += misses;
+}
+
 void BlueStore::OnodeSpace::rename(
   OnodeRef& oldo,
   const ghobject_t& old_oid,
@@ -4227,6 +4238,50 @@ void BlueStore::ExtentMap::fault_range(
   }
 }
 
+void BlueStore::ExtentMap::unload_clean_shards(
+  uint32_t offset,
+  uint32_t length,
+  unsigned max_loaded)
+{
+  if (shards.empty() || max_loaded == 0) {
+    return;
+  }
+  // update() marks shards clean when their txc is prepared; until that
+  // txc reaches the kv store, the decoded shard is the only current copy
+  if (onode->flushing_count.load()) {
+    return;
+  }
+  unsigned loaded = std::count_if(
+    shards.begin(), shards.end(),
+    [](const Shard& s) { return s.loaded; });
+  if (loaded <= max_loaded) {
+    return;
+  }
+  length = std::max<uint32_t>(length, 1);
+  for (size_t i = 0; i < shards.size() && loaded > max_loaded; ++i) {
+    auto& s = shards[i];
+    if (!s.loaded || s.dirty) {
+      continue;
+    }
+    uint32_t start = s.shard_info->offset;
+    uint32_t end = i + 1 < shards.size() ?
+      shards[i + 1].shard_info->offset : OBJECT_MAX_SIZE;
+    if (start < offset + length && offset < end) {
+      continue;
+    }
+    dout(20) << __func__ << " unloading shard 0x" << std::hex << start
+	     << std::dec << " (" << s.extents << " extents)" << dendl;
+    // extents never cross shard boundaries, and blobs used by more than
+    // one shard are spanning blobs, which stay in spanning_blob_map
+    auto p = extent_map.lower_bound(Extent(start));
+    while (p != extent_map.end() && p->logical_offset < end) {
+      rm(p++);
+    }
+    s.loaded = false;
+    --loaded;
+  }
+}
+
 void BlueStore::ExtentMap::dirty_range(
   uint32_t offset,
   uint32_t length)
@@ -5301,11 +5356,17 @@ void *BlueStore::MempoolThread::entry()
     }
     // cache balancing
     if (autotune_interval > 0 && next_balance < ceph_clock_now()) {
+      double kv_ratio = store->cache_kv_ratio;
+      double kv_onode_ratio = store->cache_kv_onode_ratio;
+      if (binned_kv_onode_cache != nullptr &&
+	  store->cct->_conf.get_val<bool>("bluestore_cache_kv_cf_balance")) {
+	_balance_kv_cf_ratios(&kv_ratio, &kv_onode_ratio);
+      }
       if (binned_kv_cache != nullptr) {
-        binned_kv_cache->set_cache_ratio(store->cache_kv_ratio);
+        binned_kv_cache->set_cache_ratio(kv_ratio);
       }
       if (binned_kv_onode_cache != nullptr) {
-        binned_kv_onode_cache->set_cache_ratio(store->cache_kv_onode_ratio);
+        binned_kv_onode_cache->set_cache_ratio(kv_onode_ratio);
       }
       meta_cache->set_cache_ratio(store->cache_meta_ratio);
       data_cache->set_cache_ratio(store->cache_data_ratio);
@@ -5421,6 +5482,50 @@ void BlueStore::MempoolThread::_resize_shards(bool interval_stats)
   }
 }
 
+void BlueStore::MempoolThread::_balance_kv_cf_ratios(
+  double* kv_ratio, double* kv_onode_ratio)
+{
+  // Move the combined kv ratio between the default and the onode column
+  // family block caches, towards the one that misses more: the misses a
+  // cache takes are what more memory would have saved.
+  uint64_t hits = 0, misses = 0, onode_hits = 0, onode_misses = 0;
+  if (store->db->get_cache_lookups(&hits, &misses) < 0 ||
+      store->db->get_cache_lookups(PREFIX_OBJ, &onode_hits, &onode_misses) < 0) {
+    return;
+  }
+  double total = *kv_ratio + *kv_onode_ratio;
+  if (total <= 0) {
+    return;
+  }
+  if (kv_onode_share < 0) {
+    kv_onode_share = *kv_onode_ratio / total;
+  } else {
+    uint64_t d_hits = hits - kv_hits;
+    uint64_t d_misses = misses - kv_misses;
+    uint64_t d_onode_hits = onode_hits - kv_onode_hits;
+    uint64_t d_onode_misses = onode_misses - kv_onode_misses;
+    if (d_misses + d_onode_misses > 0) {
+      double target = double(d_onode_misses) / (d_misses + d_onode_misses);
+      kv_onode_share = 0.8 * kv_onode_share + 0.2 * target;
+    }
+    double min_share =
+      store->cct->_conf.get_val<double>("bluestore_cache_kv_cf_balance_min_ratio");
+    kv_onode_share = std::clamp(kv_onode_share, min_share, 1.0 - min_share);
+    dout(10) << __func__ << " kv hit ratio "
+	     << (d_hits + d_misses ? double(d_hits) / (d_hits + d_misses) : 0)
+	     << " kv_onode hit ratio "
+	     << (d_onode_hits + d_onode_misses ?
+		 double(d_onode_hits) / (d_onode_hits + d_onode_misses) : 0)
+	     << " kv_onode share " << kv_onode_share << dendl;
+  }
+  kv_hits = hits;
+  kv_misses = misses;
+  kv_onode_hits = onode_hits;
+  kv_onode_misses = onode_misses;
+  *kv_onode_ratio = total * kv_onode_share;
+  *kv_ratio = total - *kv_onode_ratio;
+}
+
 void BlueStore::MempoolThread::_update_cache_settings()
 {
   // Nothing to do if pcm is not used.
@@ -5628,7 +5733,7 @@ void BlueStore::handle_discard(interval_set<uint64_t>& to_release)
 {
   dout(10) << __func__ << dendl;
   ceph_assert(alloc);
-  alloc->release(to_release);
+  alloc->traced_release(to_release);
 }
 
 BlueStore::BlueStore(CephContext *cct, const string& path)
@@ -5641,6 +5746,7 @@ BlueStore::BlueStore(CephContext *cct,
     throttle(cct),
     finisher(cct, "commit_finisher", "cfin"),
     kv_sync_thread(this),
+    kv_commit_thread(this),
     kv_finalize_thread(this),
     min_alloc_size(_min_alloc_size),
     min_alloc_size_order(std::countr_zero(_min_alloc_size)),
@@ -6228,6 +6334,12 @@ void BlueStore::_init_logger()
 		    NULL,
 		    PerfCountersBuilder::PRIO_DEBUGONLY,
 		    unit_t(UNIT_BYTES));
+  b.add_u64_counter(l_bluestore_deferred_merge_ios,
+		    "deferred_merge_ios",
+		    "Deferred ios of several sequencers merged into common writes");
+  b.add_u64_counter(l_bluestore_deferred_merge_writes,
+		    "deferred_merge_writes",
+		    "Device writes issued for merged deferred ios");
 
   b.add_u64_counter(l_bluestore_write_big_skipped_blobs,
       "write_big_skipped_blobs",
@@ -6412,6 +6524,56 @@ void BlueStore::_init_logger()
     "bsal",
     PerfCountersBuilder::PRIO_USEFUL);
 
+  // Latency axis configuration for state histograms, values are in nanoseconds
+  PerfHistogramCommon::axis_config_d state_hist_x_axis_config{
+    "Latency (usec)",
+    PerfHistogramCommon::SCALE_LOG2, ///< Latency in logarithmic scale
+    0,                               ///< Start at 0
+    10000,                           ///< Quantization unit is 10usec
+    32,                              ///< Enough to cover much longer than slow requests
+  };
+  // Transaction size axis configuration for state histograms, values are in bytes
+  PerfHistogramCommon::axis_config_d state_hist_y_axis_config{
+    "Transaction size (bytes)",
+    PerfHistogramCommon::SCALE_LOG2, ///< Size in logarithmic scale
+    0,                               ///< Start at 0
+    512,                             ///< Quantization unit is 512 bytes
+    24,                              ///< Enough to cover 4+G transactions
+  };
+  b.add_u64_counter_histogram(
+    l_bluestore_state_prepare_lat_hist, "state_prepare_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of prepare state latency vs. transaction size");
+  b.add_u64_counter_histogram(
+    l_bluestore_state_aio_wait_lat_hist, "state_aio_wait_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of aio_wait state latency vs. transaction size");
+  b.add_u64_counter_histogram(
+    l_bluestore_state_io_done_lat_hist, "state_io_done_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of io_done state latency vs. transaction size");
+  b.add_u64_counter_histogram(
+    l_bluestore_state_kv_queued_lat_hist, "state_kv_queued_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of kv_queued state latency vs. transaction size");
+  b.add_u64_counter_histogram(
+    l_bluestore_state_kv_committing_lat_hist,
+    "state_kv_committing_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of kv_committing state latency vs. transaction size");
+  b.add_u64_counter_histogram(
+    l_bluestore_state_kv_done_lat_hist, "state_kv_done_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of kv_done state latency vs. transaction size");
+  b.add_u64_counter_histogram(
+    l_bluestore_state_finishing_lat_hist, "state_finishing_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of finishing state latency vs. transaction size");
+  b.add_u64_counter_histogram(
+    l_bluestore_state_done_lat_hist, "state_done_lat_bytes_histogram",
+    state_hist_x_axis_config, state_hist_y_axis_config,
+    "Histogram of done state latency vs. transaction size");
+
   logger = b.create_perf_counters();
   cct->get_perfcounters_collection()->add(logger);
 }
@@ -7634,6 +7796,14 @@ int BlueStore::_prepare_db_environment(bool create, bool read_only,
 
   FreelistManager::setup_merge_operators(db, freelist_type);
   db->set_merge_operator(PREFIX_STAT, merge_op);
+  if (cct->_conf.get_val<bool>("bluestore_rocksdb_omap_prefix_filter")) {
+    // all omap keys of an object share the (pool, hash,) nid they start with
+    db->set_key_prefix_length(PREFIX_OMAP, sizeof(uint64_t));
+    db->set_key_prefix_length(PREFIX_PGMETA_OMAP, sizeof(uint64_t));
+    db->set_key_prefix_length(PREFIX_PERPOOL_OMAP, 2 * sizeof(uint64_t));
+    db->set_key_prefix_length(PREFIX_PERPG_OMAP,
+			      2 * sizeof(uint64_t) + sizeof(uint32_t));
+  }
   db->set_cache_size(cache_kv_ratio * cache_size);
   return 0;
 }
@@ -8617,6 +8787,48 @@ void BlueStore::set_cache_shards(unsigned num)
   }
 }
 
+void BlueStore::dump_cache_stats(Formatter *f)
+{
+  int onode_count = 0, buffers_bytes = 0;
+  for (auto i: onode_cache_shards) {
+    onode_count += i->_get_num();
+  }
+  for (auto i: buffer_cache_shards) {
+    buffers_bytes += i->_get_bytes();
+  }
+  f->dump_int("bluestore_onode", onode_count);
+  f->dump_int("bluestore_buffers", buffers_bytes);
+
+  // onodes are cached per collection, so they can be attributed to pools
+  struct pool_stats_t {
+    uint64_t onodes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  };
+  std::map<int64_t, pool_stats_t> pools;
+  {
+    std::shared_lock l(coll_lock);
+    for (auto& [cid, c] : coll_map) {
+      spg_t pgid;
+      if (!cid.is_pg(&pgid)) {
+	continue;
+      }
+      auto& p = pools[pgid.pool()];
+      c->onode_space.add_stats(&p.onodes, &p.hits, &p.misses);
+    }
+  }
+  f->open_array_section("bluestore_onode_pools");
+  for (auto& [pool, p] : pools) {
+    f->open_object_section("pool");
+    f->dump_int("pool", pool);
+    f->dump_unsigned("onodes", p.onodes);
+    f->dump_unsigned("hits", p.hits);
+    f->dump_unsigned("misses", p.misses);
+    f->close_section();
+  }
+  f->close_section();
+}
+
 //---------------------------------------------
 bool BlueStore::has_null_manager() const
 {
@@ -9653,10 +9865,11 @@ void BlueStore::_fsck_check_object_omap(FSCKDepth depth,
 	bluestore_onode_t::FLAG_PERPG_OMAP;
       const string& new_omap_prefix = Onode::calc_omap_prefix(new_flags);
 
-      KeyValueDB::Iterator it = db->get_iterator(prefix);
       string head, tail;
       o->get_omap_header(&head);
       o->get_omap_tail(&tail);
+      KeyValueDB::Iterator it = db->get_iterator(prefix, 0,
+	KeyValueDB::IteratorBounds{head, tail});
       it->lower_bound(head);
       // head
       if (it->valid() && it->key() == head) {
@@ -9726,6 +9939,28 @@ void BlueStore::_fsck_check_object_omap(FSCKDepth depth,
   }
 }
 
+int BlueStore::_fsck_deep_read_object(Collection* c, OnodeRef& o)
+{
+  bufferlist bl;
+  uint64_t max_read_block = cct->_conf->bluestore_fsck_read_bytes_cap;
+  uint64_t offset = 0;
+  do {
+    uint64_t l = std::min(uint64_t(o->onode.size - offset), max_read_block);
+    int r = _do_read(c, o, offset, l, bl,
+      CEPH_OSD_OP_FLAG_FADVISE_NOCACHE);
+    if (r < 0) {
+      derr << "fsck error: " << o->oid << std::hex
+        << " error during read: "
+        << " " << offset << "~" << l
+        << " " << cpp_strerror(r) << std::dec
+        << dendl;
+      return 1;
+    }
+    offset += l;
+  } while (offset < o->onode.size);
+  return 0;
+}
+
 void BlueStore::_fsck_check_objects(
   FSCKDepth depth,
   BlueStore::FSCK_ObjectCtx& ctx)
@@ -9764,6 +9999,44 @@ void BlueStore::_fsck_check_objects(
       thread_pool.start();
     }
 
+    // deep fsck reads and verifies the object data on a few threads of its
+    // own while this one goes on with the metadata checks
+    ceph::mutex deep_read_lock = ceph::make_mutex("BlueStore::fsck_deep_read");
+    ceph::condition_variable deep_read_cond;
+    std::deque<std::pair<CollectionRef, OnodeRef>> deep_read_queue;
+    bool deep_read_stop = false;
+    std::atomic<int64_t> deep_read_errors = 0;
+    std::vector<std::thread> deep_readers;
+    const size_t deep_read_threads =
+      cct->_conf.get_val<uint64_t>("bluestore_fsck_deep_read_threads");
+    const size_t deep_read_queue_max = deep_read_threads * 4;
+    if (depth == FSCK_DEEP) {
+      for (size_t i = 0; i < deep_read_threads; ++i) {
+        deep_readers.push_back(make_named_thread("bstore_fsck_rd", [&] {
+          std::unique_lock l(deep_read_lock);
+          while (true) {
+            deep_read_cond.wait(l, [&] {
+              return deep_read_stop || !deep_read_queue.empty();
+            });
+            if (deep_read_queue.empty()) {
+              break;
+            }
+            auto [rc, ro] = std::move(deep_read_queue.front());
+            deep_read_queue.pop_front();
+            deep_read_cond.notify_all();
+            l.unlock();
+            {
+              std::shared_lock cl(rc->lock);
+              deep_read_errors += _fsck_deep_read_object(rc.get(), ro);
+            }
+            ro.reset();
+            rc.reset();
+            l.lock();
+          }
+        }));
+      }
+    }
+
     // fill global if not overriden below
     CollectionRef c;
     int64_t pool_id = -1;
@@ -9949,27 +10222,30 @@ void BlueStore::_fsck_check_objects(
           }
         } // if (o->onode.has_omap())
         if (depth == FSCK_DEEP) {
-          bufferlist bl;
-          uint64_t max_read_block = cct->_conf->bluestore_fsck_read_bytes_cap;
-          uint64_t offset = 0;
-          do {
-            uint64_t l = std::min(uint64_t(o->onode.size - offset), max_read_block);
-            int r = _do_read(c.get(), o, offset, l, bl,
-              CEPH_OSD_OP_FLAG_FADVISE_NOCACHE);
-            if (r < 0) {
-              ++errors;
-              derr << "fsck error: " << oid << std::hex
-                << " error during read: "
-                << " " << offset << "~" << l
-                << " " << cpp_strerror(r) << std::dec
-                << dendl;
-              break;
-            }
-            offset += l;
-          } while (offset < o->onode.size);
+          if (deep_readers.empty()) {
+            errors += _fsck_deep_read_object(c.get(), o);
+          } else {
+            std::unique_lock l(deep_read_lock);
+            deep_read_cond.wait(l, [&] {
+              return deep_read_queue.size() < deep_read_queue_max;
+            });
+            deep_read_queue.emplace_back(c, o);
+            deep_read_cond.notify_all();
+          }
         } // deep
       } //if (depth != FSCK_SHALLOW)
     } // for (it->lower_bound(string()); it->valid(); it->next())
+    if (!deep_readers.empty()) {
+      {
+        std::lock_guard l(deep_read_lock);
+        deep_read_stop = true;
+        deep_read_cond.notify_all();
+      }
+      for (auto& t : deep_readers) {
+        t.join();
+      }
+      errors += deep_read_errors;
+    }
     if (depth == FSCK_SHALLOW && thread_count > 0) {
       wq->finalize(thread_pool, ctx);
       if (processed_myself) {
@@ -11529,6 +11805,25 @@ int BlueStore::set_collection_opts(
   return 0;
 }
 
+void BlueStore::_unload_clean_shards(
+  Collection *c,
+  OnodeRef& o,
+  uint64_t offset,
+  uint64_t length)
+{
+  auto max_loaded = cct->_conf->bluestore_extent_map_max_loaded_shards;
+  if (max_loaded == 0) {
+    return;
+  }
+  // other readers decode and walk shards under the shared lock, so they
+  // are only dropped under the exclusive one. a busy collection skips it
+  // rather than wait for it
+  std::unique_lock l(c->lock, std::try_to_lock);
+  if (l.owns_lock() && o->exists) {
+    o->extent_map.unload_clean_shards(offset, length, max_loaded);
+  }
+}
+
 int BlueStore::read(
   CollectionHandle &c_,
   const ghobject_t& oid,
@@ -11569,6 +11864,8 @@ int BlueStore::read(
     if (r == -EIO) {
       logger->inc(l_bluestore_read_eio);
     }
+    l.unlock();
+    _unload_clean_shards(c, o, offset, length);
   }
 
  out:
@@ -11666,7 +11963,9 @@ void BlueStore::_read_cache(
           regions2read_t& r2r = blobs2read[bptr];
           if (r2r.size()) {
             read_req_t& pre = r2r.back();
-            if (r_off <= (pre.r_off + pre.r_len)) {
+            // with vectored reads we may come back to a blob we have
+            // already planned, so only merge going forward
+            if (r_off >= pre.r_off && r_off <= (pre.r_off + pre.r_len)) {
               front += (r_off - pre.r_off);
               pre.r_len += (r_off + r_len - pre.r_off - pre.r_len);
               pre.regs.emplace_back(region_t(pos, b_off, l, front));
@@ -11758,16 +12057,13 @@ int BlueStore::_prepare_read_ioc(
   return 0;
 }
 
-int BlueStore::_generate_read_result_bl(
+int BlueStore::_decode_read_result(
   OnodeRef& o,
-  uint64_t offset,
-  size_t length,
   ready_regions_t& ready_regions,
   vector<bufferlist>& compressed_blob_bls,
   blobs2read_t& blobs2read,
   bool buffered,
-  bool* csum_error,
-  bufferlist& bl)
+  bool* csum_error)
 {
  // enumerate and decompress desired blobs
   auto p = compressed_blob_bls.begin();
@@ -11819,10 +12115,18 @@ int BlueStore::_generate_read_result_bl(
     }
     ++b2r_it;
   }
+  return 0;
+}
 
-  // generate a resulting buffer
-  auto pr = ready_regions.begin();
-  auto pr_end = ready_regions.end();
+void BlueStore::_assemble_read_result(
+  uint64_t offset,
+  size_t length,
+  ready_regions_t::iterator& pr,
+  const ready_regions_t::iterator& pr_end,
+  bufferlist& bl)
+{
+  // ready regions past offset~length belong to a later extent of a
+  // vectored read; we stop in front of them and leave pr pointing there.
   uint64_t pos = 0;
   while (pos < length) {
     if (pr != pr_end && pr->first == pos + offset) {
@@ -11834,7 +12138,7 @@ int BlueStore::_generate_read_result_bl(
       ++pr;
     } else {
       uint64_t l = length - pos;
-      if (pr != pr_end) {
+      if (pr != pr_end && pr->first < offset + length) {
         ceph_assert(pr->first > pos + offset);
         l = pr->first - (pos + offset);
       }
@@ -11845,9 +12149,31 @@ int BlueStore::_generate_read_result_bl(
       pos += l;
     }
   }
-  ceph_assert(bl.length() == length);
   ceph_assert(pos == length);
-  ceph_assert(pr == pr_end);
+}
+
+int BlueStore::_generate_read_result_bl(
+  OnodeRef& o,
+  uint64_t offset,
+  size_t length,
+  ready_regions_t& ready_regions,
+  vector<bufferlist>& compressed_blob_bls,
+  blobs2read_t& blobs2read,
+  bool buffered,
+  bool* csum_error,
+  bufferlist& bl)
+{
+  int r = _decode_read_result(o, ready_regions, compressed_blob_bls,
+                              blobs2read, buffered, csum_error);
+  if (r < 0) {
+    return r;
+  }
+
+  // generate a resulting buffer
+  auto pr = ready_regions.begin();
+  _assemble_read_result(offset, length, pr, ready_regions.end(), bl);
+  ceph_assert(bl.length() == length);
+  ceph_assert(pr == ready_regions.end());
   return 0;
 }
 
@@ -12199,6 +12525,9 @@ int BlueStore::readv(
     if (r == -EIO) {
       logger->inc(l_bluestore_read_eio);
     }
+    l.unlock();
+    _unload_clean_shards(c, o, m.range_start(),
+			 m.range_end() - m.range_start());
   }
 
  out:
@@ -12266,19 +12595,21 @@ int BlueStore::_do_readv(
     "", l_bluestore_slow_read_onode_meta_count);
   _dump_onode<30>(cct, *o);
 
+  // plan the whole vector up front: regions of the same blob that come
+  // from different extents are merged into shared device reads, and each
+  // blob is checksummed (and decompressed) once rather than per extent.
   IOContext ioc(cct, NULL, !cct->_conf->bluestore_fail_eio);
-  vector<std::tuple<ready_regions_t, vector<bufferlist>, blobs2read_t>> raw_results;
-  raw_results.reserve(m.num_intervals());
-  int i = 0;
-  for (auto p = m.begin(); p != m.end(); p++, i++) {
-    raw_results.push_back({});
+  ready_regions_t ready_regions;
+  vector<bufferlist> compressed_blob_bls;
+  blobs2read_t blobs2read;
+  for (auto p = m.begin(); p != m.end(); p++) {
     _read_cache(o, p.get_start(), p.get_len(), read_cache_policy,
-                std::get<0>(raw_results[i]), std::get<2>(raw_results[i]));
-    r = _prepare_read_ioc(std::get<2>(raw_results[i]), &std::get<1>(raw_results[i]), &ioc);
-    // we always issue aio for reading, so errors other than EIO are not allowed
-    if (r < 0)
-      return r;
+                ready_regions, blobs2read);
   }
+  r = _prepare_read_ioc(blobs2read, &compressed_blob_bls, &ioc);
+  // we always issue aio for reading, so errors other than EIO are not allowed
+  if (r < 0)
+    return r;
 
   auto num_ios = m.size();
   if (ioc.has_pending_aios()) {
@@ -12300,29 +12631,29 @@ int BlueStore::_do_readv(
     l_bluestore_slow_read_wait_aio_count
   );
 
-  ceph_assert(raw_results.size() == (size_t)m.num_intervals());
-  i = 0;
-  for (auto p = m.begin(); p != m.end(); p++, i++) {
-    bool csum_error = false;
-    bufferlist t;
-    r = _generate_read_result_bl(o, p.get_start(), p.get_len(),
-                                 std::get<0>(raw_results[i]),
-                                 std::get<1>(raw_results[i]),
-                                 std::get<2>(raw_results[i]),
-                                 buffered, &csum_error, t);
-    if (csum_error) {
-      // Handles spurious read errors caused by a kernel bug.
-      // We sometimes get all-zero pages as a result of the read under
-      // high memory pressure. Retrying the failing read succeeds in most
-      // cases.
-      // See also: http://tracker.ceph.com/issues/22464
-      if (retry_count >= cct->_conf->bluestore_retry_disk_reads) {
-        return -EIO;
-      }
-      return _do_readv(c, o, m, bl, op_flags, retry_count + 1);
+  bool csum_error = false;
+  r = _decode_read_result(o, ready_regions, compressed_blob_bls, blobs2read,
+                          buffered, &csum_error);
+  if (csum_error) {
+    // Handles spurious read errors caused by a kernel bug.
+    // We sometimes get all-zero pages as a result of the read under
+    // high memory pressure. Retrying the failing read succeeds in most
+    // cases.
+    // See also: http://tracker.ceph.com/issues/22464
+    if (retry_count >= cct->_conf->bluestore_retry_disk_reads) {
+      return -EIO;
     }
-    bl.claim_append(t);
+    return _do_readv(c, o, m, bl, op_flags, retry_count + 1);
+  }
+  if (r < 0) {
+    return r;
   }
+  auto pr = ready_regions.begin();
+  for (auto p = m.begin(); p != m.end(); p++) {
+    _assemble_read_result(p.get_start(), p.get_len(), pr,
+                          ready_regions.end(), bl);
+  }
+  ceph_assert(pr == ready_regions.end());
   if (retry_count) {
     logger->inc(l_bluestore_reads_with_retries);
     dout(5) << __func__ << " read fiemap " << m
@@ -12497,6 +12828,9 @@ int BlueStore::collection_list(
   {
     std::shared_lock l(c->lock);
     r = _collection_list(c, start, end, max, false, ls, pnext);
+    if (r == 0) {
+      _prefetch_onodes(c, *ls);
+    }
   }
 
   dout(10) << __func__ << " " << c->cid
@@ -12655,6 +12989,82 @@ int BlueStore::_collection_list(
   return 0;
 }
 
+void BlueStore::_prefetch_onodes(Collection *c, const vector<ghobject_t>& ls)
+{
+  unsigned max = cct->_conf->bluestore_collection_list_prefetch_onodes;
+  if (max == 0) {
+    return;
+  }
+  // keys of the onodes we don't have yet, in kv order
+  std::map<string, ghobject_t> keys;
+  for (auto& oid : ls) {
+    if (keys.size() >= max) {
+      break;
+    }
+    if (c->onode_space.lookup(oid)) {
+      continue;
+    }
+    string key;
+    get_object_key(cct, oid, &key);
+    keys.emplace(std::move(key), oid);
+  }
+  if (keys.empty()) {
+    return;
+  }
+
+  unsigned loaded = 0, shards = 0;
+  KeyValueDB::Iterator it = db->get_iterator(PREFIX_OBJ);
+  it->lower_bound(keys.begin()->first);
+  for (auto& [key, oid] : keys) {
+    // the next onode is usually right after the shards of the previous one
+    for (unsigned n = 0; n < 8 && it->valid() && it->key() < key; ++n) {
+      it->next();
+    }
+    if (it->valid() && it->key() < key) {
+      it->lower_bound(key);
+    }
+    if (!it->valid()) {
+      break;
+    }
+    if (it->key() != key) {
+      continue;
+    }
+    bufferlist v = it->value();
+    Onode *on = Onode::create_decode(c, oid, key, v, false);
+    OnodeRef o(on);
+    o = c->onode_space.add_onode(oid, o);
+    ++loaded;
+    it->next();
+    if (o.get() != on) {
+      continue;  // someone else loaded it meanwhile
+    }
+    // its extent map shards follow the onode key
+    string skey;
+    for (auto& s : o->extent_map.shards) {
+      generate_extent_shard_key_and_apply(
+	key, s.shard_info->offset, &skey,
+	[&](const string& final_key) {
+	  if (!it->valid() || it->key() != final_key) {
+	    return;
+	  }
+	  bufferlist sv = it->value();
+	  if (sv.length() != s.shard_info->bytes) {
+	    return;
+	  }
+	  s.extents = o->extent_map.decode_some(sv);
+	  s.loaded = true;
+	  ++shards;
+	  it->next();
+	});
+      if (!s.loaded) {
+	break;  // leave the rest to fault_range()
+      }
+    }
+  }
+  dout(20) << __func__ << " " << c->cid << " loaded " << loaded << "/"
+	   << keys.size() << " onodes, " << shards << " shards" << dendl;
+}
+
 int BlueStore::omap_get(
   CollectionHandle &c_,    ///< [in] Collection containing oid
   const ghobject_t &oid,   ///< [in] Object containing omap
@@ -13235,12 +13645,26 @@ void BlueStore::get_db_statistics(Formatter *f)
   db->get_statistics(f);
 }
 
+void BlueStore::_txc_destroy(TransContext *txc)
+{
+  // the txc may hold the last ref to its sequencer
+  OpSequencerRef osr = txc->osr;
+  txc->~TransContext();
+  if (!osr->put_txc_storage(txc, cct->_conf->bluestore_txc_cache_size)) {
+    TransContext::operator delete(txc);
+  }
+}
+
 BlueStore::TransContext *BlueStore::_txc_create(
   Collection *c, OpSequencer *osr,
   list<Context*> *on_commits,
   TrackedOpRef osd_op)
 {
-  TransContext *txc = new TransContext(cct, c, osr, on_commits);
+  // reuse the memory of a finished txc of this sequencer if we can
+  void *p = osr->get_txc_storage();
+  TransContext *txc = p ?
+    ::new (p) TransContext(cct, c, osr, on_commits) :
+    new TransContext(cct, c, osr, on_commits);
   txc->t = db->get_transaction();
 
 #ifdef WITH_BLKIN
@@ -13383,6 +13807,9 @@ void BlueStore::_txc_state_proc(TransContext *txc)
 	if (!kv_sync_in_progress) {
 	  kv_sync_in_progress = true;
 	  kv_cond.notify_one();
+	} else if (kv_sync_batching &&
+		   kv_queue.size() >= cct->_conf->bluestore_kv_sync_batch_target) {
+	  kv_cond.notify_one();
 	}
 	if (txc->get_state() != TransContext::STATE_KV_SUBMITTED) {
 	  kv_queue_unsubmitted.push_back(txc);
@@ -13471,8 +13898,10 @@ void BlueStore::_txc_write_nodes(TransContext *txc, KeyValueDB::Transaction t)
 
   // finalize onodes
   for (auto o : txc->onodes) {
-    _record_onode(o, t);
+    // counted before _record_onode() marks the shards clean, see
+    // ExtentMap::unload_clean_shards()
     o->flushing_count++;
+    _record_onode(o, t);
   }
 
   // objects we modified but didn't affect the onode
@@ -13707,7 +14136,7 @@ void BlueStore::_txc_finish(TransContext *txc)
     releasing_txc.pop_front();
     throttle.log_state_latency(*txc, logger, l_bluestore_state_done_lat);
     throttle.complete(*txc);
-    delete txc;
+    _txc_destroy(txc);
   }
 
   if (submit_deferred) {
@@ -13741,7 +14170,7 @@ void BlueStore::_txc_release_alloc(TransContext *txc)
   if (!discard_queued) {
       dout(10) << __func__ << "(sync) " << txc << " " << std::hex
                << txc->released << std::dec << dendl;
-      alloc->release(txc->released);
+      alloc->traced_release(txc->released);
   }
 
 out:
@@ -13905,13 +14334,19 @@ void BlueStore::_kv_start()
   dout(10) << __func__ << dendl;
 
   finisher.start();
+  kv_sync_pipeline = cct->_conf.get_val<bool>("bluestore_kv_sync_pipeline");
   kv_sync_thread.create("bstore_kv_sync");
+  if (kv_sync_pipeline) {
+    kv_commit_thread.create("bstore_kv_cmt");
+  }
   kv_finalize_thread.create("bstore_kv_final");
+  _compress_threads_start();
 }
 
 void BlueStore::_kv_stop()
 {
   dout(10) << __func__ << dendl;
+  _compress_threads_stop();
   {
     std::unique_lock l{kv_lock};
     while (!kv_sync_started) {
@@ -13920,6 +14355,22 @@ void BlueStore::_kv_stop()
     kv_stop = true;
     kv_cond.notify_all();
   }
+  // the commit thread drains whatever the sync thread handed over, and
+  // only then may the finalizer stop.
+  kv_sync_thread.join();
+  if (kv_sync_pipeline) {
+    {
+      std::unique_lock l{kv_commit_lock};
+      while (!kv_commit_started) {
+	kv_commit_cond.wait(l);
+      }
+      kv_commit_stop = true;
+      kv_commit_cond.notify_all();
+    }
+    kv_commit_thread.join();
+    std::lock_guard l{kv_commit_lock};
+    kv_commit_stop = false;
+  }
   {
     std::unique_lock l{kv_finalize_lock};
     while (!kv_finalize_started) {
@@ -13928,7 +14379,6 @@ void BlueStore::_kv_stop()
     kv_finalize_stop = true;
     kv_finalize_cond.notify_all();
   }
-  kv_sync_thread.join();
   kv_finalize_thread.join();
   ceph_assert(removed_collections.empty());
   {
@@ -13945,6 +14395,78 @@ void BlueStore::_kv_stop()
   dout(10) << __func__ << " stopped" << dendl;
 }
 
+void BlueStore::_compress_threads_start()
+{
+  auto n = cct->_conf.get_val<uint64_t>("bluestore_compression_threads");
+  for (uint64_t i = 0; i < n; ++i) {
+    compress_threads.push_back(make_named_thread("bstore_compress", [this] {
+      std::unique_lock l{compress_lock};
+      while (true) {
+	compress_cond.wait(l, [this] {
+	  return compress_stop || !compress_queue.empty();
+	});
+	if (compress_queue.empty()) {
+	  break;
+	}
+	auto f = std::move(compress_queue.front());
+	compress_queue.pop_front();
+	l.unlock();
+	f();
+	l.lock();
+      }
+    }));
+  }
+}
+
+void BlueStore::_compress_threads_stop()
+{
+  {
+    std::lock_guard l{compress_lock};
+    compress_stop = true;
+    compress_cond.notify_all();
+  }
+  for (auto& t : compress_threads) {
+    t.join();
+  }
+  compress_threads.clear();
+  std::lock_guard l{compress_lock};
+  compress_stop = false;
+}
+
+void BlueStore::_compress_parallel(
+  size_t n,
+  const std::function<void(size_t)>& f)
+{
+  std::atomic<size_t> next = 0;
+  auto work = [&] {
+    for (size_t i = next++; i < n; i = next++) {
+      f(i);
+    }
+  };
+  ceph::mutex done_lock = ceph::make_mutex("BlueStore::compress_parallel");
+  ceph::condition_variable done_cond;
+  size_t helpers = std::min(n - 1, compress_threads.size());
+  size_t running = helpers;
+  {
+    std::lock_guard l{compress_lock};
+    for (size_t i = 0; i < helpers; ++i) {
+      compress_queue.emplace_back([&] {
+	work();
+	std::lock_guard dl{done_lock};
+	if (--running == 0) {
+	  done_cond.notify_one();
+	}
+      });
+    }
+    compress_cond.notify_all();
+  }
+  work();
+  // the helpers refer to our stack, wait for all of them even if there
+  // was nothing left to do by the time they got to it
+  std::unique_lock l{done_lock};
+  done_cond.wait(l, [&] { return running == 0; });
+}
+
 void BlueStore::_kv_sync_thread()
 {
   dout(10) << __func__ << " start" << dendl;
@@ -13986,6 +14508,20 @@ void BlueStore::_kv_sync_thread()
 
       dout(20) << __func__ << " wake" << dendl;
     } else {
+      auto batch_window = cct->_conf->bluestore_kv_sync_batch_window_us;
+      if (batch_window && !kv_stop && !deferred_aggressive &&
+	  !kv_queue.empty() &&
+	  kv_queue.size() < cct->_conf->bluestore_kv_sync_batch_target) {
+	// let txcs from other sequencers join this commit, so that they
+	// share one kv sync and device flush
+	dout(20) << __func__ << " waiting up to " << batch_window
+		 << "us for more than " << kv_queue.size() << " txcs" << dendl;
+	auto t = mono_clock::now();
+	kv_sync_batching = true;
+	kv_cond.wait_for(l, std::chrono::microseconds(batch_window));
+	kv_sync_batching = false;
+	twait += mono_clock::now() - t;
+      }
       deque<TransContext*> kv_submitting;
       deque<DeferredBatch*> deferred_done, deferred_stable;
       uint64_t aios = 0, costs = 0;
@@ -14111,109 +14647,160 @@ void BlueStore::_kv_sync_thread()
 	}
       }
 
+      auto batch = std::make_unique<KVCommitBatch>();
+      batch->synct = synct;
+      batch->kv_committing.swap(kv_committing);
+      batch->deferred_stable.swap(deferred_stable);
+      batch->deferred_done_size = deferred_done.size();
+      batch->new_nid_max = new_nid_max;
+      batch->new_blobid_max = new_blobid_max;
+      batch->start = start;
+      batch->after_flush = after_flush;
+      if (kv_sync_pipeline) {
+	// let the commit thread do the synchronous commit while we collect
+	// and flush for the next batch.  batches are committed strictly in
+	// order, so deferred ios that become stable by virtue of this commit
+	// cycle (see below) are only cleaned up by a later synct.
+	std::unique_lock m{kv_commit_lock};
+	kv_commit_cond.wait(m, [this] { return !kv_commit_pending; });
+	kv_commit_pending = std::move(batch);
+	kv_commit_cond.notify_all();
+      } else {
+	_kv_commit_batch(*batch);
+      }
+
+      l.lock();
+      // previously deferred "done" are now "stable" by virtue of this
+      // commit cycle.
+      deferred_stable_queue.swap(deferred_done);
+    }
+  }
+  dout(10) << __func__ << " finish" << dendl;
+  kv_sync_started = false;
+}
+
+void BlueStore::_kv_commit_batch(KVCommitBatch& b)
+{
 #if defined(WITH_LTTNG)
-      auto sync_start = mono_clock::now();
+  auto sync_start = mono_clock::now();
 #endif
-      // submit synct synchronously (block and wait for it to commit)
-      int r = cct->_conf->bluestore_debug_omit_kv_commit ? 0 : db->submit_transaction_sync(synct);
-      ceph_assert(r == 0);
+  // submit synct synchronously (block and wait for it to commit)
+  int r = cct->_conf->bluestore_debug_omit_kv_commit ? 0 : db->submit_transaction_sync(b.synct);
+  ceph_assert(r == 0);
 
 #ifdef WITH_BLKIN
-      for (auto txc : kv_committing) {
-        if (txc->trace) {
-          txc->trace.event("db sync submit");
-          txc->trace.keyval("kv_committing size", kv_committing.size());
-        }
-      }
+  for (auto txc : b.kv_committing) {
+    if (txc->trace) {
+      txc->trace.event("db sync submit");
+      txc->trace.keyval("kv_committing size", b.kv_committing.size());
+    }
+  }
 #endif
 
-      int committing_size = kv_committing.size();
-      int deferred_size = deferred_stable.size();
+  int committing_size = b.kv_committing.size();
+  int deferred_size = b.deferred_stable.size();
 
 #if defined(WITH_LTTNG)
-      double sync_latency = ceph::to_seconds<double>(mono_clock::now() - sync_start);
-      for (auto txc: kv_committing) {
-	if (txc->tracing) {
-	  tracepoint(
-	    bluestore,
-	    transaction_kv_sync_latency,
-	    txc->osr->get_sequencer_id(),
-	    txc->seq,
-	    kv_committing.size(),
-	    deferred_done.size(),
-	    deferred_stable.size(),
-	    sync_latency);
-	}
-      }
+  double sync_latency = ceph::to_seconds<double>(mono_clock::now() - sync_start);
+  for (auto txc: b.kv_committing) {
+    if (txc->tracing) {
+      tracepoint(
+	bluestore,
+	transaction_kv_sync_latency,
+	txc->osr->get_sequencer_id(),
+	txc->seq,
+	b.kv_committing.size(),
+	b.deferred_done_size,
+	b.deferred_stable.size(),
+	sync_latency);
+    }
+  }
 #endif
 
-      {
-	std::unique_lock m{kv_finalize_lock};
-	if (kv_committing_to_finalize.empty()) {
-	  kv_committing_to_finalize.swap(kv_committing);
-	} else {
-	  kv_committing_to_finalize.insert(
-	      kv_committing_to_finalize.end(),
-	      kv_committing.begin(),
-	      kv_committing.end());
-	  kv_committing.clear();
-	}
-	if (deferred_stable_to_finalize.empty()) {
-	  deferred_stable_to_finalize.swap(deferred_stable);
-	} else {
-	  deferred_stable_to_finalize.insert(
-	      deferred_stable_to_finalize.end(),
-	      deferred_stable.begin(),
-	      deferred_stable.end());
-	  deferred_stable.clear();
-	}
-	if (!kv_finalize_in_progress) {
-	  kv_finalize_in_progress = true;
-	  kv_finalize_cond.notify_one();
-	}
-      }
+  {
+    std::unique_lock m{kv_finalize_lock};
+    if (kv_committing_to_finalize.empty()) {
+      kv_committing_to_finalize.swap(b.kv_committing);
+    } else {
+      kv_committing_to_finalize.insert(
+	  kv_committing_to_finalize.end(),
+	  b.kv_committing.begin(),
+	  b.kv_committing.end());
+      b.kv_committing.clear();
+    }
+    if (deferred_stable_to_finalize.empty()) {
+      deferred_stable_to_finalize.swap(b.deferred_stable);
+    } else {
+      deferred_stable_to_finalize.insert(
+	  deferred_stable_to_finalize.end(),
+	  b.deferred_stable.begin(),
+	  b.deferred_stable.end());
+      b.deferred_stable.clear();
+    }
+    if (!kv_finalize_in_progress) {
+      kv_finalize_in_progress = true;
+      kv_finalize_cond.notify_one();
+    }
+  }
 
-      if (new_nid_max) {
-	nid_max = new_nid_max;
-	dout(10) << __func__ << " nid_max now " << nid_max << dendl;
-      }
-      if (new_blobid_max) {
-	blobid_max = new_blobid_max;
-	dout(10) << __func__ << " blobid_max now " << blobid_max << dendl;
-      }
+  if (b.new_nid_max) {
+    nid_max = b.new_nid_max;
+    dout(10) << __func__ << " nid_max now " << nid_max << dendl;
+  }
+  if (b.new_blobid_max) {
+    blobid_max = b.new_blobid_max;
+    dout(10) << __func__ << " blobid_max now " << blobid_max << dendl;
+  }
 
-      {
-	auto finish = mono_clock::now();
-	ceph::timespan dur_flush = after_flush - start;
-	ceph::timespan dur_kv = finish - after_flush;
-	ceph::timespan dur = finish - start;
-	dout(20) << __func__ << " committed " << committing_size
-	  << " cleaned " << deferred_size
-	  << " in " << dur
-	  << " (" << dur_flush << " flush + " << dur_kv << " kv commit)"
-	  << dendl;
-	log_latency("kv_flush",
-	  l_bluestore_kv_flush_lat,
-	  dur_flush,
-	  cct->_conf->bluestore_log_op_age);
-	log_latency("kv_commit",
-	  l_bluestore_kv_commit_lat,
-	  dur_kv,
-	  cct->_conf->bluestore_log_op_age);
-	log_latency("kv_sync",
-	  l_bluestore_kv_sync_lat,
-	  dur,
-	  cct->_conf->bluestore_log_op_age);
-      }
+  {
+    auto finish = mono_clock::now();
+    ceph::timespan dur_flush = b.after_flush - b.start;
+    ceph::timespan dur_kv = finish - b.after_flush;
+    ceph::timespan dur = finish - b.start;
+    dout(20) << __func__ << " committed " << committing_size
+      << " cleaned " << deferred_size
+      << " in " << dur
+      << " (" << dur_flush << " flush + " << dur_kv << " kv commit)"
+      << dendl;
+    log_latency("kv_flush",
+      l_bluestore_kv_flush_lat,
+      dur_flush,
+      cct->_conf->bluestore_log_op_age);
+    log_latency("kv_commit",
+      l_bluestore_kv_commit_lat,
+      dur_kv,
+      cct->_conf->bluestore_log_op_age);
+    log_latency("kv_sync",
+      l_bluestore_kv_sync_lat,
+      dur,
+      cct->_conf->bluestore_log_op_age);
+  }
+}
 
+void BlueStore::_kv_commit_thread()
+{
+  dout(10) << __func__ << " start" << dendl;
+  std::unique_lock l{kv_commit_lock};
+  ceph_assert(!kv_commit_started);
+  kv_commit_started = true;
+  kv_commit_cond.notify_all();
+  while (true) {
+    if (!kv_commit_pending) {
+      if (kv_commit_stop)
+	break;
+      dout(20) << __func__ << " sleep" << dendl;
+      kv_commit_cond.wait(l);
+      dout(20) << __func__ << " wake" << dendl;
+    } else {
+      auto batch = std::move(kv_commit_pending);
+      kv_commit_cond.notify_all();
+      l.unlock();
+      _kv_commit_batch(*batch);
       l.lock();
-      // previously deferred "done" are now "stable" by virtue of this
-      // commit cycle.
-      deferred_stable_queue.swap(deferred_done);
     }
   }
   dout(10) << __func__ << " finish" << dendl;
-  kv_sync_started = false;
+  kv_commit_started = false;
 }
 
 void BlueStore::_kv_finalize_thread()
@@ -14360,11 +14947,19 @@ void BlueStore::deferred_try_submit()
     }
   }
 
+  // with merging, write the pending batches of all sequencers out
+  // together, sorted and coalesced by device offset
+  bool merge = osrs.size() > 1 && cct->_conf->bluestore_deferred_merge;
+  vector<DeferredBatch*> batches;
   for (auto& osr : osrs) {
     osr->deferred_lock.lock();
     if (osr->deferred_pending) {
       if (!osr->deferred_running) {
-	_deferred_submit_unlock(osr.get());
+	if (merge) {
+	  batches.push_back(_deferred_start_unlock(osr.get()));
+	} else {
+	  _deferred_submit_unlock(osr.get());
+	}
       } else {
 	osr->deferred_lock.unlock();
 	dout(20) << __func__ << "  osr " << osr << " already has running"
@@ -14375,6 +14970,9 @@ void BlueStore::deferred_try_submit()
       dout(20) << __func__ << "  osr " << osr << " has no pending" << dendl;
     }
   }
+  if (!batches.empty()) {
+    _deferred_submit_merged(batches);
+  }
 
   {
     std::lock_guard l(deferred_lock);
@@ -14383,6 +14981,13 @@ void BlueStore::deferred_try_submit()
 }
 
 void BlueStore::_deferred_submit_unlock(OpSequencer *osr)
+{
+  auto b = _deferred_start_unlock(osr);
+  _deferred_write(b->iomap, &b->ioc);
+  bdev->aio_submit(&b->ioc);
+}
+
+BlueStore::DeferredBatch *BlueStore::_deferred_start_unlock(OpSequencer *osr)
 {
   dout(10) << __func__ << " osr " << osr
 	   << " " << osr->deferred_pending->iomap.size() << " ios pending "
@@ -14402,23 +15007,32 @@ void BlueStore::_deferred_submit_unlock(OpSequencer *osr)
   for (auto& txc : b->txcs) {
     throttle.log_state_latency(txc, logger, l_bluestore_state_deferred_queued_lat);
   }
+  return b;
+}
+
+unsigned BlueStore::_deferred_write(
+  std::map<uint64_t,DeferredBatch::deferred_io>& iomap,
+  IOContext *ioc)
+{
+  unsigned writes = 0;
   uint64_t start = 0, pos = 0;
   bufferlist bl;
-  auto i = b->iomap.begin();
+  auto i = iomap.begin();
   while (true) {
-    if (i == b->iomap.end() || i->first != pos) {
+    if (i == iomap.end() || i->first != pos) {
       if (bl.length()) {
 	dout(20) << __func__ << " write 0x" << std::hex
 		 << start << "~" << bl.length()
 		 << " crc " << bl.crc32c(-1) << std::dec << dendl;
+	++writes;
 	if (!g_conf()->bluestore_debug_omit_block_device_write) {
 	  logger->inc(l_bluestore_submitted_deferred_writes);
 	  logger->inc(l_bluestore_submitted_deferred_write_bytes, bl.length());
-	  int r = bdev->aio_write(start, bl, &b->ioc, false);
+	  int r = bdev->aio_write(start, bl, ioc, false);
 	  ceph_assert(r == 0);
 	}
       }
-      if (i == b->iomap.end()) {
+      if (i == iomap.end()) {
 	break;
       }
       start = 0;
@@ -14435,8 +15049,60 @@ void BlueStore::_deferred_submit_unlock(OpSequencer *osr)
     bl.claim_append(i->second.bl);
     ++i;
   }
-
-  bdev->aio_submit(&b->ioc);
+  return writes;
+}
+
+void BlueStore::_deferred_submit_merged(
+  const std::vector<DeferredBatch*>& batches)
+{
+  // Batches go into the same merge until it holds
+  // bluestore_deferred_merge_max_bytes: all of them complete only once
+  // the last write of the merge does.
+  uint64_t max_bytes = cct->_conf->bluestore_deferred_merge_max_bytes;
+  DeferredMerge *m = nullptr;
+  uint64_t m_bytes = 0;
+  auto submit = [&]() {
+    dout(10) << __func__ << " " << m->batches.size() << " batches, "
+	     << m->iomap.size() << " ios, 0x" << std::hex << m_bytes
+	     << std::dec << " bytes" << dendl;
+    logger->inc(l_bluestore_deferred_merge_ios, m->iomap.size());
+    logger->inc(l_bluestore_deferred_merge_writes,
+		_deferred_write(m->iomap, &m->ioc));
+    bdev->aio_submit(&m->ioc);
+    m = nullptr;
+    m_bytes = 0;
+  };
+  for (auto b : batches) {
+    uint64_t bytes = 0;
+    bool overlaps = false;
+    for (auto& [offset, io] : b->iomap) {
+      bytes += io.bl.length();
+      if (m && !overlaps) {
+	// never expected, but the device has to see the writes of a
+	// batch in a particular order then
+	auto p = m->iomap.lower_bound(offset);
+	if (p != m->iomap.end() && p->first < offset + io.bl.length()) {
+	  overlaps = true;
+	} else if (p != m->iomap.begin() &&
+		   std::prev(p)->first + std::prev(p)->second.bl.length() > offset) {
+	  overlaps = true;
+	}
+      }
+    }
+    if (m && (overlaps || m_bytes + bytes > max_bytes)) {
+      submit();
+    }
+    if (!m) {
+      m = new DeferredMerge(cct);
+    }
+    m->batches.push_back(b);
+    m->iomap.merge(b->iomap);
+    ceph_assert(b->iomap.empty());
+    m_bytes += bytes;
+  }
+  if (m) {
+    submit();
+  }
 }
 
 struct C_DeferredTrySubmit : public Context {
@@ -16018,10 +16684,41 @@ int BlueStore::_do_alloc_write(
   // We assume that allocator does its best to provide contiguous space,
   // and the condition is : (data_size < deferred).
 
+  // a large write spans several blobs; with compress threads, compress
+  // them all at once up front instead of one after the other below
+  struct compressed_t {
+    int r = 0;
+    bufferlist bl;
+    std::optional<int32_t> message;
+    ceph::timespan lat = ceph::timespan::zero();
+  };
+  std::vector<compressed_t> compressed;
+  if (c && !compress_threads.empty()) {
+    std::vector<size_t> todo;
+    for (size_t i = 0; i < wctx->writes.size(); ++i) {
+      if (wctx->writes[i].blob_length > min_alloc_size) {
+	todo.push_back(i);
+      }
+    }
+    if (todo.size() > 1) {
+      compressed.resize(wctx->writes.size());
+      _compress_parallel(todo.size(), [&](size_t k) {
+	auto& wi = wctx->writes[todo[k]];
+	auto& cr = compressed[todo[k]];
+	auto start = mono_clock::now();
+	cr.r = c->compress(wi.bl, cr.bl, cr.message);
+	cr.lat = mono_clock::now() - start;
+      });
+    }
+  }
+
   auto max_bsize = std::max(wctx->target_blob_size, min_alloc_size);
-  for (auto& wi : wctx->writes) {
+  for (size_t wi_idx = 0; wi_idx < wctx->writes.size(); ++wi_idx) {
+    auto& wi = wctx->writes[wi_idx];
     if (c && wi.blob_length > min_alloc_size) {
       auto start = mono_clock::now();
+      // a blob compressed up front still counts the time that took
+      auto precompress_lat = ceph::timespan::zero();
 
       // compress
       ceph_assert(wi.b_off == 0);
@@ -16030,7 +16727,15 @@ int BlueStore::_do_alloc_write(
       // FIXME: memory alignment here is bad
       bufferlist t;
       std::optional<int32_t> compressor_message;
-      int r = c->compress(wi.bl, t, compressor_message);
+      int r;
+      if (!compressed.empty()) {
+	r = compressed[wi_idx].r;
+	t.claim_append(compressed[wi_idx].bl);
+	compressor_message = compressed[wi_idx].message;
+	precompress_lat = compressed[wi_idx].lat;
+      } else {
+	r = c->compress(wi.bl, t, compressor_message);
+      }
       uint64_t want_len_raw = wi.blob_length * crr;
       uint64_t want_len = p2roundup(want_len_raw, min_alloc_size);
       bool rejected = false;
@@ -16096,7 +16801,7 @@ int BlueStore::_do_alloc_write(
       }
       log_latency("compress@_do_alloc_write",
 	l_bluestore_compress_lat,
-        mono_clock::now() - start,
+        mono_clock::now() - start + precompress_lat,
 	cct->_conf->bluestore_log_op_age );
     } else {
       need += wi.blob_length;
@@ -16107,7 +16812,7 @@ int BlueStore::_do_alloc_write(
   prealloc.reserve(2 * wctx->writes.size());
   int64_t prealloc_left = 0;
   auto start = mono_clock::now();
-  prealloc_left = alloc->allocate(
+  prealloc_left = alloc->traced_allocate(
     need, min_alloc_size, need,
     0, &prealloc);
   log_latency("allocator@_do_alloc_write",
@@ -16121,7 +16826,7 @@ int BlueStore::_do_alloc_write(
          << " available 0x " << alloc->get_free()
          << std::dec << dendl;
     if (prealloc.size()) {
-      alloc->release(prealloc);
+      alloc->traced_release(prealloc);
     }
     return -ENOSPC;
   }
@@ -17788,6 +18493,12 @@ mono_clock::duration BlueStore::BlueStoreThrottle::log_state_latency(
   mono_clock::time_point now = mono_clock::now();
   mono_clock::duration lat = now - txc.last_stamp;
   logger->tinc(state, lat);
+  if (state >= l_bluestore_state_prepare_lat &&
+      state <= l_bluestore_state_done_lat) {
+    logger->hinc(
+      l_bluestore_state_prepare_lat_hist + (state - l_bluestore_state_prepare_lat),
+      lat.count(), txc.bytes);
+  }
 #if defined(WITH_LTTNG)
   if (txc.tracing &&
       state >= l_bluestore_state_prepare_lat &&
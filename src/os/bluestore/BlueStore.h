@@ -143,6 +143,8 @@ enum {
   l_bluestore_issued_deferred_write_bytes,
   l_bluestore_submitted_deferred_writes,
   l_bluestore_submitted_deferred_write_bytes,
+  l_bluestore_deferred_merge_ios,
+  l_bluestore_deferred_merge_writes,
 
   l_bluestore_write_big_skipped_blobs,
   l_bluestore_write_big_skipped_bytes,
@@ -216,6 +218,19 @@ enum {
   l_bluestore_allocator_lat,
   //****************************************
 
+  // op processing state latency vs. size histograms, in the same order
+  // as l_bluestore_state_prepare_lat..l_bluestore_state_done_lat
+  //****************************************
+  l_bluestore_state_prepare_lat_hist,
+  l_bluestore_state_aio_wait_lat_hist,
+  l_bluestore_state_io_done_lat_hist,
+  l_bluestore_state_kv_queued_lat_hist,
+  l_bluestore_state_kv_committing_lat_hist,
+  l_bluestore_state_kv_done_lat_hist,
+  l_bluestore_state_finishing_lat_hist,
+  l_bluestore_state_done_lat_hist,
+  //****************************************
+
   // slow op counter
   //****************************************
   l_bluestore_slow_aio_wait_count,
@@ -1132,6 +1147,10 @@ public:
     void fault_range(KeyValueDB *db,
 		     uint32_t offset, uint32_t length);
 
+    /// drop clean shards outside of a range if more than max_loaded are loaded
+    void unload_clean_shards(uint32_t offset, uint32_t length,
+			     unsigned max_loaded);
+
     /// ensure a range of the map is marked dirty
     void dirty_range(uint32_t offset, uint32_t length);
 
@@ -1594,6 +1613,10 @@ private:
     friend struct Onode; // for put()
     friend struct LruOnodeCacheShard;
     void _remove(const ghobject_t& oid);
+
+    /// lookups in this collection, under cache->lock
+    uint64_t hits = 0;
+    uint64_t misses = 0;
   public:
     OnodeSpace(OnodeCacheShard *c) : cache(c) {}
     ~OnodeSpace() {
@@ -1607,6 +1630,7 @@ private:
 		const mempool::bluestore_cache_meta::string& new_okey);
     void clear();
     bool empty();
+    void add_stats(uint64_t *onodes, uint64_t *hits, uint64_t *misses);
 
     template <int LogLevelV>
     void dump(CephContext *cct);
@@ -2109,6 +2133,23 @@ private:
     }
   };
 
+  /// the deferred batches of several OpSequencers, written out together
+  /// in device offset order
+  struct DeferredMerge final : public AioContext {
+    std::vector<DeferredBatch*> batches;
+    std::map<uint64_t,DeferredBatch::deferred_io> iomap;
+    IOContext ioc;
+
+    DeferredMerge(CephContext *cct) : ioc(cct, this) {}
+
+    void aio_finish(BlueStore *store) override {
+      for (auto b : batches) {
+	store->_deferred_aio_finish(b->osr);
+      }
+      delete this;
+    }
+  };
+
   class OpSequencer : public RefCountedObject {
   public:
     ceph::mutex qlock = ceph::make_mutex("BlueStore::OpSequencer::qlock");
@@ -2143,10 +2184,33 @@ private:
 
     const uint32_t sequencer_id;
 
+    /// memory of finished TransContexts, reused by _txc_create()
+    ceph::mutex txc_cache_lock =
+      ceph::make_mutex("BlueStore::OpSequencer::txc_cache_lock");
+    std::vector<void*> txc_cache;
+
     uint32_t get_sequencer_id() const {
       return sequencer_id;
     }
 
+    void* get_txc_storage() {
+      std::lock_guard l(txc_cache_lock);
+      if (txc_cache.empty()) {
+	return nullptr;
+      }
+      void* p = txc_cache.back();
+      txc_cache.pop_back();
+      return p;
+    }
+    bool put_txc_storage(void* p, size_t max) {
+      std::lock_guard l(txc_cache_lock);
+      if (txc_cache.size() >= max) {
+	return false;
+      }
+      txc_cache.push_back(p);
+      return true;
+    }
+
     void queue_new(TransContext *txc) {
       std::lock_guard l(qlock);
       txc->seq = ++last_seq;
@@ -2241,6 +2305,9 @@ private:
     }
     ~OpSequencer() {
       ceph_assert(q.empty());
+      for (auto p : txc_cache) {
+	TransContext::operator delete(p);
+      }
     }
   };
 
@@ -2259,6 +2326,14 @@ private:
       return NULL;
     }
   };
+  struct KVCommitThread : public Thread {
+    BlueStore *store;
+    explicit KVCommitThread(BlueStore *s) : store(s) {}
+    void *entry() override {
+      store->_kv_commit_thread();
+      return NULL;
+    }
+  };
   struct KVFinalizeThread : public Thread {
     BlueStore *store;
     explicit KVFinalizeThread(BlueStore *s) : store(s) {}
@@ -2268,6 +2343,16 @@ private:
     }
   };
 
+  /// one kv_sync_thread cycle, ready for the final (synchronous) kv commit
+  struct KVCommitBatch {
+    KeyValueDB::Transaction synct;
+    std::deque<TransContext*> kv_committing;
+    std::deque<DeferredBatch*> deferred_stable;
+    size_t deferred_done_size = 0;
+    uint64_t new_nid_max = 0, new_blobid_max = 0;
+    mono_clock::time_point start, after_flush;
+  };
+
   struct BigDeferredWriteContext {
     uint64_t off = 0;     // original logical offset
     uint32_t b_off = 0;   // blob relative offset
@@ -2356,6 +2441,18 @@ private:
   std::deque<TransContext*> kv_committing;        ///< currently syncing
   std::deque<DeferredBatch*> deferred_done_queue;   ///< deferred ios done
   bool kv_sync_in_progress = false;
+  bool kv_sync_batching = false;  ///< kv_sync_thread waits for a bigger batch
+
+  // with bluestore_kv_sync_pipeline, the synchronous kv commit of a batch
+  // is done by kv_commit_thread so that kv_sync_thread can go on flushing
+  // the device for the next batch in the meantime.
+  bool kv_sync_pipeline = false;
+  KVCommitThread kv_commit_thread;
+  ceph::mutex kv_commit_lock = ceph::make_mutex("BlueStore::kv_commit_lock");
+  ceph::condition_variable kv_commit_cond;
+  std::unique_ptr<KVCommitBatch> kv_commit_pending; ///< next batch to commit
+  bool kv_commit_started = false;
+  bool kv_commit_stop = false;
 
   KVFinalizeThread kv_finalize_thread;
   ceph::mutex kv_finalize_lock = ceph::make_mutex("BlueStore::kv_finalize_lock");
@@ -2364,6 +2461,14 @@ private:
   std::deque<DeferredBatch*> deferred_stable_to_finalize; ///< pending finalization
   bool kv_finalize_in_progress = false;
 
+  // with bluestore_compression_threads, helpers that compress the blobs
+  // of a single large write side by side with the writing thread
+  std::vector<std::thread> compress_threads;
+  ceph::mutex compress_lock = ceph::make_mutex("BlueStore::compress_lock");
+  ceph::condition_variable compress_cond;
+  std::deque<std::function<void()>> compress_queue;
+  bool compress_stop = false;
+
   PerfCounters *logger = nullptr;
 
   std::list<CollectionRef> removed_collections;
@@ -2458,6 +2563,12 @@ private:
     std::shared_ptr<PriorityCache::PriCache> binned_kv_onode_cache = nullptr;
     std::shared_ptr<PriorityCache::Manager> pcm = nullptr;
 
+    // share of the kv_onode cache in the combined kv + kv_onode ratio, and
+    // the lookup counters seen at the last balance
+    double kv_onode_share = -1;
+    uint64_t kv_hits = 0, kv_misses = 0;
+    uint64_t kv_onode_hits = 0, kv_onode_misses = 0;
+
     struct MempoolCache : public PriorityCache::PriCache {
       BlueStore *store;
       uint64_t bins[PriorityCache::Priority::LAST+1] = {0};
@@ -2677,6 +2788,7 @@ private:
   private:
     void _update_cache_settings();
     void _resize_shards(bool interval_stats);
+    void _balance_kv_cf_ratios(double* kv_ratio, double* kv_onode_ratio);
   } mempool_thread;
 
 #ifdef WITH_BLKIN
@@ -2810,6 +2922,7 @@ private:
   void _txc_committed_kv(TransContext *txc);
   void _txc_finish(TransContext *txc);
   void _txc_release_alloc(TransContext *txc);
+  void _txc_destroy(TransContext *txc);
 
   void _osr_attach(Collection *c);
   void _osr_register_zombie(OpSequencer *osr);
@@ -2819,7 +2932,13 @@ private:
 
   void _kv_start();
   void _kv_stop();
+  void _compress_threads_start();
+  void _compress_threads_stop();
+  /// call f(0) .. f(n - 1), spread over the compress threads and this one
+  void _compress_parallel(size_t n, const std::function<void(size_t)>& f);
   void _kv_sync_thread();
+  void _kv_commit_batch(KVCommitBatch& b);
+  void _kv_commit_thread();
   void _kv_finalize_thread();
 
   bluestore_deferred_op_t *_get_deferred_op(TransContext *txc, uint64_t len);
@@ -2828,6 +2947,10 @@ public:
   void deferred_try_submit();
 private:
   void _deferred_submit_unlock(OpSequencer *osr);
+  DeferredBatch *_deferred_start_unlock(OpSequencer *osr);
+  unsigned _deferred_write(
+    std::map<uint64_t,DeferredBatch::deferred_io>& iomap, IOContext *ioc);
+  void _deferred_submit_merged(const std::vector<DeferredBatch*>& batches);
   void _deferred_aio_finish(OpSequencer *osr);
   int _deferred_replay();
   bool _eliminate_outdated_deferred(bluestore_deferred_transaction_t* deferred_txn,
@@ -2891,6 +3014,8 @@ private:
   int _collection_list(
     Collection *c, const ghobject_t& start, const ghobject_t& end,
     int max, bool legacy, std::vector<ghobject_t> *ls, ghobject_t *next);
+  /// load the onodes of listed objects into the cache with one iterator
+  void _prefetch_onodes(Collection *c, const std::vector<ghobject_t>& ls);
 
   template <typename T, typename F>
   T select_option(const std::string& opt_name, T val1, F f) {
@@ -3003,17 +3128,7 @@ public:
   }
 
   void set_cache_shards(unsigned num) override;
-  void dump_cache_stats(ceph::Formatter *f) override {
-    int onode_count = 0, buffers_bytes = 0;
-    for (auto i: onode_cache_shards) {
-      onode_count += i->_get_num();
-    }
-    for (auto i: buffer_cache_shards) {
-      buffers_bytes += i->_get_bytes();
-    }
-    f->dump_int("bluestore_onode", onode_count);
-    f->dump_int("bluestore_buffers", buffers_bytes);
-  }
+  void dump_cache_stats(ceph::Formatter *f) override;
   void dump_cache_stats(std::ostream& ss) override {
     int onode_count = 0, buffers_bytes = 0;
     for (auto i: onode_cache_shards) {
@@ -3147,6 +3262,21 @@ private:
     std::vector<ceph::buffer::list>* compressed_blob_bls,
     IOContext* ioc);
 
+  int _decode_read_result(
+    OnodeRef& o,
+    ready_regions_t& ready_regions,
+    std::vector<ceph::buffer::list>& compressed_blob_bls,
+    blobs2read_t& blobs2read,
+    bool buffered,
+    bool* csum_error);
+
+  void _assemble_read_result(
+    uint64_t offset,
+    size_t length,
+    ready_regions_t::iterator& pr,
+    const ready_regions_t::iterator& pr_end,
+    ceph::buffer::list& bl);
+
   int _generate_read_result_bl(
     OnodeRef& o,
     uint64_t offset,
@@ -3167,6 +3297,13 @@ private:
     uint32_t op_flags = 0,
     uint64_t retry_count = 0);
 
+  /// enforce bluestore_extent_map_max_loaded_shards after a read
+  void _unload_clean_shards(
+    Collection *c,
+    OnodeRef& o,
+    uint64_t offset,
+    uint64_t length);
+
   int _do_readv(
     Collection *c,
     OnodeRef& o,
@@ -3930,6 +4067,9 @@ private:
     OnodeRef& o,
     const BlueStore::FSCK_ObjectCtx& ctx);
 
+  /// read all of o's data, verifying checksums; returns the errors found
+  int _fsck_deep_read_object(Collection* c, OnodeRef& o);
+
   void _fsck_check_objects(FSCKDepth depth,
     FSCK_ObjectCtx& ctx);
 };
@@ -0,0 +1,197 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "ShardedAllocator.h"
+
+#include <atomic>
+
+#include "common/debug.h"
+
+#define dout_context cct
+#define dout_subsys ceph_subsys_bluestore
+#undef  dout_prefix
+#define dout_prefix *_dout << "ShardedAllocator "
+
+ShardedAllocator::ShardedAllocator(CephContext* cct,
+				   int64_t device_size,
+				   int64_t block_size,
+				   unsigned num_shards,
+				   std::string_view name) :
+  Allocator(name, device_size, block_size),
+  cct(cct)
+{
+  // keep region boundaries aligned for any reasonable allocation unit
+  uint64_t align = std::max<uint64_t>(block_size, 1ull << 20);
+  num_shards = std::max(num_shards, 1u);
+  region_size = round_up_to(
+    std::max<uint64_t>(div_round_up(device_size, num_shards), 1), align);
+  num_shards = std::max<uint64_t>(div_round_up(device_size, region_size), 1);
+  shards.reserve(num_shards);
+  for (unsigned i = 0; i < num_shards; ++i) {
+    uint64_t base = _base(i);
+    uint64_t size = base < uint64_t(device_size) ?
+      std::min(region_size, device_size - base) : 0;
+    std::string shard_name =
+      name.empty() ? std::string() : std::string(name) + ".shard" + std::to_string(i);
+    shards.emplace_back(
+      std::make_unique<AvlAllocator>(cct, size, block_size, shard_name));
+  }
+  ldout(cct, 10) << __func__ << " 0x" << std::hex << get_capacity() << "/"
+		 << get_block_size() << " region 0x" << region_size << std::dec
+		 << " shards " << shards.size() << dendl;
+}
+
+ShardedAllocator::~ShardedAllocator()
+{
+  shutdown();
+}
+
+size_t ShardedAllocator::_my_shard() const
+{
+  static std::atomic<unsigned> next_shard = 0;
+  thread_local const unsigned shard = next_shard++;
+  return shard % shards.size();
+}
+
+int64_t ShardedAllocator::allocate(
+  uint64_t want,
+  uint64_t unit,
+  uint64_t max_alloc_size,
+  int64_t  hint,
+  PExtentVector* extents)
+{
+  ldout(cct, 10) << __func__ << std::hex
+		 << " 0x" << want
+		 << "/" << unit
+		 << "," << max_alloc_size
+		 << "," << hint
+		 << std::dec << dendl;
+  const size_t n = shards.size();
+  const size_t first = hint > 0 ? _shard_of(hint) : _my_shard();
+  uint64_t allocated = 0;
+  PExtentVector shard_extents;
+  for (size_t i = 0; i < n && allocated < want; ++i) {
+    size_t s = (first + i) % n;
+    uint64_t base = _base(s);
+    int64_t shard_hint = (i == 0 && hint > 0) ? hint - base : 0;
+    shard_extents.clear();
+    int64_t r = shards[s]->allocate(want - allocated, unit, max_alloc_size,
+				    shard_hint, &shard_extents);
+    if (r <= 0) {
+      continue;
+    }
+    for (auto& e : shard_extents) {
+      extents->emplace_back(base + e.offset, e.length);
+    }
+    allocated += r;
+  }
+  if (allocated == 0) {
+    return -ENOSPC;
+  }
+  return allocated;
+}
+
+void ShardedAllocator::release(const interval_set<uint64_t>& release_set)
+{
+  // adjacent extents from different regions may have been merged by the
+  // caller
+  std::vector<interval_set<uint64_t>> by_shard(shards.size());
+  for (auto p = release_set.begin(); p != release_set.end(); ++p) {
+    _for_each_region(p.get_start(), p.get_len(),
+      [&](size_t s, uint64_t offset, uint64_t length) {
+	by_shard[s].insert(offset, length);
+      });
+  }
+  for (size_t s = 0; s < shards.size(); ++s) {
+    if (!by_shard[s].empty()) {
+      shards[s]->release(by_shard[s]);
+    }
+  }
+}
+
+uint64_t ShardedAllocator::get_free()
+{
+  uint64_t free = 0;
+  for (auto& s : shards) {
+    free += s->get_free();
+  }
+  return free;
+}
+
+double ShardedAllocator::get_fragmentation()
+{
+  // weighted by the free space of each region
+  uint64_t total = 0;
+  double frag = 0;
+  for (auto& s : shards) {
+    uint64_t free = s->get_free();
+    total += free;
+    frag += s->get_fragmentation() * free;
+  }
+  return total ? frag / total : 0.0;
+}
+
+void ShardedAllocator::dump()
+{
+  for (size_t s = 0; s < shards.size(); ++s) {
+    ldout(cct, 0) << __func__ << " shard " << s << " base 0x" << std::hex
+		  << _base(s) << std::dec << dendl;
+    shards[s]->dump();
+  }
+}
+
+void ShardedAllocator::foreach(
+  std::function<void(uint64_t offset, uint64_t length)> notify)
+{
+  // report free extents meeting at a region boundary as one
+  uint64_t start = 0, len = 0;
+  for (size_t s = 0; s < shards.size(); ++s) {
+    uint64_t base = _base(s);
+    shards[s]->foreach([&](uint64_t offset, uint64_t length) {
+      offset += base;
+      if (len && start + len == offset) {
+	len += length;
+	return;
+      }
+      if (len) {
+	notify(start, len);
+      }
+      start = offset;
+      len = length;
+    });
+  }
+  if (len) {
+    notify(start, len);
+  }
+}
+
+void ShardedAllocator::init_add_free(uint64_t offset, uint64_t length)
+{
+  ldout(cct, 10) << __func__ << std::hex
+		 << " offset 0x" << offset
+		 << " length 0x" << length
+		 << std::dec << dendl;
+  _for_each_region(offset, length,
+    [&](size_t s, uint64_t offset, uint64_t length) {
+      shards[s]->init_add_free(offset, length);
+    });
+}
+
+void ShardedAllocator::init_rm_free(uint64_t offset, uint64_t length)
+{
+  ldout(cct, 10) << __func__ << std::hex
+		 << " offset 0x" << offset
+		 << " length 0x" << length
+		 << std::dec << dendl;
+  _for_each_region(offset, length,
+    [&](size_t s, uint64_t offset, uint64_t length) {
+      shards[s]->init_rm_free(offset, length);
+    });
+}
+
+void ShardedAllocator::shutdown()
+{
+  for (auto& s : shards) {
+    s->shutdown();
+  }
+}
@@ -0,0 +1,73 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "AvlAllocator.h"
+
+/*
+ * Splits the device into a few equally sized regions, each managed by its
+ * own AvlAllocator (and thus its own lock and per size class cursors).
+ * Every thread allocates from a region of its own first, and only moves
+ * on to the others once that one cannot satisfy the request, so
+ * concurrent allocations do not serialize on a single mutex.
+ *
+ * Free extents never cross region boundaries.
+ */
+class ShardedAllocator : public Allocator {
+  CephContext* cct;
+  uint64_t region_size = 0;
+  std::vector<std::unique_ptr<AvlAllocator>> shards;
+
+  size_t _shard_of(uint64_t offset) const {
+    return std::min<size_t>(offset / region_size, shards.size() - 1);
+  }
+  uint64_t _base(size_t shard) const {
+    return shard * region_size;
+  }
+  /// the shard the calling thread allocates from first
+  size_t _my_shard() const;
+
+  /// call f(shard, offset in shard, length) for each region of a range
+  template <typename F>
+  void _for_each_region(uint64_t offset, uint64_t length, F&& f) const {
+    while (length > 0) {
+      size_t s = _shard_of(offset);
+      uint64_t base = _base(s);
+      uint64_t len = s + 1 < shards.size() ?
+	std::min(length, base + region_size - offset) : length;
+      f(s, offset - base, len);
+      offset += len;
+      length -= len;
+    }
+  }
+
+public:
+  ShardedAllocator(CephContext* cct, int64_t device_size, int64_t block_size,
+		   unsigned num_shards, std::string_view name);
+  ~ShardedAllocator() override;
+  const char* get_type() const override
+  {
+    return "sharded";
+  }
+
+  int64_t allocate(
+    uint64_t want,
+    uint64_t unit,
+    uint64_t max_alloc_size,
+    int64_t  hint,
+    PExtentVector *extents) override;
+  void release(const interval_set<uint64_t>& release_set) override;
+  uint64_t get_free() override;
+  double get_fragmentation() override;
+
+  void dump() override;
+  void foreach(
+    std::function<void(uint64_t offset, uint64_t length)> notify) override;
+  void init_add_free(uint64_t offset, uint64_t length) override;
+  void init_rm_free(uint64_t offset, uint64_t length) override;
+  void shutdown() override;
+};
@@ -827,6 +827,10 @@ bool ECBackend::_handle_message(
       _op->get_nonconst_req());
     parent->maybe_preempt_replica_scrub(op->op.soid);
     handle_sub_write(op->op.from, _op, op->op, _op->pg_trace, *get_parent()->get_eclistener());
+    for (auto& sop : op->batched_ops) {
+      parent->maybe_preempt_replica_scrub(sop.soid);
+      handle_sub_write(sop.from, _op, sop, _op->pg_trace, *get_parent()->get_eclistener());
+    }
     return true;
   }
   case MSG_OSD_EC_WRITE_REPLY: {
@@ -1047,22 +1051,65 @@ void ECBackend::handle_sub_read(
         dout(25) << __func__ << " case2: going to do fragmented read." << dendl;
         int subchunk_size =
           sinfo.get_chunk_size() / ec_impl->get_sub_chunk_count();
-        bool error = false;
-        for (int m = 0; m < (int)j->get<1>() && !error;
+        // submit all the sub-chunk ranges as one vectored read, so that
+        // the store can issue them together rather than one at a time.
+        // that only returns them in order if they come in ascending order,
+        // which is what the plugins' minimum_to_decode produces.
+        interval_set<uint64_t> ranges;
+        bool ascending = true;
+        uint64_t next_off = 0;
+        for (int m = 0; m < (int)j->get<1>() && ascending;
              m += sinfo.get_chunk_size()) {
           for (auto &&k:op.subchunks.find(i->first)->second) {
-            bufferlist bl0;
-            r = store->read(
-                ch,
-                ghobject_t(i->first, ghobject_t::NO_GEN, shard),
-                j->get<0>() + m + (k.first)*subchunk_size,
-                (k.second)*subchunk_size,
-                bl0, j->get<2>());
-            if (r < 0) {
-              error = true;
+            uint64_t off = j->get<0>() + m + (k.first)*subchunk_size;
+            uint64_t len = (k.second)*subchunk_size;
+            if (len == 0) {
+              continue;
+            }
+            if (off < next_off) {
+              ascending = false;
               break;
             }
-            bl.claim_append(bl0);
+            ranges.insert(off, len);
+            next_off = off + len;
+          }
+        }
+        if (ascending && !ranges.empty()) {
+          // unlike read(), readv() does not stop at the end of the object,
+          // so ranges running past the end of a short shard go through
+          // the per-range reads below
+          struct stat st;
+          r = store->stat(
+              ch,
+              ghobject_t(i->first, ghobject_t::NO_GEN, shard),
+              &st);
+          if (r < 0 || ranges.range_end() > (uint64_t)st.st_size) {
+            ascending = false;
+          }
+        }
+        if (ascending) {
+          r = store->readv(
+              ch,
+              ghobject_t(i->first, ghobject_t::NO_GEN, shard),
+              ranges, bl, j->get<2>());
+        } else {
+          bool error = false;
+          for (int m = 0; m < (int)j->get<1>() && !error;
+               m += sinfo.get_chunk_size()) {
+            for (auto &&k:op.subchunks.find(i->first)->second) {
+              bufferlist bl0;
+              r = store->read(
+                  ch,
+                  ghobject_t(i->first, ghobject_t::NO_GEN, shard),
+                  j->get<0>() + m + (k.first)*subchunk_size,
+                  (k.second)*subchunk_size,
+                  bl0, j->get<2>());
+              if (r < 0) {
+                error = true;
+                break;
+              }
+              bl.claim_append(bl0);
+            }
           }
         }
       }
@@ -1554,11 +1601,9 @@ void ECBackend::objects_read_async(
 	 to_read.begin();
        i != to_read.end();
        ++i) {
-    pair<uint64_t, uint64_t> tmp =
-      sinfo.offset_len_to_stripe_bounds(
-	make_pair(i->first.get<0>(), i->first.get<1>()));
-
-    es.union_insert(tmp.first, tmp.second);
+    // the read pipeline aligns to stripes itself; it needs the exact
+    // extents to tell which data shards to read from
+    es.union_insert(i->first.get<0>(), i->first.get<1>());
     flags |= i->first.get<2>();
   }
 
@@ -259,6 +259,43 @@ void ECCommon::ReadPipeline::get_all_avail_shards(
   }
 }
 
+set<int> ECCommon::ReadPipeline::get_local_shards(
+  const set<int> &have,
+  const map<shard_id_t, pg_shard_t> &shards)
+{
+  set<int> local;
+  const auto& type_name = cct->_conf->osd_ec_read_prefer_local_crush_type;
+  if (type_name.empty()) {
+    return local;
+  }
+  const auto& crush = get_osdmap()->crush;
+  int type = crush->get_type_id(type_name);
+  if (type <= 0) {
+    return local;
+  }
+  if (local_ancestors_epoch != get_osdmap_epoch()) {
+    local_ancestors.clear();
+    local_ancestors_epoch = get_osdmap_epoch();
+  }
+  auto ancestor = [&](int osd) {
+    auto [p, inserted] = local_ancestors.try_emplace(osd, 0);
+    if (inserted) {
+      p->second = crush->get_parent_of_type(osd, type);
+    }
+    return p->second;
+  };
+  int mine = ancestor(get_parent()->whoami_shard().osd);
+  if (mine == 0) {
+    return local;
+  }
+  for (auto i : have) {
+    if (ancestor(shards.at(shard_id_t(i)).osd) == mine) {
+      local.insert(i);
+    }
+  }
+  return local;
+}
+
 int ECCommon::ReadPipeline::get_min_avail_to_read_shards(
   const hobject_t &hoid,
   const set<int> &want,
@@ -276,9 +313,25 @@ int ECCommon::ReadPipeline::get_min_avail_to_read_shards(
   get_all_avail_shards(hoid, error_shards, have, shards, for_recovery);
 
   map<int, vector<pair<int, int>>> need;
-  int r = ec_impl->minimum_to_decode(want, have, &need);
-  if (r < 0)
-    return r;
+  int r = -EIO;
+  if (!do_redundant_reads) {
+    // stay within our own failure domain if that is enough
+    set<int> local = get_local_shards(have, shards);
+    if (!local.empty() && local.size() < have.size()) {
+      r = ec_impl->minimum_to_decode(want, local, &need);
+      if (r < 0) {
+	need.clear();
+      } else {
+	dout(20) << __func__ << ": reading from local shards " << local
+		 << " of " << have << dendl;
+      }
+    }
+  }
+  if (r < 0) {
+    r = ec_impl->minimum_to_decode(want, have, &need);
+    if (r < 0)
+      return r;
+  }
 
   if (do_redundant_reads) {
       vector<pair<int, int>> subchunks_list;
@@ -461,11 +514,34 @@ void ECCommon::ReadPipeline::get_want_to_read_shards(
   }
 }
 
+void ECCommon::ReadPipeline::get_min_want_to_read_shards(
+  const list<boost::tuple<uint64_t, uint64_t, uint32_t> > &to_read,
+  std::set<int> *want_to_read) const
+{
+  const std::vector<int> &chunk_mapping = ec_impl->get_chunk_mapping();
+  const uint64_t k = ec_impl->get_data_chunk_count();
+  for (auto &&read : to_read) {
+    auto [first, last] = sinfo.offset_len_to_data_chunk_indices(
+      read.get<0>(), read.get<1>());
+    for (uint64_t i = first; i < last && want_to_read->size() < k; ++i) {
+      uint64_t raw_chunk = i % k;
+      int chunk = chunk_mapping.size() > raw_chunk ?
+	chunk_mapping[raw_chunk] : (int)raw_chunk;
+      want_to_read->insert(chunk);
+    }
+  }
+  if (want_to_read->empty()) {
+    get_want_to_read_shards(want_to_read);
+  }
+}
+
 struct ClientReadCompleter : ECCommon::ReadCompleter {
   ClientReadCompleter(ECCommon::ReadPipeline &read_pipeline,
-                      ECCommon::ClientAsyncReadStatus *status)
+                      ECCommon::ClientAsyncReadStatus *status,
+                      map<hobject_t, set<int>> want_to_read)
     : read_pipeline(read_pipeline),
-      status(status) {}
+      status(status),
+      want_to_read(std::move(want_to_read)) {}
 
   void finish_single_request(
     const hobject_t &hoid,
@@ -494,6 +570,7 @@ struct ClientReadCompleter : ECCommon::ReadCompleter {
       int r = ECUtil::decode(
 	read_pipeline.sinfo,
 	read_pipeline.ec_impl,
+	want_to_read[hoid],
 	to_decode,
 	&bl);
       if (r < 0) {
@@ -522,6 +599,8 @@ out:
 
   ECCommon::ReadPipeline &read_pipeline;
   ECCommon::ClientAsyncReadStatus *status;
+  /// data shards read for each object, the others come back zero filled
+  map<hobject_t, set<int>> want_to_read;
 };
 
 void ECCommon::ReadPipeline::objects_read_and_reconstruct(
@@ -539,11 +618,13 @@ void ECCommon::ReadPipeline::objects_read_and_reconstruct(
   }
 
   map<hobject_t, set<int>> obj_want_to_read;
-  set<int> want_to_read;
-  get_want_to_read_shards(&want_to_read);
-    
+
   map<hobject_t, read_request_t> for_read_op;
   for (auto &&to_read: reads) {
+    // only ask for the data shards the extents live on, parity is
+    // pulled in by minimum_to_decode if one of them is unavailable
+    set<int> want_to_read;
+    get_min_want_to_read_shards(to_read.second, &want_to_read);
     map<pg_shard_t, vector<pair<int, int>>> shards;
     int r = get_min_avail_to_read_shards(
       to_read.first,
@@ -553,16 +634,32 @@ void ECCommon::ReadPipeline::objects_read_and_reconstruct(
       &shards);
     ceph_assert(r == 0);
 
+    // the shards are still read a whole stripe at a time
+    uint32_t flags = 0;
+    extent_set es;
+    for (auto &&read : to_read.second) {
+      pair<uint64_t, uint64_t> bounds = sinfo.offset_len_to_stripe_bounds(
+	make_pair(read.get<0>(), read.get<1>()));
+      es.union_insert(bounds.first, bounds.second);
+      flags |= read.get<2>();
+    }
+    list<boost::tuple<uint64_t, uint64_t, uint32_t> > aligned;
+    for (auto j = es.begin(); j != es.end(); ++j) {
+      aligned.push_back(boost::make_tuple(j.get_start(), j.get_len(), flags));
+    }
+
     for_read_op.insert(
       make_pair(
 	to_read.first,
 	read_request_t(
-	  to_read.second,
+	  aligned,
 	  shards,
 	  false)));
     obj_want_to_read.insert(make_pair(to_read.first, want_to_read));
   }
 
+  auto on_complete = std::make_unique<ClientReadCompleter>(
+    *this, &(in_progress_client_reads.back()), obj_want_to_read);
   start_read_op(
     CEPH_MSG_PRIO_DEFAULT,
     obj_want_to_read,
@@ -570,7 +667,7 @@ void ECCommon::ReadPipeline::objects_read_and_reconstruct(
     OpRequestRef(),
     fast_read,
     false,
-    std::make_unique<ClientReadCompleter>(*this, &(in_progress_client_reads.back())));
+    std::move(on_complete));
 }
 
 
@@ -788,8 +885,6 @@ bool ECCommon::RMWPipeline::try_reads_to_commit()
   ObjectStore::Transaction empty;
   bool should_write_local = false;
   ECSubWrite local_write_op;
-  std::vector<std::pair<int, Message*>> messages;
-  messages.reserve(get_parent()->get_acting_recovery_backfill_shards().size());
   set<pg_shard_t> backfill_shards = get_parent()->get_backfill_shards();
   for (set<pg_shard_t>::const_iterator i =
 	 get_parent()->get_acting_recovery_backfill_shards().begin();
@@ -838,12 +933,14 @@ bool ECCommon::RMWPipeline::try_reads_to_commit()
       r->map_epoch = get_osdmap_epoch();
       r->min_epoch = get_parent()->get_interval_start_epoch();
       r->trace = trace;
-      messages.push_back(std::make_pair(i->osd, r));
+      pending_sub_writes.push_back(std::make_pair(i->osd, r));
     }
   }
 
-  if (!messages.empty()) {
-    get_parent()->send_message_osd_cluster(messages, get_osdmap_epoch());
+  if (!op->on_write.empty()) {
+    // the callbacks are ordered after this write, including anything
+    // they send to the shards
+    flush_sub_writes();
   }
 
   if (should_write_local) {
@@ -932,6 +1029,44 @@ void ECCommon::RMWPipeline::check_ops()
   while (try_state_to_reads() ||
 	 try_reads_to_commit() ||
 	 try_finish_rmw());
+  flush_sub_writes();
+}
+
+void ECCommon::RMWPipeline::flush_sub_writes()
+{
+  if (pending_sub_writes.empty()) {
+    return;
+  }
+  std::vector<std::pair<int, Message*>> messages;
+  messages.reserve(pending_sub_writes.size());
+  // peers without the feature cannot decode batched_ops
+  if (cct->_conf->osd_ec_batch_sub_writes &&
+      HAVE_FEATURE(get_parent()->min_peer_features(), OSD_EC_BATCHED_SUB_WRITE) &&
+      pending_sub_writes.size() > 1) {
+    // fold every later write for a shard into the first message going
+    // there; the replica applies them in the order they were queued
+    std::map<std::pair<int, spg_t>, MOSDECSubOpWrite*> by_shard;
+    for (auto& [osd, m] : pending_sub_writes) {
+      auto [it, inserted] = by_shard.try_emplace({osd, m->pgid}, m);
+      if (inserted) {
+	messages.emplace_back(osd, m);
+      } else {
+	auto& batched = it->second->batched_ops;
+	batched.emplace_back();
+	batched.back().claim(m->op);
+	batched.splice(batched.end(), m->batched_ops);
+	m->put();
+      }
+    }
+    dout(20) << __func__ << ": " << pending_sub_writes.size()
+	     << " sub writes in " << messages.size() << " messages" << dendl;
+  } else {
+    for (auto& [osd, m] : pending_sub_writes) {
+      messages.emplace_back(osd, m);
+    }
+  }
+  pending_sub_writes.clear();
+  get_parent()->send_message_osd_cluster(messages, get_osdmap_epoch());
 }
 
 void ECCommon::RMWPipeline::on_change()
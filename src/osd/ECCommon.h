@@ -50,6 +50,7 @@ typedef crimson::osd::ObjectContextRef ObjectContextRef;
 //forward declaration
 struct ECSubWrite;
 struct PGLog;
+class MOSDECSubOpWrite;
 
 // ECListener -- an interface decoupling the pipelines from
 // particular implementation of ECBackend (crimson vs cassical).
@@ -173,6 +174,7 @@ struct ECListener {
   // XXX
   virtual void send_message_osd_cluster(
     std::vector<std::pair<int, Message*>>& messages, epoch_t from_epoch) = 0;
+  virtual uint64_t min_peer_features() const = 0;
 
   virtual std::ostream& gen_dbg_prefix(std::ostream& out) const = 0;
 
@@ -448,6 +450,19 @@ struct ECCommon {
     friend struct FinishReadOp;
 
     void get_want_to_read_shards(std::set<int> *want_to_read) const;
+    /// the data shards holding the given extents of an object
+    void get_min_want_to_read_shards(
+      const std::list<boost::tuple<uint64_t, uint64_t, uint32_t>> &to_read,
+      std::set<int> *want_to_read) const;
+
+    /// shards in have sharing an osd_ec_read_prefer_local_crush_type
+    /// bucket with us, when that option is set
+    std::set<int> get_local_shards(
+      const std::set<int> &have,
+      const std::map<shard_id_t, pg_shard_t> &shards);
+    /// CRUSH ancestor of each osd for get_local_shards(), per osdmap epoch
+    std::map<int, int> local_ancestors;
+    epoch_t local_ancestors_epoch = 0;
 
     /// Returns to_read replicas sufficient to reconstruct want
     int get_min_avail_to_read_shards(
@@ -604,6 +619,10 @@ struct ECCommon {
     bool try_finish_rmw();
     void check_ops();
 
+    /// sub writes built by try_reads_to_commit, sent by flush_sub_writes()
+    std::vector<std::pair<int, MOSDECSubOpWrite*>> pending_sub_writes;
+    void flush_sub_writes();
+
     void on_change();
     void call_write_ordered(std::function<void(void)> &&cb);
 
@@ -6,6 +6,7 @@
 
 using namespace std;
 using ceph::bufferlist;
+using ceph::bufferptr;
 using ceph::ErasureCodeInterfaceRef;
 using ceph::Formatter;
 
@@ -96,6 +97,20 @@ int ECUtil::decode(
     }
   }
 
+  if (ec_impl->get_sub_chunk_count() == 1) {
+    // the whole object in one batch, rather than one decode per stripe
+    map<int, bufferlist> out_bls;
+    r = ec_impl->decode_stripes(need, to_decode, &out_bls, chunks_count);
+    ceph_assert(r == 0);
+    for (auto j = out.begin(); j != out.end(); ++j) {
+      ceph_assert(out_bls.count(j->first));
+      ceph_assert(out_bls[j->first].length() ==
+		  chunks_count * sinfo.get_chunk_size());
+      j->second->claim_append(out_bls[j->first]);
+    }
+    return 0;
+  }
+
   for (int i = 0; i < chunks_count; i++) {
     map<int, bufferlist> chunks;
     for (auto j = to_decode.begin();
@@ -120,6 +135,51 @@ int ECUtil::decode(
   return 0;
 }
 
+int ECUtil::decode(
+  const stripe_info_t &sinfo,
+  ErasureCodeInterfaceRef &ec_impl,
+  const set<int> &want_to_read,
+  map<int, bufferlist> &to_decode,
+  bufferlist *out) {
+  ceph_assert(to_decode.size());
+
+  uint64_t total_data_size = to_decode.begin()->second.length();
+  ceph_assert(total_data_size % sinfo.get_chunk_size() == 0);
+
+  ceph_assert(out);
+  ceph_assert(out->length() == 0);
+
+  for (auto &&i : to_decode) {
+    ceph_assert(i.second.length() == total_data_size);
+  }
+
+  if (total_data_size == 0)
+    return 0;
+
+  const vector<int> &chunk_mapping = ec_impl->get_chunk_mapping();
+  const unsigned k = ec_impl->get_data_chunk_count();
+  for (uint64_t i = 0; i < total_data_size; i += sinfo.get_chunk_size()) {
+    map<int, bufferlist> chunks;
+    for (auto &&j : to_decode) {
+      chunks[j.first].substr_of(j.second, i, sinfo.get_chunk_size());
+    }
+    map<int, bufferlist> decoded;
+    int r = ec_impl->decode(want_to_read, chunks, &decoded,
+			    sinfo.get_chunk_size());
+    ceph_assert(r == 0);
+    for (unsigned j = 0; j < k; ++j) {
+      int chunk = chunk_mapping.size() > j ? chunk_mapping[j] : (int)j;
+      if (want_to_read.count(chunk)) {
+	ceph_assert(decoded[chunk].length() == sinfo.get_chunk_size());
+	out->claim_append(decoded[chunk]);
+      } else {
+	out->append_zero(sinfo.get_chunk_size());
+      }
+    }
+  }
+  return 0;
+}
+
 int ECUtil::encode(
   const stripe_info_t &sinfo,
   ErasureCodeInterfaceRef &ec_impl,
@@ -136,11 +196,42 @@ int ECUtil::encode(
   if (logical_size == 0)
     return 0;
 
-  for (uint64_t i = 0; i < logical_size; i += sinfo.get_stripe_width()) {
+  uint64_t stripe_count = logical_size / sinfo.get_stripe_width();
+  if (stripe_count > 1) {
+    // lay the chunks of all the stripes out back to back and encode
+    // them in one batch
+    const unsigned k = ec_impl->get_data_chunk_count();
+    const unsigned km = ec_impl->get_chunk_count();
+    const uint64_t chunk_size = sinfo.get_chunk_size();
+    ceph_assert(ec_impl->get_chunk_size(sinfo.get_stripe_width()) == chunk_size);
+    const vector<int> &chunk_mapping = ec_impl->get_chunk_mapping();
+    vector<char*> data(k);
+    map<int, bufferlist> encoded;
+    for (unsigned i = 0; i < km; i++) {
+      int chunk = chunk_mapping.size() > i ? chunk_mapping[i] : (int)i;
+      // the plugins want their buffers SIMD aligned, see
+      // ErasureCode::SIMD_ALIGN
+      bufferptr p = ceph::buffer::create_aligned(
+	stripe_count * chunk_size, 32);
+      if (i < k)
+	data[i] = p.c_str();
+      encoded[chunk].push_back(std::move(p));
+    }
+    auto p = in.cbegin();
+    for (uint64_t s = 0; s < stripe_count; s++) {
+      for (unsigned i = 0; i < k; i++) {
+	p.copy(chunk_size, data[i] + s * chunk_size);
+      }
+    }
+    int r = ec_impl->encode_stripes(want, stripe_count, &encoded);
+    ceph_assert(r == 0);
+    for (auto i : want) {
+      ceph_assert(encoded.count(i));
+      (*out)[i].claim_append(encoded[i]);
+    }
+  } else {
     map<int, bufferlist> encoded;
-    bufferlist buf;
-    buf.substr_of(in, i, sinfo.get_stripe_width());
-    int r = ec_impl->encode(want, buf, &encoded);
+    int r = ec_impl->encode(want, in, &encoded);
     ceph_assert(r == 0);
     for (map<int, bufferlist>::iterator i = encoded.begin();
 	 i != encoded.end();
@@ -77,6 +77,13 @@ public:
       (in.first - off) + in.second);
     return std::make_pair(off, len);
   }
+  /// [first, last) indexes, counted from the start of the object, of
+  /// the data chunks the logical extent touches
+  std::pair<uint64_t, uint64_t> offset_len_to_data_chunk_indices(
+    uint64_t off, uint64_t len) const {
+    return std::make_pair(off / chunk_size,
+                          (off + len + chunk_size - 1) / chunk_size);
+  }
 };
 
 int decode(
@@ -91,6 +98,15 @@ int decode(
   std::map<int, ceph::buffer::list> &to_decode,
   std::map<int, ceph::buffer::list*> &out);
 
+/// decode only the data chunks in want_to_read; the others are zero
+/// filled so that offsets into out are still those of whole stripes
+int decode(
+  const stripe_info_t &sinfo,
+  ceph::ErasureCodeInterfaceRef &ec_impl,
+  const std::set<int> &want_to_read,
+  std::map<int, ceph::buffer::list> &to_decode,
+  ceph::buffer::list *out);
+
 int encode(
   const stripe_info_t &sinfo,
   ceph::ErasureCodeInterfaceRef &ec_impl,
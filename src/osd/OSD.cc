@@ -57,6 +57,7 @@
 #include "common/pick_address.h"
 #include "common/blkdev.h"
 #include "common/numa.h"
+#include "common/Thread.h"
 
 #include "os/ObjectStore.h"
 #ifdef HAVE_LIBFUSE
@@ -244,6 +245,7 @@ OSDService::OSDService(OSD *osd, ceph::async::io_context_pool& poolctx) :
   monc(osd->monc),
   osd_max_object_size(cct->_conf, "osd_max_object_size"),
   osd_skip_data_digest(cct->_conf, "osd_skip_data_digest"),
+  osd_op_cpu_stats(cct->_conf, "osd_op_cpu_stats"),
   publish_lock{ceph::make_mutex("OSDService::publish_lock")},
   pre_publish_lock{ceph::make_mutex("OSDService::pre_publish_lock")},
   m_osd_scrub{cct, *this, cct->_conf},
@@ -293,6 +295,14 @@ OSDService::OSDService(OSD *osd, ceph::async::io_context_pool& poolctx) :
     auto fin = make_unique<Finisher>(osd->client_messenger->cct, str.str(), "finisher");
     objecter_finishers.push_back(std::move(fin));
   }
+
+  const auto scrub_compare_threads =
+    cct->_conf.get_val<uint64_t>("osd_scrub_compare_threads");
+  for (uint64_t i = 0; i < scrub_compare_threads; i++) {
+    auto fin = make_unique<Finisher>(cct, fmt::format("scrub-compare-{}", i),
+                                     "fn_scrub_cmp");
+    scrub_compare_finishers.push_back(std::move(fin));
+  }
 }
 
 #ifdef PG_DEBUG_REFS
@@ -511,6 +521,10 @@ void OSDService::shutdown()
     f->wait_for_empty();
     f->stop();
   }
+  for (auto& f : scrub_compare_finishers) {
+    f->wait_for_empty();
+    f->stop();
+  }
 
   publish_map(OSDMapRef());
   next_osdmap = OSDMapRef();
@@ -522,6 +536,9 @@ void OSDService::init()
   for (auto& f : objecter_finishers) {
     f->start();
   }
+  for (auto& f : scrub_compare_finishers) {
+    f->start();
+  }
   objecter->set_client_incarnation(0);
 
   // deprioritize objecter in daemonperf output
@@ -2332,6 +2349,9 @@ OSD::OSD(CephContext *cct_,
   osd_compat(get_osd_compat_set()),
   osd_op_tp(cct, "OSD::osd_op_tp", "tp_osd_tp",
 	    get_num_op_threads()),
+  mapper_tp(cct, "OSD::mapper_tp", "tp_osd_mapper",
+	    cct->_conf->osd_map_mapper_threads),
+  mapper(cct, &mapper_tp),
   heartbeat_stop(false),
   heartbeat_need_update(true),
   hb_front_client_messenger(hb_client_front),
@@ -2550,12 +2570,26 @@ int OSD::set_numa_affinity()
 	      << " cpus "
 	      << cpu_set_to_str_list(numa_cpu_set_size, &numa_cpu_set)
 	      << dendl;
-      r = set_cpu_affinity_all_threads(numa_cpu_set_size, &numa_cpu_set);
+      if (!cct->_conf.get_val<std::string>("osd_op_shard_cpus").empty() ||
+	  !cct->_conf->ms_async_worker_cpus.empty()) {
+	// don't undo the explicit per thread pinning
+	dout(1) << __func__ << " op shard or messenger threads are pinned,"
+		<< " not changing the cpu affinity" << dendl;
+	r = 0;
+      } else {
+	r = set_cpu_affinity_all_threads(numa_cpu_set_size, &numa_cpu_set);
+      }
       if (r < 0) {
 	r = -errno;
 	derr << __func__ << " failed to set numa affinity: " << cpp_strerror(r)
 	     << dendl;
 	numa_node = -1;
+      } else if (g_conf().get_val<bool>("osd_numa_local_memory")) {
+	// the op shard threads pick this up the next time they run; that
+	// keeps the caches they populate (onodes, buffers, pg state) local.
+	dout(1) << __func__ << " preferring numa node " << numa_node
+		<< " for op shard allocations" << dendl;
+	numa_memory_node = numa_node;
       }
     }
   } else {
@@ -2821,6 +2855,13 @@ will start to track new ops received afterwards.";
     f->open_object_section("pq");
     op_shardedwq.dump(f);
     f->close_section();
+  } else if (prefix == "dump_op_cpu_stats") {
+    f->open_object_section("op_cpu_stats");
+    f->dump_bool("enabled", service.get_op_cpu_stats() != nullptr);
+    service.op_cpu_stats.dump(f);
+    f->close_section();
+  } else if (prefix == "reset_op_cpu_stats") {
+    service.op_cpu_stats.reset();
   } else if (prefix == "dump_blocklist") {
     list<pair<entity_addr_t,utime_t> > bl;
     list<pair<entity_addr_t,utime_t> > rbl;
@@ -3992,6 +4033,7 @@ int OSD::init()
   }
 
   osd_op_tp.start();
+  mapper_tp.start();
 
   // start the heartbeat
   heartbeat_thread.create("osd_srv_heartbt");
@@ -4131,6 +4173,14 @@ void OSD::final_init()
 				     asok_hook,
 				     "dump op queue state");
   ceph_assert(r == 0);
+  r = admin_socket->register_command("dump_op_cpu_stats",
+				     asok_hook,
+				     "dump cpu time spent per op type and cls method");
+  ceph_assert(r == 0);
+  r = admin_socket->register_command("reset_op_cpu_stats",
+				     asok_hook,
+				     "reset the cpu time spent per op type and cls method");
+  ceph_assert(r == 0);
   r = admin_socket->register_command("dump_blocklist",
 				     asok_hook,
 				     "dump blocklisted clients and times");
@@ -4591,6 +4641,8 @@ int OSD::shutdown()
     // then, wait on osd_op_tp to drain (TBD: should probably add a timeout)
     osd_op_tp.drain();
     osd_op_tp.stop();
+    mapper.drain();
+    mapper_tp.stop();
 
     utime_t  start_time_umount = ceph_clock_now();
     store->prepare_for_fast_shutdown();
@@ -4660,6 +4712,9 @@ int OSD::shutdown()
   osd_op_tp.stop();
   dout(10) << "op sharded tp stopped" << dendl;
 
+  mapper.drain();
+  mapper_tp.stop();
+
   dout(10) << "stopping agent" << dendl;
   service.agent_stop();
 
@@ -5242,7 +5297,7 @@ void OSD::load_pgs()
     derr << "failed to list pgs: " << cpp_strerror(-r) << dendl;
   }
 
-  int num = 0;
+  vector<PGRef> pgs;
   for (vector<coll_t>::iterator it = ls.begin();
        it != ls.end();
        ++it) {
@@ -5296,19 +5351,25 @@ void OSD::load_pgs()
       continue;
     }
 
-    // there can be no waiters here, so we don't call _wake_pg_slot
-
-    pg->lock();
     pg->ch = store->open_collection(pg->coll);
+    pgs.push_back(pg);
+  }
+
+  // read pg state, log
+  _read_pg_states(pgs);
 
-    // read pg state, log
-    pg->read_state(store.get());
+  int num = 0;
+  for (auto& pg : pgs) {
+    spg_t pgid = pg->get_pgid();
+
+    // there can be no waiters here, so we don't call _wake_pg_slot
 
+    pg->lock();
     if (pg->dne())  {
-      dout(10) << "load_pgs " << *it << " deleting dne" << dendl;
+      dout(10) << "load_pgs " << pg->coll << " deleting dne" << dendl;
       pg->ch = nullptr;
       pg->unlock();
-      recursive_remove_collection(cct, store.get(), pgid, *it);
+      recursive_remove_collection(cct, store.get(), pgid, pg->coll);
       continue;
     }
     {
@@ -5326,6 +5387,38 @@ void OSD::load_pgs()
   dout(0) << __func__ << " opened " << num << " pgs" << dendl;
 }
 
+void OSD::_read_pg_states(const vector<PGRef>& pgs)
+{
+  // the pgs are independent of each other, and most of the time goes
+  // to reading their info and log, so with many pgs it pays off to have
+  // a few threads keep the store busy
+  unsigned num_threads = std::min<size_t>(
+    cct->_conf->osd_load_pgs_threads, pgs.size());
+  dout(10) << __func__ << " " << pgs.size() << " pgs with "
+	   << num_threads << " threads" << dendl;
+  std::atomic<size_t> next = 0;
+  auto read_states = [&] {
+    size_t i;
+    while ((i = next++) < pgs.size()) {
+      pgs[i]->lock();
+      pgs[i]->read_state(store.get());
+      pgs[i]->unlock();
+    }
+  };
+  if (num_threads <= 1) {
+    read_states();
+    return;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (unsigned i = 0; i < num_threads; ++i) {
+    threads.push_back(make_named_thread("osd_load_pgs", read_states));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
 
 PGRef OSD::handle_pg_create_info(const OSDMapRef& osdmap,
 				 const PGCreateInfo *info)
@@ -6177,6 +6270,11 @@ void OSD::heartbeat()
   auto mnow = service.get_mnow();
   utime_t deadline = now;
   deadline += cct->_conf->osd_heartbeat_grace;
+  // the same for every ping of this round
+  const uuid_d fsid = monc->get_fsid();
+  const epoch_t map_epoch = service.get_osdmap_epoch();
+  const epoch_t up_epoch = service.get_up_epoch();
+  const unsigned min_size = cct->_conf->osd_heartbeat_min_size;
 
   // send heartbeats
   for (map<int,HeartbeatInfo>::iterator i = heartbeat_peers.begin();
@@ -6202,26 +6300,26 @@ void OSD::heartbeat()
     s->stamps->sent_ping(&delta_ub);
 
     i->second.con_back->send_message(
-      new MOSDPing(monc->get_fsid(),
-		   service.get_osdmap_epoch(),
+      new MOSDPing(fsid,
+		   map_epoch,
 		   MOSDPing::PING,
 		   now,
 		   mnow,
 		   mnow,
-		   service.get_up_epoch(),
-		   cct->_conf->osd_heartbeat_min_size,
+		   up_epoch,
+		   min_size,
 		   delta_ub));
 
     if (i->second.con_front)
       i->second.con_front->send_message(
-	new MOSDPing(monc->get_fsid(),
-		     service.get_osdmap_epoch(),
+	new MOSDPing(fsid,
+		     map_epoch,
 		     MOSDPing::PING,
 		     now,
 		     mnow,
 		     mnow,
-		     service.get_up_epoch(),
-		     cct->_conf->osd_heartbeat_min_size,
+		     up_epoch,
+		     min_size,
 		     delta_ub));
   }
 
@@ -6346,6 +6444,8 @@ void OSD::tick_without_osd_lock()
   logger->set(l_osd_cached_crc, ceph::buffer::get_cached_crc());
   logger->set(l_osd_cached_crc_adjusted, ceph::buffer::get_cached_crc_adjusted());
   logger->set(l_osd_missed_crc, ceph::buffer::get_missed_crc());
+  logger->set(l_osd_buffer_raw_cache_hit, ceph::buffer::get_raw_cache_hits());
+  logger->set(l_osd_buffer_raw_cache_miss, ceph::buffer::get_raw_cache_misses());
 
   // refresh osd stats
   struct store_statfs_t stbuf;
@@ -7725,6 +7825,7 @@ MPGStats* OSD::collect_pg_stats()
 
   osd_stat_t cur_stat = service.get_osd_stat();
   cur_stat.os_perf_stat = store->get_cur_stats();
+  update_mclock_capacity(cur_stat.os_perf_stat.os_commit_latency_ns);
 
   auto m = new MPGStats(monc->get_fsid(), get_osdmap_epoch());
   m->osd_stat = cur_stat;
@@ -7772,6 +7873,57 @@ MPGStats* OSD::collect_pg_stats()
   return m;
 }
 
+void OSD::update_mclock_capacity(uint64_t commit_latency_ns)
+{
+  // only ever called from collect_pg_stats(), serialized by the MgrClient
+  if (op_queue_type_t::mClockScheduler != osd_op_queue_type()) {
+    return;
+  }
+  if (!cct->_conf.get_val<bool>("osd_mclock_capacity_feedback")) {
+    // drop any scaling applied before the feedback was turned off, and
+    // restart the average from scratch if it is turned back on
+    mclock_commit_latency_avg_ns = 0;
+    if (mclock_capacity_ratio != 1.0) {
+      set_mclock_capacity_ratio(1.0);
+    }
+    return;
+  }
+  if (commit_latency_ns == 0) {
+    return;
+  }
+  // smooth out the per-interval samples, and measure the slowdown against
+  // the best the device has managed since we started
+  constexpr double alpha = 0.2;
+  if (mclock_commit_latency_avg_ns == 0) {
+    mclock_commit_latency_avg_ns = commit_latency_ns;
+  } else {
+    mclock_commit_latency_avg_ns = alpha * commit_latency_ns +
+      (1 - alpha) * mclock_commit_latency_avg_ns;
+  }
+  if (mclock_commit_latency_baseline_ns == 0 ||
+      mclock_commit_latency_avg_ns < mclock_commit_latency_baseline_ns) {
+    mclock_commit_latency_baseline_ns = mclock_commit_latency_avg_ns;
+  }
+  const double min_ratio =
+    cct->_conf.get_val<double>("osd_mclock_capacity_feedback_min_ratio");
+  const double ratio = std::clamp(
+    mclock_commit_latency_baseline_ns / mclock_commit_latency_avg_ns,
+    min_ratio, 1.0);
+  dout(20) << __func__ << " commit latency " << commit_latency_ns
+           << "ns avg " << mclock_commit_latency_avg_ns
+           << "ns baseline " << mclock_commit_latency_baseline_ns
+           << "ns capacity ratio " << ratio << dendl;
+  set_mclock_capacity_ratio(ratio);
+}
+
+void OSD::set_mclock_capacity_ratio(double ratio)
+{
+  mclock_capacity_ratio = ratio;
+  for (auto shard : shards) {
+    shard->update_scheduler_capacity_ratio(ratio);
+  }
+}
+
 vector<DaemonHealthMetric> OSD::get_health_metrics()
 {
   vector<DaemonHealthMetric> metrics;
@@ -8151,6 +8303,12 @@ void OSD::handle_osd_map(MOSDMap *m)
 
       ghobject_t fulloid = get_osdmap_pobject_name(e);
       t.write(coll_t::meta(), fulloid, 0, bl.length(), bl);
+      // keep the encoded map around too, so sharing it with peers and
+      // clients does not read it straight back from the store. cache a copy
+      // of it, as bl may point into the message with all the other maps
+      bufferlist cached_bl = bl;
+      cached_bl.rebuild();
+      service.add_map_bl(e, cached_bl);
       added_maps[e] = add_map(o);
       got_full_map(e);
       continue;
@@ -8223,6 +8381,10 @@ void OSD::handle_osd_map(MOSDMap *m)
 
       ghobject_t fulloid = get_osdmap_pobject_name(e);
       t.write(coll_t::meta(), fulloid, 0, fbl.length(), fbl);
+      bufferlist cached_bl = bl;
+      cached_bl.rebuild();
+      service.add_map_inc_bl(e, cached_bl);
+      service.add_map_bl(e, fbl);
       added_maps[e] = add_map(o);
       continue;
     }
@@ -8572,6 +8734,8 @@ void OSD::_committed_osd_maps(epoch_t first, epoch_t last, MOSDMap *m)
 
   check_osdmap_features();
 
+  precalc_pg_mappings(first, last);
+
   // yay!
   consume_map();
 
@@ -8743,6 +8907,7 @@ bool OSD::advance_pg(
 
   unsigned old_pg_num = lastmap->have_pg_pool(pg->pg_id.pool()) ?
     lastmap->get_pg_num(pg->pg_id.pool()) : 0;
+  auto mappings = get_pg_mappings();
   for (epoch_t next_epoch = first_new_epoch;
        next_epoch <= osd_epoch;
        ++next_epoch) {
@@ -8873,10 +9038,25 @@ bool OSD::advance_pg(
 
     vector<int> newup, newacting;
     int up_primary, acting_primary;
-    nextmap->pg_to_up_acting_osds(
-      pg->pg_id.pgid,
-      &newup, &up_primary,
-      &newacting, &acting_primary);
+    const pg_mapping_t *precalc = nullptr;
+    if (mappings) {
+      if (auto e = mappings->find(next_epoch); e != mappings->end()) {
+	if (auto q = e->second.find(pg->pg_id.pgid); q != e->second.end()) {
+	  precalc = &q->second;
+	}
+      }
+    }
+    if (precalc) {
+      newup = precalc->up;
+      up_primary = precalc->up_primary;
+      newacting = precalc->acting;
+      acting_primary = precalc->acting_primary;
+    } else {
+      nextmap->pg_to_up_acting_osds(
+	pg->pg_id.pgid,
+	&newup, &up_primary,
+	&newacting, &acting_primary);
+    }
     pg->handle_advance_map(
       nextmap, lastmap, newup, up_primary,
       newacting, acting_primary, rctx);
@@ -8926,6 +9106,123 @@ bool OSD::advance_pg(
   return ret;
 }
 
+/// the mappings of our PGs for one batch of committed maps, one job per
+/// epoch
+struct OSD::PGMappingBatch {
+  const epoch_t last;
+  std::shared_ptr<pg_mappings_t> precalc = std::make_shared<pg_mappings_t>();
+  std::vector<std::unique_ptr<PGMappingJob>> jobs;
+  std::atomic<unsigned> pending = 0; ///< jobs not complete yet
+  ceph::mono_time start = ceph::mono_clock::now();
+
+  explicit PGMappingBatch(epoch_t last) : last(last) {}
+  /// can we be freed? (the jobs were completed and let go of their locks)
+  bool is_done() {
+    return std::all_of(jobs.begin(), jobs.end(),
+		       [](auto& job) { return job->is_done(); });
+  }
+};
+
+struct OSD::PGMappingJob : public ParallelPGMapper::Job {
+  OSD *osd;
+  PGMappingBatch *batch;
+  OSDMapRef map;
+  std::map<pg_t, pg_mapping_t> *out;
+
+  PGMappingJob(OSD *osd, PGMappingBatch *batch, OSDMapRef m,
+	       std::map<pg_t, pg_mapping_t> *o)
+    : Job(m.get()), osd(osd), batch(batch), map(std::move(m)), out(o) {}
+
+  void process(const vector<pg_t>& pgs) override {
+    // every pg has its own (preallocated) entry, so workers never touch
+    // the same element and need no locking
+    for (auto pgid : pgs) {
+      auto& m = out->at(pgid);
+      map->pg_to_up_acting_osds(pgid, &m.up, &m.up_primary,
+				&m.acting, &m.acting_primary);
+    }
+  }
+  void process(int64_t pool, unsigned ps_begin, unsigned ps_end) override {}
+  void complete() override {
+    if (--batch->pending == 0) {
+      osd->finish_pg_mappings(*batch);
+    }
+  }
+};
+
+void OSD::precalc_pg_mappings(epoch_t first, epoch_t last)
+{
+  ceph_assert(ceph_mutex_is_locked(osd_lock));
+  const unsigned num_threads = cct->_conf->osd_map_mapper_threads;
+  if (num_threads == 0) {
+    return;
+  }
+
+  pg_mapping_batches.remove_if([](auto& batch) { return batch->is_done(); });
+
+  set<pg_t> pgset;
+  {
+    vector<spg_t> pgids;
+    _get_pgids(&pgids);
+    for (auto& pgid : pgids) {
+      pgset.insert(pgid.pgid);
+    }
+  }
+  auto batch = std::make_shared<PGMappingBatch>(last);
+  if (!pgset.empty()) {
+    vector<pg_t> pgs(pgset.begin(), pgset.end());
+    // PGs behind by more than a batch of maps catch up on their own
+    first = std::max<epoch_t>(
+      first, last + 1 - std::min<epoch_t>(last, cct->_conf->osd_map_message_max));
+    for (epoch_t e = first; e <= last; ++e) {
+      OSDMapRef map = get_map(e);
+      if (!map) {
+	continue;
+      }
+      auto& out = (*batch->precalc)[e];
+      for (auto pgid : pgs) {
+	out[pgid];
+      }
+      batch->jobs.emplace_back(
+	std::make_unique<PGMappingJob>(this, batch.get(), std::move(map), &out));
+    }
+    // the mapping happens off osd_lock: the PGs advancing meanwhile map
+    // the epochs they do not find themselves, as they would without it
+    if (!batch->jobs.empty()) {
+      const unsigned pgs_per_item = std::max<unsigned>(1, pgs.size() / num_threads);
+      dout(10) << __func__ << " mapping " << pgs.size() << " pgs for "
+	       << batch->jobs.size() << " epochs " << first << ".." << last
+	       << dendl;
+      batch->pending = batch->jobs.size();
+      pg_mapping_batches.push_back(batch);
+      for (auto& job : batch->jobs) {
+	mapper.queue(job.get(), pgs_per_item, pgs);
+      }
+      return;
+    }
+  }
+  publish_pg_mappings(last, batch->precalc);
+}
+
+void OSD::finish_pg_mappings(PGMappingBatch& batch)
+{
+  dout(10) << __func__ << " mapped epochs through " << batch.last << " in "
+	   << ceph::mono_clock::now() - batch.start << dendl;
+  publish_pg_mappings(batch.last, batch.precalc);
+}
+
+void OSD::publish_pg_mappings(epoch_t last,
+			      std::shared_ptr<const pg_mappings_t> precalc)
+{
+  std::lock_guard l(pg_mappings_lock);
+  // a batch finishing after a later one has nothing to add
+  if (last < pg_mappings_last) {
+    return;
+  }
+  pg_mappings_last = last;
+  pg_mappings = std::move(precalc);
+}
+
 void OSD::consume_map()
 {
   ceph_assert(ceph_mutex_is_locked(osd_lock));
@@ -9436,7 +9733,7 @@ void OSDService::_maybe_queue_recovery() {
 	 _recover_now(&available_pushes)) {
     uint64_t to_start = std::min(
       available_pushes,
-      cct->_conf->osd_recovery_max_single_start);
+      _get_recovery_single_start(awaiting_throttle.front().cost_per_object));
     _queue_for_recovery(awaiting_throttle.front(), to_start);
     awaiting_throttle.pop_front();
     dout(10) << __func__ << " starting " << to_start
@@ -9446,6 +9743,18 @@ void OSDService::_maybe_queue_recovery() {
   }
 }
 
+uint64_t OSDService::_get_recovery_single_start(uint64_t cost_per_object) const
+{
+  uint64_t max_start = cct->_conf->osd_recovery_max_single_start;
+  // small objects are latency bound: start enough of them at once to
+  // fill a batch, the pushes to each peer then share MOSDPGPushes
+  uint64_t batch_bytes = cct->_conf->osd_recovery_small_object_batch_bytes;
+  if (batch_bytes && cost_per_object && cost_per_object < batch_bytes) {
+    max_start = std::max(max_start, batch_bytes / cost_per_object);
+  }
+  return max_start;
+}
+
 bool OSDService::_recover_now(uint64_t *available_pushes)
 {
   if (available_pushes)
@@ -9645,7 +9954,8 @@ bool OSD::op_is_discardable(const MOSDOp *op)
 void OSD::enqueue_op(spg_t pg, OpRequestRef&& op, epoch_t epoch)
 {
   const utime_t stamp = op->get_req()->get_recv_stamp();
-  const utime_t latency = ceph_clock_now() - stamp;
+  const utime_t now = ceph_clock_now();
+  const utime_t latency = now - stamp;
   const unsigned priority = op->get_req()->get_priority();
   const int cost = op->get_req()->get_cost();
   const uint64_t owner = op->get_req()->get_source().num();
@@ -9671,6 +9981,7 @@ void OSD::enqueue_op(spg_t pg, OpRequestRef&& op, epoch_t epoch)
     });
 
   op->mark_queued_for_pg();
+  op->set_queued_time(now);
   logger->tinc(l_osd_op_before_queue_op_lat, latency);
   if (PGRecoveryMsg::is_recovery_msg(op)) {
     op_shardedwq.queue(
@@ -10804,6 +11115,12 @@ void OSDShard::update_scheduler_config()
   scheduler->update_configuration();
 }
 
+void OSDShard::update_scheduler_capacity_ratio(double ratio)
+{
+  std::lock_guard l(shard_lock);
+  scheduler->update_capacity_ratio(ratio);
+}
+
 op_queue_type_t OSDShard::get_op_queue_type() const
 {
   return scheduler->get_type();
@@ -10869,6 +11186,35 @@ void OSD::ShardedOpWQ::_process(uint32_t thread_index, heartbeat_handle_d *hb)
   auto& sdata = osd->shards[shard_index];
   ceph_assert(sdata);
 
+  // shard threads exist before we know our numa node; apply the memory
+  // policy lazily, from the thread itself.
+  static thread_local int applied_numa_memory_node = -1;
+  if (int node = osd->numa_memory_node.load(std::memory_order_relaxed);
+      node != applied_numa_memory_node) {
+    int r = set_preferred_memory_node(node);
+    if (r < 0) {
+      dout(1) << __func__ << " unable to prefer numa node " << node
+	      << " for allocations: " << cpp_strerror(r) << dendl;
+    }
+    applied_numa_memory_node = node;
+  }
+  static thread_local bool applied_shard_cpu = false;
+  if (!applied_shard_cpu) {
+    applied_shard_cpu = true;
+    if (auto cpus = osd->cct->_conf.get_val<std::string>("osd_op_shard_cpus");
+	!cpus.empty()) {
+      int cpu = -1;
+      int r = set_cpu_affinity_this_thread_nth(cpus.c_str(), shard_index, &cpu);
+      if (r < 0) {
+	derr << __func__ << " unable to pin shard " << shard_index
+	     << " to a cpu of '" << cpus << "': " << cpp_strerror(r) << dendl;
+      } else {
+	dout(1) << __func__ << " shard " << shard_index << " thread "
+		<< thread_index << " pinned to cpu " << cpu << dendl;
+      }
+    }
+  }
+
   // If all threads of shards do oncommits, there is a out-of-order
   // problem.  So we choose the thread which has the smallest
   // thread_index(thread_index < num_shards) of shard to do oncommit
@@ -35,6 +35,7 @@
 #include "include/CompatSet.h"
 #include "include/common_fwd.h"
 
+#include "OpCpuStats.h"
 #include "OpRequest.h"
 #include "Session.h"
 
@@ -52,6 +53,7 @@
 #include "messages/MOSDOp.h"
 #include "common/EventTrace.h"
 #include "osd/osd_perf_counters.h"
+#include "osd/OSDMapMapping.h"
 #include "common/Finisher.h"
 #include "scrubber/osd_scrub.h"
 
@@ -115,6 +117,13 @@ public:
 
   md_config_cacher_t<Option::size_t> osd_max_object_size;
   md_config_cacher_t<bool> osd_skip_data_digest;
+  md_config_cacher_t<bool> osd_op_cpu_stats;
+
+  OpCpuStats op_cpu_stats;
+  /// the stats to account the cpu time of ops in, if enabled
+  OpCpuStats *get_op_cpu_stats() {
+    return osd_op_cpu_stats ? &op_cpu_stats : nullptr;
+  }
 
   void enqueue_back(OpSchedulerItem&& qi);
   void enqueue_front(OpSchedulerItem&& qi);
@@ -416,6 +425,17 @@ public:
     return objecter_finishers[shard].get();
   }
 
+  /// the finisher to compare the maps of a scrub chunk of 'pgid' on, or
+  /// nullptr if they are to be compared under the PG lock
+  Finisher* get_scrub_compare_finisher(spg_t pgid) {
+    if (scrub_compare_finishers.empty()) {
+      return nullptr;
+    }
+    return scrub_compare_finishers[
+      pgid.pgid.ps() % scrub_compare_finishers.size()].get();
+  }
+  std::vector<std::unique_ptr<Finisher>> scrub_compare_finishers;
+
   // -- Objecter, for tiering reads/writes from/to other OSDs --
   ceph::async::io_context_pool& poolctx;
   std::unique_ptr<Objecter> objecter;
@@ -599,6 +619,7 @@ private:
   std::map<spg_t, std::set<hobject_t> > recovery_oids;
 #endif
   bool _recover_now(uint64_t *available_pushes);
+  uint64_t _get_recovery_single_start(uint64_t cost_per_object) const;
   void _maybe_queue_recovery();
   void _queue_for_recovery(pg_awaiting_throttle_t p, uint64_t reserved_pushes);
 public:
@@ -688,6 +709,10 @@ public:
   OSDMapRef _add_map(OSDMap *o);
 
   void _add_map_bl(epoch_t e, ceph::buffer::list& bl);
+  void add_map_bl(epoch_t e, ceph::buffer::list& bl) {
+    std::lock_guard l(map_cache_lock);
+    _add_map_bl(e, bl);
+  }
   bool get_map_bl(epoch_t e, ceph::buffer::list& bl) {
     std::lock_guard l(map_cache_lock);
     return _get_map_bl(e, bl);
@@ -695,6 +720,10 @@ public:
   bool _get_map_bl(epoch_t e, ceph::buffer::list& bl);
 
   void _add_map_inc_bl(epoch_t e, ceph::buffer::list& bl);
+  void add_map_inc_bl(epoch_t e, ceph::buffer::list& bl) {
+    std::lock_guard l(map_cache_lock);
+    _add_map_inc_bl(e, bl);
+  }
   bool get_inc_map_bl(epoch_t e, ceph::buffer::list& bl);
 
   /// identify split child pgids over a osdmap interval
@@ -1038,6 +1067,7 @@ struct OSDShard {
   void register_and_wake_split_child(PG *pg);
   void unprime_split_children(spg_t parent, unsigned old_pg_num);
   void update_scheduler_config();
+  void update_scheduler_capacity_ratio(double ratio);
   op_queue_type_t get_op_queue_type() const;
 
   OSDShard(
@@ -1097,6 +1127,8 @@ protected:
   int numa_node = -1;
   size_t numa_cpu_set_size = 0;
   cpu_set_t numa_cpu_set;
+  /// numa node op shard threads should allocate from (-1 for none)
+  std::atomic<int> numa_memory_node = {-1};
 
   bool store_is_rotational = true;
   bool journal_is_rotational = true;
@@ -1270,6 +1302,37 @@ private:
 
   ShardedThreadPool osd_op_tp;
 
+  // -- precalculated pg mappings --
+  /// threads mapping our PGs for newly committed maps (osd_map_mapper_threads)
+  ThreadPool mapper_tp;
+  ParallelPGMapper mapper;
+
+  struct pg_mapping_t {
+    std::vector<int> up, acting;
+    int up_primary = -1, acting_primary = -1;
+  };
+  /// epoch -> up/acting of each of our PGs in that epoch
+  using pg_mappings_t = std::map<epoch_t, std::map<pg_t, pg_mapping_t>>;
+  struct PGMappingJob;
+  struct PGMappingBatch;
+
+  /// batches queued on the mapper and not reaped yet, under osd_lock
+  std::list<std::shared_ptr<PGMappingBatch>> pg_mapping_batches;
+
+  ceph::mutex pg_mappings_lock = ceph::make_mutex("OSD::pg_mappings_lock");
+  std::shared_ptr<const pg_mappings_t> pg_mappings;
+  epoch_t pg_mappings_last = 0; ///< last epoch of pg_mappings
+
+  void precalc_pg_mappings(epoch_t first, epoch_t last);
+  /// called by the mapper thread completing the last job of a batch
+  void finish_pg_mappings(PGMappingBatch& batch);
+  void publish_pg_mappings(epoch_t last,
+			   std::shared_ptr<const pg_mappings_t> precalc);
+  std::shared_ptr<const pg_mappings_t> get_pg_mappings() {
+    std::lock_guard l(pg_mappings_lock);
+    return pg_mappings;
+  }
+
   void get_latest_osdmap();
 
   // -- sessions --
@@ -1765,6 +1828,7 @@ protected:
   void resume_creating_pg();
 
   void load_pgs();
+  void _read_pg_states(const std::vector<PGRef>& pgs);
 
   epoch_t last_pg_create_epoch;
 
@@ -1873,6 +1937,13 @@ protected:
 
   // -- status reporting --
   MPGStats *collect_pg_stats();
+  /// feed the latest object store commit latency to the mclock capacity
+  /// estimate (osd_mclock_capacity_feedback)
+  void update_mclock_capacity(uint64_t commit_latency_ns);
+  void set_mclock_capacity_ratio(double ratio);
+  double mclock_capacity_ratio = 1.0;
+  double mclock_commit_latency_avg_ns = 0;
+  double mclock_commit_latency_baseline_ns = 0;
   std::vector<DaemonHealthMetric> get_health_metrics();
 
 
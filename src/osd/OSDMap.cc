@@ -16,9 +16,12 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <bit>
+#include <functional>
 #include <optional>
 #include <random>
+#include <thread>
 #include <fmt/format.h>
 
 #include <boost/algorithm/string.hpp>
@@ -241,6 +244,233 @@ int OSDMap::Incremental::identify_osd(uuid_d u) const
   return -1;
 }
 
+bool OSDMap::Incremental::squash(const Incremental& next)
+{
+  if (next.get_base_epoch() != epoch ||
+      fullmap.length() || next.fullmap.length() ||
+      (crush.length() && next.crush.length())) {
+    return false;
+  }
+
+  // anything apply_incremental() does in an order that folding the two
+  // would change
+  auto touches_osds = [](const Incremental& i) {
+    return !i.new_state.empty() || !i.new_up_client.empty() ||
+      !i.new_up_cluster.empty() || !i.new_weight.empty() ||
+      !i.new_primary_affinity.empty() || !i.new_up_thru.empty() ||
+      !i.new_last_clean_interval.empty() || !i.new_lost.empty() ||
+      !i.new_uuid.empty() || !i.new_xinfo.empty();
+  };
+  auto touches_osd = [](const Incremental& i, int32_t osd) {
+    return i.new_state.count(osd) || i.new_up_client.count(osd) ||
+      i.new_weight.count(osd) || i.new_primary_affinity.count(osd);
+  };
+  if (next.new_max_osd >= 0 && (new_max_osd >= 0 || touches_osds(*this))) {
+    return false;
+  }
+  for (auto& [osd, state] : next.new_state) {
+    // an osd marked up by us would be marked up again, not down
+    if (new_up_client.count(osd)) {
+      return false;
+    }
+    // an osd destroyed (or created) and touched on the other side
+    if ((state & CEPH_OSD_EXISTS) && touches_osd(*this, osd)) {
+      return false;
+    }
+  }
+  for (auto& [osd, state] : new_state) {
+    if ((state & CEPH_OSD_EXISTS) && touches_osd(next, osd)) {
+      return false;
+    }
+  }
+  // marking in clears AUTOOUT and NEW, marking out does not
+  for (auto& [osd, weight] : next.new_weight) {
+    if (auto p = new_weight.find(osd);
+	!weight && p != new_weight.end() && p->second) {
+      return false;
+    }
+  }
+  for (auto& [pool, p] : next.new_pools) {
+    if (old_pools.count(pool)) {
+      return false;
+    }
+  }
+  // blocklisting does not update the expiration of an existing entry
+  for (auto& [addr, until] : next.new_blocklist) {
+    if (std::find(old_blocklist.begin(), old_blocklist.end(), addr) !=
+	old_blocklist.end()) {
+      return false;
+    }
+  }
+  for (auto& [addr, until] : next.new_range_blocklist) {
+    if (std::find(old_range_blocklist.begin(), old_range_blocklist.end(),
+		  addr) != old_range_blocklist.end()) {
+      return false;
+    }
+  }
+
+  base_epoch = get_base_epoch();
+  epoch = next.epoch;
+  modified = next.modified;
+  encode_features = next.encode_features;
+  full_crc = next.full_crc;
+  if (next.new_pool_max != -1)
+    new_pool_max = next.new_pool_max;
+  if (next.new_flags >= 0)
+    new_flags = next.new_flags;
+  if (next.new_max_osd >= 0)
+    new_max_osd = next.new_max_osd;
+  if (next.crush.length())
+    crush = next.crush;
+
+  for (auto& [pool, p] : next.new_pools)
+    new_pools[pool] = p;
+  for (auto& [pool, name] : next.new_pool_names)
+    new_pool_names[pool] = name;
+  for (auto pool : next.old_pools) {
+    new_pools.erase(pool);
+    new_pool_names.erase(pool);
+    old_pools.insert(pool);
+  }
+  for (auto& [name, profile] : next.new_erasure_code_profiles)
+    new_erasure_code_profiles[name] = profile;
+  for (auto& name : next.old_erasure_code_profiles) {
+    new_erasure_code_profiles.erase(name);
+    old_erasure_code_profiles.push_back(name);
+  }
+
+  // weights go in before states: marking in clears these bits, so they
+  // must not be flipped back afterwards
+  for (auto& [osd, weight] : next.new_weight) {
+    new_weight[osd] = weight;
+    auto p = new_state.find(osd);
+    if (weight && p != new_state.end()) {
+      uint32_t s = p->second ? p->second : CEPH_OSD_UP;
+      s &= ~(CEPH_OSD_AUTOOUT | CEPH_OSD_NEW);
+      if (s) {
+	p->second = s;
+      } else {
+	new_state.erase(p);
+      }
+    }
+  }
+  for (auto& [osd, affinity] : next.new_primary_affinity)
+    new_primary_affinity[osd] = affinity;
+  // states are XORed, and 0 is a legacy alias for CEPH_OSD_UP
+  for (auto& [osd, state] : next.new_state) {
+    auto p = new_state.find(osd);
+    if (p == new_state.end()) {
+      new_state[osd] = state;
+      continue;
+    }
+    uint32_t s = (p->second ? p->second : CEPH_OSD_UP) ^
+      (state ? state : CEPH_OSD_UP);
+    if (s) {
+      p->second = s;
+    } else {
+      new_state.erase(p);
+    }
+  }
+  for (auto& [osd, addrs] : next.new_up_client)
+    new_up_client[osd] = addrs;
+  for (auto& [osd, addrs] : next.new_up_cluster)
+    new_up_cluster[osd] = addrs;
+  for (auto& [osd, addrs] : next.new_hb_back_up)
+    new_hb_back_up[osd] = addrs;
+  for (auto& [osd, addrs] : next.new_hb_front_up)
+    new_hb_front_up[osd] = addrs;
+  for (auto& [osd, e] : next.new_up_thru)
+    new_up_thru[osd] = e;
+  for (auto& [osd, interval] : next.new_last_clean_interval)
+    new_last_clean_interval[osd] = interval;
+  for (auto& [osd, e] : next.new_lost)
+    new_lost[osd] = e;
+  for (auto& [osd, uuid] : next.new_uuid)
+    new_uuid[osd] = uuid;
+  for (auto& [osd, xinfo] : next.new_xinfo)
+    new_xinfo[osd] = xinfo;
+
+  for (auto& [pg, osds] : next.new_pg_temp)
+    new_pg_temp[pg] = osds;
+  for (auto& [pg, osd] : next.new_primary_temp)
+    new_primary_temp[pg] = osd;
+  for (auto& [pg, osds] : next.new_pg_upmap) {
+    new_pg_upmap[pg] = osds;
+    old_pg_upmap.erase(pg);
+  }
+  for (auto& pg : next.old_pg_upmap) {
+    new_pg_upmap.erase(pg);
+    old_pg_upmap.insert(pg);
+  }
+  for (auto& [pg, items] : next.new_pg_upmap_items) {
+    new_pg_upmap_items[pg] = items;
+    old_pg_upmap_items.erase(pg);
+  }
+  for (auto& pg : next.old_pg_upmap_items) {
+    new_pg_upmap_items.erase(pg);
+    old_pg_upmap_items.insert(pg);
+  }
+  for (auto& [pg, osd] : next.new_pg_upmap_primary) {
+    new_pg_upmap_primary[pg] = osd;
+    old_pg_upmap_primary.erase(pg);
+  }
+  for (auto& pg : next.old_pg_upmap_primary) {
+    new_pg_upmap_primary.erase(pg);
+    old_pg_upmap_primary.insert(pg);
+  }
+  for (auto& [pool, snaps] : next.new_removed_snaps)
+    new_removed_snaps[pool].union_of(snaps);
+  for (auto& [pool, snaps] : next.new_purged_snaps)
+    new_purged_snaps[pool].union_of(snaps);
+
+  for (auto& [addr, until] : next.new_blocklist)
+    new_blocklist.insert({addr, until});
+  for (auto& addr : next.old_blocklist) {
+    new_blocklist.erase(addr);
+    old_blocklist.push_back(addr);
+  }
+  for (auto& [addr, until] : next.new_range_blocklist)
+    new_range_blocklist.insert({addr, until});
+  for (auto& addr : next.old_range_blocklist) {
+    new_range_blocklist.erase(addr);
+    old_range_blocklist.push_back(addr);
+  }
+
+  for (auto& [node, flags] : next.new_crush_node_flags)
+    new_crush_node_flags[node] = flags;
+  for (auto& [cls, flags] : next.new_device_class_flags)
+    new_device_class_flags[cls] = flags;
+
+  cluster_snapshot = next.cluster_snapshot;
+  if (next.new_nearfull_ratio >= 0)
+    new_nearfull_ratio = next.new_nearfull_ratio;
+  if (next.new_backfillfull_ratio >= 0)
+    new_backfillfull_ratio = next.new_backfillfull_ratio;
+  if (next.new_full_ratio >= 0)
+    new_full_ratio = next.new_full_ratio;
+  if (next.new_require_min_compat_client > ceph_release_t::unknown)
+    new_require_min_compat_client = next.new_require_min_compat_client;
+  // the flags are adjusted to whichever release the last one requires
+  if (next.new_require_osd_release >= ceph_release_t::unknown)
+    new_require_osd_release = next.new_require_osd_release;
+  if (next.new_last_up_change != utime_t())
+    new_last_up_change = next.new_last_up_change;
+  if (next.new_last_in_change != utime_t())
+    new_last_in_change = next.new_last_in_change;
+
+  if (next.change_stretch_mode) {
+    change_stretch_mode = true;
+    stretch_mode_enabled = next.stretch_mode_enabled;
+    new_stretch_bucket_count = next.new_stretch_bucket_count;
+    new_degraded_stretch_mode = next.new_degraded_stretch_mode;
+    new_recovering_stretch_mode = next.new_recovering_stretch_mode;
+    new_stretch_mode_bucket = next.new_stretch_mode_bucket;
+  }
+  if (next.mutate_allow_crimson != mutate_allow_crimson_t::NONE)
+    mutate_allow_crimson = next.mutate_allow_crimson;
+  return true;
+}
+
 int OSDMap::Incremental::propagate_base_properties_to_tiers(CephContext *cct,
 							    const OSDMap& osdmap)
 {
@@ -591,6 +821,11 @@ void OSDMap::Incremental::encode(ceph::buffer::list& bl, uint64_t features) cons
     } /* else if (!HAVE_FEATURE(features, SERVER_REEF)) {
       v = 8;
     } */
+    if (base_epoch) {
+      // squashed incrementals only go to clients that understand them
+      ceph_assert(v == 9);
+      v = 10;
+    }
     ENCODE_START(v, 1, bl); // client-usable data
     encode(fsid, bl);
     encode(epoch, bl);
@@ -653,6 +888,9 @@ void OSDMap::Incremental::encode(ceph::buffer::list& bl, uint64_t features) cons
       encode(new_pg_upmap_primary, bl);
       encode(old_pg_upmap_primary, bl);
     }
+    if (v >= 10) {
+      encode(base_epoch, bl);
+    }
     ENCODE_FINISH(bl); // client-usable data
   }
 
@@ -938,6 +1176,11 @@ void OSDMap::Incremental::decode(ceph::buffer::list::const_iterator& bl)
       decode(new_pg_upmap_primary, bl);
       decode(old_pg_upmap_primary, bl);
     }
+    if (struct_v >= 10) {
+      decode(base_epoch, bl);
+    } else {
+      base_epoch = 0;
+    }
     DECODE_FINISH(bl); // client-usable data
   }
 
@@ -1051,6 +1294,9 @@ void OSDMap::Incremental::decode(ceph::buffer::list::const_iterator& bl)
 void OSDMap::Incremental::dump(Formatter *f) const
 {
   f->dump_int("epoch", epoch);
+  if (base_epoch) {
+    f->dump_int("base_epoch", base_epoch);
+  }
   f->dump_stream("fsid") << fsid;
   f->dump_stream("modified") << modified;
   f->dump_stream("new_last_up_change") << new_last_up_change;
@@ -2273,9 +2519,9 @@ int OSDMap::apply_incremental(const Incremental &inc)
   else if (inc.fsid != fsid)
     return -EINVAL;
   
-  ceph_assert(inc.epoch == epoch+1);
+  ceph_assert(inc.get_base_epoch() == epoch);
 
-  epoch++;
+  epoch = inc.epoch;
   modified = inc.modified;
 
   // full map?
@@ -5512,6 +5758,102 @@ int OSDMap::calc_desired_primary_distribution_osdsize_opt(
   return 0;
 
 }
+namespace {
+unsigned get_upmap_threads(CephContext *cct)
+{
+  auto n = cct->_conf.get_val<uint64_t>("osd_calc_pg_upmaps_threads");
+  return std::clamp<uint64_t>(n, 1, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// threads kept around for the length of a calc_pg_upmaps() call, so that
+// the many small batches it searches do not each pay for spawning threads
+class upmap_workers_t {
+  ceph::mutex lock = ceph::make_mutex("upmap_workers_t::lock");
+  ceph::condition_variable cond;       ///< a new job, or stopping
+  ceph::condition_variable done_cond;  ///< busy dropped to 0
+  std::vector<std::thread> threads;
+  const std::function<void(size_t)> *job = nullptr;
+  size_t job_size = 0;
+  uint64_t job_seq = 0;
+  std::atomic<size_t> next = 0;
+  unsigned busy = 0;                   ///< workers inside the current job
+  bool stopping = false;
+
+  void work(const std::function<void(size_t)>& f, size_t n) {
+    for (size_t i; (i = next++) < n; ) {
+      f(i);
+    }
+  }
+
+  void entry() {
+    uint64_t seen = 0;
+    std::unique_lock l{lock};
+    while (true) {
+      cond.wait(l, [&] { return stopping || job_seq != seen; });
+      if (stopping) {
+	return;
+      }
+      seen = job_seq;
+      if (!job) {
+	// woke up after the caller was done with it
+	continue;
+      }
+      ++busy;
+      auto f = job;
+      size_t n = job_size;
+      l.unlock();
+      work(*f, n);
+      l.lock();
+      if (--busy == 0) {
+	done_cond.notify_all();
+      }
+    }
+  }
+
+public:
+  explicit upmap_workers_t(unsigned num_threads) {
+    for (unsigned t = 1; t < num_threads; ++t) {
+      threads.emplace_back([this] { entry(); });
+    }
+  }
+  ~upmap_workers_t() {
+    {
+      std::lock_guard l{lock};
+      stopping = true;
+    }
+    cond.notify_all();
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+
+  /// call f(0) ... f(n - 1), spread over the caller and the workers
+  template <typename F>
+  void parallel_for(size_t n, F&& f) {
+    if (threads.empty() || n <= 1) {
+      for (size_t i = 0; i < n; ++i) {
+	f(i);
+      }
+      return;
+    }
+    std::function<void(size_t)> fn{std::ref(f)};
+    {
+      std::lock_guard l{lock};
+      job = &fn;
+      job_size = n;
+      next = 0;
+      ++job_seq;
+    }
+    cond.notify_all();
+    work(fn, n);
+    std::unique_lock l{lock};
+    // every index is taken once we get here; wait for those still running
+    done_cond.wait(l, [this] { return busy == 0; });
+    job = nullptr;
+  }
+};
+} // anonymous namespace
+
 int OSDMap::calc_pg_upmaps(
   CephContext *cct,
   uint32_t max_deviation,
@@ -5568,7 +5910,11 @@ int OSDMap::calc_pg_upmaps(
     cct->_conf.get_val<bool>("osd_calc_pg_upmaps_aggressively_fast");
   auto local_fallback_retries =
     cct->_conf.get_val<uint64_t>("osd_calc_pg_upmaps_local_fallback_retries");
-    
+  const unsigned num_threads = get_upmap_threads(cct);
+  const size_t search_batch = num_threads > 1 ? num_threads * 4 : 1;
+  upmap_workers_t workers(num_threads);
+
+
   while (max--) {
     ldout(cct, 30) << "Top of loop #" << max+1 << dendl;
     // build overfull and underfull
@@ -5601,12 +5947,13 @@ int OSDMap::calc_pg_upmaps(
     // If we can't find a change per OSD we skip further iterations for this OSD
     uint n_changes = 0, prev_n_changes = 0;
     set<int> osd_to_skip;
+    pgs_by_osd_txn_t temp_pgs_by_osd(pgs_by_osd);
 
   retry:
 
+    temp_pgs_by_osd.rollback();
     set<pg_t> to_unmap;
     map<pg_t, mempool::osdmap::vector<pair<int32_t,int32_t>>> to_upmap;
-    auto temp_pgs_by_osd = pgs_by_osd;
     // always start with fullest, break if we find any changes to make
     for (auto p = deviation_osd.rbegin(); p != deviation_osd.rend(); ++p) {
       if (skip_overfull && !underfull.empty()) {
@@ -5658,65 +6005,30 @@ int OSDMap::calc_pg_upmaps(
 				  temp_pgs_by_osd, to_unmap, to_upmap))
 	goto test_change;
 
-      // try upmap
-      for (auto pg : pgs) {
-        auto temp_it = tmp_osd_map.pg_upmap.find(pg);
-        if (temp_it != tmp_osd_map.pg_upmap.end()) {
-          // leave pg_upmap alone
-          // it must be specified by admin since balancer does not
-          // support pg_upmap yet
-	  ldout(cct, 10) << " " << pg << " already has pg_upmap "
-                         << temp_it->second << ", skipping"
-                         << dendl;
-	  continue;
-	}
-        auto pg_pool_size = tmp_osd_map.get_pg_pool_size(pg);
-        mempool::osdmap::vector<pair<int32_t,int32_t>> new_upmap_items;
-        set<int> existing;
-        auto it = tmp_osd_map.pg_upmap_items.find(pg);
-        if (it != tmp_osd_map.pg_upmap_items.end()) {
-	  auto& um_items = it->second;
-          if (um_items.size() >= (size_t)pg_pool_size) {
-            ldout(cct, 10) << " " << pg << " already has full-size pg_upmap_items "
-                           << um_items << ", skipping"
-                           << dendl;
+      // try upmap, looking at a few pgs at once when searching in
+      // parallel; the first one (in order) with a usable remap wins
+      for (size_t first = 0; first < pgs.size(); first += search_batch) {
+        size_t n = std::min(search_batch, pgs.size() - first);
+        vector<upmap_candidate_t> found(n);
+        workers.parallel_for(n, [&](size_t i) {
+          find_upmap_candidate(cct, tmp_osd_map, pgs[first + i], overfull,
+                               underfull, more_underfull, osd_deviation,
+                               &found[i]);
+        });
+        for (size_t i = 0; i < n; ++i) {
+          auto& c = found[i];
+          if (c.pos == -1) {
             continue;
-          } else {
-            ldout(cct, 10) << " " << pg << " already has pg_upmap_items "
-                           << um_items
-                           << dendl;
-            new_upmap_items = um_items;
-            // build existing too (for dedup)
-            for (auto [um_from, um_to] : um_items) {
-              existing.insert(um_from);
-              existing.insert(um_to);
-            }
-	  }
-          // fall through
-          // to see if we can append more remapping pairs
-	}
-	ldout(cct, 10) << " trying " << pg << dendl;
-        vector<int> raw, orig, out;
-        tmp_osd_map.pg_to_raw_upmap(pg, &raw, &orig); // including existing upmaps too
-	if (!try_pg_upmap(cct, pg, overfull, underfull, more_underfull, &orig, &out)) {
-	  continue;
-	}
-	ldout(cct, 10) << " " << pg << " " << orig << " -> " << out << dendl;
-	if (orig.size() != out.size()) {
-	  continue;
-	}
-	ceph_assert(orig != out);
-	int pos = find_best_remap(cct, orig, out, existing, osd_deviation);
-	if (pos != -1) {
+          }
           // append new remapping pairs slowly
           // This way we can make sure that each tiny change will
           // definitely make distribution of PGs converging to
           // the perfect status.
-	  add_remap_pair(cct, orig[pos], out[pos], pg, (size_t)pg_pool_size, 
-	  		 osd, existing, temp_pgs_by_osd,
-			 new_upmap_items, to_upmap);
+          add_remap_pair(cct, c.orig[c.pos], c.out[c.pos], pgs[first + i],
+                         (size_t)c.pg_pool_size, osd, c.existing,
+                         temp_pgs_by_osd, c.new_upmap_items, to_upmap);
           goto test_change;
-	}
+        }
       }
       if (fast_aggressive) {
 	if (prev_n_changes == n_changes) {  // no changes for prev OSD
@@ -5782,7 +6094,7 @@ int OSDMap::calc_pg_upmaps(
     float new_stddev = 0;
     map<int,float> temp_osd_deviation;
     multimap<float,int> temp_deviation_osd;
-    float cur_max_deviation = calc_deviations(cct, temp_pgs_by_osd, osd_weight,
+    float cur_max_deviation = calc_deviations(cct, temp_pgs_by_osd.get(), osd_weight,
     					      pgs_per_weight, temp_osd_deviation,
 					      temp_deviation_osd, new_stddev);
     ldout(cct, 10) << " stddev " << stddev << " -> " << new_stddev << dendl;
@@ -5817,7 +6129,7 @@ int OSDMap::calc_pg_upmaps(
     // ready to go
     ceph_assert(new_stddev < stddev);
     stddev = new_stddev;
-    pgs_by_osd = temp_pgs_by_osd;
+    temp_pgs_by_osd.commit();
     osd_deviation = temp_osd_deviation;
     deviation_osd = temp_deviation_osd;
     n_changes++;
@@ -5922,19 +6234,34 @@ float OSDMap::build_pool_pgs_info (
   // and returns the osd_weight_total
   //
   float osds_weight_total = 0.0;
+  // mapping the pgs is what takes time, do the pools in parallel
+  vector<int64_t> pids;
   for (auto& [pid, pdata] : pools) {
     if (!only_pools.empty() && !only_pools.count(pid))
       continue;
-    for (unsigned ps = 0; ps < pdata.get_pg_num(); ++ps) {
+    pids.push_back(pid);
+  }
+  vector<map<int,set<pg_t>>> pool_pgs_by_osd(pids.size());
+  upmap_workers_t workers(std::min<size_t>(get_upmap_threads(cct), pids.size()));
+  workers.parallel_for(pids.size(), [&](size_t i) {
+    int64_t pid = pids[i];
+    for (unsigned ps = 0; ps < pools.at(pid).get_pg_num(); ++ps) {
       pg_t pg(ps, pid);
       vector<int> up;
       tmp_osd_map.pg_to_up_acting_osds(pg, &up, nullptr, nullptr, nullptr);
       ldout(cct, 20) << __func__ << " " << pg << " up " << up << dendl;
       for (auto osd : up) {
         if (osd != CRUSH_ITEM_NONE)
-	  pgs_by_osd[osd].insert(pg);
+	  pool_pgs_by_osd[i][osd].insert(pg);
       }
     }
+  });
+  for (size_t i = 0; i < pids.size(); ++i) {
+    int64_t pid = pids[i];
+    auto& pdata = pools.at(pid);
+    for (auto& [osd, pgs] : pool_pgs_by_osd[i]) {
+      pgs_by_osd[osd].merge(pgs);
+    }
     total_pgs += pdata.get_size() * pdata.get_pg_num();
 
     osds_weight_total = get_osds_weight(cct, tmp_osd_map, pid, osds_weight);
@@ -6092,12 +6419,102 @@ std::default_random_engine OSDMap::get_random_engine(
   return std::default_random_engine{seed};
 }
 
+void OSDMap::find_upmap_candidate(
+  CephContext *cct,
+  const OSDMap& tmp_osd_map,
+  pg_t pg,
+  const set<int>& overfull,
+  const vector<int>& underfull,
+  const vector<int>& more_underfull,
+  const map<int,float>& osd_deviation,
+  upmap_candidate_t *c)
+{
+  //
+  // Check whether pg can be moved off the overfull osds, and how. This only
+  // reads the maps, so that several candidates can be looked at in parallel.
+  //
+  auto temp_it = tmp_osd_map.pg_upmap.find(pg);
+  if (temp_it != tmp_osd_map.pg_upmap.end()) {
+    // leave pg_upmap alone
+    // it must be specified by admin since balancer does not
+    // support pg_upmap yet
+    ldout(cct, 10) << " " << pg << " already has pg_upmap "
+                   << temp_it->second << ", skipping"
+                   << dendl;
+    return;
+  }
+  c->pg_pool_size = tmp_osd_map.get_pg_pool_size(pg);
+  auto it = tmp_osd_map.pg_upmap_items.find(pg);
+  if (it != tmp_osd_map.pg_upmap_items.end()) {
+    auto& um_items = it->second;
+    if (um_items.size() >= (size_t)c->pg_pool_size) {
+      ldout(cct, 10) << " " << pg << " already has full-size pg_upmap_items "
+                     << um_items << ", skipping"
+                     << dendl;
+      return;
+    } else {
+      ldout(cct, 10) << " " << pg << " already has pg_upmap_items "
+                     << um_items
+                     << dendl;
+      c->new_upmap_items = um_items;
+      // build existing too (for dedup)
+      for (auto [um_from, um_to] : um_items) {
+        c->existing.insert(um_from);
+        c->existing.insert(um_to);
+      }
+    }
+    // fall through
+    // to see if we can append more remapping pairs
+  }
+  ldout(cct, 10) << " trying " << pg << dendl;
+  vector<int> raw;
+  tmp_osd_map.pg_to_raw_upmap(pg, &raw, &c->orig); // including existing upmaps too
+  if (!try_pg_upmap(cct, pg, overfull, underfull, more_underfull,
+                    &c->orig, &c->out)) {
+    return;
+  }
+  ldout(cct, 10) << " " << pg << " " << c->orig << " -> " << c->out << dendl;
+  if (c->orig.size() != c->out.size()) {
+    return;
+  }
+  ceph_assert(c->orig != c->out);
+  c->pos = find_best_remap(cct, c->orig, c->out, c->existing, osd_deviation);
+}
+
+set<pg_t>& OSDMap::pgs_by_osd_txn_t::operator[](int osd)
+{
+  auto p = pgs_by_osd.find(osd);
+  if (!saved.count(osd)) {
+    if (p == pgs_by_osd.end()) {
+      saved.emplace(osd, std::nullopt);
+    } else {
+      saved.emplace(osd, p->second);
+    }
+  }
+  if (p == pgs_by_osd.end()) {
+    p = pgs_by_osd.emplace(osd, set<pg_t>()).first;
+  }
+  return p->second;
+}
+
+void OSDMap::pgs_by_osd_txn_t::rollback()
+{
+  for (auto& [osd, pgs] : saved) {
+    if (pgs) {
+      pgs_by_osd[osd] = std::move(*pgs);
+    } else {
+      pgs_by_osd.erase(osd);
+    }
+  }
+  saved.clear();
+}
+
 bool OSDMap::try_drop_remap_overfull(
   CephContext *cct,
   const std::vector<pg_t>& pgs,
   const OSDMap& tmp_osd_map,
   int osd,
-  map<int,std::set<pg_t>>& temp_pgs_by_osd,
+  pgs_by_osd_txn_t& temp_pgs_by_osd,
   set<pg_t>& to_unmap,
   map<pg_t, mempool::osdmap::vector<pair<int32_t,int32_t>>>& to_upmap)
 {
@@ -6154,7 +6571,7 @@ bool OSDMap::try_drop_remap_underfull(
     CephContext *cct,
     const candidates_t& candidates,
     int osd,
-    map<int,std::set<pg_t>>& temp_pgs_by_osd,
+    pgs_by_osd_txn_t& temp_pgs_by_osd,
     set<pg_t>& to_unmap,
     map<pg_t, mempool::osdmap::vector<std::pair<int32_t,int32_t>>>& to_upmap)
 {
@@ -6213,7 +6630,7 @@ void OSDMap::add_remap_pair(
   size_t pg_pool_size,
   int osd,
   set<int>& existing,
-  map<int,set<pg_t>>& temp_pgs_by_osd,
+  pgs_by_osd_txn_t& temp_pgs_by_osd,
   mempool::osdmap::vector<pair<int32_t,int32_t>> new_upmap_items,
   map<pg_t, mempool::osdmap::vector<pair<int32_t,int32_t>>>& to_upmap) 
 {
@@ -6244,7 +6661,7 @@ int OSDMap::find_best_remap (
   const vector<int>& orig,
   const vector<int>& out,
   const set<int>& existing,
-  const map<int,float> osd_deviation) 
+  const map<int,float>& osd_deviation)
 {
   //
   // Find the best remap from the suggestions in orig and out - the best remap 
@@ -6270,7 +6687,7 @@ int OSDMap::find_best_remap (
 OSDMap::candidates_t OSDMap::build_candidates(
   CephContext *cct,
   const OSDMap& tmp_osd_map,
-  const set<pg_t> to_skip,
+  const set<pg_t>& to_skip,
   const set<int64_t>& only_pools,
   bool aggressive,
   std::random_device::result_type *p_seed)
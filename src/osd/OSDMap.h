@@ -29,6 +29,7 @@
 #include <set>
 #include <map>
 #include <memory>
+#include <optional>
 
 #include <boost/smart_ptr/local_shared_ptr.hpp>
 #include "include/btree_map.h"
@@ -366,6 +367,7 @@ public:
     uint64_t encode_features;
     uuid_d fsid;
     epoch_t epoch;   // new epoch; we are a diff from epoch-1 to epoch
+    epoch_t base_epoch = 0;  // squashed; a diff from base_epoch to epoch
     utime_t modified;
     int64_t new_pool_max; //incremented by the OSDMonitor on each pool create
     int32_t new_flags;
@@ -532,6 +534,23 @@ public:
     }
 
     void set_allow_crimson() { mutate_allow_crimson = mutate_allow_crimson_t::SET; }
+
+    /// the epoch of the map we apply to
+    epoch_t get_base_epoch() const {
+      return base_epoch ? base_epoch : epoch - 1;
+    }
+    /**
+     * fold the incremental that follows us into this one
+     *
+     * Afterwards we take the map at get_base_epoch() straight to
+     * next.epoch.  The result is only good for clients: osd-only details
+     * like up_from or down_at end up stamped with the last epoch, and the
+     * crcs no longer describe what we turn the map into.
+     *
+     * @return false if the two can not be folded, in which case we are
+     *         left untouched
+     */
+    bool squash(const Incremental& next);
   };
   
 private:
@@ -1533,6 +1552,29 @@ public:
 
 private: // Bunch of internal functions used only by calc_pg_upmaps (result of code refactoring)
 
+  /// pgs_by_osd of calc_pg_upmaps, remembering the previous state of the
+  /// osds changed since the last commit(), so that a change which does not
+  /// improve the distribution is rolled back instead of having to start
+  /// every attempt from a copy of the whole map
+  class pgs_by_osd_txn_t {
+    std::map<int,std::set<pg_t>>& pgs_by_osd;
+    std::map<int,std::optional<std::set<pg_t>>> saved;
+  public:
+    explicit pgs_by_osd_txn_t(std::map<int,std::set<pg_t>>& pgs_by_osd)
+      : pgs_by_osd(pgs_by_osd) {}
+    ~pgs_by_osd_txn_t() {
+      rollback();
+    }
+    std::set<pg_t>& operator[](int osd);
+    const std::map<int,std::set<pg_t>>& get() const {
+      return pgs_by_osd;
+    }
+    void commit() {
+      saved.clear();
+    }
+    void rollback();
+  };
+
   float get_osds_weight(
     CephContext *cct,
     const OSDMap& tmp_osd_map,
@@ -1587,7 +1629,7 @@ private: // Bunch of internal functions used only by calc_pg_upmaps (result of c
     const std::vector<pg_t>& pgs,
     const OSDMap& tmp_osd_map,
     int osd,
-    std::map<int,std::set<pg_t>>& temp_pgs_by_osd,
+    pgs_by_osd_txn_t& temp_pgs_by_osd,
     std::set<pg_t>& to_unmap,
     std::map<pg_t, mempool::osdmap::vector<std::pair<int32_t,int32_t>>>& to_upmap
   );
@@ -1599,7 +1641,7 @@ bool try_drop_remap_underfull(
     CephContext *cct,
     const candidates_t& candidates,
     int osd,
-    std::map<int,std::set<pg_t>>& temp_pgs_by_osd,
+    pgs_by_osd_txn_t& temp_pgs_by_osd,
     std::set<pg_t>& to_unmap,
     std::map<pg_t, mempool::osdmap::vector<std::pair<int32_t,int32_t>>>& to_upmap
   );
@@ -1612,23 +1654,42 @@ bool try_drop_remap_underfull(
     size_t pg_pool_size,
     int osd,
     std::set<int>& existing,
-    std::map<int,std::set<pg_t>>& temp_pgs_by_osd,
+    pgs_by_osd_txn_t& temp_pgs_by_osd,
     mempool::osdmap::vector<std::pair<int32_t,int32_t>> new_upmap_items,
     std::map<pg_t, mempool::osdmap::vector<std::pair<int32_t,int32_t>>>& to_upmap
   );
 
+  struct upmap_candidate_t {
+    int pos = -1;  ///< position in orig/out of the remap to add, -1 if none
+    int pg_pool_size = 0;
+    std::vector<int> orig, out;
+    std::set<int> existing;
+    mempool::osdmap::vector<std::pair<int32_t,int32_t>> new_upmap_items;
+  };
+
+  void find_upmap_candidate(
+    CephContext *cct,
+    const OSDMap& tmp_osd_map,
+    pg_t pg,
+    const std::set<int>& overfull,
+    const std::vector<int>& underfull,
+    const std::vector<int>& more_underfull,
+    const std::map<int,float>& osd_deviation,
+    upmap_candidate_t *c
+  );
+
   int find_best_remap (
     CephContext *cct,
     const std::vector<int>& orig,
     const std::vector<int>& out,
     const std::set<int>& existing,
-    const std::map<int,float> osd_deviation
+    const std::map<int,float>& osd_deviation
   );
 
   candidates_t build_candidates(
     CephContext *cct,
     const OSDMap& tmp_osd_map,
-    const std::set<pg_t> to_skip,
+    const std::set<pg_t>& to_skip,
     const std::set<int64_t>& only_pools,
     bool aggressive,
     std::random_device::result_type *p_seed
@@ -166,7 +166,7 @@ void ParallelPGMapper::queue(
   unsigned pgs_per_item,
   const vector<pg_t>& input_pgs)
 {
-  bool any = false;
+  vector<Item*> items;
   if (!input_pgs.empty()) {
     unsigned i = 0;
     vector<pg_t> item_pgs;
@@ -177,31 +177,32 @@ void ParallelPGMapper::queue(
         item_pgs.push_back(pg);
       }
       if (i >= pgs_per_item) {
-        job->start_one();
-        wq.queue(new Item(job, item_pgs));
+        items.push_back(new Item(job, item_pgs));
         i = 0;
         item_pgs.clear();
-        any = true;
       }
     }
     if (!item_pgs.empty()) {
-      job->start_one();
-      wq.queue(new Item(job, item_pgs));
-      any = true;
+      items.push_back(new Item(job, item_pgs));
     }
-    ceph_assert(any);
-    return;
-  }
-  // no input pgs, load all from map
-  for (auto& p : job->osdmap->get_pools()) {
-    for (unsigned ps = 0; ps < p.second.get_pg_num(); ps += pgs_per_item) {
-      unsigned ps_end = std::min(ps + pgs_per_item, p.second.get_pg_num());
-      job->start_one();
-      wq.queue(new Item(job, p.first, ps, ps_end));
-      ldout(cct, 20) << __func__ << " " << job << " " << p.first << " [" << ps
-		     << "," << ps_end << ")" << dendl;
-      any = true;
+  } else {
+    // no input pgs, load all from map
+    for (auto& p : job->osdmap->get_pools()) {
+      for (unsigned ps = 0; ps < p.second.get_pg_num(); ps += pgs_per_item) {
+        unsigned ps_end = std::min(ps + pgs_per_item, p.second.get_pg_num());
+        items.push_back(new Item(job, p.first, ps, ps_end));
+        ldout(cct, 20) << __func__ << " " << job << " " << p.first << " [" << ps
+		       << "," << ps_end << ")" << dendl;
+      }
     }
   }
-  ceph_assert(any);
+  ceph_assert(!items.empty());
+  // account for every item before queueing any, or the job could
+  // complete once the first ones are processed
+  for (size_t n = 0; n < items.size(); ++n) {
+    job->start_one();
+  }
+  for (auto i : items) {
+    wq.queue(i);
+  }
 }
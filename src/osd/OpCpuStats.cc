@@ -0,0 +1,111 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "OpCpuStats.h"
+
+#include <atomic>
+#include <time.h>
+
+#include "include/rados.h"
+
+uint64_t OpCpuStats::thread_cpu_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t OpCpuStats::next_id()
+{
+  static std::atomic<uint64_t> last_id = 0;
+  return ++last_id;
+}
+
+OpCpuStats::thread_counters_t& OpCpuStats::_my_counters()
+{
+  thread_local uint64_t my_id = 0;
+  thread_local thread_counters_t *my_counters = nullptr;
+  if (my_id != id) {
+    std::lock_guard l{lock};
+    threads.push_back(std::make_unique<thread_counters_t>());
+    my_counters = threads.back().get();
+    my_id = id;
+  }
+  return *my_counters;
+}
+
+void OpCpuStats::add_op(int op, uint64_t ns)
+{
+  auto& c = _my_counters();
+  std::lock_guard l{c.lock};
+  auto& counter = c.ops[op];
+  counter.count++;
+  counter.ns += ns;
+}
+
+void OpCpuStats::add_call(std::string_view cls, std::string_view method,
+			  uint64_t ns)
+{
+  std::string name;
+  name.reserve(cls.size() + method.size() + 1);
+  name.append(cls).append(".").append(method);
+  auto& c = _my_counters();
+  std::lock_guard l{c.lock};
+  auto p = c.calls.find(name);
+  if (p == c.calls.end()) {
+    p = c.calls.emplace(std::move(name), counter_t{}).first;
+  }
+  p->second.count++;
+  p->second.ns += ns;
+}
+
+void OpCpuStats::dump(ceph::Formatter *f)
+{
+  std::map<int, counter_t> ops;
+  std::map<std::string, counter_t, std::less<>> calls;
+  {
+    std::lock_guard l{lock};
+    for (auto& t : threads) {
+      std::lock_guard tl{t->lock};
+      for (auto& [op, c] : t->ops) {
+	ops[op].count += c.count;
+	ops[op].ns += c.ns;
+      }
+      for (auto& [name, c] : t->calls) {
+	calls[name].count += c.count;
+	calls[name].ns += c.ns;
+      }
+    }
+  }
+  auto dump_counter = [f](const counter_t& c) {
+    f->dump_unsigned("count", c.count);
+    f->dump_unsigned("cpu_ns", c.ns);
+    f->dump_unsigned("avg_cpu_ns", c.count ? c.ns / c.count : 0);
+  };
+  f->open_array_section("ops");
+  for (auto& [op, c] : ops) {
+    f->open_object_section("op");
+    f->dump_string("op", ceph_osd_op_name(op));
+    dump_counter(c);
+    f->close_section();
+  }
+  f->close_section();
+  f->open_array_section("calls");
+  for (auto& [name, c] : calls) {
+    f->open_object_section("call");
+    f->dump_string("method", name);
+    dump_counter(c);
+    f->close_section();
+  }
+  f->close_section();
+}
+
+void OpCpuStats::reset()
+{
+  std::lock_guard l{lock};
+  for (auto& t : threads) {
+    std::lock_guard tl{t->lock};
+    t->ops.clear();
+    t->calls.clear();
+  }
+}
@@ -0,0 +1,70 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/ceph_mutex.h"
+#include "common/Formatter.h"
+
+/**
+ * CPU time spent on each OSD op type and on each cls method
+ *
+ * The threads handling ops each add to counters of their own, so that
+ * the accounting does not add a shared cache line to the op path; the
+ * counters are only summed up when dumped.
+ */
+class OpCpuStats {
+public:
+  struct counter_t {
+    uint64_t count = 0;
+    uint64_t ns = 0;
+  };
+
+  /// cpu time consumed by the calling thread so far
+  static uint64_t thread_cpu_ns();
+
+  void add_op(int op, uint64_t ns);
+  void add_call(std::string_view cls, std::string_view method, uint64_t ns);
+
+  void dump(ceph::Formatter *f);
+  void reset();
+
+  /// adds the cpu time the calling thread spends until its destruction
+  /// to op, does nothing without stats
+  class OpTimer {
+    OpCpuStats *stats;
+    int op;
+    uint64_t start;
+  public:
+    OpTimer(OpCpuStats *stats, int op)
+      : stats(stats), op(op), start(stats ? thread_cpu_ns() : 0) {}
+    ~OpTimer() {
+      if (stats) {
+	stats->add_op(op, thread_cpu_ns() - start);
+      }
+    }
+  };
+
+private:
+  struct thread_counters_t {
+    ceph::mutex lock = ceph::make_mutex("OpCpuStats::thread_counters_t::lock");
+    std::map<int, counter_t> ops;
+    std::map<std::string, counter_t, std::less<>> calls;
+  };
+
+  /// tells apart instances living at the same address
+  const uint64_t id = next_id();
+  ceph::mutex lock = ceph::make_mutex("OpCpuStats::lock");
+  // not released before ~OpCpuStats, as exited threads still account
+  std::vector<std::unique_ptr<thread_counters_t>> threads;
+
+  static uint64_t next_id();
+  thread_counters_t& _my_counters();
+};
@@ -189,6 +189,7 @@ void PGLog::clear() {
   log.clear();
   log_keys_debug.clear();
   undirty();
+  forget_written_rollback_info();
 }
 
 void PGLog::clear_info_log(
@@ -661,6 +662,8 @@ void PGLog::write_log_and_missing(
       dirty_from_dups,
       write_from_dups,
       &may_include_deletes_in_missing_dirty,
+      &written_can_rollback_to,
+      &written_rollback_info_trimmed_to,
       (pg_log_debug ? &log_keys_debug : nullptr),
       this);
     undirty();
@@ -711,7 +714,7 @@ void PGLog::write_log_and_missing(
     eversion_t::max(),
     eversion_t(),
     eversion_t(),
-    may_include_deletes_in_missing_dirty, nullptr, dpp);
+    may_include_deletes_in_missing_dirty, nullptr, nullptr, nullptr, dpp);
 }
 
 // static
@@ -864,6 +867,8 @@ void PGLog::_write_log_and_missing(
   eversion_t dirty_from_dups,
   eversion_t write_from_dups,
   bool *may_include_deletes_in_missing_dirty, // in/out param
+  eversion_t *written_can_rollback_to, // in/out param, may be null
+  eversion_t *written_rollback_info_trimmed_to, // in/out param, may be null
   set<string> *log_keys_debug,
   const DoutPrefixProvider *dpp
   ) {
@@ -1000,12 +1005,24 @@ void PGLog::_write_log_and_missing(
       }
     });
   if (require_rollback) {
-    encode(
-      log.get_can_rollback_to(),
-      (*km)["can_rollback_to"]);
-    encode(
-      log.get_rollback_info_trimmed_to(),
-      (*km)["rollback_info_trimmed_to"]);
+    // both bounds only move on some ops (trim, roll forward), do not
+    // queue them again if they still match what is on disk
+    if (!written_can_rollback_to ||
+	*written_can_rollback_to != log.get_can_rollback_to()) {
+      encode(
+	log.get_can_rollback_to(),
+	(*km)["can_rollback_to"]);
+      if (written_can_rollback_to)
+	*written_can_rollback_to = log.get_can_rollback_to();
+    }
+    if (!written_rollback_info_trimmed_to ||
+	*written_rollback_info_trimmed_to != log.get_rollback_info_trimmed_to()) {
+      encode(
+	log.get_rollback_info_trimmed_to(),
+	(*km)["rollback_info_trimmed_to"]);
+      if (written_rollback_info_trimmed_to)
+	*written_rollback_info_trimmed_to = log.get_rollback_info_trimmed_to();
+    }
   }
 
   if (!to_remove.empty())
@@ -146,7 +146,19 @@ public:
    * plus some methods to manipulate it all.
    */
   struct IndexedLog : public pg_log_t {
-    mutable ceph::unordered_map<hobject_t,pg_log_entry_t*> objects;  // ptrs into log.  be careful!
+    // the keys of objects refer to the soid of the entry they map to,
+    // rather than holding a copy of the object name for every object in
+    // the log
+    struct soid_ref_hash {
+      size_t operator()(const hobject_t& soid) const {
+	return std::hash<hobject_t>()(soid);
+      }
+    };
+    using objects_t = ceph::unordered_map<std::reference_wrapper<const hobject_t>,
+					  pg_log_entry_t*,
+					  soid_ref_hash,
+					  std::equal_to<hobject_t>>;
+    mutable objects_t objects;  // ptrs into log.  be careful!
     mutable ceph::unordered_map<osd_reqid_t,pg_log_entry_t*> caller_ops;
     mutable ceph::unordered_multimap<osd_reqid_t,pg_log_entry_t*> extra_caller_ops;
     mutable ceph::unordered_map<osd_reqid_t,pg_log_dup_t*> dup_index;
@@ -444,6 +456,20 @@ public:
       }
     }
 
+    /// map e->soid to e, keyed by e's soid
+    void index_object(pg_log_entry_t* e) const {
+      // re-key a present entry: its key may belong to an entry about to be
+      // trimmed
+      auto node = objects.extract(e->soid);
+      if (node) {
+	node.key() = std::cref(e->soid);
+	node.mapped() = e;
+	objects.insert(std::move(node));
+      } else {
+	objects.emplace(std::cref(e->soid), e);
+      }
+    }
+
     void index(__u16 to_index = PGLOG_INDEXED_ALL) const {
       // if to_index is 0, no need to run any of this code, especially
       // loop below; this can happen with copy constructor for
@@ -472,7 +498,7 @@ public:
 	for (auto i = log.begin(); i != log.end(); ++i) {
 	  if (to_index & PGLOG_INDEXED_OBJECTS) {
 	    if (i->object_is_indexed()) {
-	      objects[i->soid] = const_cast<pg_log_entry_t*>(&(*i));
+	      index_object(const_cast<pg_log_entry_t*>(&(*i)));
 	    }
 	  }
 
@@ -514,9 +540,9 @@ public:
 
     void index(pg_log_entry_t& e) {
       if ((indexed_data & PGLOG_INDEXED_OBJECTS) && e.object_is_indexed()) {
-        if (objects.count(e.soid) == 0 ||
-            objects[e.soid]->version < e.version)
-          objects[e.soid] = &e;
+        auto it = objects.find(e.soid);
+        if (it == objects.end() || it->second->version < e.version)
+          index_object(&e);
       }
       if (indexed_data & PGLOG_INDEXED_CALLER_OPS) {
 	// divergent merge_log indexes new before unindexing old
@@ -609,7 +635,7 @@ public:
 
       // to our index
       if ((indexed_data & PGLOG_INDEXED_OBJECTS) && e.object_is_indexed()) {
-        objects[e.soid] = &(log.back());
+        index_object(&(log.back()));
       }
       if (indexed_data & PGLOG_INDEXED_CALLER_OPS) {
         if (e.reqid_is_indexed()) {
@@ -662,6 +688,14 @@ protected:
   bool dirty_log;
   bool clear_divergent_priors;
   bool may_include_deletes_in_missing_dirty = false;
+  /// rollback bounds last queued for the log object, max if unknown
+  eversion_t written_can_rollback_to = eversion_t::max();
+  eversion_t written_rollback_info_trimmed_to = eversion_t::max();
+
+  void forget_written_rollback_info() {
+    written_can_rollback_to = eversion_t::max();
+    written_rollback_info_trimmed_to = eversion_t::max();
+  }
 
   void mark_dirty_to(eversion_t to) {
     if (to > dirty_to)
@@ -707,6 +741,7 @@ public:
     mark_dirty_from(eversion_t());
     mark_dirty_to_dups(eversion_t::max());
     mark_dirty_from_dups(eversion_t());
+    forget_written_rollback_info();
     touched_log = false;
   }
   bool get_may_include_deletes_in_missing_dirty() const {
@@ -1392,6 +1427,8 @@ public:
     eversion_t dirty_from_dups,
     eversion_t write_from_dups,
     bool *may_include_deletes_in_missing_dirty,
+    eversion_t *written_can_rollback_to,
+    eversion_t *written_rollback_info_trimmed_to,
     std::set<std::string> *log_keys_debug,
     const DoutPrefixProvider *dpp = nullptr
     );
@@ -2290,6 +2290,64 @@ void PeeringState::choose_async_recovery_replicated(
 	     << " async_recovery=" << *async_recovery << dendl;
 }
 
+/*
+ * Log based recovery tracks every missing object of a shard in memory
+ * (pg_missing_t, and MissingLoc on the primary), which can take more than
+ * the OSD has to spare after a long outage. Backfill instead scans the
+ * objects of the PG a chunk at a time, so a shard past
+ * osd_log_recovery_max_missing_objects is backfilled as long as the PG
+ * keeps min_size without it.
+ */
+void PeeringState::choose_backfill_for_missing_replicated(
+  const map<pg_shard_t, pg_info_t> &all_info,
+  const pg_info_t &auth_info,
+  vector<int> *want,
+  set<pg_shard_t> *backfill) const
+{
+  auto max_missing = cct->_conf.get_val<uint64_t>(
+    "osd_log_recovery_max_missing_objects");
+  if (max_missing == 0) {
+    return;
+  }
+  set<pair<int64_t, pg_shard_t>> candidates_by_missing;
+  // the primary stays, it is the one doing the backfill
+  for (auto it = want->begin() + 1; it != want->end(); ++it) {
+    pg_shard_t shard_i(*it, shard_id_t::NO_SHARD);
+    // as for async recovery, only an up osd stays in acting_recovery_backfill
+    // once out of the acting set
+    if (!is_up(shard_i))
+      continue;
+    auto& shard_info = all_info.find(shard_i)->second;
+    // the same estimate the async recovery cost uses
+    version_t auth_version = auth_info.last_update.version;
+    version_t candidate_version = shard_info.last_update.version;
+    int64_t approx_missing_objects =
+      shard_info.stats.stats.sum.num_objects_missing;
+    if (auth_version > candidate_version) {
+      approx_missing_objects += auth_version - candidate_version;
+    } else {
+      approx_missing_objects += candidate_version - auth_version;
+    }
+    if (static_cast<uint64_t>(approx_missing_objects) > max_missing) {
+      candidates_by_missing.emplace(approx_missing_objects, shard_i);
+    }
+  }
+
+  psdout(20) << "candidates by missing objects are: " << candidates_by_missing
+	     << dendl;
+  for (auto rit = candidates_by_missing.rbegin();
+       rit != candidates_by_missing.rend(); ++rit) {
+    if (want->size() <= pool.info.min_size) {
+      break;
+    }
+    auto cur_shard = rit->second;
+    want->erase(std::find(want->begin(), want->end(), cur_shard.osd));
+    backfill->insert(cur_shard);
+    psdout(10) << "backfilling " << cur_shard << " with approximately "
+	       << rit->first << " missing objects" << dendl;
+  }
+}
+
 /**
  * choose acting
  *
@@ -2385,6 +2443,8 @@ bool PeeringState::choose_acting(pg_shard_t &auth_log_shard_id,
 	get_osdmap(),
 	pool,
 	ss);
+      choose_backfill_for_missing_replicated(
+	all_info, primary_shard->second, &want, &want_backfill);
     }
   } else {
     calc_ec_acting(
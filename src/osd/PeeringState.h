@@ -1693,6 +1693,11 @@ private:
     std::vector<int> *want,
     std::set<pg_shard_t> *async_recovery,
     const OSDMapRef osdmap) const;
+  void choose_backfill_for_missing_replicated(
+    const std::map<pg_shard_t, pg_info_t> &all_info,
+    const pg_info_t &auth_info,
+    std::vector<int> *want,
+    std::set<pg_shard_t> *backfill) const;
 
   bool recoverable(const std::vector<int> &want) const;
   bool choose_acting(pg_shard_t &auth_log_shard,
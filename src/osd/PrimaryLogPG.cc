@@ -805,7 +805,7 @@ void PrimaryLogPG::maybe_force_recovery()
 	!it_missing->second.get_rmissing().empty()) {
       const auto& min_obj = recovery_state.get_peer_missing(peer).get_rmissing().begin();
       dout(20) << __func__ << " peer " << peer << " min_version " << min_obj->first
-               << " oid " << min_obj->second << dendl;
+               << " oid " << min_obj->second.get() << dendl;
       if (min_version > min_obj->first) {
         min_version = min_obj->first;
         soid = min_obj->second;
@@ -3532,12 +3532,12 @@ void PrimaryLogPG::dec_refcount(const hobject_t& soid, const object_ref_delta_t&
   for (auto p = refs.begin(); p != refs.end(); ++p) {
     int dec_ref_count = p->second;
     ceph_assert(dec_ref_count < 0);
-    while (dec_ref_count < 0) {
-      dout(10) << __func__ << ": decrement reference on offset oid: " << p->first << dendl;
-      refcount_manifest(soid, p->first, 
-			refcount_t::DECREMENT_REF, NULL, std::nullopt);
-      dec_ref_count++;
-    }
+    dout(10) << __func__ << ": decrement reference on offset oid: " << p->first
+	     << " by " << -dec_ref_count << dendl;
+    // one op for all the references this chunk loses
+    refcount_manifest(soid, p->first,
+		      refcount_t::DECREMENT_REF, NULL, std::nullopt,
+		      -dec_ref_count);
   }
 }
 
@@ -3711,7 +3711,8 @@ void PrimaryLogPG::dec_all_refcount_manifest(const object_info_t& oi, OpContext*
 }
 
 ceph_tid_t PrimaryLogPG::refcount_manifest(hobject_t src_soid, hobject_t tgt_soid, refcount_t type,
-                                     Context *cb, std::optional<bufferlist> chunk)
+                                     Context *cb, std::optional<bufferlist> chunk,
+                                     unsigned count)
 {
   unsigned flags = CEPH_OSD_FLAG_IGNORE_CACHE | CEPH_OSD_FLAG_IGNORE_OVERLAY |
                    CEPH_OSD_FLAG_RWORDERED;
@@ -3730,7 +3731,14 @@ ceph_tid_t PrimaryLogPG::refcount_manifest(hobject_t src_soid, hobject_t tgt_soi
     cls_cas_chunk_put_ref_op call;
     call.source = src_soid.get_head();
     ::encode(call, in);
-    obj_op.call("cas", "chunk_put_ref", in);
+    for (unsigned i = 0; i < count; ++i) {
+      obj_op.call("cas", "chunk_put_ref", in);
+      if (count > 1) {
+	// like separate ops would: the chunk may be gone after the last
+	// reference, but that must not undo the puts before it
+	obj_op.set_last_op_flags(CEPH_OSD_OP_FLAG_FAILOK);
+      }
+    }
   } else if (type == refcount_t::CREATE_OR_GET_REF) {
     cls_cas_chunk_create_or_get_ref_op get_call;
     get_call.source = src_soid.get_head();
@@ -3741,6 +3749,7 @@ ceph_tid_t PrimaryLogPG::refcount_manifest(hobject_t src_soid, hobject_t tgt_soi
   } else {
     ceph_assert(0 == "unrecognized type");
   }
+  ceph_assert(count == 1 || type == refcount_t::DECREMENT_REF);
 
   Context *c = nullptr;
   if (cb) {
@@ -4371,6 +4380,20 @@ void PrimaryLogPG::log_op_stats(const OpRequest& op,
   osd->logger->inc(l_osd_op_inb, inb);
   osd->logger->tinc(l_osd_op_lat, latency);
   osd->logger->tinc(l_osd_op_process_lat, process_latency);
+  // an op requeued while it was being processed has no meaningful queue wait
+  if (op.get_queued_time() != utime_t() &&
+      op.get_dequeued_time() >= op.get_queued_time()) {
+    const utime_t before_queue_latency =
+      op.get_queued_time() - m->get_recv_stamp();
+    const utime_t queue_wait_latency =
+      op.get_dequeued_time() - op.get_queued_time();
+    osd->logger->hinc(l_osd_op_before_queue_lat_bytes_hist,
+		      before_queue_latency.to_nsec(), inb + outb);
+    osd->logger->hinc(l_osd_op_queue_wait_lat_bytes_hist,
+		      queue_wait_latency.to_nsec(), inb + outb);
+  }
+  osd->logger->hinc(l_osd_op_process_lat_bytes_hist,
+		    process_latency.to_nsec(), inb + outb);
 
   if (op.may_read() && op.may_write()) {
     osd->logger->inc(l_osd_op_rw);
@@ -5755,6 +5778,22 @@ int PrimaryLogPG::finish_extent_cmp(OSDOp& osd_op, const bufferlist &read_bl)
   return 0;
 }
 
+bool PrimaryLogPG::is_data_cacheable(const OpContext *ctx,
+				     const OSDOp& osd_op) const
+{
+  // whole small objects of replicated pools, and only if nothing in this
+  // op has modified them already
+  const auto& op = osd_op.op;
+  const auto& oi = ctx->new_obs.oi;
+  return ctx->obc &&
+    cct->_conf->osd_obc_data_cache_max_object_size > 0 &&
+    !pool.info.is_erasure() &&
+    op.extent.offset == 0 &&
+    op.extent.length == oi.size &&
+    oi.size <= cct->_conf->osd_obc_data_cache_max_object_size &&
+    ctx->op_t->empty();
+}
+
 int PrimaryLogPG::do_read(OpContext *ctx, OSDOp& osd_op) {
   dout(20) << __func__ << dendl;
   auto& op = osd_op.op;
@@ -5794,6 +5833,12 @@ int PrimaryLogPG::do_read(OpContext *ctx, OSDOp& osd_op) {
     // read size was trimmed to zero and it is expected to do nothing
     // a read operation of 0 bytes does *not* do nothing, this is why
     // the trimmed_read boolean is needed
+  } else if (is_data_cacheable(ctx, osd_op) &&
+	     ctx->obc->has_data_cache()) {
+    osd_op.outdata.append(ctx->obc->data_cache);
+    osd->logger->inc(l_osd_op_r_data_cache_hit);
+    dout(10) << " read got " << op.extent.length
+	     << " bytes from the data cache of obj " << soid << dendl;
   } else if (pool.info.is_erasure()) {
     // The initialisation below is required to silence a false positive
     // -Wmaybe-uninitialized warning
@@ -5833,9 +5878,15 @@ int PrimaryLogPG::do_read(OpContext *ctx, OSDOp& osd_op) {
     if (r == -EIO) {
       r = rep_repair_primary_object(soid, ctx);
     }
-    if (r >= 0)
+    if (r >= 0) {
+      if ((uint64_t)r == oi.size &&
+	  !(op.flags & (CEPH_OSD_OP_FLAG_FADVISE_DONTNEED |
+			CEPH_OSD_OP_FLAG_FADVISE_NOCACHE)) &&
+	  is_data_cacheable(ctx, osd_op)) {
+	ctx->obc->set_data_cache(osd_op.outdata);
+      }
       op.extent.length = r;
-    else if (r == -EAGAIN) {
+    } else if (r == -EAGAIN) {
       result = -EAGAIN;
     } else {
       result = r;
@@ -5956,6 +6007,7 @@ int PrimaryLogPG::do_osd_ops(OpContext *ctx, vector<OSDOp>& ops)
     osd->osd_skip_data_digest;
 
   PGTransaction* t = ctx->op_t.get();
+  OpCpuStats* cpu_stats = osd->get_op_cpu_stats();
 
   dout(10) << "do_osd_op " << soid << " " << ops << dendl;
 
@@ -5963,6 +6015,7 @@ int PrimaryLogPG::do_osd_ops(OpContext *ctx, vector<OSDOp>& ops)
   for (auto p = ops.begin(); p != ops.end(); ++p, ctx->current_osd_subop_num++, ctx->processed_subop_count++) {
     OSDOp& osd_op = *p;
     ceph_osd_op& op = osd_op.op;
+    OpCpuStats::OpTimer op_cpu_timer(cpu_stats, op.op);
 
     OpFinisher* op_finisher = nullptr;
     {
@@ -6160,7 +6213,12 @@ int PrimaryLogPG::do_osd_ops(OpContext *ctx, vector<OSDOp>& ops)
 	dout(10) << "call method " << cname << "." << mname << dendl;
 	int prev_rd = ctx->num_read;
 	int prev_wr = ctx->num_write;
+	uint64_t call_start = cpu_stats ? OpCpuStats::thread_cpu_ns() : 0;
 	result = method->exec((cls_method_context_t)&ctx, indata, outdata);
+	if (cpu_stats) {
+	  cpu_stats->add_call(cname, mname,
+			      OpCpuStats::thread_cpu_ns() - call_start);
+	}
 
 	if (ctx->num_read > prev_rd && !(flags & CLS_METHOD_RD)) {
 	  derr << "method " << cname << "." << mname << " tried to read object but is not marked RD" << dendl;
@@ -8806,13 +8864,21 @@ void PrimaryLogPG::do_osd_op_effects(OpContext *ctx, const ConnectionRef& conn)
       dout(10) << "notify_ack " << make_pair(*(p->watch_cookie), p->notify_id) << dendl;
     else
       dout(10) << "notify_ack " << make_pair("NULL", p->notify_id) << dendl;
+    if (p->watch_cookie) {
+      // the ack names its watch: look it up rather than walk every
+      // watcher of the object for each ack of a notify
+      auto i = ctx->obc->watchers.find(make_pair(*(p->watch_cookie), entity));
+      if (i != ctx->obc->watchers.end()) {
+	dout(10) << "acking notify on watch " << i->first << dendl;
+	i->second->notify_ack(p->notify_id, p->reply_bl);
+      }
+      continue;
+    }
     for (map<pair<uint64_t, entity_name_t>, WatchRef>::iterator i =
 	   ctx->obc->watchers.begin();
 	 i != ctx->obc->watchers.end();
 	 ++i) {
       if (i->first.second != entity) continue;
-      if (p->watch_cookie &&
-	  *(p->watch_cookie) != i->first.first) continue;
       dout(10) << "acking notify on watch " << i->first << dendl;
       i->second->notify_ack(p->notify_id, p->reply_bl);
     }
@@ -8944,6 +9010,10 @@ void PrimaryLogPG::finish_ctx(OpContext *ctx, int log_op_type, int result)
     ctx->new_obs.oi.user_version = ctx->user_at_version;
   }
   ctx->bytes_written = ctx->op_t->get_bytes_written();
+  // the cached data would only be stale once this op applies
+  if (ctx->obc) {
+    ctx->obc->clear_data_cache();
+  }
 
   if (ctx->new_obs.exists) {
     ctx->new_obs.oi.version = ctx->at_version;
@@ -11829,10 +11899,11 @@ ObjectContextRef PrimaryLogPG::get_object_context(
     dout(10) << __func__ << ": obc NOT found in cache: " << soid << dendl;
     // check disk
     bufferlist bv;
+    const bufferlist *oi_bl = &bv;
     if (attrs) {
       auto it_oi = attrs->find(OI_ATTR);
       ceph_assert(it_oi != attrs->end());
-      bv = it_oi->second;
+      oi_bl = &it_oi->second;
     } else {
       int r = pgbackend->objects_get_attr(soid, OI_ATTR, &bv);
       if (r < 0) {
@@ -11861,7 +11932,7 @@ ObjectContextRef PrimaryLogPG::get_object_context(
 
     object_info_t oi;
     try {
-      bufferlist::const_iterator bliter = bv.begin();
+      bufferlist::const_iterator bliter = oi_bl->begin();
       decode(oi, bliter);
     } catch (...) {
       dout(0) << __func__ << ": obc corrupt: " << soid << dendl;
@@ -11872,7 +11943,7 @@ ObjectContextRef PrimaryLogPG::get_object_context(
 
     obc = object_contexts.lookup_or_create(oi.soid);
     obc->destructor_callback = new C_PG_ObjectContext(this, obc.get());
-    obc->obs.oi = oi;
+    obc->obs.oi = std::move(oi);
     obc->obs.exists = true;
 
     obc->ssc = get_snapset_context(
@@ -12240,6 +12311,7 @@ SnapSetContext *PrimaryLogPG::get_snapset_context(
     }
   } else {
     bufferlist bv;
+    const bufferlist *ss_bl = &bv;
     if (!attrs) {
       int r = -ENOENT;
       if (!(oid.is_head() && !oid_existed)) {
@@ -12250,12 +12322,12 @@ SnapSetContext *PrimaryLogPG::get_snapset_context(
     } else {
       auto it_ss = attrs->find(SS_ATTR);
       ceph_assert(it_ss != attrs->end());
-      bv = it_ss->second;
+      ss_bl = &it_ss->second;
     }
     ssc = new SnapSetContext(oid.get_snapdir());
     _register_snapset_context(ssc);
-    if (bv.length()) {
-      bufferlist::const_iterator bvp = bv.begin();
+    if (ss_bl->length()) {
+      bufferlist::const_iterator bvp = ss_bl->begin();
       try {
 	ssc->snapset.decode(bvp);
       } catch (const ceph::buffer::error& e) {
@@ -13357,7 +13429,7 @@ uint64_t PrimaryLogPG::recover_primary(uint64_t max, ThreadPool::TPHandle &handl
   int skipped = 0;
 
   PGBackend::RecoveryHandle *h = pgbackend->open_recovery_op();
-  map<version_t, hobject_t>::const_iterator p =
+  pg_missing_t::rmissing_t::const_iterator p =
     missing.get_rmissing().lower_bound(recovery_state.get_pg_log().get_log().last_requested);
   while (p != missing.get_rmissing().end()) {
     handle.reset_tp_timeout();
@@ -13665,7 +13737,7 @@ uint64_t PrimaryLogPG::recover_replicas(uint64_t max, ThreadPool::TPHandle &hand
 
     // oldest first!
     const pg_missing_t &m(pm->second);
-    for (map<version_t, hobject_t>::const_iterator p = m.get_rmissing().begin();
+    for (pg_missing_t::rmissing_t::const_iterator p = m.get_rmissing().begin();
 	 p != m.get_rmissing().end() && started < max;
 	   ++p) {
       handle.reset_tp_timeout();
@@ -1413,6 +1413,7 @@ protected:
 
   friend struct C_ExtentCmpRead;
 
+  bool is_data_cacheable(const OpContext *ctx, const OSDOp& osd_op) const;
   int do_read(OpContext *ctx, OSDOp& osd_op);
   int do_sparse_read(OpContext *ctx, OSDOp& osd_op);
   int do_writesame(OpContext *ctx, OSDOp& osd_op);
@@ -1462,7 +1463,8 @@ protected:
   void cancel_and_requeue_proxy_ops(hobject_t oid);
   void cancel_manifest_ops(bool requeue, std::vector<ceph_tid_t> *tids);
   ceph_tid_t refcount_manifest(hobject_t src_soid, hobject_t tgt_soid, refcount_t type,
-			      Context *cb, std::optional<bufferlist> chunk);
+			      Context *cb, std::optional<bufferlist> chunk,
+			      unsigned count = 1);
   void dec_all_refcount_manifest(const object_info_t& oi, OpContext* ctx);
   void dec_refcount(const hobject_t& soid, const object_ref_delta_t& refs);
   void update_chunk_map_by_dirty(OpContext* ctx);
@@ -959,6 +959,7 @@ Message * ReplicatedBackend::generate_subop(
   const bufferlist &log_entries,
   std::optional<pg_hit_set_history_t> &hset_hist,
   ObjectStore::Transaction &op_t,
+  bufferlist &op_t_bl,
   pg_shard_t peer,
   const pg_info_t &pinfo)
 {
@@ -977,7 +978,11 @@ Message * ReplicatedBackend::generate_subop(
     ObjectStore::Transaction t;
     encode(t, wr->get_data());
   } else {
-    encode(op_t, wr->get_data());
+    // encoded for the first peer that needs it, shared with the rest
+    if (op_t_bl.length() == 0) {
+      encode(op_t, op_t_bl);
+    }
+    wr->get_data() = op_t_bl;
     wr->get_header().data_off = op_t.get_data_alignment();
   }
 
@@ -1031,6 +1036,8 @@ void ReplicatedBackend::issue_op(
     // avoid doing the same work in generate_subop
     bufferlist logs;
     encode(log_entries, logs);
+    // likewise the transaction, which no peer may need at all
+    bufferlist op_t_bl;
 
     for (const auto& shard : get_parent()->get_acting_recovery_backfill_shards()) {
       if (shard == parent->whoami_shard()) continue;
@@ -1049,6 +1056,7 @@ void ReplicatedBackend::issue_op(
 	  logs,
 	  hset_hist,
 	  op_t,
+	  op_t_bl,
 	  shard,
 	  pinfo);
       if (op->op && op->op->pg_trace)
@@ -1963,6 +1971,9 @@ void ReplicatedBackend::handle_push(
 
 void ReplicatedBackend::send_pushes(int prio, map<pg_shard_t, vector<PushOp> > &pushes)
 {
+  // the pushes of a batch of small objects may exceed osd_max_push_objects
+  // as long as they add up to less than a batch
+  uint64_t batch_bytes = cct->_conf->osd_recovery_small_object_batch_bytes;
   for (map<pg_shard_t, vector<PushOp> >::iterator i = pushes.begin();
        i != pushes.end();
        ++i) {
@@ -1985,7 +1996,8 @@ void ReplicatedBackend::send_pushes(int prio, map<pg_shard_t, vector<PushOp> > &
       for (;
            (j != i->second.end() &&
 	    cost < cct->_conf->osd_max_push_cost &&
-	    pushes < cct->_conf->osd_max_push_objects) ;
+	    (pushes < cct->_conf->osd_max_push_objects ||
+	     cost + j->cost(cct) <= batch_bytes)) ;
 	   ++j) {
 	dout(20) << __func__ << ": sending push " << *j
 		 << " to osd." << i->first << dendl;
@@ -118,6 +118,13 @@ public:
  * The 2) mapping is arranged such that all objects in a particular
  * snap will sort together, and so that all objects in a pg for a
  * particular snap will group under up to 8 prefixes.
+ *
+ * Trimming a snap still touches every clone in it: the 1) entry of each
+ * clone is rewritten without the snap (or removed with the clone) in the
+ * same transaction as the clone itself, and the update looks the 1) entry
+ * up to find the 2) keys to drop.  Once the last clone is trimmed the
+ * snap's 2) prefixes are already empty, so there is nothing left for a
+ * range delete to purge.
  */
 class SnapMapper : public Scrub::SnapMapReaderI {
   friend class MapperVerifier; // unit-test support
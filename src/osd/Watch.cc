@@ -55,6 +55,7 @@ Notify::Notify(
     discarded(false),
     timed_out(false),
     payload(payload),
+    start(ceph::mono_clock::now()),
     timeout(timeout),
     cookie(cookie),
     notify_id(notify_id),
@@ -118,12 +119,23 @@ void Notify::do_timeout()
   _watchers.swap(watchers);
   lock.unlock();
 
-  for (auto i = _watchers.begin(); i != _watchers.end(); ++i) {
-    boost::intrusive_ptr<PrimaryLogPG> pg((*i)->get_pg());
-    pg->lock();
-    if (!(*i)->is_discarded()) {
-      (*i)->cancel_notify(self.lock());
+  // the watchers are all on the notified object, so they share a PG: take
+  // its lock once rather than once per watcher
+  NotifyRef notif = self.lock();
+  boost::intrusive_ptr<PrimaryLogPG> pg;
+  for (auto& watch : _watchers) {
+    if (watch->get_pg() != pg) {
+      if (pg) {
+	pg->unlock();
+      }
+      pg = watch->get_pg();
+      pg->lock();
     }
+    if (!watch->is_discarded()) {
+      watch->cancel_notify(notif);
+    }
+  }
+  if (pg) {
     pg->unlock();
   }
 }
@@ -166,8 +178,8 @@ void Notify::complete_watcher(WatchRef watch, bufferlist& reply_bl)
   dout(10) << "complete_watcher" << dendl;
   if (is_discarded())
     return;
-  ceph_assert(watchers.count(watch));
-  watchers.erase(watch);
+  auto erased = watchers.erase(watch);
+  ceph_assert(erased);
   notify_replies.insert(make_pair(make_pair(watch->get_watcher_gid(),
 					    watch->get_cookie()),
 				  reply_bl));
@@ -180,8 +192,8 @@ void Notify::complete_watcher_remove(WatchRef watch)
   dout(10) << __func__ << dendl;
   if (is_discarded())
     return;
-  ceph_assert(watchers.count(watch));
-  watchers.erase(watch);
+  auto erased = watchers.erase(watch);
+  ceph_assert(erased);
   maybe_complete_notify();
 }
 
@@ -216,6 +228,10 @@ void Notify::maybe_complete_notify()
     client->send_message(reply);
     unregister_cb();
 
+    osd->logger->tinc(l_osd_notify_lat, ceph::mono_clock::now() - start);
+    if (timed_out)
+      osd->logger->inc(l_osd_notify_timeout);
+
     complete = true;
   }
 }
@@ -231,6 +247,8 @@ void Notify::discard()
 void Notify::init()
 {
   std::lock_guard l(lock);
+  osd->logger->inc(l_osd_notify);
+  osd->logger->inc(l_osd_notify_watchers, watchers.size());
   register_cb();
   maybe_complete_notify();
 }
@@ -542,16 +560,21 @@ void WatchConState::reset(Connection *con)
     std::lock_guard l(lock);
     _watches.swap(watches);
   }
-  for (set<WatchRef>::iterator i = _watches.begin();
-       i != _watches.end();
-       ++i) {
-    boost::intrusive_ptr<PrimaryLogPG> pg((*i)->get_pg());
+  // a client often watches many objects of a PG: disconnect them all under
+  // one take of its lock
+  std::map<boost::intrusive_ptr<PrimaryLogPG>, vector<WatchRef>> by_pg;
+  for (auto& watch : _watches) {
+    by_pg[watch->get_pg()].push_back(watch);
+  }
+  for (auto& [pg, pg_watches] : by_pg) {
     pg->lock();
-    if (!(*i)->is_discarded()) {
-      if ((*i)->is_connected(con)) {
-	(*i)->disconnect();
-      } else {
-	lgeneric_derr(cct) << __func__ << " not still connected to " << (*i) << dendl;
+    for (auto& watch : pg_watches) {
+      if (!watch->is_discarded()) {
+	if (watch->is_connected(con)) {
+	  watch->disconnect();
+	} else {
+	  lgeneric_derr(cct) << __func__ << " not still connected to " << watch << dendl;
+	}
       }
     }
     pg->unlock();
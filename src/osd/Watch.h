@@ -15,6 +15,7 @@
 #define CEPH_WATCH_H
 
 #include <set>
+#include "common/ceph_time.h"
 #include "msg/Connection.h"
 #include "include/Context.h"
 
@@ -57,6 +58,7 @@ class Notify {
   std::set<WatchRef> watchers;
 
   ceph::buffer::list payload;
+  ceph::mono_time start;    ///< when the notify was created
   uint32_t timeout;
   uint64_t cookie;
   uint64_t notify_id;
@@ -51,6 +51,25 @@ public:
   // attr cache
   std::map<std::string, ceph::buffer::list, std::less<>> attr_cache;
 
+  // data of small objects, as of data_cache_version
+  eversion_t data_cache_version;
+  ceph::buffer::list data_cache;
+
+  bool has_data_cache() const {
+    return data_cache_version != eversion_t() &&
+      data_cache_version == obs.oi.version;
+  }
+  void set_data_cache(const ceph::buffer::list& bl) {
+    // do not pin the buffers of the read
+    data_cache = bl;
+    data_cache.rebuild();
+    data_cache_version = obs.oi.version;
+  }
+  void clear_data_cache() {
+    data_cache.clear();
+    data_cache_version = eversion_t();
+  }
+
   RWState rwstate;
   std::list<OpRequestRef> waiters;  ///< ops waiting on state change
   bool get_read(OpRequestRef& op) {
@@ -63,6 +63,17 @@ PerfCounters *build_osd_logger(CephContext *cct) {
     l_osd_op_delayed_degraded, "op_delayed_degraded",
     "Count of ops delayed due to target object being degraded");
 
+  osd_plb.add_u64_counter(
+    l_osd_notify, "notify", "Notifies sent to watchers");
+  osd_plb.add_u64_avg(
+    l_osd_notify_watchers, "notify_watchers",
+    "Watchers a notify is sent to");
+  osd_plb.add_time_avg(
+    l_osd_notify_lat, "notify_latency",
+    "Latency of notifies, until all watchers acked or the notify timed out");
+  osd_plb.add_u64_counter(
+    l_osd_notify_timeout, "notify_timeout", "Notifies that timed out");
+
   osd_plb.add_u64_counter(
     l_osd_op_r, "op_r", "Client read operations");
   osd_plb.add_u64_counter(
@@ -80,6 +91,9 @@ PerfCounters *build_osd_logger(CephContext *cct) {
   osd_plb.add_time_avg(
     l_osd_op_r_prepare_lat, "op_r_prepare_latency",
     "Latency of read operations (excluding queue time and wait for finished)");
+  osd_plb.add_u64_counter(
+    l_osd_op_r_data_cache_hit, "op_r_data_cache_hit",
+    "Whole-object reads served from the object context data cache");
   osd_plb.add_u64_counter(
     l_osd_op_w, "op_w", "Client write operations");
   osd_plb.add_u64_counter(
@@ -126,6 +140,21 @@ PerfCounters *build_osd_logger(CephContext *cct) {
   osd_plb.add_time_avg(l_osd_op_before_queue_op_lat, "op_before_queue_op_lat",
     "Latency of IO before calling queue(before really queue into ShardedOpWq)"); // client io before queue op_wq latency
 
+  // client op latency broken down into the time until it was queued, the
+  // time spent in the op queue and the time it took to process it
+  osd_plb.add_u64_counter_histogram(
+    l_osd_op_before_queue_lat_bytes_hist, "op_before_queue_latency_bytes_histogram",
+    op_hist_x_axis_config, op_hist_y_axis_config,
+    "Histogram of operation latency before being queued + data read and written");
+  osd_plb.add_u64_counter_histogram(
+    l_osd_op_queue_wait_lat_bytes_hist, "op_queue_wait_latency_bytes_histogram",
+    op_hist_x_axis_config, op_hist_y_axis_config,
+    "Histogram of operation time in the op queue + data read and written");
+  osd_plb.add_u64_counter_histogram(
+    l_osd_op_process_lat_bytes_hist, "op_process_latency_bytes_histogram",
+    op_hist_x_axis_config, op_hist_y_axis_config,
+    "Histogram of operation latency after being dequeued + data read and written");
+
   // Now we move on to some more obscure stats, revert to assuming things
   // are low priority unless otherwise specified.
   osd_plb.set_prio_default(PerfCountersBuilder::PRIO_DEBUGONLY);
@@ -211,6 +240,12 @@ PerfCounters *build_osd_logger(CephContext *cct) {
     "Total number getting crc from crc_cache with adjusting");
   osd_plb.add_u64(l_osd_missed_crc, "missed_crc", 
     "Total number of crc cache misses");
+  osd_plb.add_u64(
+    l_osd_buffer_raw_cache_hit, "buffer_raw_cache_hit",
+    "Small buffers allocated from the per thread cache");
+  osd_plb.add_u64(
+    l_osd_buffer_raw_cache_miss, "buffer_raw_cache_miss",
+    "Small buffers the per thread cache had to malloc");
 
   osd_plb.add_u64(l_osd_pg, "numpg", "Placement groups",
 		  "pgs", PerfCountersBuilder::PRIO_USEFUL);
@@ -22,6 +22,7 @@ enum {
   l_osd_op_r_lat_outb_hist,
   l_osd_op_r_process_lat,
   l_osd_op_r_prepare_lat,
+  l_osd_op_r_data_cache_hit,
   l_osd_op_w,
   l_osd_op_w_inb,
   l_osd_op_w_lat,
@@ -40,8 +41,16 @@ enum {
   l_osd_op_delayed_unreadable,
   l_osd_op_delayed_degraded,
 
+  l_osd_notify,
+  l_osd_notify_watchers,
+  l_osd_notify_lat,
+  l_osd_notify_timeout,
+
   l_osd_op_before_queue_op_lat,
   l_osd_op_before_dequeue_op_lat,
+  l_osd_op_before_queue_lat_bytes_hist,
+  l_osd_op_queue_wait_lat_bytes_hist,
+  l_osd_op_process_lat_bytes_hist,
 
   l_osd_sop,
   l_osd_sop_inb,
@@ -76,6 +85,8 @@ enum {
   l_osd_cached_crc,
   l_osd_cached_crc_adjusted,
   l_osd_missed_crc,
+  l_osd_buffer_raw_cache_hit,
+  l_osd_buffer_raw_cache_miss,
 
   l_osd_pg,
   l_osd_pg_primary,
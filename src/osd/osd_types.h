@@ -21,6 +21,7 @@
 #include <atomic>
 #include <sstream>
 #include <cstdio>
+#include <functional>
 #include <memory>
 #include <string_view>
 
@@ -4837,9 +4838,12 @@ template <> struct fmt::formatter<pg_missing_item> : fmt::ostream_formatter {};
 
 class pg_missing_const_i {
 public:
+  /// need version -> oid, the oids are the keys of get_items()
+  using rmissing_t = std::map<version_t, std::reference_wrapper<const hobject_t>>;
+
   virtual const std::map<hobject_t, pg_missing_item> &
     get_items() const = 0;
-  virtual const std::map<version_t, hobject_t> &get_rmissing() const = 0;
+  virtual const rmissing_t &get_rmissing() const = 0;
   virtual bool get_may_include_deletes() const = 0;
   virtual unsigned int num_missing() const = 0;
   virtual bool have_missing() const = 0;
@@ -4885,16 +4889,44 @@ template <bool TrackChanges>
 class pg_missing_set : public pg_missing_const_i {
   using item = pg_missing_item;
   std::map<hobject_t, item> missing;  // oid -> (need v, have v)
-  std::map<version_t, hobject_t> rmissing;  // v -> oid
+  rmissing_t rmissing;  // v -> oid, refers to the keys of missing
   ChangeTracker<TrackChanges> tracker;
 
+  void _set_rmissing(std::map<hobject_t, item>::const_iterator m) {
+    rmissing.insert_or_assign(m->second.need.version, std::cref(m->first));
+  }
+  void _rebuild_rmissing() {
+    rmissing.clear();
+    for (auto m = missing.cbegin(); m != missing.cend(); ++m) {
+      _set_rmissing(m);
+    }
+  }
+
 public:
   pg_missing_set() = default;
+  // the copies of rmissing must refer to their own missing map
+  pg_missing_set(const pg_missing_set &o)
+    : missing(o.missing),
+      tracker(o.tracker),
+      may_include_deletes(o.may_include_deletes) {
+    _rebuild_rmissing();
+  }
+  pg_missing_set(pg_missing_set &&) = default;
+  pg_missing_set& operator=(const pg_missing_set &o) {
+    if (this != &o) {
+      missing = o.missing;
+      tracker = o.tracker;
+      may_include_deletes = o.may_include_deletes;
+      _rebuild_rmissing();
+    }
+    return *this;
+  }
+  pg_missing_set& operator=(pg_missing_set &&) = default;
 
   template <typename missing_type>
   pg_missing_set(const missing_type &m) {
     missing = m.get_items();
-    rmissing = m.get_rmissing();
+    _rebuild_rmissing();
     may_include_deletes = m.get_may_include_deletes();
     for (auto &&i: missing)
       tracker.changed(i.first);
@@ -4905,7 +4937,7 @@ public:
   const std::map<hobject_t, item> &get_items() const override {
     return missing;
   }
-  const std::map<version_t, hobject_t> &get_rmissing() const override {
+  const rmissing_t &get_rmissing() const override {
     return rmissing;
   }
   bool get_may_include_deletes() const override {
@@ -4973,8 +5005,9 @@ public:
       } else {
          // create new element in missing map
          // .have = nil
-        missing[e.soid] = item(e.version, eversion_t(), e.is_delete());
-        missing[e.soid].clean_regions.mark_fully_dirty();
+        missing_it = missing.emplace(
+          e.soid, item(e.version, eversion_t(), e.is_delete())).first;
+        missing_it->second.clean_regions.mark_fully_dirty();
       }
     } else if (is_missing_divergent_item) {
       // already missing (prior).
@@ -4988,13 +5021,14 @@ public:
     } else {
       // not missing, we must have prior_version (if any)
       ceph_assert(!is_missing_divergent_item);
-      missing[e.soid] = item(e.version, e.prior_version, e.is_delete());
+      missing_it = missing.emplace(
+        e.soid, item(e.version, e.prior_version, e.is_delete())).first;
       if (e.is_lost_revert())
-        missing[e.soid].clean_regions.mark_fully_dirty();
+        missing_it->second.clean_regions.mark_fully_dirty();
       else
-        missing[e.soid].clean_regions = e.clean_regions;
+        missing_it->second.clean_regions = e.clean_regions;
     }
-    rmissing[e.version.version] = e.soid;
+    _set_rmissing(missing_it);
     tracker.changed(e.soid);
   }
 
@@ -5006,10 +5040,10 @@ public:
       p->second.set_delete(is_delete);
       p->second.clean_regions.mark_fully_dirty();
     } else {
-      missing[oid] = item(need, eversion_t(), is_delete);
-      missing[oid].clean_regions.mark_fully_dirty();
+      p = missing.emplace(oid, item(need, eversion_t(), is_delete)).first;
+      p->second.clean_regions.mark_fully_dirty();
     }
-    rmissing[need.version] = oid;
+    _set_rmissing(p);
 
     tracker.changed(oid);
   }
@@ -5032,14 +5066,22 @@ public:
 
   void add(const hobject_t& oid, eversion_t need, eversion_t have,
 	   bool is_delete) {
-    missing[oid] = item(need, have, is_delete, true);
-    rmissing[need.version] = oid;
+    auto p = missing.find(oid);
+    if (p != missing.end()) {
+      rmissing.erase(p->second.need.version);
+      p->second = item(need, have, is_delete, true);
+    } else {
+      p = missing.emplace(oid, item(need, have, is_delete, true)).first;
+    }
+    _set_rmissing(p);
     tracker.changed(oid);
   }
 
   void add(const hobject_t& oid, pg_missing_item&& item) {
-    rmissing[item.need.version] = oid;
-    missing.insert({oid, std::move(item)});
+    auto [p, inserted] = missing.insert({oid, std::move(item)});
+    if (inserted) {
+      _set_rmissing(p);
+    }
     tracker.changed(oid);
   }
 
@@ -5103,6 +5145,7 @@ public:
   void decode(ceph::buffer::list::const_iterator &bl, int64_t pool = -1) {
     for (auto const &i: missing)
       tracker.changed(i.first);
+    rmissing.clear();
     DECODE_START_LEGACY_COMPAT_LEN(5, 2, 2, bl);
     decode(missing, bl);
     if (struct_v >= 4) {
@@ -5129,11 +5172,7 @@ public:
       missing.insert(tmp.begin(), tmp.end());
     }
 
-    for (std::map<hobject_t,item>::iterator it =
-	   missing.begin();
-	 it != missing.end();
-	 ++it)
-      rmissing[it->second.need.version] = it->first;
+    _rebuild_rmissing();
     for (auto const &i: missing)
       tracker.changed(i.first);
   }
@@ -58,6 +58,10 @@ public:
   // Get the scheduler type set for the queue
   virtual op_queue_type_t get_type() const = 0;
 
+  // Scale the IO capacity the scheduler assumes for the device by ratio
+  // (in (0, 1]), as estimated from its observed latency
+  virtual void update_capacity_ratio(double ratio) {}
+
   // Destructor
   virtual ~OpScheduler() {};
 };
@@ -13,6 +13,7 @@
  */
 
 
+#include <algorithm>
 #include <memory>
 #include <functional>
 
@@ -177,7 +178,7 @@ void mClockScheduler::set_osd_capacity_params_from_config()
   }();
 
   osd_bandwidth_capacity = std::max<uint64_t>(1, osd_bandwidth_capacity);
-  osd_iop_capacity = std::max<double>(1.0, osd_iop_capacity);
+  osd_iop_capacity = std::max<double>(1.0, osd_iop_capacity * capacity_ratio);
 
   osd_bandwidth_cost_per_io =
     static_cast<double>(osd_bandwidth_capacity) / osd_iop_capacity;
@@ -189,9 +190,22 @@ void mClockScheduler::set_osd_capacity_params_from_config()
           << osd_bandwidth_cost_per_io << " bytes/io"
           << ", osd_bandwidth_capacity_per_shard "
           << osd_bandwidth_capacity_per_shard << " bytes/second"
+          << ", capacity_ratio " << capacity_ratio
           << dendl;
 }
 
+void mClockScheduler::update_capacity_ratio(double ratio)
+{
+  ratio = std::clamp(ratio, 0.0, 1.0);
+  if (ratio <= 0.0 || ratio == capacity_ratio) {
+    return;
+  }
+  capacity_ratio = ratio;
+  set_osd_capacity_params_from_config();
+  client_registry.update_from_config(
+    cct->_conf, osd_bandwidth_capacity_per_shard);
+}
+
 /**
  * profile_t
  *
@@ -381,6 +395,13 @@ void mClockScheduler::dump(ceph::Formatter &f) const
     f.dump_int("queue_size", it->second.size());
   }
   f.close_section();
+
+  f.open_object_section("capacity");
+  f.dump_float("osd_bandwidth_cost_per_io", osd_bandwidth_cost_per_io);
+  f.dump_float("osd_bandwidth_capacity_per_shard",
+               osd_bandwidth_capacity_per_shard);
+  f.dump_float("capacity_ratio", capacity_ratio);
+  f.close_section();
 }
 
 void mClockScheduler::enqueue(OpSchedulerItem&& item)
@@ -142,6 +142,16 @@ class mClockScheduler : public OpScheduler, md_config_obs_t {
    */
   double osd_bandwidth_capacity_per_shard;
 
+  /**
+   * capacity_ratio
+   *
+   * Fraction of osd_mclock_max_capacity_iops_(hdd|ssd) the device is
+   * currently believed to sustain, as estimated by the OSD from the
+   * observed commit latency (see osd_mclock_capacity_feedback).  1.0 unless
+   * feedback is enabled.  A lower ratio raises osd_bandwidth_cost_per_io.
+   */
+  double capacity_ratio = 1.0;
+
   class ClientRegistry {
     std::array<
       crimson::dmclock::ClientInfo,
@@ -258,6 +268,9 @@ public:
     return op_queue_type_t::mClockScheduler;
   }
 
+  // Rescale the IOPS capacity from the latency feedback of the OSD
+  void update_capacity_ratio(double ratio) final;
+
   const char** get_tracked_conf_keys() const final;
   void handle_conf_change(const ConfigProxy& conf,
 			  const std::set<std::string> &changed) final;
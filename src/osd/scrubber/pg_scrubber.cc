@@ -1177,7 +1177,7 @@ void PgScrubber::on_init()
   m_interval_start = m_pg->get_history().same_interval_since;
   dout(10) << __func__ << " start same_interval:" << m_interval_start << dendl;
 
-  m_be = std::make_unique<ScrubBackend>(
+  m_be = std::make_shared<ScrubBackend>(
     *this,
     *m_pg,
     m_pg_whoami,
@@ -1207,7 +1207,7 @@ void PgScrubber::on_replica_init()
   dout(10) << __func__ << " called with 'active' "
 	   << (m_active ? "set" : "cleared") << dendl;
   if (!m_active) {
-    m_be = std::make_unique<ScrubBackend>(
+    m_be = std::make_shared<ScrubBackend>(
       *this, *m_pg, m_pg_whoami, m_is_repair,
       m_is_deep ? scrub_level_t::deep : scrub_level_t::shallow);
     m_active = true;
@@ -1506,8 +1506,42 @@ void PgScrubber::maps_compare_n_cleanup()
 {
   m_pg->add_objects_scrubbed_count(m_be->get_primary_scrubmap().objects.size());
 
+  m_be->prepare_compare_maps();
+
+  auto compare_finisher = m_osds->get_scrub_compare_finisher(m_pg_id);
+  if (!compare_finisher) {
+    m_be->compare_chunk_maps();
+    finish_maps_compare();
+    return;
+  }
+
+  // The per-object comparison only reads the chunk's maps, so it is done
+  // without the PG lock. The chunk stays blocked to writes, and
+  // on_digest_updates() holds off, until we are back under the lock.
+  dout(15) << __func__ << ": comparing the maps off the PG lock" << dendl;
+  m_maps_compare_in_flight = true;
+  compare_finisher->queue(new LambdaContext(
+    [this, pg = PGRef(m_pg), be = m_be](int) {
+      be->compare_chunk_maps();
+      pg->lock();
+      if (be == m_be && m_maps_compare_in_flight) {
+	m_maps_compare_in_flight = false;
+	m_maps_compare_ready = true;
+	m_osds->queue_scrub_digest_update(m_pg,
+					  m_pg->is_scrub_blocking_ops());
+      } else {
+	// the scrub session was reset while we were comparing
+	dout(10) << "maps_compare_n_cleanup: dropping the comparison of"
+		 << " a discarded chunk" << dendl;
+      }
+      pg->unlock();
+    }));
+}
+
+void PgScrubber::finish_maps_compare()
+{
   auto required_fixes =
-    m_be->scrub_compare_maps(m_end.is_max(), get_snap_mapper_accessor());
+    m_be->complete_compare_maps(m_end.is_max(), get_snap_mapper_accessor());
   if (!required_fixes.inconsistent_objs.empty()) {
     if (state_test(PG_STATE_REPAIR)) {
       dout(10) << __func__ << ": discarding scrub results (repairing)" << dendl;
@@ -1689,6 +1723,13 @@ void PgScrubber::map_from_replica(OpRequestRef op)
     return;
   }
 
+  if (m_maps_compare_in_flight || m_maps_compare_ready) {
+    // all maps of the chunk are in, and are being compared
+    dout(5) << __func__ << ": unexpected map from " << m->from
+	    << " while comparing the chunk" << dendl;
+    return;
+  }
+
   // note: we check for active() before map_from_replica() is called. Thus, we
   // know m_be is initialized
   m_be->decode_received_map(m->from, *m);
@@ -2028,6 +2069,14 @@ void PgScrubber::on_digest_updates()
 	   << (is_queued_or_active() ? "" : " ** not marked as scrubbing **")
 	   << dendl;
 
+  if (m_maps_compare_in_flight) {
+    // we will be requeued once the chunk's maps are compared
+    return;
+  }
+  if (std::exchange(m_maps_compare_ready, false)) {
+    finish_maps_compare();  // might submit digest updates
+  }
+
   if (num_digest_updates_pending > 0) {
     // do nothing for now. We will be called again when new updates arrive
     return;
@@ -2336,6 +2385,8 @@ void PgScrubber::reset_internal_state()
   run_callbacks();
 
   num_digest_updates_pending = 0;
+  m_maps_compare_in_flight = false;
+  m_maps_compare_ready = false;
   m_primary_scrubmap_pos.reset();
   replica_scrubmap = ScrubMap{};
   replica_scrubmap_pos.reset();
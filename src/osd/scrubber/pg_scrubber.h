@@ -726,6 +726,17 @@ class PgScrubber : public ScrubPgIF,
   int num_digest_updates_pending{0};
   hobject_t m_start, m_end;  ///< note: half-closed: [start,end)
 
+  /// set while the current chunk's maps are being compared on a
+  /// scrub-compare worker. The backend is not to be touched until then.
+  bool m_maps_compare_in_flight{false};
+  /// the worker is done, and the chunk is waiting for
+  /// finish_maps_compare() to be called under the PG lock
+  bool m_maps_compare_ready{false};
+
+  /// the part of maps_compare_n_cleanup() that follows the per-object
+  /// comparison: repair decisions, stats and releasing the chunk
+  void finish_maps_compare();
+
   /// Returns epoch of current osdmap
   epoch_t get_osdmap_epoch() const { return get_osdmap()->get_epoch(); }
 
@@ -836,7 +847,8 @@ class PgScrubber : public ScrubPgIF,
   ScrubMap replica_scrubmap;
 
   // the backend, handling the details of comparing maps & fixing objects
-  std::unique_ptr<ScrubBackend> m_be;
+  // (shared with the scrub-compare worker comparing the chunk's maps, if any)
+  std::shared_ptr<ScrubBackend> m_be;
 
   /**
    * we mark the request priority as it arrived. It influences the queuing
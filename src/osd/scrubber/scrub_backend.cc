@@ -196,6 +196,13 @@ objs_fix_list_t ScrubBackend::scrub_compare_maps(
   dout(10) << __func__ << " has maps, analyzing" << dendl;
   ceph_assert(m_scrubber.is_primary());
 
+  prepare_compare_maps();
+  compare_chunk_maps();
+  return complete_compare_maps(max_reached, snaps_getter);
+}
+
+void ScrubBackend::prepare_compare_maps()
+{
   // construct authoritative scrub map for type-specific scrubbing
 
   m_cleaned_meta_map.insert(my_map());
@@ -203,7 +210,19 @@ objs_fix_list_t ScrubBackend::scrub_compare_maps(
 
   // collect some omap statistics into m_omap_stats
   omap_checks();
+}
 
+void ScrubBackend::compare_chunk_maps()
+{
+  if (!m_acting_but_me.empty()) {
+    compare_smaps();  // note: might cluster-log errors
+  }
+}
+
+objs_fix_list_t ScrubBackend::complete_compare_maps(
+  bool max_reached,
+  SnapMapReaderI& snaps_getter)
+{
   update_authoritative();
   auto for_meta_scrub = clean_meta_map(m_cleaned_meta_map, max_reached);
 
@@ -231,36 +250,22 @@ void ScrubBackend::omap_checks()
 
   stringstream wss;
 
-  // Iterate through objects and update omap stats
-  for (const auto& ho : this_chunk->authoritative_set) {
-
-    for (const auto& [srd, smap] : this_chunk->received_maps) {
-      if (srd != m_pg_whoami) {
-        // Only set omap stats for the primary
-        continue;
-      }
-
-      auto it = smap.objects.find(ho);
-      if (it == smap.objects.end()) {
-        continue;
-      }
-
-      const ScrubMap::object& smap_obj = it->second;
-      m_omap_stats.omap_bytes += smap_obj.object_omap_bytes;
-      m_omap_stats.omap_keys += smap_obj.object_omap_keys;
-      if (smap_obj.large_omap_object_found) {
-        auto osdmap = m_scrubber.get_osdmap();
-        pg_t pg;
-        osdmap->map_to_pg(ho.pool, ho.oid.name, ho.get_key(), ho.nspace, &pg);
-        pg_t mpg = osdmap->raw_pg_to_pg(pg);
-        m_omap_stats.large_omap_objects++;
-        wss << "Large omap object found. Object: " << ho << " PG: " << pg
-            << " (" << mpg << ")"
-            << " Key count: " << smap_obj.large_omap_object_key_count
-            << " Size (bytes): " << smap_obj.large_omap_object_value_size
-            << '\n';
-        break;
-      }
+  // Only set omap stats for the primary. Its map holds a subset of the
+  // authoritative set, in the same order, so there is nothing to look up.
+  for (const auto& [ho, smap_obj] : my_map().objects) {
+    m_omap_stats.omap_bytes += smap_obj.object_omap_bytes;
+    m_omap_stats.omap_keys += smap_obj.object_omap_keys;
+    if (smap_obj.large_omap_object_found) {
+      auto osdmap = m_scrubber.get_osdmap();
+      pg_t pg;
+      osdmap->map_to_pg(ho.pool, ho.oid.name, ho.get_key(), ho.nspace, &pg);
+      pg_t mpg = osdmap->raw_pg_to_pg(pg);
+      m_omap_stats.large_omap_objects++;
+      wss << "Large omap object found. Object: " << ho << " PG: " << pg
+          << " (" << mpg << ")"
+          << " Key count: " << smap_obj.large_omap_object_key_count
+          << " Size (bytes): " << smap_obj.large_omap_object_value_size
+          << '\n';
     }
   }
 
@@ -286,10 +291,11 @@ void ScrubBackend::update_authoritative()
     return;
   }
 
-  compare_smaps();  // note: might cluster-log errors
-
   // update the session-wide m_auth_peers with the list of good
   // peers for each object (i.e. the ones that are in this_chunks's auth list)
+  //
+  // also replace the object in m_cleaned_meta_map with the copy held by
+  // the back-most of these peers
   for (auto& [obj, peers] : this_chunk->authoritative) {
 
     auth_peers_t good_peers;
@@ -298,15 +304,11 @@ void ScrubBackend::update_authoritative()
       good_peers.emplace_back(this_chunk->received_maps[peer].objects[obj],
                               peer);
     }
+    m_cleaned_meta_map.objects.insert_or_assign(obj,
+                                                good_peers.back().first);
 
     m_auth_peers.emplace(obj, std::move(good_peers));
   }
-
-  for (const auto& [obj, peers] : this_chunk->authoritative) {
-    m_cleaned_meta_map.objects.erase(obj);
-    m_cleaned_meta_map.objects.insert(
-      *(this_chunk->received_maps[peers.back()].objects.find(obj)));
-  }
 }
 
 int ScrubBackend::scrub_process_inconsistent()
@@ -423,13 +425,7 @@ auth_selection_t ScrubBackend::select_auth_object(const hobject_t& ho,
   /// selecting best auth source below. Then - stopping on the first one
   /// that is auth eligible.
   /// This creates an issue with 'digest_match' that should be handled.
-  std::list<pg_shard_t> shards;
-  for (const auto& [srd, smap] : this_chunk->received_maps) {
-    if (srd != m_pg_whoami) {
-      shards.push_back(srd);
-    }
-  }
-  shards.push_front(m_pg_whoami);
+  const auto& shards = this_chunk->auth_candidates;
 
   auth_selection_t ret_auth;
   ret_auth.auth = this_chunk->received_maps.end();
@@ -753,6 +749,15 @@ void ScrubBackend::compare_smaps()
            << ": authoritative-set #: " << this_chunk->authoritative_set.size()
            << dendl;
 
+  // the candidate order is the same for all objects in the chunk
+  this_chunk->auth_candidates.clear();
+  this_chunk->auth_candidates.push_back(m_pg_whoami);
+  for (const auto& [srd, smap] : this_chunk->received_maps) {
+    if (srd != m_pg_whoami) {
+      this_chunk->auth_candidates.push_back(srd);
+    }
+  }
+
   std::for_each(this_chunk->authoritative_set.begin(),
                 this_chunk->authoritative_set.end(),
                 [this](const auto& ho) {
@@ -258,6 +258,10 @@ struct scrub_chunk_t {
   /// a collection of all objs mentioned in the maps
   std::set<hobject_t> authoritative_set;
 
+  /// the shards in the order they are considered as auth source: the
+  /// Primary first, then the replicas. Set once all maps are in.
+  std::vector<pg_shard_t> auth_candidates;
+
   utime_t started{ceph_clock_now()};
 
   digests_fixes_t missing_digest;
@@ -338,6 +342,22 @@ class ScrubBackend {
   objs_fix_list_t scrub_compare_maps(bool max_reached,
 				     Scrub::SnapMapReaderI& snaps_getter);
 
+  /**
+   * scrub_compare_maps(), in three steps, so that the Scrubber can run the
+   * second - the per-object comparison of the shards' versions - off the PG
+   * lock:
+   *  - prepare_compare_maps() merges the received maps and collects the omap
+   *    statistics. It reads the osdmap, and must be called under the PG lock;
+   *  - compare_chunk_maps() only touches the chunk's maps and the backend's
+   *    own error sets. Nothing else may access the backend while it runs;
+   *  - complete_compare_maps() decides on the fixes for the chunk, and must
+   *    be called under the PG lock.
+   */
+  void prepare_compare_maps();
+  void compare_chunk_maps();
+  objs_fix_list_t complete_compare_maps(bool max_reached,
+					Scrub::SnapMapReaderI& snaps_getter);
+
   int scrub_process_inconsistent();
 
   const omap_stat_t& this_scrub_omapstats() const { return m_omap_stats; }
@@ -485,7 +505,8 @@ class ScrubBackend {
   void scrub_snapshot_metadata(ScrubMap& map);
 
   /**
-   *  Updates the "global" (i.e. - not 'per-chunk') databases:
+   *  Following compare_smaps(), updates the "global" (i.e. - not 'per-chunk')
+   *  databases:
    *   - in m_authoritative: a list of good peers for each "problem" object in
    *     the current chunk;
    *   - in m_cleaned_meta_map: a "cleaned" version of the object (the one from
@@ -571,7 +571,31 @@ void Journaler::_finish_flush(int r, uint64_t start, ceph::real_time stamp)
 uint64_t Journaler::append_entry(bufferlist& bl)
 {
   unique_lock l(lock);
+  return _append_entry(bl, l);
+}
+
+void Journaler::append_entries(std::vector<bufferlist>& bls,
+			       std::function<Context*(size_t, uint64_t)> on_append)
+{
+  unique_lock l(lock);
+  for (size_t i = 0; i < bls.size(); ++i) {
+    if (bls[i].length()) {
+      _append_entry(bls[i], l);
+    }
+    Context *onsafe = on_append(i, write_pos);
+    if (!onsafe) {
+      continue;
+    }
+    if (is_stopping()) {
+      onsafe->complete(-EAGAIN);
+    } else {
+      _wait_for_flush(onsafe);
+    }
+  }
+}
 
+uint64_t Journaler::_append_entry(bufferlist& bl, unique_lock& l)
+{
   ceph_assert(!readonly);
   uint32_t s = bl.length();
 
@@ -712,6 +736,21 @@ void Journaler::wait_for_flush(Context *onsafe)
   _wait_for_flush(onsafe);
 }
 
+void Journaler::wait_for_flushed(Context *onsafe)
+{
+  lock_guard l(lock);
+  if (is_stopping()) {
+    onsafe->complete(-EAGAIN);
+    return;
+  }
+  if (pending_safe.empty()) {
+    finisher->queue(onsafe, 0);
+    return;
+  }
+  // safe_pos becomes next_safe_pos once the last of them completes
+  waitfor_safe[next_safe_pos].push_back(wrap_finisher(onsafe));
+}
+
 void Journaler::_wait_for_flush(Context *onsafe)
 {
   ceph_assert(!readonly);
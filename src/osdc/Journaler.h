@@ -57,8 +57,10 @@
 #ifndef CEPH_JOURNALER_H
 #define CEPH_JOURNALER_H
 
+#include <functional>
 #include <list>
 #include <map>
+#include <vector>
 
 #include "Objecter.h"
 #include "Filer.h"
@@ -319,6 +321,7 @@ private:
 
   void _flush(C_OnFinisher *onsafe);
   void _do_flush(unsigned amount=0);
+  uint64_t _append_entry(bufferlist& bl, unique_lock& l);
   void _finish_flush(int r, uint64_t start, ceph::real_time stamp);
   class C_Flush;
   friend class C_Flush;
@@ -457,6 +460,9 @@ public:
   void reread_head_and_probe(Context *onfinish);
   void write_head(Context *onsave=0);
   void wait_for_flush(Context *onsafe = 0);
+  // complete onsafe once the writes already issued are safe, leaving what
+  // is still buffered alone
+  void wait_for_flushed(Context *onsafe);
   void flush(Context *onsafe = 0);
   void wait_for_readable(Context *onfinish);
   void _wait_for_readable(Context *onfinish);
@@ -480,6 +486,14 @@ public:
     read_buf.clear();
   }
   uint64_t append_entry(bufferlist& bl);
+  /**
+   * Append a batch of entries, taking the lock only once.  After each of
+   * them on_append(i, write_pos) is called, and the Context it returns (if
+   * any) is completed once the journal is safe up to there.  An empty
+   * bufferlist appends nothing, but still gets its on_append call.
+   */
+  void append_entries(std::vector<bufferlist>& bls,
+		      std::function<Context*(size_t, uint64_t)> on_append);
   void set_expire_pos(uint64_t ep) {
       lock_guard l(lock);
       expire_pos = ep;
@@ -532,6 +546,7 @@ public:
   bool try_read_entry(bufferlist& bl);
   uint64_t get_write_pos() const { return write_pos; }
   uint64_t get_write_safe_pos() const { return safe_pos; }
+  uint64_t get_write_flush_pos() const { return flush_pos; }
   uint64_t get_read_pos() const { return read_pos; }
   uint64_t get_expire_pos() const { return expire_pos; }
   uint64_t get_trimmed_pos() const { return trimmed_pos; }
@@ -535,7 +535,7 @@ void Objecter::shutdown()
 }
 
 void Objecter::_send_linger(LingerOp *info,
-			    ceph::shunique_lock<ceph::shared_mutex>& sul)
+			    ceph::shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   ceph_assert(sul.owns_lock() && sul.mutex() == &rwlock);
 
@@ -869,7 +869,7 @@ ceph_tid_t Objecter::linger_notify(LingerOp *info,
 }
 
 void Objecter::_linger_submit(LingerOp *info,
-			      ceph::shunique_lock<ceph::shared_mutex>& sul)
+			      ceph::shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   ceph_assert(sul.owns_lock() && sul.mutex() == &rwlock);
   ceph_assert(info->linger_id);
@@ -1037,7 +1037,7 @@ void Objecter::_scan_requests(
   map<ceph_tid_t, Op*>& need_resend,
   list<LingerOp*>& need_resend_linger,
   map<ceph_tid_t, CommandOp*>& need_resend_command,
-  ceph::shunique_lock<ceph::shared_mutex>& sul)
+  ceph::shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   ceph_assert(sul.owns_lock() && sul.mutex() == &rwlock);
 
@@ -1209,6 +1209,8 @@ void Objecter::handle_osd_map(MOSDMap *m)
 			<< dendl;
 	  OSDMap::Incremental inc(m->incremental_maps[e]);
 	  osdmap->apply_incremental(inc);
+	  // a squashed incremental takes us past e
+	  e = osdmap->get_epoch();
 
           emit_blocklist_events(inc);
 
@@ -1567,6 +1569,7 @@ void Objecter::_check_op_pool_dne(Op *op, std::unique_lock<std::shared_mutex> *s
       ldout(cct, 10) << "check_op_pool_dne tid " << op->tid
 		     << " concluding pool " << op->target.base_pgid.pool()
 		     << " dne" << dendl;
+      _op_revoke_rx_buffer(op);
       if (op->has_completion()) {
 	num_in_flight--;
 	op->complete(osdc_errc::pool_dne, -ENOENT, service.get_executor());
@@ -1602,6 +1605,7 @@ void Objecter::_check_op_pool_eio(Op *op, std::unique_lock<std::shared_mutex> *s
   ldout(cct, 10) << "check_op_pool_eio tid " << op->tid
 		 << " concluding pool " << op->target.base_pgid.pool()
 		 << " has eio" << dendl;
+  _op_revoke_rx_buffer(op);
   if (op->has_completion()) {
     num_in_flight--;
     op->complete(osdc_errc::pool_eio, -EIO, service.get_executor());
@@ -1842,7 +1846,7 @@ void Objecter::_command_cancel_map_check(CommandOp *c)
  * promotion to write.
  */
 int Objecter::_get_session(int osd, OSDSession **session,
-			   shunique_lock<ceph::shared_mutex>& sul)
+			   shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   ceph_assert(sul && sul.mutex() == &rwlock);
 
@@ -2000,7 +2004,7 @@ void Objecter::wait_for_osd_map(epoch_t e)
 
 void Objecter::_get_latest_version(epoch_t oldest, epoch_t newest,
 				   OpCompletion fin,
-				   std::unique_lock<ceph::shared_mutex>&& l)
+				   std::unique_lock<ceph::sharded_shared_mutex>&& l)
 {
   ceph_assert(fin);
   if (osdmap->get_epoch() >= newest) {
@@ -2035,6 +2039,9 @@ void Objecter::_maybe_request_map()
       << "_maybe_request_map subscribing (onetime) to next osd map" << dendl;
     flag = CEPH_SUBSCRIBE_ONETIME;
   }
+  if (squash_osdmaps) {
+    flag |= CEPH_SUBSCRIBE_SQUASH;
+  }
   epoch_t epoch = osdmap->get_epoch() ? osdmap->get_epoch()+1 : 0;
   if (monc->sub_want("osdmap", epoch, flag)) {
     monc->renew_subs();
@@ -2123,7 +2130,7 @@ void Objecter::_kick_requests(OSDSession *session,
 }
 
 void Objecter::_linger_ops_resend(map<uint64_t, LingerOp *>& lresend,
-				  unique_lock<ceph::shared_mutex>& ul)
+				  unique_lock<ceph::sharded_shared_mutex>& ul)
 {
   ceph_assert(ul.owns_lock());
   shunique_lock sul(std::move(ul));
@@ -2283,8 +2290,19 @@ void Objecter::op_submit(Op *op, ceph_tid_t *ptid, int *ctx_budget)
   _op_submit_with_budget(op, rl, ptid, ctx_budget);
 }
 
+void Objecter::op_submit_batch(std::vector<Op*>& ops)
+{
+  shunique_lock rl(rwlock, ceph::acquire_shared);
+  for (auto op : ops) {
+    ceph_tid_t tid = 0;
+    op->trace.event("op submit");
+    _op_submit_with_budget(op, rl, &tid);
+  }
+  ops.clear();
+}
+
 void Objecter::_op_submit_with_budget(Op *op,
-				      shunique_lock<ceph::shared_mutex>& sul,
+				      shunique_lock<ceph::sharded_shared_mutex>& sul,
 				      ceph_tid_t *ptid,
 				      int *ctx_budget)
 {
@@ -2388,7 +2406,7 @@ void Objecter::_send_op_account(Op *op)
   }
 }
 
-void Objecter::_op_submit(Op *op, shunique_lock<ceph::shared_mutex>& sul, ceph_tid_t *ptid)
+void Objecter::_op_submit(Op *op, shunique_lock<ceph::sharded_shared_mutex>& sul, ceph_tid_t *ptid)
 {
   // rwlock is locked
 
@@ -2504,17 +2522,10 @@ int Objecter::op_cancel(OSDSession *s, ceph_tid_t tid, int r)
     return -ENOENT;
   }
 
-#if 0
-  if (s->con) {
-    ldout(cct, 20) << " revoking rx ceph::buffer for " << tid
-		   << " on " << s->con << dendl;
-    s->con->revoke_rx_buffer(tid);
-  }
-#endif
-
   ldout(cct, 10) << __func__ << " tid " << tid << " in session " << s->osd
 		 << dendl;
   Op *op = p->second;
+  _op_revoke_rx_buffer(op);
   if (op->has_completion()) {
     num_in_flight--;
     op->complete(osdcode(r), r, service.get_executor());
@@ -3016,7 +3027,7 @@ int Objecter::_calc_target(op_target_t *t, Connection *con, bool any_change)
 }
 
 int Objecter::_map_session(op_target_t *target, OSDSession **s,
-			   shunique_lock<ceph::shared_mutex>& sul)
+			   shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   _calc_target(target, nullptr);
   return _get_session(target->osd, s, sul);
@@ -3123,7 +3134,7 @@ void Objecter::_session_command_op_assign(OSDSession *to, CommandOp *op)
 }
 
 int Objecter::_recalc_linger_op_target(LingerOp *linger_op,
-				       shunique_lock<ceph::shared_mutex>& sul)
+				       shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   // rwlock is locked unique
 
@@ -3167,12 +3178,24 @@ void Objecter::_cancel_linger_op(Op *op)
   _finish_op(op, 0);
 }
 
+void Objecter::_op_revoke_rx_buffer(Op *op)
+{
+  if (op->con) {
+    ldout(cct, 20) << " revoking rx ceph::buffer for " << op->tid << " on "
+		   << op->con << dendl;
+    op->con->revoke_rx_buffer(op->tid);
+    op->con = nullptr;
+  }
+}
+
 void Objecter::_finish_op(Op *op, int r)
 {
   ldout(cct, 15) << __func__ << " " << op->tid << dendl;
 
   // op->session->lock is locked unique or op->session is null
 
+  _op_revoke_rx_buffer(op);
+
   if (!op->ctx_budgeted && op->budget >= 0) {
     put_op_budget_bytes(op->budget);
     op->budget = -1;
@@ -3300,23 +3323,19 @@ void Objecter::_send_op(Op *op)
   ConnectionRef con = op->session->con;
   ceph_assert(con);
 
-#if 0
   // preallocated rx ceph::buffer?
-  if (op->con) {
-    ldout(cct, 20) << " revoking rx ceph::buffer for " << op->tid << " on "
-		   << op->con << dendl;
-    op->con->revoke_rx_buffer(op->tid);
-  }
-  if (op->outbl &&
+  _op_revoke_rx_buffer(op);
+  if (cct->_conf.get_val<bool>("objecter_post_rx_buffers") &&
+      op->outbl &&
       op->ontimeout == 0 &&  // only post rx_buffer if no timeout; see #9582
-      op->outbl->length()) {
+      op->outbl->length() &&
+      op->outbl->get_num_buffers() == 1) {
     op->outbl->invalidate_crc();  // messenger writes through c_str()
     ldout(cct, 20) << " posting rx ceph::buffer for " << op->tid << " on " << con
 		   << dendl;
     op->con = con;
     op->con->post_rx_buffer(op->tid, *op->outbl);
   }
-#endif
 
   op->incarnation = op->session->incarnation;
 
@@ -3345,7 +3364,7 @@ int Objecter::calc_op_budget(const bc::small_vector_base<OSDOp>& ops)
 }
 
 void Objecter::_throttle_op(Op *op,
-			    shunique_lock<ceph::shared_mutex>& sul,
+			    shunique_lock<ceph::sharded_shared_mutex>& sul,
 			    int op_budget)
 {
   ceph_assert(sul && sul.mutex() == &rwlock);
@@ -3504,12 +3523,16 @@ void Objecter::handle_osd_op_reply(MOSDOpReply *m)
 
   // got data?
   if (op->outbl) {
-#if 0
-    if (op->con)
-      op->con->revoke_rx_buffer(op->tid);
-#endif
+    _op_revoke_rx_buffer(op);
     auto& bl = m->get_data();
     if (op->outbl->length() == bl.length() &&
+	bl.get_num_buffers() == 1 &&
+	op->outbl->get_num_buffers() == 1 &&
+	bl.front().c_str() == op->outbl->front().c_str()) {
+      // the messenger received the data straight into our buffer
+      ldout(cct,10) << __func__ << " data received in place into existing"
+		    << " ceph::buffer of length " << bl.length() << dendl;
+    } else if (op->outbl->length() == bl.length() &&
 	bl.get_num_buffers() <= 1) {
       // this is here to keep previous users to *relied* on getting data
       // read into existing buffers happy.  Notably,
@@ -4933,7 +4956,7 @@ void Objecter::submit_command(CommandOp *c, ceph_tid_t *ptid)
 }
 
 int Objecter::_calc_command_target(CommandOp *c,
-				   shunique_lock<ceph::shared_mutex>& sul)
+				   shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   ceph_assert(sul.owns_lock() && sul.mutex() == &rwlock);
 
@@ -4989,7 +5012,7 @@ int Objecter::_calc_command_target(CommandOp *c,
 }
 
 void Objecter::_assign_command_session(CommandOp *c,
-				       shunique_lock<ceph::shared_mutex>& sul)
+				       shunique_lock<ceph::sharded_shared_mutex>& sul)
 {
   ceph_assert(sul.owns_lock() && sul.mutex() == &rwlock);
 
@@ -5087,6 +5110,8 @@ Objecter::Objecter(CephContext *cct,
 {
   mon_timeout = cct->_conf.get_val<std::chrono::seconds>("rados_mon_op_timeout");
   osd_timeout = cct->_conf.get_val<std::chrono::seconds>("rados_osd_op_timeout");
+  squash_osdmaps = cct->_conf->objecter_squash_osdmaps &&
+    cct->get_module_type() == CEPH_ENTITY_TYPE_CLIENT;
 }
 
 Objecter::~Objecter()
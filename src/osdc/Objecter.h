@@ -15,6 +15,7 @@
 #ifndef CEPH_OBJECTER_H
 #define CEPH_OBJECTER_H
 
+#include <array>
 #include <condition_variable>
 #include <list>
 #include <map>
@@ -54,6 +55,7 @@
 #include "common/ceph_mutex.h"
 #include "common/ceph_timer.h"
 #include "common/config_obs.h"
+#include "common/sharded_shared_mutex.h"
 #include "common/shunique_lock.h"
 #include "common/zipkin_trace.h"
 #include "common/tracer.h"
@@ -1741,25 +1743,39 @@ private:
                : epoch(epoch), up(up), up_primary(up_primary),
                  acting(acting), acting_primary(acting_primary) {}
   };
-  ceph::shared_mutex pg_mapping_lock =
-    ceph::make_shared_mutex("Objecter::pg_mapping_lock");
-  // pool -> pg mapping
-  std::map<int64_t, std::vector<pg_mapping_t>> pg_mappings;
+  // The pg mapping cache is striped by ps so that concurrent
+  // _calc_target() callers (all holding rwlock shared) don't all bounce
+  // the same lock; shard i holds the pgs with ps % pg_mapping_shards == i
+  // at index ps / pg_mapping_shards.
+  static constexpr unsigned pg_mapping_shards = 16;
+  struct alignas(64) pg_mapping_shard_t {
+    ceph::shared_mutex lock =
+      ceph::make_shared_mutex("Objecter::pg_mapping_shard_t::lock");
+    // pool -> pg mapping
+    std::map<int64_t, std::vector<pg_mapping_t>> pg_mappings;
+  };
+  std::array<pg_mapping_shard_t, pg_mapping_shards> pg_mapping_shard;
+
+  pg_mapping_shard_t& get_pg_mapping_shard(const pg_t& pg) {
+    return pg_mapping_shard[pg.ps() % pg_mapping_shards];
+  }
 
   // convenient accessors
   bool lookup_pg_mapping(const pg_t& pg, epoch_t epoch, std::vector<int> *up,
                          int *up_primary, std::vector<int> *acting,
                          int *acting_primary) {
-    std::shared_lock l{pg_mapping_lock};
-    auto it = pg_mappings.find(pg.pool());
-    if (it == pg_mappings.end())
+    auto& shard = get_pg_mapping_shard(pg);
+    std::shared_lock l{shard.lock};
+    auto it = shard.pg_mappings.find(pg.pool());
+    if (it == shard.pg_mappings.end())
       return false;
     auto& mapping_array = it->second;
-    if (pg.ps() >= mapping_array.size())
+    const auto idx = pg.ps() / pg_mapping_shards;
+    if (idx >= mapping_array.size())
       return false;
-    if (mapping_array[pg.ps()].epoch != epoch) // stale
+    if (mapping_array[idx].epoch != epoch) // stale
       return false;
-    auto& pg_mapping = mapping_array[pg.ps()];
+    auto& pg_mapping = mapping_array[idx];
     *up = pg_mapping.up;
     *up_primary = pg_mapping.up_primary;
     *acting = pg_mapping.acting;
@@ -1767,28 +1783,37 @@ private:
     return true;
   }
   void update_pg_mapping(const pg_t& pg, pg_mapping_t&& pg_mapping) {
-    std::lock_guard l{pg_mapping_lock};
-    auto& mapping_array = pg_mappings[pg.pool()];
-    ceph_assert(pg.ps() < mapping_array.size());
-    mapping_array[pg.ps()] = std::move(pg_mapping);
+    auto& shard = get_pg_mapping_shard(pg);
+    std::lock_guard l{shard.lock};
+    auto& mapping_array = shard.pg_mappings[pg.pool()];
+    const auto idx = pg.ps() / pg_mapping_shards;
+    ceph_assert(idx < mapping_array.size());
+    mapping_array[idx] = std::move(pg_mapping);
   }
   void prune_pg_mapping(const mempool::osdmap::map<int64_t,pg_pool_t>& pools) {
-    std::lock_guard l{pg_mapping_lock};
-    for (auto& pool : pools) {
-      auto& mapping_array = pg_mappings[pool.first];
-      size_t pg_num = pool.second.get_pg_num();
-      if (mapping_array.size() != pg_num) {
-        // catch both pg_num increasing & decreasing
-        mapping_array.resize(pg_num);
+    for (unsigned i = 0; i < pg_mapping_shards; ++i) {
+      auto& shard = pg_mapping_shard[i];
+      std::lock_guard l{shard.lock};
+      for (auto& pool : pools) {
+        auto& mapping_array = shard.pg_mappings[pool.first];
+        // number of ps < pg_num with ps % pg_mapping_shards == i
+        size_t pg_num = pool.second.get_pg_num();
+        size_t n = pg_num > i ?
+          (pg_num - i + pg_mapping_shards - 1) / pg_mapping_shards : 0;
+        if (mapping_array.size() != n) {
+          // catch both pg_num increasing & decreasing
+          mapping_array.resize(n);
+        }
       }
-    }
-    for (auto it = pg_mappings.begin(); it != pg_mappings.end(); ) {
-      if (!pools.count(it->first)) {
-        // pool is gone
-        pg_mappings.erase(it++);
-        continue;
+      for (auto it = shard.pg_mappings.begin();
+           it != shard.pg_mappings.end(); ) {
+        if (!pools.count(it->first)) {
+          // pool is gone
+          shard.pg_mappings.erase(it++);
+          continue;
+        }
+        it++;
       }
-      it++;
     }
   }
 
@@ -1803,8 +1828,10 @@ private:
   version_t last_seen_osdmap_version = 0;
   version_t last_seen_pgmap_version = 0;
 
-  mutable ceph::shared_mutex rwlock =
-	   ceph::make_shared_mutex("Objecter::rwlock");
+  // taken shared by op submission and reply handling, unique only for
+  // map changes and other rare updates; sharded so that the former don't
+  // all contend on one reader count
+  mutable ceph::sharded_shared_mutex rwlock{"Objecter::rwlock"};
   ceph::timer<ceph::coarse_mono_clock> timer;
 
   PerfCounters* logger = nullptr;
@@ -2355,9 +2382,9 @@ public:
 
   void submit_command(CommandOp *c, ceph_tid_t *ptid);
   int _calc_command_target(CommandOp *c,
-			   ceph::shunique_lock<ceph::shared_mutex> &sul);
+			   ceph::shunique_lock<ceph::sharded_shared_mutex> &sul);
   void _assign_command_session(CommandOp *c,
-			       ceph::shunique_lock<ceph::shared_mutex> &sul);
+			       ceph::shunique_lock<ceph::sharded_shared_mutex> &sul);
   void _send_command(CommandOp *c);
   int command_op_cancel(OSDSession *s, ceph_tid_t tid,
 			boost::system::error_code ec);
@@ -2557,12 +2584,15 @@ public:
 
   ceph::timespan mon_timeout;
   ceph::timespan osd_timeout;
+  /// ask for squashed incrementals; daemons need to see every epoch
+  bool squash_osdmaps = false;
 
   MOSDOp *_prepare_osd_op(Op *op);
   void _send_op(Op *op);
   void _send_op_account(Op *op);
   void _cancel_linger_op(Op *op);
   void _finish_op(Op *op, int r);
+  void _op_revoke_rx_buffer(Op *op);
   static bool is_pg_changed(
     int oldprimary,
     const std::vector<int>& oldacting,
@@ -2587,7 +2617,7 @@ public:
   int _calc_target(op_target_t *t, Connection *con,
 		   bool any_change = false);
   int _map_session(op_target_t *op, OSDSession **s,
-		   ceph::shunique_lock<ceph::shared_mutex>& lc);
+		   ceph::shunique_lock<ceph::sharded_shared_mutex>& lc);
 
   void _session_op_assign(OSDSession *s, Op *op);
   void _session_op_remove(OSDSession *s, Op *op);
@@ -2596,16 +2626,16 @@ public:
   void _session_command_op_assign(OSDSession *to, CommandOp *op);
   void _session_command_op_remove(OSDSession *from, CommandOp *op);
 
-  int _assign_op_target_session(Op *op, ceph::shunique_lock<ceph::shared_mutex>& lc,
+  int _assign_op_target_session(Op *op, ceph::shunique_lock<ceph::sharded_shared_mutex>& lc,
 				bool src_session_locked,
 				bool dst_session_locked);
   int _recalc_linger_op_target(LingerOp *op,
-			       ceph::shunique_lock<ceph::shared_mutex>& lc);
+			       ceph::shunique_lock<ceph::sharded_shared_mutex>& lc);
 
   void _linger_submit(LingerOp *info,
-		      ceph::shunique_lock<ceph::shared_mutex>& sul);
+		      ceph::shunique_lock<ceph::sharded_shared_mutex>& sul);
   void _send_linger(LingerOp *info,
-		    ceph::shunique_lock<ceph::shared_mutex>& sul);
+		    ceph::shunique_lock<ceph::sharded_shared_mutex>& sul);
   void _linger_commit(LingerOp *info, boost::system::error_code ec,
 		      ceph::buffer::list& outbl);
   void _linger_reconnect(LingerOp *info, boost::system::error_code ec);
@@ -2649,10 +2679,10 @@ private:
 
   void _kick_requests(OSDSession *session, std::map<uint64_t, LingerOp *>& lresend);
   void _linger_ops_resend(std::map<uint64_t, LingerOp *>& lresend,
-			  std::unique_lock<ceph::shared_mutex>& ul);
+			  std::unique_lock<ceph::sharded_shared_mutex>& ul);
 
   int _get_session(int osd, OSDSession **session,
-		   ceph::shunique_lock<ceph::shared_mutex>& sul);
+		   ceph::shunique_lock<ceph::sharded_shared_mutex>& sul);
   void put_session(OSDSession *s);
   void get_session(OSDSession *s);
   void _reopen_session(OSDSession *session);
@@ -2670,9 +2700,9 @@ private:
    * If throttle_op needs to throttle it will unlock client_lock.
    */
   int calc_op_budget(const boost::container::small_vector_base<OSDOp>& ops);
-  void _throttle_op(Op *op, ceph::shunique_lock<ceph::shared_mutex>& sul,
+  void _throttle_op(Op *op, ceph::shunique_lock<ceph::sharded_shared_mutex>& sul,
 		    int op_size = 0);
-  int _take_op_budget(Op *op, ceph::shunique_lock<ceph::shared_mutex>& sul) {
+  int _take_op_budget(Op *op, ceph::shunique_lock<ceph::sharded_shared_mutex>& sul) {
     ceph_assert(sul && sul.mutex() == &rwlock);
     int op_budget = calc_op_budget(op->ops);
     if (keep_balanced_budget) {
@@ -2746,7 +2776,7 @@ private:
     std::map<ceph_tid_t, Op*>& need_resend,
     std::list<LingerOp*>& need_resend_linger,
     std::map<ceph_tid_t, CommandOp*>& need_resend_command,
-    ceph::shunique_lock<ceph::shared_mutex>& sul);
+    ceph::shunique_lock<ceph::sharded_shared_mutex>& sul);
 
   int64_t get_object_hash_position(int64_t pool, const std::string& key,
 				   const std::string& ns);
@@ -2831,15 +2861,17 @@ private:
                              const OSDMap &new_osd_map);
 
   // low-level
-  void _op_submit(Op *op, ceph::shunique_lock<ceph::shared_mutex>& lc,
+  void _op_submit(Op *op, ceph::shunique_lock<ceph::sharded_shared_mutex>& lc,
 		  ceph_tid_t *ptid);
   void _op_submit_with_budget(Op *op,
-			      ceph::shunique_lock<ceph::shared_mutex>& lc,
+			      ceph::shunique_lock<ceph::sharded_shared_mutex>& lc,
 			      ceph_tid_t *ptid,
 			      int *ctx_budget = NULL);
   // public interface
 public:
   void op_submit(Op *op, ceph_tid_t *ptid = NULL, int *ctx_budget = NULL);
+  /// submit independent ops taking rwlock only once for all of them
+  void op_submit_batch(std::vector<Op*>& ops);
   bool is_active() {
     std::shared_lock l(rwlock);
     return !((!inflight_ops) && linger_ops.empty() &&
@@ -2954,7 +2986,7 @@ public:
 
   void _get_latest_version(epoch_t oldest, epoch_t neweset,
 			   OpCompletion fin,
-			   std::unique_lock<ceph::shared_mutex>&& ul);
+			   std::unique_lock<ceph::sharded_shared_mutex>&& ul);
 
   /** Get the current set of global op flags */
   int get_global_op_flags() const { return global_op_flags; }
@@ -3073,12 +3105,12 @@ public:
     return tid;
   }
 
-  void mutate(const object_t& oid, const object_locator_t& oloc,
-	      ObjectOperation&& op, const SnapContext& snapc,
-	      ceph::real_time mtime, int flags,
-	      Op::OpComp oncommit,
-	      version_t *objver = NULL, osd_reqid_t reqid = osd_reqid_t(),
-	      ZTracer::Trace *parent_trace = nullptr) {
+  Op *prepare_mutate_op(const object_t& oid, const object_locator_t& oloc,
+			ObjectOperation&& op, const SnapContext& snapc,
+			ceph::real_time mtime, int flags,
+			Op::OpComp oncommit,
+			version_t *objver = NULL, osd_reqid_t reqid = osd_reqid_t(),
+			ZTracer::Trace *parent_trace = nullptr) {
     Op *o = new Op(oid, oloc, std::move(op.ops), flags | global_op_flags |
 		   CEPH_OSD_FLAG_WRITE, std::move(oncommit), objver,
 		   nullptr, parent_trace);
@@ -3091,7 +3123,18 @@ public:
     o->out_ec.swap(op.out_ec);
     o->reqid = reqid;
     op.clear();
-    op_submit(o);
+    return o;
+  }
+
+  void mutate(const object_t& oid, const object_locator_t& oloc,
+	      ObjectOperation&& op, const SnapContext& snapc,
+	      ceph::real_time mtime, int flags,
+	      Op::OpComp oncommit,
+	      version_t *objver = NULL, osd_reqid_t reqid = osd_reqid_t(),
+	      ZTracer::Trace *parent_trace = nullptr) {
+    op_submit(prepare_mutate_op(oid, oloc, std::move(op), snapc, mtime, flags,
+				std::move(oncommit), objver, reqid,
+				parent_trace));
   }
 
   void mutate(const object_t& oid, const object_locator_t& oloc,
@@ -3145,11 +3188,11 @@ public:
     return tid;
   }
 
-  void read(const object_t& oid, const object_locator_t& oloc,
-	    ObjectOperation&& op, snapid_t snapid, ceph::buffer::list *pbl,
-	    int flags, Op::OpComp onack,
-	    version_t *objver = nullptr, int *data_offset = nullptr,
-	    uint64_t features = 0, ZTracer::Trace *parent_trace = nullptr) {
+  Op *prepare_read_op(const object_t& oid, const object_locator_t& oloc,
+		      ObjectOperation&& op, snapid_t snapid, ceph::buffer::list *pbl,
+		      int flags, Op::OpComp onack,
+		      version_t *objver = nullptr, int *data_offset = nullptr,
+		      uint64_t features = 0, ZTracer::Trace *parent_trace = nullptr) {
     Op *o = new Op(oid, oloc, std::move(op.ops), flags | global_op_flags |
 		   CEPH_OSD_FLAG_READ, std::move(onack), objver,
 		   data_offset, parent_trace);
@@ -3167,7 +3210,17 @@ public:
     if (features)
       o->features = features;
     op.clear();
-    op_submit(o);
+    return o;
+  }
+
+  void read(const object_t& oid, const object_locator_t& oloc,
+	    ObjectOperation&& op, snapid_t snapid, ceph::buffer::list *pbl,
+	    int flags, Op::OpComp onack,
+	    version_t *objver = nullptr, int *data_offset = nullptr,
+	    uint64_t features = 0, ZTracer::Trace *parent_trace = nullptr) {
+    op_submit(prepare_read_op(oid, oloc, std::move(op), snapid, pbl, flags,
+			      std::move(onack), objver, data_offset, features,
+			      parent_trace));
   }
 
   void read(const object_t& oid, const object_locator_t& oloc,
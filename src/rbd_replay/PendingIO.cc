@@ -26,10 +26,14 @@ void rbd_replay_pending_io_callback(librbd::completion_t cb, void *arg) {
 }
 
 PendingIO::PendingIO(action_id_t id,
-		     ActionCtx &worker)
+		     ActionCtx &worker,
+		     bool timed)
   : m_id(id),
     m_completion(new librbd::RBD::AioCompletion(this, rbd_replay_pending_io_callback)),
-    m_worker(worker) {
+    m_worker(worker),
+    m_timed(timed),
+    m_start_time(timed ? std::chrono::steady_clock::now() :
+                 std::chrono::steady_clock::time_point{}) {
     }
 
 PendingIO::~PendingIO() {
@@ -40,5 +44,8 @@ void PendingIO::completed(librbd::completion_t cb) {
   dout(ACTION_LEVEL) << "Completed pending IO #" << m_id << dendl;
   ssize_t r = m_completion->get_return_value();
   assertf(r >= 0, "id = %d, r = %d", m_id, r);
+  if (m_timed) {
+    m_worker.record_io_latency(std::chrono::steady_clock::now() - m_start_time);
+  }
   m_worker.remove_pending(shared_from_this());
 }
@@ -31,8 +31,13 @@ class PendingIO : public boost::enable_shared_from_this<PendingIO> {
 public:
   typedef boost::shared_ptr<PendingIO> ptr;
 
+  /**
+     @param timed whether the completion latency is recorded, which only
+     makes sense for data %IO
+  */
   PendingIO(action_id_t id,
-            ActionCtx &worker);
+            ActionCtx &worker,
+            bool timed = true);
 
   ~PendingIO();
 
@@ -57,6 +62,8 @@ private:
   ceph::bufferlist m_bl;
   librbd::RBD::AioCompletion *m_completion;
   ActionCtx &m_worker;
+  const bool m_timed;
+  const std::chrono::steady_clock::time_point m_start_time;
 };
 
 }
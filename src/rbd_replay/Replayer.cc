@@ -22,6 +22,8 @@
 #include <condition_variable>
 #include <thread>
 #include <fstream>
+#include <algorithm>
+#include <limits>
 #include "global/global_context.h"
 #include "rbd_replay_debug.hpp"
 
@@ -114,6 +116,10 @@ void Worker::run() {
 }
 
 
+void Worker::record_io_latency(std::chrono::nanoseconds latency) {
+  m_replayer.record_io_latency(latency);
+}
+
 void Worker::remove_pending(PendingIO::ptr io) {
   ceph_assert(io);
   m_replayer.set_action_complete(io->id());
@@ -168,6 +174,7 @@ Replayer::Replayer(int num_action_trackers)
   : m_rbd(NULL), m_ioctx(0),
     m_latency_multiplier(1.0),
     m_readonly(false), m_dump_perf_counters(false),
+    m_print_latency_summary(false),
     m_num_action_trackers(num_action_trackers),
     m_action_trackers(new action_tracker_d[m_num_action_trackers]) {
   assertf(num_action_trackers > 0, "num_action_trackers = %d", num_action_trackers);
@@ -272,6 +279,9 @@ void Replayer::run(const std::string& replay_file) {
 	delete w.second;
       }
       clear_images();
+      if (m_print_latency_summary) {
+	print_latency_summary();
+      }
       delete m_rbd;
       m_rbd = NULL;
     }
@@ -386,6 +396,40 @@ void Replayer::clear_images() {
   m_images.clear();
 }
 
+void Replayer::record_io_latency(std::chrono::nanoseconds latency) {
+  if (!m_print_latency_summary) {
+    return;
+  }
+  auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  std::scoped_lock lock{m_io_latencies_mutex};
+  m_io_latencies.push_back(static_cast<uint32_t>(
+    std::min<int64_t>(micros, std::numeric_limits<uint32_t>::max())));
+}
+
+void Replayer::print_latency_summary() {
+  std::scoped_lock lock{m_io_latencies_mutex};
+  cout << "Completed IOs: " << m_io_latencies.size() << std::endl;
+  if (m_io_latencies.empty()) {
+    return;
+  }
+  std::sort(m_io_latencies.begin(), m_io_latencies.end());
+  uint64_t total = 0;
+  for (auto l : m_io_latencies) {
+    total += l;
+  }
+  auto percentile = [this](double p) {
+    size_t idx = static_cast<size_t>(p / 100.0 * (m_io_latencies.size() - 1) + 0.5);
+    return m_io_latencies[idx];
+  };
+  cout << "IO latency (us): avg " << total / m_io_latencies.size()
+       << " min " << m_io_latencies.front()
+       << " p50 " << percentile(50)
+       << " p90 " << percentile(90)
+       << " p99 " << percentile(99)
+       << " p99.9 " << percentile(99.9)
+       << " max " << m_io_latencies.back() << std::endl;
+}
+
 void Replayer::set_latency_multiplier(float f) {
   assertf(f >= 0, "f = %f", f);
   m_latency_multiplier = f;
@@ -18,6 +18,7 @@
 #include <chrono>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <condition_variable>
 #include "rbd_replay/ActionTypes.h"
 #include "BoundedBuffer.hpp"
@@ -60,6 +61,8 @@ public:
 
   void set_action_complete(action_id_t id) override;
 
+  void record_io_latency(std::chrono::nanoseconds latency) override;
+
   bool readonly() const override;
 
   rbd_loc map_image_name(std::string image_name, std::string snap_name) const override;
@@ -105,6 +108,8 @@ public:
 
   void wait_for_actions(const action::Dependencies &deps);
 
+  void record_io_latency(std::chrono::nanoseconds latency);
+
   std::string pool_name() const;
 
   void set_pool_name(std::string pool_name);
@@ -123,6 +128,10 @@ public:
     m_dump_perf_counters = dump_perf_counters;
   }
 
+  void set_print_latency_summary(bool print_latency_summary) {
+    m_print_latency_summary = print_latency_summary;
+  }
+
   const ImageNameMap &image_name_map() const {
     return m_image_name_map;
   }
@@ -137,6 +146,8 @@ private:
 
   void clear_images();
 
+  void print_latency_summary();
+
   action_tracker_d &tracker_for(action_id_t id);
 
   /// Disallow copying
@@ -151,6 +162,11 @@ private:
   bool m_readonly;
   ImageNameMap m_image_name_map;
   bool m_dump_perf_counters;
+  bool m_print_latency_summary;
+
+  /// Completion latency of every replayed %IO, in microseconds
+  std::vector<uint32_t> m_io_latencies;
+  std::mutex m_io_latencies_mutex;
 
   std::map<imagectx_id_t, librbd::Image*> m_images;
   std::shared_mutex m_images_mutex;
@@ -187,7 +187,7 @@ void DiscardAction::perform(ActionCtx &worker) {
 
 void OpenImageAction::perform(ActionCtx &worker) {
   dout(ACTION_LEVEL) << "Performing " << *this << dendl;
-  PendingIO::ptr io(new PendingIO(pending_io_id(), worker));
+  PendingIO::ptr io(new PendingIO(pending_io_id(), worker, false));
   worker.add_pending(io);
   librbd::Image *image = new librbd::Image();
   librbd::RBD *rbd = worker.rbd();
@@ -219,7 +219,7 @@ void CloseImageAction::perform(ActionCtx &worker) {
 void AioOpenImageAction::perform(ActionCtx &worker) {
   dout(ACTION_LEVEL) << "Performing " << *this << dendl;
   // TODO: Make it async
-  PendingIO::ptr io(new PendingIO(pending_io_id(), worker));
+  PendingIO::ptr io(new PendingIO(pending_io_id(), worker, false));
   worker.add_pending(io);
   librbd::Image *image = new librbd::Image();
   librbd::RBD *rbd = worker.rbd();
@@ -20,6 +20,7 @@
 #include "common/Formatter.h"
 #include "rbd_replay/ActionTypes.h"
 #include "rbd_loc.hpp"
+#include <chrono>
 #include <iostream>
 
 // Stupid Doxygen requires this or else the typedef docs don't appear anywhere.
@@ -75,6 +76,11 @@ public:
 
   virtual void set_action_complete(action_id_t id) = 0;
 
+  /**
+     Records the time between submitting an %IO and its completion.
+   */
+  virtual void record_io_latency(std::chrono::nanoseconds latency) = 0;
+
   virtual void stop() = 0;
 
   /**
@@ -41,6 +41,8 @@ static void usage(const char* program) {
   cout << "  --read-only                     Only perform non-destructive operations." << std::endl;
   cout << "  --map-image <rule>              Add a rule to map image names in the trace to" << std::endl;
   cout << "                                  image names in the replay cluster." << std::endl;
+  cout << "  --latency-summary               Print IO completion latency percentiles" << std::endl;
+  cout << "                                  to standard out when the replay finishes." << std::endl;
   cout << "  --dump-perf-counters            *Experimental*" << std::endl;
   cout << "                                  Dump performance counters to standard out before" << std::endl;
   cout << "                                  an image is closed. Performance counters may be dumped" << std::endl;
@@ -75,6 +77,7 @@ int main(int argc, const char **argv) {
   std::string val;
   std::ostringstream err;
   bool dump_perf_counters = false;
+  bool latency_summary = false;
   for (i = args.begin(); i != args.end(); ) {
     if (ceph_argparse_double_dash(args, i)) {
       break;
@@ -98,6 +101,8 @@ int main(int argc, const char **argv) {
       }
     } else if (ceph_argparse_flag(args, i, "--dump-perf-counters", (char*)NULL)) {
       dump_perf_counters = true;
+    } else if (ceph_argparse_flag(args, i, "--latency-summary", (char*)NULL)) {
+      latency_summary = true;
     } else if (get_remainder(*i, "-")) {
       cerr << "Unrecognized argument: " << *i << std::endl;
       return 1;
@@ -125,5 +130,6 @@ int main(int argc, const char **argv) {
   replayer.set_readonly(readonly);
   replayer.set_image_name_map(image_name_map);
   replayer.set_dump_perf_counters(dump_perf_counters);
+  replayer.set_print_latency_summary(latency_summary);
   replayer.run(replay_file);
 }
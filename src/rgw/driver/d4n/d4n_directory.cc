@@ -24,6 +24,58 @@ std::string RGWBlockDirectory::buildIndex(cache_block *ptr) {
   return "rgw-object:" + ptr->c_obj.obj_name + ":directory";
 }
 
+bool RGWBlockDirectory::cache_lookup(const std::string& key, cache_block *ptr) {
+  if (cache_ttl == ceph::timespan::zero()) {
+    return false;
+  }
+
+  std::lock_guard l{cache_lock};
+  auto i = cache.find(key);
+  if (i == cache.end()) {
+    return false;
+  }
+  if (i->second.expires <= ceph::coarse_mono_clock::now()) {
+    cache.erase(i);
+    return false;
+  }
+  ptr->size_in_bytes = i->second.block.size_in_bytes;
+  ptr->c_obj.bucket_name = i->second.block.c_obj.bucket_name;
+  ptr->c_obj.obj_name = i->second.block.c_obj.obj_name;
+  return true;
+}
+
+void RGWBlockDirectory::cache_insert(const std::string& key, const cache_block *ptr) {
+  if (cache_ttl == ceph::timespan::zero()) {
+    return;
+  }
+
+  const auto now = ceph::coarse_mono_clock::now();
+  std::lock_guard l{cache_lock};
+  if (cache.size() >= cache_size && !cache.count(key)) {
+    /* drop the expired entries first, and any entry if that is not enough */
+    std::erase_if(cache, [now](const auto& e) { return e.second.expires <= now; });
+    if (cache.size() >= cache_size && !cache.empty()) {
+      cache.erase(cache.begin());
+    }
+  }
+  if (cache_size == 0) {
+    return;
+  }
+  auto& e = cache[key];
+  e.block.size_in_bytes = ptr->size_in_bytes;
+  e.block.c_obj = ptr->c_obj;
+  e.expires = now + cache_ttl;
+}
+
+void RGWBlockDirectory::cache_erase(const std::string& key) {
+  if (cache_ttl == ceph::timespan::zero()) {
+    return;
+  }
+
+  std::lock_guard l{cache_lock};
+  cache.erase(key);
+}
+
 int RGWBlockDirectory::existKey(std::string key) {
   int result = -1;
   std::vector<std::string> keys;
@@ -83,18 +135,26 @@ int RGWBlockDirectory::setValue(cache_block *ptr) {
     client.sync_commit(std::chrono::milliseconds(1000));
     
     if (result != "OK") {
+      cache_erase(key);
       return -1;
     }
   } catch(std::exception &e) {
+    cache_erase(key);
     return -1;
   }
 
+  cache_insert(key, ptr);
   return 0;
 }
 
 int RGWBlockDirectory::getValue(cache_block *ptr) {
   std::string key = buildIndex(ptr);
 
+  if (cache_lookup(key, ptr)) {
+    dout(20) << "RGW D4N Directory: Block found in local directory cache." << dendl;
+    return 0;
+  }
+
   if (!client.is_connected()) {
     findClient(&client);
   }
@@ -140,6 +200,7 @@ int RGWBlockDirectory::getValue(cache_block *ptr) {
       ptr->size_in_bytes = std::stoi(size);
       ptr->c_obj.bucket_name = bucket_name;
       ptr->c_obj.obj_name = obj_name;
+      cache_insert(key, ptr);
     } catch(std::exception &e) {
       return -1;
     }
@@ -153,6 +214,7 @@ int RGWBlockDirectory::delValue(cache_block *ptr) {
   std::vector<std::string> keys;
   std::string key = buildIndex(ptr);
   keys.push_back(key);
+  cache_erase(key);
   
   if (!client.is_connected()) {
     findClient(&client);
@@ -5,6 +5,9 @@
 #include <cpp_redis/cpp_redis>
 #include <string>
 #include <iostream>
+#include <unordered_map>
+#include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 
 struct cache_obj {
   std::string bucket_name; /* s3 bucket name */
@@ -32,6 +35,8 @@ class RGWBlockDirectory: RGWDirectory {
       cct = _cct;
       host = cct->_conf->rgw_d4n_host;
       port = cct->_conf->rgw_d4n_port;
+      cache_ttl = cct->_conf.get_val<std::chrono::seconds>("rgw_d4n_directory_cache_ttl");
+      cache_size = cct->_conf.get_val<uint64_t>("rgw_d4n_directory_cache_size");
     }
 	
     int findClient(cpp_redis::client *client);
@@ -48,6 +53,21 @@ class RGWBlockDirectory: RGWDirectory {
     std::string buildIndex(cache_block *ptr);
     std::string host = "";
     int port = 0;
+
+    /* entries are leased from the directory for cache_ttl, lookups that hit
+     * an unexpired entry do not go to the directory host */
+    struct cached_entry {
+      cache_block block;
+      ceph::coarse_mono_time expires;
+    };
+    ceph::mutex cache_lock = ceph::make_mutex("RGWBlockDirectory::cache_lock");
+    std::unordered_map<std::string, cached_entry> cache;
+    ceph::timespan cache_ttl = ceph::timespan::zero();
+    uint64_t cache_size = 0;
+
+    bool cache_lookup(const std::string& key, cache_block *ptr);
+    void cache_insert(const std::string& key, const cache_block *ptr);
+    void cache_erase(const std::string& key);
 };
 
 #endif
@@ -636,6 +636,18 @@ void *SQLiteDB::openDB(const DoutPrefixProvider *dpp)
 
   exec(dpp, "PRAGMA foreign_keys=ON", NULL);
 
+  {
+    // with the default rollback journal every transaction syncs both the
+    // journal and the database file; in wal mode a commit only appends to
+    // (and syncs) the log, and readers do not block the writer
+    const string journal_mode = "PRAGMA journal_mode=" +
+        cct->_conf.get_val<std::string>("dbstore_sqlite_journal_mode");
+    exec(dpp, journal_mode.c_str(), NULL);
+    const string synchronous = "PRAGMA synchronous=" +
+        cct->_conf.get_val<std::string>("dbstore_sqlite_synchronous");
+    exec(dpp, synchronous.c_str(), NULL);
+  }
+
 out:
   return db;
 }
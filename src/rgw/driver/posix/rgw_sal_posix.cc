@@ -1960,19 +1960,15 @@ int POSIXObject::read(int64_t ofs, int64_t left, bufferlist& bl,
 {
   if (!shadow) {
     // Normal file, just read it
-    int64_t len = std::min(left + 1, READ_SIZE);
+    static const int64_t read_size = std::max<int64_t>(
+      g_conf().get_val<Option::size_t>("rgw_posix_read_size"), READ_SIZE);
+    int64_t len = std::min(left + 1, read_size);
     ssize_t ret;
 
-    ret = lseek(obj_fd, ofs, SEEK_SET);
-    if (ret < 0) {
-      ret = errno;
-      ldpp_dout(dpp, 0) << "ERROR: could not seek object " << get_name() << " to "
-	<< ofs << " :" << cpp_strerror(ret) << dendl;
-      return -ret;
-    }
-
-    char read_buf[READ_SIZE];
-    ret = ::read(obj_fd, read_buf, len);
+    // read straight into the buffer handed to the caller, without seeking
+    // and copying through a small stack buffer
+    bufferptr bp = buffer::create(len);
+    ret = ::pread(obj_fd, bp.c_str(), len, ofs);
     if (ret < 0) {
       ret = errno;
       ldpp_dout(dpp, 0) << "ERROR: could not read object " << get_name() << ": "
@@ -1980,7 +1976,8 @@ int POSIXObject::read(int64_t ofs, int64_t left, bufferlist& bl,
       return -ret;
     }
 
-    bl.append(read_buf, ret);
+    bp.set_length(ret);
+    bl.append(std::move(bp));
 
     return ret;
   }
@@ -2020,8 +2017,6 @@ int POSIXObject::write(int64_t ofs, bufferlist& bl, const DoutPrefixProvider* dp
     return -EINVAL;
   }
 
-  int64_t left = bl.length();
-  char* curp = bl.c_str();
   ssize_t ret;
 
   ret = fchmod(obj_fd, S_IRUSR|S_IWUSR);
@@ -2031,26 +2026,24 @@ int POSIXObject::write(int64_t ofs, bufferlist& bl, const DoutPrefixProvider* dp
     return ret;
   }
 
+  // write each buffer as it is rather than rebuilding the bufferlist into
+  // one contiguous buffer first
+  for (const auto& bp : bl.buffers()) {
+    const char* curp = bp.c_str();
+    int64_t left = bp.length();
+    while (left > 0) {
+      ret = ::pwrite(obj_fd, curp, left, ofs);
+      if (ret < 0) {
+	ret = errno;
+	ldpp_dout(dpp, 0) << "ERROR: could not write object " << get_name() << ": "
+	  << cpp_strerror(ret) << dendl;
+	return -ret;
+      }
 
-  ret = lseek(obj_fd, ofs, SEEK_SET);
-  if (ret < 0) {
-    ret = errno;
-    ldpp_dout(dpp, 0) << "ERROR: could not seek object " << get_name() << " to "
-      << ofs << " :" << cpp_strerror(ret) << dendl;
-    return -ret;
-  }
-
-  while (left > 0) {
-    ret = ::write(obj_fd, curp, left);
-    if (ret < 0) {
-      ret = errno;
-      ldpp_dout(dpp, 0) << "ERROR: could not write object " << get_name() << ": "
-	<< cpp_strerror(ret) << dendl;
-      return -ret;
+      curp += ret;
+      left -= ret;
+      ofs += ret;
     }
-
-    curp += ret;
-    left -= ret;
   }
 
   return 0;
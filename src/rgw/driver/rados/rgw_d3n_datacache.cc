@@ -99,6 +99,14 @@ void D3nDataCache::init(CephContext *_cct) {
   if (conf_eviction_policy == "random")
     eviction_policy = _eviction_policy::RANDOM;
 
+  auto conf_admission_policy = cct->_conf.get_val<std::string>("rgw_d3n_l1_admission_policy");
+  if (conf_admission_policy == "tinylfu") {
+    admission_policy = _admission_policy::TINYLFU;
+    // track a few times as many chunks as fit in the cache
+    const uint64_t chunk_size = std::max<uint64_t>(cct->_conf->rgw_obj_stripe_size, 1);
+    frequency.init(4 * (free_data_cache_size / chunk_size));
+  }
+
 #if defined(HAVE_LIBAIO) && defined(__GLIBC__)
   // libaio setup
   struct aioinit ainit{0};
@@ -249,6 +257,12 @@ void D3nDataCache::put(bufferlist& bl, unsigned int len, std::string& oid)
     _outstanding_write_size = outstanding_write_size;
   }
   ldout(cct, 20) << "D3nDataCache: Before eviction _free_data_cache_size:" << _free_data_cache_size << ", _outstanding_write_size:" << _outstanding_write_size << ", freed_size:" << freed_size << dendl;
+  if (len > (_free_data_cache_size - _outstanding_write_size) && !admit(oid)) {
+    ldout(cct, 20) << "D3nDataCache: " << __func__ << "(): not admitting oid=" << oid << ", read less often than the eviction candidates" << dendl;
+    const std::lock_guard l(d3n_cache_lock);
+    d3n_outstanding_write_list.erase(oid);
+    return;
+  }
   while (len > (_free_data_cache_size - _outstanding_write_size + freed_size)) {
     ldout(cct, 20) << "D3nDataCache: enter eviction" << dendl;
     if (eviction_policy == _eviction_policy::LRU) {
@@ -281,10 +295,26 @@ void D3nDataCache::put(bufferlist& bl, unsigned int len, std::string& oid)
   outstanding_write_size += len;
 }
 
+bool D3nDataCache::admit(const string& oid)
+{
+  if (admission_policy == _admission_policy::ALL) {
+    return true;
+  }
+  const std::lock_guard l(d3n_cache_lock);
+  const std::lock_guard le(d3n_eviction_lock);
+  if (tail == nullptr) {
+    return true;
+  }
+  return frequency.estimate(oid) > frequency.estimate(tail->oid);
+}
+
 bool D3nDataCache::get(const string& oid, const off_t len)
 {
   const std::lock_guard l(d3n_cache_lock);
   bool exist = false;
+  if (admission_policy == _admission_policy::TINYLFU) {
+    frequency.record(oid);
+  }
   string location = cache_location + url_encode(oid, true);
 
   lsubdout(g_ceph_context, rgw_datacache, 20) << "D3nDataCache: " << __func__ << "(): location=" << location << dendl;
@@ -58,6 +58,62 @@ struct D3nCacheAioWriteRequest {
   }
 };
 
+/* count-min sketch of how often chunks were read recently, for the
+ * tinylfu admission policy. Counters saturate at 15 and are all halved
+ * once there have been ten samples per counter row slot, so the
+ * estimate favors recent popularity */
+class D3nFrequencySketch {
+  static constexpr unsigned depth = 4;
+  static constexpr uint8_t max_count = 15;
+  std::vector<uint8_t> table;
+  size_t width_mask = 0;
+  uint64_t samples = 0;
+  uint64_t sample_limit = 0;
+
+  template <typename F>
+  void for_each_slot(const std::string& key, F&& f) {
+    const uint64_t h1 = std::hash<std::string>{}(key);
+    const uint64_t h2 = ((h1 * 0x9e3779b97f4a7c15ull) >> 32) | 1;
+    for (unsigned i = 0; i < depth; ++i) {
+      f(table[i * (width_mask + 1) + ((h1 + i * h2) & width_mask)]);
+    }
+  }
+
+public:
+  void init(size_t entries) {
+    size_t width = 1;
+    while (width < std::max<size_t>(entries, 64)) {
+      width <<= 1;
+    }
+    table.assign(depth * width, 0);
+    width_mask = width - 1;
+    samples = 0;
+    sample_limit = 10 * width;
+  }
+
+  void record(const std::string& key) {
+    for_each_slot(key, [](uint8_t& c) {
+      if (c < max_count) {
+        ++c;
+      }
+    });
+    if (++samples >= sample_limit) {
+      for (auto& c : table) {
+        c >>= 1;
+      }
+      samples /= 2;
+    }
+  }
+
+  unsigned estimate(const std::string& key) {
+    unsigned count = max_count;
+    for_each_slot(key, [&count](uint8_t& c) {
+      count = std::min<unsigned>(count, c);
+    });
+    return count;
+  }
+};
+
 struct D3nDataCache {
 
 private:
@@ -75,6 +131,10 @@ private:
   enum class _eviction_policy {
     LRU=0, RANDOM=1
   } eviction_policy;
+  enum class _admission_policy {
+    ALL=0, TINYLFU=1
+  } admission_policy = _admission_policy::ALL;
+  D3nFrequencySketch frequency; // protected by d3n_cache_lock
 
   struct sigaction action;
   uint64_t free_data_cache_size = 0;
@@ -84,6 +144,7 @@ private:
 
 private:
   void add_io();
+  bool admit(const std::string& oid);
 
 public:
   D3nDataCache();
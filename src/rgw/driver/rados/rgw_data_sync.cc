@@ -4205,6 +4205,40 @@ public:
   }
 };
 
+/* result of a bilog page listed while the previous one is being synced */
+struct BucketIndexLogPrefetch {
+  string marker;
+  bilog_list_result result;
+  int ret{0};
+  bool done{false};
+};
+
+class RGWPrefetchBucketIndexLogCR : public RGWCoroutine {
+  RGWDataSyncCtx *sc;
+  const rgw_bucket_shard bs;
+  uint64_t generation;
+  std::shared_ptr<BucketIndexLogPrefetch> prefetch;
+
+public:
+  RGWPrefetchBucketIndexLogCR(RGWDataSyncCtx *_sc, const rgw_bucket_shard& bs,
+                              uint64_t generation,
+                              std::shared_ptr<BucketIndexLogPrefetch> prefetch)
+    : RGWCoroutine(_sc->cct), sc(_sc), bs(bs), generation(generation),
+      prefetch(std::move(prefetch)) {}
+
+  int operate(const DoutPrefixProvider *dpp) override {
+    reenter(this) {
+      yield call(new RGWListBucketIndexLogCR(sc, bs, prefetch->marker,
+                                             generation, &prefetch->result));
+      /* the error is for whoever picks the result up */
+      prefetch->ret = retcode;
+      prefetch->done = true;
+      return set_cr_done();
+    }
+    return 0;
+  }
+};
+
 #define BUCKET_SYNC_UPDATE_MARKER_WINDOW 10
 
 class RGWBucketFullSyncMarkerTrack : public RGWSyncShardMarkerTrack<rgw_obj_key, rgw_obj_key> {
@@ -4891,6 +4925,11 @@ class RGWBucketShardIncrementalSyncCR : public RGWCoroutine {
   int sync_status{0};
   bool syncstopped{false};
 
+  /* the next bilog page, listed while this one syncs */
+  std::shared_ptr<BucketIndexLogPrefetch> prefetch;
+  bool prefetched{false};
+  int child_ret{0};
+
   RGWSyncTraceNodeRef tn;
   RGWBucketIncSyncShardMarkerTrack marker_tracker;
 
@@ -4952,7 +4991,33 @@ int RGWBucketShardIncrementalSyncCR::operate(const DoutPrefixProvider *dpp)
       }
       tn->log(20, SSTR("listing bilog for incremental sync; position=" << sync_info.inc_marker.position));
       set_status() << "listing bilog; position=" << sync_info.inc_marker.position;
-      yield call(new RGWListBucketIndexLogCR(sc, bs, sync_info.inc_marker.position, generation, &extended_result));
+      prefetched = false;
+      if (prefetch) {
+        /* collect whatever else completes while waiting */
+        while (!prefetch->done) {
+          yield wait_for_child();
+          for (bool again = true; again; ) {
+            again = collect(&child_ret, nullptr);
+            if (child_ret < 0) {
+              tn->log(10, "a sync operation returned error");
+              sync_status = child_ret;
+            }
+          }
+        }
+        if (prefetch->ret >= 0 &&
+            prefetch->marker == sync_info.inc_marker.position) {
+          extended_result = std::move(prefetch->result);
+          retcode = prefetch->ret;
+          prefetched = true;
+        }
+        prefetch.reset();
+        if (sync_status != 0) {
+          break;
+        }
+      }
+      if (!prefetched) {
+        yield call(new RGWListBucketIndexLogCR(sc, bs, sync_info.inc_marker.position, generation, &extended_result));
+      }
       if (retcode < 0 && retcode != -ENOENT) {
         /* wait for all operations to complete */
         drain_all();
@@ -5000,6 +5065,18 @@ int RGWBucketShardIncrementalSyncCR::operate(const DoutPrefixProvider *dpp)
         }
       }
 
+      if (truncated && !syncstopped && !list_result.empty()) {
+        /* list the next page while this one syncs; it starts where the
+         * position will be once every entry here has been handled */
+        prefetch = std::make_shared<BucketIndexLogPrefetch>();
+        {
+          const auto& last_id = list_result.back().id;
+          ssize_t p = last_id.find('#');
+          prefetch->marker = p < 0 ? last_id : last_id.substr(p + 1);
+        }
+        spawn(new RGWPrefetchBucketIndexLogCR(sc, bs, generation, prefetch), false);
+      }
+
       entries_iter = list_result.begin();
       for (; entries_iter != entries_end; ++entries_iter) {
         if (lease_cr && !lease_cr->is_locked()) {
@@ -352,6 +352,7 @@ class RGWGCIOManager {
     string oid;
     int index{-1};
     string tag;
+    ceph::mono_time start{ceph::mono_clock::now()};
   };
 
   deque<IO> ios;
@@ -363,12 +364,40 @@ class RGWGCIOManager {
 
 #define MAX_AIO_DEFAULT 10
   size_t max_aio{MAX_AIO_DEFAULT};
+  /* the window of tail ios moves between these, following how long
+   * the osds take to complete them */
+  size_t min_aio{MAX_AIO_DEFAULT};
+  size_t limit_aio{0};
+  ceph::timespan best_latency{ceph::timespan::zero()};
+
+  void adapt_window(ceph::timespan latency) {
+    if (limit_aio <= min_aio) {
+      return;
+    }
+    if (best_latency == ceph::timespan::zero() || latency < best_latency) {
+      best_latency = latency;
+    } else {
+      /* let the floor follow a slower cluster, if slowly */
+      best_latency += (latency - best_latency) / 64;
+    }
+    if (latency < best_latency * 2) {
+      if (max_aio < limit_aio) {
+        ++max_aio;
+      }
+    } else if (latency > best_latency * 4) {
+      max_aio = std::max(min_aio, max_aio / 2);
+      ldpp_dout(dpp, 20) << "RGWGC::" << __func__ << " latency " << latency
+        << " shrinks io window to " << max_aio << dendl;
+    }
+  }
 
 public:
   RGWGCIOManager(const DoutPrefixProvider* _dpp, CephContext *_cct, RGWGC *_gc) : dpp(_dpp),
                                                                                   cct(_cct),
                                                                                   gc(_gc) {
     max_aio = cct->_conf->rgw_gc_max_concurrent_io;
+    min_aio = max_aio;
+    limit_aio = cct->_conf.get_val<uint64_t>("rgw_gc_max_concurrent_io_limit");
     remove_tags.resize(min(static_cast<int>(cct->_conf->rgw_gc_max_objs), rgw_shards_max()));
     tag_io_size.resize(min(static_cast<int>(cct->_conf->rgw_gc_max_objs), rgw_shards_max()));
   }
@@ -410,6 +439,10 @@ public:
     int ret = io.c->get_return_value();
     io.c->release();
 
+    if (io.type == IO::TailIO) {
+      adapt_window(ceph::mono_clock::now() - io.start);
+    }
+
     if (ret == -ENOENT) {
       ret = 0;
     }
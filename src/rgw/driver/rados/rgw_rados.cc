@@ -795,11 +795,57 @@ class RGWIndexCompletionManager {
   // around back to 0 without issue
   std::atomic<uint32_t> cur_shard {0};
 
+  // completions headed to an index shard object that already has a batch
+  // in flight wait here, and are sent together once that one is done
+  using batch_key = std::pair<int64_t, std::string>; // pool, oid
+  struct batch_queue {
+    rgw_rados_ref ref;
+    std::vector<complete_op_data*> queued;
+  };
+  // shared with the batches in flight, whose callbacks may come after
+  // stop() gave up on waiting for them
+  struct batch_state_t {
+    ceph::mutex lock = ceph::make_mutex("RGWIndexCompletionManager::batch_lock");
+    ceph::condition_variable cond;
+    std::map<batch_key, batch_queue> queues; // one per batch in flight
+    bool stop{false};
+    bool abandoned{false}; // stop() returned, the manager may be gone
+    unsigned handling{0}; // callbacks still using the manager
+  };
+  std::shared_ptr<batch_state_t> batches = std::make_shared<batch_state_t>();
+  static constexpr auto batch_stop_timeout = std::chrono::seconds(30);
+  friend struct complete_batch_data;
+
   void process();
   
   void add_completion(complete_op_data *completion);
+
+  void send_batch(const batch_key& key, rgw_rados_ref& ref,
+                  std::vector<complete_op_data*>&& entries);
+  void send_single(rgw_rados_ref& ref, complete_op_data *c);
   
   void stop() {
+    std::vector<complete_op_data*> cancel;
+    {
+      std::unique_lock l{batches->lock};
+      batches->stop = true;
+      if (!batches->cond.wait_for(l, batch_stop_timeout,
+                                  [this] { return batches->queues.empty(); })) {
+        ldout(ctx(), 0) << "WARNING: " << __func__ << "(): "
+            << batches->queues.size() << " batches of completions still in "
+            << "flight after " << batch_stop_timeout.count() << "s" << dendl;
+        // the replies of those finish their own entries once they come in,
+        // and those still waiting behind them are ours to cancel
+        for (auto& [key, q] : batches->queues) {
+          cancel.insert(cancel.end(), q.queued.begin(), q.queued.end());
+          q.queued.clear();
+        }
+      }
+    }
+    for (auto c : cancel) {
+      finish_completion(c, -ECANCELED);
+    }
+
     if (retry_thread.joinable()) {
       _stop = true;
       cond.notify_all();
@@ -812,6 +858,13 @@ class RGWIndexCompletionManager {
         c->stop();
       }
     }
+    {
+      // the entries of the batches still in flight are stopped now, so
+      // their callbacks can free them without us
+      std::unique_lock l{batches->lock};
+      batches->abandoned = true;
+      batches->cond.wait(l, [this] { return batches->handling == 0; });
+    }
     completions.clear();
   }
   
@@ -847,7 +900,15 @@ public:
                          rgw_zone_set *zones_trace,
                          complete_op_data **result);
 
-  bool handle_completion(completion_t cb, complete_op_data *arg);
+  bool handle_completion(int r, complete_op_data *arg);
+  void finish_completion(complete_op_data *completion, int r);
+
+  // sends the completion along with the others that come in for the same
+  // bucket index shard while an earlier batch is in flight
+  void queue_batched(const rgw_rados_ref& ref, complete_op_data *completion);
+  void handle_batch_completion(const batch_key& key,
+                               std::vector<complete_op_data*>&& entries,
+                               int r);
 
   CephContext* ctx() {
     return store->ctx();
@@ -857,19 +918,179 @@ public:
 static void obj_complete_cb(completion_t cb, void *arg)
 {
   complete_op_data *completion = reinterpret_cast<complete_op_data*>(arg);
+  completion->manager->finish_completion(completion,
+                                         rados_aio_get_return_value(cb));
+}
+
+struct complete_batch_data {
+  RGWIndexCompletionManager *manager;
+  std::shared_ptr<RGWIndexCompletionManager::batch_state_t> state;
+  std::pair<int64_t, std::string> key;
+  std::vector<complete_op_data*> entries;
+};
+
+static void batch_complete_cb(completion_t cb, void *arg)
+{
+  std::unique_ptr<complete_batch_data> batch{
+    reinterpret_cast<complete_batch_data*>(arg)};
+  const int r = rados_aio_get_return_value(cb);
+  auto& state = *batch->state;
+  {
+    std::lock_guard l{state.lock};
+    if (state.abandoned) {
+      // stop() marked the entries stopped, so this only frees them
+      for (auto c : batch->entries) {
+        delete c;
+      }
+      return;
+    }
+    ++state.handling;
+  }
+  batch->manager->handle_batch_completion(batch->key,
+                                          std::move(batch->entries), r);
+  std::lock_guard l{state.lock};
+  if (--state.handling == 0) {
+    state.cond.notify_all();
+  }
+}
+
+void RGWIndexCompletionManager::finish_completion(complete_op_data *completion,
+                                                  int r)
+{
   completion->lock.lock();
   if (completion->stopped) {
     completion->lock.unlock(); /* can drop lock, no one else is referencing us */
     delete completion;
     return;
   }
-  bool need_delete = completion->manager->handle_completion(cb, completion);
+  bool need_delete = handle_completion(r, completion);
   completion->lock.unlock();
   if (need_delete) {
     delete completion;
   }
 }
 
+void RGWIndexCompletionManager::queue_batched(const rgw_rados_ref& ref,
+                                              complete_op_data *completion)
+{
+  batch_key key{ref.ioctx.get_id(), ref.obj.oid};
+  {
+    std::unique_lock l{batches->lock};
+    if (batches->stop) {
+      l.unlock();
+      finish_completion(completion, -ECANCELED);
+      return;
+    }
+    auto [q, inserted] = batches->queues.try_emplace(key);
+    if (!inserted) {
+      q->second.queued.push_back(completion);
+      return;
+    }
+    q->second.ref = ref;
+  }
+  rgw_rados_ref r = ref;
+  send_batch(key, r, {completion});
+}
+
+void RGWIndexCompletionManager::send_batch(const batch_key& key,
+                                           rgw_rados_ref& ref,
+                                           std::vector<complete_op_data*>&& entries)
+{
+  librados::ObjectWriteOperation o;
+  o.assert_exists(); // bucket index shard must exist
+  cls_rgw_guard_bucket_resharding(o, -ERR_BUSY_RESHARDING);
+  for (auto c : entries) {
+    cls_rgw_bucket_complete_op(o, c->op, c->tag, c->ver, c->key, c->dir_meta,
+                               &c->remove_objs, c->log_op, c->bilog_op,
+                               &c->zones_trace, c->obj.key.get_loc());
+  }
+  ldout(ctx(), 20) << __func__ << "(): sending " << entries.size()
+      << " completions to " << ref.obj << dendl;
+
+  auto batch = std::make_unique<complete_batch_data>();
+  batch->manager = this;
+  batch->state = batches;
+  batch->key = key;
+  batch->entries = std::move(entries);
+  auto completion = librados::Rados::aio_create_completion(batch.get(),
+                                                           batch_complete_cb);
+  int r = ref.aio_operate(completion, &o);
+  completion->release();
+  if (r < 0) {
+    handle_batch_completion(key, std::move(batch->entries), r);
+    return;
+  }
+  batch.release(); // owned by batch_complete_cb now
+}
+
+void RGWIndexCompletionManager::send_single(rgw_rados_ref& ref,
+                                            complete_op_data *c)
+{
+  librados::ObjectWriteOperation o;
+  o.assert_exists(); // bucket index shard must exist
+  cls_rgw_guard_bucket_resharding(o, -ERR_BUSY_RESHARDING);
+  cls_rgw_bucket_complete_op(o, c->op, c->tag, c->ver, c->key, c->dir_meta,
+                             &c->remove_objs, c->log_op, c->bilog_op,
+                             &c->zones_trace, c->obj.key.get_loc());
+  auto completion = librados::Rados::aio_create_completion(c, obj_complete_cb);
+  int r = ref.aio_operate(completion, &o);
+  completion->release();
+  if (r < 0) {
+    finish_completion(c, r);
+  }
+}
+
+void RGWIndexCompletionManager::handle_batch_completion(
+  const batch_key& key, std::vector<complete_op_data*>&& entries, int r)
+{
+  const size_t max_batch = std::max<uint64_t>(1,
+    ctx()->_conf.get_val<uint64_t>("rgw_bucket_index_max_batched_completions"));
+  std::vector<complete_op_data*> next;
+  rgw_rados_ref ref;
+  bool stopping;
+  {
+    std::lock_guard l{batches->lock};
+    auto q = batches->queues.find(key);
+    ceph_assert(q != batches->queues.end());
+    auto& queued = q->second.queued;
+    ref = q->second.ref;
+    stopping = batches->stop;
+    if (stopping || queued.size() <= max_batch) {
+      next = std::move(queued);
+    } else {
+      next.assign(queued.begin(), queued.begin() + max_batch);
+      queued.erase(queued.begin(), queued.begin() + max_batch);
+    }
+    if (next.empty() || stopping) {
+      batches->queues.erase(q);
+      batches->cond.notify_all();
+    }
+  }
+
+  if (r < 0 && r != -ERR_BUSY_RESHARDING && entries.size() > 1 && !stopping) {
+    // the compound op fails as a whole when any of its entries does, so
+    // send them again one by one to let the others through. resharding
+    // is retried for each of them by finish_completion() anyway
+    ldout(ctx(), 5) << __func__ << "(): batch of " << entries.size()
+        << " completions to " << ref.obj << " failed r=" << r
+        << ", resending them one at a time" << dendl;
+    for (auto c : entries) {
+      send_single(ref, c);
+    }
+  } else {
+    for (auto c : entries) {
+      finish_completion(c, r);
+    }
+  }
+  if (stopping) {
+    for (auto c : next) {
+      finish_completion(c, -ECANCELED);
+    }
+  } else if (!next.empty()) {
+    send_batch(key, ref, std::move(next));
+  }
+}
+
 void RGWIndexCompletionManager::process()
 {
   DoutPrefix dpp(store->ctx(), dout_subsys, "rgw index completion thread: ");
@@ -989,7 +1210,7 @@ void RGWIndexCompletionManager::add_completion(complete_op_data *completion) {
   cond.notify_all();
 }
 
-bool RGWIndexCompletionManager::handle_completion(completion_t cb, complete_op_data *arg)
+bool RGWIndexCompletionManager::handle_completion(int r, complete_op_data *arg)
 {
   int shard_id = arg->manager_shard_id;
   {
@@ -1006,7 +1227,6 @@ bool RGWIndexCompletionManager::handle_completion(completion_t cb, complete_op_d
     comps.erase(iter);
   }
 
-  int r = rados_aio_get_return_value(cb);
   if (r != -ERR_BUSY_RESHARDING) {
     ldout(arg->manager->ctx(), 20) << __func__ << "(): completion " << 
       (r == 0 ? "ok" : "failed with " + to_string(r)) << 
@@ -1841,6 +2061,9 @@ int RGWRados::Bucket::List::list_objects_ordered(
   // until we return at least one entry
   constexpr uint16_t SOFT_MAX_ATTEMPTS = 8;
 
+  // shard results carried over from one attempt to the next
+  RGWRados::shard_list_cache_t shard_cache;
+
   rgw_obj_index_key prev_marker;
   for (uint16_t attempt = 1; /* empty */; ++attempt) {
     ldpp_dout(dpp, 20) << __func__ <<
@@ -1873,7 +2096,9 @@ int RGWRados::Bucket::List::list_objects_ordered(
 					   &cls_filtered,
 					   &cur_marker,
                                            y,
-					   params.force_check_filter);
+					   params.force_check_filter,
+					   params.list_versions ?
+					     nullptr : &shard_cache);
     if (r < 0) {
       return r;
     }
@@ -3497,7 +3722,7 @@ public:
 
     // do not compress if object is encrypted
     if (plugin && !encrypted) {
-      compressor = boost::in_place(cct, plugin, filter);
+      compressor = boost::in_place(cct, plugin, filter, null_yield);
       // add a filter that buffers data so we don't try to compress tiny blocks.
       // libcurl reads in 16k at a time, and we need at least 64k to get a good
       // compression ratio
@@ -7184,6 +7409,7 @@ int get_obj_data::flush(rgw::AioResultList&& results) {
     if (r < 0) {
       return r;
     }
+    adapt_window(bl.length());
 
     if (rgwrados->get_use_datacache()) {
       const std::lock_guard l(d3n_get_data.d3n_lock);
@@ -7200,6 +7426,41 @@ int get_obj_data::flush(rgw::AioResultList&& results) {
   return 0;
 }
 
+void get_obj_data::adapt_window(uint64_t bytes)
+{
+  if (window >= max_window && last_rate == 0) {
+    return; // not adapting
+  }
+  epoch_bytes += bytes;
+  if (epoch_bytes < window) {
+    return;
+  }
+  const auto now = ceph::mono_clock::now();
+  const double secs = std::chrono::duration<double>(now - epoch_start).count();
+  const double rate = secs > 0 ? epoch_bytes / secs : 0;
+  uint64_t new_window;
+  if (last_rate == 0 || rate > last_rate * 1.1) {
+    new_window = std::min(window * 2, max_window);
+    last_rate = rate;
+  } else {
+    // the last step didn't help, go back to the previous window and stay
+    new_window = std::max(window / 2, min_window);
+    max_window = new_window;
+  }
+  if (new_window >= max_window) {
+    max_window = new_window;
+    last_rate = 0; // done adapting
+  }
+  if (new_window != window) {
+    ldout(rgwrados->ctx(), 20) << "get_obj_data: read window " << window
+        << " -> " << new_window << " at " << rate << " bytes/s" << dendl;
+    window = new_window;
+    aio->set_window(window);
+  }
+  epoch_bytes = 0;
+  epoch_start = now;
+}
+
 static int _get_obj_iterate_cb(const DoutPrefixProvider *dpp,
                                const rgw_raw_obj& read_obj, off_t obj_ofs,
                                off_t read_ofs, off_t len, bool is_head_obj,
@@ -7271,8 +7532,12 @@ int RGWRados::Object::Read::iterate(const DoutPrefixProvider *dpp, int64_t ofs,
   const uint64_t chunk_size = cct->_conf->rgw_get_obj_max_req_size;
   const uint64_t window_size = cct->_conf->rgw_get_obj_window_size;
 
+  const uint64_t max_window_size = std::max<uint64_t>(window_size,
+      cct->_conf.get_val<Option::size_t>("rgw_get_obj_max_window_size"));
+
   auto aio = rgw::make_throttle(window_size, y);
   get_obj_data data(store, cb, &*aio, ofs, y);
+  data.set_adaptive_window(window_size, max_window_size);
 
   int r = store->iterate_obj(dpp, source->get_ctx(), source->get_bucket_info(), state.obj,
                              ofs, end, chunk_size, _get_obj_iterate_cb, &data, y);
@@ -9295,7 +9560,13 @@ int RGWRados::cls_obj_complete_op(BucketShard& bs, const rgw_obj& obj, RGWModify
   index_completion_manager->create_completion(obj, op, tag, ver, key, dir_meta, remove_objs,
                                               log_op, bilog_flags, &zones_trace, &arg);
   librados::AioCompletion *completion = arg->rados_completion;
-  int ret = bs.bucket_obj.aio_operate(arg->rados_completion, &o);
+  int ret = 0;
+  if (cct->_conf.get_val<uint64_t>("rgw_bucket_index_max_batched_completions") > 1) {
+    // sent from the manager along with other completions for the shard
+    index_completion_manager->queue_batched(bs.bucket_obj, arg);
+  } else {
+    ret = bs.bucket_obj.aio_operate(arg->rados_completion, &o);
+  }
   completion->release(); /* can't reference arg here, as it might have already been released */
 
   ldout_bitx_c(bitx, cct, 10) << "EXITING " << __func__ << ": ret=" << ret << dendl_bitx;
@@ -9406,7 +9677,8 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
 				      bool* cls_filtered,
 				      rgw_obj_index_key* last_entry,
                                       optional_yield y,
-				      RGWBucketListNameFilter force_check_filter)
+				      RGWBucketListNameFilter force_check_filter,
+				      shard_list_cache_t* shard_cache)
 {
   const bool bitx = cct->_conf->rgw_bucket_index_transaction_instrumentation;
 
@@ -9481,15 +9753,47 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
   auto& ioctx = index_pool;
   std::map<int, rgw_cls_list_ret> shard_list_results;
   cls_rgw_obj_key start_after_key(start_after.name, start_after.instance);
-  r = CLSRGWIssueBucketList(ioctx, start_after_key, prefix, delimiter,
-			    num_entries_per_shard,
-			    list_versions, shard_oids, shard_list_results,
-			    cct->_conf->rgw_bucket_index_max_aio)();
-  if (r < 0) {
-    ldpp_dout(dpp, 0) << __func__ <<
-      ": CLSRGWIssueBucketList for " << bucket_info.bucket <<
-      " failed" << dendl;
-    return r;
+
+  // reuse what the previous call left over from each shard unless there
+  // is too little of it to be worth merging, and do not read the shards
+  // that have no more entries at all
+  std::map<int, std::string> fetch_oids = shard_oids;
+  if (shard_cache) {
+    for (auto& [shard, ret] : *shard_cache) {
+      auto& ents = ret.dir.m;
+      // drop the entries the caller skipped over since
+      auto first = ents.begin();
+      while (first != ents.end() && !(start_after_key < first->second.key)) {
+	++first;
+      }
+      ents.erase(ents.begin(), first);
+      if (!ret.is_truncated ||
+	  (!ents.empty() && ents.size() >= num_entries_per_shard / 2)) {
+	fetch_oids.erase(shard);
+	if (!ents.empty()) {
+	  shard_list_results.emplace(shard, std::move(ret));
+	}
+      }
+    }
+    shard_cache->clear();
+    ldpp_dout(dpp, 20) << __func__ << ": reusing results of " <<
+      shard_list_results.size() << " shard(s), reading " <<
+      fetch_oids.size() << " shard(s)" << dendl;
+  }
+
+  if (!fetch_oids.empty()) {
+    std::map<int, rgw_cls_list_ret> fetched;
+    r = CLSRGWIssueBucketList(ioctx, start_after_key, prefix, delimiter,
+			      num_entries_per_shard,
+			      list_versions, fetch_oids, fetched,
+			      cct->_conf->rgw_bucket_index_max_aio)();
+    if (r < 0) {
+      ldpp_dout(dpp, 0) << __func__ <<
+	": CLSRGWIssueBucketList for " << bucket_info.bucket <<
+	" failed" << dendl;
+      return r;
+    }
+    shard_list_results.merge(fetched);
   }
 
   // to manage the iterators through each shard's list results
@@ -9697,6 +10001,14 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     }
   }
 
+  if (shard_cache) {
+    // keep what we did not consume for the next call
+    for (auto& t : results_trackers) {
+      t.result.dir.m.erase(t.result.dir.m.begin(), t.cursor);
+      shard_cache->emplace(t.shard_idx, std::move(t.result));
+    }
+  }
+
   ldpp_dout(dpp, 20) << __func__ <<
     ": returning, count=" << count << ", is_truncated=" << *is_truncated <<
     dendl;
@@ -1461,6 +1461,11 @@ public:
   using ent_map_t =
     boost::container::flat_map<std::string, rgw_bucket_dir_entry>;
 
+  // per-shard results that one cls_bucket_list_ordered() call did not
+  // consume, for the next call of the same listing to pick up without
+  // reading those shards again
+  using shard_list_cache_t = std::map<int, rgw_cls_list_ret>;
+
   int cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
                               RGWBucketInfo& bucket_info,
                               const rgw::bucket_index_layout_generation& idx_layout,
@@ -1476,7 +1481,8 @@ public:
 			      bool* cls_filtered,
 			      rgw_obj_index_key *last_entry,
                               optional_yield y,
-			      RGWBucketListNameFilter force_check_filter = {});
+			      RGWBucketListNameFilter force_check_filter = {},
+			      shard_list_cache_t* shard_cache = nullptr);
   int cls_bucket_list_unordered(const DoutPrefixProvider *dpp,
                                 RGWBucketInfo& bucket_info,
                                 const rgw::bucket_index_layout_generation& idx_layout,
@@ -1673,9 +1679,27 @@ struct get_obj_data {
   rgw::AioResultList completed; // completed read results, sorted by offset
   optional_yield yield;
 
+  // the read window starts at min_window and is doubled for as long as
+  // that raises the rate at which data reaches the client, up to
+  // max_window. whether the cluster or the client is the bottleneck, a
+  // larger window that doesn't pay off is given back
+  uint64_t window = 0;
+  uint64_t min_window = 0;
+  uint64_t max_window = 0;
+  uint64_t epoch_bytes = 0; // sent to the client at the current window
+  ceph::mono_time epoch_start;
+  double last_rate = 0; // bytes per second at the previous window
+
   get_obj_data(RGWRados* rgwrados, RGWGetDataCB* cb, rgw::Aio* aio,
                uint64_t offset, optional_yield yield)
                : rgwrados(rgwrados), client_cb(cb), aio(aio), offset(offset), yield(yield) {}
+
+  void set_adaptive_window(uint64_t min, uint64_t max) {
+    window = min_window = min;
+    max_window = max;
+    epoch_start = ceph::mono_clock::now();
+  }
+  void adapt_window(uint64_t bytes);
   ~get_obj_data() {
     if (rgwrados->get_use_datacache()) {
       const std::lock_guard l(d3n_get_data.d3n_lock);
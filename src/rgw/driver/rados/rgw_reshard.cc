@@ -246,6 +246,124 @@ public:
   }
 }; // class BucketReshardManager
 
+// lists the entries of all shards of a bucket index layout, keeping reads
+// on several of them in flight at once
+class BucketReshardSourceShards {
+  struct ShardRead {
+    RGWRados::BucketShard bs;
+    rgw_cls_bi_list_ret result;
+    int op_ret = 0;
+    librados::AioCompletion *c = nullptr;
+
+    explicit ShardRead(RGWRados *rados) : bs(rados) {}
+  };
+
+  rgw::sal::RadosStore *store;
+  const DoutPrefixProvider *dpp;
+  const RGWBucketInfo& bucket_info;
+  const rgw::bucket_index_layout_generation& index;
+  const uint32_t num_shards;
+  const uint32_t max_entries;
+  const uint64_t max_aio;
+  uint32_t next_shard = 0;
+  deque<unique_ptr<ShardRead>> reads;
+
+  int issue(unique_ptr<ShardRead> read, const string& marker) {
+    read->result = rgw_cls_bi_list_ret();
+    read->op_ret = 0;
+    librados::ObjectReadOperation op;
+    cls_rgw_bi_list(op, string(), marker, max_entries,
+		    &read->result, &read->op_ret);
+    read->c = librados::Rados::aio_create_completion(nullptr, nullptr);
+    int ret = read->bs.bucket_obj.aio_operate(read->c, &op, nullptr);
+    if (ret < 0) {
+      read->c->release();
+      derr << "ERROR: failed to list source bucket shard (bs=" << read->bs.bucket << "/" << read->bs.shard_id << ") error=" << cpp_strerror(-ret) << dendl;
+      return ret;
+    }
+    reads.push_back(std::move(read));
+    return 0;
+  }
+
+  int start_shards() {
+    while (reads.size() < max_aio && next_shard < num_shards) {
+      auto read = make_unique<ShardRead>(store->getRados());
+      int ret = read->bs.init(dpp, bucket_info, index, next_shard, null_yield);
+      if (ret < 0) {
+	ldpp_dout(dpp, 5) << "bs.init() returned ret=" << ret << dendl;
+	return ret;
+      }
+      ++next_shard;
+      ret = issue(std::move(read), string());
+      if (ret < 0) {
+	return ret;
+      }
+    }
+    return 0;
+  }
+
+public:
+  BucketReshardSourceShards(const DoutPrefixProvider *_dpp,
+			    rgw::sal::RadosStore *_store,
+			    const RGWBucketInfo& _bucket_info,
+			    const rgw::bucket_index_layout_generation& _index,
+			    uint32_t _max_entries) :
+    store(_store), dpp(_dpp), bucket_info(_bucket_info), index(_index),
+    num_shards(rgw::num_shards(_index.layout.normal)),
+    max_entries(_max_entries),
+    max_aio(store->ctx()->_conf.get_val<uint64_t>("rgw_reshard_max_list_aio"))
+  { }
+
+  ~BucketReshardSourceShards() {
+    for (auto& read : reads) {
+      read->c->wait_for_complete();
+      read->c->release();
+    }
+  }
+
+  // waits for the oldest outstanding read and returns its entries, after
+  // sending the read for the next chunk of that shard; sets *done once
+  // every shard has been listed
+  int get_next(int *shard_id, list<rgw_cls_bi_entry> *entries, bool *done) {
+    for (;;) {
+      int ret = start_shards();
+      if (ret < 0) {
+	return ret;
+      }
+      if (reads.empty()) {
+	*done = true;
+	return 0;
+      }
+
+      auto read = std::move(reads.front());
+      reads.pop_front();
+      read->c->wait_for_complete();
+      ret = read->c->get_return_value();
+      read->c->release();
+      read->c = nullptr;
+      if (ret >= 0) {
+	ret = read->op_ret;
+      }
+      if (ret == -ENOENT) {
+	ldpp_dout(dpp, 1) << "WARNING: " << __func__ << " failed to find shard "
+	    << read->bs.shard_id << ", skipping" << dendl;
+	continue;
+      } else if (ret < 0) {
+	derr << "ERROR: bi_list(): " << cpp_strerror(-ret) << dendl;
+	return ret;
+      }
+
+      *shard_id = read->bs.shard_id;
+      *entries = std::move(read->result.entries);
+      *done = false;
+      if (read->result.is_truncated && !entries->empty()) {
+	return issue(std::move(read), entries->back().idx);
+      }
+      return 0;
+    }
+  }
+}; // class BucketReshardSourceShards
+
 RGWBucketReshard::RGWBucketReshard(rgw::sal::RadosStore* _store,
 				   const RGWBucketInfo& _bucket_info,
 				   const std::map<std::string, bufferlist>& _bucket_attrs,
@@ -828,96 +946,93 @@ int RGWBucketReshard::do_reshard(const rgw::bucket_index_layout_generation& curr
     (*out) << "total entries:";
   }
 
-  const uint32_t num_source_shards = rgw::num_shards(current.layout.normal);
+  // the source shards are read ahead, so that writes to the target shards
+  // overlap with the reads of the next entries
+  BucketReshardSourceShards source_shards(dpp, store, bucket_info, current,
+					  max_entries);
   string marker;
-  for (uint32_t i = 0; i < num_source_shards; ++i) {
-    bool is_truncated = true;
-    marker.clear();
-    const std::string null_object_filter; // empty string since we're not filtering by object
-    while (is_truncated) {
-      entries.clear();
-      int ret = store->getRados()->bi_list(dpp, bucket_info, i, null_object_filter, marker, max_entries, &entries, &is_truncated, y);
-      if (ret == -ENOENT) {
-        ldpp_dout(dpp, 1) << "WARNING: " << __func__ << " failed to find shard "
-            << i << ", skipping" << dendl;
-        // break out of the is_truncated loop and move on to the next shard
-        break;
-      } else if (ret < 0) {
-        derr << "ERROR: bi_list(): " << cpp_strerror(-ret) << dendl;
-        return ret;
-      }
+  for (;;) {
+    int i;
+    bool done;
+    entries.clear();
+    int ret = source_shards.get_next(&i, &entries, &done);
+    if (ret < 0) {
+      return ret;
+    }
+    if (done) {
+      break;
+    }
 
-      for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
-	rgw_cls_bi_entry& entry = *iter;
-	if (verbose_json_out) {
-	  formatter->open_object_section("entry");
+    for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+      rgw_cls_bi_entry& entry = *iter;
+      if (verbose_json_out) {
+	formatter->open_object_section("entry");
 
-	  encode_json("shard_id", i, formatter);
-	  encode_json("num_entry", total_entries, formatter);
-	  encode_json("entry", entry, formatter);
-	}
-	total_entries++;
-
-	marker = entry.idx;
-
-	int target_shard_id;
-	cls_rgw_obj_key cls_key;
-	RGWObjCategory category;
-	rgw_bucket_category_stats stats;
-	bool account = entry.get_info(&cls_key, &category, &stats);
-	rgw_obj_key key(cls_key);
-	if (entry.type == BIIndexType::OLH && key.empty()) {
-	  // bogus entry created by https://tracker.ceph.com/issues/46456
-	  // to fix, skip so it doesn't get include in the new bucket instance
-	  total_entries--;
-	  ldpp_dout(dpp, 10) << "Dropping entry with empty name, idx=" << marker << dendl;
-	  continue;
-	}
-	rgw_obj obj(bucket_info.bucket, key);
-	RGWMPObj mp;
-	if (key.ns == RGW_OBJ_NS_MULTIPART && mp.from_meta(key.name)) {
-	  // place the multipart .meta object on the same shard as its head object
-	  obj.index_hash_source = mp.get_key();
-	}
-	ret = store->getRados()->get_target_shard_id(bucket_info.layout.target_index->layout.normal,
-						     obj.get_hash_object(), &target_shard_id);
-	if (ret < 0) {
-	  ldpp_dout(dpp, -1) << "ERROR: get_target_shard_id() returned ret=" << ret << dendl;
-	  return ret;
-	}
+	encode_json("shard_id", i, formatter);
+	encode_json("num_entry", total_entries, formatter);
+	encode_json("entry", entry, formatter);
+      }
+      total_entries++;
+
+      marker = entry.idx;
+
+      int target_shard_id;
+      cls_rgw_obj_key cls_key;
+      RGWObjCategory category;
+      rgw_bucket_category_stats stats;
+      bool account = entry.get_info(&cls_key, &category, &stats);
+      rgw_obj_key key(cls_key);
+      if (entry.type == BIIndexType::OLH && key.empty()) {
+	// bogus entry created by https://tracker.ceph.com/issues/46456
+	// to fix, skip so it doesn't get include in the new bucket instance
+	total_entries--;
+	ldpp_dout(dpp, 10) << "Dropping entry with empty name, idx=" << marker << dendl;
+	continue;
+      }
+      rgw_obj obj(bucket_info.bucket, key);
+      RGWMPObj mp;
+      if (key.ns == RGW_OBJ_NS_MULTIPART && mp.from_meta(key.name)) {
+	// place the multipart .meta object on the same shard as its head object
+	obj.index_hash_source = mp.get_key();
+      }
+      ret = store->getRados()->get_target_shard_id(bucket_info.layout.target_index->layout.normal,
+						   obj.get_hash_object(), &target_shard_id);
+      if (ret < 0) {
+	ldpp_dout(dpp, -1) << "ERROR: get_target_shard_id() returned ret=" << ret << dendl;
+	return ret;
+      }
 
-	int shard_index = (target_shard_id > 0 ? target_shard_id : 0);
+      int shard_index = (target_shard_id > 0 ? target_shard_id : 0);
 
-	ret = target_shards_mgr.add_entry(shard_index, entry, account,
-					  category, stats);
-	if (ret < 0) {
-	  return ret;
-	}
+      ret = target_shards_mgr.add_entry(shard_index, entry, account,
+					category, stats);
+      if (ret < 0) {
+	return ret;
+      }
 
-	Clock::time_point now = Clock::now();
-	if (reshard_lock.should_renew(now)) {
-	  // assume outer locks have timespans at least the size of ours, so
-	  // can call inside conditional
-	  if (outer_reshard_lock) {
-	    ret = outer_reshard_lock->renew(now);
-	    if (ret < 0) {
-	      return ret;
-	    }
-	  }
-	  ret = reshard_lock.renew(now);
+      Clock::time_point now = Clock::now();
+      if (reshard_lock.should_renew(now)) {
+	// assume outer locks have timespans at least the size of ours, so
+	// can call inside conditional
+	if (outer_reshard_lock) {
+	  ret = outer_reshard_lock->renew(now);
 	  if (ret < 0) {
-	    ldpp_dout(dpp, -1) << "Error renewing bucket lock: " << ret << dendl;
 	    return ret;
 	  }
 	}
-	if (verbose_json_out) {
-	  formatter->close_section();
-	  formatter->flush(*out);
-	} else if (out && !(total_entries % 1000)) {
-	  (*out) << " " << total_entries;
+	ret = reshard_lock.renew(now);
+	if (ret < 0) {
+	  ldpp_dout(dpp, -1) << "Error renewing bucket lock: " << ret << dendl;
+	  return ret;
 	}
-      } // entries loop
-    }
+      }
+      if (verbose_json_out) {
+	formatter->close_section();
+	formatter->flush(*out);
+      } else if (out && !(total_entries % 1000)) {
+	(*out) << " " << total_entries;
+      }
+    } // entries loop
   }
 
   if (verbose_json_out) {
@@ -2415,6 +2415,84 @@ int RadosMultipartUpload::list_parts(const DoutPrefixProvider *dpp, CephContext
   return 0;
 }
 
+/* reads the info of parts 1..num_parts into parts, with the omap pages
+ * holding them requested all at once rather than one after the other as
+ * list_parts() does. Only for v2 uploads, which keep their parts in
+ * sorted omap; returns -EAGAIN if the parts found are not numbered
+ * exactly 1..num_parts, so that the caller can fall back to list_parts()
+ * and report what is wrong with them */
+int RadosMultipartUpload::read_all_parts(const DoutPrefixProvider *dpp,
+					 CephContext *cct,
+					 uint32_t num_parts, optional_yield y)
+{
+  static constexpr uint32_t page_size = 1000;
+
+  rgw_obj_key key(get_meta(), std::string(), RGW_OBJ_NS_MULTIPART);
+  rgw_obj obj(bucket->get_key(), key);
+  obj.in_extra_data = true;
+
+  rgw_raw_obj raw_obj;
+  store->getRados()->obj_to_raw(bucket->get_placement_rule(), obj, &raw_obj);
+  rgw_rados_ref ref;
+  int ret = store->getRados()->get_raw_obj_ref(dpp, raw_obj, &ref);
+  if (ret < 0) {
+    return ret;
+  }
+
+  const uint32_t num_pages = (num_parts + page_size - 1) / page_size;
+  std::vector<std::map<std::string, bufferlist>> pages(num_pages);
+  std::vector<int> rvals(num_pages, 0);
+  auto aio = rgw::make_throttle(
+      cct->_conf.get_val<uint64_t>("rgw_multipart_complete_max_aio"), y);
+  rgw::AioResultList results;
+  for (uint32_t i = 0; i < num_pages; ++i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "part.%08d", i * page_size);
+
+    librados::ObjectReadOperation op;
+    op.omap_get_vals2(buf, page_size, &pages[i], nullptr, &rvals[i]);
+    static constexpr uint64_t cost = 1; // 1 throttle unit per request
+    results.splice(results.end(),
+		   aio->get(ref.obj, rgw::Aio::librados_op(ref.ioctx, std::move(op), y),
+			    cost, i));
+  }
+  results.splice(results.end(), aio->drain());
+  ret = rgw::check_for_errors(results);
+  if (ret < 0) {
+    return ret;
+  }
+  for (auto r : rvals) {
+    if (r < 0) {
+      return r;
+    }
+  }
+
+  parts.clear();
+  uint32_t expected_next = 1;
+  for (auto& page : pages) {
+    for (auto& [k, bl] : page) {
+      auto bli = bl.cbegin();
+      std::unique_ptr<RadosMultipartPart> part = std::make_unique<RadosMultipartPart>();
+      try {
+	decode(part->info, bli);
+      } catch (buffer::error& err) {
+	ldpp_dout(dpp, 0) << "ERROR: could not part info, caught buffer::error" <<
+	  dendl;
+	return -EIO;
+      }
+      if (part->info.num != expected_next) {
+	return -EAGAIN;
+      }
+      ++expected_next;
+      parts[part->info.num] = std::move(part);
+    }
+  }
+  if (expected_next != num_parts + 1) {
+    return -EAGAIN;
+  }
+  return 0;
+}
+
 int RadosMultipartUpload::complete(const DoutPrefixProvider *dpp,
 				   optional_yield y, CephContext* cct,
 				   map<int, string>& part_etags,
@@ -2443,13 +2521,33 @@ int RadosMultipartUpload::complete(const DoutPrefixProvider *dpp,
   auto etags_iter = part_etags.begin();
   rgw::sal::Attrs& attrs = target_obj->get_attrs();
 
-  do {
-    ret = list_parts(dpp, cct, max_parts, marker, &marker, &truncated, y);
+  /* the parts of large uploads are usually numbered 1..N, which lets us
+   * read all their pages in parallel and handle them in a single pass */
+  bool have_all_parts = false;
+  if (part_etags.size() > (size_t)max_parts &&
+      is_v2_upload_id(get_upload_id()) &&
+      part_etags.begin()->first == 1 &&
+      part_etags.rbegin()->first == (int)part_etags.size()) {
+    ret = read_all_parts(dpp, cct, part_etags.size(), y);
     if (ret == -ENOENT) {
       ret = -ERR_NO_SUCH_UPLOAD;
     }
-    if (ret < 0)
+    if (ret < 0 && ret != -EAGAIN)
       return ret;
+    have_all_parts = (ret == 0);
+  }
+
+  do {
+    if (have_all_parts) {
+      truncated = false;
+    } else {
+      ret = list_parts(dpp, cct, max_parts, marker, &marker, &truncated, y);
+      if (ret == -ENOENT) {
+        ret = -ERR_NO_SUCH_UPLOAD;
+      }
+      if (ret < 0)
+        return ret;
+    }
 
     total_parts += parts.size();
     if (!truncated && total_parts != (int)part_etags.size()) {
@@ -645,6 +645,8 @@ protected:
                            optional_yield y,
                            RadosMultipartPart* part,
                            std::list<rgw_obj_index_key>& remove_objs);
+  int read_all_parts(const DoutPrefixProvider* dpp, CephContext* cct,
+                     uint32_t num_parts, optional_yield y);
 };
 
 class MPRadosSerializer : public StoreMPSerializer {
@@ -91,6 +91,10 @@ class Aio {
   // wait for all outstanding completions and return their results
   virtual AioResultList drain() = 0;
 
+  // change the total cost allowed to be outstanding. operations in flight
+  // are not affected; a smaller window only delays the next get()
+  virtual void set_window(uint64_t window) = 0;
+
   static OpFunc librados_op(librados::IoCtx ctx,
                             librados::ObjectReadOperation&& op,
                             optional_yield y);
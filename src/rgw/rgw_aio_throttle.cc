@@ -108,6 +108,12 @@ AioResultList BlockingAioThrottle::drain()
   return std::move(completed);
 }
 
+void BlockingAioThrottle::set_window(uint64_t w)
+{
+  std::scoped_lock lock{mutex};
+  window = w;
+}
+
 template <typename CompletionToken>
 auto YieldingAioThrottle::async_wait(CompletionToken&& token)
 {
@@ -199,4 +205,9 @@ AioResultList YieldingAioThrottle::drain()
   }
   return std::move(completed);
 }
+
+void YieldingAioThrottle::set_window(uint64_t w)
+{
+  window = w;
+}
 } // namespace rgw
@@ -3,6 +3,7 @@
 
 #include <atomic>
 #include <ctime>
+#include <optional>
 #include <vector>
 
 #include <boost/asio/error.hpp>
@@ -72,6 +73,31 @@ class StreamIO : public rgw::asio::ClientIO {
   spawn::yield_context yield;
   parse_buffer& buffer;
   boost::system::error_code fatal_ec;
+  // once set, the rest of the body is read from the stream directly
+  // instead of through the parser
+  std::optional<uint64_t> direct_remaining;
+
+  size_t recv_body_direct(char* buf, size_t max) {
+    size_t received = 0;
+    while (received < max && *direct_remaining > 0) {
+      const size_t want = std::min<uint64_t>(max - received, *direct_remaining);
+      boost::system::error_code ec;
+      timeout.start();
+      auto bytes = stream.async_read_some(boost::asio::buffer(buf + received, want),
+                                          yield[ec]);
+      timeout.cancel();
+      if (ec) {
+        ldout(cct, 4) << "failed to read body: " << ec.message() << dendl;
+        if (!fatal_ec) {
+          fatal_ec = ec;
+        }
+        throw rgw::io::Exception(ec.value(), std::system_category());
+      }
+      received += bytes;
+      *direct_remaining -= bytes;
+    }
+    return received;
+  }
  public:
   StreamIO(CephContext *cct, Stream& stream, timeout_timer& timeout,
            rgw::asio::parser_type& parser, spawn::yield_context yield,
@@ -105,7 +131,23 @@ class StreamIO : public rgw::asio::ClientIO {
     return bytes;
   }
 
+  std::optional<uint64_t> get_direct_remaining() const {
+    return direct_remaining;
+  }
+
   size_t recv_body(char* buf, size_t max) override {
+    // the parser copies the body out of the parse buffer. for large reads
+    // of a body with a known length, skip that copy by reading into the
+    // caller's buffer directly once the parse buffer has been drained
+    if (!direct_remaining && max >= parse_buffer_size &&
+        parser.is_header_done() && !parser.is_done() && !parser.chunked() &&
+        buffer.size() == 0 && parser.content_length_remaining()) {
+      direct_remaining = *parser.content_length_remaining();
+    }
+    if (direct_remaining) {
+      return recv_body_direct(buf, max);
+    }
+
     auto& message = parser.get();
     auto& body_remaining = message.body();
     body_remaining.data = buf;
@@ -245,6 +287,7 @@ void handle_connection(boost::asio::io_context& context,
     }
 
     bool expect_continue = (message[http::field::expect] == "100-continue");
+    std::optional<uint64_t> direct_remaining;
 
     {
       auto lock = pause_mutex.async_lock_shared(yield[ec]);
@@ -313,12 +356,33 @@ void handle_connection(boost::asio::io_context& context,
       if (real_client.sent_100_continue()) {
         expect_continue = false;
       }
+      direct_remaining = real_client.get_direct_remaining();
     }
 
     if (!parser.keep_alive()) {
       return;
     }
 
+    if (direct_remaining) {
+      // the parser never saw the body, so discard what is left of it here
+      while (!expect_continue && *direct_remaining > 0) {
+        static std::array<char, 1024> discard_buffer;
+        const size_t want = std::min<uint64_t>(discard_buffer.size(),
+                                               *direct_remaining);
+        timeout.start();
+        auto bytes = stream.async_read_some(
+            boost::asio::buffer(discard_buffer.data(), want), yield[ec]);
+        timeout.cancel();
+        if (ec) {
+          ldout(cct, 5) << "failed to discard unread message: "
+              << ec.message() << dendl;
+          return;
+        }
+        *direct_remaining -= bytes;
+      }
+      continue;
+    }
+
     // if we failed before reading the entire message, discard any remaining
     // bytes before reading the next
     while (!expect_continue && !parser.is_done()) {
@@ -7,6 +7,7 @@
 #include <iterator>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "common/armor.h"
@@ -948,6 +949,19 @@ get_v4_signing_key(CephContext* const cct,
                    const std::string_view& secret_access_key,
                    const DoutPrefixProvider *dpp)
 {
+  /* the key only depends on the secret and the credential scope, which stay
+   * the same for all requests of a client on a given day. Remember the last
+   * few per thread instead of redoing four HMACs on every request. */
+  static constexpr size_t max_cached_signing_keys = 64;
+  thread_local std::unordered_map<std::string, sha256_digest_t> signing_keys;
+  std::string cache_key;
+  cache_key.reserve(credential_scope.size() + 1 + secret_access_key.size());
+  cache_key.append(credential_scope).append(1, '\0').append(secret_access_key);
+  if (auto i = signing_keys.find(cache_key); i != signing_keys.end()) {
+    ldpp_dout(dpp, 20) << "using cached signing key" << dendl;
+    return i->second;
+  }
+
   std::string_view date, region, service;
   std::tie(date, region, service) = parse_cred_scope(credential_scope);
 
@@ -965,6 +979,11 @@ get_v4_signing_key(CephContext* const cct,
   ldpp_dout(dpp, 10) << "service_k = " << service_k << dendl;
   ldpp_dout(dpp, 10) << "signing_k = " << signing_key << dendl;
 
+  if (signing_keys.size() >= max_cached_signing_keys) {
+    signing_keys.clear();
+  }
+  signing_keys.emplace(std::move(cache_key), signing_key);
+
   return signing_key;
 }
 
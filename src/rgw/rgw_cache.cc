@@ -4,22 +4,42 @@
 #include "rgw_cache.h"
 #include "rgw_perf_counters.h"
 
+#include <algorithm>
+
 #include <errno.h>
 
 #define dout_subsys ceph_subsys_rgw
 
 using namespace std;
 
-int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cache_entry_info *cache_info)
+ObjectCache::ObjectCache() : cct(NULL), enabled(false)
 {
+  shards.reserve(num_shards);
+  for (unsigned i = 0; i < num_shards; ++i) {
+    shards.push_back(std::make_unique<Shard>(
+      "ObjectCache::shard" + std::to_string(i)));
+  }
+}
 
-  std::shared_lock rl{lock};
-  std::unique_lock wl{lock, std::defer_lock}; // may be promoted to write lock
+std::vector<std::unique_lock<ceph::shared_mutex>> ObjectCache::lock_all()
+{
+  std::vector<std::unique_lock<ceph::shared_mutex>> locks;
+  locks.reserve(shards.size());
+  for (auto& shard : shards) {
+    locks.emplace_back(shard->lock);
+  }
+  return locks;
+}
+
+int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cache_entry_info *cache_info)
+{
+  Shard& shard = shard_of(name);
+  std::shared_lock rl{shard.lock};
   if (!enabled) {
     return -ENOENT;
   }
-  auto iter = cache_map.find(name);
-  if (iter == cache_map.end()) {
+  auto iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end()) {
     ldpp_dout(dpp, 10) << "cache get: name=" << name << " : miss" << dendl;
     if (perfcounter) {
       perfcounter->inc(l_rgw_cache_miss);
@@ -31,14 +51,14 @@ int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCa
        (ceph::coarse_mono_clock::now() - iter->second.info.time_added) > expiry) {
     ldpp_dout(dpp, 10) << "cache get: name=" << name << " : expiry miss" << dendl;
     rl.unlock();
-    wl.lock(); // write lock for expiration
+    std::unique_lock wl{shard.lock}; // write lock for expiration
     // check that wasn't already removed by other thread
-    iter = cache_map.find(name);
-    if (iter != cache_map.end()) {
+    iter = shard.cache_map.find(name);
+    if (iter != shard.cache_map.end()) {
       for (auto &kv : iter->second.chained_entries)
         kv.first->invalidate(kv.second);
-      remove_lru(name, iter->second.lru_iter);
-      cache_map.erase(iter);
+      remove_lru(shard, iter->second.lru_iter);
+      shard.cache_map.erase(iter);
     }
     if (perfcounter) {
       perfcounter->inc(l_rgw_cache_miss);
@@ -47,26 +67,9 @@ int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCa
   }
 
   ObjectCacheEntry *entry = &iter->second;
-
-  if (lru_counter - entry->lru_promotion_ts > lru_window) {
-    ldpp_dout(dpp, 20) << "cache get: touching lru, lru_counter=" << lru_counter
-                   << " promotion_ts=" << entry->lru_promotion_ts << dendl;
-    rl.unlock();
-    wl.lock(); // write lock for touch_lru()
-    /* need to redo this because entry might have dropped off the cache */
-    iter = cache_map.find(name);
-    if (iter == cache_map.end()) {
-      ldpp_dout(dpp, 10) << "lost race! cache get: name=" << name << " : miss" << dendl;
-      if(perfcounter) perfcounter->inc(l_rgw_cache_miss);
-      return -ENOENT;
-    }
-
-    entry = &iter->second;
-    /* check again, we might have lost a race here */
-    if (lru_counter - entry->lru_promotion_ts > lru_window) {
-      touch_lru(dpp, name, *entry, iter->second.lru_iter);
-    }
-  }
+  // the lru is only reordered on eviction, so a hit never needs the
+  // write lock
+  entry->referenced.store(true, std::memory_order_relaxed);
 
   ObjectCacheInfo& src = iter->second.info;
   if(src.status == -ENOENT) {
@@ -99,7 +102,19 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
                                     std::initializer_list<rgw_cache_entry_info*> cache_info_entries,
 				    RGWChainedCache::Entry *chained_entry)
 {
-  std::unique_lock l{lock};
+  // the entries may live in different shards; lock all of those, in shard
+  // order, so that none of them changes before the chained entry is added
+  std::vector<Shard*> locked;
+  for (auto cache_info : cache_info_entries) {
+    locked.push_back(&shard_of(cache_info->cache_locator));
+  }
+  std::sort(locked.begin(), locked.end());
+  locked.erase(std::unique(locked.begin(), locked.end()), locked.end());
+  std::vector<std::unique_lock<ceph::shared_mutex>> locks;
+  locks.reserve(locked.size());
+  for (auto shard : locked) {
+    locks.emplace_back(shard->lock);
+  }
 
   if (!enabled) {
     return false;
@@ -111,8 +126,9 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
   for (auto cache_info : cache_info_entries) {
     ldpp_dout(dpp, 10) << "chain_cache_entry: cache_locator="
 		   << cache_info->cache_locator << dendl;
-    auto iter = cache_map.find(cache_info->cache_locator);
-    if (iter == cache_map.end()) {
+    Shard& shard = shard_of(cache_info->cache_locator);
+    auto iter = shard.cache_map.find(cache_info->cache_locator);
+    if (iter == shard.cache_map.end()) {
       ldpp_dout(dpp, 20) << "chain_cache_entry: couldn't find cache locator" << dendl;
       return false;
     }
@@ -141,7 +157,8 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
 
 void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, rgw_cache_entry_info *cache_info)
 {
-  std::unique_lock l{lock};
+  Shard& shard = shard_of(name);
+  std::unique_lock l{shard.lock};
 
   if (!enabled) {
     return;
@@ -150,11 +167,11 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
   ldpp_dout(dpp, 10) << "cache put: name=" << name << " info.flags=0x"
                  << std::hex << info.flags << std::dec << dendl;
 
-  auto [iter, inserted] = cache_map.emplace(name, ObjectCacheEntry{});
+  auto [iter, inserted] = shard.cache_map.try_emplace(name);
   ObjectCacheEntry& entry = iter->second;
   entry.info.time_added = ceph::coarse_mono_clock::now();
   if (inserted) {
-    entry.lru_iter = lru.end();
+    entry.lru_iter = shard.lru.end();
   }
   ObjectCacheInfo& target = entry.info;
 
@@ -163,7 +180,7 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
   entry.chained_entries.clear();
   entry.gen++;
 
-  touch_lru(dpp, name, entry, entry.lru_iter);
+  touch_lru(dpp, shard, name, entry, entry.lru_iter);
 
   target.status = info.status;
 
@@ -218,14 +235,15 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
 // negative lookup. It must only invalidate.
 bool ObjectCache::invalidate_remove(const DoutPrefixProvider *dpp, const string& name)
 {
-  std::unique_lock l{lock};
+  Shard& shard = shard_of(name);
+  std::unique_lock l{shard.lock};
 
   if (!enabled) {
     return false;
   }
 
-  auto iter = cache_map.find(name);
-  if (iter == cache_map.end())
+  auto iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end())
     return false;
 
   ldpp_dout(dpp, 10) << "removing " << name << " from cache" << dendl;
@@ -235,16 +253,22 @@ bool ObjectCache::invalidate_remove(const DoutPrefixProvider *dpp, const string&
     kv.first->invalidate(kv.second);
   }
 
-  remove_lru(name, iter->second.lru_iter);
-  cache_map.erase(iter);
+  remove_lru(shard, iter->second.lru_iter);
+  shard.cache_map.erase(iter);
   return true;
 }
 
-void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, const string& name, ObjectCacheEntry& entry,
+void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, Shard& shard,
+			    const string& name, ObjectCacheEntry& entry,
 			    std::list<string>::iterator& lru_iter)
 {
-  while (lru_size > (size_t)cct->_conf->rgw_cache_lru_size) {
-    auto iter = lru.begin();
+  const size_t max_size = std::max<size_t>(
+    cct->_conf->rgw_cache_lru_size / shards.size(), 1);
+  // entries looked up since they last came around get another round,
+  // but only once per eviction so this can't go on forever
+  size_t second_chances = shard.lru_size;
+  while (shard.lru_size > max_size) {
+    auto iter = shard.lru.begin();
     if ((*iter).compare(name) == 0) {
       /*
        * if the entry we're touching happens to be at the lru end, don't remove it,
@@ -252,43 +276,45 @@ void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, const string& name, O
        */
       break;
     }
-    auto map_iter = cache_map.find(*iter);
+    auto map_iter = shard.cache_map.find(*iter);
+    if (map_iter != shard.cache_map.end() && second_chances > 0 &&
+	map_iter->second.referenced.exchange(false, std::memory_order_relaxed)) {
+      --second_chances;
+      shard.lru.splice(shard.lru.end(), shard.lru, iter);
+      continue;
+    }
     ldout(cct, 10) << "removing entry: name=" << *iter << " from cache LRU" << dendl;
-    if (map_iter != cache_map.end()) {
+    if (map_iter != shard.cache_map.end()) {
       ObjectCacheEntry& entry = map_iter->second;
       invalidate_lru(entry);
-      cache_map.erase(map_iter);
+      shard.cache_map.erase(map_iter);
     }
-    lru.pop_front();
-    lru_size--;
+    shard.lru.pop_front();
+    shard.lru_size--;
   }
 
-  if (lru_iter == lru.end()) {
-    lru.push_back(name);
-    lru_size++;
+  if (lru_iter == shard.lru.end()) {
+    shard.lru.push_back(name);
+    shard.lru_size++;
     lru_iter--;
     ldpp_dout(dpp, 10) << "adding " << name << " to cache LRU end" << dendl;
   } else {
     ldpp_dout(dpp, 10) << "moving " << name << " to cache LRU end" << dendl;
-    lru.erase(lru_iter);
-    lru.push_back(name);
-    lru_iter = lru.end();
-    --lru_iter;
+    shard.lru.splice(shard.lru.end(), shard.lru, lru_iter);
   }
 
-  lru_counter++;
-  entry.lru_promotion_ts = lru_counter;
+  entry.referenced.store(false, std::memory_order_relaxed);
 }
 
-void ObjectCache::remove_lru(const string& name,
+void ObjectCache::remove_lru(Shard& shard,
 			     std::list<string>::iterator& lru_iter)
 {
-  if (lru_iter == lru.end())
+  if (lru_iter == shard.lru.end())
     return;
 
-  lru.erase(lru_iter);
-  lru_size--;
-  lru_iter = lru.end();
+  shard.lru.erase(lru_iter);
+  shard.lru_size--;
+  lru_iter = shard.lru.end();
 }
 
 void ObjectCache::invalidate_lru(ObjectCacheEntry& entry)
@@ -302,7 +328,7 @@ void ObjectCache::invalidate_lru(ObjectCacheEntry& entry)
 
 void ObjectCache::set_enabled(bool status)
 {
-  std::unique_lock l{lock};
+  auto locks = lock_all();
 
   enabled = status;
 
@@ -313,32 +339,32 @@ void ObjectCache::set_enabled(bool status)
 
 void ObjectCache::invalidate_all()
 {
-  std::unique_lock l{lock};
+  auto locks = lock_all();
 
   do_invalidate_all();
 }
 
 void ObjectCache::do_invalidate_all()
 {
-  cache_map.clear();
-  lru.clear();
-
-  lru_size = 0;
-  lru_counter = 0;
-  lru_window = 0;
+  for (auto& shard : shards) {
+    shard->cache_map.clear();
+    shard->lru.clear();
+    shard->lru_size = 0;
+  }
 
+  std::lock_guard l{chained_lock};
   for (auto& cache : chained_cache) {
     cache->invalidate_all();
   }
 }
 
 void ObjectCache::chain_cache(RGWChainedCache *cache) {
-  std::unique_lock l{lock};
+  std::lock_guard l{chained_lock};
   chained_cache.push_back(cache);
 }
 
 void ObjectCache::unchain_cache(RGWChainedCache *cache) {
-  std::unique_lock l{lock};
+  std::lock_guard l{chained_lock};
 
   auto iter = chained_cache.begin();
   for (; iter != chained_cache.end(); ++iter) {
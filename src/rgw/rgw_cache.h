@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <map>
 #include <unordered_map>
@@ -151,36 +153,53 @@ public:
 struct ObjectCacheEntry {
   ObjectCacheInfo info;
   std::list<std::string>::iterator lru_iter;
-  uint64_t lru_promotion_ts;
+  // set by lookups, which only hold the lock shared; eviction gives a
+  // referenced entry another round through the lru instead of dropping it
+  mutable std::atomic<bool> referenced;
   uint64_t gen;
   std::vector<std::pair<RGWChainedCache *, std::string> > chained_entries;
 
-  ObjectCacheEntry() : lru_promotion_ts(0), gen(0) {}
+  ObjectCacheEntry() : referenced(false), gen(0) {}
 };
 
 class ObjectCache {
-  std::unordered_map<std::string, ObjectCacheEntry> cache_map;
-  std::list<std::string> lru;
-  unsigned long lru_size;
-  unsigned long lru_counter;
-  unsigned long lru_window;
-  ceph::shared_mutex lock = ceph::make_shared_mutex("ObjectCache");
+  // names are spread over independently locked shards, so that lookups of
+  // different objects do not all take the same lock
+  static constexpr unsigned num_shards = 16;
+
+  struct Shard {
+    std::unordered_map<std::string, ObjectCacheEntry> cache_map;
+    std::list<std::string> lru;
+    unsigned long lru_size = 0;
+    ceph::shared_mutex lock;
+
+    explicit Shard(const std::string& name)
+      : lock(ceph::make_shared_mutex(name)) {}
+  };
+  std::vector<std::unique_ptr<Shard>> shards;
   CephContext *cct;
 
+  ceph::mutex chained_lock = ceph::make_mutex("ObjectCache::chained_lock");
   std::vector<RGWChainedCache *> chained_cache;
 
-  bool enabled;
+  std::atomic<bool> enabled;
   ceph::timespan expiry;
 
-  void touch_lru(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheEntry& entry,
+  Shard& shard_of(const std::string& name) {
+    return *shards[std::hash<std::string>{}(name) % shards.size()];
+  }
+  std::vector<std::unique_lock<ceph::shared_mutex>> lock_all();
+
+  void touch_lru(const DoutPrefixProvider *dpp, Shard& shard,
+		 const std::string& name, ObjectCacheEntry& entry,
 		 std::list<std::string>::iterator& lru_iter);
-  void remove_lru(const std::string& name, std::list<std::string>::iterator& lru_iter);
+  void remove_lru(Shard& shard, std::list<std::string>::iterator& lru_iter);
   void invalidate_lru(ObjectCacheEntry& entry);
 
   void do_invalidate_all();
 
 public:
-  ObjectCache() : lru_size(0), lru_counter(0), lru_window(0), cct(NULL), enabled(false) { }
+  ObjectCache();
   ~ObjectCache();
   int get(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheInfo& bl, uint32_t mask, rgw_cache_entry_info *cache_info);
   std::optional<ObjectCacheInfo> get(const DoutPrefixProvider *dpp, const std::string& name) {
@@ -191,12 +210,14 @@ public:
 
   template<typename F>
   void for_each(const F& f) {
-    std::shared_lock l{lock};
-    if (enabled) {
-      auto now  = ceph::coarse_mono_clock::now();
-      for (const auto& [name, entry] : cache_map) {
-        if (expiry.count() && (now - entry.info.time_added) < expiry) {
-          f(name, entry);
+    for (auto& shard : shards) {
+      std::shared_lock l{shard->lock};
+      if (enabled) {
+        auto now  = ceph::coarse_mono_clock::now();
+        for (const auto& [name, entry] : shard->cache_map) {
+          if (expiry.count() && (now - entry.info.time_added) < expiry) {
+            f(name, entry);
+          }
         }
       }
     }
@@ -206,7 +227,6 @@ public:
   bool invalidate_remove(const DoutPrefixProvider *dpp, const std::string& name);
   void set_ctx(CephContext *_cct) {
     cct = _cct;
-    lru_window = cct->_conf->rgw_cache_lru_size / 2;
     expiry = std::chrono::seconds(cct->_conf.get_val<uint64_t>(
 						"rgw_cache_expiry_interval"));
   }
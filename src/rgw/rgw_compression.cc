@@ -41,8 +41,73 @@ int rgw_compression_info_from_attrset(const map<string, bufferlist>& attrs,
 
 //------------RGWPutObj_Compress---------------
 
+RGWPutObj_Compress::RGWPutObj_Compress(CephContext* cct_,
+                                       CompressorRef compressor,
+                                       rgw::sal::DataProcessor *next,
+                                       optional_yield y)
+  : Pipe(next), cct(cct_), compressor(compressor)
+{
+  if (auto pool = rgw::get_filter_pool(cct); pool) {
+    jobs.emplace(*pool, cct->_conf.get_val<uint64_t>(
+                          "rgw_filter_max_pending_chunks"), y);
+  }
+}
+
+void RGWPutObj_Compress::add_block(uint64_t logical_offset, uint64_t len)
+{
+  compression_block newbl;
+  size_t bs = blocks.size();
+  newbl.old_ofs = logical_offset;
+  newbl.new_ofs = bs > 0 ? blocks[bs-1].len + blocks[bs-1].new_ofs : 0;
+  newbl.len = len;
+  blocks.push_back(newbl);
+
+  compressed_ofs = newbl.new_ofs;
+}
+
+int RGWPutObj_Compress::write_next_compressed()
+{
+  auto c = jobs->pop();
+  if (c.r < 0) {
+    lderr(cct) << "Compression failed with exit code " << c.r
+        << " for next part, compression process failed" << dendl;
+    return -EIO;
+  }
+  compressor_message = c.compressor_message;
+  add_block(c.logical_offset, c.out.length());
+  return Pipe::process(std::move(c.out), compressed_ofs);
+}
+
 int RGWPutObj_Compress::process(bufferlist&& in, uint64_t logical_offset)
 {
+  if (jobs) {
+    if (in.length() > 0 && logical_offset > 0 && compressed) {
+      // the following parts are compressed alongside the writes of the
+      // previous ones
+      if (jobs->full()) {
+        int r = write_next_compressed();
+        if (r < 0) {
+          return r;
+        }
+      }
+      ldout(cct, 10) << "Compression for rgw is enabled, compress part " << in.length() << dendl;
+      jobs->submit([compressor = compressor, in = std::move(in),
+                    logical_offset] () mutable {
+          Compressed c;
+          c.logical_offset = logical_offset;
+          c.r = compressor->compress(in, c.out, c.compressor_message);
+          return c;
+        });
+      return 0;
+    }
+    while (!jobs->empty()) {
+      int r = write_next_compressed();
+      if (r < 0) {
+        return r;
+      }
+    }
+  }
+
   bufferlist out;
   compressed_ofs = logical_offset;
 
@@ -64,15 +129,7 @@ int RGWPutObj_Compress::process(bufferlist&& in, uint64_t logical_offset)
         out = std::move(in);
       } else {
         compressed = true;
-    
-        compression_block newbl;
-        size_t bs = blocks.size();
-        newbl.old_ofs = logical_offset;
-        newbl.new_ofs = bs > 0 ? blocks[bs-1].len + blocks[bs-1].new_ofs : 0;
-        newbl.len = out.length();
-        blocks.push_back(newbl);
-
-	compressed_ofs = newbl.new_ofs;
+        add_block(logical_offset, out.length());
       }
     } else {
       compressed = false;
@@ -91,7 +148,8 @@ int RGWPutObj_Compress::process(bufferlist&& in, uint64_t logical_offset)
 RGWGetObj_Decompress::RGWGetObj_Decompress(CephContext* cct_, 
                                            RGWCompressionInfo* cs_info_, 
                                            bool partial_content_,
-                                           RGWGetObj_Filter* next): RGWGetObj_Filter(next),
+                                           RGWGetObj_Filter* next,
+                                           optional_yield y): RGWGetObj_Filter(next),
                                                                 cct(cct_),
                                                                 cs_info(cs_info_),
                                                                 partial_content(partial_content_),
@@ -102,6 +160,10 @@ RGWGetObj_Decompress::RGWGetObj_Decompress(CephContext* cct_,
   compressor = Compressor::create(cct, cs_info->compression_type);
   if (!compressor.get())
     lderr(cct) << "Cannot load compressor of type " << cs_info->compression_type << dendl;
+  if (auto pool = rgw::get_filter_pool(cct); pool) {
+    jobs.emplace(*pool, cct->_conf.get_val<uint64_t>(
+                          "rgw_filter_max_pending_chunks"), y);
+  }
 }
 
 int RGWGetObj_Decompress::handle_data(bufferlist& bl, off_t bl_ofs, off_t bl_len)
@@ -125,6 +187,9 @@ int RGWGetObj_Decompress::handle_data(bufferlist& bl, off_t bl_ofs, off_t bl_len
   } else {
     in_bl = std::move(temp_in_bl);
   }
+  if (jobs) {
+    return handle_data_parallel(in_bl);
+  }
   bl_len = in_bl.length();
   
   auto iter_in_bl = in_bl.cbegin();
@@ -180,6 +245,85 @@ int RGWGetObj_Decompress::handle_data(bufferlist& bl, off_t bl_ofs, off_t bl_len
   return r;
 }
 
+int RGWGetObj_Decompress::handle_data_parallel(bufferlist& in_bl)
+{
+  const off_t bl_len = in_bl.length();
+  auto iter_in_bl = in_bl.cbegin();
+  while (first_block <= last_block) {
+    bufferlist tmp;
+    off_t ofs_in_bl = first_block->new_ofs - cur_ofs;
+    if (ofs_in_bl + (off_t)first_block->len > bl_len) {
+      // not complete block, put it to waiting
+      unsigned tail = bl_len - ofs_in_bl;
+      if (iter_in_bl.get_off() != ofs_in_bl) {
+        iter_in_bl.seek(ofs_in_bl);
+      }
+      iter_in_bl.copy(tail, waiting);
+      cur_ofs -= tail;
+      break;
+    }
+    if (iter_in_bl.get_off() != ofs_in_bl) {
+      iter_in_bl.seek(ofs_in_bl);
+    }
+    iter_in_bl.copy(first_block->len, tmp);
+    ++first_block;
+
+    // the decompressed blocks are sent in order as they come back, while
+    // the following ones are still being decompressed
+    if (jobs->full()) {
+      int r = send_next_decompressed();
+      if (r < 0) {
+        return r;
+      }
+    }
+    jobs->submit([compressor = compressor, tmp = std::move(tmp),
+                  message = cs_info->compressor_message] {
+        Decompressed d;
+        d.r = compressor->decompress(tmp, d.out, message);
+        return d;
+      });
+  }
+  cur_ofs += bl_len;
+  return 0;
+}
+
+int RGWGetObj_Decompress::send_next_decompressed()
+{
+  auto d = jobs->pop();
+  if (d.r < 0) {
+    lderr(cct) << "Decompression failed with exit code " << d.r << dendl;
+    return d.r;
+  }
+  bufferlist& out_bl = d.out;
+  while (q_len > 0 && out_bl.length() > static_cast<uint64_t>(q_ofs)) {
+    off_t ch_len = std::min<off_t>({
+        static_cast<off_t>(cct->_conf->rgw_max_chunk_size), q_len,
+        static_cast<off_t>(out_bl.length()) - q_ofs});
+    int r = next->handle_data(out_bl, q_ofs, ch_len);
+    if (r < 0) {
+      lsubdout(cct, rgw, 0) << "handle_data failed with exit code " << r << dendl;
+      return r;
+    }
+    out_bl.splice(0, q_ofs + ch_len);
+    q_len -= ch_len;
+    q_ofs = 0;
+  }
+  return 0;
+}
+
+int RGWGetObj_Decompress::flush()
+{
+  if (jobs) {
+    while (!jobs->empty()) {
+      int r = send_next_decompressed();
+      if (r < 0) {
+        return r;
+      }
+    }
+  }
+  return RGWGetObj_Filter::flush();
+}
+
 int RGWGetObj_Decompress::fixup_range(off_t& ofs, off_t& end)
 {
   if (partial_content) {
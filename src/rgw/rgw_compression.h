@@ -9,6 +9,7 @@
 #include "rgw_putobj.h"
 #include "rgw_op.h"
 #include "rgw_compression_types.h"
+#include "rgw_filter_pool.h"
 
 int rgw_compression_info_from_attr(const bufferlist& attr,
                                    bool& need_decompress,
@@ -27,15 +28,26 @@ class RGWGetObj_Decompress : public RGWGetObj_Filter
   off_t q_ofs, q_len;
   uint64_t cur_ofs;
   bufferlist waiting;
+
+  // decompressed blocks, when they are decompressed on the filter pool
+  struct Decompressed {
+    int r;
+    bufferlist out;
+  };
+  std::optional<rgw::OrderedFilterJobs<Decompressed>> jobs;
+  int send_next_decompressed();
+  int handle_data_parallel(bufferlist& in_bl);
 public:
   RGWGetObj_Decompress(CephContext* cct_, 
                        RGWCompressionInfo* cs_info_, 
                        bool partial_content_,
-                       RGWGetObj_Filter* next);
+                       RGWGetObj_Filter* next,
+                       optional_yield y);
   virtual ~RGWGetObj_Decompress() override {}
 
   int handle_data(bufferlist& bl, off_t bl_ofs, off_t bl_len) override;
   int fixup_range(off_t& ofs, off_t& end) override;
+  int flush() override;
 
 };
 
@@ -47,10 +59,21 @@ class RGWPutObj_Compress : public rgw::putobj::Pipe
   std::optional<int32_t> compressor_message;
   std::vector<compression_block> blocks;
   uint64_t compressed_ofs{0};
+
+  // once the first part compressed, the following ones are compressed on
+  // the filter pool, if there is one
+  struct Compressed {
+    int r;
+    bufferlist out;
+    uint64_t logical_offset;
+    std::optional<int32_t> compressor_message;
+  };
+  std::optional<rgw::OrderedFilterJobs<Compressed>> jobs;
+  void add_block(uint64_t logical_offset, uint64_t len);
+  int write_next_compressed();
 public:
   RGWPutObj_Compress(CephContext* cct_, CompressorRef compressor,
-                     rgw::sal::DataProcessor *next)
-    : Pipe(next), cct(cct_), compressor(compressor) {}
+                     rgw::sal::DataProcessor *next, optional_yield y);
   virtual ~RGWPutObj_Compress() override {};
 
   int process(bufferlist&& data, uint64_t logical_offset) override;
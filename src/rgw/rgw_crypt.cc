@@ -821,8 +821,12 @@ int RGWGetObj_BlockDecrypt::flush() {
   // flush up to block boundaries, aligned or not
   if (cache.length() > 0) {
     res = process(cache, part_ofs, cache.length());
+    if (res < 0) {
+      return res;
+    }
   }
-  return res;
+  // filters after us may be holding data back as well
+  return RGWGetObj_Filter::flush();
 }
 
 RGWPutObj_BlockEncrypt::RGWPutObj_BlockEncrypt(const DoutPrefixProvider *dpp,
@@ -837,6 +841,19 @@ RGWPutObj_BlockEncrypt::RGWPutObj_BlockEncrypt(const DoutPrefixProvider *dpp,
     block_size(this->crypt->get_block_size()),
     y(y)
 {
+  if (auto pool = rgw::get_filter_pool(cct); pool) {
+    jobs.emplace(*pool, cct->_conf.get_val<uint64_t>(
+                          "rgw_filter_max_pending_chunks"), y);
+  }
+}
+
+int RGWPutObj_BlockEncrypt::write_next_encrypted()
+{
+  auto e = jobs->pop();
+  if (!e.ok) {
+    return -ERR_INTERNAL_ERROR;
+  }
+  return Pipe::process(std::move(e.out), e.logical_offset);
 }
 
 int RGWPutObj_BlockEncrypt::process(bufferlist&& data, uint64_t logical_offset)
@@ -854,7 +871,26 @@ int RGWPutObj_BlockEncrypt::process(bufferlist&& data, uint64_t logical_offset)
   if (flush) {
     proc_size = cache.length();
   }
-  if (proc_size > 0) {
+  if (proc_size > 0 && jobs) {
+    // encrypt alongside the writes of the previous chunks
+    if (jobs->full()) {
+      int r = write_next_encrypted();
+      if (r < 0) {
+        return r;
+      }
+    }
+    bufferlist in;
+    cache.splice(0, proc_size, &in);
+    jobs->submit([crypt = crypt.get(), in = std::move(in),
+                  logical_offset, proc_size] () mutable {
+        Encrypted e;
+        e.logical_offset = logical_offset;
+        e.ok = crypt->encrypt(in, 0, proc_size, e.out, logical_offset,
+                              null_yield);
+        return e;
+      });
+    logical_offset += proc_size;
+  } else if (proc_size > 0) {
     bufferlist in, out;
     cache.splice(0, proc_size, &in);
     if (!crypt->encrypt(in, 0, proc_size, out, logical_offset, y)) {
@@ -867,6 +903,12 @@ int RGWPutObj_BlockEncrypt::process(bufferlist&& data, uint64_t logical_offset)
   }
 
   if (flush) {
+    while (jobs && !jobs->empty()) {
+      int r = write_next_encrypted();
+      if (r < 0) {
+        return r;
+      }
+    }
     /*replicate 0-sized handle_data*/
     return Pipe::process({}, logical_offset);
   }
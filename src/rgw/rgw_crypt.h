@@ -13,6 +13,7 @@
 #include <rgw/rgw_rest.h>
 #include <rgw/rgw_rest_s3.h>
 #include "rgw_putobj.h"
+#include "rgw_filter_pool.h"
 #include "common/async/yield_context.h"
 
 /**
@@ -136,6 +137,15 @@ class RGWPutObj_BlockEncrypt : public rgw::putobj::Pipe
   bufferlist cache; /**< stores extra data that could not (yet) be processed by BlockCrypt */
   const size_t block_size; /**< snapshot of \ref BlockCrypt.get_block_size() */
   optional_yield y;
+
+  struct Encrypted {
+    bool ok;
+    bufferlist out;
+    uint64_t logical_offset;
+  };
+  /**< chunks being encrypted on the filter pool, if there is one */
+  std::optional<rgw::OrderedFilterJobs<Encrypted>> jobs;
+  int write_next_encrypted();
 public:
   RGWPutObj_BlockEncrypt(const DoutPrefixProvider *dpp,
                          CephContext* cct,
@@ -0,0 +1,21 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#include "rgw_filter_pool.h"
+
+#include "common/ceph_context.h"
+
+namespace rgw {
+
+boost::asio::thread_pool* get_filter_pool(CephContext* cct)
+{
+  const auto threads = cct->_conf.get_val<uint64_t>("rgw_filter_threads");
+  if (threads == 0) {
+    return nullptr;
+  }
+  // sized by whoever gets here first; the option is not runtime changeable
+  static boost::asio::thread_pool pool(threads);
+  return &pool;
+}
+
+} // namespace rgw
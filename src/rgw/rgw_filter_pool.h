@@ -0,0 +1,127 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include "include/common_fwd.h"
+#include "common/async/completion.h"
+#include "common/async/yield_context.h"
+
+namespace rgw {
+
+/// the threads shared by all requests for the compression and encryption
+/// filters to transform chunks on, sized by rgw_filter_threads. returns
+/// nullptr if that is 0, in which case the filters work inline
+boost::asio::thread_pool* get_filter_pool(CephContext* cct);
+
+/// the transforms of consecutive chunks of one object, running on the
+/// filter pool with at most rgw_filter_max_pending_chunks of them in
+/// flight. results come back in the order the chunks were submitted.
+/// waiting for a result suspends the request's coroutine when there is
+/// one, rather than blocking the frontend thread under it
+template <typename Result>
+class OrderedFilterJobs {
+  using Signature = void(boost::system::error_code);
+  using Completion = ceph::async::Completion<Signature>;
+
+  struct Job {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool done = false;
+    std::optional<Result> result;
+    std::exception_ptr eptr;
+    std::unique_ptr<Completion> waiter; // posted once done, if set
+
+    void finish() {
+      std::unique_lock l{mutex};
+      done = true;
+      if (waiter) {
+        auto c = std::move(waiter);
+        l.unlock();
+        Completion::post(std::move(c), boost::system::error_code{});
+      } else {
+        cond.notify_one();
+      }
+    }
+  };
+
+  boost::asio::thread_pool& pool;
+  const size_t max_pending;
+  optional_yield y;
+  std::deque<std::shared_ptr<Job>> pending;
+
+  template <typename CompletionToken>
+  auto async_wait(Job& job, std::unique_lock<std::mutex>& l,
+                  CompletionToken&& token) {
+    boost::asio::async_completion<CompletionToken, Signature> init(token);
+    job.waiter = Completion::create(y.get_io_context().get_executor(),
+                                    std::move(init.completion_handler));
+    l.unlock();
+    return init.result.get();
+  }
+
+  void wait(Job& job) {
+    std::unique_lock l{job.mutex};
+    if (job.done) {
+      return;
+    }
+    if (y) {
+      boost::system::error_code ec;
+      async_wait(job, l, y.get_yield_context()[ec]);
+    } else {
+      job.cond.wait(l, [&job] { return job.done; });
+    }
+  }
+
+ public:
+  OrderedFilterJobs(boost::asio::thread_pool& pool, size_t max_pending,
+                    optional_yield y)
+    : pool(pool), max_pending(max_pending), y(y) {}
+  ~OrderedFilterJobs() {
+    // the jobs may refer to state of the filter that owns us
+    for (auto& job : pending) {
+      wait(*job);
+    }
+  }
+
+  bool empty() const { return pending.empty(); }
+  bool full() const { return pending.size() >= max_pending; }
+
+  template <typename F>
+  void submit(F&& f) {
+    auto job = std::make_shared<Job>();
+    pending.push_back(job);
+    boost::asio::post(pool, [job, f = std::forward<F>(f)] () mutable {
+        try {
+          job->result.emplace(f());
+        } catch (...) {
+          job->eptr = std::current_exception();
+        }
+        job->finish();
+      });
+  }
+
+  /// wait for the oldest job and return its result
+  Result pop() {
+    auto job = std::move(pending.front());
+    pending.pop_front();
+    wait(*job);
+    if (job->eptr) {
+      std::rethrow_exception(job->eptr);
+    }
+    return std::move(*job->result);
+  }
+};
+
+} // namespace rgw
@@ -257,6 +257,30 @@ public:
   }
 }; // class OwnedBuffer
 
+// A Buffer over the memory of a bufferlist, which it keeps alive, so
+// that data read from rados reaches arrow without another copy
+class BufferlistBuffer : public arw::Buffer {
+
+  bufferlist bl;
+
+  BufferlistBuffer(bufferlist&& _bl) :
+    Buffer(nullptr, 0),
+    bl(std::move(_bl))
+    {
+      // rebuilds the bufferlist only if it is fragmented
+      data_ = reinterpret_cast<const uint8_t*>(bl.c_str());
+      size_ = bl.length();
+      capacity_ = size_;
+    }
+
+public:
+
+  static std::shared_ptr<BufferlistBuffer> make(bufferlist&& bl) {
+    return std::shared_ptr<BufferlistBuffer>(
+      new BufferlistBuffer(std::move(bl)));
+  }
+}; // class BufferlistBuffer
+
 #if 0 // remove classes used for testing and incrementally building
 
 // make local to DoGet eventually
@@ -557,9 +581,8 @@ public:
     return is_closed;
   }
 
-  arw::Result<int64_t> Read(int64_t nbytes, void* out) override {
-    INFO << "entered: asking for " << nbytes << " bytes" << dendl;
-
+  // reads the next nbytes of the object into bl and advances position
+  arw::Result<int64_t> read_bl(int64_t nbytes, bufferlist& bl) {
     if (position < 0) {
       ERROR << "error, position indicated error" << dendl;
       return arw::Status::IOError("object read op is in bad state");
@@ -568,8 +591,6 @@ public:
     // note: read function reads through end_position inclusive
     int64_t end_position = position + nbytes - 1;
 
-    bufferlist bl;
-
     const int64_t bytes_read =
       op->read(position, end_position, bl, null_yield, &dp);
     if (bytes_read < 0) {
@@ -582,9 +603,11 @@ public:
 	bytes_read);
     }
 
-    // TODO: see if there's a way to get rid of this copy, perhaps
-    // updating rgw::sal::read_op
-    bl.cbegin().copy(bytes_read, reinterpret_cast<char*>(out));
+    if ((int64_t) bl.length() > bytes_read) {
+      bufferlist head;
+      head.substr_of(bl, 0, bytes_read);
+      bl = std::move(head);
+    }
 
     position += bytes_read;
 
@@ -596,21 +619,25 @@ public:
     return bytes_read;
   }
 
-  arw::Result<std::shared_ptr<arw::Buffer>> Read(int64_t nbytes) override {
+  arw::Result<int64_t> Read(int64_t nbytes, void* out) override {
     INFO << "entered: asking for " << nbytes << " bytes" << dendl;
 
-    std::shared_ptr<OwnedBuffer> buffer;
-    ARROW_ASSIGN_OR_RAISE(buffer, OwnedBuffer::make(nbytes));
+    bufferlist bl;
+    ARROW_ASSIGN_OR_RAISE(const int64_t bytes_read, read_bl(nbytes, bl));
+    bl.cbegin().copy(bytes_read, reinterpret_cast<char*>(out));
+    return bytes_read;
+  }
 
-    ARROW_ASSIGN_OR_RAISE(const int64_t bytes_read,
-			  Read(nbytes, buffer->writeable_data()));
-    buffer->set_size(bytes_read);
+  arw::Result<std::shared_ptr<arw::Buffer>> Read(int64_t nbytes) override {
+    INFO << "entered: asking for " << nbytes << " bytes" << dendl;
 
-    return buffer;
+    bufferlist bl;
+    ARROW_RETURN_NOT_OK(read_bl(nbytes, bl));
+    return BufferlistBuffer::make(std::move(bl));
   }
 
   bool supports_zero_copy() const override {
-    return false;
+    return true;
   }
 
   // implement Seekable
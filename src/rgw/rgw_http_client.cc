@@ -16,6 +16,7 @@
 #include "common/RefCountedObj.h"
 
 #include "rgw_coroutine.h"
+#include "rgw_perf_counters.h"
 #include "rgw_tools.h"
 
 #include <atomic>
@@ -591,6 +592,13 @@ int RGWHTTPClient::init_request(rgw_http_req_data *_req_data)
   curl_easy_setopt(easy_handle, CURLOPT_READFUNCTION, send_http_data);
   curl_easy_setopt(easy_handle, CURLOPT_READDATA, (void *)req_data);
   curl_easy_setopt(easy_handle, CURLOPT_BUFFERSIZE, cct->_conf->rgw_curl_buffersize);
+  if (cct->_conf.get_val<bool>("rgw_curl_http2")) {
+    /* falls back to http/1.1 for plain http and for servers that don't
+     * negotiate h2; waiting for a connection that can multiplex beats
+     * opening another one */
+    curl_easy_setopt(easy_handle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(easy_handle, CURLOPT_PIPEWAIT, 1L);
+  }
   if (send_data_hint || is_upload_request(method)) {
     curl_easy_setopt(easy_handle, CURLOPT_UPLOAD, 1L);
   }
@@ -771,6 +779,9 @@ RGWHTTPManager::RGWHTTPManager(CephContext *_cct, RGWCompletionManager *_cm) : c
                                                     completion_mgr(_cm)
 {
   multi_handle = (void *)curl_multi_init();
+  if (cct->_conf.get_val<bool>("rgw_curl_http2")) {
+    curl_multi_setopt((CURLM *)multi_handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  }
   thread_pipe[0] = -1;
   thread_pipe[1] = -1;
 }
@@ -1131,6 +1142,19 @@ void *RGWHTTPManager::reqs_thread_entry()
 	curl_easy_getinfo(e, CURLINFO_PRIVATE, (void **)&req_data);
 	curl_multi_remove_handle((CURLM *)multi_handle, e);
 
+	if (perfcounter) {
+	  /* a transfer that completed without a new connection went over
+	   * one from the pool of the multi handle; a failed one may not
+	   * have had a connection at all */
+	  long num_connects = 0;
+	  curl_easy_getinfo(e, CURLINFO_NUM_CONNECTS, &num_connects);
+	  if (num_connects > 0) {
+	    perfcounter->inc(l_rgw_http_conn_new);
+	  } else if (result == CURLE_OK) {
+	    perfcounter->inc(l_rgw_http_conn_reused);
+	  }
+	}
+
 	long http_status;
         int status;
         if (!req_data->user_ret) {
@@ -260,6 +260,17 @@ bool new_producer(connection_t* conn) {
       }
   }
 
+  // let the producer collect messages into larger batches per partition
+  // instead of sending a request per notification
+  if (const auto linger_ms = conn->cct->_conf.get_val<uint64_t>("rgw_kafka_linger_ms"); linger_ms > 0) {
+    const auto value = std::to_string(linger_ms);
+    if (rd_kafka_conf_set(conn->temp_conf, "queue.buffering.max.ms", value.c_str(), errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) goto conf_error;
+  }
+  if (const auto batch_size = conn->cct->_conf.get_val<uint64_t>("rgw_kafka_batch_num_messages"); batch_size > 0) {
+    const auto value = std::to_string(batch_size);
+    if (rd_kafka_conf_set(conn->temp_conf, "batch.num.messages", value.c_str(), errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) goto conf_error;
+  }
+
   // set the global callback for delivery success/fail
   rd_kafka_conf_set_dr_msg_cb(conn->temp_conf, message_callback);
 
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <tuple>
 #include <functional>
+#include <future>
 
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string.hpp>
@@ -374,6 +375,24 @@ class LCObjsLister {
   rgw_bucket_dir_entry pre_obj;
   int64_t delay_ms;
 
+  /* the page following list_results, listed while the current one is
+   * being worked on */
+  std::future<int> prefetch;
+  rgw::sal::Bucket::ListParams prefetch_params;
+  rgw::sal::Bucket::ListResults prefetch_results;
+
+  void start_prefetch(const DoutPrefixProvider *dpp) {
+    if (!list_results.is_truncated || list_results.objs.empty()) {
+      return;
+    }
+    prefetch_params = list_params;
+    prefetch_params.marker = list_results.objs.back().key;
+    prefetch = std::async(std::launch::async, [this, dpp] {
+      return bucket->list(dpp, prefetch_params, 1000, prefetch_results,
+			  null_yield);
+    });
+  }
+
 public:
   LCObjsLister(rgw::sal::Driver* _driver, rgw::sal::Bucket* _bucket) :
       driver(_driver), bucket(_bucket) {
@@ -382,6 +401,12 @@ public:
     delay_ms = driver->ctx()->_conf.get_val<int64_t>("rgw_lc_thread_delay");
   }
 
+  ~LCObjsLister() {
+    if (prefetch.valid()) {
+      prefetch.wait();
+    }
+  }
+
   void set_prefix(const string& p) {
     prefix = p;
     list_params.prefix = prefix;
@@ -392,12 +417,23 @@ public:
   }
 
   int fetch(const DoutPrefixProvider *dpp) {
-    int ret = bucket->list(dpp, list_params, 1000, list_results, null_yield);
+    int ret;
+    if (prefetch.valid()) {
+      ret = prefetch.get();
+      if (ret >= 0 && prefetch_params.marker == list_params.marker) {
+	list_results = std::move(prefetch_results);
+      } else {
+	ret = bucket->list(dpp, list_params, 1000, list_results, null_yield);
+      }
+    } else {
+      ret = bucket->list(dpp, list_params, 1000, list_results, null_yield);
+    }
     if (ret < 0) {
       return ret;
     }
 
     obj_iter = list_results.objs.begin();
+    start_prefetch(dpp);
 
     return 0;
   }
@@ -1,4 +1,5 @@
 #include <string>
+#include <unordered_map>
 #include <lua.hpp>
 #include "common/ceph_context.h"
 #include "common/debug.h"
@@ -177,5 +178,41 @@ lua_state_guard::~lua_state_guard() {
   }
 }
 
+namespace {
+// bytecode of the scripts this thread ran, keyed by their source, so that
+// a changed script simply gets a new entry
+thread_local std::unordered_map<std::string, std::string> compiled_scripts;
+constexpr std::size_t MAX_COMPILED_SCRIPTS = 16;
+
+int bytecode_writer(lua_State*, const void* p, std::size_t size, void* ud) {
+  static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+  return 0;
+}
+}
+
+int dostring_cached(lua_State* L, const std::string& script) {
+  int rc;
+  if (auto it = compiled_scripts.find(script); it != compiled_scripts.end()) {
+    // the dump keeps the debug info, so errors read the same as when parsed
+    rc = luaL_loadbufferx(L, it->second.data(), it->second.size(),
+        script.c_str(), "b");
+  } else {
+    rc = luaL_loadstring(L, script.c_str());
+    if (rc == LUA_OK) {
+      std::string bytecode;
+      if (lua_dump(L, bytecode_writer, &bytecode, 0) == 0) {
+        if (compiled_scripts.size() >= MAX_COMPILED_SCRIPTS) {
+          compiled_scripts.clear();
+        }
+        compiled_scripts.emplace(script, std::move(bytecode));
+      }
+    }
+  }
+  if (rc != LUA_OK) {
+    return rc;
+  }
+  return lua_pcall(L, 0, LUA_MULTRET, 0);
+}
+
 } // namespace rgw::lua
 
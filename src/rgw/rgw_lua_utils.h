@@ -77,6 +77,10 @@ public:
 
 int dostring(lua_State* L, const char* str);
 
+// like luaL_dostring(), but the script is only parsed the first time the
+// calling thread runs it, and its compiled bytecode is loaded after that
+int dostring_cached(lua_State* L, const std::string& script);
+
 constexpr const int MAX_LUA_VALUE_SIZE = 1000;
 constexpr const int MAX_LUA_KEY_ENTRIES = 100000;
 
@@ -1695,7 +1695,7 @@ int RGWGetObj::read_user_manifest_part(rgw::sal::Bucket* bucket,
           << ", actual read size=" << ent.meta.size << dendl;
       return -EIO;
     }
-    decompress.emplace(s->cct, &cs_info, partial_content, filter);
+    decompress.emplace(s->cct, &cs_info, partial_content, filter, s->yield);
     filter = &*decompress;
   }
   else
@@ -2351,7 +2351,7 @@ void RGWGetObj::execute(optional_yield y)
   if (need_decompress && (!encrypted || !skip_decrypt)) {
     s->obj_size = cs_info.orig_size;
     s->object->set_obj_size(cs_info.orig_size);
-    decompress.emplace(s->cct, &cs_info, partial_content, filter);
+    decompress.emplace(s->cct, &cs_info, partial_content, filter, s->yield);
     filter = &*decompress;
   }
 
@@ -4045,7 +4045,7 @@ int RGWPutObj::get_data(const off_t fst, const off_t lst, bufferlist& bl)
   if (need_decompress)
   {
     obj_size = cs_info.orig_size;
-    decompress.emplace(s->cct, &cs_info, partial_content, filter);
+    decompress.emplace(s->cct, &cs_info, partial_content, filter, s->yield);
     filter = &*decompress;
   }
 
@@ -4355,7 +4355,7 @@ void RGWPutObj::execute(optional_yield y)
         ldpp_dout(this, 1) << "Cannot load plugin for compression type "
             << compression_type << dendl;
       } else {
-        compressor.emplace(s->cct, plugin, filter);
+        compressor.emplace(s->cct, plugin, filter, s->yield);
         filter = &*compressor;
         // always send incompressible hint when rgw is itself doing compression
         s->object->set_compressed();
@@ -4713,7 +4713,7 @@ void RGWPostObj::execute(optional_yield y)
           ldpp_dout(this, 1) << "Cannot load plugin for compression type "
                            << compression_type << dendl;
         } else {
-          compressor.emplace(s->cct, plugin, filter);
+          compressor.emplace(s->cct, plugin, filter, s->yield);
           filter = &*compressor;
         }
       }
@@ -7877,7 +7877,7 @@ int RGWBulkUploadOp::handle_file(const std::string_view path,
       ldpp_dout(this, 1) << "Cannot load plugin for rgw_compression_type "
           << compression_type << dendl;
     } else {
-      compressor.emplace(s->cct, plugin, filter);
+      compressor.emplace(s->cct, plugin, filter, s->yield);
       filter = &*compressor;
     }
   }
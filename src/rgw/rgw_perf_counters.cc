@@ -59,6 +59,9 @@ void add_rgw_frontend_counters(PerfCountersBuilder *pcb) {
   pcb->add_u64_counter(l_rgw_lua_script_ok, "lua_script_ok", "Successful executions of Lua scripts");
   pcb->add_u64_counter(l_rgw_lua_script_fail, "lua_script_fail", "Failed executions of Lua scripts");
   pcb->add_u64(l_rgw_lua_current_vms, "lua_current_vms", "Number of Lua VMs currently being executed");
+
+  pcb->add_u64_counter(l_rgw_http_conn_new, "http_client_conn_new", "Outgoing HTTP requests that opened a new connection");
+  pcb->add_u64_counter(l_rgw_http_conn_reused, "http_client_conn_reused", "Outgoing HTTP requests sent over a pooled connection");
 }
 
 void add_rgw_op_counters(PerfCountersBuilder *lpcb) {
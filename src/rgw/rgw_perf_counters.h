@@ -49,6 +49,9 @@ enum {
   l_rgw_lua_script_ok,
   l_rgw_lua_script_fail,
 
+  l_rgw_http_conn_new,
+  l_rgw_http_conn_reused,
+
   l_rgw_last,
 };
 
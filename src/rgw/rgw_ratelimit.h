@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <chrono>
 #include <thread>
 #include <condition_variable>
@@ -145,11 +146,18 @@ class RateLimiterEntry {
 class RateLimiter {
 
   static constexpr size_t map_size = 2000000; // will create it with the closest upper prime number
-  std::shared_mutex insert_lock;
+  // the entries are spread over independently locked shards, so that
+  // concurrent requests only contend when their keys land on the same one
+  static constexpr size_t num_shards = 16;
+  static constexpr size_t shard_map_size = map_size / num_shards;
   std::atomic_bool& replacing;
   std::condition_variable& cv;
   typedef std::unordered_map<std::string, RateLimiterEntry> hash_map;
-  hash_map ratelimit_entries{map_size};
+  struct alignas(64) shard_t {
+    std::shared_mutex insert_lock;
+    hash_map ratelimit_entries{shard_map_size};
+  };
+  std::array<shard_t, num_shards> shards;
   static bool is_read_op(const std::string_view method) {
     if (method == "GET" || method == "HEAD")
     {
@@ -160,18 +168,19 @@ class RateLimiter {
 
     // find or create an entry, and return its iterator
   auto& find_or_create(const std::string& key) {
-    std::shared_lock rlock(insert_lock);
-    if (ratelimit_entries.size() > 0.9 * map_size && replacing == false)
+    auto& shard = shards[std::hash<std::string>{}(key) % num_shards];
+    std::shared_lock rlock(shard.insert_lock);
+    if (shard.ratelimit_entries.size() > 0.9 * shard_map_size && replacing == false)
     {
       replacing = true;
       cv.notify_all();
     }
-    auto ret = ratelimit_entries.find(key);
+    auto ret = shard.ratelimit_entries.find(key);
     rlock.unlock();
-    if (ret == ratelimit_entries.end())
+    if (ret == shard.ratelimit_entries.end())
     {
-      std::unique_lock wlock(insert_lock);
-      ret = ratelimit_entries.emplace(std::piecewise_construct,
+      std::unique_lock wlock(shard.insert_lock);
+      ret = shard.ratelimit_entries.emplace(std::piecewise_construct,
                                  std::forward_as_tuple(key),
                                  std::forward_as_tuple()).first;
     }
@@ -190,7 +199,9 @@ class RateLimiter {
       : replacing(replacing), cv(cv)
     {
       // prevents rehash, so no iterators invalidation
-      ratelimit_entries.max_load_factor(1000);
+      for (auto& shard : shards) {
+        shard.ratelimit_entries.max_load_factor(1000);
+      }
     };
 
     bool should_rate_limit(const char *method, const std::string& key, ceph::coarse_real_time curr_timestamp, const RGWRateLimitInfo* ratelimit_info) {
@@ -223,7 +234,9 @@ class RateLimiter {
       it.decrease_bytes(is_read, amount, info);
     }
     void clear() {
-      ratelimit_entries.clear();
+      for (auto& shard : shards) {
+        shard.ratelimit_entries.clear();
+      }
     }
 };
 // This class purpose is to hold 2 RateLimiter instances, one active and one passive.
@@ -683,6 +683,40 @@ size_t RGWSelectObj_ObjStore_S3::get_obj_size()
 }
 
 int RGWSelectObj_ObjStore_S3::range_request(int64_t ofs, int64_t len, void* buff, optional_yield y)
+{
+  //parquet reader issues many small reads (footer, page headers), each a round of RGWGetObj::execute.
+  //serve those from one larger read ahead.
+  if (buff && m_parquet_type) {
+    if (m_range_cache_ofs >= 0 && ofs >= m_range_cache_ofs &&
+        ofs + len <= m_range_cache_ofs + (int64_t)m_range_cache.size()) {
+      memcpy(buff, m_range_cache.data() + (ofs - m_range_cache_ofs), len);
+      return len;
+    }
+    const int64_t readahead = s->cct->_conf.get_val<Option::size_t>("rgw_s3select_parquet_readahead");
+    const int64_t obj_size = get_obj_size();
+    if (len < readahead && ofs + len <= obj_size) {
+      //reads near the end of the object are for the footer and metadata, which precede each other
+      const int64_t start = std::min(ofs, std::max<int64_t>(0, obj_size - readahead));
+      const int64_t window = std::min(readahead, obj_size - start);
+      fetch_range(start, window, y);
+      if ((int64_t)requested_buffer.size() >= window) {
+        m_range_cache.swap(requested_buffer);
+        m_range_cache.resize(window);
+        m_range_cache_ofs = start;
+        memcpy(buff, m_range_cache.data() + (ofs - start), len);
+        return len;
+      }
+    }
+  }
+  fetch_range(ofs, len, y);
+  if (buff) {
+    memcpy(buff, requested_buffer.data(), len);
+  }
+  ldout(s->cct, 10) << "S3select: done waiting, buffer is complete buffer-size:" << requested_buffer.size() << dendl;
+  return len;
+}
+
+void RGWSelectObj_ObjStore_S3::fetch_range(int64_t ofs, int64_t len, optional_yield y)
 {
   //purpose: implementation for arrow::ReadAt, this may take several async calls.
   //send_response_date(call_back) accumulate buffer, upon completion control is back to ReadAt.
@@ -694,11 +728,6 @@ int RGWSelectObj_ObjStore_S3::range_request(int64_t ofs, int64_t len, void* buff
   m_request_range = len;
   ldout(s->cct, 10) << "S3select: calling execute(async):" << " request-offset :" << ofs << " request-length :" << len << " buffer size : " << requested_buffer.size() << dendl;
   RGWGetObj::execute(y);
-  if (buff) {
-    memcpy(buff, requested_buffer.data(), len);
-  }
-  ldout(s->cct, 10) << "S3select: done waiting, buffer is complete buffer-size:" << requested_buffer.size() << dendl;
-  return len;
 }
 
 void RGWSelectObj_ObjStore_S3::execute(optional_yield y)
@@ -204,6 +204,9 @@ private:
   //a request for range may satisfy by several calls to send_response_date;
   size_t m_request_range;
   std::string requested_buffer;
+  //parquet reads served without another request
+  std::string m_range_cache;
+  int64_t m_range_cache_ofs{-1};
   std::string range_req_str;
   std::function<int(std::string&)> fp_result_header_format;
   std::function<int(std::string&)> fp_s3select_result_format;
@@ -248,6 +251,7 @@ private:
   int handle_aws_cli_parameters(std::string& sql_query);
 
   int range_request(int64_t start, int64_t len, void*, optional_yield);
+  void fetch_range(int64_t start, int64_t len, optional_yield);
 
   size_t get_obj_size();
   std::function<int(int64_t, int64_t, void*, optional_yield*)> fp_range_req;
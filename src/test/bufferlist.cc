@@ -22,6 +22,7 @@
 #include <limits.h>
 #include <errno.h>
 #include <sys/uio.h>
+#include <thread>
 
 #include "include/buffer.h"
 #include "include/buffer_raw.h"
@@ -145,6 +146,58 @@ TEST(Buffer, BenchAlloc) {
   bench_buffer_alloc(4, 1000000);
 }
 
+TEST(Buffer, raw_cache) {
+  if (getenv("CEPH_BUFFER_NO_RAW_CACHE")) {
+    GTEST_SKIP() << "raw cache disabled";
+  }
+  uint64_t hits = buffer::get_raw_cache_hits();
+  // the counters of a thread are folded into the totals when it exits
+  std::thread t([] {
+    const char *a_data, *b_data;
+    {
+      bufferptr a(100);
+      bufferptr b(3000);
+      a_data = a.c_str();
+      b_data = b.c_str();
+    }
+    for (unsigned i = 0; i < 4096; ++i) {
+      bufferptr a(100);
+      memset(a.c_str(), 'a', a.length());
+      bufferptr b(3000);
+      memset(b.c_str(), 'b', b.length());
+      ASSERT_EQ('a', a[99]);
+      ASSERT_EQ('b', b[0]);
+      // freed blocks come straight back out of this thread's cache
+      ASSERT_EQ(a_data, a.c_str());
+      ASSERT_EQ(b_data, b.c_str());
+    }
+  });
+  t.join();
+  // other threads can only add to the totals
+  EXPECT_GE(buffer::get_raw_cache_hits() - hits, 2 * 4096u);
+}
+
+TEST(Buffer, raw_cache_mempool) {
+  // a pool nothing else in this test allocates from
+  auto& pool = mempool::get_pool(mempool::mempool_bluestore_cache_data);
+  size_t before = pool.allocated_bytes();
+  {
+    bufferptr p(100);
+    p.reassign_to_mempool(mempool::mempool_bluestore_cache_data);
+    size_t used = pool.allocated_bytes() - before;
+    if (getenv("CEPH_BUFFER_NO_RAW_CACHE")) {
+      // only rounded up to the alignment of raw_combined
+      EXPECT_GE(used, 100u);
+      EXPECT_LT(used, 100u + sizeof(void*) * 2);
+    } else {
+      // the 256 byte block it was rounded up to, minus the raw_combined
+      EXPECT_GT(used, 100u + sizeof(void*) * 2);
+      EXPECT_LT(used, 256u);
+    }
+  }
+  EXPECT_EQ(before, pool.allocated_bytes());
+}
+
 TEST(BufferRaw, ostream) {
   bufferptr ptr(1);
   std::ostringstream stream;
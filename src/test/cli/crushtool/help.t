@@ -107,6 +107,8 @@
      --show-mappings       show mappings
      --show-bad-mappings   show bad mappings
      --show-choose-tries   show choose tries histogram
+     --show-mapping-rate   show how many mappings per second the
+                           rule(s) compute
      --output-name name
                            prepend the data file(s) generated during the
                            testing routine with name
@@ -1099,6 +1099,33 @@ TEST_F(cls_rgw, usage_basic)
   ASSERT_EQ(0, cls_rgw_usage_log_trim(ioctx, oid, "", bucket2, start_epoch, end_epoch));
 }
 
+TEST_F(cls_rgw, usage_trim_removes_both_records)
+{
+  string oid="usage.2";
+  string user="user1";
+  uint64_t start_epoch{0}, end_epoch{(uint64_t) -1};
+  string payer;
+
+  // every entry is stored under a by-time and a by-user key
+  auto info = populate_usage_log_info(user, payer, 16);
+  ObjectWriteOperation op;
+  cls_rgw_usage_log_add(op, info);
+  ASSERT_EQ(0, ioctx.operate(oid, &op));
+
+  std::set<std::string> keys;
+  bool more = false;
+  ASSERT_EQ(0, ioctx.omap_get_keys2(oid, "", 1000, &keys, &more));
+  ASSERT_EQ(32u, keys.size());
+
+  // trimming by user finds the entries through their by-user keys, and has
+  // to drop the by-time keys along with them
+  ASSERT_EQ(0, cls_rgw_usage_log_trim(ioctx, oid, user, "", start_epoch, end_epoch));
+
+  keys.clear();
+  ASSERT_EQ(0, ioctx.omap_get_keys2(oid, "", 1000, &keys, &more));
+  ASSERT_EQ(0u, keys.size());
+}
+
 TEST_F(cls_rgw, usage_clear_no_obj)
 {
   string user="user1";
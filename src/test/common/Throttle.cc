@@ -212,6 +212,40 @@ TEST_F(ThrottleTest, wait) {
   } while(!waited);
 }
 
+TEST_F(ThrottleTest, no_over_admission) {
+  // the lockless fast path and the locked slow path race for the same
+  // slots; together they must never hand out more than max
+  const int64_t throttle_max = 10;
+  Throttle throttle(g_ceph_context, "throttle", throttle_max);
+  std::atomic<int64_t> in_use = 0;
+  std::atomic<int64_t> peak = 0;
+
+  auto worker = [&](int id) {
+    for (int i = 0; i < 20000; ++i) {
+      int64_t c = 1 + (i + id) % 3;
+      if ((i + id) % 2) {
+	throttle.get(c);
+      } else if (!throttle.get_or_fail(c)) {
+	continue;
+      }
+      int64_t now = in_use += c;
+      int64_t prev = peak;
+      while (now > prev && !peak.compare_exchange_weak(prev, now));
+      in_use -= c;
+      throttle.put(c);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 16; ++i) {
+    threads.emplace_back(worker, i);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_LE(peak.load(), throttle_max);
+  ASSERT_EQ(throttle.get_current(), 0);
+}
+
 std::pair<double, std::chrono::duration<double> > test_backoff(
   double low_threshhold,
   double high_threshhold,
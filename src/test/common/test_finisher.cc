@@ -0,0 +1,92 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <atomic>
+#include <list>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/Finisher.h"
+#include "common/config_proxy.h"
+#include "global/global_context.h"
+
+// run everything against both the locked and the lock-free queue
+class FinisherTest : public ::testing::TestWithParam<bool> {
+protected:
+  void SetUp() override {
+    g_ceph_context->_conf.set_val_or_die("finisher_lockless_queue",
+					 GetParam() ? "true" : "false");
+  }
+  void TearDown() override {
+    g_ceph_context->_conf.rm_val("finisher_lockless_queue");
+  }
+};
+
+TEST_P(FinisherTest, order)
+{
+  Finisher finisher(g_ceph_context);
+  finisher.start();
+
+  std::vector<int> completed;
+  const int n = 1000;
+  for (int i = 0; i < n; ++i) {
+    if (i % 10 == 0) {
+      std::list<Context*> ls;
+      ls.push_back(new LambdaContext([&completed, i](int) {
+	completed.push_back(i);
+      }));
+      finisher.queue(ls);
+    } else {
+      finisher.queue(new LambdaContext([&completed, i](int r) {
+	ASSERT_EQ(i, r);
+	completed.push_back(i);
+      }), i);
+    }
+  }
+  finisher.wait_for_empty();
+  finisher.stop();
+
+  ASSERT_EQ(n, (int)completed.size());
+  for (int i = 0; i < n; ++i) {
+    ASSERT_EQ(i, completed[i]);
+  }
+}
+
+TEST_P(FinisherTest, concurrent_producers)
+{
+  // named, so that the queued contexts get stamped
+  Finisher finisher(g_ceph_context, "test", "fn_test");
+  finisher.start();
+
+  const int nthreads = 8;
+  const int per_thread = 10000;
+  std::atomic<int> completed = 0;
+  std::vector<int> last_seen(nthreads, -1);
+  std::vector<std::thread> producers;
+  for (int t = 0; t < nthreads; ++t) {
+    producers.emplace_back([&, t] {
+      for (int i = 0; i < per_thread; ++i) {
+	finisher.queue(new LambdaContext([&, t, i](int) {
+	  // each producer's contexts complete in the order they were queued
+	  ASSERT_LT(last_seen[t], i);
+	  last_seen[t] = i;
+	  ++completed;
+	}));
+	if (i % 1000 == 0) {
+	  // give the finisher a chance to go to sleep
+	  std::this_thread::yield();
+	}
+      }
+    });
+  }
+  for (auto& p : producers) {
+    p.join();
+  }
+  finisher.wait_for_empty();
+  ASSERT_TRUE(finisher.is_empty());
+  finisher.stop();
+  ASSERT_EQ(nthreads * per_thread, completed.load());
+}
+
+INSTANTIATE_TEST_SUITE_P(Finisher, FinisherTest, ::testing::Bool());
@@ -70,3 +70,23 @@ TEST(cpu_set, round_trip_list)
   }
 }
 
+
+TEST(cpu_set, affinity_this_thread_nth)
+{
+  cpu_set_t orig;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(orig), &orig));
+  std::string allowed = cpu_set_to_str_list(CPU_SETSIZE, &orig);
+  int count = CPU_COUNT(&orig);
+  for (int n = 0; n < count + 1; ++n) {
+    int cpu = -1;
+    ASSERT_EQ(0, set_cpu_affinity_this_thread_nth(allowed.c_str(), n, &cpu));
+    ASSERT_TRUE(CPU_ISSET(cpu, &orig));
+    cpu_set_t now;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(now), &now));
+    ASSERT_EQ(1, CPU_COUNT(&now));
+    ASSERT_TRUE(CPU_ISSET(cpu, &now));
+  }
+  int cpu = -1;
+  ASSERT_EQ(-EINVAL, set_cpu_affinity_this_thread_nth("x", 0, &cpu));
+  ASSERT_EQ(0, sched_setaffinity(0, sizeof(orig), &orig));
+}
@@ -0,0 +1,68 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <chrono>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "common/obj_bencher.h"
+
+using namespace std::chrono_literals;
+
+TEST(BenchLatencyHistogram, Empty) {
+  bench_latency_histogram h;
+  ASSERT_EQ(0u, h.total);
+  ASSERT_EQ(0, h.percentile(50));
+  ASSERT_EQ(0, h.percentile(99.9));
+}
+
+TEST(BenchLatencyHistogram, SmallValuesAreExact) {
+  bench_latency_histogram h;
+  for (int i = 0; i < 100; ++i) {
+    h.add(10us);
+  }
+  h.add(20us);
+  ASSERT_EQ(101u, h.total);
+  ASSERT_DOUBLE_EQ(10e-6, h.percentile(50));
+  ASSERT_DOUBLE_EQ(10e-6, h.percentile(99));
+  ASSERT_DOUBLE_EQ(20e-6, h.percentile(100));
+}
+
+TEST(BenchLatencyHistogram, Percentiles) {
+  bench_latency_histogram h;
+  // 1us..100ms, one of each
+  const uint64_t n = 100000;
+  for (uint64_t us = 1; us <= n; ++us) {
+    h.add(std::chrono::microseconds(us));
+  }
+  ASSERT_EQ(n, h.total);
+  for (double p : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+    // the upper bound of the bucket holding the exact percentile
+    double exact = std::ceil(n * p / 100) / 1e6;
+    double lat = h.percentile(p);
+    EXPECT_GE(lat, exact) << "p" << p;
+    EXPECT_LE(lat, exact * (1 + 1.0 / bench_latency_histogram::SUB_BUCKETS))
+      << "p" << p;
+  }
+}
+
+TEST(BenchLatencyHistogram, LargeAndNegative) {
+  bench_latency_histogram h;
+  h.add(-1s); // clock went backwards
+  h.add(1h);
+  ASSERT_EQ(2u, h.total);
+  ASSERT_EQ(0, h.percentile(50));
+  double lat = h.percentile(100);
+  EXPECT_GE(lat, 3600.0);
+  EXPECT_LE(lat, 3600.0 * (1 + 1.0 / bench_latency_histogram::SUB_BUCKETS));
+}
+
+TEST(BenchLatencyHistogram, Reset) {
+  bench_latency_histogram h;
+  h.add(5ms);
+  h.reset();
+  ASSERT_EQ(0u, h.total);
+  ASSERT_EQ(0, h.percentile(100));
+  h.add(7us);
+  ASSERT_DOUBLE_EQ(7e-6, h.percentile(50));
+}
@@ -0,0 +1,73 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/sharded_shared_mutex.h"
+
+TEST(ShardedSharedMutex, simple)
+{
+  ceph::sharded_shared_mutex mutex{"sharded::simple"};
+  {
+    std::unique_lock lock{mutex};
+    // a writer excludes readers and other writers
+    auto writer = std::async(std::launch::async, [&] {
+      return mutex.try_lock();
+    });
+    ASSERT_FALSE(writer.get());
+    auto reader = std::async(std::launch::async, [&] {
+      return mutex.try_lock_shared();
+    });
+    ASSERT_FALSE(reader.get());
+  }
+  {
+    std::shared_lock lock{mutex};
+    // readers exclude writers, but not other readers
+    auto reader = std::async(std::launch::async, [&] {
+      bool locked = mutex.try_lock_shared();
+      if (locked) {
+        mutex.unlock_shared();
+      }
+      return locked;
+    });
+    ASSERT_TRUE(reader.get());
+    auto writer = std::async(std::launch::async, [&] {
+      return mutex.try_lock();
+    });
+    ASSERT_FALSE(writer.get());
+  }
+  ASSERT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(ShardedSharedMutex, exclusion)
+{
+  // writers see no readers in between, whichever shard the readers use
+  ceph::sharded_shared_mutex mutex{"sharded::exclusion"};
+  const int NR_THREADS = 8;
+  const int NR_ROUNDS = 10000;
+  int a = 0, b = 0;
+  auto run = [&] {
+    for (int i = 0; i < NR_ROUNDS; i++) {
+      if (i % 16 == 0) {
+        std::unique_lock lock{mutex};
+        ++a;
+        ++b;
+      } else {
+        std::shared_lock lock{mutex};
+        ASSERT_EQ(a, b);
+      }
+    }
+  };
+  std::vector<std::future<void>> threads;
+  for (int i = 0; i < NR_THREADS; i++) {
+    threads.push_back(std::async(std::launch::async, run));
+  }
+  for (auto& t : threads) {
+    t.get();
+  }
+  ASSERT_EQ(a, NR_THREADS * ((NR_ROUNDS + 15) / 16));
+  ASSERT_EQ(a, b);
+}
@@ -90,6 +90,33 @@ TEST_P(CompressorTest, small_round_trip)
        << " with " << GetParam() << std::endl;
 }
 
+TEST_P(CompressorTest, stream_round_trip)
+{
+  auto cs = compressor->create_compress_stream();
+  auto ds = compressor->create_decompress_stream();
+  ASSERT_EQ(!cs, !ds);
+  if (!cs) {
+    return;
+  }
+  unsigned total = 0, total_compressed = 0;
+  for (unsigned i = 0; i < 100; ++i) {
+    bufferlist orig;
+    orig.append("This is a short string.  There are many strings like it but this one is mine.");
+    orig.append(std::to_string(i));
+    bufferlist compressed;
+    ASSERT_EQ(0, cs->compress(orig, compressed));
+    bufferlist decompressed;
+    ASSERT_EQ(0, ds->decompress(compressed, decompressed));
+    ASSERT_TRUE(decompressed.contents_equal(orig));
+    total += orig.length();
+    total_compressed += compressed.length();
+  }
+  // later inputs refer back to the first one
+  ASSERT_LT(total_compressed, total / 2);
+  cout << "stream orig " << total << " compressed " << total_compressed
+       << " with " << GetParam() << std::endl;
+}
+
 TEST_P(CompressorTest, big_round_trip_repeated)
 {
   unsigned len = 1048576 * 4;
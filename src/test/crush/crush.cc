@@ -970,6 +970,28 @@ TEST_F(CRUSHTest, straw2_stddev)
   }
 }
 
+TEST_F(CRUSHTest, hash32_3_vec)
+{
+  // the batched hash used by straw2 must match the scalar one exactly,
+  // including for counts that are not a multiple of the vector width
+  std::vector<__s32> ids(37);
+  std::vector<__u32> out(ids.size());
+  for (unsigned i = 0; i < ids.size(); ++i) {
+    ids[i] = (i & 1) ? -(int)i * 7919 : (int)i * 104729;
+  }
+  for (__u32 x = 0; x < 100; ++x) {
+    for (__u32 r = 0; r < 5; ++r) {
+      for (unsigned n = 0; n <= ids.size(); ++n) {
+	crush_hash32_3_vec(CRUSH_HASH_RJENKINS1, x, ids.data(), r,
+			   out.data(), n);
+	for (unsigned i = 0; i < n; ++i) {
+	  ASSERT_EQ(crush_hash32_3(CRUSH_HASH_RJENKINS1, x, ids[i], r), out[i]);
+	}
+      }
+    }
+  }
+}
+
 TEST_F(CRUSHTest, straw2_reweight) {
   // when we adjust the weight of an item in a straw2 bucket,
   // we should *only* see movement from or to that item, never
@@ -368,6 +368,59 @@ TEST_F(IsaErasureCodeTest, encode)
   }
 }
 
+TEST_F(IsaErasureCodeTest, encode_decode_stripes)
+{
+  ErasureCodeIsaDefault Isa(tcache);
+  ErasureCodeProfile profile;
+  profile["k"] = "4";
+  profile["m"] = "2";
+  Isa.init(profile, &cerr);
+
+  const unsigned k = 4;
+  const unsigned stripe_count = 5;
+  const unsigned stripe_width = Isa.get_alignment() * k * 2;
+  const unsigned chunk_size = Isa.get_chunk_size(stripe_width);
+  set<int> want_to_encode;
+  for (unsigned i = 0; i < Isa.get_chunk_count(); i++)
+    want_to_encode.insert(i);
+
+  // one stripe at a time
+  map<int, bufferlist> expected;
+  map<int, bufferlist> batch;
+  for (unsigned s = 0; s < stripe_count; s++) {
+    string payload;
+    for (unsigned i = 0; i < stripe_width; i++)
+      payload.push_back(rand());
+    bufferlist in;
+    in.append(payload);
+    map<int, bufferlist> encoded;
+    EXPECT_EQ(0, Isa.encode(want_to_encode, in, &encoded));
+    for (auto &[i, chunk] : encoded) {
+      expected[i].append(chunk);
+      if (i < (int)k)
+        batch[i].append(chunk);
+      else
+        batch[i].append_zero(chunk_size);
+    }
+  }
+
+  // all of them at once
+  EXPECT_EQ(0, Isa.encode_stripes(want_to_encode, stripe_count, &batch));
+  for (unsigned i = 0; i < Isa.get_chunk_count(); i++)
+    EXPECT_TRUE(batch[i].contents_equal(expected[i]));
+
+  // lose a data and a coding chunk, get them back in one go
+  map<int, bufferlist> chunks(batch);
+  chunks.erase(1);
+  chunks.erase(4);
+  map<int, bufferlist> decoded;
+  EXPECT_EQ(0, Isa.decode_stripes(set<int>{1, 4}, chunks, &decoded,
+                                  stripe_count));
+  EXPECT_EQ(stripe_count * chunk_size, decoded[1].length());
+  EXPECT_TRUE(decoded[1].contents_equal(expected[1]));
+  EXPECT_TRUE(decoded[4].contents_equal(expected[4]));
+}
+
 TEST_F(IsaErasureCodeTest, sanity_check_k)
 {
   ErasureCodeIsaDefault Isa(tcache);
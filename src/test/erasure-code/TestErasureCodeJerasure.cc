@@ -130,6 +130,61 @@ TYPED_TEST(ErasureCodeTest, encode_decode)
   }
 }
 
+TYPED_TEST(ErasureCodeTest, encode_decode_stripes)
+{
+  TypeParam jerasure;
+  ErasureCodeProfile profile;
+  profile["k"] = "2";
+  profile["m"] = "2";
+  profile["packetsize"] = "8";
+  jerasure.init(profile, &cerr);
+
+  const unsigned k = 2;
+  const unsigned stripe_count = 5;
+  const unsigned stripe_width = jerasure.get_alignment() * 2;
+  const unsigned chunk_size = jerasure.get_chunk_size(stripe_width);
+  set<int> want_to_encode;
+  for (unsigned i = 0; i < jerasure.get_chunk_count(); i++)
+    want_to_encode.insert(i);
+
+  // one stripe at a time
+  map<int, bufferlist> expected;
+  map<int, bufferlist> batch;
+  for (unsigned s = 0; s < stripe_count; s++) {
+    string payload;
+    for (unsigned i = 0; i < stripe_width; i++)
+      payload.push_back(rand());
+    bufferlist in;
+    in.append(payload);
+    map<int, bufferlist> encoded;
+    EXPECT_EQ(0, jerasure.encode(want_to_encode, in, &encoded));
+    for (auto &[i, chunk] : encoded) {
+      EXPECT_EQ(chunk_size, chunk.length());
+      expected[i].append(chunk);
+      if (i < (int)k)
+	batch[i].append(chunk);
+      else
+	batch[i].append_zero(chunk_size);
+    }
+  }
+
+  // all of them at once
+  EXPECT_EQ(0, jerasure.encode_stripes(want_to_encode, stripe_count, &batch));
+  for (unsigned i = 0; i < jerasure.get_chunk_count(); i++)
+    EXPECT_TRUE(batch[i].contents_equal(expected[i]));
+
+  // lose a data and a coding chunk, get them back in one go
+  map<int, bufferlist> chunks(batch);
+  chunks.erase(1);
+  chunks.erase(3);
+  map<int, bufferlist> decoded;
+  EXPECT_EQ(0, jerasure.decode_stripes(set<int>{1, 3}, chunks, &decoded,
+				       stripe_count));
+  EXPECT_EQ(stripe_count * chunk_size, decoded[1].length());
+  EXPECT_TRUE(decoded[1].contents_equal(expected[1]));
+  EXPECT_TRUE(decoded[3].contents_equal(expected[3]));
+}
+
 TYPED_TEST(ErasureCodeTest, minimum_to_decode)
 {
   TypeParam jerasure;
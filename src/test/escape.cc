@@ -122,6 +122,13 @@ TEST(EscapeJson, ControlChars) {
   ASSERT_EQ(escape_json_stream("abc\x7f"), "abc\\u007f");
 }
 
+TEST(EscapeJson, Runs) {
+  // escapes at the start, in the middle and at the end of unescaped runs
+  ASSERT_EQ(escape_json_stream("\"a\\bc\n"), "\\\"a\\\\bc\\n");
+  ASSERT_EQ(escape_json_stream("x\x01y\x1fz"), "x\\u0001y\\u001fz");
+  ASSERT_EQ(escape_xml_stream("<a&b>\x01"), "&lt;a&amp;b&gt;&#x01;");
+}
+
 TEST(EscapeJson, Utf8) {
   EXPECT_EQ(escape_json_attrs("\xe6\xb1\x89\xe5\xad\x97\n"), "\xe6\xb1\x89\xe5\xad\x97\\n");
   EXPECT_EQ(escape_json_stream("\xe6\xb1\x89\xe5\xad\x97\n"), "\xe6\xb1\x89\xe5\xad\x97\\n");
@@ -54,7 +54,13 @@ struct Options {
     pglog_dup_omap_len_low,
     pglog_dup_omap_len_high,
     _fastinfo_omap_len_low,
-    _fastinfo_omap_len_high;
+    _fastinfo_omap_len_high,
+    object_omap_len_low,
+    object_omap_len_high;
+  unsigned object_omap_set_keys;
+  unsigned object_omap_rm_keys;
+  unsigned object_omap_get_keys;
+  unsigned object_omap_key_space;
   unsigned simulate_pglog;
   unsigned single_pool_mode;
   unsigned preallocate_files;
@@ -118,6 +124,53 @@ static std::vector<fio_option> ceph_options{
     o.def    = 0;
     o.minval = 0;
   }),
+  make_option([] (fio_option& o) {
+    o.name   = "object_omap_len";
+    o.lname  = "object omap entry length";
+    o.type   = FIO_OPT_STR_VAL;
+    o.help   = "Set omap entries of the written objects themselves (as in a "
+               "bucket index) to specified length";
+    o.off1   = offsetof(Options, object_omap_len_low);
+    o.off2   = offsetof(Options, object_omap_len_high);
+    o.def    = 0;
+    o.minval = 0;
+  }),
+  make_option([] (fio_option& o) {
+    o.name   = "object_omap_set_keys";
+    o.lname  = "object omap keys set per write";
+    o.type   = FIO_OPT_INT;
+    o.help   = "Number of random omap keys of the object set along with each write";
+    o.off1   = offsetof(Options, object_omap_set_keys);
+    o.def    = "1";
+    o.minval = 0;
+  }),
+  make_option([] (fio_option& o) {
+    o.name   = "object_omap_rm_keys";
+    o.lname  = "object omap keys removed per write";
+    o.type   = FIO_OPT_INT;
+    o.help   = "Number of random omap keys of the object removed along with each write";
+    o.off1   = offsetof(Options, object_omap_rm_keys);
+    o.def    = "0";
+    o.minval = 0;
+  }),
+  make_option([] (fio_option& o) {
+    o.name   = "object_omap_get_keys";
+    o.lname  = "object omap keys read per read";
+    o.type   = FIO_OPT_INT;
+    o.help   = "Number of random omap keys of the object read along with each read";
+    o.off1   = offsetof(Options, object_omap_get_keys);
+    o.def    = "0";
+    o.minval = 0;
+  }),
+  make_option([] (fio_option& o) {
+    o.name   = "object_omap_key_space";
+    o.lname  = "object omap key space";
+    o.type   = FIO_OPT_INT;
+    o.help   = "Number of distinct omap keys per object random keys are picked from";
+    o.off1   = offsetof(Options, object_omap_key_space);
+    o.def    = "10000";
+    o.minval = 1;
+  }),
   make_option([] (fio_option& o) {
     o.name   = "pglog_simulation";
     o.lname  = "pglog behavior simulation";
@@ -436,6 +489,8 @@ Engine::Engine(thread_data* td)
 					o->pglog_dup_omap_len_high);
   o->_fastinfo_omap_len_high = max(o->_fastinfo_omap_len_low,
 					o->_fastinfo_omap_len_high);
+  o->object_omap_len_high = max(o->object_omap_len_low,
+				o->object_omap_len_high);
 
   int r = os->mkfs();
   if (r < 0)
@@ -524,6 +579,7 @@ Job::Job(Engine* engine, const thread_data* td)
   max_data = max(max_data, o->pglog_omap_len_high);
   max_data = max(max_data, o->pglog_dup_omap_len_high);
   max_data = max(max_data, o->_fastinfo_omap_len_high);
+  max_data = max(max_data, o->object_omap_len_high);
   one_for_all_data = buffer::create(max_data);
 
   std::vector<Collection>* colls;
@@ -723,6 +779,15 @@ class UnitComplete : public Context {
   }
 };
 
+/// a random key of the object_omap_key_space ones
+static string object_omap_key(const Options* o)
+{
+  char key[32];
+  snprintf(key, sizeof(key), "%016u",
+	   ceph::util::generate_random_number(0u, o->object_omap_key_space - 1));
+  return key;
+}
+
 enum fio_q_status fio_ceph_os_queue(thread_data* td, io_u* u)
 {
   fio_ro_check(td, u);
@@ -855,6 +920,28 @@ enum fio_q_status fio_ceph_os_queue(thread_data* td, io_u* u)
       ghobject_t pgmeta_oid(coll.pg.make_pgmeta_oid());
       t.omap_setkeys(coll.cid, pgmeta_oid, omaps);
     }
+
+    if (o->object_omap_len_high) {
+      // omap of the object itself, as with bucket index entries
+      set<string> obj_rmkeys;
+      for (unsigned i = 0; i < o->object_omap_rm_keys; ++i) {
+	obj_rmkeys.emplace(object_omap_key(o));
+      }
+      if (!obj_rmkeys.empty()) {
+	t.omap_rmkeys(coll.cid, object.oid, obj_rmkeys);
+      }
+      map<string, bufferlist> obj_omaps;
+      for (unsigned i = 0; i < o->object_omap_set_keys; ++i) {
+	// fill with the garbage as we do not care of the actual content...
+	job->one_for_all_data.set_length(
+	  ceph::util::generate_random_number(
+	    o->object_omap_len_low, o->object_omap_len_high));
+	obj_omaps[object_omap_key(o)].append(job->one_for_all_data);
+      }
+      if (!obj_omaps.empty()) {
+	t.omap_setkeys(coll.cid, object.oid, obj_omaps);
+      }
+    }
     t.register_on_commit(new UnitComplete(u));
     os->queue_transaction(coll.ch,
                           std::move(t));
@@ -872,6 +959,18 @@ enum fio_q_status fio_ceph_os_queue(thread_data* td, io_u* u)
       bl.begin().copy(bl.length(), static_cast<char*>(u->xfer_buf));
       u->resid = u->xfer_buflen - r;
     }
+    if (o->object_omap_get_keys) {
+      set<string> keys;
+      for (unsigned i = 0; i < o->object_omap_get_keys; ++i) {
+	keys.emplace(object_omap_key(o));
+      }
+      map<string, bufferlist> values;
+      r = os->omap_get_values(coll.ch, object.oid, keys, &values);
+      if (r < 0) {
+	u->error = r;
+	td_verror(td, u->error, "omap_get_values");
+      }
+    }
     return FIO_Q_COMPLETED;
   }
 
@@ -62,6 +62,19 @@ TEST(JsonFormatter, CunningFloats) {
   ASSERT_EQ(oss.str(), "{\"long\":0.14285714285714285,\"big\":1.2345678901234567e+19}");
 }
 
+TEST(JsonFormatter, Integers) {
+  ostringstream oss;
+  JSONFormatter fmt(false);
+  fmt.open_object_section("foo");
+  fmt.dump_int("min", std::numeric_limits<int64_t>::min());
+  fmt.dump_int("zero", 0);
+  fmt.dump_unsigned("max", std::numeric_limits<uint64_t>::max());
+  fmt.close_section();
+  ASSERT_EQ(fmt.get_len(), 64);
+  fmt.flush(oss);
+  ASSERT_EQ(oss.str(), "{\"min\":-9223372036854775808,\"zero\":0,\"max\":18446744073709551615}");
+}
+
 TEST(JsonFormatter, Empty) {
   ostringstream oss;
   JSONFormatter fmt(false);
@@ -233,3 +233,55 @@ TEST_F(TestSimplePolicy, test_evict_list_10) {
     m_promoted_lru.erase(m_promoted_lru.begin());
   }
 }
+
+TEST_F(TestSimplePolicy, test_lookup_hit_and_promoted_to_hot) {
+  // a second hit moves an entry from probation to the hot LRU, which is
+  // only evicted from once probation is empty
+  ASSERT_TRUE(m_simple_policy->lookup_object(generate_file_name(0)) == OBJ_CACHE_PROMOTED);
+  ASSERT_TRUE(m_simple_policy->lookup_object(generate_file_name(1)) == OBJ_CACHE_PROMOTED);
+  ASSERT_TRUE(m_promoted_lru.size() == m_simple_policy->get_promoted_entry_num());
+  ASSERT_TRUE(m_simple_policy->get_evict_entry() == generate_file_name(2));
+
+  m_promoted_lru.erase(m_promoted_lru.begin(), m_promoted_lru.begin() + 2);
+  m_promoted_lru.push_back(generate_file_name(0));
+  m_promoted_lru.push_back(generate_file_name(1));
+}
+
+TEST_F(TestSimplePolicy, test_lookup_hit_and_demoted_from_hot) {
+  // hitting every entry fills the hot LRU up to 80% of the entries, the
+  // least recently hit ones fall back to probation
+  for (uint64_t index = 0; index < m_entry_index; index++) {
+    ASSERT_TRUE(m_simple_policy->lookup_object(generate_file_name(index)) == OBJ_CACHE_PROMOTED);
+  }
+  ASSERT_TRUE(m_promoted_lru.size() == m_simple_policy->get_promoted_entry_num());
+  ASSERT_TRUE(m_simple_policy->get_evict_entry() == generate_file_name(0));
+
+  // hitting a demoted entry again pushes the coldest hot entry out
+  ASSERT_TRUE(m_simple_policy->lookup_object(generate_file_name(0)) == OBJ_CACHE_PROMOTED);
+  ASSERT_TRUE(m_simple_policy->get_evict_entry() == generate_file_name(1));
+
+  // probation now holds 1..10, the hot LRU 11..49 and then 0
+  m_promoted_lru.erase(m_promoted_lru.begin());
+  m_promoted_lru.push_back(generate_file_name(0));
+}
+
+TEST_F(TestSimplePolicy, test_evict_list_skips_hot) {
+  ASSERT_TRUE(m_simple_policy->lookup_object(generate_file_name(0)) == OBJ_CACHE_PROMOTED);
+  uint64_t left_entry_num = m_cache_size - m_promoted_lru.size();
+  for (uint64_t i = 0; i < left_entry_num; i++, ++m_entry_index) {
+    insert_entry_into_promoted_lru(generate_file_name(m_entry_index));
+  }
+  ASSERT_TRUE(0 == m_simple_policy->get_free_size());
+  m_promoted_lru.erase(m_promoted_lru.begin());
+  m_promoted_lru.push_back(generate_file_name(0));
+
+  std::list<std::string> evict_entry_list;
+  m_simple_policy->get_evict_list(&evict_entry_list);
+  // evict 10% of the entries, all of them from probation
+  ASSERT_TRUE(m_cache_size*0.1 == evict_entry_list.size());
+  for (auto it = evict_entry_list.begin(); it != evict_entry_list.end(); it++) {
+    ASSERT_TRUE(*it != generate_file_name(0));
+    ASSERT_TRUE(*it == m_promoted_lru.front());
+    m_promoted_lru.erase(m_promoted_lru.begin());
+  }
+}
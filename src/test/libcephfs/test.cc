@@ -1208,6 +1208,50 @@ TEST(LibCephFS, ReadEmptyFile) {
   ceph_shutdown(cmount);
 }
 
+TEST(LibCephFS, DirectWriteAroundObjectCache) {
+  struct ceph_mount_info *cmount;
+  ASSERT_EQ(ceph_create(&cmount, NULL), 0);
+  ASSERT_EQ(ceph_conf_read_file(cmount, NULL), 0);
+  ASSERT_EQ(0, ceph_conf_parse_env(cmount, NULL));
+  ASSERT_EQ(ceph_conf_set(cmount, "client_oc", "true"), 0);
+  ASSERT_EQ(ceph_conf_set(cmount, "client_oc_direct_write_threshold", "65536"), 0);
+  ASSERT_EQ(ceph_mount(cmount, NULL), 0);
+
+  int mypid = getpid();
+  char testf[256];
+
+  sprintf(testf, "test_directwrite%d", mypid);
+  int fd = ceph_open(cmount, testf, O_CREAT|O_TRUNC|O_RDWR, 0644);
+  ASSERT_GT(fd, 0);
+
+  // a small cached write, then large ones over it that bypass the cache
+  const size_t len = 1 << 20;
+  std::string small(4096, 'a');
+  ASSERT_EQ(ceph_write(cmount, fd, small.data(), small.size(), 0), (int)small.size());
+  std::string big(len, 'b');
+  for (int i = 0; i < 8; ++i) {
+    big[0] = 'b' + i;
+    ASSERT_EQ(ceph_write(cmount, fd, big.data(), len, i * len), (int)len);
+  }
+  // fsync must wait for the writes sent around the object cacher too
+  ASSERT_EQ(ceph_fsync(cmount, fd, 0), 0);
+
+  std::string in(len, '\0');
+  for (int i = 0; i < 8; ++i) {
+    big[0] = 'b' + i;
+    ASSERT_EQ(ceph_read(cmount, fd, in.data(), len, i * len), (int)len);
+    ASSERT_EQ(big, in);
+  }
+
+  struct ceph_statx stx;
+  ASSERT_EQ(ceph_fstatx(cmount, fd, &stx, CEPH_STATX_SIZE, 0), 0);
+  ASSERT_EQ(stx.stx_size, 8 * len);
+
+  ASSERT_EQ(ceph_close(cmount, fd), 0);
+  ASSERT_EQ(ceph_unlink(cmount, testf), 0);
+  ceph_shutdown(cmount);
+}
+
 TEST(LibCephFS, PreadvPwritev) {
   struct ceph_mount_info *cmount;
   ASSERT_EQ(ceph_create(&cmount, NULL), 0);
@@ -1293,6 +1337,102 @@ TEST(LibCephFS, LlreadvLlwritev) {
   ceph_shutdown(cmount);
 }
 
+TEST(LibCephFS, LlReadBuffers) {
+  struct ceph_mount_info *cmount;
+  ASSERT_EQ(ceph_create(&cmount, NULL), 0);
+  ASSERT_EQ(ceph_conf_read_file(cmount, NULL), 0);
+  ASSERT_EQ(0, ceph_conf_parse_env(cmount, NULL));
+  ASSERT_EQ(ceph_mount(cmount, NULL), 0);
+
+  char filename[256];
+  sprintf(filename, "test_llreadbuffersfile%u", getpid());
+
+  Inode *root, *file;
+  Fh *fh;
+  struct ceph_statx stx;
+  UserPerm *perms = ceph_mount_perms(cmount);
+  ASSERT_EQ(ceph_ll_lookup_root(cmount, &root), 0);
+  ASSERT_EQ(ceph_ll_create(cmount, root, filename, 0666,
+			   O_RDWR|O_CREAT|O_TRUNC, &file, &fh, &stx, 0, 0, perms), 0);
+
+  std::string out(1 << 20, 'x');
+  for (size_t i = 0; i < out.size(); i += 4096) {
+    out[i] = 'a' + (i / 4096) % 26;
+  }
+  ASSERT_EQ(ceph_ll_write(cmount, fh, 0, out.size(), out.data()), (int)out.size());
+
+  struct ceph_read_buffers *bufs;
+  const struct iovec *iov;
+  int iovcnt;
+  ASSERT_EQ(ceph_ll_read_buffers(cmount, fh, 0, out.size() + 100, &bufs, &iov,
+				 &iovcnt), (int64_t)out.size());
+  std::string in;
+  for (int i = 0; i < iovcnt; ++i) {
+    in.append((const char*)iov[i].iov_base, iov[i].iov_len);
+  }
+  ASSERT_EQ(in, out);
+  ceph_ll_release_read_buffers(cmount, bufs);
+
+  ASSERT_EQ(ceph_ll_read_buffers(cmount, fh, out.size(), 100, &bufs, &iov,
+				 &iovcnt), 0);
+  ASSERT_EQ(iovcnt, 0);
+  ceph_ll_release_read_buffers(cmount, bufs);
+
+  ceph_ll_close(cmount, fh);
+  ceph_ll_put(cmount, file);
+  ASSERT_EQ(ceph_unlink(cmount, filename), 0);
+  ceph_shutdown(cmount);
+}
+
+TEST(LibCephFS, LlUnlinkBatch) {
+  struct ceph_mount_info *cmount;
+  ASSERT_EQ(ceph_create(&cmount, NULL), 0);
+  ASSERT_EQ(ceph_conf_read_file(cmount, NULL), 0);
+  ASSERT_EQ(0, ceph_conf_parse_env(cmount, NULL));
+  ASSERT_EQ(ceph_mount(cmount, NULL), 0);
+
+  char dirname[256];
+  sprintf(dirname, "test_llunlinkbatch%u", getpid());
+
+  Inode *root, *dir;
+  struct ceph_statx stx;
+  UserPerm *perms = ceph_mount_perms(cmount);
+  ASSERT_EQ(ceph_ll_lookup_root(cmount, &root), 0);
+  ASSERT_EQ(ceph_ll_mkdir(cmount, root, dirname, 0755, &dir, &stx, 0, 0, perms), 0);
+
+  const int count = 16;
+  std::vector<std::string> names;
+  for (int i = 0; i < count; ++i) {
+    Inode *file;
+    Fh *fh;
+    names.push_back("file" + std::to_string(i));
+    ASSERT_EQ(ceph_ll_create(cmount, dir, names.back().c_str(), 0666,
+			     O_RDWR|O_CREAT|O_EXCL, &file, &fh, &stx, 0, 0, perms), 0);
+    ASSERT_EQ(ceph_ll_close(cmount, fh), 0);
+    ceph_ll_put(cmount, file);
+  }
+  names.push_back("nonexistent");
+
+  std::vector<const char*> cnames;
+  for (auto& name : names) {
+    cnames.push_back(name.c_str());
+  }
+  std::vector<int> results(cnames.size(), 1);
+  ASSERT_EQ(ceph_ll_unlink_batch(cmount, dir, cnames.data(), cnames.size(),
+				 perms, results.data()), 0);
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(results[i], 0);
+    Inode *file;
+    ASSERT_EQ(ceph_ll_lookup(cmount, dir, cnames[i], &file, &stx, 0, 0, perms),
+	      -CEPHFS_ENOENT);
+  }
+  ASSERT_EQ(results[count], -CEPHFS_ENOENT);
+
+  ceph_ll_put(cmount, dir);
+  ASSERT_EQ(ceph_rmdir(cmount, dirname), 0);
+  ceph_shutdown(cmount);
+}
+
 TEST(LibCephFS, StripeUnitGran) {
   struct ceph_mount_info *cmount;
   ASSERT_EQ(ceph_create(&cmount, NULL), 0);
@@ -1364,6 +1364,11 @@ int cls_cxx_map_remove_key(cls_method_context_t hctx, const string &key) {
   std::set<std::string> keys;
   keys.insert(key);
 
+  return cls_cxx_map_remove_keys(hctx, keys);
+}
+
+int cls_cxx_map_remove_keys(cls_method_context_t hctx,
+                            const std::set<std::string> &keys) {
   librados::TestClassHandler::MethodContext *ctx =
     reinterpret_cast<librados::TestClassHandler::MethodContext*>(hctx);
   return ctx->io_ctx_impl->omap_rm_keys(ctx->oid, keys);
@@ -0,0 +1,55 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "messages/MMgrReport.h"
+#include "gtest/gtest.h"
+
+TEST(PerfCounterChanges, round_trip)
+{
+  PerfCounterChanges changes;
+  const unsigned n = 21;
+  for (unsigned i = 0; i < n; ++i) {
+    changes.push_back(i % 3 == 0);
+  }
+  ceph::buffer::list bl;
+  encode(changes, bl);
+
+  PerfCounterChanges decoded;
+  auto p = bl.cbegin();
+  decode(decoded, p);
+  ASSERT_TRUE(p.end());
+  for (unsigned i = 0; i < n; ++i) {
+    EXPECT_EQ(i % 3 == 0, decoded.test(i)) << "counter " << i;
+  }
+  // counters the bitmap does not cover are left out
+  EXPECT_FALSE(decoded.test(n + 100));
+}
+
+TEST(PerfCounterChanges, one_bit_per_counter)
+{
+  PerfCounterChanges changes;
+  for (unsigned i = 0; i < 17; ++i) {
+    changes.push_back(true);
+  }
+  ceph::buffer::list bl;
+  encode(changes, bl);
+  // the wire format is a vector of bytes
+  std::vector<uint8_t> bits;
+  auto p = bl.cbegin();
+  decode(bits, p);
+  ASSERT_EQ(3u, bits.size());
+  EXPECT_EQ(0xff, bits[0]);
+  EXPECT_EQ(0xff, bits[1]);
+  EXPECT_EQ(0x01, bits[2]);
+}
+
+TEST(PerfCounterChanges, empty)
+{
+  PerfCounterChanges changes;
+  ceph::buffer::list bl;
+  encode(changes, bl);
+  PerfCounterChanges decoded;
+  auto p = bl.cbegin();
+  decode(decoded, p);
+  EXPECT_FALSE(decoded.test(0));
+}
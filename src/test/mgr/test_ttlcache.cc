@@ -26,6 +26,15 @@ TEST(TTLCache, Erase) {
   }
 }
 
+TEST(TTLCache, Exists) {
+	TTLCache<string, int> c{100};
+	ASSERT_FALSE(c.exists("foo"));
+	c.insert("foo", 1);
+	ASSERT_TRUE(c.exists("foo"));
+	c.erase("foo");
+	ASSERT_FALSE(c.exists("foo"));
+}
+
 TEST(TTLCache, Clear) {
 	TTLCache<string, int> c{100};
 	c.insert("foo", 1);
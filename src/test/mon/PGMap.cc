@@ -167,3 +167,46 @@ TEST(pgmap, dump_object_stat_sum_2)
   ASSERT_EQ(percentify(0), tbl.get(0, col++));
   ASSERT_EQ(stringify(byte_u_t(avail/pool.size)), tbl.get(0, col++));
 }
+
+// stats updates that keep a pg's mapping take the shortcut in
+// apply_incremental(), the result must match a full recount
+TEST(pgmap, apply_incremental)
+{
+  PGMap pg_map;
+  auto apply = [&pg_map](const map<pg_t, pg_stat_t>& updates) {
+    PGMap::Incremental inc;
+    inc.version = pg_map.version + 1;
+    inc.stamp = utime_t(pg_map.version + 1, 0);
+    inc.pg_stat_updates.insert(updates.begin(), updates.end());
+    pg_map.apply_incremental(nullptr, inc);
+  };
+  auto make_stat = [](vector<int32_t> osds, uint64_t objects) {
+    pg_stat_t s;
+    s.state = PG_STATE_ACTIVE | PG_STATE_CLEAN;
+    s.up = s.acting = osds;
+    s.up_primary = s.acting_primary = osds[0];
+    s.stats.sum.num_objects = objects;
+    return s;
+  };
+  apply({{pg_t(0, 1), make_stat({0, 1}, 1)},
+	 {pg_t(1, 1), make_stat({1, 2}, 2)}});
+  // same mapping, new stats
+  apply({{pg_t(0, 1), make_stat({0, 1}, 10)}});
+  // remapped
+  apply({{pg_t(1, 1), make_stat({2, 0}, 20)}});
+
+  ASSERT_EQ(30, pg_map.pg_sum.stats.sum.num_objects);
+  ASSERT_EQ(30, pg_map.pg_pool_sum[1].stats.sum.num_objects);
+  auto pg_by_osd = pg_map.pg_by_osd;
+  auto num_pg_by_osd = pg_map.num_pg_by_osd;
+  pg_map.calc_stats();
+  ASSERT_EQ(pg_map.pg_by_osd, pg_by_osd);
+  ASSERT_EQ(pg_map.num_pg_by_osd.size(), num_pg_by_osd.size());
+  for (auto& [osd, count] : pg_map.num_pg_by_osd) {
+    ASSERT_EQ(count.acting, num_pg_by_osd[osd].acting);
+    ASSERT_EQ(count.up_not_acting, num_pg_by_osd[osd].up_not_acting);
+    ASSERT_EQ(count.primary, num_pg_by_osd[osd].primary);
+  }
+  ASSERT_EQ(2u, pg_map.get_num_pg_by_osd(0));
+  ASSERT_EQ(1, pg_map.get_num_primary_pg_by_osd(2));
+}
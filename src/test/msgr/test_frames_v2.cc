@@ -279,6 +279,46 @@ TEST_P(RoundTripTest, Reuse) {
   }
 }
 
+TEST(FrameAssembler, CompressionStream) {
+  // frames compressed with the context of the previous ones still decode
+  // one by one, and repetitive ones get much smaller than on their own
+  CompConnectionMeta comp_meta;
+  comp_meta.con_mode = Compressor::COMP_FORCE;
+  comp_meta.con_method = Compressor::COMP_ALG_ZSTD;
+  auto tx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
+    g_ceph_context, comp_meta, /*min_compress_size=*/0, /*stream=*/true);
+  auto rx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
+    g_ceph_context, comp_meta, /*min_compress_size=*/0, /*stream=*/true);
+  ASSERT_TRUE(tx_comp.tx);
+  ASSERT_TRUE(rx_comp.rx);
+  ceph::crypto::onwire::rxtx_t tx_crypto, rx_crypto;
+  FrameAssembler tx_frame_asm(&tx_crypto, true, true, &tx_comp);
+  FrameAssembler rx_frame_asm(&rx_crypto, true, true, &rx_comp);
+
+  uint64_t logical = 0, onwire = 0;
+  for (int i = 0; i < 100; i++) {
+    bufferlist header, front, middle, data;
+    header.append("header " + std::to_string(i));
+    front.append(std::string(200, 'F') + std::to_string(i));
+    data.append("a message much like the one before " + std::to_string(i));
+    auto tx_frame = TestFrame::Encode(header, front, middle, data);
+    auto onwire_bl = tx_frame.get_buffer(tx_frame_asm);
+    logical += tx_frame_asm.get_frame_logical_len();
+    onwire += onwire_bl.length();
+
+    Tag rx_tag;
+    segment_bls_t rx_segment_bls;
+    ASSERT_TRUE(disassemble_frame(rx_frame_asm, onwire_bl, rx_tag,
+				  rx_segment_bls));
+    ASSERT_EQ(TestFrame::tag, rx_tag);
+    auto rx_frame = TestFrame::Decode(rx_segment_bls);
+    ASSERT_TRUE(header.contents_equal(rx_frame.header()));
+    ASSERT_TRUE(front.contents_equal(rx_frame.front()));
+    ASSERT_TRUE(data.contents_equal(rx_frame.data()));
+  }
+  EXPECT_LT(onwire, logical / 2);
+}
+
 static const round_trip_instance_t round_trip_instances[] = {
   // first segment is empty
   { 0,   0,   0,   0, 1, {{32,  0,  17,   0,   0,  0},
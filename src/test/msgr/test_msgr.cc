@@ -1062,6 +1062,113 @@ TEST_P(MessengerTest, SimpleMsgr2Test) {
   server_msgr->wait();
 }
 
+struct DataAlignDispatcher : public Dispatcher {
+  ceph::mutex lock = ceph::make_mutex("DataAlignDispatcher::lock");
+  ceph::condition_variable cond;
+  std::optional<bufferlist> data;
+
+  DataAlignDispatcher() : Dispatcher(g_ceph_context) {}
+  bool ms_can_fast_dispatch_any() const override { return false; }
+  bool ms_dispatch(Message *m) override {
+    std::lock_guard l{lock};
+    data = m->get_data();
+    cond.notify_all();
+    m->put();
+    return true;
+  }
+  bool ms_handle_reset(Connection *con) override { return true; }
+  void ms_handle_remote_reset(Connection *con) override {}
+  bool ms_handle_refused(Connection *con) override { return false; }
+  int ms_handle_fast_authentication(Connection *con) override { return 1; }
+};
+
+TEST_P(MessengerTest, Msgr2DataOffsetAlignment) {
+  // msgr2 receives the data segment so that its in-page offset matches
+  // header.data_off, as msgr1 does
+  DataAlignDispatcher cli_dispatcher, srv_dispatcher;
+  entity_addr_t bind_addr;
+  bind_addr.parse("v2:127.0.0.1");
+  server_msgr->bind(bind_addr);
+  server_msgr->add_dispatcher_head(&srv_dispatcher);
+  server_msgr->start();
+  client_msgr->add_dispatcher_head(&cli_dispatcher);
+  client_msgr->start();
+
+  ConnectionRef conn = client_msgr->connect_to(server_msgr->get_mytype(),
+					       server_msgr->get_myaddrs());
+  for (unsigned off : {0u, 512u, 4095u, 8192u + 100u}) {
+    bufferlist bl;
+    bl.append(std::string(3 * CEPH_PAGE_SIZE, 'a' + off % 26));
+    MPing *m = new MPing();
+    m->set_data(bl);
+    m->get_header().data_off = off;
+    ASSERT_EQ(conn->send_message(m), 0);
+    std::unique_lock l{srv_dispatcher.lock};
+    srv_dispatcher.cond.wait(l, [&] { return srv_dispatcher.data.has_value(); });
+    ASSERT_TRUE(bl.contents_equal(*srv_dispatcher.data));
+    ASSERT_EQ(1u, srv_dispatcher.data->get_num_buffers());
+    ASSERT_EQ(off & ~CEPH_PAGE_MASK,
+	      reinterpret_cast<uintptr_t>(srv_dispatcher.data->c_str()) &
+	      ~CEPH_PAGE_MASK);
+    srv_dispatcher.data.reset();
+  }
+  client_msgr->shutdown();
+  client_msgr->wait();
+  server_msgr->shutdown();
+  server_msgr->wait();
+}
+
+TEST_P(MessengerTest, CompressionStreamTest) {
+  // on-wire compression is only negotiated between osds
+  g_ceph_context->_conf.set_val("ms_osd_compress_mode", "force");
+  g_ceph_context->_conf.set_val("ms_osd_compression_algorithm", "zstd");
+  g_ceph_context->_conf.set_val("ms_compression_stream", "true");
+  g_ceph_context->_conf.apply_changes(nullptr);
+  Messenger *osd_msgr = Messenger::create(g_ceph_context, string(GetParam()),
+					  entity_name_t::OSD(1), "osd",
+					  getpid());
+  osd_msgr->set_default_policy(Messenger::Policy::lossless_peer(0));
+  osd_msgr->set_auth_client(&dummy_auth);
+  osd_msgr->set_auth_server(&dummy_auth);
+
+  DataAlignDispatcher cli_dispatcher, srv_dispatcher;
+  entity_addr_t bind_addr;
+  bind_addr.parse("v2:127.0.0.1");
+  server_msgr->bind(bind_addr);
+  server_msgr->add_dispatcher_head(&srv_dispatcher);
+  server_msgr->start();
+  osd_msgr->add_dispatcher_head(&cli_dispatcher);
+  osd_msgr->start();
+
+  for (int round = 0; round < 2; round++) {
+    // a new session starts both stream contexts over
+    ConnectionRef conn = osd_msgr->connect_to(server_msgr->get_mytype(),
+					      server_msgr->get_myaddrs());
+    for (int i = 0; i < 50; i++) {
+      bufferlist bl;
+      bl.append(std::string(4000, 'a' + i % 26));
+      bl.append(std::to_string(i));
+      MPing *m = new MPing();
+      m->set_data(bl);
+      ASSERT_EQ(conn->send_message(m), 0);
+      std::unique_lock l{srv_dispatcher.lock};
+      srv_dispatcher.cond.wait(l, [&] { return srv_dispatcher.data.has_value(); });
+      ASSERT_TRUE(bl.contents_equal(*srv_dispatcher.data));
+      srv_dispatcher.data.reset();
+    }
+    conn->mark_down();
+  }
+  osd_msgr->shutdown();
+  osd_msgr->wait();
+  server_msgr->shutdown();
+  server_msgr->wait();
+  delete osd_msgr;
+  g_ceph_context->_conf.rm_val("ms_osd_compress_mode");
+  g_ceph_context->_conf.rm_val("ms_osd_compression_algorithm");
+  g_ceph_context->_conf.rm_val("ms_compression_stream");
+  g_ceph_context->_conf.apply_changes(nullptr);
+}
+
 TEST_P(MessengerTest, FeatureTest) {
   FakeDispatcher cli_dispatcher(false), srv_dispatcher(true);
   entity_addr_t bind_addr;
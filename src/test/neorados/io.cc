@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -379,3 +380,32 @@ CORO_TEST_F(NeoRadosIo, GetXattrs, NeoRadosTest) {
 
   co_return;
 }
+
+CORO_TEST_F(NeoRadosIo, BatchRoundTrip, NeoRadosTest) {
+  static constexpr auto count = 16u;
+  std::vector<std::pair<neorados::Object, WriteOp>> writes;
+  for (auto i = 0u; i < count; ++i) {
+    writes.emplace_back(fmt::format("batch.{}", i),
+			WriteOp{}.write_full(filled_buffer_list(i, 64)));
+  }
+  co_await rados().execute(pool(), std::move(writes), asio::use_awaitable);
+
+  std::array<buffer::list, count> bls;
+  std::vector<std::pair<neorados::Object, ReadOp>> reads;
+  for (auto i = 0u; i < count; ++i) {
+    reads.emplace_back(fmt::format("batch.{}", i),
+		       ReadOp{}.read(0, 0, &bls[i]));
+  }
+  reads.emplace_back("batch.missing", ReadOp{}.read(0, 0, nullptr));
+  std::vector<sys::error_code> ecs;
+  co_await expect_error_code(
+    rados().execute(pool(), std::move(reads), asio::use_awaitable, &ecs),
+    sys::errc::no_such_file_or_directory);
+  EXPECT_EQ(count + 1, ecs.size());
+  for (auto i = 0u; i < count; ++i) {
+    EXPECT_FALSE(ecs[i]);
+    EXPECT_EQ(filled_buffer_list(i, 64), bls[i]);
+  }
+  EXPECT_EQ(sys::errc::no_such_file_or_directory, ecs[count]);
+  co_return;
+}
@@ -291,6 +291,9 @@ TEST_P(AllocTest, test_alloc_fragmentation)
   } else if (GetParam() == string("hybrid")) {
     // AVL allocator uses a different allocating strategy
     GTEST_SKIP() << "skipping for Hybrid allocator";
+  } else if (GetParam() == string("sharded")) {
+    // made of AVL allocators
+    GTEST_SKIP() << "skipping for Sharded allocator";
   }
 
   for (size_t i = 0; i < allocated.size(); i += 2)
@@ -655,4 +658,4 @@ TEST_P(AllocTest, test_init_rm_free_unbound)
 INSTANTIATE_TEST_SUITE_P(
   Allocator,
   AllocTest,
-  ::testing::Values("stupid", "bitmap", "avl", "hybrid", "btree"));
+  ::testing::Values("stupid", "bitmap", "avl", "hybrid", "btree", "sharded"));
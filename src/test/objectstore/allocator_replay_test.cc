@@ -27,6 +27,7 @@ void usage(const string &name) {
           "assess_free <alloc_unit>|"
           "try_alloc <count> <want> <alloc_unit>|"
           "replay_alloc <alloc_list_file|"
+          "replay_trace|"
           "export_binary <out_file>|"
           "free_histogram [<alloc_unit>] [<num_buckets>]"
        << std::endl;
@@ -39,6 +40,12 @@ void usage_replay_alloc(const string &name) {
   cerr << "Allocation request format (space separated, optional parameters are 0 if not given): want unit [max] [hint]" << std::endl;
 }
 
+void usage_replay_trace(const string &name) {
+  cerr << "Detailed replay_trace usage: " << name << " <allocator_trace> replay_trace" << std::endl;
+  cerr << "The \"allocator_trace\" parameter should be a file produced by the \"bluestore allocator trace stop\" admin socket command." << std::endl;
+  cerr << "The trace is replayed against every allocator implementation, starting from the free space recorded when the trace was started." << std::endl;
+}
+
 struct binary_alloc_map_t {
   std::vector<std::pair<uint64_t, uint64_t>> free_extents;
 
@@ -534,6 +541,178 @@ int check_duplicates(char* fname)
   return r >= 0 ? errors != 0 : r;
 }
 
+/*
+ * Replays the allocate() and release() calls of a trace recorded on a
+ * running OSD against each allocator implementation.  Since a replayed
+ * allocator hands out other extents than the traced one, a release is
+ * translated through the recorded -> replayed mapping of the allocations
+ * it frees; space the trace sees released without having seen it being
+ * allocated was in use when the trace started, and maps onto itself.
+ */
+int replay_trace(char* fname)
+{
+  bufferlist bl;
+  std::string err;
+  int r = bl.read_file(fname, &err);
+  if (r < 0) {
+    std::cerr << "error: unable to read " << fname << ": " << err << std::endl;
+    return r;
+  }
+  allocator_trace_header_t header;
+  std::vector<allocator_trace_op_t> ops;
+  try {
+    auto p = bl.cbegin();
+    decode(header, p);
+    while (!p.end()) {
+      ops.emplace_back();
+      decode(ops.back(), p);
+    }
+  } catch (const ceph::buffer::error& e) {
+    std::cerr << "error: malformed trace after " << ops.size() << " ops: "
+	      << e.what() << std::endl;
+    return -EINVAL;
+  }
+  std::cout << "trace of " << header.type << " allocator: capacity 0x"
+	    << std::hex << header.capacity << " block size 0x"
+	    << header.block_size << std::dec << ", "
+	    << header.free_extents.size() << " free extents, "
+	    << ops.size() << " ops" << std::endl;
+
+  const size_t report_every = std::max<size_t>(ops.size() / 20, 1);
+  for (auto type : { "stupid", "bitmap", "avl", "btree", "hybrid", "sharded" }) {
+    unique_ptr<Allocator> alloc(
+      Allocator::create(g_ceph_context, type, header.capacity,
+			header.block_size, ""));
+    if (!alloc) {
+      std::cerr << "error: unable to create " << type << " allocator"
+		<< std::endl;
+      return -1;
+    }
+    interval_set<uint64_t> in_use;   // allocated when the trace started
+    in_use.insert(0, header.capacity);
+    for (auto& [o, l] : header.free_extents) {
+      alloc->init_add_free(o, l);
+      in_use.erase(o, l);
+    }
+    // recorded offset -> (length, replayed offset)
+    std::map<uint64_t, std::pair<uint64_t, uint64_t>> mapping;
+    std::vector<uint64_t> latencies;
+    latencies.reserve(ops.size());
+    size_t failed = 0;
+
+    auto report = [&](size_t pos) {
+      std::cout << type << " op " << pos
+		<< " fragmentation " << alloc->get_fragmentation()
+		<< " score " << alloc->get_fragmentation_score()
+		<< " free 0x" << std::hex << alloc->get_free() << std::dec
+		<< std::endl;
+    };
+    for (size_t pos = 0; pos < ops.size(); ++pos) {
+      auto& op = ops[pos];
+      if (op.op == allocator_trace_op_t::OP_ALLOCATE) {
+	if (op.result <= 0) {
+	  continue;
+	}
+	PExtentVector extents;
+	auto start = ceph::mono_clock::now();
+	int64_t got = alloc->allocate(op.want, op.unit, op.max_alloc_size,
+				      op.hint, &extents);
+	latencies.push_back(
+	  std::chrono::duration_cast<std::chrono::nanoseconds>(
+	    ceph::mono_clock::now() - start).count());
+	if (got < op.result) {
+	  ++failed;
+	}
+	// pair up recorded and replayed extents piece by piece
+	auto re = extents.begin();
+	uint64_t re_pos = 0;
+	for (auto [o, l] : op.extents) {
+	  while (l > 0 && re != extents.end()) {
+	    uint64_t len = std::min(l, re->length - re_pos);
+	    mapping[o] = std::make_pair(len, re->offset + re_pos);
+	    o += len;
+	    l -= len;
+	    re_pos += len;
+	    if (re_pos == re->length) {
+	      ++re;
+	      re_pos = 0;
+	    }
+	  }
+	}
+      } else if (op.op == allocator_trace_op_t::OP_RELEASE) {
+	interval_set<uint64_t> release_set;
+	for (auto [o, l] : op.extents) {
+	  uint64_t end = o + l;
+	  auto it = mapping.lower_bound(o);
+	  if (it != mapping.begin()) {
+	    auto prev = std::prev(it);
+	    if (prev->first + prev->second.first > o) {
+	      it = prev;
+	    }
+	  }
+	  uint64_t cur = o;
+	  while (it != mapping.end() && it->first < end) {
+	    uint64_t p_off = it->first;
+	    auto [p_len, p_replay] = it->second;
+	    if (cur < p_off) {
+	      interval_set<uint64_t> pre;
+	      pre.insert(cur, p_off - cur);
+	      pre.intersection_of(in_use);
+	      in_use.subtract(pre);
+	      release_set.union_of(pre);
+	    }
+	    uint64_t from = std::max(p_off, o);
+	    uint64_t to = std::min(p_off + p_len, end);
+	    release_set.union_insert(p_replay + (from - p_off), to - from);
+	    it = mapping.erase(it);
+	    if (p_off < from) {
+	      mapping[p_off] = std::make_pair(from - p_off, p_replay);
+	    }
+	    if (to < p_off + p_len) {
+	      mapping[to] = std::make_pair(p_off + p_len - to,
+					   p_replay + (to - p_off));
+	    }
+	    cur = to;
+	  }
+	  if (cur < end) {
+	    interval_set<uint64_t> pre;
+	    pre.insert(cur, end - cur);
+	    pre.intersection_of(in_use);
+	    in_use.subtract(pre);
+	    release_set.union_of(pre);
+	  }
+	}
+	if (!release_set.empty()) {
+	  alloc->release(release_set);
+	}
+      }
+      if ((pos + 1) % report_every == 0) {
+	report(pos + 1);
+      }
+    }
+    report(ops.size());
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double q) -> uint64_t {
+      if (latencies.empty()) {
+	return 0;
+      }
+      return latencies[std::min<size_t>(latencies.size() * q,
+					latencies.size() - 1)];
+    };
+    std::cout << type << " allocations " << latencies.size()
+	      << " short " << failed
+	      << " latency ns p50 " << pct(0.5)
+	      << " p90 " << pct(0.9)
+	      << " p99 " << pct(0.99)
+	      << " p99.9 " << pct(0.999)
+	      << " max " << (latencies.empty() ? 0 : latencies.back())
+	      << std::endl;
+    alloc->shutdown();
+  }
+  return 0;
+}
+
 int main(int argc, char **argv)
 {
   auto args = argv_to_vec(argc, argv);
@@ -780,5 +959,11 @@ int main(int argc, char **argv)
     return export_as_binary(argv[1], argv[3]);
   } else if (strcmp(argv[2], "duplicates") == 0) {
     return check_duplicates(argv[1]);
+  } else if (strcmp(argv[2], "replay_trace") == 0) {
+    if (argc != 3) {
+      usage_replay_trace(argv[0]);
+      return 1;
+    }
+    return replay_trace(argv[1]);
   }
 }
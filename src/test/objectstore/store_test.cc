@@ -5302,6 +5302,7 @@ TEST_P(StoreTestSpecificAUSize, SyntheticMatrixSharding) {
     { "bluestore_extent_map_shard_min_size", "60", 0 },
     { "bluestore_extent_map_shard_max_size", "300", 0 },
     { "bluestore_extent_map_shard_target_size", "150", 0 },
+    { "bluestore_extent_map_max_loaded_shards", "0", "1", 0 },
     { "bluestore_default_buffered_read", "true", 0 },
     { "bluestore_default_buffered_write", "true", 0 },
     { 0 },
@@ -5345,6 +5346,7 @@ TEST_P(StoreTestSpecificAUSize, SyntheticShardingLimited) {
     { "bluestore_extent_map_shard_min_size", "60", 0 },
     { "bluestore_extent_map_shard_max_size", "300", 0 },
     { "bluestore_extent_map_shard_target_size", "150", 0 },
+    { "bluestore_collection_list_prefetch_onodes", "0", "64", 0 },
     { "bluestore_default_buffered_read", "true", 0 },
     { "bluestore_default_buffered_write", "true", 0 },
     { 0 },
@@ -5502,6 +5504,187 @@ TEST_P(StoreTestSpecificAUSize, SyntheticMatrixPreferDeferred) {
   };
   do_matrix(m, &StoreTestSpecificAUSize::SyntheticTest);
 }
+
+TEST_P(StoreTestSpecificAUSize, SyntheticMatrixKvSyncPipeline) {
+  if (string(GetParam()) != "bluestore")
+    return;
+
+  // the commit thread is only started at mount
+  SetVal(g_conf(), "bluestore_kv_sync_pipeline", "true");
+  g_conf().apply_changes(nullptr);
+
+  const char *m[][10] = {
+    { "bluestore_min_alloc_size", "4096", "65536", 0 }, // to be the first!
+    { "max_write", "65536", 0 },
+    { "max_size", "1048576", 0 },
+    { "alignment", "512", 0 },
+    { "bluestore_max_blob_size", "262144", 0 },
+    { "bluestore_prefer_deferred_size", "32768", "0", 0},
+    { "bluestore_sync_submit_transaction", "true", "false", 0 },
+    { 0 },
+  };
+  do_matrix(m, &StoreTestSpecificAUSize::SyntheticTest);
+}
+
+TEST_P(StoreTestSpecificAUSize, KvSyncPipelineDeferredRemount) {
+  if (string(GetParam()) != "bluestore")
+    return;
+
+  size_t alloc_size = 4096;
+  size_t object_size = 256 * 1024;
+  unsigned num_objects = 16;
+  unsigned num_overwrites = 64;
+
+  SetVal(g_conf(), "bluestore_kv_sync_pipeline", "true");
+  SetVal(g_conf(), "bluestore_prefer_deferred_size", "65536");
+  g_conf().apply_changes(nullptr);
+  StartDeferred(alloc_size);
+
+  int r;
+  coll_t cid;
+  const PerfCounters* logger = store->get_perf_counters();
+  ObjectStore::CollectionHandle ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  auto name = [](unsigned i) {
+    return ghobject_t(hobject_t("test-" + to_string(i), "", CEPH_NOSNAP, 0, -1, ""));
+  };
+  std::vector<bufferlist> expected(num_objects);
+  for (unsigned i = 0; i < num_objects; ++i) {
+    ObjectStore::Transaction t;
+    expected[i].append(std::string(object_size, 'a' + i));
+    t.write(cid, name(i), 0, expected[i].length(), expected[i]);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  // small overwrites go deferred, and keep enough transactions in flight
+  // for the sync thread to prepare a batch while another one commits
+  uint64_t deferred_before = logger->get(l_bluestore_issued_deferred_writes);
+  for (unsigned j = 0; j < num_overwrites; ++j) {
+    for (unsigned i = 0; i < num_objects; ++i) {
+      ObjectStore::Transaction t;
+      bufferlist bl;
+      bl.append(std::string(alloc_size, 'A' + (i + j) % 26));
+      uint64_t offset = ((i * 7 + j * 13) % (object_size / alloc_size)) * alloc_size;
+      t.write(cid, name(i), offset, bl.length(), bl);
+      r = queue_transaction(store, ch, std::move(t));
+      ASSERT_EQ(r, 0);
+      bufferlist updated;
+      updated.substr_of(expected[i], 0, offset);
+      updated.append(bl);
+      bufferlist tail;
+      tail.substr_of(expected[i], offset + alloc_size,
+		     object_size - offset - alloc_size);
+      updated.append(tail);
+      expected[i] = std::move(updated);
+    }
+  }
+  ASSERT_GT(logger->get(l_bluestore_issued_deferred_writes), deferred_before);
+
+  // umount drains the commit thread before the finalizer, and mount
+  // replays whatever deferred io was left
+  ch.reset(nullptr);
+  CloseAndReopen();
+  ch = store->open_collection(cid);
+  for (unsigned i = 0; i < num_objects; ++i) {
+    bufferlist bl;
+    r = store->read(ch, name(i), 0, object_size, bl);
+    ASSERT_EQ(r, (int)object_size);
+    ASSERT_TRUE(bl_eq(expected[i], bl));
+  }
+  {
+    ObjectStore::Transaction t;
+    for (unsigned i = 0; i < num_objects; ++i) {
+      t.remove(cid, name(i));
+    }
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
+
+TEST_P(StoreTestSpecificAUSize, ExtentMapUnloadReadAfterWrite) {
+  if (string(GetParam()) != "bluestore")
+    return;
+
+  size_t alloc_size = 4096;
+  size_t object_size = 1024 * 1024;
+  SetVal(g_conf(), "bluestore_max_blob_size", "4096");
+  SetVal(g_conf(), "bluestore_extent_map_shard_min_size", "50");
+  SetVal(g_conf(), "bluestore_extent_map_shard_target_size", "100");
+  SetVal(g_conf(), "bluestore_extent_map_shard_max_size", "200");
+  SetVal(g_conf(), "bluestore_extent_map_max_loaded_shards", "1");
+  g_conf().apply_changes(nullptr);
+  StartDeferred(alloc_size);
+
+  int r;
+  coll_t cid;
+  ghobject_t hoid(hobject_t("test", "", CEPH_NOSNAP, 0, -1, ""));
+  ObjectStore::CollectionHandle ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  bufferlist expected;
+  expected.append(std::string(object_size, 'a'));
+  {
+    ObjectStore::Transaction t;
+    t.write(cid, hoid, 0, expected.length(), expected);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  // every write is read back, together with another range that makes the
+  // read drop the other shards, while earlier writes are still in flight
+  gen_type rng(time(NULL));
+  boost::uniform_int<> u(0, object_size / alloc_size - 1);
+  for (unsigned i = 0; i < 2000; ++i) {
+    uint64_t offset = u(rng) * alloc_size;
+    bufferlist bl;
+    bl.append(std::string(alloc_size, 'b' + i % 24));
+    {
+      ObjectStore::Transaction t;
+      t.write(cid, hoid, offset, bl.length(), bl);
+      r = queue_transaction(store, ch, std::move(t));
+      ASSERT_EQ(r, 0);
+    }
+    bufferlist updated;
+    updated.substr_of(expected, 0, offset);
+    updated.append(bl);
+    bufferlist tail;
+    tail.substr_of(expected, offset + alloc_size,
+		   object_size - offset - alloc_size);
+    updated.append(tail);
+    expected = std::move(updated);
+
+    uint64_t other = u(rng) * alloc_size;
+    for (auto o : {other, offset}) {
+      bufferlist in, exp;
+      r = store->read(ch, hoid, o, alloc_size, in);
+      ASSERT_EQ(r, (int)alloc_size);
+      exp.substr_of(expected, o, alloc_size);
+      ASSERT_TRUE(bl_eq(exp, in));
+    }
+  }
+  {
+    bufferlist in;
+    r = store->read(ch, hoid, 0, object_size, in);
+    ASSERT_EQ(r, (int)object_size);
+    ASSERT_TRUE(bl_eq(expected, in));
+  }
+  {
+    ObjectStore::Transaction t;
+    t.remove(cid, hoid);
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
 #endif // WITH_BLUESTORE
 
 TEST_P(StoreTest, AttrSynthetic) {
@@ -6115,6 +6298,77 @@ TEST_P(StoreTest, OMapIterator) {
   }
 }
 
+TEST_P(StoreTest, OMapIteratorPrefixFilter) {
+  if (string(GetParam()) != "bluestore")
+    return;
+  SetVal(g_conf(), "bluestore_rocksdb_omap_prefix_filter", "true");
+  g_conf().apply_changes(nullptr);
+  int r = store->umount();
+  ASSERT_EQ(0, r);
+  r = store->mount();
+  ASSERT_EQ(0, r);
+
+  coll_t cid(spg_t(pg_t(0, 1), shard_id_t::NO_SHARD));
+  auto ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  // neighbouring objects, every other one with its omap removed again
+  const int num_objects = 10;
+  const int num_keys = 50;
+  std::vector<ghobject_t> oids;
+  for (int i = 0; i < num_objects; ++i) {
+    oids.emplace_back(hobject_t(sobject_t("omap_prefix_" + stringify(i),
+					  CEPH_NOSNAP)));
+    oids.back().hobj.pool = 1;
+    ObjectStore::Transaction t;
+    t.touch(cid, oids.back());
+    map<string, bufferlist> keys;
+    for (int k = 0; k < num_keys; ++k) {
+      keys["key-" + stringify(k)].append(stringify(i));
+    }
+    t.omap_setkeys(cid, oids.back(), keys);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  for (int i = 0; i < num_objects; i += 2) {
+    ObjectStore::Transaction t;
+    t.omap_clear(cid, oids[i]);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  // land the keys and tombstones in tables
+  store->compact();
+
+  for (int i = 0; i < num_objects; ++i) {
+    auto iter = store->get_omap_iterator(ch, oids[i]);
+    int count = 0;
+    for (iter->seek_to_first(); iter->valid(); iter->next(), ++count) {
+      ASSERT_EQ(stringify(i), iter->value().to_str());
+    }
+    ASSERT_EQ(i % 2 ? num_keys : 0, count);
+    if (i % 2) {
+      iter->lower_bound("key-3");
+      ASSERT_TRUE(iter->valid());
+      ASSERT_EQ("key-3", iter->key());
+      iter->upper_bound("key-9");
+      ASSERT_FALSE(iter->valid());
+    }
+  }
+  {
+    ObjectStore::Transaction t;
+    for (auto& oid : oids) {
+      t.remove(cid, oid);
+    }
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
+
 TEST_P(StoreTest, XattrTest) {
   coll_t cid;
   ghobject_t hoid(hobject_t("tesomap", "", CEPH_NOSNAP, 0, 0, ""));
@@ -397,6 +397,43 @@ TEST(bluestore_blob_t, calc_csum)
   }
 }
 
+TEST(bluestore_blob_t, verify_csum_batched)
+{
+  // enough chunks to span several verification batches, split across
+  // buffers so that some chunks straddle a buffer boundary
+  const unsigned chunk_order = 9;
+  const unsigned chunk_size = 1u << chunk_order;
+  const unsigned nchunks = 100;
+  bufferptr bp(chunk_size * nchunks);
+  for (unsigned i = 0; i < bp.length(); ++i)
+    bp.c_str()[i] = (i * 7 + 3) & 0xff;
+  bufferlist bl;
+  bl.append(bp, 0, chunk_size * 37 + 100);
+  bl.append(bp, chunk_size * 37 + 100, chunk_size * (nchunks - 37) - 100);
+
+  for (unsigned csum_type = Checksummer::CSUM_NONE + 1;
+       csum_type < Checksummer::CSUM_MAX;
+       ++csum_type) {
+    cout << "csum_type " << Checksummer::get_csum_type_string(csum_type)
+	 << std::endl;
+    bluestore_blob_t b;
+    int bad_off;
+    uint64_t bad_csum;
+    b.init_csum(csum_type, chunk_order, bl.length());
+    b.calc_csum(0, bl);
+    ASSERT_EQ(0, b.verify_csum(0, bl, &bad_off, &bad_csum));
+    ASSERT_EQ(-1, bad_off);
+
+    for (unsigned bad : {0u, 36u, 37u, 70u, nchunks - 1}) {
+      bufferlist corrupt;
+      corrupt.append(bl.c_str(), bl.length());
+      corrupt.c_str()[bad * chunk_size + 5] ^= 0xff;
+      ASSERT_EQ(-1, b.verify_csum(0, corrupt, &bad_off, &bad_csum));
+      ASSERT_EQ((int)(bad * chunk_size), bad_off);
+    }
+  }
+}
+
 TEST(bluestore_blob_t, csum_bench)
 {
   bufferlist bl;
@@ -58,5 +58,13 @@ TEST(ECUtil, stripe_info_t)
 
   ASSERT_EQ(s.offset_len_to_stripe_bounds(make_pair(swidth-10, (uint64_t)20)),
             make_pair((uint64_t)0, 2*swidth));
+
+  // 1024 byte chunks: [swidth-10, swidth+10) ends chunk 3, starts chunk 4
+  ASSERT_EQ(s.offset_len_to_data_chunk_indices(swidth-10, 20),
+            make_pair((uint64_t)3, (uint64_t)5));
+  ASSERT_EQ(s.offset_len_to_data_chunk_indices(1024, 1024),
+            make_pair((uint64_t)1, (uint64_t)2));
+  ASSERT_EQ(s.offset_len_to_data_chunk_indices(100, 0),
+            make_pair((uint64_t)0, (uint64_t)1));
 }
 
@@ -844,6 +844,90 @@ TEST_F(OSDMapTest, parse_osd_id_list) {
   ASSERT_EQ(-EINVAL, osdmap.parse_osd_id_list({"-12"}, &out, &cout));
 }
 
+TEST_F(OSDMapTest, CalcPGUpmapsThreads) {
+  // searching in parallel must not change the plan
+  set_up_map(20, true);
+  int64_t pool_id = 1;
+  {
+    OSDMap::Incremental pending_inc(osdmap.get_epoch() + 1);
+    pending_inc.new_pool_max = osdmap.get_pool_max();
+    pool_id = ++pending_inc.new_pool_max;
+    pg_pool_t empty;
+    auto p = pending_inc.get_new_pool(pool_id, &empty);
+    p->size = 3;
+    p->min_size = 1;
+    p->set_pg_num(256);
+    p->set_pgp_num(256);
+    p->type = pg_pool_t::TYPE_REPLICATED;
+    p->crush_rule = 0;
+    p->set_flag(pg_pool_t::FLAG_HASHPSPOOL);
+    pending_inc.new_pool_names[pool_id] = "upmap_pool";
+    osdmap.apply_incremental(pending_inc);
+  }
+  // no shuffling, the engine is seeded differently on every call
+  g_ceph_context->_conf.set_val("osd_calc_pg_upmaps_aggressively", "false");
+  auto calc = [&](const char *threads) {
+    g_ceph_context->_conf.set_val("osd_calc_pg_upmaps_threads", threads);
+    OSDMap::Incremental pending_inc(osdmap.get_epoch() + 1);
+    osdmap.calc_pg_upmaps(g_ceph_context, 1, 100, {pool_id}, &pending_inc);
+    return pending_inc;
+  };
+  auto serial = calc("1");
+  auto parallel = calc("8");
+  g_ceph_context->_conf.rm_val("osd_calc_pg_upmaps_threads");
+  g_ceph_context->_conf.rm_val("osd_calc_pg_upmaps_aggressively");
+  ASSERT_FALSE(serial.new_pg_upmap_items.empty());
+  ASSERT_EQ(serial.new_pg_upmap_items, parallel.new_pg_upmap_items);
+  ASSERT_EQ(serial.old_pg_upmap_items, parallel.old_pg_upmap_items);
+}
+
+TEST_F(OSDMapTest, ParallelPGMapperCompletesOnce) {
+  // a job must only complete after all of its items are processed, even
+  // when the workers drain the first of them while the rest are queued
+  set_up_map();
+  struct CountingJob : public ParallelPGMapper::Job {
+    std::atomic<unsigned> processed = 0;
+    std::atomic<unsigned> completed = 0;
+    unsigned processed_at_completion = 0;
+    explicit CountingJob(const OSDMap *om) : Job(om) {}
+    void process(const vector<pg_t>& pgs) override {
+      processed += pgs.size();
+    }
+    void process(int64_t pool, unsigned ps_begin, unsigned ps_end) override {
+      processed += ps_end - ps_begin;
+    }
+    void complete() override {
+      ++completed;
+      processed_at_completion = processed;
+    }
+  };
+  vector<pg_t> pgs;
+  unsigned num_pgs = 0;
+  for (auto& [pool, p] : osdmap.get_pools()) {
+    for (unsigned ps = 0; ps < p.get_pg_num(); ++ps) {
+      pgs.emplace_back(ps, pool);
+    }
+    num_pgs += p.get_pg_num();
+  }
+  ThreadPool tp(g_ceph_context, "ParallelPGMapperCompletesOnce::tp", "mapper_tp", 4);
+  tp.start();
+  ParallelPGMapper mapper(g_ceph_context, &tp);
+  for (int round = 0; round < 20; ++round) {
+    CountingJob list_job(&osdmap);
+    mapper.queue(&list_job, 1, pgs);
+    list_job.wait();
+    ASSERT_EQ(1u, list_job.completed);
+    ASSERT_EQ(pgs.size(), list_job.processed_at_completion);
+
+    CountingJob range_job(&osdmap);
+    mapper.queue(&range_job, 1, {});
+    range_job.wait();
+    ASSERT_EQ(1u, range_job.completed);
+    ASSERT_EQ(num_pgs, range_job.processed_at_completion);
+  }
+  tp.stop();
+}
+
 TEST_F(OSDMapTest, CleanPGUpmaps) {
   set_up_map();
 
@@ -2388,6 +2472,112 @@ TEST_F(OSDMapTest, blocklisting_ips) {
   }
 }
 
+TEST_F(OSDMapTest, SquashIncrementals) {
+  set_up_map(6);
+  OSDMap squashed_map;
+  squashed_map.deepish_copy_from(osdmap);
+
+  pg_t pgid = osdmap.raw_pg_to_pg(pg_t(0, my_rep_pool));
+  vector<int> up, acting;
+  int up_primary, acting_primary;
+  osdmap.pg_to_up_acting_osds(pgid, &up, &up_primary, &acting, &acting_primary);
+  entity_addr_t client;
+  client.parse("10.1.2.3:0/1");
+  entity_addrvec_t addrs;
+  addrs.v.push_back(entity_addr_t());
+  addrs.v[0].nonce = 100;
+
+  vector<OSDMap::Incremental> incs;
+  {
+    // osd.0 goes down, a pg_temp and a client blocklisted
+    OSDMap::Incremental inc(osdmap.get_epoch() + 1);
+    inc.fsid = osdmap.get_fsid();
+    inc.new_state[0] = CEPH_OSD_UP;
+    inc.new_pg_temp[pgid] = mempool::osdmap::vector<int>(acting.rbegin(),
+							 acting.rend());
+    inc.new_blocklist[client] = ceph_clock_now();
+    // later incrementals leave require_osd_release unset
+    inc.new_require_osd_release = ceph_release_t::squid;
+    incs.push_back(inc);
+    osdmap.apply_incremental(inc);
+  }
+  {
+    // osd.1 is marked out, the pg_temp goes away and an upmap comes in
+    OSDMap::Incremental inc(osdmap.get_epoch() + 1);
+    inc.fsid = osdmap.get_fsid();
+    inc.new_weight[1] = CEPH_OSD_OUT;
+    inc.new_pg_temp[pgid] = {};
+    inc.new_pg_upmap_items[pgid] = {{up[0], 5}};
+    incs.push_back(inc);
+    osdmap.apply_incremental(inc);
+  }
+  {
+    // osd.0 comes back with new addrs, the client is let go
+    OSDMap::Incremental inc(osdmap.get_epoch() + 1);
+    inc.fsid = osdmap.get_fsid();
+    inc.new_up_client[0] = addrs;
+    inc.new_up_cluster[0] = addrs;
+    inc.new_hb_back_up[0] = addrs;
+    inc.new_hb_front_up[0] = addrs;
+    inc.new_flags = osdmap.get_flags() | CEPH_OSDMAP_NOOUT;
+    inc.old_blocklist.push_back(client);
+    incs.push_back(inc);
+    osdmap.apply_incremental(inc);
+  }
+
+  OSDMap::Incremental squashed = incs[0];
+  for (size_t i = 1; i < incs.size(); ++i) {
+    ASSERT_TRUE(squashed.squash(incs[i]));
+  }
+  ASSERT_EQ(osdmap.get_epoch(), squashed.epoch);
+  ASSERT_EQ(squashed_map.get_epoch(), squashed.get_base_epoch());
+
+  // it survives the wire
+  bufferlist bl;
+  squashed.encode(bl, CEPH_FEATURES_SUPPORTED_DEFAULT | CEPH_FEATURE_RESERVED);
+  OSDMap::Incremental decoded(bl);
+  ASSERT_EQ(squashed.get_base_epoch(), decoded.get_base_epoch());
+  squashed_map.apply_incremental(decoded);
+
+  ASSERT_EQ(osdmap.get_epoch(), squashed_map.get_epoch());
+  ASSERT_EQ(osdmap.get_flags(), squashed_map.get_flags());
+  ASSERT_EQ(ceph_release_t::squid, squashed.new_require_osd_release);
+  ASSERT_EQ(osdmap.require_osd_release, squashed_map.require_osd_release);
+  for (int i = 0; i < osdmap.get_max_osd(); ++i) {
+    ASSERT_EQ(osdmap.get_state(i), squashed_map.get_state(i));
+    ASSERT_EQ(osdmap.get_weight(i), squashed_map.get_weight(i));
+    ASSERT_EQ(osdmap.get_addrs(i), squashed_map.get_addrs(i));
+  }
+  ASSERT_EQ(osdmap.is_blocklisted(client), squashed_map.is_blocklisted(client));
+  for (auto& [poolid, pool] : osdmap.get_pools()) {
+    for (unsigned ps = 0; ps < pool.get_pg_num(); ++ps) {
+      pg_t pg(ps, poolid);
+      vector<int> up2, acting2;
+      int up_primary2, acting_primary2;
+      osdmap.pg_to_up_acting_osds(pg, &up, &up_primary, &acting,
+				  &acting_primary);
+      squashed_map.pg_to_up_acting_osds(pg, &up2, &up_primary2, &acting2,
+					&acting_primary2);
+      ASSERT_EQ(up, up2);
+      ASSERT_EQ(acting, acting2);
+      ASSERT_EQ(up_primary, up_primary2);
+      ASSERT_EQ(acting_primary, acting_primary2);
+    }
+  }
+
+  {
+    // an osd booting and marked down right after can not be folded
+    OSDMap::Incremental boot(osdmap.get_epoch() + 1);
+    boot.new_up_client[2] = addrs;
+    boot.new_hb_back_up[2] = addrs;
+    boot.new_hb_front_up[2] = addrs;
+    OSDMap::Incremental down(osdmap.get_epoch() + 2);
+    down.new_state[2] = CEPH_OSD_UP;
+    ASSERT_FALSE(boot.squash(down));
+    ASSERT_EQ(osdmap.get_epoch() + 1, boot.epoch);
+  }
+}
+
 TEST_F(OSDMapTest, blocklisting_ranges) {
   set_up_map(6); //whatever
   OSDMap::Incremental range_blocklist_inc(osdmap.get_epoch() + 1);
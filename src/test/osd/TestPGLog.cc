@@ -2293,6 +2293,42 @@ TEST_F(PGLogTest, split_into_preserves_may_include_deletes) {
   }
 }
 
+TEST_F(PGLogTest, write_rollback_info_on_change) {
+  clear();
+  ObjectStore::Transaction t;
+  coll_t coll;
+  ghobject_t log_oid(mk_obj(100));
+
+  add(mk_ple_mod(mk_obj(1), mk_evt(10, 100), mk_evt(8, 70), osd_reqid_t()));
+  {
+    map<string, bufferlist> km;
+    write_log_and_missing(t, &km, coll, log_oid, true);
+    EXPECT_EQ(1u, km.count("can_rollback_to"));
+    EXPECT_EQ(1u, km.count("rollback_info_trimmed_to"));
+  }
+
+  // neither bound moved
+  eversion_t crt = log.get_can_rollback_to();
+  add(mk_ple_mod(mk_obj(2), mk_evt(10, 101), mk_evt(8, 80), osd_reqid_t()));
+  {
+    map<string, bufferlist> km;
+    write_log_and_missing(t, &km, coll, log_oid, true);
+    EXPECT_EQ(1u, km.count(mk_evt(10, 101).get_key_name()));
+    EXPECT_EQ(crt != log.get_can_rollback_to() ? 1u : 0u,
+	      km.count("can_rollback_to"));
+    EXPECT_EQ(0u, km.count("rollback_info_trimmed_to"));
+  }
+
+  // the bounds are written again along with a full rewrite
+  mark_log_for_rewrite();
+  {
+    map<string, bufferlist> km;
+    write_log_and_missing(t, &km, coll, log_oid, true);
+    EXPECT_EQ(1u, km.count("can_rollback_to"));
+    EXPECT_EQ(1u, km.count("rollback_info_trimmed_to"));
+  }
+}
+
 class PGLogTestRebuildMissing : public PGLogTest, public StoreTestFixture {
 public:
   PGLogTestRebuildMissing() : PGLogTest(), StoreTestFixture("memstore") {}
@@ -2769,6 +2805,33 @@ TEST_F(PGLogTrimTest, TestTrimNoTrimmed) {
 }
 
 
+TEST_F(PGLogTrimTest, TestTrimObjectIndex) {
+  SetUp(20);
+  PGLog::IndexedLog log;
+  log.head = mk_evt(20, 0);
+  log.skip_can_rollback_to_to_head();
+  log.head = mk_evt(9, 0);
+  log.index();
+
+  hobject_t obj1 = mk_obj(1);
+  hobject_t obj2 = mk_obj(2);
+  log.add(mk_ple_mod(obj1, mk_evt(10, 100), mk_evt(8, 70)));
+  log.add(mk_ple_mod(obj2, mk_evt(15, 150), mk_evt(10, 100)));
+  log.add(mk_ple_mod(obj1, mk_evt(20, 160), mk_evt(10, 100)));
+
+  eversion_t write_from_dups = eversion_t::max();
+  log.trim(cct, mk_evt(15, 150), nullptr, nullptr, &write_from_dups);
+  EXPECT_EQ(1u, log.log.size());
+
+  // the index key of obj1 must refer to the remaining entry
+  EXPECT_EQ(0u, log.objects.count(obj2));
+  auto it = log.objects.find(obj1);
+  ASSERT_NE(log.objects.end(), it);
+  EXPECT_EQ(mk_evt(20, 160), it->second->version);
+  EXPECT_EQ(&it->second->soid, &it->first.get());
+  EXPECT_EQ(obj1, it->first.get());
+}
+
 TEST_F(PGLogTrimTest, TestTrimNoDups)
 {
   SetUp(10);
@@ -1050,7 +1050,7 @@ TEST(pg_missing_t, add_next_event)
     missing.add_next_event(e);
     EXPECT_TRUE(missing.is_missing(oid));
     EXPECT_EQ(eversion_t(), missing.get_items().at(oid).have);
-    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version));
+    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version).get());
     EXPECT_EQ(1U, missing.num_missing());
     EXPECT_EQ(1U, missing.get_rmissing().size());
 
@@ -1075,7 +1075,7 @@ TEST(pg_missing_t, add_next_event)
     missing.add_next_event(e);
     EXPECT_TRUE(missing.is_missing(oid));
     EXPECT_EQ(eversion_t(), missing.get_items().at(oid).have);
-    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version));
+    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version).get());
     EXPECT_EQ(1U, missing.num_missing());
     EXPECT_EQ(1U, missing.get_rmissing().size());
 
@@ -1100,7 +1100,7 @@ TEST(pg_missing_t, add_next_event)
     missing.add_next_event(e);
     EXPECT_TRUE(missing.is_missing(oid));
     EXPECT_EQ(eversion_t(), missing.get_items().at(oid).have);
-    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version));
+    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version).get());
     EXPECT_EQ(1U, missing.num_missing());
     EXPECT_EQ(1U, missing.get_rmissing().size());
 
@@ -1127,7 +1127,7 @@ TEST(pg_missing_t, add_next_event)
     EXPECT_TRUE(missing.is_missing(oid));
     EXPECT_EQ(prior_version, missing.get_items().at(oid).have);
     EXPECT_EQ(version, missing.get_items().at(oid).need);
-    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version));
+    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version).get());
     EXPECT_EQ(1U, missing.num_missing());
     EXPECT_EQ(1U, missing.get_rmissing().size());
   }
@@ -1152,7 +1152,7 @@ TEST(pg_missing_t, add_next_event)
     EXPECT_TRUE(missing.get_items().at(oid).is_delete());
     EXPECT_EQ(prior_version, missing.get_items().at(oid).have);
     EXPECT_EQ(version, missing.get_items().at(oid).need);
-    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version));
+    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version).get());
     EXPECT_EQ(1U, missing.num_missing());
     EXPECT_EQ(1U, missing.get_rmissing().size());
   }
@@ -1179,7 +1179,7 @@ TEST(pg_missing_t, add_next_event)
     EXPECT_TRUE(missing.get_items().at(oid).is_delete());
     EXPECT_EQ(prior_version, missing.get_items().at(oid).have);
     EXPECT_EQ(e.version, missing.get_items().at(oid).need);
-    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version));
+    EXPECT_EQ(oid, missing.get_rmissing().at(e.version.version).get());
     EXPECT_EQ(1U, missing.num_missing());
     EXPECT_EQ(1U, missing.get_rmissing().size());
   }
@@ -1328,6 +1328,34 @@ TEST(pg_missing_t, split_into)
   EXPECT_TRUE(missing.is_missing(oid2));
 }
 
+TEST(pg_missing_t, copy)
+{
+  hobject_t oid1(object_t("objname"), "key1", 123, 1, 0, "");
+  hobject_t oid2(object_t("objname"), "key2", 123, 2, 0, "");
+  pg_missing_t copy;
+  {
+    pg_missing_t missing;
+    missing.add(oid1, eversion_t(1, 10), eversion_t(), false);
+    missing.add(oid2, eversion_t(1, 20), eversion_t(), false);
+    copy = missing;
+    pg_missing_t other(missing);
+    EXPECT_EQ(&other.get_items().find(oid1)->first,
+	      &other.get_rmissing().at(10).get());
+  }
+  // the oids of rmissing are the keys of the copied items
+  ASSERT_EQ(2u, copy.get_rmissing().size());
+  EXPECT_EQ(&copy.get_items().find(oid1)->first,
+	    &copy.get_rmissing().at(10).get());
+  EXPECT_EQ(&copy.get_items().find(oid2)->first,
+	    &copy.get_rmissing().at(20).get());
+  EXPECT_EQ(eversion_t(1, 10), copy.get_oldest_need());
+
+  // replacing the need version of an item drops its old version
+  copy.add(oid1, eversion_t(1, 30), eversion_t(), false);
+  EXPECT_EQ(0u, copy.get_rmissing().count(10));
+  EXPECT_EQ(oid1, copy.get_rmissing().at(30).get());
+}
+
 TEST(pg_pool_t_test, get_pg_num_divisor) {
   pg_pool_t p;
   p.set_pg_num(16);
@@ -1493,6 +1521,30 @@ TEST(hobject_t, parse) {
   }
 }
 
+TEST(hobject_t, cmp) {
+  // cmp() must order exactly like operator<=>
+  std::vector<hobject_t> objs;
+  for (auto& ns : {"", "a", "b"}) {
+    for (auto& key : {"", "k", "z"}) {
+      for (auto& name : {"", "k", "obj", "obk"}) {
+	for (snapid_t snap : {snapid_t(1), snapid_t(CEPH_NOSNAP)}) {
+	  objs.emplace_back(object_t(name), key, snap, 0x42, 1, ns);
+	}
+      }
+    }
+  }
+  objs.push_back(hobject_t::get_max());
+  for (auto& l : objs) {
+    for (auto& r : objs) {
+      auto expected = l <=> r;
+      int c = cmp(l, r);
+      ASSERT_EQ(expected < 0, c < 0) << l << " vs " << r;
+      ASSERT_EQ(expected == 0, c == 0) << l << " vs " << r;
+      ASSERT_TRUE(c >= -1 && c <= 1);
+    }
+  }
+}
+
 TEST(ghobject_t, cmp) {
   ghobject_t min;
   ghobject_t sep;
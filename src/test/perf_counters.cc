@@ -260,6 +260,43 @@ TEST(PerfCounters, read_avg) {
   t1.join();
 }
 
+TEST(PerfCounters, ManyThreads) {
+  PerfCountersBuilder bld(g_ceph_context, "test_perfcounter_threads",
+	  TEST_PERFCOUNTERS1_ELEMENT_FIRST, TEST_PERFCOUNTERS1_ELEMENT_LAST);
+  bld.add_u64_counter(TEST_PERFCOUNTERS1_ELEMENT_1, "element1");
+  bld.add_time(TEST_PERFCOUNTERS1_ELEMENT_2, "element2");
+  bld.add_time_avg(TEST_PERFCOUNTERS1_ELEMENT_3, "element3");
+  std::unique_ptr<PerfCounters> pc(bld.create_perf_counters());
+
+  constexpr int num_threads = 16;
+  constexpr int num_incs = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&pc] {
+      for (int i = 0; i < num_incs; i++) {
+	pc->inc(TEST_PERFCOUNTERS1_ELEMENT_1);
+	pc->tinc(TEST_PERFCOUNTERS1_ELEMENT_3, utime_t(0, 2));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ((uint64_t)num_threads * num_incs,
+	    pc->get(TEST_PERFCOUNTERS1_ELEMENT_1));
+  auto [count, sum] = pc->get_tavg_ns(TEST_PERFCOUNTERS1_ELEMENT_3);
+  ASSERT_EQ((uint64_t)num_threads * num_incs, count);
+  ASSERT_EQ(2 * count, sum);
+
+  pc->set(TEST_PERFCOUNTERS1_ELEMENT_1, 42);
+  ASSERT_EQ(42u, pc->get(TEST_PERFCOUNTERS1_ELEMENT_1));
+  pc->inc(TEST_PERFCOUNTERS1_ELEMENT_1, 3);
+  pc->dec(TEST_PERFCOUNTERS1_ELEMENT_1, 1);
+  ASSERT_EQ(44u, pc->get(TEST_PERFCOUNTERS1_ELEMENT_1));
+  pc->reset();
+  ASSERT_EQ(0u, pc->get_tavg_ns(TEST_PERFCOUNTERS1_ELEMENT_3).first);
+}
+
 static PerfCounters* setup_test_perfcounter4(std::string name, CephContext *cct)
 {
   PerfCountersBuilder bld(cct, name,
@@ -28,6 +28,9 @@
 // run.  If no test names are provided then all of the performance tests
 // are run.
 //
+// Add "--format json" to get the results as JSON, e.g. to compare them
+// across builds.
+//
 // To add a new test:
 // * Write a function that implements the test.  Use existing test functions
 //   as a guideline, and be sure to generate output in the same form as
@@ -44,13 +47,20 @@
 #include "include/buffer.h"
 #include "include/encoding.h"
 #include "include/ceph_hash.h"
+#include "include/interval_set.h"
 #include "include/spinlock.h"
 #include "common/ceph_argparse.h"
 #include "common/Cycles.h"
 #include "common/Cond.h"
+#include "common/Formatter.h"
 #include "common/ceph_mutex.h"
+#include "common/hobject.h"
+#include "common/perf_counters.h"
 #include "common/Thread.h"
 #include "common/Timer.h"
+#include "crush/CrushWrapper.h"
+#include "osd/OSDMap.h"
+#include "osd/osd_types.h"
 #include "msg/async/Event.h"
 #include "global/global_init.h"
 
@@ -915,6 +925,185 @@ double perf_ceph_clock_now()
   return Cycles::to_seconds(stop - start)/count;
 }
 
+// Measure the cost of appending a 4KB ptr to a bufferlist
+double buffer_append_4k()
+{
+  int count = 100000;
+  bufferptr ptr(buffer::create_page_aligned(4096));
+  ptr.zero();
+  bufferlist b;
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    b.append(ptr);
+    if ((i & 255) == 255) {
+      b.clear();
+    }
+  }
+  uint64_t stop = Cycles::rdtsc();
+  return Cycles::to_seconds(stop - start)/count;
+}
+
+// Measure the cost of rebuilding a bufferlist of 16 4KB ptrs into one
+double buffer_rebuild_16x4k()
+{
+  int count = 10000;
+  bufferptr ptr(buffer::create_page_aligned(4096));
+  ptr.zero();
+  uint64_t total = 0;
+  for (int i = 0; i < count; i++) {
+    bufferlist b;
+    for (int j = 0; j < 16; j++) {
+      b.append(ptr);
+    }
+    uint64_t start = Cycles::rdtsc();
+    b.rebuild();
+    total += Cycles::rdtsc() - start;
+  }
+  return Cycles::to_seconds(total)/count;
+}
+
+// Measure the cost of the crc32c of a bufferlist, without the crc cache
+template<size_t size>
+double buffer_crc32c()
+{
+  int count = 10000;
+  bufferptr ptr(buffer::create_page_aligned(size));
+  ptr.zero();
+  bufferlist b;
+  b.append(ptr);
+  uint32_t crc = 0;
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    b.invalidate_crc();
+    crc += b.crc32c(0);
+  }
+  uint64_t stop = Cycles::rdtsc();
+  discard(&crc);
+  return Cycles::to_seconds(stop - start)/count;
+}
+
+static object_info_t make_object_info()
+{
+  object_info_t oi(hobject_t(object_t("rbd_data.1234567890ab.0000000000000001"),
+			     "", CEPH_NOSNAP, 0x12345678, 1, ""));
+  oi.version = eversion_t(12, 3456);
+  oi.prior_version = eversion_t(12, 3455);
+  oi.size = 4194304;
+  oi.mtime = oi.local_mtime = ceph_clock_now();
+  oi.set_data_digest(0x1234);
+  oi.set_omap_digest(0x5678);
+  oi.truncate_seq = 1;
+  return oi;
+}
+
+// Measure the cost of encoding and decoding an object_info_t
+double object_info_encode_decode()
+{
+  int count = 100000;
+  object_info_t oi = make_object_info();
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    bufferlist b;
+    encode(oi, b, CEPH_FEATURES_SUPPORTED_DEFAULT);
+    auto iter = b.cbegin();
+    decode(oi, iter);
+  }
+  uint64_t stop = Cycles::rdtsc();
+  return Cycles::to_seconds(stop - start)/count;
+}
+
+// Measure the cost of encoding and decoding a pg_log_entry_t
+double pg_log_entry_encode_decode()
+{
+  int count = 100000;
+  object_info_t oi = make_object_info();
+  pg_log_entry_t e(pg_log_entry_t::MODIFY, oi.soid, eversion_t(12, 3457),
+		   oi.version, 0, osd_reqid_t(entity_name_t::CLIENT(4567), 0, 89),
+		   ceph_clock_now(), 0);
+  e.mod_desc.append(4096);
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    bufferlist b;
+    encode(e, b);
+    auto iter = b.cbegin();
+    decode(e, iter);
+  }
+  uint64_t stop = Cycles::rdtsc();
+  return Cycles::to_seconds(stop - start)/count;
+}
+
+// Measure the cost of comparing two hobject_t in the same pool
+double hobject_compare()
+{
+  int count = 1000000;
+  std::vector<hobject_t> objs;
+  for (int i = 0; i < 64; i++) {
+    objs.emplace_back(object_t("rbd_data.1234567890ab." + std::to_string(i)),
+		      "", CEPH_NOSNAP, (i * 2654435761u) & 0xffff0000, 1, "");
+  }
+  int less = 0;
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    less += objs[i & 63] < objs[(i + 1) & 63];
+  }
+  uint64_t stop = Cycles::rdtsc();
+  discard(&less);
+  return Cycles::to_seconds(stop - start)/count;
+}
+
+// Measure the cost of inserting into and erasing from an interval_set
+// holding 1000 extents
+double interval_set_insert_erase()
+{
+  int count = 100000;
+  interval_set<uint64_t> s;
+  for (uint64_t i = 0; i < 1000; i++) {
+    s.insert(i * 8192, 4096);
+  }
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    uint64_t off = (i % 1000) * 8192 + 4096;
+    s.insert(off, 4096);
+    s.erase(off, 4096);
+  }
+  uint64_t stop = Cycles::rdtsc();
+  return Cycles::to_seconds(stop - start)/(count*2);
+}
+
+// Measure the cost of incrementing a PerfCounters counter
+double perf_counters_inc()
+{
+  int count = 1000000;
+  enum { l_first = 9000, l_counter, l_last };
+  PerfCountersBuilder b(g_ceph_context, "perf_local", l_first, l_last);
+  b.add_u64_counter(l_counter, "counter", "a counter");
+  std::unique_ptr<PerfCounters> logger{b.create_perf_counters()};
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    logger->inc(l_counter);
+  }
+  uint64_t stop = Cycles::rdtsc();
+  return Cycles::to_seconds(stop - start)/count;
+}
+
+// Measure the cost of mapping an input to 3 of 100 osds with crush
+double crush_do_rule()
+{
+  int count = 100000;
+  g_ceph_context->_conf.set_val("osd_crush_chooseleaf_type", "0");
+  CrushWrapper crush;
+  OSDMap::build_simple_crush_map(g_ceph_context, crush, 100, nullptr);
+  int rule = crush.get_rule_id("replicated_rule");
+  std::vector<__u32> weights(100, 0x10000);
+  std::vector<int> out;
+  uint64_t start = Cycles::rdtsc();
+  for (int i = 0; i < count; i++) {
+    crush.do_rule(rule, i, out, 3, weights, 0);
+  }
+  uint64_t stop = Cycles::rdtsc();
+  return Cycles::to_seconds(stop - start)/count;
+}
+
 // The following struct and table define each performance test in terms of
 // a string name and a function that implements the test.
 struct TestInfo {
@@ -1005,6 +1194,26 @@ TestInfo tests[] = {
     "Push and pop a std::vector"},
   {"ceph_clock_now", perf_ceph_clock_now,
    "ceph_clock_now function"},
+  {"buffer_append_4k", buffer_append_4k,
+    "append a 4KB ptr to a bufferlist"},
+  {"buffer_rebuild_16x4k", buffer_rebuild_16x4k,
+    "rebuild a bufferlist of 16 4KB ptrs"},
+  {"buffer_crc32c_4k", buffer_crc32c<4096>,
+    "crc32c of a 4KB bufferlist"},
+  {"buffer_crc32c_64k", buffer_crc32c<65536>,
+    "crc32c of a 64KB bufferlist"},
+  {"object_info_encode_decode", object_info_encode_decode,
+    "encode/decode an object_info_t"},
+  {"pg_log_entry_encode_decode", pg_log_entry_encode_decode,
+    "encode/decode a pg_log_entry_t"},
+  {"hobject_compare", hobject_compare,
+    "compare two hobject_t"},
+  {"interval_set_insert_erase", interval_set_insert_erase,
+    "insert or erase an extent of a 1000 extent interval_set"},
+  {"perf_counters_inc", perf_counters_inc,
+    "increment a PerfCounters counter"},
+  {"crush_do_rule", crush_do_rule,
+    "map an input to 3 of 100 osds with crush"},
 };
 
 /**
@@ -1013,9 +1222,21 @@ TestInfo tests[] = {
  * \param info
  *      Describes the test to run.
  */
-void run_test(TestInfo& info)
+void run_test(TestInfo& info, Formatter *f)
 {
   double secs = info.func();
+  if (f) {
+    f->open_object_section("test");
+    f->dump_string("name", info.name);
+    f->dump_string("description", info.description);
+    if (secs == -1) {
+      f->dump_bool("supported", false);
+    } else {
+      f->dump_float("ns_per_op", 1e09*secs);
+    }
+    f->close_section();
+    return;
+  }
   int width = printf("%-24s ", info.name);
   if (secs == -1) {
     width += printf(" architecture nonsupport ");
@@ -1041,27 +1262,49 @@ int main(int argc, char *argv[])
   common_init_finish(g_ceph_context);
   Cycles::init();
 
+  // --format json or json-pretty gives machine readable results that can
+  // be compared across runs
+  std::unique_ptr<Formatter> f;
+  std::vector<const char*> names;
+  for (auto i = args.begin(); i != args.end(); ) {
+    std::string val;
+    if (ceph_argparse_witharg(args, i, &val, "--format", (char*)NULL)) {
+      f.reset(Formatter::create(val, "json-pretty", "json-pretty"));
+    } else {
+      names.push_back(*i);
+      ++i;
+    }
+  }
+
   bind_thread_to_cpu(3);
-  if (argc == 1) {
+  if (f) {
+    f->open_array_section("tests");
+  }
+  if (names.empty()) {
     // No test names specified; run all tests.
     for (size_t i = 0; i < sizeof(tests)/sizeof(TestInfo); ++i) {
-      run_test(tests[i]);
+      run_test(tests[i], f.get());
     }
   } else {
     // Run only the tests that were specified on the command line.
-    for (int i = 1; i < argc; i++) {
+    for (auto name : names) {
       bool found_test = false;
       for (size_t j = 0; j < sizeof(tests)/sizeof(TestInfo); ++j) {
-        if (strcmp(argv[i], tests[j].name) == 0) {
+        if (strcmp(name, tests[j].name) == 0) {
           found_test = true;
-          run_test(tests[j]);
+          run_test(tests[j], f.get());
           break;
         }
       }
-      if (!found_test) {
-        int width = printf("%-24s ??", argv[i]);
+      if (!found_test && !f) {
+        int width = printf("%-24s ??", name);
         printf("%*s No such test\n", 32-width, "");
       }
     }
   }
+  if (f) {
+    f->close_section();
+    f->flush(std::cout);
+    std::cout << std::endl;
+  }
 }
@@ -0,0 +1,113 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#include <gtest/gtest.h>
+#include "common/dout.h"
+#include "global/global_context.h"
+#include "rgw_cache.h"
+
+namespace {
+
+// ObjectCache spreads names over 16 shards by hash; pick names that all
+// land in the same shard so that they compete for its lru
+std::vector<std::string> same_shard_names(size_t count)
+{
+  std::vector<std::string> names;
+  const auto shard = std::hash<std::string>{}("obj0") % 16;
+  for (int i = 0; names.size() < count; ++i) {
+    auto name = "obj" + std::to_string(i);
+    if (std::hash<std::string>{}(name) % 16 == shard) {
+      names.push_back(std::move(name));
+    }
+  }
+  return names;
+}
+
+struct ObjectCacheTest : public ::testing::Test {
+  NoDoutPrefix dpp{g_ceph_context, 1};
+  ObjectCache cache;
+
+  void SetUp() override {
+    // two entries per shard
+    g_ceph_context->_conf.set_val_or_die("rgw_cache_lru_size", "32");
+    g_ceph_context->_conf.set_val_or_die("rgw_cache_expiry_interval", "0");
+    cache.set_ctx(g_ceph_context);
+    cache.set_enabled(true);
+  }
+
+  void put(const std::string& name) {
+    ObjectCacheInfo info;
+    info.status = 0;
+    info.flags = CACHE_FLAG_DATA;
+    info.data.append(name);
+    cache.put(&dpp, name, info, nullptr);
+  }
+
+  bool cached(const std::string& name) {
+    ObjectCacheInfo info;
+    return cache.get(&dpp, name, info, 0, nullptr) == 0;
+  }
+};
+
+} // anonymous namespace
+
+TEST_F(ObjectCacheTest, shard_evicts_oldest)
+{
+  auto names = same_shard_names(8);
+  for (const auto& name : names) {
+    put(name);
+  }
+  // a shard keeps at most one entry above its share of rgw_cache_lru_size
+  EXPECT_TRUE(cached(names[7]));
+  EXPECT_TRUE(cached(names[6]));
+  EXPECT_TRUE(cached(names[5]));
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_FALSE(cached(names[i])) << names[i];
+  }
+}
+
+TEST_F(ObjectCacheTest, shards_are_independent)
+{
+  // filling one shard must not evict entries of another
+  auto names = same_shard_names(8);
+  std::string other;
+  for (int i = 0; other.empty(); ++i) {
+    auto name = "other" + std::to_string(i);
+    if (std::hash<std::string>{}(name) % 16 !=
+	std::hash<std::string>{}(names[0]) % 16) {
+      other = name;
+    }
+  }
+  put(other);
+  for (const auto& name : names) {
+    put(name);
+  }
+  EXPECT_TRUE(cached(other));
+}
+
+TEST_F(ObjectCacheTest, referenced_entry_gets_second_chance)
+{
+  auto names = same_shard_names(4);
+  put(names[0]);
+  put(names[1]);
+  put(names[2]);
+  // looking names[0] up sets its referenced bit, so the next eviction
+  // skips it and takes names[1] instead
+  ASSERT_TRUE(cached(names[0]));
+  put(names[3]);
+  EXPECT_FALSE(cached(names[1]));
+  EXPECT_TRUE(cached(names[3]));
+  EXPECT_TRUE(cached(names[2]));
+  EXPECT_TRUE(cached(names[0]));
+}
+
+TEST_F(ObjectCacheTest, unreferenced_entry_is_evicted)
+{
+  auto names = same_shard_names(4);
+  put(names[0]);
+  put(names[1]);
+  put(names[2]);
+  put(names[3]);
+  EXPECT_FALSE(cached(names[0]));
+  EXPECT_TRUE(cached(names[1]));
+}
@@ -93,7 +93,7 @@ TEST(Decompress, FixupRangePartial)
   blocks.emplace_back(compression_block{24, 18, 6});
 
   const bool partial = true;
-  RGWGetObj_Decompress decompress(g_ceph_context, &cs_info, partial, &cb);
+  RGWGetObj_Decompress decompress(g_ceph_context, &cs_info, partial, &cb, null_yield);
 
   // test translation from logical ranges to compressed ranges
   ASSERT_EQ(range_t(0, 5), fixup_range(&decompress, 0, 1));
@@ -122,7 +122,7 @@ TEST(Compress, LimitedChunkSize)
     bl.append(bp);
 
     ut_put_sink c_sink;
-    RGWPutObj_Compress compressor(g_ceph_context, plugin, &c_sink);
+    RGWPutObj_Compress compressor(g_ceph_context, plugin, &c_sink, null_yield);
     compressor.process(std::move(bl), 0);
     compressor.process({}, s); // flush
 
@@ -133,7 +133,7 @@ TEST(Compress, LimitedChunkSize)
     cs_info.blocks = std::move(compressor.get_compression_blocks());
 
     ut_get_sink_size d_sink;
-    RGWGetObj_Decompress decompress(g_ceph_context, &cs_info, false, &d_sink);
+    RGWGetObj_Decompress decompress(g_ceph_context, &cs_info, false, &d_sink, null_yield);
 
     off_t f_begin = 0;
     off_t f_end = s - 1;
@@ -154,7 +154,7 @@ TEST(Compress, BillionZeros)
   ut_put_sink c_sink;
   plugin = Compressor::create(g_ceph_context, Compressor::COMP_ALG_ZLIB);
   ASSERT_NE(plugin.get(), nullptr);
-  RGWPutObj_Compress compressor(g_ceph_context, plugin, &c_sink);
+  RGWPutObj_Compress compressor(g_ceph_context, plugin, &c_sink, null_yield);
 
   constexpr size_t size = 1000000;
   bufferptr bp(size);
@@ -172,7 +172,7 @@ TEST(Compress, BillionZeros)
   cs_info.blocks = std::move(compressor.get_compression_blocks());
 
   ut_get_sink d_sink;
-  RGWGetObj_Decompress decompress(g_ceph_context, &cs_info, false, &d_sink);
+  RGWGetObj_Decompress decompress(g_ceph_context, &cs_info, false, &d_sink, null_yield);
 
   off_t f_begin = 0;
   off_t f_end = size*1000 - 1;
@@ -184,3 +184,65 @@ TEST(Compress, BillionZeros)
 
   ASSERT_EQ(d_sink.get_sink().length() , size*1000);
 }
+
+TEST(Compress, FilterPoolRoundTrip)
+{
+  // compress and decompress on the filter pool rather than inline
+  g_ceph_context->_conf.set_val_or_die("rgw_filter_threads", "4");
+  g_ceph_context->_conf.set_val_or_die("rgw_filter_max_pending_chunks", "3");
+  ASSERT_NE(nullptr, rgw::get_filter_pool(g_ceph_context));
+
+  CompressorRef plugin;
+  plugin = Compressor::create(g_ceph_context, Compressor::COMP_ALG_ZLIB);
+  ASSERT_NE(plugin.get(), nullptr);
+
+  constexpr size_t chunk = 256 * 1024;
+  constexpr int chunks = 20;
+  bufferlist orig;
+  for (int i = 0; i < chunks; i++) {
+    std::string s(chunk, 'a' + i);
+    for (size_t j = 0; j < chunk; j += 97) {
+      s[j] = j * i;
+    }
+    orig.append(s);
+  }
+
+  ut_put_sink c_sink;
+  RGWPutObj_Compress compressor(g_ceph_context, plugin, &c_sink, null_yield);
+  for (int i = 0; i < chunks; i++) {
+    bufferlist bl;
+    bl.substr_of(orig, i * chunk, chunk);
+    ASSERT_EQ(0, compressor.process(std::move(bl), i * chunk));
+  }
+  ASSERT_EQ(0, compressor.process({}, chunks * chunk)); // flush
+  ASSERT_TRUE(compressor.is_compressed());
+
+  RGWCompressionInfo cs_info;
+  cs_info.compression_type = plugin->get_type_name();
+  cs_info.orig_size = orig.length();
+  cs_info.compressor_message = compressor.get_compressor_message();
+  cs_info.blocks = std::move(compressor.get_compression_blocks());
+  // one block per chunk, in logical order
+  ASSERT_EQ((size_t)chunks, cs_info.blocks.size());
+  for (int i = 0; i < chunks; i++) {
+    ASSERT_EQ(i * chunk, cs_info.blocks[i].old_ofs);
+  }
+
+  ut_get_sink d_sink;
+  RGWGetObj_Decompress decompress(g_ceph_context, &cs_info, false, &d_sink, null_yield);
+  off_t f_begin = 0;
+  off_t f_end = orig.length() - 1;
+  decompress.fixup_range(f_begin, f_end);
+  // hand the compressed data over in pieces that do not match the blocks
+  auto& compressed = c_sink.get_sink();
+  for (unsigned ofs = 0; ofs < compressed.length(); ofs += 100000) {
+    bufferlist bl;
+    bl.substr_of(compressed, ofs,
+                 std::min<unsigned>(100000, compressed.length() - ofs));
+    ASSERT_EQ(0, decompress.handle_data(bl, 0, bl.length()));
+  }
+  ASSERT_EQ(0, decompress.flush());
+
+  ASSERT_TRUE(orig.contents_equal(d_sink.get_sink()));
+  g_ceph_context->_conf.set_val_or_die("rgw_filter_threads", "0");
+}
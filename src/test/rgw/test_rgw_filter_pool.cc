@@ -0,0 +1,124 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "rgw_filter_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <boost/asio/io_context.hpp>
+#include <spawn/spawn.hpp>
+#include <gtest/gtest.h>
+
+namespace rgw {
+
+TEST(OrderedFilterJobs, ResultsInOrder)
+{
+  boost::asio::thread_pool pool(4);
+  OrderedFilterJobs<int> jobs(pool, 4, null_yield);
+
+  constexpr int total = 32;
+  int next = 0;
+  for (int i = 0; i < total; i++) {
+    if (jobs.full()) {
+      EXPECT_EQ(next++, jobs.pop());
+    }
+    // later jobs finish first
+    jobs.submit([i] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(4 - i % 4));
+        return i;
+      });
+  }
+  while (!jobs.empty()) {
+    EXPECT_EQ(next++, jobs.pop());
+  }
+  EXPECT_EQ(total, next);
+}
+
+TEST(OrderedFilterJobs, MaxPending)
+{
+  boost::asio::thread_pool pool(2);
+  OrderedFilterJobs<int> jobs(pool, 2, null_yield);
+  EXPECT_TRUE(jobs.empty());
+  EXPECT_FALSE(jobs.full());
+  jobs.submit([] { return 1; });
+  EXPECT_FALSE(jobs.full());
+  jobs.submit([] { return 2; });
+  EXPECT_TRUE(jobs.full());
+  EXPECT_EQ(1, jobs.pop());
+  EXPECT_FALSE(jobs.full());
+}
+
+TEST(OrderedFilterJobs, DestructorWaits)
+{
+  boost::asio::thread_pool pool(1);
+  std::atomic<bool> done = false;
+  {
+    OrderedFilterJobs<int> jobs(pool, 1, null_yield);
+    jobs.submit([&done] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        done = true;
+        return 0;
+      });
+  }
+  EXPECT_TRUE(done);
+}
+
+TEST(OrderedFilterJobs, PopYields)
+{
+  // a coroutine waiting for a result lets others run on its thread
+  boost::asio::thread_pool pool(1);
+  boost::asio::io_context context;
+  bool other_ran = false;
+  spawn::spawn(context, [&] (spawn::yield_context yield) {
+      OrderedFilterJobs<int> jobs(pool, 1, optional_yield{context, yield});
+      jobs.submit([] {
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+          return 1;
+        });
+      EXPECT_EQ(1, jobs.pop());
+      EXPECT_TRUE(other_ran);
+    });
+  spawn::spawn(context, [&] (spawn::yield_context yield) {
+      other_ran = true;
+    });
+  context.run();
+  EXPECT_TRUE(other_ran);
+}
+
+TEST(OrderedFilterJobs, DestructorYields)
+{
+  boost::asio::thread_pool pool(1);
+  boost::asio::io_context context;
+  std::atomic<bool> done = false;
+  bool other_ran = false;
+  spawn::spawn(context, [&] (spawn::yield_context yield) {
+      {
+        OrderedFilterJobs<int> jobs(pool, 1, optional_yield{context, yield});
+        jobs.submit([&done] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            done = true;
+            return 0;
+          });
+      }
+      EXPECT_TRUE(done);
+      EXPECT_TRUE(other_ran);
+    });
+  spawn::spawn(context, [&] (spawn::yield_context yield) {
+      other_ran = true;
+    });
+  context.run();
+}
+
+TEST(OrderedFilterJobs, Exception)
+{
+  boost::asio::thread_pool pool(1);
+  OrderedFilterJobs<int> jobs(pool, 2, null_yield);
+  jobs.submit([]() -> int { throw std::runtime_error("boom"); });
+  jobs.submit([] { return 2; });
+  EXPECT_THROW(jobs.pop(), std::runtime_error);
+  EXPECT_EQ(2, jobs.pop());
+}
+
+} // namespace rgw
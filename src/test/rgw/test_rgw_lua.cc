@@ -300,6 +300,24 @@ TEST(TestRGWLua, SetResponse)
   ASSERT_EQ(rc, 0);
 }
 
+TEST(TestRGWLua, SetResponseTwice)
+{
+  // the second run loads the script compiled by the first one
+  const std::string script = R"(
+    assert(Request.Response.Message == "this is a bad request")
+    Request.Response.Message = "this is a good request"
+  )";
+
+  for (auto i = 0; i < 2; ++i) {
+    DEFINE_REQ_STATE;
+    s.err.message = "this is a bad request";
+
+    const auto rc = lua::request::execute(nullptr, nullptr, nullptr, &s, nullptr, script);
+    ASSERT_EQ(rc, 0);
+    ASSERT_EQ(s.err.message, "this is a good request");
+  }
+}
+
 TEST(TestRGWLua, RGWIdNotWriteable)
 {
   const std::string script = R"(
@@ -400,6 +400,51 @@ TEST(denc, bar)
   test_denc_featured(a);
 }
 
+struct trivial_t {
+  uint32_t a = 1;
+  uint16_t b = 2;
+  uint8_t c = 3, d = 4;
+  uint64_t e = 5;
+  DENC(trivial_t, v, p) {
+    denc(v.a, p);
+    denc(v.b, p);
+    denc(v.c, p);
+    denc(v.d, p);
+    denc(v.e, p);
+  }
+  friend bool operator==(const trivial_t&, const trivial_t&) = default;
+};
+WRITE_CLASS_DENC_TRIVIAL(trivial_t)
+
+struct trivial_fields_t {
+  trivial_t t;
+  DENC(trivial_fields_t, v, p) {
+    denc(v.t.a, p);
+    denc(v.t.b, p);
+    denc(v.t.c, p);
+    denc(v.t.d, p);
+    denc(v.t.e, p);
+  }
+};
+WRITE_CLASS_DENC(trivial_fields_t)
+
+TEST(denc, trivial)
+{
+  static_assert(denc_traits<trivial_t>::bounded);
+  trivial_t a{0x01020304, 0x0506, 7, 8, 0x090a0b0c0d0e0f10};
+  test_denc(a);
+  std::vector<trivial_t> v(3, a);
+  v[1].e = 42;
+  test_denc(v);
+
+  // the single copy encodes what the field by field denc() does
+  bufferlist trivial, fields;
+  encode(a, trivial);
+  encode(trivial_fields_t{a}, fields);
+  ASSERT_EQ(sizeof(trivial_t), trivial.length());
+  ASSERT_TRUE(trivial.contents_equal(fields));
+}
+
 
 
 TEST(denc, pair)
@@ -22,6 +22,7 @@
 #include "include/types.h"
 #include "common/Formatter.h"
 #include "common/ceph_argparse.h"
+#include "common/ceph_time.h"
 #include "common/errno.h"
 #include "denc_plugin.h"
 #include "denc_registry.h"
@@ -57,11 +58,23 @@ void usage(ostream &out)
   out << "  copy                copy object (via operator=)\n";
   out << "  copy_ctor           copy object (via copy ctor)\n";
   out << "\n";
+  out << "  bench_encode <n>    time <n> encodes of in-memory object\n";
+  out << "  bench_decode <n>    time <n> decodes of encoded data\n";
+  out << "\n";
   out << "  count_tests         print number of generated test objects (to stdout)\n";
   out << "  select_test <n>     select generated test object as in-memory object\n";
   out << "  is_deterministic    exit w/ success if type encodes deterministically\n";
 }
 
+static void print_bench(const char* what, unsigned n, size_t len,
+			ceph::timespan elapsed)
+{
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  cout << what << " " << n << " x " << len << " bytes: "
+       << std::fixed << std::setprecision(1) << ns / n << " ns/op, "
+       << (ns > 0 ? len * n * 1000.0 / ns : 0.0) << " MB/s" << std::endl;
+}
+
 vector<DencoderPlugin> load_plugins()
 {
   fs::path mod_dir{CEPH_DENC_MOD_DIR};
@@ -169,6 +182,31 @@ int main(int argc, const char **argv)
 	return 1;
       }
       err = den->decode(encbl, skip);
+    } else if (*i == string("bench_encode") ||
+	       *i == string("bench_decode")) {
+      const bool encode = *i == string("bench_encode");
+      if (!den) {
+	cerr << "must first select type with 'type <name>'" << std::endl;
+	return 1;
+      }
+      ++i;
+      if (i == args.end()) {
+	cerr << "expecting iteration count" << std::endl;
+	return 1;
+      }
+      unsigned n = std::max(atoi(*i), 1);
+      auto start = ceph::mono_clock::now();
+      if (encode) {
+	for (unsigned j = 0; j < n; ++j) {
+	  den->encode(encbl, features | CEPH_FEATURE_RESERVED);
+	}
+      } else {
+	for (unsigned j = 0; j < n && err.empty(); ++j) {
+	  err = den->decode(encbl, skip);
+	}
+      }
+      print_bench(encode ? "encode" : "decode", n, encbl.length(),
+		  ceph::mono_clock::now() - start);
     } else if (*i == string("copy_ctor")) {
       if (!den) {
 	cerr << "must first select type with 'type <name>'" << std::endl;
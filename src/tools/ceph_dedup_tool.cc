@@ -138,7 +138,7 @@ po::options_description make_usage() {
   po::options_description desc("Usage");
   desc.add_options()
     ("help,h", ": produce help message")
-    ("op estimate --pool <POOL> --chunk-size <CHUNK_SIZE> --chunk-algorithm <ALGO> --fingerprint-algorithm <FP_ALGO>", 
+    ("op estimate --pool <POOL> --chunk-size <CHUNK_SIZE> --chunk-algorithm <ALGO> --fingerprint-algorithm <FP_ALGO> [--sampling-ratio <PERCENT>]", 
      ": estimate how many chunks are redundant")
     ("op chunk-scrub --chunk-pool <POOL>",
      ": perform chunk scrub")
@@ -253,19 +253,21 @@ class EstimateDedupRatio : public CrawlerThread
   string fp_algo;
   uint64_t chunk_size;
   uint64_t max_seconds;
+  int sampling_ratio;  ///< percentage of objects to examine, -1 for all
 
 public:
   EstimateDedupRatio(
     IoCtx& io_ctx, int n, int m, ObjectCursor begin, ObjectCursor end,
     string chunk_algo, string fp_algo, uint64_t chunk_size, int32_t report_period,
     uint64_t num_objects, uint64_t max_read_size,
-    uint64_t max_seconds):
+    uint64_t max_seconds, int sampling_ratio):
     CrawlerThread(io_ctx, n, m, begin, end, report_period, num_objects,
 		  max_read_size),
     chunk_algo(chunk_algo),
     fp_algo(fp_algo),
     chunk_size(chunk_size),
-    max_seconds(max_seconds) {
+    max_seconds(max_seconds),
+    sampling_ratio(sampling_ratio) {
   }
 
   void* entry() {
@@ -399,6 +401,13 @@ void EstimateDedupRatio::estimate_dedup_ratio()
 	next_report += report_period;
       }
 
+      // pick the sample by name, so that repeated runs look at the same
+      // objects and their estimates can be compared
+      if (sampling_ratio >= 0 && sampling_ratio < 100 &&
+	  std::hash<string>{}(oid) % 100 >= (size_t)sampling_ratio) {
+	continue;
+      }
+
       // read entire object
       bufferlist bl;
       uint64_t offset = 0;
@@ -1191,6 +1200,7 @@ int estimate_dedup_ratio(const po::variables_map &opts)
   uint32_t report_period = get_opts_report_period(opts);
   uint64_t max_read_size = default_op_size;
   uint64_t max_seconds = 0;
+  int sampling_ratio = -1;
   int ret;
   std::map<std::string, std::string>::const_iterator i;
   bool debug = false;
@@ -1237,6 +1247,13 @@ int estimate_dedup_ratio(const po::variables_map &opts)
   } else {
     cout << default_op_size << " is set as max-read-size by default" << std::endl;
   }
+  if (opts.count("sampling-ratio")) {
+    sampling_ratio = opts["sampling-ratio"].as<int>();
+    if (sampling_ratio < 0 || sampling_ratio > 100) {
+      cerr << "sampling-ratio must be between 0 and 100" << std::endl;
+      exit(1);
+    }
+  }
   if (opts.count("debug")) {
     debug = true;
   }
@@ -1300,7 +1317,7 @@ int estimate_dedup_ratio(const po::variables_map &opts)
       new EstimateDedupRatio(io_ctx, i, max_thread, begin, end,
 			     chunk_algo, fp_algo, chunk_size,
 			     report_period, s.num_objects, max_read_size,
-			     max_seconds));
+			     max_seconds, sampling_ratio));
     ptr->create("estimate_thread");
     ptr->set_debug(debug);
     estimate_threads.push_back(std::move(ptr));
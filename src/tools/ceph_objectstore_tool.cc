@@ -1341,14 +1341,18 @@ int get_attrs(
       auto p = mi->second.cbegin();
       snapset.decode(p);
       cout << "snapset " << snapset << std::endl;
+      if (!snapset.clone_snaps.empty()) {
+	// the clones may still be queued
+	ch->flush();
+      }
       for (auto& p : snapset.clone_snaps) {
 	ghobject_t clone = hoid;
 	clone.hobj.snap = p.first;
 	set<snapid_t> snaps(p.second.begin(), p.second.end());
 	if (!store->exists(ch, clone)) {
 	  // no clone, skip.  this is probably a cache pool.  this works
-	  // because we use a separate transaction per object and clones
-	  // come before head in the archive.
+	  // because we use a separate transaction per object, clones
+	  // come before head in the archive, and we flushed above.
 	  if (debug)
 	    cerr << "\tskipping missing " << clone << " (snaps "
 		 << snaps << ")" << std::endl;
@@ -1501,6 +1505,8 @@ int ObjectStoreTool::dump_object(Formatter *formatter,
   return 0;
 }
 
+static constexpr uint64_t max_unflushed_import_bytes = 64 << 20;
+
 int ObjectStoreTool::get_object(ObjectStore *store,
 				OSDriver& driver,
 				SnapMapper& mapper,
@@ -1595,10 +1601,15 @@ int ObjectStoreTool::get_object(ObjectStore *store,
     }
   }
   if (!dry_run) {
-    wait_until_done(t, [&] {
-      store->queue_transaction(ch, std::move(*t));
+    // transactions on a collection are applied in order, and do_import()
+    // waits for its final one, so there is no need to wait for every
+    // object; only bound how much is queued at a time
+    unflushed_bytes += t->get_num_bytes();
+    store->queue_transaction(ch, std::move(*t));
+    if (unflushed_bytes >= max_unflushed_import_bytes) {
       ch->flush();
-    });
+      unflushed_bytes = 0;
+    }
   }
   return 0;
 }
@@ -39,6 +39,10 @@ class ObjectStoreTool : public RadosDump
     int export_file(
         ObjectStore *store, coll_t cid, ghobject_t &obj);
     int export_files(ObjectStore *store, coll_t coll);
+
+  private:
+    /// bytes of imported objects queued since the collection was last flushed
+    uint64_t unflushed_bytes = 0;
 };
 
 #endif // CEPH_OBJECSTORE_TOOL_H_
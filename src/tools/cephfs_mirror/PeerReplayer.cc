@@ -729,16 +729,185 @@ close_local_fd:
   return r == 0 ? 0 : r;
 }
 
+static int read_full(MountRef mnt, int fd, char *buf, int64_t len, int64_t off) {
+  int64_t done = 0;
+  while (done < len) {
+    int r = ceph_read(mnt, fd, buf + done, len - done, off + done);
+    if (r < 0) {
+      return r;
+    }
+    if (r == 0) {
+      break;
+    }
+    done += r;
+  }
+  return done;
+}
+
+// the remote file matches the file in the previous snapshot: compare the
+// current file against it block by block and only rewrite the blocks that
+// differ, instead of retransferring the whole file.
+int PeerReplayer::copy_changed_to_remote(const std::string &dir_root, const std::string &epath,
+                                         const struct ceph_statx &stx, const FHandles &fh) {
+  dout(10) << ": dir_root=" << dir_root << ", epath=" << epath << dendl;
+  int l_fd;
+  int p_fd;
+  int r_fd;
+  char *cbuf;
+  char *pbuf;
+  int64_t off = 0;
+  uint64_t written = 0;
+
+  // the remote file still has to be what was synchronized from the
+  // previous snapshot (which also set its mtime), or else it is copied
+  // as a whole
+  struct ceph_statx pstx;
+  struct ceph_statx rstx;
+  int r = ceph_statxat(fh.p_mnt, fh.p_fd, epath.c_str(), &pstx,
+                       CEPH_STATX_MODE | CEPH_STATX_SIZE | CEPH_STATX_MTIME,
+                       AT_STATX_DONT_SYNC | AT_SYMLINK_NOFOLLOW);
+  if (r == 0) {
+    r = ceph_statxat(m_remote_mount, fh.r_fd_dir_root, epath.c_str(), &rstx,
+                     CEPH_STATX_MODE | CEPH_STATX_SIZE | CEPH_STATX_MTIME,
+                     AT_STATX_DONT_SYNC | AT_SYMLINK_NOFOLLOW);
+  }
+  if (r < 0 || !S_ISREG(pstx.stx_mode) || !S_ISREG(rstx.stx_mode) ||
+      rstx.stx_size != pstx.stx_size || rstx.stx_mtime != pstx.stx_mtime) {
+    dout(5) << ": remote file path=" << epath << " does not match the previous"
+            << " snapshot (r=" << r << "), copying all of it" << dendl;
+    return copy_to_remote(dir_root, epath, stx, fh);
+  }
+
+  r = ceph_openat(m_local_mount, fh.c_fd, epath.c_str(), O_RDONLY | O_NOFOLLOW, 0);
+  if (r < 0) {
+    derr << ": failed to open local file path=" << epath << ": "
+         << cpp_strerror(r) << dendl;
+    return r;
+  }
+
+  l_fd = r;
+  r = ceph_openat(fh.p_mnt, fh.p_fd, epath.c_str(), O_RDONLY | O_NOFOLLOW, 0);
+  if (r < 0) {
+    derr << ": failed to open prev file path=" << epath << ": "
+         << cpp_strerror(r) << dendl;
+    goto close_local_fd;
+  }
+
+  p_fd = r;
+  r = ceph_openat(m_remote_mount, fh.r_fd_dir_root, epath.c_str(),
+                  O_CREAT | O_WRONLY | O_NOFOLLOW, stx.stx_mode);
+  if (r < 0) {
+    derr << ": failed to open remote file path=" << epath << ": "
+         << cpp_strerror(r) << dendl;
+    goto close_prev_fd;
+  }
+
+  r_fd = r;
+  cbuf = (char *)malloc(2 * IOVEC_SIZE);
+  if (!cbuf) {
+    r = -ENOMEM;
+    derr << ": failed to allocate memory" << dendl;
+    goto close_remote_fd;
+  }
+  pbuf = cbuf + IOVEC_SIZE;
+
+  while (true) {
+    if (should_backoff(dir_root, &r)) {
+      dout(0) << ": backing off r=" << r << dendl;
+      break;
+    }
+
+    r = read_full(m_local_mount, l_fd, cbuf, IOVEC_SIZE, off);
+    if (r < 0) {
+      derr << ": failed to read local file path=" << epath << ": "
+           << cpp_strerror(r) << dendl;
+      break;
+    }
+    if (r == 0) {
+      break;
+    }
+
+    int len = r;
+    r = read_full(fh.p_mnt, p_fd, pbuf, len, off);
+    if (r < 0) {
+      derr << ": failed to read prev file path=" << epath << ": "
+           << cpp_strerror(r) << dendl;
+      break;
+    }
+    if (r != len || memcmp(cbuf, pbuf, len) != 0) {
+      r = ceph_write(m_remote_mount, r_fd, cbuf, len, off);
+      if (r < 0) {
+        derr << ": failed to write remote file path=" << epath << ": "
+             << cpp_strerror(r) << dendl;
+        break;
+      }
+      written += len;
+    }
+    off += len;
+    r = 0;
+  }
+
+  if (r == 0) {
+    r = ceph_ftruncate(m_remote_mount, r_fd, off);
+    if (r < 0) {
+      derr << ": failed to truncate remote file path=" << epath << ": "
+           << cpp_strerror(r) << dendl;
+    }
+  }
+  if (r == 0) {
+    r = ceph_fsync(m_remote_mount, r_fd, 0);
+    if (r < 0) {
+      derr << ": failed to sync data for file path=" << epath << ": "
+           << cpp_strerror(r) << dendl;
+    }
+  }
+  dout(10) << ": epath=" << epath << ", rewrote " << written << " of " << off
+           << " bytes" << dendl;
+
+  free(cbuf);
+
+close_remote_fd:
+  if (ceph_close(m_remote_mount, r_fd) < 0) {
+    derr << ": failed to close remote fd path=" << epath << ": " << cpp_strerror(r)
+         << dendl;
+    return -EINVAL;
+  }
+
+close_prev_fd:
+  if (ceph_close(fh.p_mnt, p_fd) < 0) {
+    derr << ": failed to close prev fd path=" << epath << ": " << cpp_strerror(r)
+         << dendl;
+    return -EINVAL;
+  }
+
+close_local_fd:
+  if (ceph_close(m_local_mount, l_fd) < 0) {
+    derr << ": failed to close local fd path=" << epath << ": " << cpp_strerror(r)
+         << dendl;
+    return -EINVAL;
+  }
+
+  return r == 0 ? 0 : r;
+}
+
 int PeerReplayer::remote_file_op(const std::string &dir_root, const std::string &epath,
                                  const struct ceph_statx &stx, const FHandles &fh,
-                                 bool need_data_sync, bool need_attr_sync) {
+                                 bool need_data_sync, bool need_attr_sync,
+                                 bool can_copy_changed) {
   dout(10) << ": dir_root=" << dir_root << ", epath=" << epath << ", need_data_sync=" << need_data_sync
-           << ", need_attr_sync=" << need_attr_sync << dendl;
+           << ", need_attr_sync=" << need_attr_sync << ", can_copy_changed="
+           << can_copy_changed << dendl;
 
   int r;
   if (need_data_sync) {
     if (S_ISREG(stx.stx_mode)) {
-      r = copy_to_remote(dir_root, epath, stx, fh);
+      auto min_size = g_ceph_context->_conf.get_val<Option::size_t>(
+        "cephfs_mirror_delta_sync_min_size");
+      if (can_copy_changed && min_size > 0 && stx.stx_size >= min_size) {
+        r = copy_changed_to_remote(dir_root, epath, stx, fh);
+      } else {
+        r = copy_to_remote(dir_root, epath, stx, fh);
+      }
       if (r < 0) {
         derr << ": failed to copy path=" << epath << ": " << cpp_strerror(r) << dendl;
         return r;
@@ -924,11 +1093,13 @@ int PeerReplayer::cleanup_remote_dir(const std::string &dir_root,
 }
 
 int PeerReplayer::should_sync_entry(const std::string &epath, const struct ceph_statx &cstx,
-                                    const FHandles &fh, bool *need_data_sync, bool *need_attr_sync) {
+                                    const FHandles &fh, bool *need_data_sync, bool *need_attr_sync,
+                                    bool *can_copy_changed) {
   dout(10) << ": epath=" << epath << dendl;
 
   *need_data_sync = false;
   *need_attr_sync = false;
+  *can_copy_changed = false;
   struct ceph_statx pstx;
   int r = ceph_statxat(fh.p_mnt, fh.p_fd, epath.c_str(), &pstx,
                        CEPH_STATX_MODE | CEPH_STATX_UID | CEPH_STATX_GID |
@@ -962,6 +1133,9 @@ int PeerReplayer::should_sync_entry(const std::string &epath, const struct ceph_
   } else {
     *need_data_sync = (cstx.stx_size != pstx.stx_size) || (cstx.stx_mtime != pstx.stx_mtime);
     *need_attr_sync = (cstx.stx_ctime != pstx.stx_ctime);
+    // only a previous snapshot (rather than the remote dir_root) is known
+    // to hold the data the remote file was synchronized from.
+    *can_copy_changed = S_ISREG(cstx.stx_mode) && fh.remote_is_prev;
   }
 
   return 0;
@@ -1211,7 +1385,7 @@ void PeerReplayer::post_sync_close_handles(const FHandles &fh) {
 }
 
 int PeerReplayer::do_synchronize(const std::string &dir_root, const Snapshot &current,
-                                 boost::optional<Snapshot> prev) {
+                                 boost::optional<Snapshot> prev, bool remote_is_prev) {
   dout(20) << ": dir_root=" << dir_root << ", current=" << current << dendl;
   if (prev) {
     dout(20) << ": incremental sync check from prev=" << prev << dendl;
@@ -1227,6 +1401,7 @@ int PeerReplayer::do_synchronize(const std::string &dir_root, const Snapshot &cu
   BOOST_SCOPE_EXIT_ALL( (this)(&fh) ) {
     post_sync_close_handles(fh);
   };
+  fh.remote_is_prev = remote_is_prev && fh.p_mnt == m_local_mount;
 
   // record that we are going to "dirty" the data under this
   // directory root
@@ -1336,8 +1511,9 @@ int PeerReplayer::do_synchronize(const std::string &dir_root, const Snapshot &cu
     } else {
       bool need_data_sync = true;
       bool need_attr_sync = true;
+      bool can_copy_changed = false;
       r = should_sync_entry(entry.epath, entry.stx, fh,
-                            &need_data_sync, &need_attr_sync);
+                            &need_data_sync, &need_attr_sync, &can_copy_changed);
       if (r < 0) {
         break;
       }
@@ -1346,7 +1522,7 @@ int PeerReplayer::do_synchronize(const std::string &dir_root, const Snapshot &cu
               << ", attr_sync=" << need_attr_sync << dendl;
       if (need_data_sync || need_attr_sync) {
         r = remote_file_op(dir_root, entry.epath, entry.stx, fh, need_data_sync,
-                           need_attr_sync);
+                           need_attr_sync, can_copy_changed);
         if (r < 0) {
           break;
         }
@@ -1389,7 +1565,7 @@ int PeerReplayer::synchronize(const std::string &dir_root, const Snapshot &curre
   if (r < 0) {
     dout(5) << ": missing \"ceph.mirror.dirty_snap_id\" xattr on remote -- using"
             << " incremental sync with remote scan" << dendl;
-    r = do_synchronize(dir_root, current, boost::none);
+    r = do_synchronize(dir_root, current, boost::none, false);
   } else {
     size_t xlen = r;
     char *val = (char *)alloca(xlen+1);
@@ -1407,10 +1583,10 @@ int PeerReplayer::synchronize(const std::string &dir_root, const Snapshot &curre
              << "," << (prev ? stringify((*prev).second) : "~") << ")" << dendl;
     if (prev && (dirty_snap_id == (*prev).second || dirty_snap_id == current.second)) {
       dout(5) << ": match -- using incremental sync with local scan" << dendl;
-      r = do_synchronize(dir_root, current, prev);
+      r = do_synchronize(dir_root, current, prev, dirty_snap_id == (*prev).second);
     } else {
       dout(5) << ": mismatch -- using incremental sync with remote scan" << dendl;
-      r = do_synchronize(dir_root, current, boost::none);
+      r = do_synchronize(dir_root, current, boost::none, false);
     }
   }
 
@@ -70,6 +70,11 @@ private:
     // open file descriptor on dir_root on remote filesystem.
     // Always use this fd with @m_remote_mount.
     int r_fd_dir_root;
+
+    // set if the remote files were last synchronized from the "previous"
+    // snapshot. not so when retrying an interrupted sync of the current
+    // snapshot, which may have left some of them half written.
+    bool remote_is_prev = false;
   };
 
   bool is_stopping() {
@@ -294,7 +299,8 @@ private:
                          const FHandles &fh);
 
   int should_sync_entry(const std::string &epath, const struct ceph_statx &cstx,
-                        const FHandles &fh, bool *need_data_sync, bool *need_attr_sync);
+                        const FHandles &fh, bool *need_data_sync, bool *need_attr_sync,
+                        bool *can_copy_changed);
 
   int open_dir(MountRef mnt, const std::string &dir_path, boost::optional<uint64_t> snap_id);
   int pre_sync_check_and_open_handles(const std::string &dir_root, const Snapshot &current,
@@ -302,7 +308,7 @@ private:
   void post_sync_close_handles(const FHandles &fh);
 
   int do_synchronize(const std::string &dir_root, const Snapshot &current,
-                     boost::optional<Snapshot> prev);
+                     boost::optional<Snapshot> prev, bool remote_is_prev);
 
   int synchronize(const std::string &dir_root, const Snapshot &current,
                   boost::optional<Snapshot> prev);
@@ -310,9 +316,12 @@ private:
 
   int remote_mkdir(const std::string &epath, const struct ceph_statx &stx, const FHandles &fh);
   int remote_file_op(const std::string &dir_root, const std::string &epath, const struct ceph_statx &stx,
-                     const FHandles &fh, bool need_data_sync, bool need_attr_sync);
+                     const FHandles &fh, bool need_data_sync, bool need_attr_sync,
+                     bool can_copy_changed);
   int copy_to_remote(const std::string &dir_root, const std::string &epath, const struct ceph_statx &stx,
                      const FHandles &fh);
+  int copy_changed_to_remote(const std::string &dir_root, const std::string &epath,
+                             const struct ceph_statx &stx, const FHandles &fh);
   int sync_perms(const std::string& path);
 };
 
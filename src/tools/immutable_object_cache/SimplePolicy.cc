@@ -75,8 +75,24 @@ cache_status_t SimplePolicy::lookup_object(std::string file_name) {
   Entry* entry = entry_it->second;
 
   if (entry->status == OBJ_CACHE_PROMOTED || entry->status == OBJ_CACHE_DNE) {
-    // bump pos in lru on hit
-    m_promoted_lru.lru_touch(entry);
+    std::lock_guard lru_locker{m_lru_lock};
+    if (entry->hot) {
+      // bump pos in lru on hit
+      m_hot_lru.lru_touch(entry);
+    } else {
+      m_promoted_lru.lru_remove(entry);
+      m_hot_lru.lru_insert_top(entry);
+      entry->hot = true;
+      auto total = m_hot_lru.lru_get_size() + m_promoted_lru.lru_get_size();
+      while (m_hot_lru.lru_get_size() > total * HOT_RATIO) {
+        auto cold = static_cast<Entry*>(m_hot_lru.lru_expire());
+        if (cold == nullptr) {
+          break;
+        }
+        cold->hot = false;
+        m_promoted_lru.lru_insert_top(cold);
+      }
+    }
   }
 
   return entry->status;
@@ -137,7 +153,8 @@ void SimplePolicy::update_status(std::string file_name,
     entry->size = 0;
     entry->status = new_status;
 
-    m_promoted_lru.lru_remove(entry);
+    lru_of(entry).lru_remove(entry);
+    entry->hot = false;
     m_cache_map.erase(entry_it);
     m_cache_size -= size;
     delete entry;
@@ -174,10 +191,12 @@ void SimplePolicy::get_evict_list(std::list<std::string>* obj_list) {
     // TODO(dehao): make this configurable
     int evict_num = m_cache_map.size() * 0.1;
     for (int i = 0; i < evict_num; i++) {
-      Entry* entry = reinterpret_cast<Entry*>(m_promoted_lru.lru_expire());
+      Entry* entry = next_evict_entry();
       if (entry == nullptr) {
         continue;
       }
+      lru_of(entry).lru_remove(entry);
+      entry->hot = false;
       std::string file_name = entry->file_name;
       obj_list->push_back(file_name);
     }
@@ -201,11 +220,19 @@ uint64_t SimplePolicy::get_promoting_entry_num() {
 }
 
 uint64_t SimplePolicy::get_promoted_entry_num() {
-  return m_promoted_lru.lru_get_size();
+  return m_promoted_lru.lru_get_size() + m_hot_lru.lru_get_size();
+}
+
+SimplePolicy::Entry* SimplePolicy::next_evict_entry() {
+  auto entry = m_promoted_lru.lru_get_next_expire();
+  if (entry == nullptr) {
+    entry = m_hot_lru.lru_get_next_expire();
+  }
+  return static_cast<Entry*>(entry);
 }
 
 std::string SimplePolicy::get_evict_entry() {
-  Entry* entry = reinterpret_cast<Entry*>(m_promoted_lru.lru_get_next_expire());
+  Entry* entry = next_evict_entry();
   if (entry == nullptr) {
     return "";
   }
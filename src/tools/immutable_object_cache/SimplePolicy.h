@@ -46,8 +46,14 @@ class SimplePolicy : public Policy {
     Entry() : status(OBJ_CACHE_NONE) {}
     std::string file_name;
     uint64_t size;
+    bool hot = false;  ///< in m_hot_lru rather than m_promoted_lru
   };
 
+  LRU& lru_of(Entry* entry) {
+    return entry->hot ? m_hot_lru : m_promoted_lru;
+  }
+  Entry* next_evict_entry();
+
   CephContext* cct;
   double m_watermark;
   uint64_t m_max_inflight_ops;
@@ -60,7 +66,18 @@ class SimplePolicy : public Policy {
 
   std::atomic<uint64_t> m_cache_size;
 
+  // a scan touches each object once, so keep objects that have been hit
+  // since their promotion apart, and evict the others first: a boot storm
+  // sweeping through a parent image cannot push out its hot set then.
+  // at most HOT_RATIO of the entries are hot, the least recently used of
+  // them go back to m_promoted_lru beyond that.
+  static constexpr double HOT_RATIO = 0.8;
   LRU m_promoted_lru;
+  LRU m_hot_lru;
+  /// lookup_object() only holds m_cache_map_lock shared when it touches
+  /// the LRUs
+  ceph::mutex m_lru_lock =
+    ceph::make_mutex("rbd::cache::SimplePolicy::m_lru_lock");
 };
 
 }  // namespace immutable_obj_cache
@@ -237,6 +237,8 @@ void usage(ostream& out)
 "   -t N\n"
 "   --concurrent-ios=N\n"
 "        Set number of concurrent I/O operations\n"
+"   --rate=N\n"
+"        issue N ops/sec and measure latency from when each op was due\n"
 "   --show-time\n"
 "        prefix output with date/time\n"
 "   --no-verify\n"
@@ -1875,6 +1877,7 @@ static int rados_tool_common(const std::map < std::string, std::string > &opts,
   const char *target_pool_name = NULL;
   string oloc, target_oloc, nspace, target_nspace;
   int concurrent_ios = 16;
+  int bench_rate = 0;
   unsigned op_size = default_op_size;
   unsigned object_size = 0;
   unsigned max_objects = 0;
@@ -1951,6 +1954,12 @@ static int rados_tool_common(const std::map < std::string, std::string > &opts,
       return -EINVAL;
     }
   }
+  i = opts.find("rate");
+  if (i != opts.end()) {
+    if (rados_sistrtoll(i, &bench_rate)) {
+      return -EINVAL;
+    }
+  }
   i = opts.find("run-name");
   if (i != opts.end()) {
     run_name = i->second;
@@ -3314,6 +3323,7 @@ static int rados_tool_common(const std::map < std::string, std::string > &opts,
     }
     RadosBencher bencher(g_ceph_context, rados, io_ctx);
     bencher.set_show_time(show_time);
+    bencher.set_target_rate(bench_rate);
     bencher.set_write_destination(static_cast<OpWriteDest>(bench_write_dest));
 
     ostream *outstream = NULL;
@@ -4143,6 +4153,8 @@ int main(int argc, const char **argv)
 #endif
     } else if (ceph_argparse_witharg(args, i, &val, "-t", "--concurrent-ios", (char*)NULL)) {
       opts["concurrent-ios"] = val;
+    } else if (ceph_argparse_witharg(args, i, &val, "--rate", (char*)NULL)) {
+      opts["rate"] = val;
     } else if (ceph_argparse_witharg(args, i, &val, "--block-size", (char*)NULL)) {
       opts["block-size"] = val;
     } else if (ceph_argparse_witharg(args, i, &val, "-b", (char*)NULL)) {
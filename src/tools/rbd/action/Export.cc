@@ -360,13 +360,9 @@ public:
         return;
       }
 
-      uint64_t chkret = lseek64(m_fd, m_dest_offset, SEEK_SET);
-      if (chkret != m_dest_offset) {
-        cerr << "rbd: error seeking destination image to offset "
-             << m_dest_offset << std::endl;
-        r = -errno;
-        return;
-      }
+      // only write the non-zero parts, the file is sparse everywhere else
+      r = write_sparse();
+      return;
     }
 
     r = m_bufferlist.write_fd(m_fd);
@@ -381,6 +377,31 @@ private:
   librbd::Image &m_image;
   bufferlist m_bufferlist;
   uint64_t m_dest_offset;
+
+  int write_sparse() {
+    m_bufferlist.rebuild();
+    const bufferptr& bp = m_bufferlist.front();
+    size_t buffer_offset = 0;
+    while (buffer_offset < bp.length()) {
+      size_t write_length;
+      bool zeroed;
+      utils::calc_sparse_extent(bp, utils::RBD_DEFAULT_SPARSE_SIZE,
+                                buffer_offset, bp.length(), &write_length,
+                                &zeroed);
+      if (!zeroed) {
+        bufferlist write_bl;
+        write_bl.substr_of(m_bufferlist, buffer_offset, write_length);
+        int r = write_bl.write_fd(m_fd, m_dest_offset + buffer_offset);
+        if (r < 0) {
+          cerr << "rbd: error writing to destination image at offset "
+               << m_dest_offset + buffer_offset << std::endl;
+          return r;
+        }
+      }
+      buffer_offset += write_length;
+    }
+    return 0;
+  }
   uint64_t m_offset;
   uint64_t m_length;
   int m_fd;